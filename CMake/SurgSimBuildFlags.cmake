@@ -140,3 +140,34 @@ mark_as_advanced(EIGEN_ALIGNMENT)
 if(NOT EIGEN_ALIGNMENT)
 	add_definitions( -DEIGEN_DONT_ALIGN )
 endif()
+
+# Instruction set used by the explicitly vectorized code (SurgSim::Math::TriangleTriangleBatch), and by Eigen (e.g. for
+# SurgSim::Physics::Fem3DElementCorotationalTetrahedronBatch).
+# Off by default, the binaries would not run on processors without the instruction set. The flags are global, all the
+# code and the libraries linked with it need to agree on the alignment of the Eigen types.
+set(SURGSIM_SIMD "NONE" CACHE STRING "Instruction set for the vectorized code (NONE, AVX2 or AVX512)")
+set_property(CACHE SURGSIM_SIMD PROPERTY STRINGS NONE AVX2 AVX512)
+mark_as_advanced(SURGSIM_SIMD)
+
+if("${SURGSIM_SIMD}" STREQUAL "AVX2")
+	if(MSVC)
+		set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} /arch:AVX2")
+	else()
+		set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -mavx2 -mfma")
+	endif()
+elseif("${SURGSIM_SIMD}" STREQUAL "AVX512")
+	if(MSVC)
+		set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} /arch:AVX512")
+	else()
+		set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -mavx512f -mavx2 -mfma")
+	endif()
+elseif(NOT "${SURGSIM_SIMD}" STREQUAL "NONE")
+	message(FATAL_ERROR "Unknown SURGSIM_SIMD value '${SURGSIM_SIMD}', use NONE, AVX2 or AVX512.")
+endif()
+
+# Eigen 3.3 and later align the fixed size types on the register size with AVX, but the C++11 allocations
+# (std::make_shared, std::vector) only guarantee 16 bytes. Keep the fixed size types aligned on 16 bytes as without the
+# instruction set, the dynamic ones are still allocated by Eigen on the register size.
+if(NOT "${SURGSIM_SIMD}" STREQUAL "NONE")
+	add_definitions( -DEIGEN_MAX_STATIC_ALIGN_BYTES=16 )
+endif()
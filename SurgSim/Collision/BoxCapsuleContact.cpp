@@ -18,6 +18,7 @@
 #include "SurgSim/Collision/BoxCapsuleContact.h"
 
 #include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/ContactArena.h"
 #include "SurgSim/Collision/Representation.h"
 #include "SurgSim/Math/Geometry.h"
 #include "SurgSim/Math/Vector.h"
@@ -179,7 +180,7 @@ std::list<std::shared_ptr<Contact>> BoxCapsuleContact::calculateDcdContact(
 		normal = boxPose.linear() * normal;
 		std::pair<Location, Location> penetrationPoints = std::make_pair(Location(deepestBoxPoint),
 				Location(capsulePose.inverse() * boxPose * deepestCapsulePoint));
-		contacts.emplace_back(std::make_shared<Contact>(COLLISION_DETECTION_TYPE_DISCRETE, distance, 1.0,
+		contacts.emplace_back(ContactArena::makeContact(COLLISION_DETECTION_TYPE_DISCRETE, distance, 1.0,
 							  Vector3d::Zero(), normal, penetrationPoints));
 	}
 	return contacts;
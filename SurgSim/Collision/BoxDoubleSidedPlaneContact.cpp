@@ -16,6 +16,7 @@
 #include "SurgSim/Collision/BoxDoubleSidedPlaneContact.h"
 
 #include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/ContactArena.h"
 #include "SurgSim/Collision/Representation.h"
 #include "SurgSim/Math/Geometry.h"
 #include "SurgSim/Math/Vector.h"
@@ -136,7 +137,7 @@ std::list<std::shared_ptr<Contact>> BoxDoubleSidedPlaneContact::calculateDcdCont
 			{
 				std::pair<Location, Location> penetrationPoints = std::make_pair(Location(boxVertices[i]),
 						Location(planePose.inverse() * (boxPose * boxVertices[i] + normal * std::abs(d[i]))));
-				contacts.emplace_back(std::make_shared<Contact>(
+				contacts.emplace_back(ContactArena::makeContact(
 										  COLLISION_DETECTION_TYPE_DISCRETE,
 										  std::abs(d[i]), 1.0, Vector3d::Zero(), normal,
 										  penetrationPoints));
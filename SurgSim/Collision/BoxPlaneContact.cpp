@@ -16,6 +16,7 @@
 #include "SurgSim/Collision/BoxPlaneContact.h"
 
 #include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/ContactArena.h"
 #include "SurgSim/Collision/Representation.h"
 #include "SurgSim/Math/Geometry.h"
 #include "SurgSim/Math/Vector.h"
@@ -63,7 +64,7 @@ std::list<std::shared_ptr<Contact>> BoxPlaneContact::calculateDcdContact(
 		{
 			std::pair<Location, Location> penetrationPoints = std::make_pair(Location(boxVertex),
 					Location(boxLocalToPlaneLocal * (boxVertex - planeNormal * d)));
-			contacts.emplace_back(std::make_shared<Contact>(
+			contacts.emplace_back(ContactArena::makeContact(
 									  COLLISION_DETECTION_TYPE_DISCRETE, -d, 1.0,
 									  Vector3d::Zero(), planePose.linear() * planeShape.getNormal(),
 									  penetrationPoints));
@@ -16,6 +16,7 @@
 #include "SurgSim/Collision/BoxSphereContact.h"
 
 #include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/ContactArena.h"
 #include "SurgSim/Collision/Representation.h"
 #include "SurgSim/Math/Geometry.h"
 #include "SurgSim/Math/Vector.h"
@@ -111,7 +112,7 @@ std::list<std::shared_ptr<Contact>> BoxSphereContact::calculateDcdContact(
 			Location(spherePose.inverse() * (sphereCenter + (normal * sphereShape.getRadius()))));
 
 	// Create the contact.
-	contacts.emplace_back(std::make_shared<Contact>(
+	contacts.emplace_back(ContactArena::makeContact(
 							  COLLISION_DETECTION_TYPE_DISCRETE, depth, 1.0,
 							  Vector3d::Zero(), normal, penetrationPoints));
 	return contacts;
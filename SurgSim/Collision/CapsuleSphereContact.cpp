@@ -16,6 +16,7 @@
 #include "SurgSim/Collision/CapsuleSphereContact.h"
 
 #include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/ContactArena.h"
 #include "SurgSim/Collision/Representation.h"
 #include "SurgSim/Math/CapsuleShape.h"
 #include "SurgSim/Math/Geometry.h"
@@ -64,7 +65,7 @@ std::list<std::shared_ptr<Contact>> CapsuleSphereContact::calculateDcdContact(
 		penetrationPoints.second.rigidLocalPosition.setValue(
 			spherePose.inverse() * (sphereCenter + normal * sphere.getRadius()));
 
-		contacts.emplace_back(std::make_shared<Contact>(
+		contacts.emplace_back(ContactArena::makeContact(
 								  COLLISION_DETECTION_TYPE_DISCRETE, depth, 1.0,
 								  Vector3d::Zero(), normal, penetrationPoints));
 	}
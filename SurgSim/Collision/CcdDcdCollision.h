@@ -23,12 +23,16 @@
 #include "SurgSim/Collision/CapsuleSphereContact.h"
 #include "SurgSim/Collision/CompoundShapeContact.h"
 #include "SurgSim/Collision/ContactCalculation.h"
+#include "SurgSim/Collision/ConvexContact.h"
 #include "SurgSim/Collision/DefaultContactCalculation.h"
 #include "SurgSim/Collision/OctreeCapsuleContact.h"
 #include "SurgSim/Collision/OctreeDoubleSidedPlaneContact.h"
 #include "SurgSim/Collision/OctreePlaneContact.h"
 #include "SurgSim/Collision/OctreeSphereContact.h"
 #include "SurgSim/Collision/OctreeTriangleMeshContact.h"
+#include "SurgSim/Collision/SdfParticlesContact.h"
+#include "SurgSim/Collision/SdfSegmentMeshContact.h"
+#include "SurgSim/Collision/SdfTriangleMeshContact.h"
 #include "SurgSim/Collision/SegmentMeshTriangleMeshContact.h"
 #include "SurgSim/Collision/SegmentSelfContact.h"
 #include "SurgSim/Collision/SphereDoubleSidedPlaneContact.h"
@@ -15,6 +15,9 @@
 
 #include "SurgSim/Collision/CollisionPair.h"
 
+#include "SurgSim/Collision/ContactArena.h"
+#include "SurgSim/Collision/ContactCache.h"
+#include "SurgSim/Collision/ContactCalculation.h"
 #include "SurgSim/Framework/Assert.h"
 
 using SurgSim::DataStructures::Location;
@@ -25,12 +28,22 @@ namespace SurgSim
 namespace Collision
 {
 
-CollisionPair::CollisionPair()
+std::shared_ptr<Contact> Contact::makeComplimentary()
+{
+	auto complimentary = ContactArena::makeContact(type, depth, time, contact,
+						 -normal, std::make_pair(penetrationPoints.second, penetrationPoints.first));
+	complimentary->force = -force;
+	return complimentary;
+}
+
+CollisionPair::CollisionPair() :
+	m_contactArenaSlot(0)
 {
 }
 
 CollisionPair::CollisionPair(const std::shared_ptr<Representation>& first,
-							 const std::shared_ptr<Representation>& second)
+							 const std::shared_ptr<Representation>& second) :
+	m_contactArenaSlot(0)
 {
 	setRepresentations(first, second);
 }
@@ -50,6 +63,9 @@ void CollisionPair::setRepresentations(const std::shared_ptr<Representation>& fi
 	m_representations.first = first;
 	m_representations.second = second;
 	m_isSwapped = false;
+	m_contactCalculation = nullptr;
+	m_posedShapes.first.invalidate();
+	m_posedShapes.second.invalidate();
 
 	if (m_representations.first == m_representations.second)
 	{
@@ -102,7 +118,7 @@ void CollisionPair::addCcdContact(const double& depth, const double& time, const
 {
 	SURGSIM_ASSERT(getType() == COLLISION_DETECTION_TYPE_CONTINUOUS)
 		<< "Can only add CCD contacts to a CollisionPair that is COLLISION_DETECTION_TYPE_CONTINUOUS";
-	addContact(std::make_shared<Contact>(COLLISION_DETECTION_TYPE_CONTINUOUS, depth, time, contactPoint, normal,
+	addContact(ContactArena::makeContact(COLLISION_DETECTION_TYPE_CONTINUOUS, depth, time, contactPoint, normal,
 				penetrationPoints));
 }
 
@@ -111,8 +127,8 @@ void CollisionPair::addDcdContact(const double& depth, const SurgSim::Math::Vect
 {
 	SURGSIM_ASSERT(getType() == COLLISION_DETECTION_TYPE_DISCRETE)
 		<< "Can only add DCD contacts to a CollisionPair that is COLLISION_DETECTION_TYPE_DISCRETE";
-	addContact(std::make_shared<Contact>(COLLISION_DETECTION_TYPE_DISCRETE, depth, 1.0, Math::Vector3d::Zero(), normal,
-				penetrationPoints));
+	addContact(ContactArena::makeContact(COLLISION_DETECTION_TYPE_DISCRETE, depth, 1.0, Math::Vector3d::Zero(),
+				normal, penetrationPoints));
 }
 
 void CollisionPair::addContact(const std::shared_ptr<Contact>& contact)
@@ -124,6 +140,7 @@ void CollisionPair::addContact(const std::shared_ptr<Contact>& contact)
 
 void CollisionPair::updateRepresentations()
 {
+	ContactArena::Scope arenaScope(m_contactArena.get(), m_contactArenaSlot);
 	for (auto& contact : m_contacts)
 	{
 		m_representations.first->addContact(m_representations.second, contact);
@@ -146,6 +163,7 @@ void CollisionPair::swapRepresentations()
 	SURGSIM_ASSERT(!hasContacts()) << "Can't swap representations after contacts have already been calculated";
 	m_isSwapped = !m_isSwapped;
 	std::swap(m_representations.first, m_representations.second);
+	std::swap(m_posedShapes.first, m_posedShapes.second);
 }
 
 bool CollisionPair::isSwapped() const
@@ -161,6 +179,55 @@ bool CollisionPair::mayIntersect() const
 	return (one.isEmpty() || two.isEmpty() || SurgSim::Math::doAabbIntersect(one, two));
 }
 
+void CollisionPair::setContactCache(const std::shared_ptr<ContactCache>& cache)
+{
+	m_contactCache = cache;
+}
+
+const std::shared_ptr<ContactCache>& CollisionPair::getContactCache() const
+{
+	return m_contactCache;
+}
+
+void CollisionPair::setContactArena(const std::shared_ptr<ContactArena>& arena, size_t slot)
+{
+	m_contactArena = arena;
+	m_contactArenaSlot = slot;
+}
+
+const std::shared_ptr<ContactArena>& CollisionPair::getContactArena() const
+{
+	return m_contactArena;
+}
+
+size_t CollisionPair::getContactArenaSlot() const
+{
+	return m_contactArenaSlot;
+}
+
+void CollisionPair::setContactCalculation(const std::shared_ptr<ContactCalculation>& calculation)
+{
+	m_contactCalculation = calculation;
+}
+
+const std::shared_ptr<ContactCalculation>& CollisionPair::getContactCalculation() const
+{
+	return m_contactCalculation;
+}
+
+void CollisionPair::setPosedShapes(const Math::PosedShape<std::shared_ptr<Math::Shape>>& first,
+								   const Math::PosedShape<std::shared_ptr<Math::Shape>>& second)
+{
+	m_posedShapes.first = first;
+	m_posedShapes.second = second;
+}
+
+const std::pair<Math::PosedShape<std::shared_ptr<Math::Shape>>, Math::PosedShape<std::shared_ptr<Math::Shape>>>&
+	CollisionPair::getPosedShapes() const
+{
+	return m_posedShapes;
+}
+
 }; // namespace Collision
 }; // namespace SurgSim
 
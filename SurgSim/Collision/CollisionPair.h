@@ -21,6 +21,7 @@
 
 #include "SurgSim/Collision/Representation.h"
 #include "SurgSim/DataStructures/Location.h"
+#include "SurgSim/Math/Shape.h"
 #include "SurgSim/Math/Vector.h"
 
 
@@ -29,6 +30,10 @@ namespace SurgSim
 namespace Collision
 {
 
+class ContactArena;
+class ContactCache;
+class ContactCalculation;
+
 /// Contact data structure used when two representations touch each other
 /// The convention is that if body 1 is moved along the normal vector by
 /// a distance depth (or equivalently if body 2 is moved the same distance
@@ -47,13 +52,8 @@ struct Contact
 		normal(newNormal), penetrationPoints(newPenetrationPoints), force(SurgSim::Math::Vector3d::Zero())
 	{
 	}
-	std::shared_ptr<Contact> makeComplimentary()
-	{
-		auto complimentary = std::make_shared<Contact>(type, depth, time, contact,
-							 -normal, std::make_pair(penetrationPoints.second, penetrationPoints.first));
-		complimentary->force = -force;
-		return complimentary;
-	}
+	/// \return The contact seen from the other representation, made in the contact arena the thread is scoped to
+	std::shared_ptr<Contact> makeComplimentary();
 	bool operator==(const Contact& contact) const
 	{
 		return type == contact.type &&
@@ -138,7 +138,8 @@ class CollisionPair
 	/// \param	contact	The contact between the first and the second representation.
 	void addContact(const std::shared_ptr<Contact>& contact);
 
-	/// Update the representations by adding the contacts to them.
+	/// Update the representations by adding the contacts to them, the complimentary contacts are made in the contact
+	/// arena of the pair.
 	void updateRepresentations();
 
 	/// \return	All the contacts.
@@ -158,6 +159,44 @@ class CollisionPair
 	/// \note The bounding boxes are taken, if the bounding box is empty it is always considered for collision
 	bool mayIntersect() const;
 
+	/// Set the data kept for this pair of representations between frames
+	/// \param cache the cache, nullptr if the contact calculations cannot take advantage of the previous frames
+	void setContactCache(const std::shared_ptr<ContactCache>& cache);
+
+	/// \return the data kept for this pair of representations between frames, may be nullptr
+	const std::shared_ptr<ContactCache>& getContactCache() const;
+
+	/// Set the arena that the contacts of this pair are made in, for the contact calculation and the update of the
+	/// representations
+	/// \param arena the arena, nullptr for the contacts to be allocated on their own
+	/// \param slot the slot of the arena reserved for this pair
+	void setContactArena(const std::shared_ptr<ContactArena>& arena, size_t slot);
+
+	/// \return the arena that the contacts of this pair are made in, may be nullptr
+	const std::shared_ptr<ContactArena>& getContactArena() const;
+
+	/// \return the slot of the contact arena reserved for this pair
+	size_t getContactArenaSlot() const;
+
+	/// Set the contact calculation for the shape types of this pair, resolved before the narrow phase
+	/// \param calculation the calculation, nullptr if it needs to be looked up in the contact tables
+	void setContactCalculation(const std::shared_ptr<ContactCalculation>& calculation);
+
+	/// \return the contact calculation resolved for this pair, may be nullptr
+	const std::shared_ptr<ContactCalculation>& getContactCalculation() const;
+
+	/// Set the posed shapes of the representations, taken before the narrow phase so that the contact calculation
+	/// does not need to pose the shapes (and lock the representations) itself
+	/// \param first the posed shape of the first representation
+	/// \param second the posed shape of the second representation
+	void setPosedShapes(const Math::PosedShape<std::shared_ptr<Math::Shape>>& first,
+						const Math::PosedShape<std::shared_ptr<Math::Shape>>& second);
+
+	/// \return the posed shapes of the representations, in the order of the representations, the shapes are nullptr
+	/// 	if they were not set
+	const std::pair<Math::PosedShape<std::shared_ptr<Math::Shape>>, Math::PosedShape<std::shared_ptr<Math::Shape>>>&
+		getPosedShapes() const;
+
 private:
 	/// Pair of objects that are colliding
 	std::pair<std::shared_ptr<Representation>, std::shared_ptr<Representation>> m_representations;
@@ -169,6 +208,22 @@ class CollisionPair
 	std::list<std::shared_ptr<Contact>> m_contacts;
 
 	bool m_isSwapped;
+
+	/// Data kept between frames
+	std::shared_ptr<ContactCache> m_contactCache;
+
+	/// Arena of the contacts
+	std::shared_ptr<ContactArena> m_contactArena;
+
+	/// Slot of the arena reserved for this pair
+	size_t m_contactArenaSlot;
+
+	/// Contact calculation resolved for this pair
+	std::shared_ptr<ContactCalculation> m_contactCalculation;
+
+	/// Posed shapes of the representations
+	std::pair<Math::PosedShape<std::shared_ptr<Math::Shape>>, Math::PosedShape<std::shared_ptr<Math::Shape>>>
+		m_posedShapes;
 };
 
 
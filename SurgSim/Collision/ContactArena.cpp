@@ -0,0 +1,264 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SurgSim/Collision/ContactArena.h"
+
+#include <algorithm>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/tss.hpp>
+
+#include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Framework/Assert.h"
+
+namespace
+{
+
+/// The number of contacts of the first block of a slot, the following blocks double the capacity of the slot
+const size_t MinimumBlockCapacity = 16;
+
+/// The slot that a thread is scoped to
+struct ScopedSlot
+{
+	ScopedSlot() : arena(nullptr), slot(0) {}
+
+	SurgSim::Collision::ContactArena* arena;
+	size_t slot;
+};
+
+boost::thread_specific_ptr<ScopedSlot>& getScopedSlot()
+{
+	static boost::thread_specific_ptr<ScopedSlot> scopedSlot;
+	return scopedSlot;
+}
+
+}
+
+namespace SurgSim
+{
+namespace Collision
+{
+
+struct ContactArena::Block
+{
+	explicit Block(size_t capacity) : size(0)
+	{
+		contacts.reserve(capacity);
+	}
+
+	/// The contacts, never reallocated, the ones past size are kept to be overwritten
+	std::vector<Contact> contacts;
+
+	/// The number of contacts in use
+	size_t size;
+};
+
+ContactArena::Slot::Slot() :
+	current(0)
+{
+}
+
+ContactArena::ContactArena()
+{
+}
+
+ContactArena::~ContactArena()
+{
+}
+
+void ContactArena::reset(size_t numSlots)
+{
+	// The retired blocks that are not referenced anymore can be used again
+	auto retired = std::partition(m_retiredBlocks.begin(), m_retiredBlocks.end(),
+		[](const std::shared_ptr<Block>& block)
+		{
+			return block.use_count() > 1;
+		});
+	for (auto block = retired; block != m_retiredBlocks.end(); ++block)
+	{
+		(*block)->size = 0;
+		m_freeBlocks.push_back(std::move(*block));
+	}
+	m_retiredBlocks.erase(retired, m_retiredBlocks.end());
+
+	for (size_t i = 0; i < m_slots.size(); ++i)
+	{
+		auto& slot = m_slots[i];
+		slot.current = 0;
+		if (i >= numSlots)
+		{
+			for (auto& block : slot.blocks)
+			{
+				releaseBlock(&block);
+			}
+			continue;
+		}
+
+		// A slot keeps its free blocks
+		for (auto& block : slot.blocks)
+		{
+			if (block.use_count() == 1)
+			{
+				block->size = 0;
+			}
+			else
+			{
+				releaseBlock(&block);
+			}
+		}
+		slot.blocks.erase(std::remove(slot.blocks.begin(), slot.blocks.end(), nullptr), slot.blocks.end());
+	}
+	m_slots.resize(numSlots);
+}
+
+size_t ContactArena::getNumSlots() const
+{
+	return m_slots.size();
+}
+
+size_t ContactArena::getCapacity() const
+{
+	size_t capacity = 0;
+	for (const auto& slot : m_slots)
+	{
+		for (const auto& block : slot.blocks)
+		{
+			capacity += block->contacts.capacity();
+		}
+	}
+	for (const auto& block : m_freeBlocks)
+	{
+		capacity += block->contacts.capacity();
+	}
+	for (const auto& block : m_retiredBlocks)
+	{
+		capacity += block->contacts.capacity();
+	}
+	return capacity;
+}
+
+std::shared_ptr<Contact> ContactArena::makeContactInSlot(size_t slotIndex,
+	const CollisionDetectionType& type,
+	double depth,
+	double time,
+	const Math::Vector3d& contact,
+	const Math::Vector3d& normal,
+	const std::pair<DataStructures::Location, DataStructures::Location>& penetrationPoints)
+{
+	SURGSIM_ASSERT(slotIndex < m_slots.size()) << "The arena has " << m_slots.size() << " slots, cannot use slot "
+		<< slotIndex;
+
+	auto& slot = m_slots[slotIndex];
+	while (slot.current < slot.blocks.size() &&
+		   slot.blocks[slot.current]->size == slot.blocks[slot.current]->contacts.capacity())
+	{
+		++slot.current;
+	}
+	if (slot.current == slot.blocks.size())
+	{
+		size_t capacity = MinimumBlockCapacity;
+		for (const auto& block : slot.blocks)
+		{
+			capacity = std::max(capacity, 2 * block->contacts.capacity());
+		}
+		slot.blocks.push_back(takeBlock(capacity));
+	}
+
+	const auto& block = slot.blocks[slot.current];
+	if (block->size < block->contacts.size())
+	{
+		// Overwrite the contact in place, so that the storage of its locations is reused
+		auto& result = block->contacts[block->size];
+		result.type = type;
+		result.depth = depth;
+		result.time = time;
+		result.contact = contact;
+		result.normal = normal;
+		result.penetrationPoints = penetrationPoints;
+		result.force.setZero();
+	}
+	else
+	{
+		block->contacts.emplace_back(type, depth, time, contact, normal, penetrationPoints);
+	}
+
+	// The contact shares the ownership of its block
+	return std::shared_ptr<Contact>(block, &block->contacts[block->size++]);
+}
+
+std::shared_ptr<Contact> ContactArena::makeContact(
+	const CollisionDetectionType& type,
+	double depth,
+	double time,
+	const Math::Vector3d& contact,
+	const Math::Vector3d& normal,
+	const std::pair<DataStructures::Location, DataStructures::Location>& penetrationPoints)
+{
+	const ScopedSlot* scopedSlot = getScopedSlot().get();
+	if (scopedSlot != nullptr && scopedSlot->arena != nullptr)
+	{
+		return scopedSlot->arena->makeContactInSlot(scopedSlot->slot, type, depth, time, contact, normal,
+				penetrationPoints);
+	}
+	return std::make_shared<Contact>(type, depth, time, contact, normal, penetrationPoints);
+}
+
+void ContactArena::releaseBlock(std::shared_ptr<Block>* block)
+{
+	if (block->use_count() == 1)
+	{
+		(*block)->size = 0;
+		m_freeBlocks.push_back(std::move(*block));
+	}
+	else
+	{
+		m_retiredBlocks.push_back(std::move(*block));
+	}
+	block->reset();
+}
+
+std::shared_ptr<ContactArena::Block> ContactArena::takeBlock(size_t capacity)
+{
+	boost::lock_guard<boost::mutex> lock(m_mutex);
+	if (m_freeBlocks.empty())
+	{
+		return std::make_shared<Block>(capacity);
+	}
+	auto block = std::move(m_freeBlocks.back());
+	m_freeBlocks.pop_back();
+	return block;
+}
+
+ContactArena::Scope::Scope(ContactArena* arena, size_t slot)
+{
+	auto& scopedSlot = getScopedSlot();
+	if (scopedSlot.get() == nullptr)
+	{
+		scopedSlot.reset(new ScopedSlot());
+	}
+	m_previousArena = scopedSlot->arena;
+	m_previousSlot = scopedSlot->slot;
+	scopedSlot->arena = arena;
+	scopedSlot->slot = slot;
+}
+
+ContactArena::Scope::~Scope()
+{
+	auto& scopedSlot = getScopedSlot();
+	scopedSlot->arena = m_previousArena;
+	scopedSlot->slot = m_previousSlot;
+}
+
+}; // namespace Collision
+}; // namespace SurgSim
@@ -0,0 +1,162 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SURGSIM_COLLISION_CONTACTARENA_H
+#define SURGSIM_COLLISION_CONTACTARENA_H
+
+#include <boost/thread/mutex.hpp>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "SurgSim/Collision/Representation.h"
+#include "SurgSim/DataStructures/Location.h"
+#include "SurgSim/Math/Vector.h"
+
+namespace SurgSim
+{
+namespace Collision
+{
+
+struct Contact;
+
+/// Storage for the contacts calculated during the physics updates, so that no contact is allocated at steady state.
+/// The contacts are kept in contiguous blocks, each collision pair of an update makes its contacts in its own slot
+/// so that the pairs can be calculated concurrently. Resetting the arena for a new update clears the slots but keeps
+/// their blocks, the contacts in them are overwritten in place. A block that still has contacts referenced outside of
+/// the arena, e.g. by the physics state of a previous update, is put aside until all of them are released, so a
+/// contact is never overwritten while it is in use.
+///
+/// The contact calculations make their contacts through makeContact(), which uses the slot that the calling thread
+/// is scoped to (see Scope), the calculations do not need to know about the arena.
+class ContactArena
+{
+public:
+	/// Constructor, the arena has no slot
+	ContactArena();
+
+	/// Destructor
+	~ContactArena();
+
+	/// Release the contacts of the previous update and prepare the slots of a new one
+	/// \param numSlots The number of slots, usually one per collision pair
+	/// \note Not to be called while contacts are made in the slots
+	void reset(size_t numSlots);
+
+	/// \return The number of slots
+	size_t getNumSlots() const;
+
+	/// \return The number of contacts that the arena holds without allocating, over all its blocks
+	size_t getCapacity() const;
+
+	/// Make a contact in a slot, different slots can be used concurrently
+	/// \param slot The slot of the contact
+	/// \param type, depth, time, contact, normal, penetrationPoints The data of the contact, see Contact
+	/// \return The contact, kept by the arena until it is released by all its owners
+	std::shared_ptr<Contact> makeContactInSlot(size_t slot,
+		const CollisionDetectionType& type,
+		double depth,
+		double time,
+		const Math::Vector3d& contact,
+		const Math::Vector3d& normal,
+		const std::pair<DataStructures::Location, DataStructures::Location>& penetrationPoints);
+
+	/// Make a contact in the slot that the calling thread is scoped to, allocate it on its own if the thread is not
+	/// scoped to an arena
+	/// \param type, depth, time, contact, normal, penetrationPoints The data of the contact, see Contact
+	/// \return The contact
+	static std::shared_ptr<Contact> makeContact(
+		const CollisionDetectionType& type,
+		double depth,
+		double time,
+		const Math::Vector3d& contact,
+		const Math::Vector3d& normal,
+		const std::pair<DataStructures::Location, DataStructures::Location>& penetrationPoints);
+
+	/// Scopes the calling thread to a slot of an arena for the lifetime of the object, the previous scope of the
+	/// thread is restored on destruction
+	class Scope
+	{
+	public:
+		/// Constructor
+		/// \param arena The arena, nullptr for the thread to allocate its contacts
+		/// \param slot The slot of the arena
+		Scope(ContactArena* arena, size_t slot);
+
+		/// Destructor
+		~Scope();
+
+	private:
+		/// @{
+		/// Prevent copy construction and assignment
+		Scope(const Scope& other);
+		Scope& operator=(const Scope& other);
+		/// @}
+
+		/// The arena the thread was scoped to before
+		ContactArena* m_previousArena;
+
+		/// The slot the thread was scoped to before
+		size_t m_previousSlot;
+	};
+
+private:
+	/// @{
+	/// Prevent copy construction and assignment
+	ContactArena(const ContactArena& other);
+	ContactArena& operator=(const ContactArena& other);
+	/// @}
+
+	/// Contiguous storage for contacts
+	struct Block;
+
+	/// The blocks of one slot, filled in order
+	struct Slot
+	{
+		Slot();
+
+		/// The blocks
+		std::vector<std::shared_ptr<Block>> blocks;
+
+		/// The index of the block being filled
+		size_t current;
+	};
+
+	/// Give back a block of a slot, to be reused once none of its contacts is referenced anymore
+	/// \param block The block
+	void releaseBlock(std::shared_ptr<Block>* block);
+
+	/// Take a free block, or allocate one if there is none
+	/// \param capacity The capacity of the block if it has to be allocated
+	/// \return The block, empty
+	std::shared_ptr<Block> takeBlock(size_t capacity);
+
+	/// The slots of the current update
+	std::vector<Slot> m_slots;
+
+	/// The blocks ready to be used by any slot
+	std::vector<std::shared_ptr<Block>> m_freeBlocks;
+
+	/// The blocks with contacts still referenced outside of the arena
+	std::vector<std::shared_ptr<Block>> m_retiredBlocks;
+
+	/// Protects the free blocks while the slots are used concurrently
+	boost::mutex m_mutex;
+};
+
+}; // namespace Collision
+}; // namespace SurgSim
+
+#endif // SURGSIM_COLLISION_CONTACTARENA_H
@@ -0,0 +1,108 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SurgSim/Collision/ContactCache.h"
+
+#include "SurgSim/DataStructures/FlatAabbTree.h"
+
+namespace SurgSim
+{
+namespace Collision
+{
+
+ContactCache::ContactCache() :
+	m_first(nullptr),
+	m_hasSeparatingAxis(false),
+	m_separatingAxis(Math::Vector3d::Zero()),
+	m_age(0),
+	m_numEarlyExits(0)
+{
+}
+
+void ContactCache::clear()
+{
+	m_hasSeparatingAxis = false;
+	m_separatingAxis.setZero();
+	m_aabbTree.reset();
+	m_age = 0;
+	m_numEarlyExits = 0;
+}
+
+void ContactCache::setFirst(const Representation* first)
+{
+	if (first != m_first)
+	{
+		clear();
+		m_first = first;
+	}
+}
+
+const Representation* ContactCache::getFirst() const
+{
+	return m_first;
+}
+
+void ContactCache::setSeparatingAxis(const Math::Vector3d& axis)
+{
+	m_separatingAxis = axis;
+	m_hasSeparatingAxis = true;
+}
+
+bool ContactCache::getSeparatingAxis(Math::Vector3d* axis) const
+{
+	if (m_hasSeparatingAxis)
+	{
+		*axis = m_separatingAxis;
+	}
+	return m_hasSeparatingAxis;
+}
+
+void ContactCache::clearSeparatingAxis()
+{
+	m_hasSeparatingAxis = false;
+}
+
+void ContactCache::setAabbTree(const std::shared_ptr<DataStructures::FlatAabbTree>& tree)
+{
+	m_aabbTree = tree;
+}
+
+const std::shared_ptr<DataStructures::FlatAabbTree>& ContactCache::getAabbTree() const
+{
+	return m_aabbTree;
+}
+
+size_t ContactCache::getAge() const
+{
+	return m_age;
+}
+
+void ContactCache::incrementAge()
+{
+	++m_age;
+}
+
+size_t ContactCache::getNumEarlyExits() const
+{
+	return m_numEarlyExits;
+}
+
+void ContactCache::incrementNumEarlyExits()
+{
+	++m_numEarlyExits;
+}
+
+}; // namespace Collision
+}; // namespace SurgSim
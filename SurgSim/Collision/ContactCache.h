@@ -0,0 +1,110 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SURGSIM_COLLISION_CONTACTCACHE_H
+#define SURGSIM_COLLISION_CONTACTCACHE_H
+
+#include <memory>
+
+#include "SurgSim/Math/Vector.h"
+
+namespace SurgSim
+{
+namespace DataStructures
+{
+class FlatAabbTree;
+}
+
+namespace Collision
+{
+
+class Representation;
+
+/// Data kept for a pair of representations from one frame to the next, so that the contact calculations can take
+/// advantage of the temporal coherence of the scene, e.g. to early out on an axis that separated the shapes in the
+/// previous frame, or to seed an iterative search.
+/// The data is expressed in the order of the shapes as seen by the contact calculation, it is cleared whenever the
+/// pair is presented in the other order.
+/// Every calculation is free to ignore the cache, a calculation that uses it is responsible for keeping it valid.
+class ContactCache
+{
+public:
+	/// Constructor, the cache is empty
+	ContactCache();
+
+	/// Remove all the cached data
+	void clear();
+
+	/// Set the representation that the data refers to as the first one, clears the data if it changes
+	/// \param first the first representation of the pair, only used as an identifier
+	void setFirst(const Representation* first);
+
+	/// \return the representation that the data refers to as the first one
+	const Representation* getFirst() const;
+
+	/// \param axis the axis that separated the shapes, or a candidate for it, in world coordinates
+	void setSeparatingAxis(const Math::Vector3d& axis);
+
+	/// \param [out] axis the axis that separated the shapes, or a candidate for it, in world coordinates
+	/// \return true if there is an axis in the cache
+	bool getSeparatingAxis(Math::Vector3d* axis) const;
+
+	/// Forget the separating axis, the other data is kept
+	void clearSeparatingAxis();
+
+	/// \param tree a bounding volume hierarchy of the pair, e.g. of the swept volumes of its features, that the next
+	/// calculation can refit instead of building a new one
+	void setAabbTree(const std::shared_ptr<DataStructures::FlatAabbTree>& tree);
+
+	/// \return the bounding volume hierarchy kept for the pair, nullptr if there is none
+	const std::shared_ptr<DataStructures::FlatAabbTree>& getAabbTree() const;
+
+	/// \return the number of consecutive calculations since the data of the cache was last cleared
+	size_t getAge() const;
+
+	/// Increase the age of the cache, called once per contact calculation of the pair
+	void incrementAge();
+
+	/// \return the number of calculations since the data of the cache was last cleared that returned early on the
+	/// cached data, without running the full calculation
+	size_t getNumEarlyExits() const;
+
+	/// Increase the number of early exits, called by a calculation that returns early on the cached data
+	void incrementNumEarlyExits();
+
+private:
+	/// The representation that the data refers to as the first one
+	const Representation* m_first;
+
+	/// Whether m_separatingAxis is valid
+	bool m_hasSeparatingAxis;
+
+	/// The separating axis
+	Math::Vector3d m_separatingAxis;
+
+	/// The bounding volume hierarchy
+	std::shared_ptr<DataStructures::FlatAabbTree> m_aabbTree;
+
+	/// The number of calculations since the last clear
+	size_t m_age;
+
+	/// The number of early exits since the last clear
+	size_t m_numEarlyExits;
+};
+
+}; // namespace Collision
+}; // namespace SurgSim
+
+#endif // SURGSIM_COLLISION_CONTACTCACHE_H
@@ -16,6 +16,8 @@
 #include <thread>
 
 #include "SurgSim/Collision/CcdDcdCollision.h"
+#include "SurgSim/Collision/ContactArena.h"
+#include "SurgSim/Collision/ContactCache.h"
 #include "SurgSim/Collision/ContactCalculation.h"
 #include "SurgSim/Collision/DefaultContactCalculation.h"
 #include "SurgSim/Collision/Representation.h"
@@ -163,21 +165,53 @@ void ContactCalculation::doCalculateContact(std::shared_ptr<CollisionPair> pair)
 				"Second Object, wrong type of object" << secondShapeType;
 	}
 
+	// The contacts made by the calculation go to the contact arena of the pair, if it has one
+	ContactArena::Scope arenaScope(pair->getContactArena().get(), pair->getContactArenaSlot());
 	std::list<std::shared_ptr<Contact>> contacts;
 	if (pair->getType() == Collision::CollisionDetectionType::COLLISION_DETECTION_TYPE_DISCRETE)
 	{
-		std::shared_ptr<Math::Shape> shape1 = pair->getFirst()->getPosedShape();
-		std::shared_ptr<Math::Shape> shape2 = pair->getSecond()->getPosedShape();
+		// Use the posed shapes taken before the narrow phase if there are any, posing the shapes locks the
+		// representations
+		Math::PosedShape<std::shared_ptr<Math::Shape>> posedShape1 = pair->getPosedShapes().first;
+		Math::PosedShape<std::shared_ptr<Math::Shape>> posedShape2 = pair->getPosedShapes().second;
+		if (posedShape1.getShape() == nullptr || posedShape2.getShape() == nullptr)
+		{
+			posedShape1 = Math::PosedShape<std::shared_ptr<Math::Shape>>(pair->getFirst()->getPosedShape(),
+						  pair->getFirst()->getPose());
+			posedShape2 = Math::PosedShape<std::shared_ptr<Math::Shape>>(pair->getSecond()->getPosedShape(),
+						  pair->getSecond()->getPose());
+		}
 
-		Math::PosedShape<std::shared_ptr<Math::Shape>> posedShape1(shape1, pair->getFirst()->getPose());
-		Math::PosedShape<std::shared_ptr<Math::Shape>> posedShape2(shape2, pair->getSecond()->getPose());
-		contacts = doCalculateDcdContact(posedShape1, posedShape2);
+		const auto& cache = pair->getContactCache();
+		if (cache != nullptr)
+		{
+			// The cached data refers to the shapes in the order of the calculation
+			cache->setFirst(pair->getFirst().get());
+			contacts = doCalculateCachedDcdContact(posedShape1, posedShape2, cache.get());
+			cache->incrementAge();
+		}
+		else
+		{
+			contacts = doCalculateDcdContact(posedShape1, posedShape2);
+		}
 	}
 	else if (pair->getType() == Collision::CollisionDetectionType::COLLISION_DETECTION_TYPE_CONTINUOUS)
 	{
-		contacts = doCalculateCcdContact(
-					   pair->getFirst()->getPosedShapeMotion(),
-					   pair->getSecond()->getPosedShapeMotion());
+		const auto& cache = pair->getContactCache();
+		if (cache != nullptr)
+		{
+			cache->setFirst(pair->getFirst().get());
+			contacts = doCalculateCachedCcdContact(
+						   pair->getFirst()->getPosedShapeMotion(),
+						   pair->getSecond()->getPosedShapeMotion(), cache.get());
+			cache->incrementAge();
+		}
+		else
+		{
+			contacts = doCalculateCcdContact(
+						   pair->getFirst()->getPosedShapeMotion(),
+						   pair->getSecond()->getPosedShapeMotion());
+		}
 	}
 	else
 	{
@@ -198,6 +232,14 @@ std::list<std::shared_ptr<Contact>> ContactCalculation::doCalculateDcdContact(
 	return std::list<std::shared_ptr<Contact>>();
 }
 
+std::list<std::shared_ptr<Contact>> ContactCalculation::doCalculateCachedDcdContact(
+									 const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape1,
+									 const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape2,
+									 ContactCache* cache)
+{
+	return doCalculateDcdContact(posedShape1, posedShape2);
+}
+
 std::list<std::shared_ptr<Contact>> ContactCalculation::doCalculateCcdContact(
 									 const Math::PosedShapeMotion<std::shared_ptr<Math::Shape>>& posedShapeMotion1,
 									 const Math::PosedShapeMotion<std::shared_ptr<Math::Shape>>& posedShapeMotion2)
@@ -206,6 +248,14 @@ std::list<std::shared_ptr<Contact>> ContactCalculation::doCalculateCcdContact(
 	return std::list<std::shared_ptr<Contact>>();
 }
 
+std::list<std::shared_ptr<Contact>> ContactCalculation::doCalculateCachedCcdContact(
+									 const Math::PosedShapeMotion<std::shared_ptr<Math::Shape>>& posedShapeMotion1,
+									 const Math::PosedShapeMotion<std::shared_ptr<Math::Shape>>& posedShapeMotion2,
+									 ContactCache* cache)
+{
+	return doCalculateCcdContact(posedShapeMotion1, posedShapeMotion2);
+}
+
 void ContactCalculation::initializeTables()
 {
 	// Fill up both tables with default empty contact calculation
@@ -218,6 +268,23 @@ void ContactCalculation::initializeTables()
 		}
 	}
 
+	// Any pair of convex shapes without a dedicated calculation goes through the generic one
+	const std::array<int, 4> convexShapes =
+	{
+		Math::SHAPE_TYPE_BOX,
+		Math::SHAPE_TYPE_CAPSULE,
+		Math::SHAPE_TYPE_CYLINDER,
+		Math::SHAPE_TYPE_SPHERE
+	};
+	for (size_t i = 0; i < convexShapes.size(); ++i)
+	{
+		for (size_t j = i; j < convexShapes.size(); ++j)
+		{
+			ContactCalculation::privateDcdRegister(std::make_shared<Collision::ConvexContact>(
+					std::make_pair(convexShapes[i], convexShapes[j])));
+		}
+	}
+
 	// Fill up the Dcd contact calculation table
 	ContactCalculation::privateDcdRegister(std::make_shared<Collision::BoxCapsuleContact>());
 	ContactCalculation::privateDcdRegister(std::make_shared<Collision::BoxDoubleSidedPlaneContact>());
@@ -229,6 +296,9 @@ void ContactCalculation::initializeTables()
 	ContactCalculation::privateDcdRegister(std::make_shared<Collision::OctreePlaneContact>());
 	ContactCalculation::privateDcdRegister(std::make_shared<Collision::OctreeSphereContact>());
 	ContactCalculation::privateDcdRegister(std::make_shared<Collision::OctreeTriangleMeshContact>());
+	ContactCalculation::privateDcdRegister(std::make_shared<Collision::SdfParticlesContact>());
+	ContactCalculation::privateDcdRegister(std::make_shared<Collision::SdfSegmentMeshContact>());
+	ContactCalculation::privateDcdRegister(std::make_shared<Collision::SdfTriangleMeshContact>());
 	ContactCalculation::privateDcdRegister(std::make_shared<Collision::SegmentMeshTriangleMeshContact>());
 	ContactCalculation::privateDcdRegister(std::make_shared<Collision::SphereSphereContact>());
 	ContactCalculation::privateDcdRegister(std::make_shared<Collision::SphereDoubleSidedPlaneContact>());
@@ -251,7 +321,8 @@ void ContactCalculation::initializeTables()
 		Math::SHAPE_TYPE_SPHERE,
 		Math::SHAPE_TYPE_SURFACEMESH,
 		Math::SHAPE_TYPE_SEGMENTMESH,
-		Math::SHAPE_TYPE_COMPOUNDSHAPE
+		Math::SHAPE_TYPE_COMPOUNDSHAPE,
+		Math::SHAPE_TYPE_SDF
 	};
 
 	for (auto type : allshapes)
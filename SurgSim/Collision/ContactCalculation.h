@@ -34,6 +34,8 @@ class Shape;
 namespace Collision
 {
 
+class ContactCache;
+
 /// Base class responsible for calculating contact data between two objects.
 /// It is used for determining whether two objects intersect. If there is
 /// contact, new Contacts are calculated.
@@ -100,6 +102,16 @@ class ContactCalculation
 		const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape1,
 		const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape2);
 
+	/// Virtual function receives the call from doCalculateContact() for pairs that keep a cache between frames,
+	/// calculations that can take advantage of the cache override this, by default the cache is ignored
+	/// \param posedShape1, posedShape2 The two posed shapes to calculate dcd contact for
+	/// \param cache The data kept for the pair between frames, in the order of the given shapes
+	/// \return a list of dcd contacts between the two given posed shapes
+	virtual std::list<std::shared_ptr<Contact>> doCalculateCachedDcdContact(
+		const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape1,
+		const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape2,
+		ContactCache* cache);
+
 	/// Virtual function receives the call from the public interface, usually will type the
 	/// shapes statically to their known types and then execute a specific contact calculation
 	/// between the two shapes
@@ -109,6 +121,16 @@ class ContactCalculation
 		const Math::PosedShapeMotion<std::shared_ptr<Math::Shape>>& posedShapeMotion1,
 		const Math::PosedShapeMotion<std::shared_ptr<Math::Shape>>& posedShapeMotion2);
 
+	/// Virtual function receives the call from doCalculateContact() for pairs that keep a cache between frames,
+	/// calculations that can take advantage of the cache override this, by default the cache is ignored
+	/// \param posedShapeMotion1, posedShapeMotion2 The two posed shapes motion to calculate ccd contact for
+	/// \param cache The data kept for the pair between frames, in the order of the given shapes
+	/// \return a list of ccd contacts between the two given posed shapes motion
+	virtual std::list<std::shared_ptr<Contact>> doCalculateCachedCcdContact(
+		const Math::PosedShapeMotion<std::shared_ptr<Math::Shape>>& posedShapeMotion1,
+		const Math::PosedShapeMotion<std::shared_ptr<Math::Shape>>& posedShapeMotion2,
+		ContactCache* cache);
+
 	/// Statically initialize the tables, used via call once
 	static void initializeTables();
 
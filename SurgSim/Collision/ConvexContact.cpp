@@ -0,0 +1,94 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SurgSim/Collision/ConvexContact.h"
+
+#include "SurgSim/Collision/ContactArena.h"
+#include "SurgSim/Collision/ContactCache.h"
+#include "SurgSim/DataStructures/Location.h"
+#include "SurgSim/Math/ConvexPenetration.h"
+#include "SurgSim/Math/Shape.h"
+
+using SurgSim::DataStructures::Location;
+using SurgSim::Math::RigidTransform3d;
+using SurgSim::Math::Vector3d;
+
+namespace SurgSim
+{
+namespace Collision
+{
+
+ConvexContact::ConvexContact(const std::pair<int, int>& types) : m_types(types)
+{
+}
+
+std::pair<int, int> ConvexContact::getShapeTypes()
+{
+	return m_types;
+}
+
+std::list<std::shared_ptr<Contact>> ConvexContact::doCalculateDcdContact(
+									 const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape1,
+									 const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape2)
+{
+	Vector3d searchDirection = Vector3d::Zero();
+	return calculateConvexContact(posedShape1, posedShape2, &searchDirection);
+}
+
+std::list<std::shared_ptr<Contact>> ConvexContact::doCalculateCachedDcdContact(
+									 const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape1,
+									 const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape2,
+									 ContactCache* cache)
+{
+	Vector3d searchDirection = Vector3d::Zero();
+	cache->getSeparatingAxis(&searchDirection);
+	auto contacts = calculateConvexContact(posedShape1, posedShape2, &searchDirection);
+	cache->setSeparatingAxis(searchDirection);
+	return contacts;
+}
+
+std::list<std::shared_ptr<Contact>> ConvexContact::calculateConvexContact(
+									 const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape1,
+									 const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape2,
+									 Vector3d* searchDirection) const
+{
+	const Math::Shape& shape1 = *posedShape1.getShape();
+	const Math::Shape& shape2 = *posedShape2.getShape();
+
+	// Transformable shapes are already posed
+	const RigidTransform3d& pose1 = posedShape1.getPose();
+	const RigidTransform3d& pose2 = posedShape2.getPose();
+	const RigidTransform3d shapePose1 = shape1.isTransformable() ? RigidTransform3d::Identity() : pose1;
+	const RigidTransform3d shapePose2 = shape2.isTransformable() ? RigidTransform3d::Identity() : pose2;
+
+	std::list<std::shared_ptr<Contact>> contacts;
+	Vector3d normal, point1, point2;
+	double depth;
+	if (Math::calculateConvexPenetration(shape1, shapePose1, shape2, shapePose2, searchDirection,
+										 &normal, &depth, &point1, &point2))
+	{
+		std::pair<Location, Location> penetrationPoints;
+		penetrationPoints.first.rigidLocalPosition.setValue(pose1.inverse() * point1);
+		penetrationPoints.second.rigidLocalPosition.setValue(pose2.inverse() * point2);
+
+		contacts.emplace_back(ContactArena::makeContact(
+								  COLLISION_DETECTION_TYPE_DISCRETE, depth, 1.0,
+								  0.5 * (point1 + point2), normal, penetrationPoints));
+	}
+	return contacts;
+}
+
+}; // namespace Collision
+}; // namespace SurgSim
@@ -0,0 +1,67 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SURGSIM_COLLISION_CONVEXCONTACT_H
+#define SURGSIM_COLLISION_CONVEXCONTACT_H
+
+#include "SurgSim/Collision/ContactCalculation.h"
+
+namespace SurgSim
+{
+
+namespace Collision
+{
+
+/// Generic contact calculation between two convex shapes (see Math::Shape::isConvex()), based only on their support
+/// functions through Math::calculateConvexPenetration(). It is registered for every pair of convex shapes that does
+/// not have a dedicated calculation, and produces at most one contact, at the deepest penetration.
+/// With a contact cache the last search direction is kept for the pair, which usually resolves separated shapes in
+/// a single iteration in the next frame.
+class ConvexContact : public ContactCalculation
+{
+public:
+	/// Constructor
+	/// \param types the types of the shapes, both need to be convex
+	explicit ConvexContact(const std::pair<int, int>& types);
+
+	std::pair<int, int> getShapeTypes() override;
+
+private:
+	std::list<std::shared_ptr<Contact>> doCalculateDcdContact(
+		const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape1,
+		const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape2) override;
+
+	std::list<std::shared_ptr<Contact>> doCalculateCachedDcdContact(
+		const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape1,
+		const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape2,
+		ContactCache* cache) override;
+
+	/// Calculate the contact between the shapes
+	/// \param posedShape1, posedShape2 the two posed shapes
+	/// \param [in,out] searchDirection the initial search direction, the last one on return
+	/// \return the contacts between the shapes, at most one
+	std::list<std::shared_ptr<Contact>> calculateConvexContact(
+		const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape1,
+		const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape2,
+		Math::Vector3d* searchDirection) const;
+
+	/// The shape types of this instance
+	std::pair<int, int> m_types;
+};
+
+}; // namespace Collision
+}; // namespace SurgSim
+
+#endif // SURGSIM_COLLISION_CONVEXCONTACT_H
@@ -15,12 +15,17 @@
 
 #include "SurgSim/Collision/OctreeContact.h"
 
+#include <array>
 #include <boost/functional/hash.hpp>
+#include <vector>
 
 #include "SurgSim/Collision/CollisionPair.h"
 #include "SurgSim/Collision/Representation.h"
 #include "SurgSim/Collision/ShapeCollisionRepresentation.h"
+#include "SurgSim/Framework/Assert.h"
 #include "SurgSim/Math/BoxShape.h"
+#include "SurgSim/Math/Geometry.h"
+#include "SurgSim/Math/Matrix.h"
 #include "SurgSim/Math/Shape.h"
 #include "SurgSim/Math/Vector.h"
 
@@ -30,6 +35,86 @@ namespace SurgSim
 namespace Collision
 {
 
+namespace
+{
+
+/// The size of the stack of the depth first traversal of the octree, a node can only add its children after being
+/// popped, so the stack holds at most 7 nodes per level plus the one being processed
+const size_t MaxStackSize = 7 * 32 + 1;
+
+/// Oriented box, for the separating axis test against the axis aligned nodes of an octree
+class OrientedBox
+{
+public:
+	/// Constructor
+	/// \param pose the pose of the box, relative to the frame of the nodes
+	/// \param boundingBox the box, in its local frame
+	OrientedBox(const Math::RigidTransform3d& pose, const Math::Aabbd& boundingBox)
+	{
+		if (!boundingBox.isEmpty())
+		{
+			m_center = pose * boundingBox.center();
+			m_rotation = pose.linear();
+			m_absRotation = m_rotation.cwiseAbs().array() + Math::Geometry::DistanceEpsilon;
+			m_halfSizes = 0.5 * boundingBox.sizes();
+			m_extents = m_absRotation * m_halfSizes;
+		}
+	}
+
+	/// Separating axis test against an axis aligned box, see Gottschalk et al. "OBBTree: A Hierarchical
+	/// Structure for Rapid Interference Detection"
+	/// \param center the center of the axis aligned box
+	/// \param halfSizes half of the sizes of the axis aligned box
+	/// \return true if the boxes overlap
+	bool intersects(const Math::Vector3d& center, const Math::Vector3d& halfSizes) const
+	{
+		const Math::Vector3d t = m_center - center;
+
+		// Axes of the axis aligned box, this is the test of the bounding box of this box
+		if (((t.cwiseAbs() - m_extents - halfSizes).array() > Math::Geometry::DistanceEpsilon).any())
+		{
+			return false;
+		}
+
+		// Axes of this box
+		const Math::Vector3d projection = m_rotation.transpose() * t;
+		const Math::Vector3d radius = m_absRotation.transpose() * halfSizes + m_halfSizes;
+		if (((projection.cwiseAbs() - radius).array() > Math::Geometry::DistanceEpsilon).any())
+		{
+			return false;
+		}
+
+		// Cross products of the axes
+		for (int i = 0; i < 3; ++i)
+		{
+			const int i1 = (i + 1) % 3;
+			const int i2 = (i + 2) % 3;
+			for (int j = 0; j < 3; ++j)
+			{
+				const int j1 = (j + 1) % 3;
+				const int j2 = (j + 2) % 3;
+				const double distance = std::abs(t[i2] * m_rotation(i1, j) - t[i1] * m_rotation(i2, j));
+				const double radiusA = halfSizes[i1] * m_absRotation(i2, j) + halfSizes[i2] * m_absRotation(i1, j);
+				const double radiusB = m_halfSizes[j1] * m_absRotation(i, j2) + m_halfSizes[j2] * m_absRotation(i, j1);
+				if (distance > radiusA + radiusB + Math::Geometry::DistanceEpsilon)
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+private:
+	Math::Vector3d m_center;
+	Math::Matrix33d m_rotation;
+	Math::Matrix33d m_absRotation;
+	Math::Vector3d m_halfSizes;
+	Math::Vector3d m_extents;
+};
+
+}
+
 size_t OctreeContact::Vector3dHash::operator()(const SurgSim::Math::Vector3d& id) const
 {
 	return boost::hash_range(id.data(), id.data() + 3);
@@ -43,81 +128,118 @@ std::list<std::shared_ptr<Contact>> OctreeContact::doCalculateDcdContact(
 	SURGSIM_ASSERT(posedShape1.getShape()->getType() == Math::SHAPE_TYPE_OCTREE) <<
 		"Octree Contact needs an OctreeShape.";
 
-	SurgSim::DataStructures::OctreePath nodePath;
 	std::list<std::shared_ptr<Contact>> result;
-	std::shared_ptr<Math::OctreeShape> shape = std::static_pointer_cast<Math::OctreeShape>(posedShape1.getShape());
+	const Math::OctreeShape& shape = static_cast<const Math::OctreeShape&>(*posedShape1.getShape());
 
-	calculateContactWithNode(shape->getOctree(), posedShape1.getPose(),
-		posedShape2.getShape(), posedShape2.getPose(), &nodePath, &result);
+	calculateContactWithNodes(shape, posedShape1.getPose(), posedShape2.getShape(), posedShape2.getPose(), &result);
 
 	return result;
 }
 
-void OctreeContact::calculateContactWithNode(
-	std::shared_ptr<const Math::OctreeShape::NodeType> node,
-	Math::RigidTransform3d octreePose,
+std::shared_ptr<Math::BoxShape> OctreeContact::getBoxShape(const Math::Vector3d& size)
+{
+	boost::lock_guard<boost::mutex> guard(m_shapesMutex);
+	auto& boxShape = m_shapes[size];
+	if (boxShape == nullptr)
+	{
+		boxShape = std::make_shared<SurgSim::Math::BoxShape>(size.x(), size.y(), size.z());
+	}
+	return boxShape;
+}
+
+void OctreeContact::calculateContactWithNodes(
+	const Math::OctreeShape& octree,
+	const Math::RigidTransform3d& octreePose,
 	const std::shared_ptr<Math::Shape>& shape,
 	const Math::RigidTransform3d& shapePose,
-	SurgSim::DataStructures::OctreePath* nodePath,
 	std::list<std::shared_ptr<Contact>>* result)
 {
-	if (! node->isActive())
+	// The snapshot stays valid even if the octree is rebuilt by another thread during the traversal
+	const auto flatOctreeSnapshot = octree.getFlatOctree();
+	const auto& flatOctree = *flatOctreeSnapshot;
+	if (flatOctree.isEmpty())
 	{
 		return;
 	}
 
-	auto nodeBoundingBox = Math::transformAabb(octreePose, node->getBoundingBox());
-	auto shapeBoundingBox = shape->getBoundingBox();
+	// The bounding box of the shape, as an oriented box in the octree's local coordinates
+	const Math::Aabbd& shapeBoundingBox = shape->getBoundingBox();
+	const bool isBounded = !shapeBoundingBox.isEmpty();
+	Math::RigidTransform3d boxPose = octreePose.inverse();
 	if (!shape->isTransformable())
 	{
-		shapeBoundingBox = Math::transformAabb(shapePose, shapeBoundingBox);
-	}
-	if (!shapeBoundingBox.isEmpty() && !Math::doAabbIntersect(nodeBoundingBox, shapeBoundingBox))
-	{
-		return;
+		boxPose = boxPose * shapePose;
 	}
+	const OrientedBox box(boxPose, shapeBoundingBox);
 
-	Math::Vector3d nodeSize = node->getBoundingBox().sizes();
+	const auto& centers = flatOctree.getCenters();
+	const auto& halfSizes = flatOctree.getHalfSizes();
+
+	Math::Vector3d lastSize = Math::Vector3d::Constant(-1.0);
 	std::shared_ptr<Math::BoxShape> nodeShape;
-	if (m_shapes.count(nodeSize) > 0)
+	auto getNodePose = [&octreePose, &centers](size_t node)
 	{
-		nodeShape = m_shapes[nodeSize];
-	}
-	else
+		Math::RigidTransform3d nodePose = octreePose;
+		nodePose.translation() += nodePose.linear() * centers.row(node).transpose();
+		return nodePose;
+	};
+	auto getNodeShape = [this, &halfSizes, &lastSize, &nodeShape](size_t node) -> const Math::BoxShape&
 	{
-		nodeShape = std::make_shared<SurgSim::Math::BoxShape>(nodeSize.x(), nodeSize.y(), nodeSize.z());
-		m_shapes[nodeSize] = nodeShape;
-	}
+		Math::Vector3d size = 2.0 * halfSizes.row(node).transpose();
+		if (size != lastSize)
+		{
+			nodeShape = getBoxShape(size);
+			lastSize = size;
+		}
+		return *nodeShape;
+	};
+
+	// Depth first traversal
+	SURGSIM_ASSERT(7 * flatOctree.getDepth() + 1 <= MaxStackSize) << "The octree is too deep for the traversal.";
+	std::array<size_t, MaxStackSize> stack;
+	size_t stackSize = 0;
+	stack[stackSize++] = 0;
+	SurgSim::DataStructures::OctreePath nodePath;
+	while (stackSize > 0)
+	{
+		const size_t node = stack[--stackSize];
 
-	Math::Vector3d nodeCenter = node->getBoundingBox().center();
-	Math::RigidTransform3d nodePose = octreePose;
-	nodePose.translation() += nodePose.linear() * nodeCenter;
+		if (!flatOctree.isActive(node) ||
+			(isBounded && !box.intersects(centers.row(node).transpose(), halfSizes.row(node).transpose())))
+		{
+			continue;
+		}
 
-	if (node->hasChildren())
-	{
-		if ((!shapeBoundingBox.isEmpty() && nodeBoundingBox.contains(shapeBoundingBox)) ||
-			 !boxContactCalculation(*nodeShape, nodePose, *shape, shapePose).empty())
+		if (flatOctree.hasChildren(node))
 		{
-			for (size_t i = 0; i < node->getChildren().size(); i++)
+			if (isBounded || !boxContactCalculation(getNodeShape(node), getNodePose(node), *shape, shapePose).empty())
 			{
-				nodePath->push_back(i);
-				calculateContactWithNode(node->getChild(i), octreePose, shape, shapePose, nodePath, result);
-				nodePath->pop_back();
+				// Push in reverse to visit the children in order
+				const size_t firstChild = flatOctree.getFirstChild(node);
+				for (size_t child = firstChild + flatOctree.getNumChildren(node); child > firstChild; --child)
+				{
+					stack[stackSize++] = child - 1;
+				}
 			}
 		}
-	}
-	else
-	{
-		auto contacts = boxContactCalculation(*nodeShape, nodePose, *shape, shapePose);
-		for (auto& contact : contacts)
+		else
 		{
-			contact->penetrationPoints.first.octreeNodePath.setValue(*nodePath);
-
-			Math::Vector3d contactPosition = contact->penetrationPoints.first.rigidLocalPosition.getValue();
-			contactPosition += nodeCenter;
-			contact->penetrationPoints.first.rigidLocalPosition.setValue(contactPosition);
+			auto contacts = boxContactCalculation(getNodeShape(node), getNodePose(node), *shape, shapePose);
+			if (!contacts.empty())
+			{
+				flatOctree.getPath(node, &nodePath);
+				const Math::Vector3d nodeCenter = centers.row(node).transpose();
+				for (auto& contact : contacts)
+				{
+					contact->penetrationPoints.first.octreeNodePath.setValue(nodePath);
+
+					Math::Vector3d contactPosition = contact->penetrationPoints.first.rigidLocalPosition.getValue();
+					contactPosition += nodeCenter;
+					contact->penetrationPoints.first.rigidLocalPosition.setValue(contactPosition);
+				}
+				result->splice(result->end(), contacts);
+			}
 		}
-		result->splice(result->end(), contacts);
 	}
 }
 
@@ -16,7 +16,9 @@
 #ifndef SURGSIM_COLLISION_OCTREECONTACT_H
 #define SURGSIM_COLLISION_OCTREECONTACT_H
 
+#include <boost/thread/mutex.hpp>
 #include <memory>
+#include <unordered_map>
 
 #include "SurgSim/Collision/ContactCalculation.h"
 #include "SurgSim/Math/BoxShape.h"
@@ -53,26 +55,28 @@ class OctreeContact : public ContactCalculation
 		const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape1,
 		const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape2) override;
 
-	/// Calculate the collision between a specific octree node and a shape
-	/// This function will check for contact between the node and shape. If
-	/// contact is found, this function will be called on each of the
-	/// node's children. Once a leaf node is reached, contacts are added to the
-	/// CollisionPair.
-	/// \param node the octree node to collide with
+	/// Calculate the collision between the nodes of an octree and a shape
+	/// The linearized octree is traversed depth first, the children of a node are only visited if the node's
+	/// bounding box overlaps the oriented bounding box of the shape. The exact contact calculation is only done
+	/// for the leaf nodes, except for unbounded shapes (e.g. planes) where it is also used to cull the internal
+	/// nodes. Contacts are generated in the same order as a recursive traversal visiting the children in order.
+	/// \param octree the octree shape to collide with
 	/// \param octreePose the pose of the octree shape
 	/// \param shape the shape that the octree is colliding with
 	/// \param shapePose the pose of the shape
-	/// \param nodePath the NodePath of the current octree node
 	/// \param result [in,out] all generated contacts are agreggated here
-	/// \param nodePath [in,out] the path of the current node
-	void calculateContactWithNode(
-		std::shared_ptr<const SurgSim::Math::OctreeShape::NodeType> node,
-		Math::RigidTransform3d octreePose,
+	void calculateContactWithNodes(
+		const Math::OctreeShape& octree,
+		const Math::RigidTransform3d& octreePose,
 		const std::shared_ptr<Math::Shape>& shape,
 		const Math::RigidTransform3d& shapePose,
-		SurgSim::DataStructures::OctreePath* nodePath,
 		std::list<std::shared_ptr<Contact>>* result);
 
+	/// Get the box shape used for the nodes of a given size, thread safe
+	/// \param size the sizes of the box
+	/// \return the cached box shape
+	std::shared_ptr<SurgSim::Math::BoxShape> getBoxShape(const SurgSim::Math::Vector3d& size);
+
 	/// Enable a Vector3d to be used as a key in an unordered map.
 	class Vector3dHash
 	{
@@ -82,6 +86,9 @@ class OctreeContact : public ContactCalculation
 
 	/// The shapes used for the contact calculations are cached for performance.
 	std::unordered_map<SurgSim::Math::Vector3d, std::shared_ptr<SurgSim::Math::BoxShape>, Vector3dHash> m_shapes;
+
+	/// Protects the cache of shapes, the calculation can run for several pairs at the same time
+	boost::mutex m_shapesMutex;
 };
 
 };
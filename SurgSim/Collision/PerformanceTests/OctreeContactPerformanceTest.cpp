@@ -0,0 +1,133 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <boost/lexical_cast.hpp>
+#include <memory>
+
+#include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/OctreeCapsuleContact.h"
+#include "SurgSim/Collision/OctreeSphereContact.h"
+#include "SurgSim/Collision/ShapeCollisionRepresentation.h"
+#include "SurgSim/Framework/Timer.h"
+#include "SurgSim/Math/CapsuleShape.h"
+#include "SurgSim/Math/OctreeShape.h"
+#include "SurgSim/Math/Quaternion.h"
+#include "SurgSim/Math/RigidTransform.h"
+#include "SurgSim/Math/SphereShape.h"
+#include "SurgSim/Math/Vector.h"
+
+using SurgSim::Math::Aabbd;
+using SurgSim::Math::OctreeShape;
+using SurgSim::Math::RigidTransform3d;
+using SurgSim::Math::Vector3d;
+
+namespace
+{
+
+/// Build an octree shaped like a spherical shell, e.g. a skull, with the given number of levels
+std::shared_ptr<OctreeShape> buildShellOctree(int numLevels, double radius, double thickness)
+{
+	auto root = std::make_shared<OctreeShape::NodeType>(Aabbd(Vector3d::Constant(-radius),
+			Vector3d::Constant(radius)));
+
+	const int cellsPerSide = 1 << (numLevels - 1);
+	const double cellSize = 2.0 * radius / cellsPerSide;
+	for (int i = 0; i < cellsPerSide; ++i)
+	{
+		for (int j = 0; j < cellsPerSide; ++j)
+		{
+			for (int k = 0; k < cellsPerSide; ++k)
+			{
+				Vector3d position = Vector3d(i + 0.5, j + 0.5, k + 0.5) * cellSize - Vector3d::Constant(radius);
+				double distance = position.norm();
+				if (distance < radius && distance > radius - thickness)
+				{
+					root->addData(position, numLevels);
+				}
+			}
+		}
+	}
+
+	auto shape = std::make_shared<OctreeShape>();
+	shape->setOctree(root);
+	return shape;
+}
+
+/// Move a shape over the surface of the octree, and time the contact calculation
+void timeContacts(const std::string& name, std::shared_ptr<SurgSim::Math::Shape> shape,
+				  SurgSim::Collision::ContactCalculation* calculator)
+{
+	using SurgSim::Collision::CollisionPair;
+	using SurgSim::Collision::ShapeCollisionRepresentation;
+
+	const double radius = 0.1;
+	auto octreeRep = std::make_shared<ShapeCollisionRepresentation>("Octree");
+	octreeRep->setShape(buildShellOctree(8, radius, 0.01));
+
+	auto shapeRep = std::make_shared<ShapeCollisionRepresentation>(name);
+	shapeRep->setShape(shape);
+
+	auto pair = std::make_shared<CollisionPair>(octreeRep, shapeRep);
+
+	SurgSim::Framework::Timer timer;
+	const int loops = 100;
+	size_t contacts = 0;
+	for (int i = 0; i < loops; ++i)
+	{
+		pair->clearContacts();
+		octreeRep->getCollisions().unsafeGet().clear();
+		shapeRep->getCollisions().unsafeGet().clear();
+		const double angle = 2.0 * M_PI * i / loops;
+		Vector3d direction(std::cos(angle), std::sin(angle), 0.3);
+		direction.normalize();
+		shapeRep->setLocalPose(SurgSim::Math::makeRigidTransform(
+								   SurgSim::Math::makeRotationQuaternion(angle, Vector3d::UnitZ().eval()),
+								   direction * radius));
+		timer.beginFrame();
+		calculator->calculateContact(pair);
+		timer.endFrame();
+		contacts += pair->getContacts().size();
+	}
+	EXPECT_LT(0u, contacts);
+
+	::testing::Test::RecordProperty("FrameRate", boost::lexical_cast<std::string>(loops / timer.getCumulativeTime()));
+	::testing::Test::RecordProperty("Duration", boost::lexical_cast<std::string>(timer.getCumulativeTime()));
+	::testing::Test::RecordProperty("Loops", boost::lexical_cast<std::string>(loops));
+	::testing::Test::RecordProperty("Contacts", boost::lexical_cast<std::string>(contacts));
+}
+
+}
+
+namespace SurgSim
+{
+namespace Collision
+{
+
+TEST(OctreeContactPerformanceTests, SphereTest)
+{
+	OctreeSphereContact calculator;
+	timeContacts("Sphere", std::make_shared<Math::SphereShape>(0.01), &calculator);
+}
+
+TEST(OctreeContactPerformanceTests, CapsuleTest)
+{
+	OctreeCapsuleContact calculator;
+	timeContacts("Capsule", std::make_shared<Math::CapsuleShape>(0.05, 0.005), &calculator);
+}
+
+}
+}
@@ -0,0 +1,64 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SurgSim/Collision/SdfParticlesContact.h"
+
+#include "SurgSim/Collision/ContactArena.h"
+#include "SurgSim/DataStructures/Location.h"
+#include "SurgSim/Math/Vector.h"
+
+using SurgSim::DataStructures::Location;
+using SurgSim::Math::RigidTransform3d;
+using SurgSim::Math::Vector3d;
+
+namespace SurgSim
+{
+namespace Collision
+{
+
+std::pair<int, int> SdfParticlesContact::getShapeTypes()
+{
+	return std::pair<int, int>(Math::SHAPE_TYPE_SDF, Math::SHAPE_TYPE_PARTICLES);
+}
+
+std::list<std::shared_ptr<Contact>> SdfParticlesContact::calculateDcdContact(
+									 const Math::SdfShape& sdf,
+									 const Math::RigidTransform3d& sdfPose,
+									 const Math::ParticlesShape& particles,
+									 const Math::RigidTransform3d&) const
+{
+	std::list<std::shared_ptr<Contact>> contacts;
+	const RigidTransform3d sdfPoseInverse = sdfPose.inverse();
+	const double radius = particles.getRadius();
+	double depth;
+	Vector3d normal, surfacePoint;
+
+	const auto& vertices = particles.getVertices();
+	for (size_t particle = 0; particle < vertices.size(); ++particle)
+	{
+		if (sdf.calculatePenetration(sdfPoseInverse * vertices[particle].position, radius,
+									 &depth, &normal, &surfacePoint))
+		{
+			auto penetrationPoints = std::make_pair(Location(surfacePoint), Location(particle));
+			contacts.push_back(ContactArena::makeContact(
+								   COLLISION_DETECTION_TYPE_DISCRETE, depth, 1.0,
+								   sdfPose * surfacePoint, -(sdfPose.linear() * normal), penetrationPoints));
+		}
+	}
+	return contacts;
+}
+
+}; // namespace Collision
+}; // namespace SurgSim
@@ -0,0 +1,62 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SurgSim/Collision/SdfSegmentMeshContact.h"
+
+#include "SurgSim/Collision/ContactArena.h"
+#include "SurgSim/DataStructures/IndexedLocalCoordinate.h"
+#include "SurgSim/DataStructures/Location.h"
+#include "SurgSim/Math/Vector.h"
+
+using SurgSim::DataStructures::IndexedLocalCoordinate;
+using SurgSim::DataStructures::Location;
+using SurgSim::Math::Vector3d;
+
+namespace SurgSim
+{
+namespace Collision
+{
+
+std::pair<int, int> SdfSegmentMeshContact::getShapeTypes()
+{
+	return std::pair<int, int>(Math::SHAPE_TYPE_SDF, Math::SHAPE_TYPE_SEGMENTMESH);
+}
+
+std::list<std::shared_ptr<Contact>> SdfSegmentMeshContact::calculateDcdContact(
+									 const Math::SdfShape& sdf,
+									 const Math::RigidTransform3d& sdfPose,
+									 const Math::SegmentMeshShape& segmentMesh,
+									 const Math::RigidTransform3d&) const
+{
+	std::list<std::shared_ptr<Contact>> contacts;
+
+	sdf.calculateVerticesPenetration(segmentMesh, segmentMesh.getEdges(), sdfPose.inverse(), segmentMesh.getRadius(),
+		[&contacts, &sdfPose](size_t segmentId, size_t i, double depth, const Vector3d& normal,
+							  const Vector3d& surfacePoint)
+	{
+		Math::Vector coordinates = Math::Vector::Zero(2);
+		coordinates[i] = 1.0;
+		Location segmentLocation(IndexedLocalCoordinate(segmentId, coordinates), Location::ELEMENT);
+
+		auto penetrationPoints = std::make_pair(Location(surfacePoint), segmentLocation);
+		contacts.push_back(ContactArena::makeContact(
+							   COLLISION_DETECTION_TYPE_DISCRETE, depth, 1.0,
+							   sdfPose * surfacePoint, -(sdfPose.linear() * normal), penetrationPoints));
+	});
+	return contacts;
+}
+
+}; // namespace Collision
+}; // namespace SurgSim
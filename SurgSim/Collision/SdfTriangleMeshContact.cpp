@@ -0,0 +1,63 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SurgSim/Collision/SdfTriangleMeshContact.h"
+
+#include "SurgSim/Collision/ContactArena.h"
+#include "SurgSim/DataStructures/IndexedLocalCoordinate.h"
+#include "SurgSim/DataStructures/Location.h"
+#include "SurgSim/Math/Vector.h"
+
+using SurgSim::DataStructures::IndexedLocalCoordinate;
+using SurgSim::DataStructures::Location;
+using SurgSim::Math::Vector3d;
+
+namespace SurgSim
+{
+namespace Collision
+{
+
+std::pair<int, int> SdfTriangleMeshContact::getShapeTypes()
+{
+	return std::pair<int, int>(Math::SHAPE_TYPE_SDF, Math::SHAPE_TYPE_MESH);
+}
+
+std::list<std::shared_ptr<Contact>> SdfTriangleMeshContact::calculateDcdContact(
+									 const Math::SdfShape& sdf,
+									 const Math::RigidTransform3d& sdfPose,
+									 const Math::MeshShape& mesh,
+									 const Math::RigidTransform3d&) const
+{
+	std::list<std::shared_ptr<Contact>> contacts;
+
+	sdf.calculateVerticesPenetration(mesh, mesh.getTriangles(), sdfPose.inverse(), 0.0,
+		[&contacts, &sdfPose](size_t triangleId, size_t i, double depth, const Vector3d& normal,
+							  const Vector3d& surfacePoint)
+	{
+		Math::Vector coordinates = Math::Vector::Zero(3);
+		coordinates[i] = 1.0;
+		Location meshLocation(IndexedLocalCoordinate(triangleId, coordinates), Location::TRIANGLE);
+		meshLocation.elementMeshLocalCoordinate = meshLocation.triangleMeshLocalCoordinate;
+
+		auto penetrationPoints = std::make_pair(Location(surfacePoint), meshLocation);
+		contacts.push_back(ContactArena::makeContact(
+							   COLLISION_DETECTION_TYPE_DISCRETE, depth, 1.0,
+							   sdfPose * surfacePoint, -(sdfPose.linear() * normal), penetrationPoints));
+	});
+	return contacts;
+}
+
+}; // namespace Collision
+}; // namespace SurgSim
@@ -16,9 +16,9 @@
 #include "SurgSim/Collision/SegmentMeshTriangleMeshContact.h"
 
 #include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/ContactArena.h"
 #include "SurgSim/Collision/Representation.h"
-#include "SurgSim/DataStructures/AabbTree.h"
-#include "SurgSim/DataStructures/AabbTreeNode.h"
+#include "SurgSim/DataStructures/FlatAabbTree.h"
 #include "SurgSim/DataStructures/IndexedLocalCoordinate.h"
 #include "SurgSim/DataStructures/TriangleMesh.h"
 #include "SurgSim/Math/Geometry.h"
@@ -71,24 +71,30 @@ std::list<std::shared_ptr<Contact>> SegmentMeshTriangleMeshContact::calculateDcd
 {
 	std::list<std::shared_ptr<Contact>> contacts;
 
-	std::list<SurgSim::DataStructures::AabbTree::TreeNodePairType> intersectionList
-		= segmentMeshShape.getAabbTree()->spatialJoin(*triangleMeshShape.getAabbTree());
+	const SurgSim::DataStructures::FlatAabbTree& segmentTree = *segmentMeshShape.getFlatAabbTree();
+	const SurgSim::DataStructures::FlatAabbTree& triangleTree = *triangleMeshShape.getFlatAabbTree();
+
+	std::vector<SurgSim::DataStructures::FlatAabbTree::NodePairType> intersectionList;
+	segmentTree.spatialJoin(triangleTree, &intersectionList);
 
 	double radius = segmentMeshShape.getRadius();
 	double depth = 0.0;
 	Vector3d normal;
 	Vector3d penetrationPointCapsule, penetrationPointTriangle, penetrationPointCapsuleAxis;
 
+	std::vector<size_t> edgeList;
+	std::vector<size_t> triangleList;
+
 	for (const auto& intersection : intersectionList)
 	{
-		std::shared_ptr<SurgSim::DataStructures::AabbTreeNode> nodeSegment = intersection.first;
-		std::shared_ptr<SurgSim::DataStructures::AabbTreeNode> nodeTriangle = intersection.second;
+		size_t nodeSegment = intersection.first;
+		size_t nodeTriangle = intersection.second;
 
-		std::list<size_t> edgeList;
-		std::list<size_t> triangleList;
+		edgeList.clear();
+		triangleList.clear();
 
-		nodeSegment->getIntersections(nodeTriangle->getAabb(), &edgeList);
-		nodeTriangle->getIntersections(nodeSegment->getAabb(), &triangleList);
+		segmentTree.getNodeIntersections(nodeSegment, triangleTree.getNodeAabb(nodeTriangle), &edgeList);
+		triangleTree.getNodeIntersections(nodeTriangle, segmentTree.getNodeAabb(nodeSegment), &triangleList);
 
 		for (auto i = triangleList.begin(); i != triangleList.end(); ++i)
 		{
@@ -137,7 +143,7 @@ std::list<std::shared_ptr<Contact>> SegmentMeshTriangleMeshContact::calculateDcd
 						triangleMeshPose.inverse() * penetrationPointTriangle);
 
 					// Create the contact.
-					contacts.push_back(std::make_shared<Contact>(COLLISION_DETECTION_TYPE_DISCRETE,
+					contacts.push_back(ContactArena::makeContact(COLLISION_DETECTION_TYPE_DISCRETE,
 									   std::abs(depth) +
 									   (penetrationPointCapsule - penetrationPointCapsuleAxis).dot(normal),
 									   1.0, Vector3d::Zero(), -normal, penetrationPoints));
@@ -397,7 +403,7 @@ std::list<std::shared_ptr<Contact>>SegmentMeshTriangleMeshContact::calculateCcdC
 			// e.g. part of a rigid body
 			locationTriangle.rigidLocalPosition = pose2AtTime1.inverse() * T;
 
-			auto contact = std::make_shared<Contact>(
+			auto contact = ContactArena::makeContact(
 							   COLLISION_DETECTION_TYPE_CONTINUOUS,
 							   penentrationDepthAtT1,
 							   earliestTimeOfImpact,
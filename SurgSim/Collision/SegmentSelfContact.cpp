@@ -15,10 +15,14 @@
 
 #include "SurgSim/Collision/SegmentSelfContact.h"
 
+#include <algorithm>
+
+#include "SurgSim/Collision/ContactArena.h"
+#include "SurgSim/Collision/ContactCache.h"
 #include "SurgSim/Collision/Representation.h"
 #include "SurgSim/Collision/SegmentSegmentCcdMovingContact.h"
 #include "SurgSim/Collision/SegmentSegmentCcdStaticContact.h"
-#include "SurgSim/DataStructures/AabbTreeNode.h"
+#include "SurgSim/DataStructures/FlatAabbTree.h"
 #include "SurgSim/DataStructures/Location.h"
 #include "SurgSim/Math/MeshShape.h"
 #include "SurgSim/Math/Scalar.h"
@@ -89,11 +93,43 @@ std::list<std::shared_ptr<Contact>> SegmentSelfContact::calculateCcdContact(
 									 const Math::SegmentMeshShape& segmentShape2AtTime1,
 									 const Math::RigidTransform3d& segmentPose2AtTime1) const
 {
+	DataStructures::FlatAabbTree tree;
+	return calculateSelfCcdContact(segmentShape1AtTime0, segmentPose1AtTime0,
+								   segmentShape1AtTime1, segmentPose1AtTime1, &tree);
+}
 
-	const Math::SegmentMeshShape& segmentShape1 = segmentShape1AtTime0;
-	const Math::RigidTransform3d& segmentPose1 = segmentPose1AtTime0;
-	const Math::SegmentMeshShape& segmentShape2 = segmentShape1AtTime1;
-	const Math::RigidTransform3d& segmentPose2 = segmentPose1AtTime1;
+std::list<std::shared_ptr<Contact>> SegmentSelfContact::calculateCachedCcdContact(
+									 const Math::SegmentMeshShape& segmentShape1AtTime0,
+									 const Math::RigidTransform3d& segmentPose1AtTime0,
+									 const Math::SegmentMeshShape& segmentShape1AtTime1,
+									 const Math::RigidTransform3d& segmentPose1AtTime1,
+									 const Math::SegmentMeshShape& segmentShape2AtTime0,
+									 const Math::RigidTransform3d& segmentPose2AtTime0,
+									 const Math::SegmentMeshShape& segmentShape2AtTime1,
+									 const Math::RigidTransform3d& segmentPose2AtTime1,
+									 ContactCache* cache) const
+{
+	// The swept volumes of the segments are kept from one time step to the next, and refitted as long as the
+	// mesh keeps the same segments
+	if (cache->getAabbTree() == nullptr)
+	{
+		cache->setAabbTree(std::make_shared<DataStructures::FlatAabbTree>());
+	}
+	return calculateSelfCcdContact(segmentShape1AtTime0, segmentPose1AtTime0,
+								   segmentShape1AtTime1, segmentPose1AtTime1, cache->getAabbTree().get());
+}
+
+std::list<std::shared_ptr<Contact>> SegmentSelfContact::calculateSelfCcdContact(
+									 const Math::SegmentMeshShape& segmentShapeAtTime0,
+									 const Math::RigidTransform3d& segmentPoseAtTime0,
+									 const Math::SegmentMeshShape& segmentShapeAtTime1,
+									 const Math::RigidTransform3d& segmentPoseAtTime1,
+									 DataStructures::FlatAabbTree* tree) const
+{
+	const Math::SegmentMeshShape& segmentShape1 = segmentShapeAtTime0;
+	const Math::RigidTransform3d& segmentPose1 = segmentPoseAtTime0;
+	const Math::SegmentMeshShape& segmentShape2 = segmentShapeAtTime1;
+	const Math::RigidTransform3d& segmentPose2 = segmentPoseAtTime1;
 
 	SURGSIM_ASSERT(segmentShape1.getNumEdges() == segmentShape2.getNumEdges()) <<
 			"Segment CCD self collision detects that " <<
@@ -101,16 +137,13 @@ std::list<std::shared_ptr<Contact>> SegmentSelfContact::calculateCcdContact(
 
 	std::list<std::shared_ptr<Contact>> contacts;
 
-	// Intersect the AABB trees of the Segment Mesh at time 0 and time 1 to get a list of
-	// potential intersecting segments.
-	std::set<std::pair<size_t, size_t>> segmentIds;
-
-	// Use a local aabb tree for the movement volume to calculate the first set of possible intersections.
+	// Use an aabb tree of the movement volumes to calculate the first set of possible intersections.
 	auto const& edges1 = segmentShape1.getEdges();
 	auto const& edges2 = segmentShape2.getEdges();
 	const Math::Vector3d halfExtent = Math::Vector3d(segmentShape1.getRadius(), segmentShape1.getRadius(),
 									  segmentShape1.getRadius());
-	std::list<DataStructures::AabbTreeData::Item> items;
+	std::vector<DataStructures::FlatAabbTree::Item> items;
+	items.reserve(edges1.size());
 	for (size_t id = 0; id < edges1.size(); ++id)
 	{
 		if (edges1[id].isValid && edges2[id].isValid)
@@ -128,11 +161,16 @@ std::list<std::shared_ptr<Contact>> SegmentSelfContact::calculateCcdContact(
 			items.emplace_back(aabb, id);
 		}
 	}
-	DataStructures::AabbTree tree;
-	tree.set(std::move(items));
+	tree->update(items);
 
-	std::list<DataStructures::AabbTree::TreeNodePairType> intersectionList = tree.spatialJoin(tree);
-	getUniqueCandidates(intersectionList, &segmentIds);
+	// Each pair of distinct segments is reported once by the traversal, they are sorted to process them in the
+	// same order from one call to the next, the removal of the duplicate contacts depends on it.
+	std::vector<std::pair<size_t, size_t>> segmentIds;
+	tree->forEachSelfIntersection([&segmentIds](size_t idA, size_t idB)
+	{
+		segmentIds.emplace_back(std::min(idA, idB), std::max(idA, idB));
+	});
+	std::sort(segmentIds.begin(), segmentIds.end());
 
 	size_t evaluations = 0;
 	for (const auto& idPair : segmentIds)
@@ -253,7 +291,7 @@ std::list<std::shared_ptr<Contact>> SegmentSelfContact::calculateCcdContact(
 											<< "\tbarymetric coordinate r:\t" << r << "\tbarymetric coordinate s:\t"
 											<< s << "\tMagnitude:\t" <<
 											pToQDir.norm() << "\tDepth:\t" << depth;
-				contacts.emplace_back(std::make_shared<Contact>(
+				contacts.emplace_back(ContactArena::makeContact(
 										  CollisionDetectionType::COLLISION_DETECTION_TYPE_CONTINUOUS, depth, t,
 										  contactPoint, -normal, penetrationPoints));
 			}
@@ -361,38 +399,6 @@ bool SegmentSelfContact::detectCollision(
 	return collisionDetected;
 }
 
-void SegmentSelfContact::getUniqueCandidates(
-	const std::list<SurgSim::DataStructures::AabbTree::TreeNodePairType>& intersectionList,
-	std::set<std::pair<size_t, size_t>>* segmentIds) const
-{
-	for (const auto& intersection : intersectionList)
-	{
-		std::shared_ptr<DataStructures::AabbTreeNode> nodeA = intersection.first;
-		std::shared_ptr<DataStructures::AabbTreeNode> nodeB = intersection.second;
-		std::list<size_t> localIdListA;
-		std::list<size_t> localIdListB;
-
-		nodeA->getIntersections(nodeB->getAabb(), &localIdListA);
-		nodeB->getIntersections(nodeA->getAabb(), &localIdListB);
-		for (const auto& idA : localIdListA)
-		{
-			for (const auto& idB : localIdListB)
-			{
-				// Segments are the same
-				if (idA == idB)
-				{
-					continue;
-				}
-
-				// Segment pair has already been added
-				auto  testValue = (idA < idB) ? std::pair<size_t, size_t>(idA, idB) :
-								  std::pair<size_t, size_t>(idB, idA);
-				segmentIds->insert(testValue);
-			}
-		}
-	}
-}
-
 bool SegmentSelfContact::removeInvalidCollisions(
 	const Math::SegmentMeshShape& segmentT0,
 	const Math::SegmentMeshShape& segmentT1,
@@ -17,7 +17,7 @@
 #define SURGSIM_COLLISION_SEGMENTSELFCONTACT_H
 
 #include "SurgSim/Collision/ShapeShapeContactCalculation.h"
-#include "SurgSim/DataStructures/AabbTree.h"
+#include "SurgSim/DataStructures/FlatAabbTree.h"
 #include "SurgSim/Framework/Logger.h"
 #include "SurgSim/Math/SegmentMeshShape.h"
 
@@ -56,6 +56,13 @@ class SegmentSelfContact : public ShapeShapeContactCalculation<Math::SegmentMesh
 		const Math::SegmentMeshShape& segmentShape2AtTime1, const Math::RigidTransform3d& segmentPose2AtTime1)
 		const override;
 
+	std::list<std::shared_ptr<Contact>> calculateCachedCcdContact(
+		const Math::SegmentMeshShape& segmentShape1AtTime0, const Math::RigidTransform3d& segmentPose1AtTime0,
+		const Math::SegmentMeshShape& segmentShape1AtTime1, const Math::RigidTransform3d& segmentPose1AtTime1,
+		const Math::SegmentMeshShape& segmentShape2AtTime0, const Math::RigidTransform3d& segmentPose2AtTime0,
+		const Math::SegmentMeshShape& segmentShape2AtTime1, const Math::RigidTransform3d& segmentPose2AtTime1,
+		ContactCache* cache) const override;
+
 	/// Set the minimum time precision allowed when deciding on the depth of recursion.
 	/// \param precision the desired minimum time precision
 	void setTimeMinPrecisionEpsilon(double precision);
@@ -82,6 +89,17 @@ class SegmentSelfContact : public ShapeShapeContactCalculation<Math::SegmentMesh
 	std::pair<int, int> getShapeTypes() override;
 
 protected:
+	/// Calculate the self contacts of a segment mesh over its motion.
+	/// \param segmentShapeAtTime0, segmentPoseAtTime0 the segment mesh and its pose at time t=0.
+	/// \param segmentShapeAtTime1, segmentPoseAtTime1 the segment mesh and its pose at time t=1.
+	/// \param tree the tree of the swept volumes of the segments, refitted if it holds the same segments as in
+	/// the previous call, rebuilt otherwise.
+	/// \return the contacts between the segments of the mesh.
+	std::list<std::shared_ptr<Contact>> calculateSelfCcdContact(
+		const Math::SegmentMeshShape& segmentShapeAtTime0, const Math::RigidTransform3d& segmentPoseAtTime0,
+		const Math::SegmentMeshShape& segmentShapeAtTime1, const Math::RigidTransform3d& segmentPoseAtTime1,
+		DataStructures::FlatAabbTree* tree) const;
+
 	/// Detect if two segments actually collide either at time t=0 (Fixed case) or within a movement phase.
 	/// \param pt0Positions are the segment endpoints for the first segment at time t=0.
 	/// \param pt1Positions are the segment endpoints for the first segment at time t=1.
@@ -109,14 +127,6 @@ class SegmentSelfContact : public ShapeShapeContactCalculation<Math::SegmentMesh
 		SurgSim::Math::Vector3d* contactPtP,
 		SurgSim::Math::Vector3d* contactPtQ) const;
 
-	/// Given a list of potentially intersecting AABB nodes, cull the list of any duplicates
-	/// and return the uniques candidates as synchronized pairs.
-	/// \param intersectionList list of potentially intersecting AABB node.
-	/// \param segmentIds [out] paired unique matches
-	void getUniqueCandidates(
-		const std::list<SurgSim::DataStructures::AabbTree::TreeNodePairType>& intersectionList,
-		std::set<std::pair<size_t, size_t>>* segmentIds) const;
-
 	/// From the initial AABB tree collisions, there are some very simple filtering operations that we can
 	/// do to eliminate a number of false positives. Most notably, we do not want to collide a single segment
 	/// against itself, or against one of the segments with which it shares a vertex. These are trivial collisions
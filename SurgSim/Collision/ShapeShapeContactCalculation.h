@@ -42,6 +42,19 @@ class ShapeShapeContactCalculation : public ContactCalculation
 		return std::list<std::shared_ptr<Contact>>();
 	}
 
+	/// Virtual function to be overridden by the calculations that can take advantage of the data kept for the pair
+	/// between frames, by default the cache is ignored
+	/// \param shape1, pose1, shape2, pose2 The two shapes and their poses
+	/// \param cache The data kept for the pair between frames
+	/// \return the contacts between the two shapes
+	virtual std::list<std::shared_ptr<Contact>> calculateCachedDcdContact(
+		const Shape1& shape1, const Math::RigidTransform3d& pose1,
+		const Shape2& shape2, const Math::RigidTransform3d& pose2,
+		ContactCache* cache) const
+	{
+		return calculateDcdContact(shape1, pose1, shape2, pose2);
+	}
+
 	virtual std::list<std::shared_ptr<Contact>> calculateCcdContact(
 		const Shape1& shape1AtTime0, const Math::RigidTransform3d& pose1AtTime0,
 		const Shape1& shape1AtTime1, const Math::RigidTransform3d& pose1AtTime1,
@@ -52,6 +65,23 @@ class ShapeShapeContactCalculation : public ContactCalculation
 		return std::list<std::shared_ptr<Contact>>();
 	}
 
+	/// Virtual function to be overridden by the calculations that can take advantage of the data kept for the pair
+	/// between frames, by default the cache is ignored
+	/// \param shape1AtTime0, pose1AtTime0, shape1AtTime1, pose1AtTime1 The first shape and its poses at both times
+	/// \param shape2AtTime0, pose2AtTime0, shape2AtTime1, pose2AtTime1 The second shape and its poses at both times
+	/// \param cache The data kept for the pair between frames
+	/// \return the contacts between the two shapes over the motion
+	virtual std::list<std::shared_ptr<Contact>> calculateCachedCcdContact(
+		const Shape1& shape1AtTime0, const Math::RigidTransform3d& pose1AtTime0,
+		const Shape1& shape1AtTime1, const Math::RigidTransform3d& pose1AtTime1,
+		const Shape2& shape2AtTime0, const Math::RigidTransform3d& pose2AtTime0,
+		const Shape2& shape2AtTime1, const Math::RigidTransform3d& pose2AtTime1,
+		ContactCache* cache) const
+	{
+		return calculateCcdContact(shape1AtTime0, pose1AtTime0, shape1AtTime1, pose1AtTime1,
+								   shape2AtTime0, pose2AtTime0, shape2AtTime1, pose2AtTime1);
+	}
+
 	/// Overrides the dcd contact calculation to go from untyped shapes to the typed shapes
 	std::list<std::shared_ptr<Contact>> doCalculateDcdContact(
 		const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape1,
@@ -66,6 +96,21 @@ class ShapeShapeContactCalculation : public ContactCalculation
 		return calculateDcdContact(*one, posedShape1.getPose(), *two, posedShape2.getPose());
 	}
 
+	/// Overrides the cached dcd contact calculation to go from untyped shapes to the typed shapes
+	std::list<std::shared_ptr<Contact>> doCalculateCachedDcdContact(
+		const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape1,
+		const Math::PosedShape<std::shared_ptr<Math::Shape>>& posedShape2,
+		ContactCache* cache) override
+	{
+		auto one = std::static_pointer_cast<Shape1>(posedShape1.getShape());
+		auto two = std::static_pointer_cast<Shape2>(posedShape2.getShape());
+
+		SURGSIM_ASSERT(one->getType() == posedShape1.getShape()->getType()) << "Invalid Shape 1";
+		SURGSIM_ASSERT(two->getType() == posedShape2.getShape()->getType()) << "Invalid Shape 2";
+
+		return calculateCachedDcdContact(*one, posedShape1.getPose(), *two, posedShape2.getPose(), cache);
+	}
+
 	/// Overrides the ccd contact calculation to go from untyped shapes to the typed shapes
 	std::list<std::shared_ptr<Contact>> doCalculateCcdContact(
 		const Math::PosedShapeMotion<std::shared_ptr<Math::Shape>>& posedShapeMotion1,
@@ -89,6 +134,32 @@ class ShapeShapeContactCalculation : public ContactCalculation
 			*oneAtTime0, posedShapeMotion1.first.getPose(), *oneAtTime1, posedShapeMotion1.second.getPose(),
 			*twoAtTime0, posedShapeMotion2.first.getPose(), *twoAtTime1, posedShapeMotion2.second.getPose());
 	}
+
+	/// Overrides the cached ccd contact calculation to go from untyped shapes to the typed shapes
+	std::list<std::shared_ptr<Contact>> doCalculateCachedCcdContact(
+		const Math::PosedShapeMotion<std::shared_ptr<Math::Shape>>& posedShapeMotion1,
+		const Math::PosedShapeMotion<std::shared_ptr<Math::Shape>>& posedShapeMotion2,
+		ContactCache* cache) override
+	{
+		auto oneAtTime0 = std::static_pointer_cast<Shape1>(posedShapeMotion1.first.getShape());
+		auto oneAtTime1 = std::static_pointer_cast<Shape1>(posedShapeMotion1.second.getShape());
+		auto twoAtTime0 = std::static_pointer_cast<Shape2>(posedShapeMotion2.first.getShape());
+		auto twoAtTime1 = std::static_pointer_cast<Shape2>(posedShapeMotion2.second.getShape());
+
+		SURGSIM_ASSERT(oneAtTime0->getType() == posedShapeMotion1.first.getShape()->getType()) <<
+			"Invalid Shape 1 detected at time 0";
+		SURGSIM_ASSERT(oneAtTime1->getType() == posedShapeMotion1.second.getShape()->getType()) <<
+			"Invalid Shape 1 detected at time 1";
+		SURGSIM_ASSERT(twoAtTime0->getType() == posedShapeMotion2.first.getShape()->getType()) <<
+			"Invalid Shape 2 detected at time 0";
+		SURGSIM_ASSERT(twoAtTime1->getType() == posedShapeMotion2.second.getShape()->getType()) <<
+			"Invalid Shape 2 detected at time 1";
+
+		return calculateCachedCcdContact(
+			*oneAtTime0, posedShapeMotion1.first.getPose(), *oneAtTime1, posedShapeMotion1.second.getPose(),
+			*twoAtTime0, posedShapeMotion2.first.getPose(), *twoAtTime1, posedShapeMotion2.second.getPose(),
+			cache);
+	}
 };
 
 }
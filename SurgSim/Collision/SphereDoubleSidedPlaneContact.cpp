@@ -16,6 +16,7 @@
 #include "SurgSim/Collision/SphereDoubleSidedPlaneContact.h"
 
 #include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/ContactArena.h"
 #include "SurgSim/Collision/Representation.h"
 #include "SurgSim/Math/DoubleSidedPlaneShape.h"
 #include "SurgSim/Math/Geometry.h"
@@ -63,7 +64,7 @@ std::list<std::shared_ptr<Contact>> SphereDoubleSidedPlaneContact::calculateDcdC
 		penetrationPoints.second.rigidLocalPosition.setValue(
 			planePose.inverse() * (sphereCenter - normal * distAbsolute));
 
-		contacts.emplace_back(std::make_shared<Contact>(
+		contacts.emplace_back(ContactArena::makeContact(
 								  COLLISION_DETECTION_TYPE_DISCRETE, depth, 1.0,
 								  Vector3d::Zero(), normal, penetrationPoints));
 	}
@@ -16,6 +16,7 @@
 #include "SurgSim/Collision/SphereSphereContact.h"
 
 #include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/ContactArena.h"
 #include "SurgSim/Collision/Representation.h"
 #include "SurgSim/Math/SphereShape.h"
 #include "SurgSim/Math/Vector.h"
@@ -52,7 +53,7 @@ std::list<std::shared_ptr<Contact>> SphereSphereContact::calculateDcdContact(
 		penetrationPoints.second.rigidLocalPosition.setValue(
 			(sphere2Pose.linear().inverse() * normal) * sphere2.getRadius());
 
-		contacts.emplace_back(std::make_shared<Contact>(
+		contacts.emplace_back(ContactArena::makeContact(
 								  COLLISION_DETECTION_TYPE_DISCRETE, maxDist - dist, 1.0,
 								  Vector3d::Zero(), normal, penetrationPoints));
 	}
@@ -0,0 +1,217 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SurgSim/Collision/SweepAndPrune.h"
+
+#include <algorithm>
+
+#include "SurgSim/Collision/Representation.h"
+#include "SurgSim/Math/Vector.h"
+
+namespace SurgSim
+{
+namespace Collision
+{
+
+SweepAndPrune::SweepAndPrune() :
+	m_axis(0)
+{
+}
+
+SweepAndPrune::~SweepAndPrune()
+{
+}
+
+void SweepAndPrune::update(const std::vector<std::shared_ptr<Representation>>& representations)
+{
+	const size_t count = representations.size();
+
+	m_boxes.resize(count);
+	m_indices.clear();
+	m_unbounded.clear();
+	m_hasEndpoints.assign(count, false);
+	for (size_t i = 0; i < count; ++i)
+	{
+		m_boxes[i] = representations[i]->getBoundingBox();
+		m_indices[representations[i].get()] = i;
+		if (m_boxes[i].isEmpty())
+		{
+			m_unbounded.push_back(i);
+		}
+	}
+
+	size_t axis = computeSweepAxis();
+
+	// Drop the endpoints of representations that went away or became unbounded, refresh the others
+	auto newEnd = std::remove_if(m_endpoints.begin(), m_endpoints.end(), [this](const Endpoint& endpoint)
+	{
+		auto found = m_indices.find(endpoint.representation);
+		return found == m_indices.end() || m_boxes[found->second].isEmpty();
+	});
+	m_endpoints.erase(newEnd, m_endpoints.end());
+
+	for (auto& endpoint : m_endpoints)
+	{
+		endpoint.index = m_indices[endpoint.representation];
+		const Math::Aabbd& box = m_boxes[endpoint.index];
+		endpoint.value = (endpoint.isMinimum) ? box.min()[axis] : box.max()[axis];
+		m_hasEndpoints[endpoint.index] = true;
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (!m_hasEndpoints[i] && !m_boxes[i].isEmpty())
+		{
+			Endpoint endpoint = {m_boxes[i].min()[axis], representations[i].get(), i, true};
+			m_endpoints.push_back(endpoint);
+			endpoint.value = m_boxes[i].max()[axis];
+			endpoint.isMinimum = false;
+			m_endpoints.push_back(endpoint);
+		}
+	}
+
+	if (axis != m_axis)
+	{
+		// Nothing to gain from the previous order
+		std::sort(m_endpoints.begin(), m_endpoints.end(), &SweepAndPrune::isBefore);
+		m_axis = axis;
+	}
+	else
+	{
+		sortEndpoints();
+	}
+
+	// Sweep, every box that starts while another one is open overlaps it along the sweep axis
+	const size_t axis1 = (m_axis + 1) % 3;
+	const size_t axis2 = (m_axis + 2) % 3;
+	m_pairs.clear();
+	m_open.clear();
+	for (const auto& endpoint : m_endpoints)
+	{
+		const size_t index = endpoint.index;
+		if (endpoint.isMinimum)
+		{
+			const Math::Aabbd& box = m_boxes[index];
+			for (auto other : m_open)
+			{
+				const Math::Aabbd& otherBox = m_boxes[other];
+				if (box.min()[axis1] <= otherBox.max()[axis1] && otherBox.min()[axis1] <= box.max()[axis1] &&
+					box.min()[axis2] <= otherBox.max()[axis2] && otherBox.min()[axis2] <= box.max()[axis2])
+				{
+					m_pairs.emplace_back(std::min(index, other), std::max(index, other));
+				}
+			}
+			m_open.push_back(index);
+		}
+		else
+		{
+			auto found = std::find(m_open.begin(), m_open.end(), index);
+			*found = m_open.back();
+			m_open.pop_back();
+		}
+	}
+
+	for (auto unbounded : m_unbounded)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (i != unbounded && (!m_boxes[i].isEmpty() || i > unbounded))
+			{
+				m_pairs.emplace_back(std::min(i, unbounded), std::max(i, unbounded));
+			}
+		}
+	}
+
+	std::sort(m_pairs.begin(), m_pairs.end());
+}
+
+const std::vector<std::pair<size_t, size_t>>& SweepAndPrune::getOverlappingPairs() const
+{
+	return m_pairs;
+}
+
+size_t SweepAndPrune::getSweepAxis() const
+{
+	return m_axis;
+}
+
+void SweepAndPrune::clear()
+{
+	m_endpoints.clear();
+	m_boxes.clear();
+	m_indices.clear();
+	m_hasEndpoints.clear();
+	m_unbounded.clear();
+	m_open.clear();
+	m_pairs.clear();
+}
+
+bool SweepAndPrune::isBefore(const Endpoint& a, const Endpoint& b)
+{
+	return a.value < b.value || (a.value == b.value && a.isMinimum && !b.isMinimum);
+}
+
+size_t SweepAndPrune::computeSweepAxis() const
+{
+	Math::Vector3d sum = Math::Vector3d::Zero();
+	Math::Vector3d sumSquared = Math::Vector3d::Zero();
+	size_t count = 0;
+	for (const auto& box : m_boxes)
+	{
+		if (!box.isEmpty())
+		{
+			Math::Vector3d center = box.center();
+			sum += center;
+			sumSquared += center.cwiseProduct(center);
+			++count;
+		}
+	}
+
+	size_t axis = m_axis;
+	if (count > 1)
+	{
+		Math::Vector3d variance = sumSquared / count - (sum / count).cwiseAbs2();
+		// Only switch when the current axis is clearly worse, to keep the benefit of the coherent sort
+		size_t best;
+		variance.maxCoeff(&best);
+		if (variance[best] > 2.0 * variance[m_axis])
+		{
+			axis = best;
+		}
+	}
+	return axis;
+}
+
+void SweepAndPrune::sortEndpoints()
+{
+	for (size_t i = 1; i < m_endpoints.size(); ++i)
+	{
+		if (isBefore(m_endpoints[i], m_endpoints[i - 1]))
+		{
+			Endpoint endpoint = m_endpoints[i];
+			size_t j = i;
+			do
+			{
+				m_endpoints[j] = m_endpoints[j - 1];
+				--j;
+			}
+			while (j > 0 && isBefore(endpoint, m_endpoints[j - 1]));
+			m_endpoints[j] = endpoint;
+		}
+	}
+}
+
+}; // namespace Collision
+}; // namespace SurgSim
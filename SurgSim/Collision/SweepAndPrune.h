@@ -0,0 +1,120 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SURGSIM_COLLISION_SWEEPANDPRUNE_H
+#define SURGSIM_COLLISION_SWEEPANDPRUNE_H
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "SurgSim/Math/Aabb.h"
+
+namespace SurgSim
+{
+namespace Collision
+{
+
+class Representation;
+
+/// Broad phase collision detection using sweep and prune over the world space bounding boxes of
+/// collision representations.
+/// The sorted list of box endpoints along the sweep axis is kept between calls to update(), as the
+/// representations move only a little from one frame to the next the list is almost sorted and
+/// an insertion sort restores the order in close to linear time.
+/// Representations with an empty bounding box (e.g. planes) are considered to overlap with everything,
+/// this matches the behavior of CollisionPair::mayIntersect().
+class SweepAndPrune
+{
+public:
+	/// Constructor
+	SweepAndPrune();
+
+	/// Destructor
+	~SweepAndPrune();
+
+	/// Update the endpoints with the current bounding boxes and recompute the overlapping pairs.
+	/// Representations are identified across calls by their address, the list may change from call to call.
+	/// \param representations The representations to consider, each representation should appear only once
+	void update(const std::vector<std::shared_ptr<Representation>>& representations);
+
+	/// \return The pairs of indices into the representations passed to the last call to update() whose bounding
+	/// 		boxes overlap, in each pair first < second, the pairs are sorted in lexicographical order.
+	/// \note Self pairs are not reported, these have to be handled by the caller
+	const std::vector<std::pair<size_t, size_t>>& getOverlappingPairs() const;
+
+	/// \return The axis that was used for the sweep in the last update (0, 1 or 2)
+	size_t getSweepAxis() const;
+
+	/// Remove all the cached data
+	void clear();
+
+private:
+	/// Start or end of a bounding box along the sweep axis
+	struct Endpoint
+	{
+		/// Value along the sweep axis
+		double value;
+		/// The representation that this endpoint belongs to, only used as an identifier
+		const Representation* representation;
+		/// The index of the representation in the last update
+		size_t index;
+		/// True for the start of the box, false for its end
+		bool isMinimum;
+	};
+
+	/// Strict ordering of the endpoints, start points are sorted before end points at the same value so that
+	/// touching boxes are considered overlapping
+	/// \param a, b The endpoints to compare
+	/// \return true if a needs to come before b
+	static bool isBefore(const Endpoint& a, const Endpoint& b);
+
+	/// Pick the axis with the largest variance of the box centers
+	/// \return the axis to be used for the sweep
+	size_t computeSweepAxis() const;
+
+	/// Restore the order of the endpoints, uses an insertion sort to exploit the coherence between frames
+	void sortEndpoints();
+
+	/// The endpoints along the sweep axis, persistent across updates
+	std::vector<Endpoint> m_endpoints;
+
+	/// The axis along which the endpoints are sorted
+	size_t m_axis;
+
+	/// The bounding boxes of the last update
+	std::vector<Math::Aabbd> m_boxes;
+
+	/// Index of each representation in the last update
+	std::unordered_map<const Representation*, size_t> m_indices;
+
+	/// Whether the representation at a given index already has endpoints in the list
+	std::vector<bool> m_hasEndpoints;
+
+	/// Indices of representations with an empty bounding box
+	std::vector<size_t> m_unbounded;
+
+	/// The boxes currently open during the sweep
+	std::vector<size_t> m_open;
+
+	/// The result of the last update
+	std::vector<std::pair<size_t, size_t>> m_pairs;
+};
+
+}; // namespace Collision
+}; // namespace SurgSim
+
+#endif // SURGSIM_COLLISION_SWEEPANDPRUNE_H
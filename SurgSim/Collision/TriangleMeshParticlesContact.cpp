@@ -15,9 +15,9 @@
 
 #include "SurgSim/Collision/TriangleMeshParticlesContact.h"
 
+#include "SurgSim/Collision/ContactArena.h"
 #include "SurgSim/Collision/Representation.h"
-#include "SurgSim/DataStructures/AabbTree.h"
-#include "SurgSim/DataStructures/AabbTreeNode.h"
+#include "SurgSim/DataStructures/FlatAabbTree.h"
 #include "SurgSim/DataStructures/IndexedLocalCoordinate.h"
 #include "SurgSim/DataStructures/Location.h"
 #include "SurgSim/Math/Geometry.h"
@@ -53,13 +53,22 @@ std::list<std::shared_ptr<Contact>> TriangleMeshParticlesContact::calculateDcdCo
 	Vector3d coordinates;
 	const double particleRadius = particles.getRadius();
 
-	auto intersections = mesh.getAabbTree()->spatialJoin(*particles.getAabbTree());
+	const DataStructures::FlatAabbTree& meshTree = *mesh.getFlatAabbTree();
+	const DataStructures::FlatAabbTree& particlesTree = *particles.getFlatAabbTree();
+
+	std::vector<DataStructures::FlatAabbTree::NodePairType> intersections;
+	meshTree.spatialJoin(particlesTree, &intersections);
+
+	std::vector<size_t> candidateTriangles;
+	std::vector<size_t> candidateParticles;
 	for (auto& intersection : intersections)
 	{
-		std::list<size_t> candidateTriangles;
-		std::list<size_t> candidateParticles;
-		intersection.first->getIntersections(intersection.second->getAabb(), &candidateTriangles);
-		intersection.second->getIntersections(intersection.first->getAabb(), &candidateParticles);
+		candidateTriangles.clear();
+		candidateParticles.clear();
+		meshTree.getNodeIntersections(intersection.first, particlesTree.getNodeAabb(intersection.second),
+									  &candidateTriangles);
+		particlesTree.getNodeIntersections(intersection.second, meshTree.getNodeAabb(intersection.first),
+										   &candidateParticles);
 		for (auto& triangle : candidateTriangles)
 		{
 			const Vector3d& normal = mesh.getNormal(triangle);
@@ -82,7 +91,7 @@ std::list<std::shared_ptr<Contact>> TriangleMeshParticlesContact::calculateDcdCo
 												 Location(IndexedLocalCoordinate(triangle, coordinates),
 														  DataStructures::Location::TRIANGLE),
 												 Location(particle));
-					contacts.push_back(std::make_shared<Contact>(
+					contacts.push_back(ContactArena::makeContact(
 										   COLLISION_DETECTION_TYPE_DISCRETE, depth, 1.0,
 										   Vector3d::Zero(), -normal, penetrationPoints));
 				}
@@ -14,6 +14,7 @@
 // limitations under the License.
 
 #include "SurgSim/Collision/TriangleMeshPlaneContact.h"
+#include "SurgSim/Collision/ContactArena.h"
 #include "SurgSim/Collision/Representation.h"
 #include "SurgSim/Math/Geometry.h"
 #include "SurgSim/Math/RigidTransform.h"
@@ -63,7 +64,7 @@ std::list<std::shared_ptr<Contact>> TriangleMeshPlaneContact::calculateDcdContac
 			penetrationPoints.second.rigidLocalPosition.setValue(
 				planePose.inverse() * (vertex.position - normal * d));
 
-			contacts.emplace_back(std::make_shared<Contact>(
+			contacts.emplace_back(ContactArena::makeContact(
 									  COLLISION_DETECTION_TYPE_DISCRETE, -d, 1.0,
 									  Vector3d::Zero(), normal, penetrationPoints));
 		}
@@ -16,9 +16,9 @@
 #include "SurgSim/Collision/TriangleMeshSurfaceMeshContact.h"
 
 #include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/ContactArena.h"
 #include "SurgSim/Collision/Representation.h"
-#include "SurgSim/DataStructures/AabbTree.h"
-#include "SurgSim/DataStructures/AabbTreeNode.h"
+#include "SurgSim/DataStructures/FlatAabbTree.h"
 #include "SurgSim/DataStructures/IndexedLocalCoordinate.h"
 #include "SurgSim/DataStructures/TriangleMesh.h"
 #include "SurgSim/Math/Geometry.h"
@@ -49,23 +49,29 @@ std::list<std::shared_ptr<Contact>> TriangleMeshSurfaceMeshContact::calculateDcd
 {
 	std::list<std::shared_ptr<Contact>> contacts;
 
-	std::list<SurgSim::DataStructures::AabbTree::TreeNodePairType> intersectionList
-		= meshA.getAabbTree()->spatialJoin(*(meshB.getAabbTree()));
+	const SurgSim::DataStructures::FlatAabbTree& treeA = *meshA.getFlatAabbTree();
+	const SurgSim::DataStructures::FlatAabbTree& treeB = *meshB.getFlatAabbTree();
+
+	std::vector<SurgSim::DataStructures::FlatAabbTree::NodePairType> intersectionList;
+	treeA.spatialJoin(treeB, &intersectionList);
 
 	double depth = 0.0;
 	Vector3d normal;
 	Vector3d penetrationPointA, penetrationPointB;
 
+	std::vector<size_t> triangleListA;
+	std::vector<size_t> triangleListB;
+
 	for (auto intersection = intersectionList.begin(); intersection != intersectionList.end(); ++intersection)
 	{
-		std::shared_ptr<SurgSim::DataStructures::AabbTreeNode> nodeA = intersection->first;
-		std::shared_ptr<SurgSim::DataStructures::AabbTreeNode> nodeB = intersection->second;
+		size_t nodeA = intersection->first;
+		size_t nodeB = intersection->second;
 
-		std::list<size_t> triangleListA;
-		std::list<size_t> triangleListB;
+		triangleListA.clear();
+		triangleListB.clear();
 
-		nodeA->getIntersections(nodeB->getAabb(), &triangleListA);
-		nodeB->getIntersections(nodeA->getAabb(), &triangleListB);
+		treeA.getNodeIntersections(nodeA, treeB.getNodeAabb(nodeB), &triangleListA);
+		treeB.getNodeIntersections(nodeB, treeA.getNodeAabb(nodeA), &triangleListB);
 
 		for (auto i = triangleListA.begin(); i != triangleListA.end(); ++i)
 		{
@@ -128,7 +134,7 @@ std::list<std::shared_ptr<Contact>> TriangleMeshSurfaceMeshContact::calculateDcd
 					penetrationPoints.first.rigidLocalPosition.setValue(meshAPose.inverse() * penetrationPointA);
 					penetrationPoints.second.rigidLocalPosition.setValue(meshBPose.inverse() * penetrationPointB);
 
-					contacts.emplace_back(std::make_shared<Contact>(
+					contacts.emplace_back(ContactArena::makeContact(
 						COLLISION_DETECTION_TYPE_DISCRETE, std::abs(depth), 1.0,
 						Vector3d::Zero(), normal, penetrationPoints));
 				}
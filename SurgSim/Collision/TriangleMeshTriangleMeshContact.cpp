@@ -15,15 +15,23 @@
 
 #include "SurgSim/Collision/TriangleMeshTriangleMeshContact.h"
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <utility>
+#include <vector>
+
 #include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/ContactArena.h"
+#include "SurgSim/Collision/ContactCache.h"
 #include "SurgSim/Collision/Representation.h"
-#include "SurgSim/DataStructures/AabbTree.h"
-#include "SurgSim/DataStructures/AabbTreeNode.h"
+#include "SurgSim/DataStructures/FlatAabbTree.h"
 #include "SurgSim/DataStructures/IndexedLocalCoordinate.h"
 #include "SurgSim/DataStructures/TriangleMesh.h"
 #include "SurgSim/Math/Geometry.h"
 #include "SurgSim/Math/MeshShape.h"
 #include "SurgSim/Math/RigidTransform.h"
+#include "SurgSim/Math/TriangleTriangleBatch.h"
 
 using SurgSim::DataStructures::Location;
 using SurgSim::DataStructures::TriangleMesh;
@@ -136,6 +144,82 @@ void assertIsCorrectNormalAndDepth(const Vector3d& normal,
 } // namespace
 #endif //SURGSIM_DEBUG_TRIANGLETRIANGLECONTACT
 
+namespace
+{
+
+/// Project the bounding boxes of the first levels of a tree on an axis, the resulting interval contains the
+/// projections of all the objects of the tree. The cost does not depend on the size of the tree.
+/// \param tree the tree, not empty
+/// \param axis the axis
+/// \param [out] min, max the interval
+void projectTree(const DataStructures::FlatAabbTree& tree, const Vector3d& axis, double* min, double* max)
+{
+	// The nodes up to this depth are projected, i.e. at most 8 boxes
+	static const size_t maxDepth = 3;
+
+	const Vector3d absAxis = axis.cwiseAbs();
+	*min = std::numeric_limits<double>::max();
+	*max = -std::numeric_limits<double>::max();
+
+	// Depth first traversal, with the depth of each node
+	std::array<std::pair<size_t, size_t>, maxDepth + 1> stack;
+	size_t stackSize = 0;
+	stack[stackSize++] = std::make_pair(0, 0);
+	while (stackSize > 0)
+	{
+		const std::pair<size_t, size_t> entry = stack[--stackSize];
+		if (entry.second < maxDepth && !tree.isLeaf(entry.first))
+		{
+			stack[stackSize++] = std::make_pair(tree.getFirstChild(entry.first), entry.second + 1);
+			stack[stackSize++] = std::make_pair(tree.getSecondChild(entry.first), entry.second + 1);
+		}
+		else
+		{
+			const Math::Aabbd aabb = tree.getNodeAabb(entry.first);
+			const double center = aabb.center().dot(axis);
+			const double radius = 0.5 * aabb.sizes().dot(absAxis);
+			*min = std::min(*min, center - radius);
+			*max = std::max(*max, center + radius);
+		}
+	}
+}
+
+/// Check if the projections of the bounding volumes of two meshes on an axis are disjoint, in which case no triangle
+/// of one mesh can intersect a triangle of the other
+/// \param treeA, treeB the bounding volume hierarchies of the meshes
+/// \param axis the axis, does not need to be normalized
+/// \return true if the axis separates the meshes
+bool isSeparatingAxis(const DataStructures::FlatAabbTree& treeA, const DataStructures::FlatAabbTree& treeB,
+					  const Vector3d& axis)
+{
+	const double norm = axis.norm();
+	if (norm < Math::Geometry::DistanceEpsilon || treeA.isEmpty() || treeB.isEmpty())
+	{
+		return false;
+	}
+
+	double minA, maxA, minB, maxB;
+	projectTree(treeA, axis, &minA, &maxA);
+	projectTree(treeB, axis, &minB, &maxB);
+	const double gap = Math::Geometry::DistanceEpsilon * norm;
+	return maxA + gap < minB || maxB + gap < minA;
+}
+
+/// Pairs of triangles and contacts of one task of the dcd contact calculation
+struct TaskResult
+{
+	/// Batch of the pairs of triangles waiting for the early rejection
+	Math::TriangleTriangleBatch batch;
+	/// The ids of the triangles of the pairs in the batch
+	std::vector<std::pair<size_t, size_t>> triangles;
+	/// Buffer for the indices of the pairs that passed the early rejection
+	std::vector<size_t> candidates;
+	/// The contacts found by the task
+	std::list<std::shared_ptr<Contact>> contacts;
+};
+
+}
+
 std::list<std::shared_ptr<Contact>> TriangleMeshTriangleMeshContact::calculateDcdContact(
 									 const Math::MeshShape& meshA,
 									 const Math::RigidTransform3d& meshAPose,
@@ -143,87 +227,155 @@ std::list<std::shared_ptr<Contact>> TriangleMeshTriangleMeshContact::calculateDc
 									 const Math::RigidTransform3d& meshBPose) const
 {
 
-	std::list<std::shared_ptr<Contact>> contacts;
-
-	std::list<SurgSim::DataStructures::AabbTree::TreeNodePairType> intersectionList
-		= meshA.getAabbTree()->spatialJoin(*(meshB.getAabbTree()));
+	// Exact contact calculation, for the pairs that passed the early rejection, reusing its signed distances
+	auto addContact = [&](size_t triangleA, size_t triangleB, const Vector3d& distancesA, const Vector3d& distancesB,
+						  std::list<std::shared_ptr<Contact>>* contacts)
+	{
+		const Vector3d& normalA = meshA.getNormal(triangleA);
+		const Vector3d& normalB = meshB.getNormal(triangleB);
+		auto verticesA = meshA.getTrianglePositions(triangleA);
+		auto verticesB = meshB.getTrianglePositions(triangleB);
+
+		double depth = 0.0;
+		Vector3d normal;
+		Vector3d penetrationPointA, penetrationPointB;
+
+		// Check if the triangles intersect.
+		if (Math::calculateContactTriangleTriangle(verticesA[0], verticesA[1], verticesA[2],
+				verticesB[0], verticesB[1], verticesB[2],
+				normalA, normalB, distancesA, distancesB, &depth,
+				&penetrationPointA, &penetrationPointB,
+				&normal))
+		{
+#ifdef SURGSIM_DEBUG_TRIANGLETRIANGLECONTACT
+			assertIsCoplanar(verticesA[0], verticesA[1], verticesA[2], penetrationPointA);
+			assertIsCoplanar(verticesB[0], verticesB[1], verticesB[2], penetrationPointB);
 
-	double depth = 0.0;
-	Vector3d normal;
-	Vector3d penetrationPointA, penetrationPointB;
+			assertIsPointInsideTriangle(
+				penetrationPointA, verticesA[0], verticesA[1], verticesA[2], normalA);
+			assertIsPointInsideTriangle(penetrationPointB, verticesB[0], verticesB[1], verticesB[2], normalB);
 
-	for (auto intersection = intersectionList.begin(); intersection != intersectionList.end(); ++intersection)
-	{
-		std::shared_ptr<SurgSim::DataStructures::AabbTreeNode> nodeA = intersection->first;
-		std::shared_ptr<SurgSim::DataStructures::AabbTreeNode> nodeB = intersection->second;
+			assertIsCorrectNormalAndDepth(normal, depth, verticesA[0], verticesA[1], verticesA[2],
+										  verticesB[0], verticesB[1], verticesB[2]);
+#endif
 
-		std::list<size_t> triangleListA;
-		std::list<size_t> triangleListB;
+			// Create the contact.
+			std::pair<Location, Location> penetrationPoints;
+			Vector3d barycentricCoordinate;
+			Math::barycentricCoordinates(penetrationPointA, verticesA[0], verticesA[1], verticesA[2],
+										 normalA, &barycentricCoordinate);
+			penetrationPoints.first.triangleMeshLocalCoordinate.setValue(
+				DataStructures::IndexedLocalCoordinate(triangleA, barycentricCoordinate));
+			Math::barycentricCoordinates(penetrationPointB, verticesB[0], verticesB[1], verticesB[2],
+										 normalB, &barycentricCoordinate);
+			penetrationPoints.second.triangleMeshLocalCoordinate.setValue(
+				DataStructures::IndexedLocalCoordinate(triangleB, barycentricCoordinate));
+
+			penetrationPoints.first.rigidLocalPosition.setValue(meshAPose.inverse() * penetrationPointA);
+			penetrationPoints.second.rigidLocalPosition.setValue(meshBPose.inverse() * penetrationPointB);
+
+			contacts->emplace_back(ContactArena::makeContact(
+									   COLLISION_DETECTION_TYPE_DISCRETE, std::abs(depth), 1.0,
+									   Vector3d::Zero(), normal, penetrationPoints));
+		}
+	};
 
-		nodeA->getIntersections(nodeB->getAabb(), &triangleListA);
-		nodeB->getIntersections(nodeA->getAabb(), &triangleListB);
+	// Run the early rejection on the whole batch, then the exact calculation on the remaining pairs, in the order
+	// they were added
+	auto processBatch = [&addContact](TaskResult* result)
+	{
+		Vector3d distancesA, distancesB;
+		result->batch.getCandidates(&result->candidates);
+		for (size_t candidate : result->candidates)
+		{
+			result->batch.getDistances(candidate, &distancesA, &distancesB);
+			addContact(result->triangles[candidate].first, result->triangles[candidate].second,
+					   distancesA, distancesB, &result->contacts);
+		}
+		result->batch.clear();
+		result->triangles.clear();
+	};
+
+	// Large pairs are split in tasks on the thread pool, each task collects its own contacts, these are merged in
+	// order so that the result does not depend on the scheduling. Small pairs are run directly, with a single result.
+	std::vector<TaskResult> taskResults;
+	meshA.getFlatAabbTree()->forEachIntersectionParallel(*meshB.getFlatAabbTree(), &taskResults,
+			[&](size_t triangleA, size_t triangleB, TaskResult* result)
+	{
+		const Vector3d& normalA = meshA.getNormal(triangleA);
+		const Vector3d& normalB = meshB.getNormal(triangleB);
+		if (normalA.isZero() || normalB.isZero())
+		{
+			return;
+		}
 
-		for (auto i = triangleListA.begin(); i != triangleListA.end(); ++i)
+		auto verticesA = meshA.getTrianglePositions(triangleA);
+		auto verticesB = meshB.getTrianglePositions(triangleB);
+		result->batch.add(verticesA[0], verticesA[1], verticesA[2], verticesB[0], verticesB[1], verticesB[2],
+						  normalA, normalB);
+		result->triangles.emplace_back(triangleA, triangleB);
+		if (result->batch.isFull())
 		{
-			const Vector3d& normalA = meshA.getNormal(*i);
-			if (normalA.isZero())
-			{
-				continue;
-			}
+			processBatch(result);
+		}
+	});
 
-			auto verticesA = meshA.getTrianglePositions(*i);
+	std::list<std::shared_ptr<Contact>> contacts;
+	for (auto& result : taskResults)
+	{
+		// Less than a batch of pairs is left in each task
+		processBatch(&result);
+		contacts.splice(contacts.end(), result.contacts);
+	}
 
-			for (auto j = triangleListB.begin(); j != triangleListB.end(); ++j)
-			{
-				const Vector3d& normalB = meshB.getNormal(*j);
-				if (normalB.isZero())
-				{
-					continue;
-				}
-
-				auto verticesB = meshB.getTrianglePositions(*j);
-
-				// Check if the triangles intersect.
-				if (Math::calculateContactTriangleTriangle(verticesA[0], verticesA[1], verticesA[2],
-						verticesB[0], verticesB[1], verticesB[2],
-						normalA, normalB, &depth,
-						&penetrationPointA, &penetrationPointB,
-						&normal))
-				{
-#ifdef SURGSIM_DEBUG_TRIANGLETRIANGLECONTACT
-					assertIsCoplanar(verticesA[0], verticesA[1], verticesA[2], penetrationPointA);
-					assertIsCoplanar(verticesB[0], verticesB[1], verticesB[2], penetrationPointB);
+	return contacts;
+}
 
-					assertIsPointInsideTriangle(
-						penetrationPointA, verticesA[0], verticesA[1], verticesA[2], normalA);
-					assertIsPointInsideTriangle(penetrationPointB, verticesB[0], verticesB[1], verticesB[2], normalB);
+std::list<std::shared_ptr<Contact>> TriangleMeshTriangleMeshContact::calculateCachedDcdContact(
+									 const Math::MeshShape& meshA,
+									 const Math::RigidTransform3d& meshAPose,
+									 const Math::MeshShape& meshB,
+									 const Math::RigidTransform3d& meshBPose,
+									 ContactCache* cache) const
+{
+	const auto treeA = meshA.getFlatAabbTree();
+	const auto treeB = meshB.getFlatAabbTree();
 
-					assertIsCorrectNormalAndDepth(normal, depth, verticesA[0], verticesA[1], verticesA[2],
-												  verticesB[0], verticesB[1], verticesB[2]);
-#endif
+	// The cached axis is checked once, on the bounding volumes only
+	Vector3d axis;
+	if (cache->getSeparatingAxis(&axis))
+	{
+		if (isSeparatingAxis(*treeA, *treeB, axis))
+		{
+			cache->incrementNumEarlyExits();
+			return std::list<std::shared_ptr<Contact>>();
+		}
+		cache->clearSeparatingAxis();
+	}
 
-					// Create the contact.
-					std::pair<Location, Location> penetrationPoints;
-					Vector3d barycentricCoordinate;
-					Math::barycentricCoordinates(penetrationPointA, verticesA[0], verticesA[1], verticesA[2],
-												 normalA, &barycentricCoordinate);
-					penetrationPoints.first.triangleMeshLocalCoordinate.setValue(
-						DataStructures::IndexedLocalCoordinate(*i, barycentricCoordinate));
-					Math::barycentricCoordinates(penetrationPointB, verticesB[0], verticesB[1], verticesB[2],
-												 normalB, &barycentricCoordinate);
-					penetrationPoints.second.triangleMeshLocalCoordinate.setValue(
-						DataStructures::IndexedLocalCoordinate(*j, barycentricCoordinate));
-
-					penetrationPoints.first.rigidLocalPosition.setValue(meshAPose.inverse() * penetrationPointA);
-					penetrationPoints.second.rigidLocalPosition.setValue(meshBPose.inverse() * penetrationPointB);
-
-					contacts.emplace_back(std::make_shared<Contact>(
-											  COLLISION_DETECTION_TYPE_DISCRETE, std::abs(depth), 1.0,
-											  Vector3d::Zero(), normal, penetrationPoints));
-				}
-			}
+	auto contacts = calculateDcdContact(meshA, meshAPose, meshB, meshBPose);
+
+	if (contacts.empty())
+	{
+		// The direction between the centers of the meshes is kept for the next frame if it separates them
+		axis = treeB->getAabb().center() - treeA->getAabb().center();
+		if (!isSeparatingAxis(*treeA, *treeB, axis))
+		{
+			return contacts;
 		}
 	}
+	else
+	{
+		// The meshes are most likely to separate along the normal of their shallowest contact, it is checked in the
+		// next frame so that a pair leaving contact does not need a full traversal
+		auto shallowest = std::min_element(contacts.begin(), contacts.end(),
+										   [](const std::shared_ptr<Contact>& a, const std::shared_ptr<Contact>& b)
+		{
+			return a->depth < b->depth;
+		});
+		axis = (*shallowest)->normal;
+	}
+	cache->setSeparatingAxis(axis);
 	return contacts;
 }
 
@@ -423,7 +575,7 @@ bool TriangleMeshTriangleMeshContact::ccdContactDcdCase(
 	}
 
 	depth = (t2contact - t1contact).dot(normal);
-	contacts->emplace_back(std::make_shared<Contact>(
+	contacts->emplace_back(ContactArena::makeContact(
 		COLLISION_DETECTION_TYPE_CONTINUOUS,
 		depth,
 		0.0,
@@ -546,7 +698,7 @@ void TriangleMeshTriangleMeshContact::ccdContactCcdCase(
 	// The location related to the TriangleMesh can carry a RIGID LOCAL POSITION information
 	locationTriangle2.rigidLocalPosition = pose2AtTime1.inverse() * t2contact;
 
-	contacts->emplace_back(std::make_shared<Contact>(
+	contacts->emplace_back(ContactArena::makeContact(
 		COLLISION_DETECTION_TYPE_CONTINUOUS,
 		penetrationDepthAtT1,
 		earliestTimeOfImpact,
@@ -41,6 +41,18 @@ class TriangleMeshTriangleMeshContact : public ShapeShapeContactCalculation<Math
 										 const Math::MeshShape& mesh2,
 										 const Math::RigidTransform3d& mesh2Pose) const override;
 
+	/// Same as calculateDcdContact(), the cache keeps a candidate separating axis: the axis that separated the meshes
+	/// when they were separated, the normal of their shallowest contact when they were in contact. The axis is checked
+	/// on the top levels of the bounding volume hierarchies, at a cost independent of the size of the meshes. When it
+	/// separates the meshes the calculation stops before traversing the trees, and counts an early exit in the cache,
+	/// otherwise it is dropped and the trees are traversed.
+	std::list<std::shared_ptr<Contact>> calculateCachedDcdContact(
+		const Math::MeshShape& mesh1,
+		const Math::RigidTransform3d& mesh1Pose,
+		const Math::MeshShape& mesh2,
+		const Math::RigidTransform3d& mesh2Pose,
+		ContactCache* cache) const override;
+
 	std::list<std::shared_ptr<Contact>> calculateCcdContact(
 		const Math::MeshShape& shape1AtTime0, const Math::RigidTransform3d& pose1AtTime0,
 		const Math::MeshShape& shape1AtTime1, const Math::RigidTransform3d& pose1AtTime1,
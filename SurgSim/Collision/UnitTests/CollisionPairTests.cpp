@@ -20,6 +20,7 @@
 #include "SurgSim/Collision/Representation.h"
 #include "SurgSim/Collision/ContactCalculation.h"
 #include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/ContactCache.h"
 #include "SurgSim/Collision/UnitTests/RepresentationUtilities.h"
 #include "SurgSim/DataStructures/BufferedValue.h"
 #include "SurgSim/Math/Vector.h"
@@ -170,6 +171,57 @@ TEST(CollisionPairTests, SelfCollisionDetectionTypeTest)
 	}
 }
 
+TEST(CollisionPairTests, ContactCacheTest)
+{
+	auto rep0 = makeSphereRepresentation(1.0);
+	auto rep1 = makeSphereRepresentation(2.0);
+
+	CollisionPair pair(rep0, rep1);
+	EXPECT_EQ(nullptr, pair.getContactCache());
+
+	auto cache = std::make_shared<ContactCache>();
+	pair.setContactCache(cache);
+	EXPECT_EQ(cache, pair.getContactCache());
+
+	pair.setContactCache(nullptr);
+	EXPECT_EQ(nullptr, pair.getContactCache());
+}
+
+TEST(CollisionPairTests, ContactCalculationTest)
+{
+	auto rep0 = makeSphereRepresentation(1.0);
+	auto rep1 = makeSphereRepresentation(2.0);
+
+	CollisionPair pair(rep0, rep1);
+	EXPECT_EQ(nullptr, pair.getContactCalculation());
+	EXPECT_EQ(nullptr, pair.getPosedShapes().first.getShape());
+	EXPECT_EQ(nullptr, pair.getPosedShapes().second.getShape());
+
+	auto calculation = ContactCalculation::getDcdContactTable()[Math::SHAPE_TYPE_SPHERE][Math::SHAPE_TYPE_SPHERE];
+	pair.setContactCalculation(calculation);
+	EXPECT_EQ(calculation, pair.getContactCalculation());
+
+	RigidTransform3d pose0 = Math::makeRigidTranslation(Vector3d(1.0, 0.0, 0.0));
+	RigidTransform3d pose1 = Math::makeRigidTranslation(Vector3d(0.0, 2.0, 0.0));
+	pair.setPosedShapes(Math::PosedShape<std::shared_ptr<Math::Shape>>(rep0->getShape(), pose0),
+						Math::PosedShape<std::shared_ptr<Math::Shape>>(rep1->getShape(), pose1));
+	EXPECT_EQ(rep0->getShape(), pair.getPosedShapes().first.getShape());
+	EXPECT_TRUE(pose0.isApprox(pair.getPosedShapes().first.getPose()));
+	EXPECT_EQ(rep1->getShape(), pair.getPosedShapes().second.getShape());
+
+	// The posed shapes follow the representations
+	pair.swapRepresentations();
+	EXPECT_EQ(rep1->getShape(), pair.getPosedShapes().first.getShape());
+	EXPECT_TRUE(pose1.isApprox(pair.getPosedShapes().first.getPose()));
+	EXPECT_EQ(rep0->getShape(), pair.getPosedShapes().second.getShape());
+
+	// New representations invalidate both
+	pair.setRepresentations(rep0, rep1);
+	EXPECT_EQ(nullptr, pair.getContactCalculation());
+	EXPECT_EQ(nullptr, pair.getPosedShapes().first.getShape());
+	EXPECT_EQ(nullptr, pair.getPosedShapes().second.getShape());
+}
+
 TEST(CollisionPairTests, addContactTest)
 {
 	auto rep0 = makeSphereRepresentation(1.0);
@@ -0,0 +1,212 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/ContactArena.h"
+#include "SurgSim/Collision/ShapeCollisionRepresentation.h"
+#include "SurgSim/Collision/SphereSphereContact.h"
+#include "SurgSim/DataStructures/Location.h"
+#include "SurgSim/Math/RigidTransform.h"
+#include "SurgSim/Math/SphereShape.h"
+#include "SurgSim/Math/Vector.h"
+
+using SurgSim::DataStructures::Location;
+using SurgSim::Math::Vector3d;
+
+namespace
+{
+
+std::shared_ptr<SurgSim::Collision::Contact> makeContact(SurgSim::Collision::ContactArena* arena, size_t slot,
+		double depth)
+{
+	return arena->makeContactInSlot(slot, SurgSim::Collision::COLLISION_DETECTION_TYPE_DISCRETE, depth, 1.0,
+									Vector3d::Zero(), Vector3d::UnitY(),
+									std::make_pair(Location(Vector3d::UnitX()), Location(Vector3d::UnitZ())));
+}
+
+}
+
+namespace SurgSim
+{
+namespace Collision
+{
+
+TEST(ContactArenaTests, InitTest)
+{
+	EXPECT_NO_THROW(ContactArena arena);
+
+	ContactArena arena;
+	EXPECT_EQ(0u, arena.getNumSlots());
+	EXPECT_EQ(0u, arena.getCapacity());
+	EXPECT_ANY_THROW(makeContact(&arena, 0, 0.1));
+
+	arena.reset(2);
+	EXPECT_EQ(2u, arena.getNumSlots());
+	EXPECT_EQ(0u, arena.getCapacity());
+	EXPECT_NO_THROW(makeContact(&arena, 1, 0.1));
+	EXPECT_ANY_THROW(makeContact(&arena, 2, 0.1));
+}
+
+TEST(ContactArenaTests, MakeContactTest)
+{
+	ContactArena arena;
+	arena.reset(2);
+
+	auto contact = makeContact(&arena, 0, 0.1);
+	ASSERT_NE(nullptr, contact);
+	EXPECT_EQ(COLLISION_DETECTION_TYPE_DISCRETE, contact->type);
+	EXPECT_DOUBLE_EQ(0.1, contact->depth);
+	EXPECT_DOUBLE_EQ(1.0, contact->time);
+	EXPECT_TRUE(contact->contact.isZero());
+	EXPECT_TRUE(contact->normal.isApprox(Vector3d::UnitY()));
+	EXPECT_TRUE(contact->penetrationPoints.first.rigidLocalPosition.getValue().isApprox(Vector3d::UnitX()));
+	EXPECT_TRUE(contact->penetrationPoints.second.rigidLocalPosition.getValue().isApprox(Vector3d::UnitZ()));
+	EXPECT_TRUE(contact->force.isZero());
+
+	// The contacts of a slot are contiguous
+	std::vector<std::shared_ptr<Contact>> contacts(1, contact);
+	for (int i = 1; i < 10; ++i)
+	{
+		contacts.push_back(makeContact(&arena, 0, 0.1 * i));
+		EXPECT_EQ(contacts[i - 1].get() + 1, contacts[i].get());
+	}
+	auto other = makeContact(&arena, 1, 0.2);
+	EXPECT_TRUE(other.get() < contacts.front().get() || other.get() > contacts.back().get());
+}
+
+TEST(ContactArenaTests, ResetTest)
+{
+	ContactArena arena;
+	arena.reset(1);
+
+	// A full slot takes a new block
+	std::vector<std::shared_ptr<Contact>> contacts;
+	for (int i = 0; i < 100; ++i)
+	{
+		contacts.push_back(makeContact(&arena, 0, 0.1));
+	}
+	std::vector<Contact*> previous;
+	for (const auto& contact : contacts)
+	{
+		previous.push_back(contact.get());
+	}
+	const size_t capacity = arena.getCapacity();
+	EXPECT_LE(100u, capacity);
+
+	// Once released, the contacts are reused in the same order without allocating
+	contacts.clear();
+	arena.reset(1);
+	for (int i = 0; i < 100; ++i)
+	{
+		contacts.push_back(makeContact(&arena, 0, 0.2));
+		EXPECT_EQ(previous[i], contacts.back().get());
+		EXPECT_DOUBLE_EQ(0.2, contacts.back()->depth);
+	}
+	EXPECT_EQ(capacity, arena.getCapacity());
+
+	// A contact still referenced is not overwritten, its block is put aside
+	auto held = contacts.front();
+	contacts.clear();
+	arena.reset(1);
+	auto contact = makeContact(&arena, 0, 0.3);
+	EXPECT_NE(held.get(), contact.get());
+	EXPECT_DOUBLE_EQ(0.2, held->depth);
+	EXPECT_EQ(capacity, arena.getCapacity());
+
+	// Once the contact is released, its block is reused
+	held.reset();
+	contact.reset();
+	arena.reset(1);
+	for (int i = 0; i < 100; ++i)
+	{
+		contacts.push_back(makeContact(&arena, 0, 0.4));
+	}
+	EXPECT_EQ(capacity, arena.getCapacity());
+
+	// Removed slots give their blocks back
+	contacts.clear();
+	arena.reset(0);
+	EXPECT_EQ(0u, arena.getNumSlots());
+	EXPECT_EQ(capacity, arena.getCapacity());
+	arena.reset(1);
+	for (int i = 0; i < 100; ++i)
+	{
+		contacts.push_back(makeContact(&arena, 0, 0.5));
+	}
+	EXPECT_EQ(capacity, arena.getCapacity());
+}
+
+TEST(ContactArenaTests, ScopeTest)
+{
+	auto arena = std::make_shared<ContactArena>();
+	arena->reset(2);
+
+	auto points = std::make_pair(Location(Vector3d::Zero()), Location(Vector3d::Zero()));
+	auto unscoped = ContactArena::makeContact(COLLISION_DETECTION_TYPE_DISCRETE, 0.1, 1.0, Vector3d::Zero(),
+					Vector3d::UnitY(), points);
+	EXPECT_NE(nullptr, unscoped);
+	EXPECT_EQ(0u, arena->getCapacity());
+
+	{
+		ContactArena::Scope scope(arena.get(), 1);
+		auto scoped = ContactArena::makeContact(COLLISION_DETECTION_TYPE_DISCRETE, 0.1, 1.0, Vector3d::Zero(),
+												Vector3d::UnitY(), points);
+		EXPECT_LT(0u, arena->getCapacity());
+		EXPECT_EQ(scoped.get() + 1, makeContact(arena.get(), 1, 0.1).get());
+
+		{
+			ContactArena::Scope unscope(nullptr, 0);
+			auto allocated = ContactArena::makeContact(COLLISION_DETECTION_TYPE_DISCRETE, 0.1, 1.0, Vector3d::Zero(),
+						   Vector3d::UnitY(), points);
+			EXPECT_NE(scoped.get() + 2, allocated.get());
+		}
+		EXPECT_EQ(scoped.get() + 2, ContactArena::makeContact(COLLISION_DETECTION_TYPE_DISCRETE, 0.1, 1.0,
+				  Vector3d::Zero(), Vector3d::UnitY(), points).get());
+	}
+}
+
+TEST(ContactArenaTests, CalculationTest)
+{
+	auto sphere = std::make_shared<Math::SphereShape>(1.0);
+	auto first = std::make_shared<ShapeCollisionRepresentation>("First");
+	first->setShape(sphere);
+	auto second = std::make_shared<ShapeCollisionRepresentation>("Second");
+	second->setShape(sphere);
+	second->setLocalPose(Math::makeRigidTranslation(Vector3d(0.5, 0.0, 0.0)));
+
+	auto arena = std::make_shared<ContactArena>();
+	arena->reset(1);
+	auto pair = std::make_shared<CollisionPair>(first, second);
+	pair->setContactArena(arena, 0);
+	EXPECT_EQ(arena, pair->getContactArena());
+	EXPECT_EQ(0u, pair->getContactArenaSlot());
+
+	// The contacts of the calculation and of the representations are made in the slot of the pair
+	SphereSphereContact calculation;
+	calculation.calculateContact(pair);
+	ASSERT_EQ(1u, pair->getContacts().size());
+	pair->updateRepresentations();
+	auto contact = makeContact(arena.get(), 0, 0.1);
+	EXPECT_EQ(pair->getContacts().front().get() + 2, contact.get());
+}
+
+}; // namespace Collision
+}; // namespace SurgSim
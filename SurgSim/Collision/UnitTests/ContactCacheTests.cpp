@@ -0,0 +1,100 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "SurgSim/Collision/ContactCache.h"
+#include "SurgSim/Collision/UnitTests/RepresentationUtilities.h"
+#include "SurgSim/DataStructures/FlatAabbTree.h"
+#include "SurgSim/Math/Vector.h"
+
+using SurgSim::Math::Vector3d;
+
+namespace SurgSim
+{
+namespace Collision
+{
+
+TEST(ContactCacheTests, InitTest)
+{
+	EXPECT_NO_THROW(ContactCache cache);
+
+	ContactCache cache;
+	Vector3d axis(1.0, 2.0, 3.0);
+	EXPECT_EQ(nullptr, cache.getFirst());
+	EXPECT_FALSE(cache.getSeparatingAxis(&axis));
+	EXPECT_TRUE(axis.isApprox(Vector3d(1.0, 2.0, 3.0)));
+	EXPECT_EQ(nullptr, cache.getAabbTree());
+	EXPECT_EQ(0u, cache.getAge());
+	EXPECT_EQ(0u, cache.getNumEarlyExits());
+}
+
+TEST(ContactCacheTests, SetGetTest)
+{
+	ContactCache cache;
+
+	cache.setSeparatingAxis(Vector3d::UnitY());
+	Vector3d axis;
+	EXPECT_TRUE(cache.getSeparatingAxis(&axis));
+	EXPECT_TRUE(axis.isApprox(Vector3d::UnitY()));
+	cache.clearSeparatingAxis();
+	EXPECT_FALSE(cache.getSeparatingAxis(&axis));
+
+	auto tree = std::make_shared<DataStructures::FlatAabbTree>();
+	cache.setAabbTree(tree);
+	EXPECT_EQ(tree, cache.getAabbTree());
+
+	cache.incrementAge();
+	cache.incrementAge();
+	EXPECT_EQ(2u, cache.getAge());
+
+	cache.incrementNumEarlyExits();
+	EXPECT_EQ(1u, cache.getNumEarlyExits());
+
+	cache.setSeparatingAxis(Vector3d::UnitX());
+	cache.clear();
+	EXPECT_FALSE(cache.getSeparatingAxis(&axis));
+	EXPECT_EQ(nullptr, cache.getAabbTree());
+	EXPECT_EQ(0u, cache.getAge());
+	EXPECT_EQ(0u, cache.getNumEarlyExits());
+}
+
+TEST(ContactCacheTests, SetFirstTest)
+{
+	auto rep0 = makeSphereRepresentation(1.0);
+	auto rep1 = makeSphereRepresentation(2.0);
+
+	ContactCache cache;
+	cache.setFirst(rep0.get());
+	cache.setSeparatingAxis(Vector3d::UnitX());
+	cache.incrementAge();
+
+	// Same order, the data is kept
+	cache.setFirst(rep0.get());
+	EXPECT_EQ(rep0.get(), cache.getFirst());
+	EXPECT_EQ(1u, cache.getAge());
+
+	// The pair was swapped, the data is not valid anymore
+	cache.setFirst(rep1.get());
+	EXPECT_EQ(rep1.get(), cache.getFirst());
+	Vector3d axis;
+	EXPECT_FALSE(cache.getSeparatingAxis(&axis));
+	EXPECT_EQ(0u, cache.getAge());
+}
+
+};
+};
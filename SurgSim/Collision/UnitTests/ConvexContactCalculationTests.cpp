@@ -0,0 +1,136 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SurgSim/Collision/UnitTests/ContactCalculationTestsCommon.h"
+#include "SurgSim/Collision/ContactCache.h"
+#include "SurgSim/Collision/ConvexContact.h"
+#include "SurgSim/Collision/SphereSphereContact.h"
+#include "SurgSim/Collision/UnitTests/RepresentationUtilities.h"
+#include "SurgSim/Math/ConvexPenetration.h"
+#include "SurgSim/Math/CylinderShape.h"
+#include "SurgSim/Math/MeshShape.h"
+#include "SurgSim/Math/SphereShape.h"
+
+namespace SurgSim
+{
+namespace Collision
+{
+
+TEST(ConvexContactCalculationTests, RegistrationTest)
+{
+	const auto& table = ContactCalculation::getDcdContactTable();
+
+	// Pairs without a dedicated calculation use the generic one
+	EXPECT_NE(nullptr, std::dynamic_pointer_cast<ConvexContact>(
+				  table[Math::SHAPE_TYPE_CYLINDER][Math::SHAPE_TYPE_CAPSULE]));
+	EXPECT_NE(nullptr, std::dynamic_pointer_cast<ConvexContact>(
+				  table[Math::SHAPE_TYPE_CAPSULE][Math::SHAPE_TYPE_CYLINDER]));
+	EXPECT_NE(nullptr, std::dynamic_pointer_cast<ConvexContact>(
+				  table[Math::SHAPE_TYPE_CAPSULE][Math::SHAPE_TYPE_CAPSULE]));
+
+	// The dedicated calculations are kept
+	EXPECT_NE(nullptr, std::dynamic_pointer_cast<SphereSphereContact>(
+				  table[Math::SHAPE_TYPE_SPHERE][Math::SHAPE_TYPE_SPHERE]));
+	EXPECT_EQ(nullptr, std::dynamic_pointer_cast<ConvexContact>(
+				  table[Math::SHAPE_TYPE_BOX][Math::SHAPE_TYPE_SPHERE]));
+}
+
+TEST(ConvexContactCalculationTests, SphereSphereTest)
+{
+	ConvexContact convex(std::make_pair(Math::SHAPE_TYPE_SPHERE, Math::SHAPE_TYPE_SPHERE));
+	SphereSphereContact reference;
+
+	auto rep1 = makeSphereRepresentation(0.5, Quaterniond::Identity(), Vector3d(0.1, 0.2, 0.3));
+	auto rep2 = makeSphereRepresentation(0.4, Math::makeRotationQuaternion(0.3, Vector3d(1.0, 1.0, 0.0).normalized()),
+										 Vector3d(0.5, 0.7, 0.3));
+
+	auto pair = std::make_shared<CollisionPair>(rep1, rep2);
+	auto referencePair = std::make_shared<CollisionPair>(rep1, rep2);
+	convex.calculateContact(pair);
+	reference.calculateContact(referencePair);
+
+	ASSERT_EQ(1u, pair->getContacts().size());
+	ASSERT_EQ(1u, referencePair->getContacts().size());
+	auto contact = pair->getContacts().front();
+	auto expected = referencePair->getContacts().front();
+
+	EXPECT_NEAR(expected->depth, contact->depth, 2.0 * Math::ConvexPenetrationRelativePrecision);
+	EXPECT_LT((expected->normal - contact->normal).norm(), 0.05);
+	ASSERT_TRUE(contact->penetrationPoints.first.rigidLocalPosition.hasValue());
+	ASSERT_TRUE(contact->penetrationPoints.second.rigidLocalPosition.hasValue());
+	EXPECT_NEAR(0.5, contact->penetrationPoints.first.rigidLocalPosition.getValue().norm(), 0.01);
+	EXPECT_NEAR(0.4, contact->penetrationPoints.second.rigidLocalPosition.getValue().norm(), 0.01);
+
+	rep2->setLocalPose(Math::makeRigidTransform(Quaterniond::Identity(), Vector3d(1.1, 0.2, 0.3)));
+	pair = std::make_shared<CollisionPair>(rep1, rep2);
+	convex.calculateContact(pair);
+	EXPECT_FALSE(pair->hasContacts());
+}
+
+TEST(ConvexContactCalculationTests, CapsuleCylinderTest)
+{
+	auto capsule = makeCapsuleRepresentation(1.0, 0.1);
+	auto cylinderRep = std::make_shared<ShapeCollisionRepresentation>("Cylinder");
+	cylinderRep->setShape(std::make_shared<Math::CylinderShape>(1.0, 0.2));
+	cylinderRep->setLocalPose(Math::makeRigidTransform(Math::makeRotationQuaternion(M_PI_2, Vector3d::UnitZ().eval()),
+							  Vector3d(0.0, 0.0, 0.25)));
+
+	auto pair = std::make_shared<CollisionPair>(capsule, cylinderRep);
+	ContactCalculation::getDcdContactTable()[Math::SHAPE_TYPE_CAPSULE][Math::SHAPE_TYPE_CYLINDER]->calculateContact(
+		pair);
+	ASSERT_EQ(1u, pair->getContacts().size());
+	auto contact = pair->getContacts().front();
+	EXPECT_NEAR(0.05, contact->depth, 1e-4);
+	EXPECT_LT((contact->normal + Vector3d::UnitZ()).norm(), 1e-2);
+
+	// The reversed pair is handled through the same calculation, which swaps the pair
+	pair = std::make_shared<CollisionPair>(cylinderRep, capsule);
+	ContactCalculation::getDcdContactTable()[Math::SHAPE_TYPE_CYLINDER][Math::SHAPE_TYPE_CAPSULE]->calculateContact(
+		pair);
+	EXPECT_EQ(capsule, pair->getFirst());
+	ASSERT_EQ(1u, pair->getContacts().size());
+	contact = pair->getContacts().front();
+	EXPECT_NEAR(0.05, contact->depth, 1e-4);
+	EXPECT_LT((contact->normal + Vector3d::UnitZ()).norm(), 1e-2);
+}
+
+TEST(ConvexContactCalculationTests, CachedTest)
+{
+	ConvexContact convex(std::make_pair(Math::SHAPE_TYPE_SPHERE, Math::SHAPE_TYPE_SPHERE));
+	auto rep1 = makeSphereRepresentation(0.5, Quaterniond::Identity(), Vector3d::Zero());
+	auto rep2 = makeSphereRepresentation(0.5, Quaterniond::Identity(), Vector3d(0.0, 2.0, 0.0));
+
+	auto cache = std::make_shared<ContactCache>();
+	auto pair = std::make_shared<CollisionPair>(rep1, rep2);
+	pair->setContactCache(cache);
+	convex.calculateContact(pair);
+	EXPECT_FALSE(pair->hasContacts());
+
+	// The separating axis is kept for the next frame
+	Vector3d axis;
+	ASSERT_TRUE(cache->getSeparatingAxis(&axis));
+	EXPECT_GT(axis.dot(Vector3d::UnitY()), 0.0);
+
+	rep2->setLocalPose(Math::makeRigidTransform(Quaterniond::Identity(), Vector3d(0.0, 0.9, 0.0)));
+	pair = std::make_shared<CollisionPair>(rep1, rep2);
+	pair->setContactCache(cache);
+	convex.calculateContact(pair);
+	ASSERT_EQ(1u, pair->getContacts().size());
+	EXPECT_NEAR(0.1, pair->getContacts().front()->depth, 2.0 * Math::ConvexPenetrationRelativePrecision);
+	EXPECT_LT((pair->getContacts().front()->normal + Vector3d::UnitY()).norm(), 0.05);
+}
+
+};
+};
@@ -0,0 +1,211 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/SdfParticlesContact.h"
+#include "SurgSim/Collision/SdfSegmentMeshContact.h"
+#include "SurgSim/Collision/SdfTriangleMeshContact.h"
+#include "SurgSim/Collision/ShapeCollisionRepresentation.h"
+#include "SurgSim/DataStructures/SegmentMesh.h"
+#include "SurgSim/DataStructures/TriangleMesh.h"
+#include "SurgSim/Math/Quaternion.h"
+#include "SurgSim/Math/RigidTransform.h"
+
+using SurgSim::DataStructures::SegmentMeshPlain;
+using SurgSim::DataStructures::TriangleMeshPlain;
+using SurgSim::Math::MeshShape;
+using SurgSim::Math::ParticlesShape;
+using SurgSim::Math::SdfShape;
+using SurgSim::Math::SegmentMeshShape;
+using SurgSim::Math::Vector3d;
+
+namespace SurgSim
+{
+namespace Collision
+{
+
+class SdfContactCalculationTests : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		// A sphere of radius 0.5 sampled every 0.05, centered on (1, 0, 0), the interpolated gradient is only
+		// accurate to a few percent at this resolution
+		const size_t samples = 31;
+		const double spacing = 0.05;
+		std::array<size_t, 3> dimensions = {{samples, samples, samples}};
+		const Vector3d origin = Vector3d::Constant(-0.75);
+		std::vector<double> values;
+		for (size_t k = 0; k < samples; ++k)
+		{
+			for (size_t j = 0; j < samples; ++j)
+			{
+				for (size_t i = 0; i < samples; ++i)
+				{
+					Vector3d point = origin + spacing * Vector3d(static_cast<double>(i), static_cast<double>(j),
+									 static_cast<double>(k));
+					values.push_back(point.norm() - 0.5);
+				}
+			}
+		}
+
+		m_sdfRepresentation = std::make_shared<ShapeCollisionRepresentation>("Sdf");
+		m_sdfRepresentation->setShape(std::make_shared<SdfShape>(dimensions, origin, spacing, values));
+		m_sdfRepresentation->setLocalPose(Math::makeRigidTransform(
+											  Math::makeRotationQuaternion(0.3, Vector3d::UnitZ().eval()),
+											  Vector3d(1.0, 0.0, 0.0)));
+	}
+
+	/// \return a representation with the given shape, at the origin
+	std::shared_ptr<ShapeCollisionRepresentation> makeRepresentation(const std::shared_ptr<Math::Shape>& shape)
+	{
+		auto representation = std::make_shared<ShapeCollisionRepresentation>("Other");
+		representation->setShape(shape);
+		return representation;
+	}
+
+	std::shared_ptr<ShapeCollisionRepresentation> m_sdfRepresentation;
+};
+
+TEST_F(SdfContactCalculationTests, RegistrationTest)
+{
+	const auto& table = ContactCalculation::getDcdContactTable();
+	EXPECT_NE(nullptr, std::dynamic_pointer_cast<SdfParticlesContact>(
+				  table[Math::SHAPE_TYPE_SDF][Math::SHAPE_TYPE_PARTICLES]));
+	EXPECT_NE(nullptr, std::dynamic_pointer_cast<SdfParticlesContact>(
+				  table[Math::SHAPE_TYPE_PARTICLES][Math::SHAPE_TYPE_SDF]));
+	EXPECT_NE(nullptr, std::dynamic_pointer_cast<SdfTriangleMeshContact>(
+				  table[Math::SHAPE_TYPE_SDF][Math::SHAPE_TYPE_MESH]));
+	EXPECT_NE(nullptr, std::dynamic_pointer_cast<SdfSegmentMeshContact>(
+				  table[Math::SHAPE_TYPE_SDF][Math::SHAPE_TYPE_SEGMENTMESH]));
+}
+
+TEST_F(SdfContactCalculationTests, ParticlesTest)
+{
+	auto particles = std::make_shared<ParticlesShape>(0.1);
+	particles->addVertex(ParticlesShape::VertexType(Vector3d(1.0, 0.45, 0.0)));
+	particles->addVertex(ParticlesShape::VertexType(Vector3d(3.0, 0.0, 0.0)));
+	particles->addVertex(ParticlesShape::VertexType(Vector3d(1.0, 0.0, 0.58)));
+	particles->addVertex(ParticlesShape::VertexType(Vector3d(1.0, 0.0, 0.65)));
+
+	SdfParticlesContact calculation;
+	auto pair = std::make_shared<CollisionPair>(m_sdfRepresentation, makeRepresentation(particles));
+	calculation.calculateContact(pair);
+
+	auto& contacts = pair->getContacts();
+	ASSERT_EQ(2u, contacts.size());
+
+	auto contact = contacts.front();
+	ASSERT_TRUE(contact->penetrationPoints.second.index.hasValue());
+	EXPECT_EQ(0u, contact->penetrationPoints.second.index.getValue());
+	EXPECT_NEAR(0.15, contact->depth, 1e-3);
+	EXPECT_TRUE(contact->normal.isApprox(-Vector3d::UnitY(), 0.1));
+	EXPECT_TRUE(contact->contact.isApprox(Vector3d(1.0, 0.5, 0.0), 1e-2));
+	ASSERT_TRUE(contact->penetrationPoints.first.rigidLocalPosition.hasValue());
+	EXPECT_TRUE((m_sdfRepresentation->getPose() * contact->penetrationPoints.first.rigidLocalPosition.getValue())
+				.isApprox(Vector3d(1.0, 0.5, 0.0), 1e-2));
+
+	contact = contacts.back();
+	ASSERT_TRUE(contact->penetrationPoints.second.index.hasValue());
+	EXPECT_EQ(2u, contact->penetrationPoints.second.index.getValue());
+	EXPECT_NEAR(0.02, contact->depth, 1e-3);
+	EXPECT_TRUE(contact->normal.isApprox(-Vector3d::UnitZ(), 0.1));
+
+	// The reversed pair is swapped
+	pair = std::make_shared<CollisionPair>(makeRepresentation(particles), m_sdfRepresentation);
+	calculation.calculateContact(pair);
+	EXPECT_EQ(m_sdfRepresentation, pair->getFirst());
+	EXPECT_EQ(2u, pair->getContacts().size());
+}
+
+TEST_F(SdfContactCalculationTests, TriangleMeshTest)
+{
+	auto mesh = std::make_shared<TriangleMeshPlain>();
+	mesh->addVertex(TriangleMeshPlain::VertexType(Vector3d(1.2, -0.2, -0.2)));
+	mesh->addVertex(TriangleMeshPlain::VertexType(Vector3d(1.2, 0.2, -0.2)));
+	mesh->addVertex(TriangleMeshPlain::VertexType(Vector3d(1.2, 0.2, 0.2)));
+	mesh->addVertex(TriangleMeshPlain::VertexType(Vector3d(1.2, -0.2, 0.2)));
+	mesh->addVertex(TriangleMeshPlain::VertexType(Vector3d(2.0, 0.0, 0.0)));
+	std::array<size_t, 3> triangles[3] = {{{0, 1, 2}}, {{0, 2, 3}}, {{1, 4, 2}}};
+	for (const auto& triangle : triangles)
+	{
+		mesh->addTriangle(TriangleMeshPlain::TriangleType(triangle));
+	}
+	auto meshShape = std::make_shared<MeshShape>(*mesh);
+
+	SdfTriangleMeshContact calculation;
+	auto pair = std::make_shared<CollisionPair>(m_sdfRepresentation, makeRepresentation(meshShape));
+	calculation.calculateContact(pair);
+
+	auto& contacts = pair->getContacts();
+	ASSERT_EQ(4u, contacts.size());
+	std::vector<bool> found(5, false);
+	for (const auto& contact : contacts)
+	{
+		ASSERT_TRUE(contact->penetrationPoints.second.triangleMeshLocalCoordinate.hasValue());
+		ASSERT_TRUE(contact->penetrationPoints.second.elementMeshLocalCoordinate.hasValue());
+		const auto& coordinate = contact->penetrationPoints.second.triangleMeshLocalCoordinate.getValue();
+		ASSERT_GT(3u, coordinate.index);
+		Math::Vector3d position = Vector3d::Zero();
+		for (size_t i = 0; i < 3; ++i)
+		{
+			position += coordinate.coordinate[i] * meshShape->getTrianglePositions(coordinate.index)[i];
+		}
+		EXPECT_NEAR(0.5 - (position - Vector3d(1.0, 0.0, 0.0)).norm(), contact->depth, 1e-3);
+		EXPECT_TRUE(contact->normal.isApprox(-(position - Vector3d(1.0, 0.0, 0.0)).normalized(), 0.1));
+
+		for (size_t vertex = 0; vertex < 5; ++vertex)
+		{
+			if (position.isApprox(meshShape->getVertexPosition(vertex)))
+			{
+				EXPECT_FALSE(found[vertex]);
+				found[vertex] = true;
+			}
+		}
+	}
+	EXPECT_EQ(4, std::count(found.begin(), found.begin() + 4, true));
+}
+
+TEST_F(SdfContactCalculationTests, SegmentMeshTest)
+{
+	auto mesh = std::make_shared<SegmentMeshPlain>();
+	mesh->addVertex(SegmentMeshPlain::VertexType(Vector3d(1.0, 0.45, 0.0)));
+	mesh->addVertex(SegmentMeshPlain::VertexType(Vector3d(1.0, 0.8, 0.0)));
+	mesh->addVertex(SegmentMeshPlain::VertexType(Vector3d(1.0, 1.2, 0.0)));
+	std::array<size_t, 2> edges[2] = {{{1, 0}}, {{1, 2}}};
+	for (const auto& edge : edges)
+	{
+		mesh->addEdge(SegmentMeshPlain::EdgeType(edge));
+	}
+	auto segmentMesh = std::make_shared<SegmentMeshShape>(*mesh, 0.1);
+
+	SdfSegmentMeshContact calculation;
+	auto pair = std::make_shared<CollisionPair>(m_sdfRepresentation, makeRepresentation(segmentMesh));
+	calculation.calculateContact(pair);
+
+	ASSERT_EQ(1u, pair->getContacts().size());
+	auto contact = pair->getContacts().front();
+	EXPECT_NEAR(0.15, contact->depth, 1e-3);
+	EXPECT_TRUE(contact->normal.isApprox(-Vector3d::UnitY(), 0.1));
+	ASSERT_TRUE(contact->penetrationPoints.second.elementMeshLocalCoordinate.hasValue());
+	const auto& coordinate = contact->penetrationPoints.second.elementMeshLocalCoordinate.getValue();
+	EXPECT_EQ(0u, coordinate.index);
+	EXPECT_TRUE(coordinate.coordinate.isApprox(Math::Vector2d(0.0, 1.0)));
+}
+
+};
+};
@@ -16,13 +16,15 @@
 /// \file
 /// Tests for the SegmentSegmentCheck functions.
 
+#include <algorithm>
 #include <array>
 
 #include <gtest/gtest.h>
 
 #include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/ContactCache.h"
 #include "SurgSim/Collision/SegmentSelfContact.h"
-#include "SurgSim/DataStructures/AabbTree.h"
+#include "SurgSim/DataStructures/FlatAabbTree.h"
 #include "SurgSim/DataStructures/Location.h"
 #include "SurgSim/Math/SegmentMeshShape.h"
 
@@ -82,13 +84,6 @@ class MockSegmentCcdSelfContact : public SurgSim::Collision::SegmentSelfContact
 		return SegmentSelfContact::removeInvalidCollisions(segmentA, segmentB, id1, id2);
 	}
 
-	void getUniqueCandidates(
-		const std::list<SurgSim::DataStructures::AabbTree::TreeNodePairType>& intersectionList,
-		std::set<std::pair<size_t, size_t>>* segmentIdList) const
-	{
-		SegmentSelfContact::getUniqueCandidates(intersectionList, segmentIdList);
-	}
-
 	bool detectCollision(
 		const std::array<SurgSim::Math::Vector3d, 2>& pt0Positions,
 		const std::array<SurgSim::Math::Vector3d, 2>& pt1Positions,
@@ -432,33 +427,48 @@ TEST_F(SegmentCcdSelfContactTests, RemoveInvalidCollisions)
 	shapeT1->getVertex(10).position -= Vector3d(10, 0, 0);
 };
 
-TEST_F(SegmentCcdSelfContactTests, GetUniqueCandidates)
+TEST_F(SegmentCcdSelfContactTests, SweptCandidates)
 {
 	std::shared_ptr<SegmentMeshShape> shapeT0 =
 		buildLoop(1.0e-03, 1.0e-04);
 	std::shared_ptr<SegmentMeshShape> shapeT1 =
 		buildLoop(-1.0e-03, 1.0e-04);
 
-	std::set<std::pair<size_t, size_t>> segmentIdList;
-	std::list<SurgSim::DataStructures::AabbTree::TreeNodePairType> intersectionList
-		= shapeT0->getAabbTree()->spatialJoin(*(shapeT1->getAabbTree()));
-	m_selfContact.getUniqueCandidates(intersectionList, &segmentIdList);
-	EXPECT_EQ(6u, segmentIdList.size());
-	EXPECT_TRUE(std::find(segmentIdList.begin(), segmentIdList.end(),
-						  std::pair<size_t, size_t>(0, 9)) != segmentIdList.end());
-	EXPECT_TRUE(std::find(segmentIdList.begin(), segmentIdList.end(),
-						  std::pair<size_t, size_t>(0, 8)) != segmentIdList.end());
-	EXPECT_TRUE(std::find(segmentIdList.begin(), segmentIdList.end(),
-						  std::pair<size_t, size_t>(1, 9)) != segmentIdList.end());
-	EXPECT_TRUE(std::find(segmentIdList.begin(), segmentIdList.end(),
-						  std::pair<size_t, size_t>(1, 8)) != segmentIdList.end());
-	EXPECT_TRUE(std::find(segmentIdList.begin(), segmentIdList.end(),
-						  std::pair<size_t, size_t>(4, 5)) != segmentIdList.end());
-	EXPECT_TRUE(std::find(segmentIdList.begin(), segmentIdList.end(),
-						  std::pair<size_t, size_t>(5, 6)) != segmentIdList.end());
-
-	EXPECT_FALSE(std::find(segmentIdList.begin(), segmentIdList.end(),
-						   std::pair<size_t, size_t>(1, 7)) != segmentIdList.end());
+	// As in the calculation, the candidates are the self intersections of the volumes swept by the segments
+	std::vector<DataStructures::FlatAabbTree::Item> items;
+	for (size_t id = 0; id < shapeT0->getNumEdges(); ++id)
+	{
+		const auto& vertices0 = shapeT0->getEdgePositions(id);
+		const auto& vertices1 = shapeT1->getEdgePositions(id);
+		Math::Aabbd aabb(vertices0[0]);
+		aabb.extend(vertices0[1]);
+		aabb.extend(vertices1[0]);
+		aabb.extend(vertices1[1]);
+		items.emplace_back(aabb, id);
+	}
+	DataStructures::FlatAabbTree tree;
+	tree.update(items);
+
+	std::vector<std::pair<size_t, size_t>> segmentIdList;
+	tree.forEachSelfIntersection([&segmentIdList](size_t idA, size_t idB)
+	{
+		segmentIdList.emplace_back(std::min(idA, idB), std::max(idA, idB));
+	});
+
+	// Each pair of distinct segments is reported once
+	std::sort(segmentIdList.begin(), segmentIdList.end());
+	EXPECT_TRUE(std::adjacent_find(segmentIdList.begin(), segmentIdList.end()) == segmentIdList.end());
+	for (const auto& idPair : segmentIdList)
+	{
+		EXPECT_NE(idPair.first, idPair.second);
+	}
+
+	// The segments crossing each other between the two times are candidates
+	const std::vector<std::pair<size_t, size_t>> crossingSegments = {{0, 9}, {0, 8}, {1, 9}, {1, 8}, {4, 5}, {5, 6}};
+	for (const auto& idPair : crossingSegments)
+	{
+		EXPECT_TRUE(std::binary_search(segmentIdList.begin(), segmentIdList.end(), idPair));
+	}
 };
 
 TEST_F(SegmentCcdSelfContactTests, DetectCollision)
@@ -585,5 +595,36 @@ TEST_F(SegmentCcdSelfContactTests, CalculateContact)
 	}
 };
 
+TEST_F(SegmentCcdSelfContactTests, CalculateCachedContact)
+{
+	std::shared_ptr<SegmentMeshShape> shapeT0 = buildLoop(1.0e-03, 1.0e-04);
+	std::shared_ptr<SegmentMeshShape> shapeT1 = buildLoop(-1.0e-03, 1.0e-04);
+	m_selfContact.setDistanceEpsilon(1.0e-06);
+	auto transform = Math::RigidTransform3d::Identity();
+
+	auto expected = m_selfContact.calculateCcdContact(*shapeT0, transform, *shapeT1, transform,
+					*shapeT0, transform, *shapeT1, transform);
+	ASSERT_EQ(1u, expected.size());
+
+	// The first call builds the tree of the swept volumes, the following ones refit it
+	ContactCache cache;
+	for (size_t i = 0; i < 3; ++i)
+	{
+		auto contacts = m_selfContact.calculateCachedCcdContact(*shapeT0, transform, *shapeT1, transform,
+						*shapeT0, transform, *shapeT1, transform, &cache);
+		ASSERT_NE(nullptr, cache.getAabbTree());
+		EXPECT_EQ(shapeT0->getNumEdges(), cache.getAabbTree()->getNumObjects());
+		ASSERT_EQ(expected.size(), contacts.size());
+		EXPECT_TRUE(*expected.front() == *contacts.front());
+		EXPECT_DOUBLE_EQ(expected.front()->time, contacts.front()->time);
+	}
+
+	// Moving apart, no contacts
+	std::shared_ptr<SegmentMeshShape> shapeT2 = buildLoop(-3.0e-03, 1.0e-04);
+	std::shared_ptr<SegmentMeshShape> shapeT3 = buildLoop(-5.0e-03, 1.0e-04);
+	EXPECT_TRUE(m_selfContact.calculateCachedCcdContact(*shapeT2, transform, *shapeT3, transform,
+				*shapeT2, transform, *shapeT3, transform, &cache).empty());
+}
+
 }; // namespace Collision
 }; // namespace SurgSim
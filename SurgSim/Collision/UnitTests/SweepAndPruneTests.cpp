@@ -0,0 +1,156 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "SurgSim/Collision/Representation.h"
+#include "SurgSim/Collision/SweepAndPrune.h"
+#include "SurgSim/Collision/UnitTests/RepresentationUtilities.h"
+#include "SurgSim/Math/Aabb.h"
+#include "SurgSim/Math/Quaternion.h"
+#include "SurgSim/Math/RigidTransform.h"
+#include "SurgSim/Math/Vector.h"
+
+using SurgSim::Math::Quaterniond;
+using SurgSim::Math::Vector3d;
+
+namespace
+{
+
+std::vector<std::pair<size_t, size_t>> bruteForcePairs(
+	const std::vector<std::shared_ptr<SurgSim::Collision::Representation>>& representations)
+{
+	std::vector<std::pair<size_t, size_t>> result;
+	for (size_t i = 0; i < representations.size(); ++i)
+	{
+		for (size_t j = i + 1; j < representations.size(); ++j)
+		{
+			auto one = representations[i]->getBoundingBox();
+			auto two = representations[j]->getBoundingBox();
+			if (one.isEmpty() || two.isEmpty() || SurgSim::Math::doAabbIntersect(one, two))
+			{
+				result.emplace_back(i, j);
+			}
+		}
+	}
+	return result;
+}
+
+}
+
+namespace SurgSim
+{
+namespace Collision
+{
+
+TEST(SweepAndPruneTests, InitTest)
+{
+	ASSERT_NO_THROW(SweepAndPrune sweepAndPrune);
+
+	SweepAndPrune sweepAndPrune;
+	EXPECT_TRUE(sweepAndPrune.getOverlappingPairs().empty());
+
+	std::vector<std::shared_ptr<Representation>> representations;
+	ASSERT_NO_THROW(sweepAndPrune.update(representations));
+	EXPECT_TRUE(sweepAndPrune.getOverlappingPairs().empty());
+}
+
+TEST(SweepAndPruneTests, SimpleOverlap)
+{
+	SweepAndPrune sweepAndPrune;
+	std::vector<std::shared_ptr<Representation>> representations;
+	representations.push_back(makeSphereRepresentation(1.0, Quaterniond::Identity(), Vector3d(0.0, 0.0, 0.0)));
+	representations.push_back(makeSphereRepresentation(1.0, Quaterniond::Identity(), Vector3d(10.0, 0.0, 0.0)));
+	representations.push_back(makeSphereRepresentation(1.0, Quaterniond::Identity(), Vector3d(1.5, 0.0, 0.0)));
+
+	sweepAndPrune.update(representations);
+	ASSERT_EQ(1u, sweepAndPrune.getOverlappingPairs().size());
+	EXPECT_EQ(std::make_pair(size_t(0), size_t(2)), sweepAndPrune.getOverlappingPairs()[0]);
+
+	// Overlapping along the sweep axis only
+	representations[2]->setLocalPose(Math::makeRigidTransform(Quaterniond::Identity(), Vector3d(1.5, 5.0, 0.0)));
+	sweepAndPrune.update(representations);
+	EXPECT_TRUE(sweepAndPrune.getOverlappingPairs().empty());
+
+	// Touching boxes are overlapping, like in CollisionPair::mayIntersect()
+	representations[2]->setLocalPose(Math::makeRigidTransform(Quaterniond::Identity(), Vector3d(8.0, 0.0, 0.0)));
+	sweepAndPrune.update(representations);
+	ASSERT_EQ(1u, sweepAndPrune.getOverlappingPairs().size());
+	EXPECT_EQ(std::make_pair(size_t(1), size_t(2)), sweepAndPrune.getOverlappingPairs()[0]);
+}
+
+TEST(SweepAndPruneTests, UnboundedRepresentations)
+{
+	SweepAndPrune sweepAndPrune;
+	std::vector<std::shared_ptr<Representation>> representations;
+	representations.push_back(makeSphereRepresentation(1.0, Quaterniond::Identity(), Vector3d(0.0, 0.0, 0.0)));
+	representations.push_back(makePlaneRepresentation());
+	representations.push_back(makeSphereRepresentation(1.0, Quaterniond::Identity(), Vector3d(10.0, 0.0, 0.0)));
+	representations.push_back(makeDoubleSidedPlaneRepresentation());
+
+	ASSERT_TRUE(representations[1]->getBoundingBox().isEmpty());
+
+	sweepAndPrune.update(representations);
+	EXPECT_EQ(bruteForcePairs(representations), sweepAndPrune.getOverlappingPairs());
+	EXPECT_EQ(5u, sweepAndPrune.getOverlappingPairs().size());
+}
+
+TEST(SweepAndPruneTests, MatchesBruteForce)
+{
+	std::mt19937 generator(1234);
+	std::uniform_real_distribution<double> position(-10.0, 10.0);
+	std::uniform_real_distribution<double> step(-0.5, 0.5);
+	std::uniform_real_distribution<double> radius(0.1, 2.0);
+
+	std::vector<std::shared_ptr<Representation>> all;
+	std::vector<Vector3d> positions;
+	for (size_t i = 0; i < 100; ++i)
+	{
+		positions.emplace_back(position(generator), position(generator), position(generator) * 0.1);
+		all.push_back(makeSphereRepresentation(radius(generator), Quaterniond::Identity(), positions.back()));
+	}
+
+	SweepAndPrune sweepAndPrune;
+	for (size_t frame = 0; frame < 50; ++frame)
+	{
+		// Change the set of representations from time to time
+		std::vector<std::shared_ptr<Representation>> representations;
+		for (size_t i = 0; i < all.size(); ++i)
+		{
+			if ((i + frame / 10) % 7 != 0)
+			{
+				representations.push_back(all[i]);
+			}
+		}
+		if (frame % 3 == 0)
+		{
+			std::reverse(representations.begin(), representations.end());
+		}
+
+		sweepAndPrune.update(representations);
+		EXPECT_EQ(bruteForcePairs(representations), sweepAndPrune.getOverlappingPairs()) << "Frame " << frame;
+
+		for (size_t i = 0; i < all.size(); ++i)
+		{
+			positions[i] += Vector3d(step(generator), step(generator), step(generator));
+			all[i]->setLocalPose(Math::makeRigidTransform(Quaterniond::Identity(), positions[i]));
+		}
+	}
+}
+
+};
+};
@@ -13,6 +13,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "SurgSim/Collision/ContactCache.h"
 #include "SurgSim/Collision/TriangleMeshTriangleMeshContact.h"
 #include "SurgSim/Collision/UnitTests/ContactCalculationTestsCommon.h"
 #include "SurgSim/DataStructures/EmptyData.h"
@@ -493,5 +494,134 @@ TEST(TriangleMeshTriangleMeshContactCalculationTests, IntersectionTestAtIdentica
 }
 
 
+TEST(TriangleMeshTriangleMeshContactCalculationTests, CachedTest)
+{
+	using SurgSim::Math::makeRigidTransform;
+
+	std::shared_ptr<TriangleMeshPlain> mesh = std::make_shared<TriangleMeshPlain>();
+	for (int i = 0; i < cubeNumPoints; ++i)
+	{
+		mesh->addVertex(TriangleMeshPlain::VertexType(cubePoints[i]));
+	}
+	for (int i = 0; i < cubeNumTriangles; ++i)
+	{
+		std::array<size_t, 3> trianglePoints;
+		for (int j = 0; j < 3; j++)
+		{
+			trianglePoints[j] = cubeTrianglesCCW[i][j];
+		}
+		mesh->addTriangle(TriangleMeshPlain::TriangleType(trianglePoints));
+	}
+
+	auto meshARep = std::make_shared<ShapeCollisionRepresentation>("Collision Mesh 0");
+	meshARep->setShape(std::make_shared<SurgSim::Math::MeshShape>(*mesh));
+	auto meshBRep = std::make_shared<ShapeCollisionRepresentation>("Collision Mesh 1");
+	meshBRep->setShape(std::make_shared<SurgSim::Math::MeshShape>(*mesh));
+
+	// The second cube goes through the first one, the cached calculation gives the same results as the plain one
+	TriangleMeshTriangleMeshContact calcContact;
+	auto cache = std::make_shared<ContactCache>();
+	const size_t numSteps = 41;
+	size_t numSeparatedSteps = 0;
+	size_t numEarlyExits = 0;
+	for (size_t step = 0; step < numSteps; ++step)
+	{
+		SCOPED_TRACE("Step " + std::to_string(step));
+		meshBRep->setLocalPose(makeRigidTransform(SurgSim::Math::Quaterniond::Identity(),
+								Vector3d(-2.0 + 0.1 * step, 0.2, 0.1)));
+
+		auto pair = std::make_shared<CollisionPair>(meshARep, meshBRep);
+		calcContact.calculateContact(pair);
+
+		Vector3d axis;
+		if (cache->getSeparatingAxis(&axis))
+		{
+			++numSeparatedSteps;
+		}
+		auto cachedPair = std::make_shared<CollisionPair>(meshARep, meshBRep);
+		cachedPair->setContactCache(cache);
+		calcContact.calculateContact(cachedPair);
+
+		ASSERT_EQ(pair->getContacts().size(), cachedPair->getContacts().size());
+		auto cachedContact = cachedPair->getContacts().begin();
+		for (const auto& contact : pair->getContacts())
+		{
+			EXPECT_TRUE(*contact == **cachedContact);
+			EXPECT_DOUBLE_EQ(contact->depth, (*cachedContact)->depth);
+			++cachedContact;
+		}
+		EXPECT_EQ(meshARep.get(), cache->getFirst());
+
+		// The trees are only traversed when the cached axis does not separate the meshes
+		if (cache->getNumEarlyExits() > numEarlyExits)
+		{
+			EXPECT_EQ(numEarlyExits + 1, cache->getNumEarlyExits());
+			EXPECT_TRUE(pair->getContacts().empty());
+			numEarlyExits = cache->getNumEarlyExits();
+		}
+	}
+	EXPECT_EQ(numSteps, cache->getAge());
+	EXPECT_LT(0u, numSeparatedSteps);
+	EXPECT_LT(0u, numEarlyExits);
+	EXPECT_GE(numSeparatedSteps, numEarlyExits);
+
+	{
+		SCOPED_TRACE("Static separated meshes");
+		meshBRep->setLocalPose(makeRigidTransform(SurgSim::Math::Quaterniond::Identity(), Vector3d(3.0, 0.0, 0.0)));
+		cache->clear();
+		auto pair = std::make_shared<CollisionPair>(meshARep, meshBRep);
+		pair->setContactCache(cache);
+		calcContact.calculateContact(pair);
+		EXPECT_TRUE(pair->getContacts().empty());
+		EXPECT_EQ(0u, cache->getNumEarlyExits());
+
+		// The axis found by the first calculation is enough for all the following ones
+		for (size_t step = 1; step < 5; ++step)
+		{
+			pair = std::make_shared<CollisionPair>(meshARep, meshBRep);
+			pair->setContactCache(cache);
+			calcContact.calculateContact(pair);
+			EXPECT_TRUE(pair->getContacts().empty());
+			EXPECT_EQ(step, cache->getNumEarlyExits());
+		}
+	}
+
+	{
+		SCOPED_TRACE("Static meshes in contact");
+		meshBRep->setLocalPose(makeRigidTransform(SurgSim::Math::Quaterniond::Identity(), Vector3d(0.5, 0.2, 0.1)));
+		cache->clear();
+		for (size_t step = 0; step < 3; ++step)
+		{
+			auto pair = std::make_shared<CollisionPair>(meshARep, meshBRep);
+			pair->setContactCache(cache);
+			calcContact.calculateContact(pair);
+			EXPECT_FALSE(pair->getContacts().empty());
+
+			// The normal of the shallowest contact is kept for the next frame, it cannot separate the touching meshes
+			Vector3d axis;
+			EXPECT_TRUE(cache->getSeparatingAxis(&axis));
+			EXPECT_EQ(0u, cache->getNumEarlyExits());
+		}
+	}
+
+	{
+		SCOPED_TRACE("Meshes leaving contact");
+		meshBRep->setLocalPose(makeRigidTransform(SurgSim::Math::Quaterniond::Identity(), Vector3d(0.9, 0.2, 0.1)));
+		cache->clear();
+		auto pair = std::make_shared<CollisionPair>(meshARep, meshBRep);
+		pair->setContactCache(cache);
+		calcContact.calculateContact(pair);
+		EXPECT_FALSE(pair->getContacts().empty());
+
+		// The normal of the shallowest contact separates the meshes as soon as they move apart along it
+		meshBRep->setLocalPose(makeRigidTransform(SurgSim::Math::Quaterniond::Identity(), Vector3d(1.2, 0.2, 0.1)));
+		pair = std::make_shared<CollisionPair>(meshARep, meshBRep);
+		pair->setContactCache(cache);
+		calcContact.calculateContact(pair);
+		EXPECT_TRUE(pair->getContacts().empty());
+		EXPECT_EQ(1u, cache->getNumEarlyExits());
+	}
+}
+
 }; // namespace Collision
 }; // namespace Surgsim
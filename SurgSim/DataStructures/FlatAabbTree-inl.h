@@ -0,0 +1,217 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SURGSIM_DATASTRUCTURES_FLATAABBTREE_INL_H
+#define SURGSIM_DATASTRUCTURES_FLATAABBTREE_INL_H
+
+#include <array>
+
+#include "SurgSim/Framework/Assert.h"
+#include "SurgSim/Framework/Runtime.h"
+#include "SurgSim/Framework/ThreadPool.h"
+
+namespace SurgSim
+{
+namespace DataStructures
+{
+
+template <class Function>
+void FlatAabbTree::forEachIntersection(const FlatAabbTree& otherTree, Function function) const
+{
+	if (!m_nodes.empty() && !otherTree.m_nodes.empty())
+	{
+		forEachNodeIntersection(otherTree, 0, 0, [this, &otherTree, &function](size_t node, size_t otherNode)
+		{
+			forEachObjectIntersection(node, otherTree, otherNode, function);
+		});
+	}
+}
+
+template <class Function>
+void FlatAabbTree::forEachSelfIntersection(Function function) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	// A node against itself is split into both children against themselves and the children against each other,
+	// the latter is a regular traversal of two disjoint subtrees
+	auto objectFunction = [this, &function](size_t node, size_t otherNode)
+	{
+		forEachObjectIntersection(node, *this, otherNode, function);
+	};
+
+	SURGSIM_ASSERT(m_depth < MaxStackSize) << "The tree is too deep for the traversal.";
+	std::array<size_t, MaxStackSize> stack;
+	size_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		const size_t node = stack[--stackSize];
+		if (isLeaf(node))
+		{
+			const size_t end = m_nodes[node].firstObject + m_nodes[node].numObjects;
+			for (size_t slot = m_nodes[node].firstObject; slot < end; ++slot)
+			{
+				for (size_t otherSlot = slot + 1; otherSlot < end; ++otherSlot)
+				{
+					if (doIntersect(m_objectMin, m_objectMax, slot, m_objectMin, m_objectMax, otherSlot))
+					{
+						function(m_objectIds[slot], m_objectIds[otherSlot]);
+					}
+				}
+			}
+		}
+		else
+		{
+			const size_t firstChild = node + 1;
+			const size_t secondChild = m_nodes[node].secondChild;
+			forEachNodeIntersection(*this, firstChild, secondChild, objectFunction);
+			stack[stackSize++] = secondChild;
+			stack[stackSize++] = firstChild;
+		}
+	}
+}
+
+template <class Result, class Function>
+void FlatAabbTree::forEachIntersectionParallel(const FlatAabbTree& otherTree, std::vector<Result>* results,
+		Function function, size_t costThreshold) const
+{
+	results->clear();
+	if (m_nodes.empty() || otherTree.m_nodes.empty())
+	{
+		return;
+	}
+
+	auto traverse = [this, &otherTree, results, &function]()
+	{
+		results->resize(1);
+		Result* result = &results->front();
+		forEachIntersection(otherTree, [result, &function](size_t id, size_t otherId)
+		{
+			function(id, otherId, result);
+		});
+	};
+
+	// The traversal of small trees is cheaper than their split
+	if (m_nodes[0].numSubtreeObjects + otherTree.m_nodes[0].numSubtreeObjects <= costThreshold)
+	{
+		traverse();
+		return;
+	}
+
+	auto threadPool = Framework::Runtime::getThreadPool();
+
+	// Enough tasks to balance the load between the threads, with a few spare ones to steal
+	std::vector<NodePairType> tasks;
+	const size_t cost = splitIntersections(otherTree, 4 * (threadPool->getNumThreads() + 1), &tasks);
+	if (cost <= costThreshold)
+	{
+		traverse();
+		return;
+	}
+
+	results->resize(tasks.size());
+	auto runTask = [this, &otherTree, &tasks, results, &function](size_t i)
+	{
+		Result* result = &(*results)[i];
+		forEachNodeIntersection(otherTree, tasks[i].first, tasks[i].second,
+								[this, &otherTree, result, &function](size_t node, size_t otherNode)
+		{
+			forEachObjectIntersection(node, otherTree, otherNode, [result, &function](size_t id, size_t otherId)
+			{
+				function(id, otherId, result);
+			});
+		});
+	};
+
+	threadPool->parallelFor(0, tasks.size(), 1, runTask);
+}
+
+template <class BoundsA, class BoundsB>
+bool FlatAabbTree::doIntersect(const BoundsA& minA, const BoundsA& maxA, size_t i,
+							   const BoundsB& minB, const BoundsB& maxB, size_t j)
+{
+	return minA(i, 0) <= maxB(j, 0) && minB(j, 0) <= maxA(i, 0) &&
+		   minA(i, 1) <= maxB(j, 1) && minB(j, 1) <= maxA(i, 1) &&
+		   minA(i, 2) <= maxB(j, 2) && minB(j, 2) <= maxA(i, 2);
+}
+
+template <class Function>
+void FlatAabbTree::forEachNodeIntersection(const FlatAabbTree& otherTree, size_t node, size_t otherNode,
+		Function function) const
+{
+	// Every step replaces one pair with at most two pairs one level deeper in one of the trees
+	SURGSIM_ASSERT(m_depth + otherTree.m_depth <= MaxStackSize) << "The trees are too deep for the traversal.";
+
+	std::array<NodePairType, MaxStackSize> stack;
+	size_t stackSize = 0;
+	stack[stackSize++] = NodePairType(node, otherNode);
+
+	while (stackSize > 0)
+	{
+		const NodePairType current = stack[--stackSize];
+		if (!doIntersect(m_nodeMin, m_nodeMax, current.first,
+						 otherTree.m_nodeMin, otherTree.m_nodeMax, current.second))
+		{
+			continue;
+		}
+
+		const bool isNodeLeaf = isLeaf(current.first);
+		const bool isOtherNodeLeaf = otherTree.isLeaf(current.second);
+		if (isNodeLeaf && isOtherNodeLeaf)
+		{
+			function(current.first, current.second);
+		}
+		else if (isOtherNodeLeaf || (!isNodeLeaf &&
+				 (m_nodeMax.row(current.first) - m_nodeMin.row(current.first)).sum() >=
+				 (otherTree.m_nodeMax.row(current.second) - otherTree.m_nodeMin.row(current.second)).sum()))
+		{
+			// Descend into the larger node
+			stack[stackSize++] = NodePairType(m_nodes[current.first].secondChild, current.second);
+			stack[stackSize++] = NodePairType(current.first + 1, current.second);
+		}
+		else
+		{
+			stack[stackSize++] = NodePairType(current.first, otherTree.m_nodes[current.second].secondChild);
+			stack[stackSize++] = NodePairType(current.first, current.second + 1);
+		}
+	}
+}
+
+template <class Function>
+void FlatAabbTree::forEachObjectIntersection(size_t node, const FlatAabbTree& otherTree, size_t otherNode,
+		Function function) const
+{
+	const size_t end = m_nodes[node].firstObject + m_nodes[node].numObjects;
+	const size_t otherBegin = otherTree.m_nodes[otherNode].firstObject;
+	const size_t otherEnd = otherBegin + otherTree.m_nodes[otherNode].numObjects;
+	for (size_t slot = m_nodes[node].firstObject; slot < end; ++slot)
+	{
+		for (size_t otherSlot = otherBegin; otherSlot < otherEnd; ++otherSlot)
+		{
+			if (doIntersect(m_objectMin, m_objectMax, slot, otherTree.m_objectMin, otherTree.m_objectMax, otherSlot))
+			{
+				function(m_objectIds[slot], otherTree.m_objectIds[otherSlot]);
+			}
+		}
+	}
+}
+
+}; // namespace DataStructures
+}; // namespace SurgSim
+
+#endif // SURGSIM_DATASTRUCTURES_FLATAABBTREE_INL_H
@@ -0,0 +1,436 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SurgSim/DataStructures/FlatAabbTree.h"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+#include "SurgSim/Framework/Assert.h"
+#include "SurgSim/Framework/Runtime.h"
+#include "SurgSim/Framework/ThreadPool.h"
+
+namespace
+{
+
+/// \return the surface area of the box given by its extents
+double surfaceArea(const SurgSim::Math::Vector3d& sizes)
+{
+	return 2.0 * (sizes[0] * sizes[1] + sizes[1] * sizes[2] + sizes[2] * sizes[0]);
+}
+
+}
+
+namespace SurgSim
+{
+namespace DataStructures
+{
+
+FlatAabbTree::FlatAabbTree(size_t maxObjectsPerNode) :
+	m_maxObjectsPerNode(maxObjectsPerNode),
+	m_rebuildThreshold(1.5),
+	m_depth(0),
+	m_cost(0.0),
+	m_buildCost(0.0)
+{
+	SURGSIM_ASSERT(maxObjectsPerNode > 0) << "A FlatAabbTree needs at least one object per node.";
+}
+
+FlatAabbTree::~FlatAabbTree()
+{
+}
+
+size_t FlatAabbTree::getMaxObjectsPerNode() const
+{
+	return m_maxObjectsPerNode;
+}
+
+void FlatAabbTree::setRebuildThreshold(double threshold)
+{
+	SURGSIM_ASSERT(threshold >= 1.0) << "The rebuild threshold can not be less than 1.0, it is " << threshold;
+	m_rebuildThreshold = threshold;
+}
+
+double FlatAabbTree::getRebuildThreshold() const
+{
+	return m_rebuildThreshold;
+}
+
+void FlatAabbTree::build(const std::vector<Item>& items)
+{
+	const size_t count = items.size();
+
+	std::vector<Math::Vector3d> centers;
+	centers.reserve(count);
+	m_itemIds.resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		centers.push_back(items[i].first.center());
+		m_itemIds[i] = items[i].second;
+	}
+
+	m_itemOrder.resize(count);
+	std::iota(m_itemOrder.begin(), m_itemOrder.end(), 0);
+
+	m_nodes.clear();
+	m_depth = 0;
+	if (count > 0)
+	{
+		m_nodes.reserve(2 * (count / m_maxObjectsPerNode) + 1);
+		buildNode(centers, 0, count, 1);
+	}
+
+	m_objectIds.resize(count);
+	m_itemSlots.resize(count);
+	m_objectMin.resize(count, 3);
+	m_objectMax.resize(count, 3);
+	for (size_t slot = 0; slot < count; ++slot)
+	{
+		const Item& item = items[m_itemOrder[slot]];
+		m_objectIds[slot] = item.second;
+		m_objectMin.row(slot) = item.first.min().transpose();
+		m_objectMax.row(slot) = item.first.max().transpose();
+		m_itemSlots[m_itemOrder[slot]] = slot;
+	}
+
+	m_nodeMin.resize(m_nodes.size(), 3);
+	m_nodeMax.resize(m_nodes.size(), 3);
+	refitNodes();
+	m_buildCost = m_cost;
+}
+
+size_t FlatAabbTree::buildNode(const std::vector<Math::Vector3d>& centers, size_t begin, size_t end, size_t depth)
+{
+	const size_t index = m_nodes.size();
+	Node node = {0, begin, end - begin, end - begin};
+	m_nodes.push_back(node);
+	m_depth = std::max(m_depth, depth);
+
+	if (end - begin > m_maxObjectsPerNode)
+	{
+		Math::Aabbd centerBounds;
+		for (size_t i = begin; i < end; ++i)
+		{
+			centerBounds.extend(centers[m_itemOrder[i]]);
+		}
+		size_t axis;
+		centerBounds.sizes().maxCoeff(&axis);
+
+		// Splitting at the median keeps the tree balanced, even when many centers coincide
+		const size_t middle = begin + (end - begin) / 2;
+		std::nth_element(m_itemOrder.begin() + begin, m_itemOrder.begin() + middle, m_itemOrder.begin() + end,
+						 [&centers, axis](size_t a, size_t b) {return centers[a][axis] < centers[b][axis];});
+
+		m_nodes[index].numObjects = 0;
+		buildNode(centers, begin, middle, depth + 1);
+		size_t secondChild = buildNode(centers, middle, end, depth + 1);
+		m_nodes[index].secondChild = secondChild;
+	}
+
+	return index;
+}
+
+void FlatAabbTree::refit(const std::vector<Item>& items)
+{
+	SURGSIM_ASSERT(items.size() == m_itemIds.size()) << "Can't refit a tree with a different number of items, tree has "
+		<< m_itemIds.size() << " items, refit has " << items.size() << ".";
+
+	for (size_t i = 0; i < items.size(); ++i)
+	{
+		SURGSIM_ASSERT(items[i].second == m_itemIds[i]) << "Can't refit a tree with different items.";
+		const size_t slot = m_itemSlots[i];
+		m_objectMin.row(slot) = items[i].first.min().transpose();
+		m_objectMax.row(slot) = items[i].first.max().transpose();
+	}
+
+	refitNodes();
+}
+
+bool FlatAabbTree::update(const std::vector<Item>& items)
+{
+	bool sameItems = (items.size() == m_itemIds.size()) &&
+					 std::equal(items.begin(), items.end(), m_itemIds.begin(),
+								[](const Item& item, size_t id) {return item.second == id;});
+
+	if (sameItems)
+	{
+		refit(items);
+		if (m_cost <= m_rebuildThreshold * m_buildCost)
+		{
+			return false;
+		}
+	}
+
+	build(items);
+	return true;
+}
+
+void FlatAabbTree::refitNodes()
+{
+	double internalArea = 0.0;
+
+	// Children are always stored after their parent
+	for (size_t index = m_nodes.size(); index-- > 0;)
+	{
+		const Node& node = m_nodes[index];
+		if (node.numObjects > 0)
+		{
+			m_nodeMin.row(index) = m_objectMin.middleRows(node.firstObject, node.numObjects).colwise().minCoeff();
+			m_nodeMax.row(index) = m_objectMax.middleRows(node.firstObject, node.numObjects).colwise().maxCoeff();
+		}
+		else
+		{
+			m_nodeMin.row(index) = m_nodeMin.row(index + 1).cwiseMin(m_nodeMin.row(node.secondChild));
+			m_nodeMax.row(index) = m_nodeMax.row(index + 1).cwiseMax(m_nodeMax.row(node.secondChild));
+			internalArea += surfaceArea((m_nodeMax.row(index) - m_nodeMin.row(index)).transpose());
+		}
+	}
+
+	if (m_nodes.empty())
+	{
+		m_aabb.setEmpty();
+		m_cost = 0.0;
+	}
+	else
+	{
+		m_aabb = getNodeAabb(0);
+		double rootArea = surfaceArea(m_aabb.sizes());
+		m_cost = (rootArea > 0.0) ? internalArea / rootArea : 0.0;
+	}
+}
+
+double FlatAabbTree::getCost() const
+{
+	return m_cost;
+}
+
+double FlatAabbTree::getBuildCost() const
+{
+	return m_buildCost;
+}
+
+const Math::Aabbd& FlatAabbTree::getAabb() const
+{
+	return m_aabb;
+}
+
+bool FlatAabbTree::isEmpty() const
+{
+	return m_objectIds.empty();
+}
+
+size_t FlatAabbTree::getNumObjects() const
+{
+	return m_objectIds.size();
+}
+
+size_t FlatAabbTree::getNumNodes() const
+{
+	return m_nodes.size();
+}
+
+bool FlatAabbTree::isLeaf(size_t node) const
+{
+	return m_nodes[node].numObjects > 0;
+}
+
+size_t FlatAabbTree::getFirstChild(size_t node) const
+{
+	SURGSIM_ASSERT(!isLeaf(node)) << "Leaf nodes don't have children.";
+	return node + 1;
+}
+
+size_t FlatAabbTree::getSecondChild(size_t node) const
+{
+	SURGSIM_ASSERT(!isLeaf(node)) << "Leaf nodes don't have children.";
+	return m_nodes[node].secondChild;
+}
+
+Math::Aabbd FlatAabbTree::getNodeAabb(size_t node) const
+{
+	return Math::Aabbd(m_nodeMin.row(node).transpose(), m_nodeMax.row(node).transpose());
+}
+
+std::vector<size_t> FlatAabbTree::getNodeObjects(size_t node) const
+{
+	SURGSIM_ASSERT(isLeaf(node)) << "Only leaf nodes have objects.";
+	auto begin = m_objectIds.begin() + m_nodes[node].firstObject;
+	return std::vector<size_t>(begin, begin + m_nodes[node].numObjects);
+}
+
+void FlatAabbTree::getNodeIntersections(size_t node, const Math::Aabbd& aabb, std::vector<size_t>* result) const
+{
+	SURGSIM_ASSERT(isLeaf(node)) << "Only leaf nodes have objects.";
+	const Eigen::RowVector3d queryMin = aabb.min().transpose();
+	const Eigen::RowVector3d queryMax = aabb.max().transpose();
+	const size_t end = m_nodes[node].firstObject + m_nodes[node].numObjects;
+	for (size_t slot = m_nodes[node].firstObject; slot < end; ++slot)
+	{
+		if (doIntersect(m_objectMin, m_objectMax, slot, queryMin, queryMax, 0))
+		{
+			result->push_back(m_objectIds[slot]);
+		}
+	}
+}
+
+void FlatAabbTree::getNodeIntersections(size_t node, const FlatAabbTree& otherTree, size_t otherNode,
+										std::vector<std::pair<size_t, size_t>>* result) const
+{
+	SURGSIM_ASSERT(isLeaf(node) && otherTree.isLeaf(otherNode)) << "Only leaf nodes have objects.";
+	forEachObjectIntersection(node, otherTree, otherNode, [result](size_t id, size_t otherId)
+	{
+		result->emplace_back(id, otherId);
+	});
+}
+
+void FlatAabbTree::getIntersections(const Math::Aabbd& aabb, std::vector<size_t>* result) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	const Eigen::RowVector3d queryMin = aabb.min().transpose();
+	const Eigen::RowVector3d queryMax = aabb.max().transpose();
+
+	SURGSIM_ASSERT(m_depth < MaxStackSize) << "The tree is too deep for the traversal.";
+	std::array<size_t, MaxStackSize> stack;
+	size_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		const size_t node = stack[--stackSize];
+		if (doIntersect(m_nodeMin, m_nodeMax, node, queryMin, queryMax, 0))
+		{
+			if (isLeaf(node))
+			{
+				getNodeIntersections(node, aabb, result);
+			}
+			else
+			{
+				stack[stackSize++] = m_nodes[node].secondChild;
+				stack[stackSize++] = node + 1;
+			}
+		}
+	}
+}
+
+void FlatAabbTree::spatialJoin(const FlatAabbTree& otherTree, std::vector<NodePairType>* result) const
+{
+	if (!m_nodes.empty() && !otherTree.m_nodes.empty())
+	{
+		forEachNodeIntersection(otherTree, 0, 0, [result](size_t node, size_t otherNode)
+		{
+			result->emplace_back(node, otherNode);
+		});
+	}
+}
+
+void FlatAabbTree::getIntersections(const FlatAabbTree& otherTree, std::vector<ObjectPairType>* result) const
+{
+	forEachIntersection(otherTree, [result](size_t id, size_t otherId)
+	{
+		result->emplace_back(id, otherId);
+	});
+}
+
+void FlatAabbTree::getIntersectionsParallel(const FlatAabbTree& otherTree, std::vector<ObjectPairType>* result) const
+{
+	std::vector<std::vector<ObjectPairType>> taskResults;
+	forEachIntersectionParallel(otherTree, &taskResults,
+								[](size_t id, size_t otherId, std::vector<ObjectPairType>* taskResult)
+	{
+		taskResult->emplace_back(id, otherId);
+	}, 0);
+
+	size_t size = result->size();
+	for (const auto& taskResult : taskResults)
+	{
+		size += taskResult.size();
+	}
+	result->reserve(size);
+	for (const auto& taskResult : taskResults)
+	{
+		result->insert(result->end(), taskResult.begin(), taskResult.end());
+	}
+}
+
+size_t FlatAabbTree::splitIntersections(const FlatAabbTree& otherTree, size_t minNumTasks,
+										std::vector<NodePairType>* tasks) const
+{
+	tasks->clear();
+	if (m_nodes.empty() || otherTree.m_nodes.empty())
+	{
+		return 0;
+	}
+
+	// Expand the top levels of both trees, breadth first, until there are enough independent node pairs
+	tasks->emplace_back(0, 0);
+	std::vector<NodePairType> nextTasks;
+	bool hasSplit = true;
+	while (tasks->size() < minNumTasks && hasSplit)
+	{
+		hasSplit = false;
+		nextTasks.clear();
+		for (const auto& task : *tasks)
+		{
+			if (!doIntersect(m_nodeMin, m_nodeMax, task.first, otherTree.m_nodeMin, otherTree.m_nodeMax, task.second))
+			{
+				continue;
+			}
+
+			const bool isNodeLeaf = isLeaf(task.first);
+			const bool isOtherNodeLeaf = otherTree.isLeaf(task.second);
+			std::array<size_t, 2> nodes = {{task.first, task.first}};
+			std::array<size_t, 2> otherNodes = {{task.second, task.second}};
+			if (!isNodeLeaf)
+			{
+				nodes[0] = task.first + 1;
+				nodes[1] = m_nodes[task.first].secondChild;
+			}
+			if (!isOtherNodeLeaf)
+			{
+				otherNodes[0] = task.second + 1;
+				otherNodes[1] = otherTree.m_nodes[task.second].secondChild;
+			}
+			hasSplit = hasSplit || !isNodeLeaf || !isOtherNodeLeaf;
+
+			for (size_t i = 0; i < (isNodeLeaf ? 1 : 2); ++i)
+			{
+				for (size_t j = 0; j < (isOtherNodeLeaf ? 1 : 2); ++j)
+				{
+					nextTasks.emplace_back(nodes[i], otherNodes[j]);
+				}
+			}
+		}
+		tasks->swap(nextTasks);
+	}
+
+	// The traversal of a node pair visits at most the objects of both subtrees, each pair that still overlaps
+	// costs the number of objects below it
+	size_t cost = 0;
+	for (const auto& task : *tasks)
+	{
+		if (doIntersect(m_nodeMin, m_nodeMax, task.first, otherTree.m_nodeMin, otherTree.m_nodeMax, task.second))
+		{
+			cost += m_nodes[task.first].numSubtreeObjects + otherTree.m_nodes[task.second].numSubtreeObjects;
+		}
+	}
+	return cost;
+}
+
+}; // namespace DataStructures
+}; // namespace SurgSim
@@ -0,0 +1,320 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SURGSIM_DATASTRUCTURES_FLATAABBTREE_H
+#define SURGSIM_DATASTRUCTURES_FLATAABBTREE_H
+
+#include <utility>
+#include <vector>
+
+#include "SurgSim/Math/Aabb.h"
+#include "SurgSim/Math/Vector.h"
+
+namespace SurgSim
+{
+namespace DataStructures
+{
+
+/// Bounding volume hierarchy of axis aligned bounding boxes, stored in contiguous arrays.
+/// The nodes are kept in depth first order, the first child of an internal node directly follows its parent,
+/// the second child is referenced by index. The bounds of the nodes and of the objects are stored as a
+/// structure of arrays, separately from the topology.
+/// When the objects move without changing (e.g. a deforming mesh) the tree can be refit bottom-up in linear
+/// time, the topology is kept as long as its quality does not degrade too much, see update().
+class FlatAabbTree
+{
+public:
+	/// An object of the tree, its bounding box and an id assigned by the user of this class
+	typedef std::pair<Math::Aabbd, size_t> Item;
+
+	/// Constructor
+	/// \param maxObjectsPerNode the maximum number of objects in a leaf node
+	explicit FlatAabbTree(size_t maxObjectsPerNode = 3);
+
+	/// Destructor
+	~FlatAabbTree();
+
+	/// \return the maximum number of objects in a leaf node
+	size_t getMaxObjectsPerNode() const;
+
+	/// Set the ratio between the current cost and the cost after the last build at which update() rebuilds the
+	/// tree instead of refitting it.
+	/// \param threshold the ratio, a value of 1.0 rebuilds the tree on every update
+	void setRebuildThreshold(double threshold);
+
+	/// \return the ratio between the current cost and the cost after the last build at which update() rebuilds the
+	/// tree instead of refitting it.
+	double getRebuildThreshold() const;
+
+	/// Build a new topology from the given items, all the previous information will be deleted
+	/// \param items the objects to put in the tree
+	void build(const std::vector<Item>& items);
+
+	/// Update the bounding boxes of the objects and of all the nodes, keeping the topology of the tree.
+	/// \param items the objects of the tree, need to have the same ids, in the same order, as in the last build
+	void refit(const std::vector<Item>& items);
+
+	/// Refit the tree when the items are the same as in the last build, rebuild it when the items changed
+	/// or when the quality of the refitted tree dropped below the rebuild threshold.
+	/// \param items the objects to put in the tree
+	/// \return true if the tree was rebuilt, false if it was refitted
+	bool update(const std::vector<Item>& items);
+
+	/// The cost of the tree is the sum of the surface areas of the internal nodes relative to the surface of the
+	/// root, it is proportional to the expected number of nodes visited by a query.
+	/// \return the cost of the tree with its current bounds
+	double getCost() const;
+
+	/// \return the cost of the tree when it was last built
+	double getBuildCost() const;
+
+	/// \return the AABB for the tree
+	const Math::Aabbd& getAabb() const;
+
+	/// \return true if there are no objects in the tree
+	bool isEmpty() const;
+
+	/// \return the number of objects in the tree
+	size_t getNumObjects() const;
+
+	/// \return the number of nodes in the tree, the root has the index 0
+	size_t getNumNodes() const;
+
+	/// \param node index of the node
+	/// \return true if the node does not have any children
+	bool isLeaf(size_t node) const;
+
+	/// \param node index of an internal node
+	/// \return the index of the first child
+	size_t getFirstChild(size_t node) const;
+
+	/// \param node index of an internal node
+	/// \return the index of the second child
+	size_t getSecondChild(size_t node) const;
+
+	/// \param node index of the node
+	/// \return the bounding box of the node
+	Math::Aabbd getNodeAabb(size_t node) const;
+
+	/// \param node index of a leaf node
+	/// \return the ids of the objects in the node
+	std::vector<size_t> getNodeObjects(size_t node) const;
+
+	/// Fetch the objects of a leaf node that have AABBs intersecting with the given AABB
+	/// \param node index of a leaf node
+	/// \param aabb the bounding box for the query
+	/// \param [out] result the ids of the intersecting objects are appended to this vector
+	void getNodeIntersections(size_t node, const Math::Aabbd& aabb, std::vector<size_t>* result) const;
+
+	/// Fetch the pairs of objects of two leaf nodes that have intersecting AABBs
+	/// \param node index of a leaf node of this tree
+	/// \param otherTree the tree otherNode belongs to
+	/// \param otherNode index of a leaf node of otherTree
+	/// \param [out] result the pairs of ids of the intersecting objects are appended to this vector, the first id of
+	/// 	each pair belongs to this tree, the second one to otherTree
+	void getNodeIntersections(size_t node, const FlatAabbTree& otherTree, size_t otherNode,
+							  std::vector<std::pair<size_t, size_t>>* result) const;
+
+	/// Fetch all the objects that have AABBs intersecting with the given AABB
+	/// \param aabb the bounding box for the query
+	/// \param [out] result the ids of the intersecting objects are appended to this vector
+	void getIntersections(const Math::Aabbd& aabb, std::vector<size_t>* result) const;
+
+	/// Type indicating a relationship between two leaf nodes, by their indices
+	typedef std::pair<size_t, size_t> NodePairType;
+
+	/// Type indicating a relationship between two objects, by their ids
+	typedef std::pair<size_t, size_t> ObjectPairType;
+
+	/// Query to find all pairs of intersecting leaf nodes between two trees.
+	/// \param otherTree the other tree to compare against
+	/// \param [out] result the pairs of intersecting leaf nodes are appended to this vector, the first node of each
+	/// 	pair belongs to this tree, the second one to otherTree
+	void spatialJoin(const FlatAabbTree& otherTree, std::vector<NodePairType>* result) const;
+
+	/// Query to find all pairs of objects with intersecting AABBs between two trees.
+	/// The traversal uses a fixed size stack, memory is only allocated when the result needs to grow, reusing
+	/// the same vector from one query to the next avoids any allocation.
+	/// \param otherTree the other tree to compare against
+	/// \param [out] result the pairs of ids of the intersecting objects are appended to this vector, the first id of
+	/// 	each pair belongs to this tree, the second one to otherTree
+	void getIntersections(const FlatAabbTree& otherTree, std::vector<ObjectPairType>* result) const;
+
+	/// Query to find all pairs of objects with intersecting AABBs between two trees, the work is split across the
+	/// threads of the runtime's thread pool. Worth it for large trees only.
+	/// \param otherTree the other tree to compare against
+	/// \param [out] result the pairs of ids of the intersecting objects are appended to this vector, in the same
+	/// 	order for every call with the same trees
+	void getIntersectionsParallel(const FlatAabbTree& otherTree, std::vector<ObjectPairType>* result) const;
+
+	/// Default estimated cost, in number of objects, above which forEachIntersectionParallel() splits the work
+	static const size_t DefaultParallelCostThreshold = 4096;
+
+	/// Call a function for all pairs of objects with intersecting AABBs between two trees, possibly splitting the
+	/// work across the threads of the runtime's thread pool.
+	/// The top levels of the trees are expanded into independent node pairs (tasks), run in parallel, each task
+	/// collects its results separately, so merging the results in order gives a deterministic output. When the
+	/// estimated cost does not exceed the given threshold, the trees are not worth splitting: they are traversed
+	/// on the calling thread as in forEachIntersection(), with a single result. Trees with fewer objects in total
+	/// than the threshold are traversed that way without estimating the cost.
+	/// \tparam Result type of the result of a task
+	/// \tparam Function callable with the signature void(size_t id, size_t otherId, Result* result), may be called
+	/// 	concurrently for different tasks
+	/// \param otherTree the other tree to compare against
+	/// \param [out] results the results of the tasks, in order, resized to the number of tasks (1 when the trees
+	/// 	are traversed on the calling thread, 0 when one of the trees is empty)
+	/// \param function the function to call with the ids of each pair of intersecting objects and the result of
+	/// 	the task the pair belongs to
+	/// \param costThreshold the estimated cost, in number of objects to traverse, above which the tasks are run in
+	/// 	parallel, 0 runs them in parallel as soon as the trees overlap
+	template <class Result, class Function>
+	void forEachIntersectionParallel(const FlatAabbTree& otherTree, std::vector<Result>* results, Function function,
+									 size_t costThreshold = DefaultParallelCostThreshold) const;
+
+	/// Call a function for all pairs of objects with intersecting AABBs between two trees, does not allocate
+	/// any memory.
+	/// \tparam Function callable with the signature void(size_t id, size_t otherId)
+	/// \param otherTree the other tree to compare against
+	/// \param function the function to call with the ids of each pair of intersecting objects, the first id belongs
+	/// 	to this tree, the second one to otherTree
+	template <class Function>
+	void forEachIntersection(const FlatAabbTree& otherTree, Function function) const;
+
+	/// Call a function for all pairs of distinct objects of this tree with intersecting AABBs, does not allocate
+	/// any memory. Unlike an intersection of the tree with itself, the symmetric node pairs are skipped during the
+	/// traversal: each pair of objects is reported once, in an unspecified order, and an object is never paired
+	/// with itself.
+	/// \tparam Function callable with the signature void(size_t id, size_t otherId)
+	/// \param function the function to call with the ids of each pair of intersecting objects
+	template <class Function>
+	void forEachSelfIntersection(Function function) const;
+
+private:
+	/// Topology of a node
+	struct Node
+	{
+		/// Index of the second child, the first child directly follows the node
+		size_t secondChild;
+		/// Index of the first object of a leaf node
+		size_t firstObject;
+		/// Number of objects of a leaf node, 0 for internal nodes
+		size_t numObjects;
+		/// Number of objects in the subtree of the node
+		size_t numSubtreeObjects;
+	};
+
+	/// Bounds stored as a structure of arrays, one row per node or per object
+	typedef Eigen::Matrix<double, Eigen::Dynamic, 3> Bounds;
+
+	/// Size of the stack used by the traversals, bounds the sum of the depths of the trees
+	static const size_t MaxStackSize = 128;
+
+	/// \return true if the box at row i of (minA, maxA) overlaps the box at row j of (minB, maxB)
+	template <class BoundsA, class BoundsB>
+	static bool doIntersect(const BoundsA& minA, const BoundsA& maxA, size_t i,
+							const BoundsB& minB, const BoundsB& maxB, size_t j);
+
+	/// Traverse both trees simultaneously, from a given pair of nodes, using an explicit stack
+	/// \tparam Function callable with the signature void(size_t node, size_t otherNode)
+	/// \param otherTree the other tree
+	/// \param node the node of this tree to start from
+	/// \param otherNode the node of the other tree to start from
+	/// \param function the function to call for each pair of intersecting leaf nodes
+	template <class Function>
+	void forEachNodeIntersection(const FlatAabbTree& otherTree, size_t node, size_t otherNode,
+								 Function function) const;
+
+	/// Call a function for all the pairs of objects with intersecting AABBs between two leaf nodes
+	/// \tparam Function callable with the signature void(size_t id, size_t otherId)
+	/// \param node the leaf node of this tree
+	/// \param otherTree the other tree
+	/// \param otherNode the leaf node of the other tree
+	/// \param function the function to call for each pair of intersecting objects
+	template <class Function>
+	void forEachObjectIntersection(size_t node, const FlatAabbTree& otherTree, size_t otherNode,
+								   Function function) const;
+
+	/// Expand the top levels of both trees into independent pairs of nodes, the pairs of intersecting objects
+	/// between the trees are the union of the ones of the node pairs.
+	/// \param otherTree the other tree
+	/// \param minNumTasks the number of node pairs to reach, if the trees are deep enough
+	/// \param [out] tasks the node pairs, in a deterministic order
+	/// \return the estimated cost of traversing all the node pairs, in number of objects
+	size_t splitIntersections(const FlatAabbTree& otherTree, size_t minNumTasks,
+							  std::vector<NodePairType>* tasks) const;
+
+	/// Recursively create the topology for a range of objects, splits at the median along the longest axis
+	/// of the centers of the objects
+	/// \param centers the centers of the items' bounding boxes
+	/// \param begin, end the range of items in m_itemOrder for this node
+	/// \param depth the depth of the node, the root has a depth of 1
+	/// \return the index of the node
+	size_t buildNode(const std::vector<Math::Vector3d>& centers, size_t begin, size_t end, size_t depth);
+
+	/// Compute the bounds of all the nodes from the bounds of the objects, and the cost of the tree
+	void refitNodes();
+
+	/// Maximum number of objects in a leaf node
+	size_t m_maxObjectsPerNode;
+
+	/// Cost ratio that triggers a rebuild in update()
+	double m_rebuildThreshold;
+
+	/// The nodes, in depth first order
+	std::vector<Node> m_nodes;
+
+	/// The number of levels of the tree
+	size_t m_depth;
+
+	///@{
+	/// The bounds of the nodes
+	Bounds m_nodeMin;
+	Bounds m_nodeMax;
+	///@}
+
+	/// The ids of the objects, sorted by leaf node
+	std::vector<size_t> m_objectIds;
+
+	///@{
+	/// The bounds of the objects, sorted by leaf node
+	Bounds m_objectMin;
+	Bounds m_objectMax;
+	///@}
+
+	/// The ids of the items in the order they were given to build()
+	std::vector<size_t> m_itemIds;
+
+	/// For each item given to build(), the position of the object in the leaf order
+	std::vector<size_t> m_itemSlots;
+
+	/// During build, the items in the leaf order
+	std::vector<size_t> m_itemOrder;
+
+	/// The bounding box of the root
+	Math::Aabbd m_aabb;
+
+	/// The cost of the tree with its current bounds
+	double m_cost;
+
+	/// The cost of the tree after the last build
+	double m_buildCost;
+};
+
+}; // namespace DataStructures
+}; // namespace SurgSim
+
+#include "SurgSim/DataStructures/FlatAabbTree-inl.h"
+
+#endif // SURGSIM_DATASTRUCTURES_FLATAABBTREE_H
@@ -0,0 +1,207 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SURGSIM_DATASTRUCTURES_FLATOCTREE_INL_H
+#define SURGSIM_DATASTRUCTURES_FLATOCTREE_INL_H
+
+#include <algorithm>
+
+#include "SurgSim/Framework/Assert.h"
+
+namespace SurgSim
+{
+namespace DataStructures
+{
+
+template <class Data>
+FlatOctree<Data>::FlatOctree() :
+	m_depth(0)
+{
+}
+
+template <class Data>
+FlatOctree<Data>::FlatOctree(std::shared_ptr<OctreeNode<Data>> root) :
+	m_depth(0)
+{
+	build(root);
+}
+
+template <class Data>
+void FlatOctree<Data>::build(std::shared_ptr<OctreeNode<Data>> root)
+{
+	m_root = root;
+	m_nodes.clear();
+	m_active.clear();
+	m_depth = 0;
+	if (root == nullptr)
+	{
+		m_centers.resize(0, 3);
+		m_halfSizes.resize(0, 3);
+		return;
+	}
+
+	// The original nodes, only used while building
+	std::vector<const OctreeNode<Data>*> originalNodes;
+
+	Node rootNode = {0, 0, 0, 0};
+	m_nodes.push_back(rootNode);
+	originalNodes.push_back(root.get());
+
+	// The nodes vector doubles as the queue of the breadth first traversal
+	for (size_t index = 0; index < m_nodes.size(); ++index)
+	{
+		const OctreeNode<Data>* original = originalNodes[index];
+		m_nodes[index].firstChild = m_nodes.size();
+		if (original->hasChildren())
+		{
+			const auto& children = original->getChildren();
+			for (size_t i = 0; i < children.size(); ++i)
+			{
+				if (children[i] != nullptr)
+				{
+					Node child = {0, index, 0, static_cast<unsigned char>(i)};
+					m_nodes.push_back(child);
+					originalNodes.push_back(children[i].get());
+					++m_nodes[index].numChildren;
+				}
+			}
+		}
+	}
+
+	// Breadth first, the last node is on the deepest level
+	for (size_t node = m_nodes.size() - 1; node != 0; node = m_nodes[node].parent)
+	{
+		++m_depth;
+	}
+
+	m_centers.resize(m_nodes.size(), 3);
+	m_halfSizes.resize(m_nodes.size(), 3);
+	m_active.resize(m_nodes.size());
+	for (size_t index = 0; index < m_nodes.size(); ++index)
+	{
+		const Math::Aabbd& boundingBox = originalNodes[index]->getBoundingBox();
+		m_centers.row(index) = boundingBox.center().transpose();
+		m_halfSizes.row(index) = 0.5 * boundingBox.sizes().transpose();
+		m_active[index] = originalNodes[index]->isActive() ? 1 : 0;
+	}
+}
+
+template <class Data>
+std::shared_ptr<OctreeNode<Data>> FlatOctree<Data>::getRoot() const
+{
+	return m_root;
+}
+
+template <class Data>
+bool FlatOctree<Data>::isEmpty() const
+{
+	return m_nodes.empty();
+}
+
+template <class Data>
+size_t FlatOctree<Data>::getNumNodes() const
+{
+	return m_nodes.size();
+}
+
+template <class Data>
+size_t FlatOctree<Data>::getDepth() const
+{
+	return m_depth;
+}
+
+template <class Data>
+bool FlatOctree<Data>::isActive(size_t node) const
+{
+	return m_active[node] != 0;
+}
+
+template <class Data>
+bool FlatOctree<Data>::hasChildren(size_t node) const
+{
+	return m_nodes[node].numChildren > 0;
+}
+
+template <class Data>
+size_t FlatOctree<Data>::getFirstChild(size_t node) const
+{
+	return m_nodes[node].firstChild;
+}
+
+template <class Data>
+size_t FlatOctree<Data>::getNumChildren(size_t node) const
+{
+	return m_nodes[node].numChildren;
+}
+
+template <class Data>
+size_t FlatOctree<Data>::getParent(size_t node) const
+{
+	SURGSIM_ASSERT(node != 0) << "The root does not have a parent.";
+	return m_nodes[node].parent;
+}
+
+template <class Data>
+size_t FlatOctree<Data>::getChildIndex(size_t node) const
+{
+	SURGSIM_ASSERT(node != 0) << "The root is not the child of any node.";
+	return m_nodes[node].childIndex;
+}
+
+template <class Data>
+Math::Vector3d FlatOctree<Data>::getCenter(size_t node) const
+{
+	return m_centers.row(node).transpose();
+}
+
+template <class Data>
+Math::Vector3d FlatOctree<Data>::getHalfSizes(size_t node) const
+{
+	return m_halfSizes.row(node).transpose();
+}
+
+template <class Data>
+Math::Aabbd FlatOctree<Data>::getBoundingBox(size_t node) const
+{
+	return Math::Aabbd(getCenter(node) - getHalfSizes(node), getCenter(node) + getHalfSizes(node));
+}
+
+template <class Data>
+void FlatOctree<Data>::getPath(size_t node, OctreePath* path) const
+{
+	path->clear();
+	for (; node != 0; node = m_nodes[node].parent)
+	{
+		path->push_back(m_nodes[node].childIndex);
+	}
+	std::reverse(path->begin(), path->end());
+}
+
+template <class Data>
+const typename FlatOctree<Data>::Bounds& FlatOctree<Data>::getCenters() const
+{
+	return m_centers;
+}
+
+template <class Data>
+const typename FlatOctree<Data>::Bounds& FlatOctree<Data>::getHalfSizes() const
+{
+	return m_halfSizes;
+}
+
+};  // namespace DataStructures
+};  // namespace SurgSim
+
+#endif // SURGSIM_DATASTRUCTURES_FLATOCTREE_INL_H
@@ -0,0 +1,152 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SURGSIM_DATASTRUCTURES_FLATOCTREE_H
+#define SURGSIM_DATASTRUCTURES_FLATOCTREE_H
+
+#include <memory>
+#include <vector>
+
+#include "SurgSim/DataStructures/OctreeNode.h"
+#include "SurgSim/Math/Aabb.h"
+#include "SurgSim/Math/Vector.h"
+
+namespace SurgSim
+{
+namespace DataStructures
+{
+
+/// Linearized copy of the topology, the bounds and the active flags of an octree, for fast traversals.
+/// The nodes are stored breadth first, the children of a node are stored next to each other in the order of their
+/// index in the parent (i.e. Morton order), so every level of the tree is sorted along the Morton curve. The nodes
+/// are addressed by index, the root has the index 0, and the bounds and active flags are kept as a structure of
+/// arrays, the traversals never go through the original nodes.
+/// Any change of the octree (e.g. subdividing a node, or deactivating it) requires a rebuild.
+/// \tparam Data Type of extra data stored in each node of the original octree
+template <class Data>
+class FlatOctree
+{
+public:
+	/// Constructor, the tree is empty
+	FlatOctree();
+
+	/// Constructor
+	/// \param root the root of the octree to linearize
+	explicit FlatOctree(std::shared_ptr<OctreeNode<Data>> root);
+
+	/// Linearize an octree, all the previous information will be deleted
+	/// \param root the root of the octree to linearize, nullptr empties the tree
+	void build(std::shared_ptr<OctreeNode<Data>> root);
+
+	/// \return the root of the octree this was built from
+	std::shared_ptr<OctreeNode<Data>> getRoot() const;
+
+	/// \return true if there are no nodes in the tree
+	bool isEmpty() const;
+
+	/// \return the number of nodes in the tree
+	size_t getNumNodes() const;
+
+	/// \return the number of levels below the root, 0 for a tree that is only a root (or empty)
+	size_t getDepth() const;
+
+	/// \param node index of the node
+	/// \return true if the original node was active when the tree was built
+	bool isActive(size_t node) const;
+
+	/// \param node index of the node
+	/// \return true if the node has any children
+	bool hasChildren(size_t node) const;
+
+	/// \param node index of the node
+	/// \return the index of the first child, the other children follow it
+	size_t getFirstChild(size_t node) const;
+
+	/// \param node index of the node
+	/// \return the number of children of the node, empty slots of the original node are skipped
+	size_t getNumChildren(size_t node) const;
+
+	/// \param node index of any node but the root
+	/// \return the index of the parent node
+	size_t getParent(size_t node) const;
+
+	/// \param node index of any node but the root
+	/// \return the index of the node in the children of its parent, from 0 to 7
+	size_t getChildIndex(size_t node) const;
+
+	/// \param node index of the node
+	/// \return the center of the bounding box of the node
+	Math::Vector3d getCenter(size_t node) const;
+
+	/// \param node index of the node
+	/// \return half of the sizes of the bounding box of the node
+	Math::Vector3d getHalfSizes(size_t node) const;
+
+	/// \param node index of the node
+	/// \return the bounding box of the node
+	Math::Aabbd getBoundingBox(size_t node) const;
+
+	/// \param node index of the node
+	/// \param [out] path the path of the node from the root of the original octree
+	void getPath(size_t node, OctreePath* path) const;
+
+	/// Bounds stored as a structure of arrays, one row per node
+	typedef Eigen::Matrix<double, Eigen::Dynamic, 3> Bounds;
+
+	/// \return the centers of the bounding boxes of all the nodes
+	const Bounds& getCenters() const;
+
+	/// \return half of the sizes of the bounding boxes of all the nodes
+	const Bounds& getHalfSizes() const;
+
+private:
+	/// Topology of a node
+	struct Node
+	{
+		/// Index of the first child
+		size_t firstChild;
+		/// Index of the parent
+		size_t parent;
+		/// Number of children
+		unsigned char numChildren;
+		/// Index of the node in the children of its parent
+		unsigned char childIndex;
+	};
+
+	/// The root of the original octree
+	std::shared_ptr<OctreeNode<Data>> m_root;
+
+	/// The nodes, in breadth first order
+	std::vector<Node> m_nodes;
+
+	/// The number of levels below the root
+	size_t m_depth;
+
+	/// The active flags of the nodes
+	std::vector<unsigned char> m_active;
+
+	/// The centers of the nodes
+	Bounds m_centers;
+
+	/// Half of the sizes of the nodes
+	Bounds m_halfSizes;
+};
+
+};  // namespace DataStructures
+};  // namespace SurgSim
+
+#include "SurgSim/DataStructures/FlatOctree-inl.h"
+
+#endif // SURGSIM_DATASTRUCTURES_FLATOCTREE_H
@@ -0,0 +1,447 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <set>
+
+#include "SurgSim/DataStructures/FlatAabbTree.h"
+#include "SurgSim/DataStructures/TriangleMesh.h"
+#include "SurgSim/Framework/Runtime.h"
+#include "SurgSim/Math/Aabb.h"
+#include "SurgSim/Math/MeshShape.h"
+#include "SurgSim/Math/RigidTransform.h"
+#include "SurgSim/Math/Vector.h"
+
+using SurgSim::Math::Aabbd;
+using SurgSim::Math::Vector3d;
+
+namespace
+{
+
+std::vector<SurgSim::DataStructures::FlatAabbTree::Item> makeItems(
+	const SurgSim::DataStructures::TriangleMeshPlain& mesh)
+{
+	std::vector<SurgSim::DataStructures::FlatAabbTree::Item> items;
+	for (size_t i = 0; i < mesh.getNumTriangles(); ++i)
+	{
+		auto vertices = mesh.getTrianglePositions(i);
+		items.emplace_back(SurgSim::Math::makeAabb(vertices[0], vertices[1], vertices[2]), i);
+	}
+	return items;
+}
+
+/// Check the structure of the tree, every object is referenced exactly once and every node contains its children
+void checkTree(const SurgSim::DataStructures::FlatAabbTree& tree,
+			   const std::vector<SurgSim::DataStructures::FlatAabbTree::Item>& items)
+{
+	std::vector<size_t> objects;
+	for (size_t node = 0; node < tree.getNumNodes(); ++node)
+	{
+		Aabbd aabb = tree.getNodeAabb(node);
+		if (tree.isLeaf(node))
+		{
+			auto nodeObjects = tree.getNodeObjects(node);
+			EXPECT_GE(tree.getMaxObjectsPerNode(), nodeObjects.size());
+			Aabbd expected;
+			for (auto id : nodeObjects)
+			{
+				expected.extend(items[id].first);
+			}
+			EXPECT_TRUE(expected.isApprox(aabb));
+			objects.insert(objects.end(), nodeObjects.begin(), nodeObjects.end());
+		}
+		else
+		{
+			Aabbd expected = tree.getNodeAabb(tree.getFirstChild(node));
+			expected.extend(tree.getNodeAabb(tree.getSecondChild(node)));
+			EXPECT_TRUE(expected.isApprox(aabb));
+		}
+	}
+
+	std::sort(objects.begin(), objects.end());
+	ASSERT_EQ(items.size(), objects.size());
+	for (size_t i = 0; i < objects.size(); ++i)
+	{
+		EXPECT_EQ(i, objects[i]);
+	}
+}
+
+/// Create two sets of small boxes randomly placed in the same volume
+void makeRandomItems(size_t count, std::vector<SurgSim::DataStructures::FlatAabbTree::Item>* itemsA,
+					 std::vector<SurgSim::DataStructures::FlatAabbTree::Item>* itemsB)
+{
+	std::mt19937 generator(1234);
+	std::uniform_real_distribution<double> position(-1.0, 1.0);
+	std::uniform_real_distribution<double> size(0.01, 0.1);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		Vector3d min(position(generator), position(generator), position(generator));
+		itemsA->emplace_back(Aabbd(min, min + Vector3d::Constant(size(generator))), i);
+		min = Vector3d(position(generator), position(generator), position(generator));
+		itemsB->emplace_back(Aabbd(min, min + Vector3d::Constant(size(generator))), i);
+	}
+}
+
+/// \return all the pairs of ids of intersecting items, testing every pair
+std::set<std::pair<size_t, size_t>> bruteForceIntersections(
+	const std::vector<SurgSim::DataStructures::FlatAabbTree::Item>& itemsA,
+	const std::vector<SurgSim::DataStructures::FlatAabbTree::Item>& itemsB)
+{
+	std::set<std::pair<size_t, size_t>> result;
+	for (const auto& itemA : itemsA)
+	{
+		for (const auto& itemB : itemsB)
+		{
+			if (SurgSim::Math::doAabbIntersect(itemA.first, itemB.first))
+			{
+				result.emplace(itemA.second, itemB.second);
+			}
+		}
+	}
+	return result;
+}
+
+}
+
+namespace SurgSim
+{
+namespace DataStructures
+{
+
+TEST(FlatAabbTreeTests, InitTest)
+{
+	ASSERT_NO_THROW({FlatAabbTree tree(3);});
+	ASSERT_ANY_THROW({FlatAabbTree tree(0);});
+
+	FlatAabbTree tree(4);
+	EXPECT_EQ(4u, tree.getMaxObjectsPerNode());
+	EXPECT_TRUE(tree.isEmpty());
+	EXPECT_EQ(0u, tree.getNumNodes());
+	EXPECT_TRUE(tree.getAabb().isEmpty());
+
+	EXPECT_NO_THROW(tree.setRebuildThreshold(2.0));
+	EXPECT_DOUBLE_EQ(2.0, tree.getRebuildThreshold());
+	EXPECT_ANY_THROW(tree.setRebuildThreshold(0.5));
+
+	std::vector<size_t> result;
+	tree.getIntersections(Aabbd(Vector3d::Zero(), Vector3d::Ones()), &result);
+	EXPECT_TRUE(result.empty());
+}
+
+TEST(FlatAabbTreeTests, EasyIntersectionTest)
+{
+	FlatAabbTree tree(3);
+
+	Aabbd bigBox;
+	std::vector<FlatAabbTree::Item> items;
+	for (size_t i = 0; i <= 6; ++i)
+	{
+		Aabbd aabb(Vector3d(static_cast<double>(i) - 0.01, -0.01, -0.01),
+				   Vector3d(static_cast<double>(i) + 0.01, 0.01, 0.01));
+		bigBox.extend(aabb);
+		items.emplace_back(aabb, i);
+	}
+	tree.build(items);
+
+	EXPECT_EQ(7u, tree.getNumObjects());
+	EXPECT_TRUE(bigBox.isApprox(tree.getAabb()));
+	checkTree(tree, items);
+
+	std::vector<size_t> result;
+	tree.getIntersections(bigBox, &result);
+	EXPECT_EQ(7u, result.size());
+
+	result.clear();
+	tree.getIntersections(Aabbd(Vector3d(0.0, -0.02, -0.02), Vector3d(3.4, 0.02, 0.02)), &result);
+	EXPECT_EQ(4u, result.size()) << "Left Box Incorrect";
+
+	result.clear();
+	tree.getIntersections(Aabbd(Vector3d(1.8, -0.02, -0.02), Vector3d(4.4, 0.02, 0.02)), &result);
+	EXPECT_EQ(3u, result.size()) << "Middle Box Incorrect";
+
+	result.clear();
+	tree.getIntersections(Aabbd(Vector3d(2.8, -0.02, -0.02), Vector3d(6.4, 0.02, 0.02)), &result);
+	EXPECT_EQ(4u, result.size()) << "Right Box Incorrect";
+}
+
+TEST(FlatAabbTreeTests, RefitTest)
+{
+	auto runtime = std::make_shared<SurgSim::Framework::Runtime>("config.txt");
+	auto mesh = std::make_shared<TriangleMeshPlain>();
+	mesh->load("Geometry/arm_collision.ply");
+
+	auto items = makeItems(*mesh);
+	FlatAabbTree tree(3);
+	tree.build(items);
+	checkTree(tree, items);
+	size_t numNodes = tree.getNumNodes();
+	EXPECT_DOUBLE_EQ(tree.getBuildCost(), tree.getCost());
+
+	// Small deformation, the tree is refit
+	std::mt19937 generator(1234);
+	std::uniform_real_distribution<double> noise(-0.001, 0.001);
+	for (size_t i = 0; i < mesh->getNumVertices(); ++i)
+	{
+		mesh->setVertexPosition(i, mesh->getVertexPosition(i) + Vector3d(noise(generator), noise(generator),
+								noise(generator)));
+	}
+	items = makeItems(*mesh);
+	EXPECT_FALSE(tree.update(items));
+	EXPECT_EQ(numNodes, tree.getNumNodes());
+	checkTree(tree, items);
+
+	std::vector<size_t> result;
+	tree.getIntersections(tree.getAabb(), &result);
+	EXPECT_EQ(items.size(), result.size());
+
+	// Shuffle the vertices, the refit tree is much worse than a new one
+	std::vector<Vector3d> positions;
+	for (size_t i = 0; i < mesh->getNumVertices(); ++i)
+	{
+		positions.push_back(mesh->getVertexPosition(i));
+	}
+	std::shuffle(positions.begin(), positions.end(), generator);
+	for (size_t i = 0; i < mesh->getNumVertices(); ++i)
+	{
+		mesh->setVertexPosition(i, positions[i]);
+	}
+	items = makeItems(*mesh);
+	EXPECT_TRUE(tree.update(items));
+	checkTree(tree, items);
+	EXPECT_DOUBLE_EQ(tree.getBuildCost(), tree.getCost());
+
+	// Different items, the tree is rebuilt
+	items.pop_back();
+	EXPECT_TRUE(tree.update(items));
+	checkTree(tree, items);
+	EXPECT_ANY_THROW(tree.refit(makeItems(*mesh)));
+}
+
+TEST(FlatAabbTreeTests, SpatialJoinTest)
+{
+	std::vector<FlatAabbTree::Item> itemsA;
+	std::vector<FlatAabbTree::Item> itemsB;
+	makeRandomItems(200, &itemsA, &itemsB);
+
+	FlatAabbTree treeA(3);
+	treeA.build(itemsA);
+	FlatAabbTree treeB(5);
+	treeB.build(itemsB);
+
+	std::vector<FlatAabbTree::NodePairType> nodePairs;
+	treeA.spatialJoin(treeB, &nodePairs);
+
+	std::vector<std::pair<size_t, size_t>> objectPairs;
+	for (const auto& nodePair : nodePairs)
+	{
+		ASSERT_TRUE(treeA.isLeaf(nodePair.first));
+		ASSERT_TRUE(treeB.isLeaf(nodePair.second));
+		treeA.getNodeIntersections(nodePair.first, treeB, nodePair.second, &objectPairs);
+	}
+	std::set<std::pair<size_t, size_t>> pairs(objectPairs.begin(), objectPairs.end());
+	EXPECT_EQ(objectPairs.size(), pairs.size()) << "Object pairs should be reported only once";
+
+	auto expected = bruteForceIntersections(itemsA, itemsB);
+	EXPECT_FALSE(expected.empty());
+	EXPECT_EQ(expected, pairs);
+}
+
+TEST(FlatAabbTreeTests, MeshShapeSpatialJoinTest)
+{
+	auto runtime = std::make_shared<SurgSim::Framework::Runtime>("config.txt");
+	const std::string fileName = "Geometry/staple_collision.ply";
+
+	auto meshA = std::make_shared<SurgSim::Math::MeshShape>();
+	ASSERT_NO_THROW(meshA->load(fileName));
+
+	auto meshB = std::make_shared<SurgSim::Math::MeshShape>();
+	ASSERT_NO_THROW(meshB->load(fileName));
+	meshB->transform(SurgSim::Math::makeRigidTranslation(Vector3d(0.005, 0.0, 0.0)));
+
+	// update the AABB trees
+	meshA->update();
+	meshB->update();
+
+	auto treeA = meshA->getFlatAabbTree();
+	auto treeB = meshB->getFlatAabbTree();
+
+	std::vector<FlatAabbTree::NodePairType> nodePairs;
+	treeA->spatialJoin(*treeB, &nodePairs);
+
+	std::vector<std::pair<size_t, size_t>> objectPairs;
+	for (const auto& nodePair : nodePairs)
+	{
+		treeA->getNodeIntersections(nodePair.first, *treeB, nodePair.second, &objectPairs);
+	}
+	std::set<std::pair<size_t, size_t>> pairs(objectPairs.begin(), objectPairs.end());
+
+	std::vector<FlatAabbTree::Item> itemsA;
+	std::vector<FlatAabbTree::Item> itemsB;
+	for (size_t i = 0; i < meshA->getNumTriangles(); ++i)
+	{
+		auto vertices = meshA->getTrianglePositions(i);
+		itemsA.emplace_back(SurgSim::Math::makeAabb(vertices[0], vertices[1], vertices[2]), i);
+		vertices = meshB->getTrianglePositions(i);
+		itemsB.emplace_back(SurgSim::Math::makeAabb(vertices[0], vertices[1], vertices[2]), i);
+	}
+
+	auto expected = bruteForceIntersections(itemsA, itemsB);
+	EXPECT_FALSE(expected.empty());
+	EXPECT_EQ(expected, pairs);
+}
+
+TEST(FlatAabbTreeTests, ObjectIntersectionsTest)
+{
+	std::vector<FlatAabbTree::Item> itemsA;
+	std::vector<FlatAabbTree::Item> itemsB;
+	makeRandomItems(500, &itemsA, &itemsB);
+	auto expected = bruteForceIntersections(itemsA, itemsB);
+	ASSERT_FALSE(expected.empty());
+
+	FlatAabbTree treeA(3);
+	treeA.build(itemsA);
+	FlatAabbTree treeB(5);
+	treeB.build(itemsB);
+	FlatAabbTree emptyTree;
+
+	{
+		SCOPED_TRACE("Stack based traversal");
+		std::vector<FlatAabbTree::ObjectPairType> objectPairs;
+		treeA.getIntersections(treeB, &objectPairs);
+		EXPECT_EQ(expected.size(), objectPairs.size());
+		EXPECT_EQ(expected, std::set<FlatAabbTree::ObjectPairType>(objectPairs.begin(), objectPairs.end()));
+
+		// The result is appended to
+		treeA.getIntersections(treeB, &objectPairs);
+		EXPECT_EQ(2 * expected.size(), objectPairs.size());
+
+		objectPairs.clear();
+		treeA.getIntersections(emptyTree, &objectPairs);
+		emptyTree.getIntersections(treeB, &objectPairs);
+		EXPECT_TRUE(objectPairs.empty());
+	}
+
+	{
+		SCOPED_TRACE("Callback");
+		std::set<FlatAabbTree::ObjectPairType> pairs;
+		size_t count = 0;
+		treeA.forEachIntersection(treeB, [&pairs, &count](size_t a, size_t b)
+		{
+			pairs.emplace(a, b);
+			++count;
+		});
+		EXPECT_EQ(expected.size(), count);
+		EXPECT_EQ(expected, pairs);
+	}
+
+	{
+		SCOPED_TRACE("Parallel traversal");
+		std::vector<FlatAabbTree::ObjectPairType> objectPairs;
+		treeA.getIntersectionsParallel(treeB, &objectPairs);
+		EXPECT_EQ(expected.size(), objectPairs.size());
+		EXPECT_EQ(expected, std::set<FlatAabbTree::ObjectPairType>(objectPairs.begin(), objectPairs.end()));
+
+		std::vector<FlatAabbTree::ObjectPairType> otherObjectPairs;
+		treeA.getIntersectionsParallel(treeB, &otherObjectPairs);
+		EXPECT_EQ(objectPairs, otherObjectPairs) << "The order of the result should not depend on the threads";
+
+		objectPairs.clear();
+		treeA.getIntersectionsParallel(emptyTree, &objectPairs);
+		EXPECT_TRUE(objectPairs.empty());
+	}
+
+	{
+		SCOPED_TRACE("Parallel callback");
+		auto collect = [](size_t a, size_t b, std::vector<FlatAabbTree::ObjectPairType>* result)
+		{
+			result->emplace_back(a, b);
+		};
+
+		// Under the threshold the trees are traversed serially, into a single result
+		std::vector<std::vector<FlatAabbTree::ObjectPairType>> serialResults;
+		treeA.forEachIntersectionParallel(treeB, &serialResults, collect, std::numeric_limits<size_t>::max());
+		ASSERT_EQ(1u, serialResults.size());
+		std::vector<FlatAabbTree::ObjectPairType> objectPairs;
+		treeA.getIntersections(treeB, &objectPairs);
+		EXPECT_EQ(objectPairs, serialResults[0]);
+
+		std::vector<std::vector<FlatAabbTree::ObjectPairType>> parallelResults;
+		treeA.forEachIntersectionParallel(treeB, &parallelResults, collect, 0);
+		EXPECT_LT(1u, parallelResults.size());
+
+		std::set<FlatAabbTree::ObjectPairType> pairs;
+		size_t count = 0;
+		for (const auto& result : parallelResults)
+		{
+			pairs.insert(result.begin(), result.end());
+			count += result.size();
+		}
+		EXPECT_EQ(expected.size(), count);
+		EXPECT_EQ(expected, pairs);
+
+		treeA.forEachIntersectionParallel(emptyTree, &parallelResults, collect);
+		EXPECT_TRUE(parallelResults.empty());
+	}
+}
+TEST(FlatAabbTreeTests, SelfIntersectionsTest)
+{
+	std::vector<FlatAabbTree::Item> items;
+	std::vector<FlatAabbTree::Item> unused;
+	makeRandomItems(1000, &items, &unused);
+
+	std::set<FlatAabbTree::ObjectPairType> expected;
+	for (const auto& pair : bruteForceIntersections(items, items))
+	{
+		if (pair.first < pair.second)
+		{
+			expected.insert(pair);
+		}
+	}
+	ASSERT_FALSE(expected.empty());
+
+	for (size_t maxObjectsPerNode : {1, 3, 8})
+	{
+		SCOPED_TRACE(maxObjectsPerNode);
+		FlatAabbTree tree(maxObjectsPerNode);
+		tree.build(items);
+
+		std::set<FlatAabbTree::ObjectPairType> pairs;
+		size_t count = 0;
+		tree.forEachSelfIntersection([&pairs, &count](size_t a, size_t b)
+		{
+			EXPECT_NE(a, b);
+			pairs.emplace(std::min(a, b), std::max(a, b));
+			++count;
+		});
+		EXPECT_EQ(expected.size(), count) << "Every pair should be reported once";
+		EXPECT_EQ(expected, pairs);
+	}
+
+	FlatAabbTree emptyTree;
+	size_t count = 0;
+	emptyTree.forEachSelfIntersection([&count](size_t a, size_t b)
+	{
+		++count;
+	});
+	EXPECT_EQ(0u, count);
+}
+
+};
+};
@@ -0,0 +1,156 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "SurgSim/DataStructures/EmptyData.h"
+#include "SurgSim/DataStructures/FlatOctree.h"
+#include "SurgSim/DataStructures/OctreeNode.h"
+#include "SurgSim/Framework/Assert.h"
+#include "SurgSim/Math/Vector.h"
+
+using SurgSim::Math::Aabbd;
+using SurgSim::Math::Vector3d;
+
+namespace SurgSim
+{
+namespace DataStructures
+{
+
+typedef OctreeNode<EmptyData> OctreeNodeType;
+
+namespace
+{
+
+/// Check that the flat octree node and the original node describe the same subtree
+void checkNode(const FlatOctree<EmptyData>& flatOctree, size_t node, std::shared_ptr<OctreeNodeType> original,
+			   std::shared_ptr<OctreeNodeType> root)
+{
+	EXPECT_TRUE(original->getBoundingBox().isApprox(flatOctree.getBoundingBox(node)));
+	EXPECT_EQ(original->isActive(), flatOctree.isActive(node));
+	EXPECT_EQ(original->hasChildren(), flatOctree.hasChildren(node));
+
+	OctreePath path;
+	flatOctree.getPath(node, &path);
+	EXPECT_EQ(original, root->getNode(path));
+
+	if (original->hasChildren())
+	{
+		size_t child = flatOctree.getFirstChild(node);
+		for (size_t i = 0; i < 8; ++i)
+		{
+			if (original->getChild(i) != nullptr)
+			{
+				EXPECT_EQ(node, flatOctree.getParent(child));
+				EXPECT_EQ(i, flatOctree.getChildIndex(child));
+				checkNode(flatOctree, child, original->getChild(i), root);
+				++child;
+			}
+		}
+		EXPECT_EQ(flatOctree.getFirstChild(node) + flatOctree.getNumChildren(node), child);
+	}
+}
+
+}
+
+TEST(FlatOctreeTests, InitTest)
+{
+	EXPECT_NO_THROW(FlatOctree<EmptyData> flatOctree);
+
+	FlatOctree<EmptyData> flatOctree;
+	EXPECT_TRUE(flatOctree.isEmpty());
+	EXPECT_EQ(0u, flatOctree.getNumNodes());
+	EXPECT_EQ(0u, flatOctree.getDepth());
+	EXPECT_EQ(nullptr, flatOctree.getRoot());
+}
+
+TEST(FlatOctreeTests, BuildTest)
+{
+	auto root = std::make_shared<OctreeNodeType>(Aabbd(Vector3d::Zero(), Vector3d::Constant(16.0)));
+	root->addData(Vector3d(0.5, 0.5, 0.5), 4);
+	root->addData(Vector3d(8.5, 8.5, 8.5), 4);
+	root->addData(Vector3d(15.5, 0.5, 0.5), 3);
+	// Remove one of the children, the flat octree skips the empty slots
+	root->getChildren()[5] = nullptr;
+
+	FlatOctree<EmptyData> flatOctree(root);
+	EXPECT_FALSE(flatOctree.isEmpty());
+	EXPECT_EQ(root, flatOctree.getRoot());
+	// The root, its 7 remaining children, 3 subdivided children and 2 subdivided grandchildren
+	EXPECT_EQ(1u + 7u + 3u * 8u + 2u * 8u, flatOctree.getNumNodes());
+	EXPECT_EQ(7u, flatOctree.getNumChildren(0));
+	EXPECT_EQ(1u, flatOctree.getFirstChild(0));
+	EXPECT_EQ(3u, flatOctree.getDepth());
+
+	OctreePath path;
+	flatOctree.getPath(0, &path);
+	EXPECT_TRUE(path.empty());
+
+	checkNode(flatOctree, 0, root, root);
+
+	// Breadth first, the nodes of a level are stored after the nodes of the previous level
+	for (size_t node = 2; node < flatOctree.getNumNodes(); ++node)
+	{
+		EXPECT_LE(flatOctree.getParent(node - 1), flatOctree.getParent(node));
+		EXPECT_GE((flatOctree.getHalfSizes(node - 1) - flatOctree.getHalfSizes(node)).minCoeff(), 0.0);
+	}
+
+	EXPECT_THROW(flatOctree.getParent(0), SurgSim::Framework::AssertionFailure);
+	EXPECT_THROW(flatOctree.getChildIndex(0), SurgSim::Framework::AssertionFailure);
+}
+
+TEST(FlatOctreeTests, ActiveTest)
+{
+	auto root = std::make_shared<OctreeNodeType>(Aabbd(Vector3d::Zero(), Vector3d::Constant(4.0)));
+	root->addData(Vector3d(0.5, 0.5, 0.5), 3);
+
+	FlatOctree<EmptyData> flatOctree(root);
+	size_t node = flatOctree.getFirstChild(flatOctree.getFirstChild(0));
+	ASSERT_FALSE(flatOctree.hasChildren(node));
+	EXPECT_TRUE(flatOctree.isActive(node));
+
+	// The active flags are copied, the tree needs to be rebuilt
+	root->getNode(OctreePath(2, 0))->setIsActive(false);
+	EXPECT_TRUE(flatOctree.isActive(node));
+	flatOctree.build(root);
+	EXPECT_FALSE(flatOctree.isActive(node));
+}
+
+TEST(FlatOctreeTests, RebuildTest)
+{
+	auto root = std::make_shared<OctreeNodeType>(Aabbd(Vector3d::Zero(), Vector3d::Constant(4.0)));
+	root->addData(Vector3d(0.5, 0.5, 0.5), 3);
+
+	FlatOctree<EmptyData> flatOctree(root);
+	EXPECT_EQ(17u, flatOctree.getNumNodes());
+
+	root->addData(Vector3d(3.5, 3.5, 3.5), 3);
+	flatOctree.build(root);
+	EXPECT_EQ(25u, flatOctree.getNumNodes());
+	checkNode(flatOctree, 0, root, root);
+
+	flatOctree.build(std::make_shared<OctreeNodeType>(Aabbd(Vector3d::Zero(), Vector3d::Constant(4.0))));
+	EXPECT_EQ(1u, flatOctree.getNumNodes());
+	EXPECT_EQ(0u, flatOctree.getDepth());
+
+	flatOctree.build(nullptr);
+	EXPECT_TRUE(flatOctree.isEmpty());
+	EXPECT_EQ(0u, flatOctree.getDepth());
+}
+
+};  // namespace DataStructures
+};  // namespace SurgSim
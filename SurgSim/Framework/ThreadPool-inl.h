@@ -27,6 +27,12 @@ class ThreadPool::TaskBase
 public:
 	virtual void execute() = 0;
 
+	/// \return The group of the task, nullptr if it does not belong to a group
+	virtual const TaskGroup* getGroup() const
+	{
+		return nullptr;
+	}
+
 	virtual ~TaskBase() {}
 };
 
@@ -58,11 +64,7 @@ std::future<R> ThreadPool::enqueue(std::function<R()> function)
 {
 	std::unique_ptr<Task<R>> task = std::unique_ptr<Task<R>>(new Task<R>(function));
 	std::future<R> future = task->getFuture();
-	{
-		boost::unique_lock<boost::mutex> lock(m_mutex);
-		m_tasks.push(std::move(task));
-	}
-	m_threadSignaler.notify_one();
+	push(std::move(task));
 	return future;
 }
 
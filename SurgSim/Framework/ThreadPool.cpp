@@ -15,6 +15,8 @@
 
 #include "SurgSim/Framework/ThreadPool.h"
 
+#include <algorithm>
+
 
 namespace SurgSim
 {
@@ -22,32 +24,18 @@ namespace Framework
 {
 
 ThreadPool::ThreadPool(size_t numThreads) :
+	m_numQueuedTasks(0),
+	m_numWaitingThreads(0),
 	m_destructing(false)
 {
-	// Main loop for each worker thread.
-	auto threadLoop = [this] ()
+	for (size_t i = 0; i < numThreads + 1; i++)
 	{
-		while (true)
-		{
-			std::unique_ptr<TaskBase> task;
-			{
-				boost::unique_lock<boost::mutex> lock(m_mutex);
-				m_threadSignaler.wait(lock, [this] { return m_destructing || !m_tasks.empty(); });
-				if (m_destructing)
-				{
-					return;
-				}
-
-				task = std::move(m_tasks.front());
-				m_tasks.pop();
-			}
-			task->execute();
-		}
-	};
+		m_queues.emplace_back(new TaskQueue);
+	}
 
 	for (size_t i = 0; i < numThreads; i++)
 	{
-		m_threads.emplace_back(threadLoop);
+		m_threads.emplace_back(&ThreadPool::threadLoop, this, i);
 	}
 }
 
@@ -65,5 +53,256 @@ ThreadPool::~ThreadPool()
 	}
 }
 
+size_t ThreadPool::getNumThreads() const
+{
+	return m_threads.size();
+}
+
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t)>& function)
+{
+	if (begin >= end)
+	{
+		return;
+	}
+
+	grain = std::max(grain, static_cast<size_t>(1));
+	std::atomic<size_t> next(begin);
+	auto work = [&next, end, grain, &function]()
+	{
+		for (size_t first = next.fetch_add(grain); first < end; first = next.fetch_add(grain))
+		{
+			const size_t last = std::min(first + grain, end);
+			for (size_t i = first; i < last; ++i)
+			{
+				function(i);
+			}
+		}
+	};
+
+	// One helper per worker at most, the calling thread does its share
+	const size_t numChunks = (end - begin + grain - 1) / grain;
+	const size_t numHelpers = std::min(numChunks - 1, m_threads.size());
+	TaskGroup group(*this);
+	for (size_t i = 0; i < numHelpers; ++i)
+	{
+		group.run(work);
+	}
+
+	std::exception_ptr exception;
+	try
+	{
+		work();
+	}
+	catch (...)
+	{
+		exception = std::current_exception();
+		next = end;
+	}
+	group.wait();
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
+}
+
+void ThreadPool::threadLoop(size_t index)
+{
+	m_workerIndex.reset(new size_t(index));
+	while (!m_destructing)
+	{
+		std::unique_ptr<TaskBase> task = pop(index);
+		if (task != nullptr)
+		{
+			task->execute();
+			continue;
+		}
+
+		boost::unique_lock<boost::mutex> lock(m_mutex);
+		++m_numWaitingThreads;
+		m_threadSignaler.wait(lock, [this] { return m_destructing || m_numQueuedTasks > 0; });
+		--m_numWaitingThreads;
+	}
+}
+
+void ThreadPool::push(std::unique_ptr<TaskBase> task)
+{
+	// Counted before being queued, so that the counter never goes below the number of queued tasks when the task is
+	// popped right away
+	++m_numQueuedTasks;
+	TaskQueue& queue = *m_queues[getQueueIndex()];
+	{
+		boost::unique_lock<boost::mutex> lock(queue.mutex);
+		queue.tasks.push_back(std::move(task));
+	}
+
+	// Waiting threads check the number of queued tasks while holding m_mutex, taking it here guarantees that the
+	// notification cannot be missed
+	if (m_numWaitingThreads > 0)
+	{
+		{
+			boost::unique_lock<boost::mutex> lock(m_mutex);
+		}
+		m_threadSignaler.notify_one();
+	}
+}
+
+std::unique_ptr<ThreadPool::TaskBase> ThreadPool::pop(size_t index, const TaskGroup* group)
+{
+	std::unique_ptr<TaskBase> task;
+	if (m_numQueuedTasks == 0)
+	{
+		return task;
+	}
+
+	auto isMatching = [group](const std::unique_ptr<TaskBase>& queued)
+	{
+		return group == nullptr || queued->getGroup() == group;
+	};
+
+	// Most recent task of our own queue first, it is the most likely to use data still in the cache
+	{
+		TaskQueue& queue = *m_queues[index];
+		boost::unique_lock<boost::mutex> lock(queue.mutex);
+		auto found = std::find_if(queue.tasks.rbegin(), queue.tasks.rend(), isMatching);
+		if (found != queue.tasks.rend())
+		{
+			task = std::move(*found);
+			queue.tasks.erase(std::next(found).base());
+		}
+	}
+
+	// Then steal the oldest task of another queue
+	for (size_t i = 1; task == nullptr && i < m_queues.size(); ++i)
+	{
+		TaskQueue& queue = *m_queues[(index + i) % m_queues.size()];
+		boost::unique_lock<boost::mutex> lock(queue.mutex);
+		auto found = std::find_if(queue.tasks.begin(), queue.tasks.end(), isMatching);
+		if (found != queue.tasks.end())
+		{
+			task = std::move(*found);
+			queue.tasks.erase(found);
+		}
+	}
+
+	if (task != nullptr)
+	{
+		--m_numQueuedTasks;
+	}
+	return task;
+}
+
+bool ThreadPool::runPendingTask(const TaskGroup* group)
+{
+	std::unique_ptr<TaskBase> task = pop(getQueueIndex(), group);
+	if (task == nullptr)
+	{
+		return false;
+	}
+	task->execute();
+	return true;
+}
+
+size_t ThreadPool::getQueueIndex() const
+{
+	const size_t* index = m_workerIndex.get();
+	return (index != nullptr) ? *index : m_queues.size() - 1;
+}
+
+class TaskGroup::Task : public ThreadPool::TaskBase
+{
+public:
+	Task(TaskGroup* group, std::function<void()> function) :
+		m_group(group),
+		m_function(std::move(function))
+	{
+	}
+
+	void execute() override
+	{
+		--m_group->m_numQueuedTasks;
+		try
+		{
+			m_function();
+		}
+		catch (...)
+		{
+			boost::unique_lock<boost::mutex> lock(m_group->m_exceptionMutex);
+			if (!m_group->m_exception)
+			{
+				m_group->m_exception = std::current_exception();
+			}
+		}
+		// The group may be gone as soon as the counter is decremented, release the function before
+		m_function = nullptr;
+		boost::unique_lock<boost::mutex> lock(m_group->m_pendingTasksMutex);
+		--m_group->m_numPendingTasks;
+		m_group->m_pendingTasksSignaler.notify_all();
+	}
+
+	const TaskGroup* getGroup() const override
+	{
+		return m_group;
+	}
+
+private:
+	TaskGroup* m_group;
+	std::function<void()> m_function;
+};
+
+TaskGroup::TaskGroup(ThreadPool& threadPool) :
+	m_threadPool(threadPool),
+	m_numPendingTasks(0),
+	m_numQueuedTasks(0)
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+	waitForTasks();
+}
+
+void TaskGroup::run(std::function<void()> function)
+{
+	++m_numPendingTasks;
+	++m_numQueuedTasks;
+	m_threadPool.push(std::unique_ptr<ThreadPool::TaskBase>(new Task(this, std::move(function))));
+}
+
+void TaskGroup::wait()
+{
+	waitForTasks();
+
+	std::exception_ptr exception;
+	{
+		boost::unique_lock<boost::mutex> lock(m_exceptionMutex);
+		std::swap(exception, m_exception);
+	}
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
+}
+
+void TaskGroup::waitForTasks()
+{
+	boost::unique_lock<boost::mutex> lock(m_pendingTasksMutex);
+	while (m_numPendingTasks > 0)
+	{
+		// Only the tasks of this group are run, another task could take much longer than the group
+		if (m_numQueuedTasks > 0)
+		{
+			lock.unlock();
+			m_threadPool.runPendingTask(this);
+			lock.lock();
+		}
+		// The remaining tasks are running on other threads, they signal their completion while holding the mutex.
+		// A task they add to the group is queued before they complete, so it is run after the next wake up.
+		else
+		{
+			m_pendingTasksSignaler.wait(lock);
+		}
+	}
+}
+
 };
 };
@@ -18,11 +18,14 @@
 
 #include <atomic>
 #include <boost/thread.hpp>
+#include <boost/thread/tss.hpp>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <future>
 #include <list>
 #include <memory>
-#include <queue>
+#include <vector>
 
 
 namespace SurgSim
@@ -30,13 +33,21 @@ namespace SurgSim
 namespace Framework
 {
 
+class TaskGroup;
+
 /// A thread pool for completing heterogenous tasks
 ///
 /// The thread pool is a class that completes given tasks using a set of worker
-/// threads. These threads pull tasks off of a task queue. Once finished with
-/// the task, the thread gets the next task if one is available, or waits for
-/// another task to be added. The tasks can be heterogenous, meaning any
-/// callable target can be added with any return type.
+/// threads. Each worker thread has its own task queue, tasks added from a worker
+/// go to its own queue and tasks added from any other thread go to a shared queue.
+/// A worker takes the most recent task from its own queue first, then the oldest
+/// task of the shared queue or of the other workers' queues (work stealing), and
+/// waits for another task to be added when all the queues are empty. The tasks
+/// can be heterogenous, meaning any callable target can be added with any return type.
+///
+/// For many small tasks, parallelFor() and TaskGroup avoid the cost of one
+/// std::future per task, threads waiting on these help running the queued tasks
+/// of the group they wait for.
 ///
 /// Example Usage:
 /// \code{.cpp}
@@ -81,7 +92,20 @@ class ThreadPool
 	template <class R>
 	std::future<R> enqueue(std::function<R()> function);
 
+	/// Call a function for every index of a range, blocks until all the calls are done.
+	/// The calling thread takes part in the work, the indices are handed out in chunks of grain indices.
+	/// \param begin, end The range of indices [begin, end)
+	/// \param grain The number of consecutive indices processed by a thread at once
+	/// \param function The function to call for each index, it is called concurrently
+	/// \exception Rethrows the first exception thrown by function, once all the running calls are done
+	void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t)>& function);
+
+	/// \return The number of worker threads
+	size_t getNumThreads() const;
+
 private:
+	friend class TaskGroup;
+
 	/// @{
 	/// Prevent default copy construction and default assignment
 	ThreadPool(const ThreadPool& other);
@@ -95,13 +119,51 @@ class ThreadPool
 	template<class R>
 	class Task;
 
+	/// Tasks queue with its own lock
+	struct TaskQueue
+	{
+		boost::mutex mutex;
+		std::deque<std::unique_ptr<TaskBase>> tasks;
+	};
+
+	/// Main loop of the worker threads
+	/// \param index The index of the worker
+	void threadLoop(size_t index);
+
+	/// Add a task to the queue of the calling worker, or to the shared queue when called from another thread
+	/// \param task The task to add
+	void push(std::unique_ptr<TaskBase> task);
+
+	/// Take a task, looking first in the queue of the given index, then stealing from the other queues
+	/// \param index The index of the queue to look into first
+	/// \param group The group of the task to take, nullptr to take any task
+	/// \return The task, nullptr if none of the queues holds a matching task
+	std::unique_ptr<TaskBase> pop(size_t index, const TaskGroup* group = nullptr);
+
+	/// Run one of the queued tasks of a group on the calling thread, used by threads waiting for the group
+	/// \param group The group of the task to run
+	/// \return true if a task was run, false if none of the queues holds a task of the group
+	bool runPendingTask(const TaskGroup* group);
+
+	/// \return The index of the queue of the calling thread, the shared queue for non worker threads
+	size_t getQueueIndex() const;
+
 	/// The worker threads
 	std::list<boost::thread> m_threads;
 
-	/// Queued tasks waiting for an available thread
-	std::queue<std::unique_ptr<TaskBase>> m_tasks;
+	/// One queue per worker thread, the last one is shared by all the other threads
+	std::vector<std::unique_ptr<TaskQueue>> m_queues;
 
-	/// Mutex for protecting the tasks queue
+	/// The index of the worker owning the calling thread, not set for other threads
+	boost::thread_specific_ptr<size_t> m_workerIndex;
+
+	/// Number of tasks in all the queues
+	std::atomic<size_t> m_numQueuedTasks;
+
+	/// Number of worker threads waiting for tasks
+	std::atomic<size_t> m_numWaitingThreads;
+
+	/// Mutex for waiting on the signaler
 	boost::mutex m_mutex;
 
 	/// Signaler for waking up threads waiting for tasks
@@ -111,6 +173,75 @@ class ThreadPool
 	std::atomic<bool> m_destructing;
 };
 
+/// A group of tasks run by a ThreadPool that can be waited on together
+///
+/// This is lighter than collecting one std::future per task, and the thread waiting for
+/// the group runs the queued tasks of the group instead of blocking, so groups can be
+/// waited on from inside other tasks. Once all the tasks of the group are running on
+/// other threads, the waiting thread blocks until they complete.
+///
+/// Example Usage:
+/// \code{.cpp}
+/// TaskGroup group(*Runtime::getThreadPool());
+/// for (auto& item : items)
+/// {
+///		group.run([&item]() { item->update(); });
+/// }
+/// group.wait();
+/// \endcode
+class TaskGroup
+{
+public:
+	/// Constructor
+	/// \param threadPool The thread pool running the tasks, it needs to outlive the group
+	explicit TaskGroup(ThreadPool& threadPool);
+
+	/// Destructor, waits for the pending tasks, exceptions of the tasks are discarded
+	~TaskGroup();
+
+	/// Queue a task in the thread pool as part of this group
+	/// \param function The task
+	void run(std::function<void()> function);
+
+	/// Wait for all the tasks of the group to complete
+	/// \exception Rethrows the first exception thrown by a task of the group
+	void wait();
+
+private:
+	/// @{
+	/// Prevent default copy construction and default assignment
+	TaskGroup(const TaskGroup& other);
+	TaskGroup& operator=(const TaskGroup& other);
+	/// @}
+
+	/// Task of a group
+	class Task;
+
+	/// Wait for the pending tasks without throwing
+	void waitForTasks();
+
+	/// The thread pool running the tasks
+	ThreadPool& m_threadPool;
+
+	/// Number of tasks that did not complete yet, only decremented while holding m_pendingTasksMutex
+	std::atomic<size_t> m_numPendingTasks;
+
+	/// Number of tasks still waiting in the queues of the thread pool
+	std::atomic<size_t> m_numQueuedTasks;
+
+	/// Mutex for waiting on the completion of the tasks
+	boost::mutex m_pendingTasksMutex;
+
+	/// Signaler for waking up the thread waiting for the group when a task completes
+	boost::condition_variable m_pendingTasksSignaler;
+
+	/// Mutex for protecting the exception
+	boost::mutex m_exceptionMutex;
+
+	/// The first exception thrown by a task of the group
+	std::exception_ptr m_exception;
+};
+
 };
 };
 
@@ -18,6 +18,11 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
 namespace
 {
 
@@ -75,5 +80,121 @@ TEST(ThreadPoolTest, AddLotsOfTasks)
 	EXPECT_EQ(expectedTotal, total);
 }
 
+TEST(ThreadPoolTest, ParallelFor)
+{
+	ThreadPool pool(3);
+	EXPECT_EQ(3u, pool.getNumThreads());
+
+	for (size_t grain : {1, 3, 7, 1000})
+	{
+		std::vector<int> visits(100, 0);
+		pool.parallelFor(10, 100, grain, [&visits](size_t i) { visits[i]++; });
+		for (size_t i = 0; i < visits.size(); ++i)
+		{
+			EXPECT_EQ((i < 10) ? 0 : 1, visits[i]) << "grain " << grain << " index " << i;
+		}
+	}
+
+	// Empty range
+	EXPECT_NO_THROW(pool.parallelFor(5, 5, 1, [](size_t i) { throw std::runtime_error("Should not be called"); }));
+
+	EXPECT_THROW(pool.parallelFor(0, 100, 1, [](size_t i)
+	{
+		if (i == 50)
+		{
+			throw std::runtime_error("Error");
+		}
+	}), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, TaskGroup)
+{
+	ThreadPool pool(2);
+
+	std::atomic<int> total(0);
+	int expectedTotal = 0;
+	{
+		TaskGroup group(pool);
+		for (int i = 0; i < 100; i++)
+		{
+			group.run([&total, i]() { total += i; });
+			expectedTotal += i;
+		}
+		group.wait();
+		EXPECT_EQ(expectedTotal, total);
+
+		// The group can be reused
+		group.run([&total]() { total = 0; });
+		group.wait();
+		EXPECT_EQ(0, total);
+
+		group.run([]() { throw std::runtime_error("Error"); });
+		EXPECT_THROW(group.wait(), std::runtime_error);
+		EXPECT_NO_THROW(group.wait());
+	}
+}
+
+TEST(ThreadPoolTest, NestedTasks)
+{
+	// Waiting threads run the pending tasks, nested groups do not dead lock even with a single worker
+	ThreadPool pool(1);
+
+	std::vector<int> values(20, 0);
+	TaskGroup group(pool);
+	for (size_t i = 0; i < 4; ++i)
+	{
+		group.run([&pool, &values, i]()
+		{
+			pool.parallelFor(i * 5, (i + 1) * 5, 1, [&values](size_t j) { values[j] = static_cast<int>(j); });
+		});
+	}
+	group.wait();
+
+	for (size_t i = 0; i < values.size(); ++i)
+	{
+		EXPECT_EQ(static_cast<int>(i), values[i]);
+	}
+}
+
+TEST(ThreadPoolTest, GroupOnlyRunsItsTasks)
+{
+	// Without workers, the queued tasks only run when a thread waits for them
+	ThreadPool pool(0);
+
+	std::future<int> unrelated = pool.enqueue<int>([]() { return 1; });
+	TaskGroup otherGroup(pool);
+	bool otherGroupDone = false;
+	otherGroup.run([&otherGroupDone]() { otherGroupDone = true; });
+
+	bool done = false;
+	TaskGroup group(pool);
+	group.run([&done]() { done = true; });
+	group.wait();
+	EXPECT_TRUE(done);
+
+	// The tasks that do not belong to the group are left in the queues
+	EXPECT_EQ(std::future_status::timeout, unrelated.wait_for(std::chrono::seconds(0)));
+	EXPECT_FALSE(otherGroupDone);
+
+	otherGroup.wait();
+	EXPECT_TRUE(otherGroupDone);
+	EXPECT_EQ(std::future_status::timeout, unrelated.wait_for(std::chrono::seconds(0)));
+}
+
+TEST(ThreadPoolTest, NoWorkers)
+{
+	// The calling thread does all the work
+	ThreadPool pool(0);
+
+	int total = 0;
+	pool.parallelFor(0, 10, 2, [&total](size_t i) { total += static_cast<int>(i); });
+	EXPECT_EQ(45, total);
+
+	TaskGroup group(pool);
+	group.run([&total]() { total = 0; });
+	group.wait();
+	EXPECT_EQ(0, total);
+}
+
 };
 };
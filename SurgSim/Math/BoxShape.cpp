@@ -139,5 +139,17 @@ bool BoxShape::isValid() const
 	return (m_size.minCoeff() >= 0);
 }
 
+bool BoxShape::isConvex() const
+{
+	return true;
+}
+
+Vector3d BoxShape::getSupport(const Vector3d& direction) const
+{
+	return Vector3d((direction[0] >= 0.0) ? m_size[0] / 2.0 : -m_size[0] / 2.0,
+					(direction[1] >= 0.0) ? m_size[1] / 2.0 : -m_size[1] / 2.0,
+					(direction[2] >= 0.0) ? m_size[2] / 2.0 : -m_size[2] / 2.0);
+}
+
 }; // namespace Math
 }; // namespace SurgSim
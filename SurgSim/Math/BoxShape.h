@@ -83,6 +83,10 @@ class BoxShape: public Shape
 	/// \return True if size along X, Y, Z are bigger than or equal to 0; Otherwise, false.
 	bool isValid() const override;
 
+	bool isConvex() const override;
+
+	Vector3d getSupport(const Vector3d& direction) const override;
+
 protected:
 	// Setters in 'protected' sections are for serialization purpose only.
 
@@ -124,6 +124,23 @@ bool CapsuleShape::isValid() const
 	return (m_length >= 0) && (m_radius >= 0);
 }
 
+bool CapsuleShape::isConvex() const
+{
+	return true;
+}
+
+Vector3d CapsuleShape::getSupport(const Vector3d& direction) const
+{
+	// The segment extremity along the direction, inflated by the radius
+	Vector3d support = (direction[1] >= 0.0) ? topCenter() : bottomCenter();
+	double norm = direction.norm();
+	if (norm > 0.0)
+	{
+		support += direction * (m_radius / norm);
+	}
+	return support;
+}
+
 void CapsuleShape::updateAabb()
 {
 	m_aabb.setEmpty();
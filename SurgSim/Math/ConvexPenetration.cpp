@@ -0,0 +1,453 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SurgSim/Math/ConvexPenetration.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "SurgSim/Framework/Assert.h"
+#include "SurgSim/Math/Geometry.h"
+#include "SurgSim/Math/Shape.h"
+
+namespace
+{
+
+using SurgSim::Math::Geometry::DistanceEpsilon;
+using SurgSim::Math::RigidTransform3d;
+using SurgSim::Math::Shape;
+using SurgSim::Math::Vector3d;
+
+/// Maximum number of iterations of GJK, only reached in degenerate cases
+const size_t MaxGjkIterations = 64;
+
+/// Maximum number of iterations of EPA, reached when the precision cannot be met on curved shapes
+const size_t MaxEpaIterations = 128;
+
+/// A point of the Minkowski difference of the shapes, with the points of each shape it is made of
+struct SupportPoint
+{
+	Vector3d point;
+	Vector3d point1;
+	Vector3d point2;
+};
+
+/// Support function of the Minkowski difference shape1 - shape2, in world coordinates
+class MinkowskiDifference
+{
+public:
+	MinkowskiDifference(const Shape& shape1, const RigidTransform3d& pose1,
+						const Shape& shape2, const RigidTransform3d& pose2) :
+		m_shape1(shape1), m_pose1(pose1), m_shape2(shape2), m_pose2(pose2)
+	{
+	}
+
+	SupportPoint getSupport(const Vector3d& direction) const
+	{
+		SupportPoint result;
+		result.point1 = m_pose1 * m_shape1.getSupport(m_pose1.linear().transpose() * direction);
+		result.point2 = m_pose2 * m_shape2.getSupport(m_pose2.linear().transpose() * -direction);
+		result.point = result.point1 - result.point2;
+		return result;
+	}
+
+private:
+	const Shape& m_shape1;
+	const RigidTransform3d& m_pose1;
+	const Shape& m_shape2;
+	const RigidTransform3d& m_pose2;
+};
+
+/// The simplex of GJK, the last point added is always at the end
+struct Simplex
+{
+	std::array<SupportPoint, 4> points;
+	size_t size;
+};
+
+/// Reduce a segment [b, a] to the feature closest to the origin and find the next search direction
+/// \return true if the origin is on the segment
+bool updateSegment(Simplex* simplex, Vector3d* direction)
+{
+	const Vector3d a = simplex->points[1].point;
+	const Vector3d ab = simplex->points[0].point - a;
+	if (ab.dot(-a) > 0.0)
+	{
+		*direction = ab.cross(-a).cross(ab);
+		return direction->norm() <= DistanceEpsilon * ab.squaredNorm();
+	}
+
+	simplex->points[0] = simplex->points[1];
+	simplex->size = 1;
+	*direction = -a;
+	return direction->squaredNorm() == 0.0;
+}
+
+/// Reduce a triangle [c, b, a] to the feature closest to the origin and find the next search direction
+/// \return true if the origin is in the triangle
+bool updateTriangle(Simplex* simplex, Vector3d* direction)
+{
+	const Vector3d a = simplex->points[2].point;
+	const Vector3d ab = simplex->points[1].point - a;
+	const Vector3d ac = simplex->points[0].point - a;
+	const Vector3d abc = ab.cross(ac);
+
+	if (abc.cross(ac).dot(-a) > 0.0)
+	{
+		if (ac.dot(-a) > 0.0)
+		{
+			// Segment [c, a]
+			simplex->points[1] = simplex->points[2];
+			simplex->size = 2;
+			*direction = ac.cross(-a).cross(ac);
+			return direction->norm() <= DistanceEpsilon * ac.squaredNorm();
+		}
+		simplex->points[0] = simplex->points[1];
+		simplex->points[1] = simplex->points[2];
+		simplex->size = 2;
+		return updateSegment(simplex, direction);
+	}
+
+	if (ab.cross(abc).dot(-a) > 0.0)
+	{
+		simplex->points[0] = simplex->points[1];
+		simplex->points[1] = simplex->points[2];
+		simplex->size = 2;
+		return updateSegment(simplex, direction);
+	}
+
+	const double side = abc.dot(-a);
+	if (std::abs(side) <= DistanceEpsilon * abc.norm())
+	{
+		return true;
+	}
+	*direction = (side > 0.0) ? abc : (-abc).eval();
+	return false;
+}
+
+/// Reduce a tetrahedron [d, c, b, a] to the feature closest to the origin and find the next search direction
+/// \return true if the origin is in the tetrahedron
+bool updateTetrahedron(Simplex* simplex, Vector3d* direction)
+{
+	const SupportPoint a = simplex->points[3];
+	const std::array<std::array<size_t, 3>, 3> faces = {{{{2, 1, 0}}, {{1, 0, 2}}, {{0, 2, 1}}}};
+	for (const auto& face : faces)
+	{
+		const SupportPoint b = simplex->points[face[0]];
+		const SupportPoint c = simplex->points[face[1]];
+		const Vector3d opposite = simplex->points[face[2]].point;
+		Vector3d normal = (b.point - a.point).cross(c.point - a.point);
+		if (normal.dot(opposite - a.point) > 0.0)
+		{
+			normal = -normal;
+		}
+		if (normal.dot(-a.point) > DistanceEpsilon * normal.norm())
+		{
+			// The origin is outside of the face [a, b, c]
+			simplex->points[0] = c;
+			simplex->points[1] = b;
+			simplex->points[2] = a;
+			simplex->size = 3;
+			return updateTriangle(simplex, direction);
+		}
+	}
+	return true;
+}
+
+/// Add the last point to the simplex and reduce it to the feature closest to the origin
+/// \return true if the origin is in the simplex
+bool updateSimplex(Simplex* simplex, Vector3d* direction)
+{
+	switch (simplex->size)
+	{
+	case 2:
+		return updateSegment(simplex, direction);
+	case 3:
+		return updateTriangle(simplex, direction);
+	case 4:
+		return updateTetrahedron(simplex, direction);
+	default:
+		SURGSIM_FAILURE() << "Invalid simplex size " << simplex->size;
+		return false;
+	}
+}
+
+/// When GJK ends on a simplex that is not a tetrahedron, the origin lies on the boundary of the simplex. Add
+/// points of the Minkowski difference around it to start EPA from a tetrahedron.
+/// \return false if the Minkowski difference is flat and no tetrahedron can be built
+bool completeTetrahedron(const MinkowskiDifference& minkowski, std::vector<SupportPoint>* vertices)
+{
+	if (vertices->size() == 1)
+	{
+		const std::array<Vector3d, 6> directions = {{Vector3d::UnitX(), -Vector3d::UnitX(), Vector3d::UnitY(),
+				-Vector3d::UnitY(), Vector3d::UnitZ(), -Vector3d::UnitZ()
+			}
+		};
+		for (const auto& direction : directions)
+		{
+			SupportPoint support = minkowski.getSupport(direction);
+			if ((support.point - vertices->front().point).norm() > DistanceEpsilon)
+			{
+				vertices->push_back(support);
+				break;
+			}
+		}
+		if (vertices->size() == 1)
+		{
+			return false;
+		}
+	}
+
+	if (vertices->size() == 2)
+	{
+		const Vector3d line = ((*vertices)[1].point - (*vertices)[0].point).normalized();
+		Eigen::Index axis;
+		line.cwiseAbs().minCoeff(&axis);
+		const Vector3d start = line.cross(Vector3d::Unit(axis));
+		for (size_t i = 0; i < 6; ++i)
+		{
+			const Vector3d direction = Eigen::AngleAxisd(M_PI / 3.0 * i, line) * start;
+			SupportPoint support = minkowski.getSupport(direction);
+			const Vector3d offset = support.point - (*vertices)[0].point;
+			if ((offset - offset.dot(line) * line).norm() > DistanceEpsilon)
+			{
+				vertices->push_back(support);
+				break;
+			}
+		}
+		if (vertices->size() == 2)
+		{
+			return false;
+		}
+	}
+
+	if (vertices->size() == 3)
+	{
+		const Vector3d& origin = (*vertices)[0].point;
+		const Vector3d normal = ((*vertices)[1].point - origin).cross((*vertices)[2].point - origin).normalized();
+		for (double sign : {1.0, -1.0})
+		{
+			SupportPoint support = minkowski.getSupport(sign * normal);
+			if (std::abs((support.point - origin).dot(normal)) > DistanceEpsilon)
+			{
+				vertices->push_back(support);
+				break;
+			}
+		}
+		if (vertices->size() == 3)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/// A face of the polytope expanded by EPA, its vertices are counter clockwise around the outward normal
+struct Face
+{
+	std::array<size_t, 3> vertices;
+	Vector3d normal;
+	double distance;
+};
+
+/// Create a face of the polytope
+/// \return false if the face is degenerate
+bool makeFace(const std::vector<SupportPoint>& vertices, size_t a, size_t b, size_t c, Face* face)
+{
+	face->vertices = {{a, b, c}};
+	face->normal = (vertices[b].point - vertices[a].point).cross(vertices[c].point - vertices[a].point);
+	const double norm = face->normal.norm();
+	if (norm <= DistanceEpsilon * DistanceEpsilon)
+	{
+		return false;
+	}
+	face->normal /= norm;
+	face->distance = face->normal.dot(vertices[a].point);
+	return true;
+}
+
+}
+
+namespace SurgSim
+{
+namespace Math
+{
+
+bool calculateConvexPenetration(const Shape& shape1, const RigidTransform3d& pose1,
+								const Shape& shape2, const RigidTransform3d& pose2,
+								Vector3d* searchDirection,
+								Vector3d* normal, double* depth, Vector3d* point1, Vector3d* point2)
+{
+	SURGSIM_ASSERT(shape1.isConvex() && shape2.isConvex()) << "The shapes need to be convex, got "
+			<< shape1.getClassName() << " and " << shape2.getClassName();
+
+	MinkowskiDifference minkowski(shape1, pose1, shape2, pose2);
+
+	// GJK, search for a simplex of the Minkowski difference that contains the origin
+	Vector3d direction = *searchDirection;
+	if (direction.squaredNorm() == 0.0)
+	{
+		direction = pose2.translation() - pose1.translation();
+		if (direction.squaredNorm() == 0.0)
+		{
+			direction = Vector3d::UnitX();
+		}
+	}
+
+	Simplex simplex;
+	simplex.points[0] = minkowski.getSupport(direction);
+	simplex.size = 1;
+	direction = -simplex.points[0].point;
+
+	bool containsOrigin = (direction.squaredNorm() == 0.0);
+	for (size_t iteration = 0; iteration < MaxGjkIterations && !containsOrigin; ++iteration)
+	{
+		SupportPoint support = minkowski.getSupport(direction);
+		if (support.point.dot(direction) <= 0.0)
+		{
+			// The origin is beyond the support plane, the direction separates the shapes
+			*searchDirection = direction;
+			return false;
+		}
+		simplex.points[simplex.size++] = support;
+		containsOrigin = updateSimplex(&simplex, &direction);
+	}
+	if (!containsOrigin)
+	{
+		*searchDirection = direction;
+		return false;
+	}
+
+	// EPA, expand the simplex into a polytope until its face closest to the origin is on the boundary of the
+	// Minkowski difference
+	std::vector<SupportPoint> vertices(simplex.points.begin(), simplex.points.begin() + simplex.size);
+	if (!completeTetrahedron(minkowski, &vertices))
+	{
+		return false;
+	}
+
+	std::vector<Face> faces(4);
+	const std::array<std::array<size_t, 3>, 4> tetrahedron = {{{{0, 1, 2}}, {{0, 3, 1}}, {{0, 2, 3}}, {{1, 3, 2}}}};
+	const Vector3d center = 0.25 * (vertices[0].point + vertices[1].point + vertices[2].point + vertices[3].point);
+	for (size_t i = 0; i < 4; ++i)
+	{
+		size_t a = tetrahedron[i][0];
+		size_t b = tetrahedron[i][1];
+		size_t c = tetrahedron[i][2];
+		if ((vertices[b].point - vertices[a].point).cross(vertices[c].point - vertices[a].point).dot(
+				vertices[a].point - center) < 0.0)
+		{
+			std::swap(b, c);
+		}
+		if (!makeFace(vertices, a, b, c, &faces[i]))
+		{
+			return false;
+		}
+	}
+
+	Face closest = faces[0];
+	std::vector<std::pair<size_t, size_t>> horizon;
+	for (size_t iteration = 0; iteration < MaxEpaIterations; ++iteration)
+	{
+		closest = *std::min_element(faces.begin(), faces.end(), [](const Face& face1, const Face& face2)
+		{
+			return face1.distance < face2.distance;
+		});
+
+		SupportPoint support = minkowski.getSupport(closest.normal);
+		if (support.point.dot(closest.normal) - closest.distance <=
+			ConvexPenetrationRelativePrecision * std::abs(closest.distance) + DistanceEpsilon)
+		{
+			break;
+		}
+
+		// Remove the faces that can see the new vertex, and close the hole with faces around the new vertex
+		const size_t newVertex = vertices.size();
+		vertices.push_back(support);
+		horizon.clear();
+		auto isVisible = [&vertices, &support](const Face& face)
+		{
+			return face.normal.dot(support.point - vertices[face.vertices[0]].point) > DistanceEpsilon;
+		};
+		for (const auto& face : faces)
+		{
+			if (isVisible(face))
+			{
+				for (size_t i = 0; i < 3; ++i)
+				{
+					std::pair<size_t, size_t> edge(face.vertices[i], face.vertices[(i + 1) % 3]);
+					auto shared = std::find(horizon.begin(), horizon.end(),
+											std::make_pair(edge.second, edge.first));
+					if (shared != horizon.end())
+					{
+						horizon.erase(shared);
+					}
+					else
+					{
+						horizon.push_back(edge);
+					}
+				}
+			}
+		}
+		if (horizon.empty())
+		{
+			break;
+		}
+		faces.erase(std::remove_if(faces.begin(), faces.end(), isVisible), faces.end());
+
+		bool isDegenerate = false;
+		for (const auto& edge : horizon)
+		{
+			Face face;
+			if (!makeFace(vertices, edge.first, edge.second, newVertex, &face))
+			{
+				isDegenerate = true;
+				break;
+			}
+			faces.push_back(face);
+		}
+		if (isDegenerate)
+		{
+			break;
+		}
+	}
+
+	*searchDirection = closest.normal;
+	if (closest.distance <= 0.0)
+	{
+		// The shapes are touching
+		return false;
+	}
+
+	const Vector3d projection = closest.normal * closest.distance;
+	const SupportPoint& a = vertices[closest.vertices[0]];
+	const SupportPoint& b = vertices[closest.vertices[1]];
+	const SupportPoint& c = vertices[closest.vertices[2]];
+	Vector3d coordinates;
+	if (!barycentricCoordinates(projection, a.point, b.point, c.point, closest.normal, &coordinates))
+	{
+		coordinates = Vector3d::UnitX();
+	}
+
+	*normal = -closest.normal;
+	*depth = closest.distance;
+	*point1 = coordinates[0] * a.point1 + coordinates[1] * b.point1 + coordinates[2] * c.point1;
+	*point2 = coordinates[0] * a.point2 + coordinates[1] * b.point2 + coordinates[2] * c.point2;
+	return true;
+}
+
+}; // namespace Math
+}; // namespace SurgSim
@@ -0,0 +1,56 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SURGSIM_MATH_CONVEXPENETRATION_H
+#define SURGSIM_MATH_CONVEXPENETRATION_H
+
+#include "SurgSim/Math/RigidTransform.h"
+#include "SurgSim/Math/Vector.h"
+
+namespace SurgSim
+{
+namespace Math
+{
+
+class Shape;
+
+/// Relative precision of the depth found by calculateConvexPenetration()
+static const double ConvexPenetrationRelativePrecision = 1e-4;
+
+/// Calculate the penetration between two convex shapes, given only through their support functions (see
+/// Shape::getSupport()).
+/// The intersection is detected with the Gilbert-Johnson-Keerthi algorithm on the Minkowski difference of the
+/// shapes; when they intersect, the Expanding Polytope Algorithm finds the smallest translation that separates them.
+/// Curved shapes are approximated by the polytope, the depth is found within a relative precision of
+/// ConvexPenetrationRelativePrecision.
+/// \param shape1, pose1 the first convex shape and its pose
+/// \param shape2, pose2 the second convex shape and its pose
+/// \param [in,out] searchDirection the initial search direction, e.g. the one returned by a previous call for the same
+/// 	pair of shapes (the zero vector can be used if there is none); on return, an axis that separates the shapes
+/// 	if they do not intersect, or the direction of the penetration otherwise.
+/// \param [out] normal the direction along which the first shape needs to move to separate the shapes, normalized
+/// \param [out] depth the distance the first shape needs to move along the normal
+/// \param [out] point1 the deepest point of the first shape inside the second one, in world coordinates
+/// \param [out] point2 the deepest point of the second shape inside the first one, in world coordinates
+/// \return true if the shapes intersect, in which case the other outputs are set
+bool calculateConvexPenetration(const Shape& shape1, const RigidTransform3d& pose1,
+								const Shape& shape2, const RigidTransform3d& pose2,
+								Vector3d* searchDirection,
+								Vector3d* normal, double* depth, Vector3d* point1, Vector3d* point2);
+
+}; // namespace Math
+}; // namespace SurgSim
+
+#endif // SURGSIM_MATH_CONVEXPENETRATION_H
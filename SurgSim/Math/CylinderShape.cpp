@@ -94,5 +94,23 @@ bool CylinderShape::isValid() const
 	return (m_length >= 0) && (m_radius >= 0);
 }
 
+bool CylinderShape::isConvex() const
+{
+	return true;
+}
+
+Vector3d CylinderShape::getSupport(const Vector3d& direction) const
+{
+	// The rim of the cap along the direction
+	Vector3d support(0.0, (direction[1] >= 0.0) ? m_length / 2.0 : -m_length / 2.0, 0.0);
+	double radialNorm = std::sqrt(direction[0] * direction[0] + direction[2] * direction[2]);
+	if (radialNorm > 0.0)
+	{
+		support[0] = direction[0] * (m_radius / radialNorm);
+		support[2] = direction[2] * (m_radius / radialNorm);
+	}
+	return support;
+}
+
 }; // namespace Math
 }; // namespace SurgSim
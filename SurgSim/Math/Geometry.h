@@ -1630,6 +1630,31 @@ bool doesIntersectTriangleTriangle(
 	const Eigen::Matrix<T, 3, 1, MOpt>& t0n,
 	const Eigen::Matrix<T, 3, 1, MOpt>& t1n);
 
+/// Check if the two triangles intersect using separating axis test, with the result of the early rejection (e.g. from
+/// TriangleTriangleBatch) already known. The pair should not have been rejected, i.e. some vertices of each triangle
+/// are not strictly on one side of the plane of the other triangle.
+/// \tparam T		Accuracy of the calculation, can usually be inferred.
+/// \tparam MOpt	Eigen Matrix options, can usually be inferred.
+/// \param t0v0,t0v1,t0v2 Vertices of the first triangle.
+/// \param t1v0,t1v1,t1v2 Vertices of the second triangle.
+/// \param t0n Normal of the first triangle, should be normalized and not zero.
+/// \param t1n Normal of the second triangle, should be normalized and not zero.
+/// \param t0Distances Signed distances of the vertices of the first triangle from the plane of the second triangle.
+/// \param t1Distances Signed distances of the vertices of the second triangle from the plane of the first triangle.
+/// \return True, if intersection is detected.
+template <class T, int MOpt> inline
+bool doesIntersectTriangleTriangle(
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0v0,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0v1,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0v2,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1v0,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1v1,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1v2,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0n,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1n,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0Distances,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1Distances);
+
 /// Check if the two triangles intersect using separating axis test.
 /// \tparam T		Accuracy of the calculation, can usually be inferred.
 /// \tparam MOpt	Eigen Matrix options, can usually be inferred.
@@ -1679,6 +1704,40 @@ bool calculateContactTriangleTriangle(
 	Eigen::Matrix<T, 3, 1, MOpt>* penetrationPoint1,
 	Eigen::Matrix<T, 3, 1, MOpt>* contactNormal);
 
+/// Calculate the contact between two triangles, with the result of the early rejection (e.g. from
+/// TriangleTriangleBatch) already known, see calculateContactTriangleTriangle() above. The pair should not have been
+/// rejected, i.e. some vertices of each triangle are not strictly on one side of the plane of the other triangle.
+/// \tparam T		Accuracy of the calculation, can usually be inferred.
+/// \tparam MOpt	Eigen Matrix options, can usually be inferred.
+/// \param t0v0,t0v1,t0v2 Vertices of the first triangle.
+/// \param t1v0,t1v1,t1v2 Vertices of the second triangle.
+/// \param t0n Unit length normal of the first triangle, should not be zero.
+/// \param t1n Unit length normal of the second triangle, should not be zero.
+/// \param t0Distances Signed distances of the vertices of the first triangle from the plane of the second triangle.
+/// \param t1Distances Signed distances of the vertices of the second triangle from the plane of the first triangle.
+/// \param [out] penetrationDepth The depth of penetration.
+/// \param [out] penetrationPoint0 The contact point on triangle0 (t0v0,t0v1,t0v2).
+/// \param [out] penetrationPoint1 The contact point on triangle1 (t1v0,t1v1,t1v2).
+/// \param [out] contactNormal The contact normal that points from triangle1 to triangle0.
+/// \return True, if intersection is detected.
+/// \note The [out] params are not modified if there is no intersection.
+template <class T, int MOpt> inline
+bool calculateContactTriangleTriangle(
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0v0,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0v1,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0v2,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1v0,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1v1,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1v2,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0n,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1n,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0Distances,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1Distances,
+	T* penetrationDepth,
+	Eigen::Matrix<T, 3, 1, MOpt>* penetrationPoint0,
+	Eigen::Matrix<T, 3, 1, MOpt>* penetrationPoint1,
+	Eigen::Matrix<T, 3, 1, MOpt>* contactNormal);
+
 /// Calculate the contact between two triangles.
 /// Algorithm presented in
 /// https://docs.google.com/a/simquest.com/document/d/11ajMD7QoTVelT2_szGPpeUEY0wHKKxW1TOgMe8k5Fsc/pub.
@@ -28,10 +28,47 @@ Matrix LinearSparseSolveAndInverse::getInverse() const
 	return m_matrix.toDense().inverse();
 }
 
+void LinearSparseSolveAndInverse::solve(const Vector& b, Vector* x) const
+{
+	*x = solve(Matrix(b));
+}
+
+bool LinearSparseSolveAndInverse::hasSamePattern(const SparseMatrix& matrix) const
+{
+	if (m_matrix.rows() == 0 || matrix.rows() != m_matrix.rows() || matrix.cols() != m_matrix.cols() ||
+		matrix.nonZeros() != m_matrix.nonZeros())
+	{
+		return false;
+	}
+
+	// Iterate over both matrices, so that compressed and uncompressed matrices can be compared
+	for (SparseMatrix::Index outer = 0; outer < matrix.outerSize(); ++outer)
+	{
+		SparseMatrix::InnerIterator it(matrix, outer);
+		SparseMatrix::InnerIterator previousIt(m_matrix, outer);
+		for (; it && previousIt; ++it, ++previousIt)
+		{
+			if (it.index() != previousIt.index())
+			{
+				return false;
+			}
+		}
+		if (it || previousIt)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 void LinearSparseSolveAndInverseLU::setMatrix(const SparseMatrix& matrix)
 {
 	SURGSIM_ASSERT(matrix.cols() == matrix.rows()) << "Cannot inverse a non square matrix";
-	m_solver.compute(matrix);
+	if (!hasSamePattern(matrix))
+	{
+		m_solver.analyzePattern(matrix);
+	}
+	m_solver.factorize(matrix);
 	SURGSIM_ASSERT(m_solver.info() == Eigen::Success) << m_solver.lastErrorMessage();
 	m_matrix = matrix;
 }
@@ -41,6 +78,74 @@ Matrix LinearSparseSolveAndInverseLU::solve(const Matrix& b) const
 	return m_solver.solve(b);
 }
 
+void LinearSparseSolveAndInverseLU::solve(const Vector& b, Vector* x) const
+{
+	*x = m_solver.solve(b);
+}
+
+LinearSparseSolveAndInverseLDLT::LinearSparseSolveAndInverseLDLT() :
+	m_maxFactorizationReuse(0),
+	m_numFactorizationReuse(0),
+	m_numFactorizations(0),
+	m_numAnalyzePattern(0)
+{
+}
+
+void LinearSparseSolveAndInverseLDLT::setMaxFactorizationReuse(size_t numCalls)
+{
+	m_maxFactorizationReuse = numCalls;
+}
+
+size_t LinearSparseSolveAndInverseLDLT::getMaxFactorizationReuse() const
+{
+	return m_maxFactorizationReuse;
+}
+
+size_t LinearSparseSolveAndInverseLDLT::getNumFactorizations() const
+{
+	return m_numFactorizations;
+}
+
+size_t LinearSparseSolveAndInverseLDLT::getNumAnalyzePattern() const
+{
+	return m_numAnalyzePattern;
+}
+
+void LinearSparseSolveAndInverseLDLT::setMatrix(const SparseMatrix& matrix)
+{
+	SURGSIM_ASSERT(matrix.cols() == matrix.rows()) << "Cannot inverse a non square matrix";
+
+	const bool samePattern = hasSamePattern(matrix);
+	if (samePattern && m_numFactorizationReuse < m_maxFactorizationReuse)
+	{
+		// Keep the factorization and the matrix it corresponds to, so that getInverse stays consistent with solve
+		++m_numFactorizationReuse;
+		return;
+	}
+
+	if (!samePattern)
+	{
+		m_solver.analyzePattern(matrix);
+		++m_numAnalyzePattern;
+	}
+	m_solver.factorize(matrix);
+	SURGSIM_ASSERT(m_solver.info() == Eigen::Success) <<
+		"The LDLT factorization failed, the matrix needs to be symmetric positive definite";
+	++m_numFactorizations;
+	m_numFactorizationReuse = 0;
+	m_matrix = matrix;
+}
+
+Matrix LinearSparseSolveAndInverseLDLT::solve(const Matrix& b) const
+{
+	return m_solver.solve(b);
+}
+
+void LinearSparseSolveAndInverseLDLT::solve(const Vector& b, Vector* x) const
+{
+	*x = m_solver.solve(b);
+}
+
 void LinearSparseSolveAndInverseCG::setTolerance(double tolerance)
 {
 	m_solver.setTolerance(tolerance);
@@ -73,6 +178,61 @@ Matrix LinearSparseSolveAndInverseCG::solve(const Matrix& b) const
 	return m_solver.solve(b);
 }
 
+void LinearSparseSolveAndInverseCG::solve(const Vector& b, Vector* x) const
+{
+	*x = m_solver.solve(b);
+}
+
+void LinearSparseSolveAndInverseDiagonal::setMatrix(const SparseMatrix& matrix)
+{
+	SURGSIM_ASSERT(matrix.cols() == matrix.rows()) << "Cannot inverse a non square matrix";
+
+	Vector diagonal = Vector::Zero(matrix.rows());
+	for (SparseMatrix::Index outer = 0; outer < matrix.outerSize(); ++outer)
+	{
+		for (SparseMatrix::InnerIterator it(matrix, outer); it; ++it)
+		{
+			if (it.row() == it.col())
+			{
+				diagonal[it.row()] = it.value();
+			}
+			else
+			{
+				SURGSIM_ASSERT(it.value() == 0.0) << "The matrix is not diagonal, (" << it.row() << ", " << it.col() <<
+					") = " << it.value();
+			}
+		}
+	}
+	setDiagonal(diagonal);
+}
+
+void LinearSparseSolveAndInverseDiagonal::setDiagonal(const Vector& diagonal)
+{
+	SURGSIM_ASSERT((diagonal.array() != 0.0).all()) << "Cannot inverse a diagonal matrix with a zero on its diagonal";
+
+	m_inverseDiagonal = diagonal.cwiseInverse();
+}
+
+Matrix LinearSparseSolveAndInverseDiagonal::solve(const Matrix& b) const
+{
+	return m_inverseDiagonal.asDiagonal() * b;
+}
+
+void LinearSparseSolveAndInverseDiagonal::solve(const Vector& b, Vector* x) const
+{
+	*x = m_inverseDiagonal.cwiseProduct(b);
+}
+
+Matrix LinearSparseSolveAndInverseDiagonal::getInverse() const
+{
+	return m_inverseDiagonal.asDiagonal();
+}
+
+const Vector& LinearSparseSolveAndInverseDiagonal::getInverseDiagonal() const
+{
+	return m_inverseDiagonal;
+}
+
 }; // namespace Math
 
 }; // namespace SurgSim
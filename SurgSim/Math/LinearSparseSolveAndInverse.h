@@ -42,13 +42,17 @@ enum LinearSolver
 {
 	LINEARSOLVER_LU = 0,
 	LINEARSOLVER_CONJUGATEGRADIENT,
+	LINEARSOLVER_LDLT,
+	LINEARSOLVER_DIAGONAL,
 	MAX_LINEARSOLVER
 };
 
 const std::unordered_map<LinearSolver, std::string, std::hash<int>> LinearSolverNames =
 			boost::assign::map_list_of
 			(LINEARSOLVER_LU, "LINEARSOLVER_LU")
-			(LINEARSOLVER_CONJUGATEGRADIENT, "LINEARSOLVER_CONJUGATEGRADIENT");
+			(LINEARSOLVER_CONJUGATEGRADIENT, "LINEARSOLVER_CONJUGATEGRADIENT")
+			(LINEARSOLVER_LDLT, "LINEARSOLVER_LDLT")
+			(LINEARSOLVER_DIAGONAL, "LINEARSOLVER_DIAGONAL");
 
 /// LinearSparseSolveAndInverse aims at performing an efficient linear system resolution and
 /// calculating its inverse matrix at the same time.
@@ -70,15 +74,26 @@ class LinearSparseSolveAndInverse
 	/// \return The solution matrix
 	virtual Matrix solve(const Matrix& b) const = 0;
 
+	/// Solve the linear system (matrix.x=b) using the matrix provided by the latest setMatrix call, into an existing
+	/// vector, which does not allocate any memory if x already has the proper size.
+	/// \param b The rhs vector
+	/// \param [out] x The solution vector, it cannot be b
+	virtual void solve(const Vector& b, Vector* x) const;
+
 	/// \return The linear system's inverse matrix, i.e. the inverse of the matrix provided on the last setMatrix call
 	virtual Matrix getInverse() const;
 
 protected:
+	/// \param matrix The matrix to compare with the matrix of the latest setMatrix call
+	/// \return True if both matrices have the same size and the same non-zero entries, false if no matrix was set
+	bool hasSamePattern(const SparseMatrix& matrix) const;
+
 	/// A copy of the system matrix for use when an inverse is necessary.
 	SparseMatrix m_matrix;
 };
 
 /// Derivation for sparse LU solver
+/// The symbolic analysis of the matrix is only redone when its sparsity pattern changes.
 class LinearSparseSolveAndInverseLU : public LinearSparseSolveAndInverse
 {
 public:
@@ -86,10 +101,60 @@ class LinearSparseSolveAndInverseLU : public LinearSparseSolveAndInverse
 
 	Matrix solve(const Matrix& b) const override;
 
+	void solve(const Vector& b, Vector* x) const override;
+
 private:
 	Eigen::SparseLU<SparseMatrix> m_solver;
 };
 
+/// Derivation for sparse LDLT (Cholesky) solver, for symmetric positive definite matrices only.
+/// The symbolic analysis (fill-reducing ordering and elimination tree) is only redone when the sparsity pattern of
+/// the matrix changes, which never happens for a given FEM mesh, each following setMatrix only does the numerical
+/// factorization.
+/// For (nearly) linear models the numerical factorization can also be reused for a number of calls to setMatrix, in
+/// which case the matrices given in between are ignored.
+class LinearSparseSolveAndInverseLDLT : public LinearSparseSolveAndInverse
+{
+public:
+	/// Constructor
+	LinearSparseSolveAndInverseLDLT();
+
+	/// Set the number of calls to setMatrix for which the latest numerical factorization is reused, as long as the
+	/// sparsity pattern of the matrix does not change.
+	/// \param numCalls the number of calls for which the matrix is not factorized again, 0 to factorize every matrix
+	void setMaxFactorizationReuse(size_t numCalls);
+
+	/// \return The number of calls to setMatrix for which the latest numerical factorization is reused
+	size_t getMaxFactorizationReuse() const;
+
+	/// \return The total number of numerical factorizations done by this solver
+	size_t getNumFactorizations() const;
+
+	/// \return The total number of symbolic analysis done by this solver
+	size_t getNumAnalyzePattern() const;
+
+	void setMatrix(const SparseMatrix& matrix) override;
+
+	Matrix solve(const Matrix& b) const override;
+
+	void solve(const Vector& b, Vector* x) const override;
+
+private:
+	Eigen::SimplicialLDLT<SparseMatrix> m_solver;
+
+	/// Number of calls to setMatrix for which the factorization is reused
+	size_t m_maxFactorizationReuse;
+
+	/// Number of calls to setMatrix since the latest factorization
+	size_t m_numFactorizationReuse;
+
+	/// Total number of numerical factorizations
+	size_t m_numFactorizations;
+
+	/// Total number of symbolic analysis
+	size_t m_numAnalyzePattern;
+};
+
 /// Derivation for sparse CG solver
 class LinearSparseSolveAndInverseCG : public LinearSparseSolveAndInverse
 {
@@ -114,10 +179,39 @@ class LinearSparseSolveAndInverseCG : public LinearSparseSolveAndInverse
 
 	Matrix solve(const Matrix& b) const override;
 
+	void solve(const Vector& b, Vector* x) const override;
+
 private:
 	Eigen::ConjugateGradient<SparseMatrix> m_solver;
 };
 
+/// Derivation for diagonal matrices (i.e. the lumped mass matrix of the explicit solvers), the resolution is a
+/// scaling by the inverse of the diagonal, no factorization is needed.
+class LinearSparseSolveAndInverseDiagonal : public LinearSparseSolveAndInverse
+{
+public:
+	/// Set the linear solver matrix
+	/// \param matrix the new matrix to solve/inverse for, it needs to be diagonal, without any zero on the diagonal
+	void setMatrix(const SparseMatrix& matrix) override;
+
+	/// Set the linear solver matrix from its diagonal, without going through a sparse matrix
+	/// \param diagonal the diagonal of the new matrix to solve/inverse for, without any zero
+	void setDiagonal(const Vector& diagonal);
+
+	Matrix solve(const Matrix& b) const override;
+
+	void solve(const Vector& b, Vector* x) const override;
+
+	Matrix getInverse() const override;
+
+	/// \return The inverse of the diagonal of the matrix provided on the last setMatrix or setDiagonal call
+	const Vector& getInverseDiagonal() const;
+
+private:
+	/// The inverse of the diagonal
+	Vector m_inverseDiagonal;
+};
+
 }; // namespace Math
 
 }; // namespace SurgSim
@@ -17,11 +17,33 @@
 
 #include "SurgSim/DataStructures/AabbTree.h"
 #include "SurgSim/DataStructures/AabbTreeData.h"
+#include "SurgSim/DataStructures/FlatAabbTree.h"
 #include "SurgSim/Framework/Assert.h"
 
 using SurgSim::DataStructures::EmptyData;
 using SurgSim::DataStructures::NormalData;
 
+namespace
+{
+/// Get the bounding boxes of the valid triangles of a mesh
+/// \param mesh the mesh
+/// \param [out] items the bounding box and id of each valid triangle
+void getTriangleItems(const SurgSim::Math::MeshShape& mesh,
+					  std::vector<SurgSim::DataStructures::FlatAabbTree::Item>* items)
+{
+	auto const& triangles = mesh.getTriangles();
+	items->reserve(triangles.size());
+	for (size_t id = 0, count = triangles.size(); id < count; ++id)
+	{
+		if (triangles[id].isValid)
+		{
+			auto vertices = mesh.getTrianglePositions(id);
+			items->emplace_back(SurgSim::Math::makeAabb(vertices[0], vertices[1], vertices[2]), id);
+		}
+	}
+}
+}
+
 
 template<>
 std::string SurgSim::DataStructures::TriangleMesh<EmptyData, EmptyData, NormalData>
@@ -46,7 +68,9 @@ MeshShape::MeshShape(const MeshShape& other) :
 	::TriangleMesh(other),
 	m_center(other.getCenter()),
 	m_volume(other.getVolume()),
-	m_secondMomentOfVolume(other.getSecondMomentOfVolume())
+	m_secondMomentOfVolume(other.getSecondMomentOfVolume()),
+	m_aabbTree((other.m_aabbTree != nullptr) ?
+			   std::make_shared<DataStructures::FlatAabbTree>(*other.m_aabbTree) : nullptr)
 {
 	updateAabbTree();
 }
@@ -221,28 +245,39 @@ std::shared_ptr<Shape> MeshShape::getTransformed(const RigidTransform3d& pose) c
 	return transformed;
 }
 
-const std::shared_ptr<const SurgSim::DataStructures::AabbTree> MeshShape::getAabbTree() const
+const std::shared_ptr<const SurgSim::DataStructures::FlatAabbTree> MeshShape::getFlatAabbTree() const
 {
 	return m_aabbTree;
 }
 
-void MeshShape::updateAabbTree()
+const std::shared_ptr<const SurgSim::DataStructures::AabbTree> MeshShape::getAabbTree() const
 {
-	m_aabbTree = std::make_shared<SurgSim::DataStructures::AabbTree>();
-
-	std::list<DataStructures::AabbTreeData::Item> items;
+	// The shape can be queried concurrently, a tree built twice is only a wasted effort
+	auto legacyAabbTree = std::atomic_load(&m_legacyAabbTree);
+	if (legacyAabbTree == nullptr)
+	{
+		std::vector<DataStructures::FlatAabbTree::Item> items;
+		getTriangleItems(*this, &items);
 
-	auto const& triangles = getTriangles();
+		auto aabbTree = std::make_shared<SurgSim::DataStructures::AabbTree>();
+		aabbTree->set(std::list<DataStructures::AabbTreeData::Item>(items.begin(), items.end()));
+		legacyAabbTree = aabbTree;
+		std::atomic_store(&m_legacyAabbTree, legacyAabbTree);
+	}
+	return legacyAabbTree;
+}
 
-	for (size_t id = 0, count = triangles.size(); id < count; ++id)
+void MeshShape::updateAabbTree()
+{
+	if (m_aabbTree == nullptr)
 	{
-		if (triangles[id].isValid)
-		{
-			auto vertices = getTrianglePositions(id);
-			items.emplace_back(SurgSim::Math::makeAabb(vertices[0], vertices[1], vertices[2]), id);
-		}
+		m_aabbTree = std::make_shared<SurgSim::DataStructures::FlatAabbTree>();
 	}
-	m_aabbTree->set(std::move(items));
+
+	std::vector<DataStructures::FlatAabbTree::Item> items;
+	getTriangleItems(*this, &items);
+	m_aabbTree->update(items);
+	std::atomic_store(&m_legacyAabbTree, std::shared_ptr<const SurgSim::DataStructures::AabbTree>());
 
 	m_aabb = m_aabbTree->getAabb();
 }
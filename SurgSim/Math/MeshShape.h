@@ -30,6 +30,7 @@ namespace SurgSim
 namespace DataStructures
 {
 class AabbTree;
+class FlatAabbTree;
 }
 
 namespace Math
@@ -87,8 +88,14 @@ class MeshShape : public Shape, public SurgSim::DataStructures::TriangleMesh<Sur
 
 	std::shared_ptr<Shape> getTransformed(const RigidTransform3d& pose) const override;
 
-	/// Get the AabbTree
-	/// \return The object's associated AabbTree
+	/// Get the flat, pointer free AabbTree of the triangles, refitted on update()
+	/// \return The object's associated FlatAabbTree
+	const std::shared_ptr<const SurgSim::DataStructures::FlatAabbTree> getFlatAabbTree() const;
+
+	/// Get a pointer based AabbTree of the triangles, kept for the existing users of this accessor
+	/// \note Deprecated, use getFlatAabbTree(). The tree is built on the first call after an update() and kept until
+	/// 	the next one.
+	/// \return The AabbTree of the valid triangles
 	const std::shared_ptr<const SurgSim::DataStructures::AabbTree> getAabbTree() const;
 
 	bool isValid() const override;
@@ -105,7 +112,8 @@ class MeshShape : public Shape, public SurgSim::DataStructures::TriangleMesh<Sur
 	/// \return true on success, or false if any triangle has an indeterminate normal.
 	bool calculateNormals();
 
-	/// Update the AabbTree, which is an axis-aligned bounding box r-tree used to accelerate spatial searches
+	/// Update the AabbTree, which is an axis-aligned bounding box tree used to accelerate spatial searches.
+	/// As long as the triangles stay the same, the tree is only refit to the new triangle positions.
 	void updateAabbTree();
 
 	/// Compute useful volume integrals based on the triangle mesh, which
@@ -123,7 +131,10 @@ class MeshShape : public Shape, public SurgSim::DataStructures::TriangleMesh<Sur
 
 private:
 	/// The aabb tree used to accelerate collision detection against the mesh
-	std::shared_ptr<SurgSim::DataStructures::AabbTree> m_aabbTree;
+	std::shared_ptr<SurgSim::DataStructures::FlatAabbTree> m_aabbTree;
+
+	/// The pointer based aabb tree returned by getAabbTree(), nullptr until requested after an update
+	mutable std::shared_ptr<const SurgSim::DataStructures::AabbTree> m_legacyAabbTree;
 };
 
 }; // Math
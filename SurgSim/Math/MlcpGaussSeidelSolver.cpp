@@ -27,11 +27,97 @@ namespace SurgSim
 namespace Math
 {
 
+namespace
+{
+
+typedef Eigen::SparseMatrix<double, Eigen::RowMajor> SparseMatrix;
+
+/// \return The product of the row of A by x
+double rowProduct(const MlcpProblem::Matrix& A, size_t row, const MlcpSolution::Vector& x)
+{
+	return A.row(row).dot(x);
+}
+
+double rowProduct(const SparseMatrix& A, size_t row, const MlcpSolution::Vector& x)
+{
+	double result = 0.0;
+	for (SparseMatrix::InnerIterator it(A, row); it; ++it)
+	{
+		result += it.value() * x[it.index()];
+	}
+	return result;
+}
+
+/// \return The product of the Rows rows of A starting at row by x
+template <int Rows>
+Eigen::Matrix<double, Rows, 1> rowsProduct(const MlcpProblem::Matrix& A, size_t row, const MlcpSolution::Vector& x)
+{
+	return A.middleRows<Rows>(row) * x;
+}
+
+template <int Rows>
+Eigen::Matrix<double, Rows, 1> rowsProduct(const SparseMatrix& A, size_t row, const MlcpSolution::Vector& x)
+{
+	Eigen::Matrix<double, Rows, 1> result;
+	for (int i = 0; i < Rows; ++i)
+	{
+		result[i] = rowProduct(A, row + i, x);
+	}
+	return result;
+}
+
+/// \return The Rows x Cols block of A starting at (row, col)
+template <int Rows, int Cols>
+Eigen::Matrix<double, Rows, Cols> fixedBlock(const MlcpProblem::Matrix& A, size_t row, size_t col)
+{
+	return A.block<Rows, Cols>(row, col);
+}
+
+template <int Rows, int Cols>
+Eigen::Matrix<double, Rows, Cols> fixedBlock(const SparseMatrix& A, size_t row, size_t col)
+{
+	Eigen::Matrix<double, Rows, Cols> result;
+	for (int i = 0; i < Rows; ++i)
+	{
+		for (int j = 0; j < Cols; ++j)
+		{
+			result(i, j) = A.coeff(row + i, col + j);
+		}
+	}
+	return result;
+}
+
+/// \return The rows x cols block of A starting at (row, col)
+Eigen::Block<const MlcpProblem::Matrix> denseBlock(const MlcpProblem::Matrix& A, size_t row, size_t col,
+		size_t rows, size_t cols)
+{
+	return A.block(row, col, rows, cols);
+}
+
+MlcpProblem::Matrix denseBlock(const SparseMatrix& A, size_t row, size_t col, size_t rows, size_t cols)
+{
+	MlcpProblem::Matrix result = MlcpProblem::Matrix::Zero(rows, cols);
+	for (size_t i = 0; i < rows; ++i)
+	{
+		for (SparseMatrix::InnerIterator it(A, row + i); it && static_cast<size_t>(it.index()) < col + cols; ++it)
+		{
+			if (static_cast<size_t>(it.index()) >= col)
+			{
+				result(i, it.index() - col) = it.value();
+			}
+		}
+	}
+	return result;
+}
+
+};
+
 MlcpGaussSeidelSolver::MlcpGaussSeidelSolver() :
 	m_epsilonConvergence(1e-4),
 	m_contactTolerance(2e-5),
 	m_maxIterations(30),
 	m_numEnforcedAtomicConstraints(0),
+	m_useSparseMatrix(false),
 	m_logger(SurgSim::Framework::Logger::getLogger("Math/MlcpGaussSeidelSolver"))
 {
 }
@@ -42,6 +128,7 @@ MlcpGaussSeidelSolver::MlcpGaussSeidelSolver(double epsilonConvergence, double c
 	m_contactTolerance(contactTolerance),
 	m_maxIterations(maxIterations),
 	m_numEnforcedAtomicConstraints(0),
+	m_useSparseMatrix(false),
 	m_logger(SurgSim::Framework::Logger::getLogger("Math/MlcpGaussSeidelSolver"))
 {
 }
@@ -80,10 +167,35 @@ void MlcpGaussSeidelSolver::setMaxIterations(size_t maxIterations)
 	m_maxIterations = maxIterations;
 }
 
+void MlcpGaussSeidelSolver::setUseSparseMatrix(bool useSparseMatrix)
+{
+	m_useSparseMatrix = useSparseMatrix;
+}
+
+bool MlcpGaussSeidelSolver::isUsingSparseMatrix() const
+{
+	return m_useSparseMatrix;
+}
+
 bool MlcpGaussSeidelSolver::solve(const MlcpProblem& problem, MlcpSolution* solution)
+{
+	if (problem.isSparse())
+	{
+		return doSolve(problem, problem.sparseA, solution);
+	}
+	if (m_useSparseMatrix)
+	{
+		// Only the exact zeros are dropped, the iterations are the same as with the dense matrix
+		m_sparseA = problem.A.sparseView();
+		return doSolve(problem, m_sparseA, solution);
+	}
+	return doSolve(problem, problem.A, solution);
+}
+
+template <typename MatrixType>
+bool MlcpGaussSeidelSolver::doSolve(const MlcpProblem& problem, const MatrixType& A, MlcpSolution* solution)
 {
 	const size_t problemSize = problem.getSize();
-	const MlcpProblem::Matrix& A = problem.A;
 	const MlcpProblem::Vector& b = problem.b;
 	MlcpSolution::Vector& initialGuessAndSolution = solution->x;
 	const std::vector<MlcpConstraintType>& constraintsType = problem.constraintTypes;
@@ -153,7 +265,8 @@ bool MlcpGaussSeidelSolver::solve(const MlcpProblem& problem, MlcpSolution* solu
 }
 
 
-void MlcpGaussSeidelSolver::calculateConvergenceCriteria(size_t problemSize, const MlcpProblem::Matrix& A,
+template <typename MatrixType>
+void MlcpGaussSeidelSolver::calculateConvergenceCriteria(size_t problemSize, const MatrixType& A,
 		const MlcpProblem::Vector& b,
 		const MlcpSolution::Vector& initialGuessAndSolution,
 		const std::vector<MlcpConstraintType>& constraintsType,
@@ -180,7 +293,7 @@ void MlcpGaussSeidelSolver::calculateConvergenceCriteria(size_t problemSize, con
 			case MLCP_BILATERAL_1D_CONSTRAINT:
 			{
 				const double criteria =
-					(b.segment<1>(currentAtomicIndex) + A.row(currentAtomicIndex) * initialGuessAndSolution).norm();
+					std::abs(b[currentAtomicIndex] + rowProduct(A, currentAtomicIndex, initialGuessAndSolution));
 				*convergenceCriteria += criteria;
 				constraintConvergenceCriteria[constraintsType[constraint]] += criteria;
 
@@ -192,8 +305,8 @@ void MlcpGaussSeidelSolver::calculateConvergenceCriteria(size_t problemSize, con
 			case MLCP_BILATERAL_2D_CONSTRAINT:
 			{
 				const double criteria = (b.segment<2>(currentAtomicIndex) +
-										 A.block(currentAtomicIndex, 0, 2, problemSize) *
-										 initialGuessAndSolution).norm();
+										 rowsProduct<2>(A, currentAtomicIndex,
+										 initialGuessAndSolution)).norm();
 				*convergenceCriteria += criteria;
 				constraintConvergenceCriteria[constraintsType[constraint]] += criteria;
 
@@ -205,8 +318,8 @@ void MlcpGaussSeidelSolver::calculateConvergenceCriteria(size_t problemSize, con
 			case MLCP_BILATERAL_3D_CONSTRAINT:
 			{
 				const double criteria = (b.segment<3>(currentAtomicIndex) +
-										 A.block(currentAtomicIndex, 0, 3, problemSize) *
-										 initialGuessAndSolution).norm();
+										 rowsProduct<3>(A, currentAtomicIndex,
+										 initialGuessAndSolution)).norm();
 				*convergenceCriteria += criteria;
 				constraintConvergenceCriteria[constraintsType[constraint]] += criteria;
 
@@ -218,7 +331,7 @@ void MlcpGaussSeidelSolver::calculateConvergenceCriteria(size_t problemSize, con
 			case MLCP_UNILATERAL_3D_FRICTIONLESS_CONSTRAINT:
 			{
 				const double violation = b[currentAtomicIndex] +
-										 A.row(currentAtomicIndex) * initialGuessAndSolution;
+										 rowProduct(A, currentAtomicIndex, initialGuessAndSolution);
 				// Enforce orthogonality condition
 				if (!SurgSim::Math::isValid(violation) || violation < -m_contactTolerance ||
 					(initialGuessAndSolution[currentAtomicIndex] > m_epsilonConvergence &&
@@ -232,7 +345,8 @@ void MlcpGaussSeidelSolver::calculateConvergenceCriteria(size_t problemSize, con
 
 			case MLCP_UNILATERAL_3D_FRICTIONAL_CONSTRAINT:
 			{
-				const double violation = b[currentAtomicIndex] + A.row(currentAtomicIndex) * initialGuessAndSolution;
+				const double violation = b[currentAtomicIndex] +
+										 rowProduct(A, currentAtomicIndex, initialGuessAndSolution);
 				// Enforce orthogonality condition
 				if (!SurgSim::Math::isValid(violation) || violation < -m_contactTolerance ||
 					(initialGuessAndSolution[currentAtomicIndex] > m_epsilonConvergence &&
@@ -247,8 +361,8 @@ void MlcpGaussSeidelSolver::calculateConvergenceCriteria(size_t problemSize, con
 			case MLCP_BILATERAL_FRICTIONLESS_SLIDING_CONSTRAINT:
 			{
 				const double criteria = (b.segment<2>(currentAtomicIndex) +
-										 A.block(currentAtomicIndex, 0, 2, problemSize) *
-										 initialGuessAndSolution).norm();
+										 rowsProduct<2>(A, currentAtomicIndex,
+										 initialGuessAndSolution)).norm();
 				*convergenceCriteria += criteria;
 				constraintConvergenceCriteria[constraintsType[constraint]] += criteria;
 
@@ -262,8 +376,8 @@ void MlcpGaussSeidelSolver::calculateConvergenceCriteria(size_t problemSize, con
 				// We verify that the sliding point is on the line...no matter what the friction violation is
 				// (3rd component)
 				const double criteria = (b.segment<2>(currentAtomicIndex) +
-										 A.block(currentAtomicIndex, 0, 2, problemSize) *
-										 initialGuessAndSolution).norm();
+										 rowsProduct<2>(A, currentAtomicIndex,
+										 initialGuessAndSolution)).norm();
 				*convergenceCriteria += criteria;
 				constraintConvergenceCriteria[constraintsType[constraint]] += criteria;
 
@@ -285,8 +399,9 @@ void MlcpGaussSeidelSolver::calculateConvergenceCriteria(size_t problemSize, con
 	}
 }
 
+template <typename MatrixType>
 void MlcpGaussSeidelSolver::computeEnforcementSystem(
-	size_t problemSize, const MlcpProblem::Matrix& A, const MlcpProblem::Vector& b,
+	size_t problemSize, const MatrixType& A, const MlcpProblem::Vector& b,
 	const MlcpSolution::Vector& initialGuessAndSolution,
 	const std::vector<MlcpConstraintType>& constraintsType,
 	size_t constraintID, size_t matrixEntryForConstraintID)
@@ -380,10 +495,11 @@ void MlcpGaussSeidelSolver::computeEnforcementSystem(
 	// We suppose that the constraint to enforce are only 1D, 2D or 3D bilateral constraints
 	{
 		// Here we fill up the core part, compliance between all the constraints themselves !
-		m_rhsEnforcedLocalSystem.head(systemSizeWithoutConstraintID) = b.head(systemSizeWithoutConstraintID) +
-				A.block(0, 0, systemSizeWithoutConstraintID, problemSize) * initialGuessAndSolution;
+		m_rhsEnforcedLocalSystem.head(systemSizeWithoutConstraintID) = b.head(systemSizeWithoutConstraintID);
+		m_rhsEnforcedLocalSystem.head(systemSizeWithoutConstraintID).noalias() +=
+			A.topRows(systemSizeWithoutConstraintID) * initialGuessAndSolution;
 		m_lhsEnforcedLocalSystem.block(0, 0, systemSizeWithoutConstraintID, systemSizeWithoutConstraintID) =
-			A.block(0, 0, systemSizeWithoutConstraintID, systemSizeWithoutConstraintID);
+			denseBlock(A, 0, 0, systemSizeWithoutConstraintID, systemSizeWithoutConstraintID);
 
 		// Now we complete the contact matrix by adding the coupling constraint/{contact|sliding} and the compliance
 		// for {contact|sliding}
@@ -397,14 +513,14 @@ void MlcpGaussSeidelSolver::computeEnforcementSystem(
 				// Coupling part (fill up LHS and RHS)
 				m_rhsEnforcedLocalSystem[systemSizeWithoutConstraintID] =
 					b[matrixEntryForConstraintID] +
-					A.row(matrixEntryForConstraintID) * initialGuessAndSolution;
+					rowProduct(A, matrixEntryForConstraintID, initialGuessAndSolution);
 				m_lhsEnforcedLocalSystem.block(0, systemSizeWithoutConstraintID, systemSizeWithoutConstraintID, 1) =
-					A.block(0, matrixEntryForConstraintID, systemSizeWithoutConstraintID, 1);
+					denseBlock(A, 0, matrixEntryForConstraintID, systemSizeWithoutConstraintID, 1);
 				m_lhsEnforcedLocalSystem.block(systemSizeWithoutConstraintID, 0, 1, systemSizeWithoutConstraintID) =
-					A.block(matrixEntryForConstraintID, 0, 1, systemSizeWithoutConstraintID);
+					denseBlock(A, matrixEntryForConstraintID, 0, 1, systemSizeWithoutConstraintID);
 				// Compliance part for the {contact|sliding}
 				m_lhsEnforcedLocalSystem(systemSizeWithoutConstraintID, systemSizeWithoutConstraintID) =
-					A(matrixEntryForConstraintID, matrixEntryForConstraintID);
+					A.coeff(matrixEntryForConstraintID, matrixEntryForConstraintID);
 				break;
 			}
 
@@ -417,14 +533,14 @@ void MlcpGaussSeidelSolver::computeEnforcementSystem(
 				// Coupling part (fill up LHS and RHS)
 				m_rhsEnforcedLocalSystem.segment<2>(systemSizeWithoutConstraintID) =
 					b.segment<2>(matrixEntryForConstraintID) +
-					A.block(matrixEntryForConstraintID, 0, 2, problemSize) * initialGuessAndSolution;
+					rowsProduct<2>(A, matrixEntryForConstraintID, initialGuessAndSolution);
 				m_lhsEnforcedLocalSystem.block(0, systemSizeWithoutConstraintID, systemSizeWithoutConstraintID, 2) =
-					A.block(0, matrixEntryForConstraintID, systemSizeWithoutConstraintID, 2);
+					denseBlock(A, 0, matrixEntryForConstraintID, systemSizeWithoutConstraintID, 2);
 				m_lhsEnforcedLocalSystem.block(systemSizeWithoutConstraintID, 0, 2, systemSizeWithoutConstraintID) =
-					A.block(matrixEntryForConstraintID, 0, 2, systemSizeWithoutConstraintID);
+					denseBlock(A, matrixEntryForConstraintID, 0, 2, systemSizeWithoutConstraintID);
 				// Compliance part for the {contact|sliding}
 				m_lhsEnforcedLocalSystem.block(systemSizeWithoutConstraintID, systemSizeWithoutConstraintID, 2, 2) =
-					A.block(matrixEntryForConstraintID, matrixEntryForConstraintID, 2, 2);
+					denseBlock(A, matrixEntryForConstraintID, matrixEntryForConstraintID, 2, 2);
 				break;
 			}
 
@@ -433,14 +549,14 @@ void MlcpGaussSeidelSolver::computeEnforcementSystem(
 				// Coupling part (fill up LHS and RHS)
 				m_rhsEnforcedLocalSystem.segment<3>(systemSizeWithoutConstraintID) =
 					b.segment<3>(matrixEntryForConstraintID) +
-					A.block(matrixEntryForConstraintID, 0, 3, problemSize) * initialGuessAndSolution;
+					rowsProduct<3>(A, matrixEntryForConstraintID, initialGuessAndSolution);
 				m_lhsEnforcedLocalSystem.block(0, systemSizeWithoutConstraintID, systemSizeWithoutConstraintID, 3) =
-					A.block(0, matrixEntryForConstraintID, systemSizeWithoutConstraintID, 3);
+					denseBlock(A, 0, matrixEntryForConstraintID, systemSizeWithoutConstraintID, 3);
 				m_lhsEnforcedLocalSystem.block(systemSizeWithoutConstraintID, 0, 3, systemSizeWithoutConstraintID) =
-					A.block(matrixEntryForConstraintID, 0, 3, systemSizeWithoutConstraintID);
+					denseBlock(A, matrixEntryForConstraintID, 0, 3, systemSizeWithoutConstraintID);
 				// Compliance part for the {contact|sliding}
 				m_lhsEnforcedLocalSystem.block(systemSizeWithoutConstraintID, systemSizeWithoutConstraintID, 3, 3) =
-					A.block(matrixEntryForConstraintID, matrixEntryForConstraintID, 3, 3);
+					denseBlock(A, matrixEntryForConstraintID, matrixEntryForConstraintID, 3, 3);
 				break;
 			}
 
@@ -466,7 +582,8 @@ static inline void solveSystem(const MlcpProblem::Matrix& A, const MlcpProblem::
 	*x = solution;
 }
 
-void MlcpGaussSeidelSolver::doOneIteration(size_t problemSize, const MlcpProblem::Matrix& A,
+template <typename MatrixType>
+void MlcpGaussSeidelSolver::doOneIteration(size_t problemSize, const MatrixType& A,
 		const MlcpProblem::Vector& b,
 		MlcpSolution::Vector* initialGuessAndSolution,
 		const MlcpProblem::Vector& frictionCoefs,
@@ -492,8 +609,8 @@ void MlcpGaussSeidelSolver::doOneIteration(size_t problemSize, const MlcpProblem
 			case MLCP_BILATERAL_1D_CONSTRAINT:
 			{
 				(*initialGuessAndSolution)[currentAtomicIndex] -=
-					(b[currentAtomicIndex] + A.row(currentAtomicIndex) * (*initialGuessAndSolution)) /
-					A(currentAtomicIndex, currentAtomicIndex);
+					(b[currentAtomicIndex] + rowProduct(A, currentAtomicIndex, *initialGuessAndSolution)) /
+					A.coeff(currentAtomicIndex, currentAtomicIndex);
 				++currentAtomicIndex;
 				break;
 			}
@@ -501,9 +618,9 @@ void MlcpGaussSeidelSolver::doOneIteration(size_t problemSize, const MlcpProblem
 			case MLCP_BILATERAL_2D_CONSTRAINT:
 			{
 				(*initialGuessAndSolution).segment<2>(currentAtomicIndex) -=
-					A.block<2, 2>(currentAtomicIndex, currentAtomicIndex).inverse() *
+					fixedBlock<2, 2>(A, currentAtomicIndex, currentAtomicIndex).inverse() *
 					(b.segment<2>(currentAtomicIndex) +
-					 A.block(currentAtomicIndex, 0, 2, problemSize) * (*initialGuessAndSolution));
+					 rowsProduct<2>(A, currentAtomicIndex, *initialGuessAndSolution));
 				currentAtomicIndex += 2;
 				break;
 			}
@@ -511,9 +628,9 @@ void MlcpGaussSeidelSolver::doOneIteration(size_t problemSize, const MlcpProblem
 			case MLCP_BILATERAL_3D_CONSTRAINT:
 			{
 				(*initialGuessAndSolution).segment<3>(currentAtomicIndex) -=
-					A.block<3, 3>(currentAtomicIndex, currentAtomicIndex).inverse() *
+					fixedBlock<3, 3>(A, currentAtomicIndex, currentAtomicIndex).inverse() *
 					(b.segment<3>(currentAtomicIndex) +
-					 A.block(currentAtomicIndex, 0, 3, problemSize) * (*initialGuessAndSolution));
+					 rowsProduct<3>(A, currentAtomicIndex, *initialGuessAndSolution));
 				currentAtomicIndex += 3;
 				break;
 			}
@@ -566,9 +683,9 @@ void MlcpGaussSeidelSolver::doOneIteration(size_t problemSize, const MlcpProblem
 				{
 					// Compute the frictions violation
 					Ft -= 2.0 * (b.segment<2>(currentAtomicIndex + 1) +
-								 A.block(currentAtomicIndex + 1, 0, 2, problemSize) * (*initialGuessAndSolution)) /
-						  (A(currentAtomicIndex + 1, currentAtomicIndex + 1) +
-						   A(currentAtomicIndex + 2, currentAtomicIndex + 2));
+								 rowsProduct<2>(A, currentAtomicIndex + 1, *initialGuessAndSolution)) /
+						  (A.coeff(currentAtomicIndex + 1, currentAtomicIndex + 1) +
+						   A.coeff(currentAtomicIndex + 2, currentAtomicIndex + 2));
 
 					const double maxFriction = frictionCoefs[currentAtomicIndex] * Fn;
 					if (Ft.norm() > maxFriction)
@@ -628,8 +745,9 @@ void MlcpGaussSeidelSolver::doOneIteration(size_t problemSize, const MlcpProblem
 				{
 					// Complete the violation of the friction along t, with the missing terms...
 					double& Ft = (*initialGuessAndSolution)[currentAtomicIndex + 2];
-					Ft -= (b[currentAtomicIndex + 2] + A.row(currentAtomicIndex + 2) * (*initialGuessAndSolution)) /
-						  A(currentAtomicIndex + 2, currentAtomicIndex + 2);
+					Ft -= (b[currentAtomicIndex + 2] +
+						   rowProduct(A, currentAtomicIndex + 2, *initialGuessAndSolution)) /
+						  A.coeff(currentAtomicIndex + 2, currentAtomicIndex + 2);
 
 					const double maxFriction = frictionCoefs[currentAtomicIndex] * Fn.norm();
 					const double ftNorm = fabs(Ft);
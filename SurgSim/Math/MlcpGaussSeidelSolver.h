@@ -18,6 +18,8 @@
 
 #include <memory.h>
 
+#include <Eigen/Sparse>
+
 #include "SurgSim/Math/Matrix.h"
 #include "SurgSim/Math/MlcpProblem.h"
 #include "SurgSim/Math/MlcpSolver.h"
@@ -50,6 +52,11 @@ namespace Math
 /// See e.g.: Duriez, Christian; Dubois, F.; Kheddar, A.; Andriot, C., "Realistic haptic rendering of interacting
 /// deformable objects in virtual environments," <i>IEEE Transactions on Visualization and Computer Graphics,</i>
 /// vol.12, no.1, pp.36,47, Jan.-Feb. 2006.
+///
+/// The matrix \f$\mathbf{A}\f$ of physics problems is block sparse, constraints that do not share a representation
+/// are not coupled. When setUseSparseMatrix() is enabled the solver iterates on a compressed row copy of the matrix
+/// so that each Gauss-Seidel step only touches the non-zero blocks of a row. Problems that are already assembled as a
+/// sparse matrix (see MlcpProblem::isSparse()) are always solved on MlcpProblem::sparseA, without any copy.
 class MlcpGaussSeidelSolver : public MlcpSolver
 {
 public:
@@ -92,14 +99,36 @@ class MlcpGaussSeidelSolver : public MlcpSolver
 	/// \param maxIterations The max number of iterations.
 	void setMaxIterations(size_t maxIterations);
 
+	/// Set whether the solver should iterate on a sparse copy of the matrix A.
+	/// This is faster when the constraints are only coupled to a few other constraints.
+	/// \param useSparseMatrix true to use a sparse copy of A, false to use the dense A directly.
+	void setUseSparseMatrix(bool useSparseMatrix);
+
+	/// \return true if the solver iterates on a sparse copy of the matrix A.
+	bool isUsingSparseMatrix() const;
+
 private:
-	void computeEnforcementSystem(size_t problemSize, const MlcpProblem::Matrix& A,
+	/// The sparse matrix type used for the compressed row copy of A
+	typedef MlcpProblem::SparseMatrix SparseMatrix;
+
+	/// Run the Gauss Seidel iterations on a given representation of the matrix A of the problem
+	/// \tparam MatrixType Either MlcpProblem::Matrix or SparseMatrix
+	/// \param problem The mlcp problem
+	/// \param A The matrix of the problem, either problem.A, problem.sparseA or a sparse copy of problem.A
+	/// \param [out] solution The mlcp solution
+	/// \return true if successfully converged.
+	template <typename MatrixType>
+	bool doSolve(const MlcpProblem& problem, const MatrixType& A, MlcpSolution* solution);
+
+	template <typename MatrixType>
+	void computeEnforcementSystem(size_t problemSize, const MatrixType& A,
 								  const MlcpProblem::Vector& b,
 								  const MlcpSolution::Vector& initialGuessAndSolution,
 								  const std::vector<MlcpConstraintType>& constraintsType,
 								  size_t constraintID, size_t matrixEntryForConstraintID);
 
-	void calculateConvergenceCriteria(size_t problemSize, const MlcpProblem::Matrix& A,
+	template <typename MatrixType>
+	void calculateConvergenceCriteria(size_t problemSize, const MatrixType& A,
 									  const MlcpProblem::Vector& b,
 									  const MlcpSolution::Vector& initialGuessAndSolution,
 									  const std::vector<MlcpConstraintType>& constraintsType,
@@ -107,7 +136,8 @@ class MlcpGaussSeidelSolver : public MlcpSolver
 									  double* convergenceCriteria,
 									  bool* validSignorini);
 
-	void doOneIteration(size_t problemSize, const MlcpProblem::Matrix& A,
+	template <typename MatrixType>
+	void doOneIteration(size_t problemSize, const MatrixType& A,
 						const MlcpProblem::Vector& b,
 						MlcpSolution::Vector* initialGuessAndSolution,
 						const MlcpProblem::Vector& frictionCoefs,
@@ -140,6 +170,12 @@ class MlcpGaussSeidelSolver : public MlcpSolver
 	/// The right-hand side vector.
 	Vector m_rhsEnforcedLocalSystem;
 
+	/// Whether the sparse copy of A is used.
+	bool m_useSparseMatrix;
+
+	/// The compressed row copy of A, kept to reuse its storage from one solve to the next.
+	SparseMatrix m_sparseA;
+
 	/// The logger.
 	std::shared_ptr<SurgSim::Framework::Logger> m_logger;
 };
@@ -27,6 +27,7 @@ MlcpProblem::~MlcpProblem()
 void MlcpProblem::setZero(size_t numDof, size_t numConstraintDof, size_t numConstraints)
 {
 	A.setZero(numConstraintDof, numConstraintDof);
+	sparseA.resize(0, 0);
 	b.setZero(numConstraintDof);
 	mu.setZero(numConstraintDof);
 
@@ -18,6 +18,7 @@
 
 #include <vector>
 #include <Eigen/Core>
+#include <Eigen/SparseCore>
 #include "SurgSim/Math/MlcpConstraintType.h"
 
 
@@ -61,9 +62,13 @@ struct MlcpProblem
 
 	typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> Matrix;
 	typedef Eigen::Matrix<double, Eigen::Dynamic, 1> Vector;
+	typedef Eigen::SparseMatrix<double, Eigen::RowMajor> SparseMatrix;
 
 	/// Matrix \f$\mathbf{A}\f$ used to describe the mixed LCP problem.
+	/// Empty when the problem is described by sparseA instead.
 	Matrix A;
+	/// Compressed row storage of the matrix \f$\mathbf{A}\f$, used instead of A when A is empty (see isSparse()).
+	SparseMatrix sparseA;
 	/// Vector \f$b\f$ used to describe the mixed LCP problem.
 	Vector b;
 	/// A vector of friction coefficients used to describe the mixed LCP problem.
@@ -89,12 +94,20 @@ struct MlcpProblem
 		return (b.rows() >= 0) ? static_cast<size_t>(b.rows()) : 0;
 	}
 
+	/// \return true if the matrix \f$\mathbf{A}\f$ of the problem is stored in sparseA rather than in A.
+	bool isSparse() const
+	{
+		return (A.size() == 0) && (sparseA.rows() > 0);
+	}
+
 	/// Checks if the sizes of various elements of the system are consistent with each other.
 	/// \return true if consistent, false otherwise.
 	bool isConsistent() const
 	{
 		size_t numConstraintTypes = constraintTypes.size();
-		return ((b.rows() >= 0) && (b.cols() == 1) && (A.rows() == b.rows()) && (A.cols() == A.rows())
+		const Eigen::Index rows = isSparse() ? sparseA.rows() : A.rows();
+		const Eigen::Index cols = isSparse() ? sparseA.cols() : A.cols();
+		return ((b.rows() >= 0) && (b.cols() == 1) && (rows == b.rows()) && (cols == rows)
 				&& (numConstraintTypes <= static_cast<size_t>(b.rows())) && (mu.size() >= 0));
 	}
 
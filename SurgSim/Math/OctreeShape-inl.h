@@ -24,7 +24,9 @@ namespace Math
 
 template<class T>
 OctreeShape::OctreeShape(const SurgSim::DataStructures::OctreeNode<T>& node) :
-	m_rootNode(std::make_shared<OctreeShape::NodeType>(node))
+	m_rootNode(std::make_shared<OctreeShape::NodeType>(node)),
+	m_flatOctree(std::make_shared<FlatOctreeType>(m_rootNode)),
+	m_isFlatOctreeStale(false)
 {
 }
 
@@ -27,7 +27,9 @@ namespace Math
 SURGSIM_REGISTER(SurgSim::Math::Shape, SurgSim::Math::OctreeShape, OctreeShape);
 
 OctreeShape::OctreeShape() :
-	m_rootNode(std::make_shared<NodeType>())
+	m_rootNode(std::make_shared<NodeType>()),
+	m_flatOctree(std::make_shared<FlatOctreeType>(m_rootNode)),
+	m_isFlatOctreeStale(false)
 {
 	SURGSIM_ADD_SERIALIZABLE_PROPERTY(
 		SurgSim::Math::OctreeShape,
@@ -78,6 +80,8 @@ Matrix33d OctreeShape::getSecondMomentOfVolume() const
 
 std::shared_ptr<OctreeShape::NodeType> OctreeShape::getOctree()
 {
+	boost::lock_guard<boost::mutex> lock(m_flatOctreeMutex);
+	m_isFlatOctreeStale = true;
 	return m_rootNode;
 }
 
@@ -90,6 +94,26 @@ void OctreeShape::setOctree(std::shared_ptr<SurgSim::Framework::Asset> node)
 	SURGSIM_ASSERT(isValid(octreeNode))
 			<< "OctreeShape was passed an invalid Octree.";
 	m_rootNode = octreeNode;
+	updateFlatOctree();
+}
+
+std::shared_ptr<const OctreeShape::FlatOctreeType> OctreeShape::getFlatOctree() const
+{
+	boost::lock_guard<boost::mutex> lock(m_flatOctreeMutex);
+	if (m_isFlatOctreeStale)
+	{
+		m_flatOctree = std::make_shared<FlatOctreeType>(m_rootNode);
+		m_isFlatOctreeStale = false;
+	}
+	return m_flatOctree;
+}
+
+void OctreeShape::updateFlatOctree()
+{
+	auto flatOctree = std::make_shared<FlatOctreeType>(m_rootNode);
+	boost::lock_guard<boost::mutex> lock(m_flatOctreeMutex);
+	m_flatOctree = flatOctree;
+	m_isFlatOctreeStale = false;
 }
 
 bool OctreeShape::isValid(std::shared_ptr<NodeType> node) const
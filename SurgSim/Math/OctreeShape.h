@@ -16,7 +16,10 @@
 #ifndef SURGSIM_MATH_OCTREESHAPE_H
 #define SURGSIM_MATH_OCTREESHAPE_H
 
+#include <boost/thread/mutex.hpp>
+
 #include "SurgSim/DataStructures/EmptyData.h"
+#include "SurgSim/DataStructures/FlatOctree.h"
 #include "SurgSim/DataStructures/OctreeNode.h"
 #include "SurgSim/Framework/Asset.h"
 #include "SurgSim/Framework/ObjectFactory.h"
@@ -69,6 +72,8 @@ class OctreeShape : public Shape
 	Matrix33d getSecondMomentOfVolume() const override;
 
 	/// Get the root node
+	/// The octree can be edited through the returned node, so the linearized copy of the octree is rebuilt on the
+	/// next call to getFlatOctree().
 	/// \return the octree root node of this shape
 	std::shared_ptr<NodeType> getOctree();
 
@@ -76,6 +81,19 @@ class OctreeShape : public Shape
 	/// \param node the octree root node of this shape
 	void setOctree(std::shared_ptr<SurgSim::Framework::Asset> node);
 
+	/// Type of the linearized copy of the octree
+	typedef SurgSim::DataStructures::FlatOctree<SurgSim::DataStructures::EmptyData> FlatOctreeType;
+
+	/// Get the linearized copy of the octree, used for the collision queries
+	/// A new copy is built first if getOctree() was called since the last build, the copies returned earlier are
+	/// left untouched, so that concurrent queries can keep using them.
+	/// \return the flat octree of this shape
+	std::shared_ptr<const FlatOctreeType> getFlatOctree() const;
+
+	/// Rebuild the linearized copy of the octree, needs to be called after the octree was changed through a node kept
+	/// from an earlier call to getOctree(), e.g. by adding data or by activating or deactivating nodes.
+	void updateFlatOctree();
+
 	/// \return True if the bounding box is bigger than or equal to 0; Otherwise, false.
 	bool isValid() const override;
 
@@ -91,6 +109,15 @@ class OctreeShape : public Shape
 
 	/// Root node of the octree datastructure
 	std::shared_ptr<NodeType> m_rootNode;
+
+	/// Linearized copy of the octree, replaced by a new one on each rebuild
+	mutable std::shared_ptr<const FlatOctreeType> m_flatOctree;
+
+	/// Whether the octree may have been edited since m_flatOctree was built
+	mutable bool m_isFlatOctreeStale;
+
+	/// Mutex to replace m_flatOctree from concurrent collision queries
+	mutable boost::mutex m_flatOctreeMutex;
 };
 
 }; // Math
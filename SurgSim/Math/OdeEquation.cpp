@@ -15,6 +15,7 @@
 
 #include "SurgSim/Math/OdeEquation.h"
 #include "SurgSim/Math/OdeState.h"
+#include "SurgSim/Framework/Assert.h"
 #include "SurgSim/Framework/Log.h"
 
 namespace SurgSim
@@ -78,6 +79,71 @@ void OdeEquation::updateFMDK(const OdeState& state, int options)
 	}
 }
 
+bool OdeEquation::hasDiagonalMass() const
+{
+	return false;
+}
+
+const Vector& OdeEquation::getLumpedMass() const
+{
+	static const Vector empty;
+	return empty;
+}
+
+void OdeEquation::updateMatrixFreeFMDK(const OdeState& state)
+{
+	updateFMDK(state, ODEEQUATIONUPDATE_FMDK);
+}
+
+void OdeEquation::applyMDK(double alphaM, double alphaD, double alphaK, const Vector& x, Vector* result)
+{
+	result->setZero(x.size());
+	if (alphaM != 0.0)
+	{
+		*result += alphaM * (m_M * x);
+	}
+	if (alphaD != 0.0)
+	{
+		*result += alphaD * (m_D * x);
+	}
+	if (alphaK != 0.0)
+	{
+		*result += alphaK * (m_K * x);
+	}
+}
+
+void OdeEquation::computeMDKDiagonalBlocks(double alphaM, double alphaD, double alphaK, size_t blockSize,
+		Matrix* blocks)
+{
+	SURGSIM_ASSERT(blockSize > 0 && static_cast<size_t>(m_M.rows()) % blockSize == 0)
+		<< "Cannot split a matrix of size " << m_M.rows() << " in blocks of size " << blockSize;
+
+	blocks->setZero(m_M.rows(), static_cast<Matrix::Index>(blockSize));
+	addDiagonalBlocks(m_M, alphaM, blocks);
+	addDiagonalBlocks(m_D, alphaD, blocks);
+	addDiagonalBlocks(m_K, alphaK, blocks);
+}
+
+void OdeEquation::addDiagonalBlocks(const SparseMatrix& matrix, double alpha, Matrix* blocks)
+{
+	if (alpha == 0.0)
+	{
+		return;
+	}
+
+	const SparseMatrix::Index blockSize = blocks->cols();
+	for (SparseMatrix::Index outer = 0; outer < matrix.outerSize(); ++outer)
+	{
+		for (SparseMatrix::InnerIterator it(matrix, outer); it; ++it)
+		{
+			if (it.row() / blockSize == it.col() / blockSize)
+			{
+				(*blocks)(it.row(), it.col() % blockSize) += alpha * it.value();
+			}
+		}
+	}
+}
+
 }; // namespace Math
 
 }; // namespace SurgSim
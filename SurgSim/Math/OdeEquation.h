@@ -86,6 +86,37 @@ class OdeEquation
 	/// \return The matrix \f$K = -\frac{\partial f}{\partial x}(x,v)\f$
 	const SparseMatrix& getK() const;
 
+	/// \return True if the mass matrix \f$M\f$ is diagonal (i.e. lumped), so the systems only made of \f$M\f$ can be
+	/// solved with LinearSparseSolveAndInverseDiagonal, false otherwise (default)
+	virtual bool hasDiagonalMass() const;
+
+	/// \return The diagonal of the mass matrix \f$M\f$ if it is diagonal (see hasDiagonalMass()), which is constant
+	/// and does not need any update, empty otherwise (default)
+	virtual const Vector& getLumpedMass() const;
+
+	/// Update the OdeEquation for a matrix free resolution based on the given state, \f$f(x, v)\f$ is computed along
+	/// with whatever applyMDK() and computeMDKDiagonalBlocks() need, the matrices do not need to be assembled.
+	/// \param state \f$(x, v)\f$ the current position and velocity to evaluate the various terms with
+	/// \note The default implementation updates and assembles all the terms, see updateFMDK()
+	virtual void updateMatrixFreeFMDK(const OdeState& state);
+
+	/// Calculate the product \f$(\alpha_M.M + \alpha_D.D + \alpha_K.K).x\f$ for the latest update
+	/// \param alphaM, alphaD, alphaK The factors of the mass, damping and stiffness matrices
+	/// \param x The vector to multiply
+	/// \param[out] result The product, it cannot be x
+	/// \note The default implementation uses the assembled matrices, equations that can do the product without them
+	/// should override this method along with updateMatrixFreeFMDK()
+	virtual void applyMDK(double alphaM, double alphaD, double alphaK, const Vector& x, Vector* result);
+
+	/// Calculate the diagonal blocks of \f$(\alpha_M.M + \alpha_D.D + \alpha_K.K)\f$ for the latest update, used to
+	/// precondition the matrix free resolutions
+	/// \param alphaM, alphaD, alphaK The factors of the mass, damping and stiffness matrices
+	/// \param blockSize The size of the blocks, typically the number of dof per node
+	/// \param[out] blocks The diagonal blocks stacked vertically, a (numDof x blockSize) matrix
+	/// \note The default implementation uses the assembled matrices
+	virtual void computeMDKDiagonalBlocks(double alphaM, double alphaD, double alphaK, size_t blockSize,
+										  Matrix* blocks);
+
 protected:
 	/// Evaluation of the RHS function \f$f(x, v)\f$ for a given state
 	/// \param state \f$(x, v)\f$ the current position and velocity to evaluate the function \f$f(x,v)\f$ with
@@ -110,6 +141,12 @@ class OdeEquation
 	/// \note computeF(), computeM(), computeD(), computeK()
 	virtual void computeFMDK(const OdeState& state) = 0;
 
+	/// Helper method adding the diagonal blocks of a matrix to the diagonal blocks of computeMDKDiagonalBlocks()
+	/// \param matrix The matrix
+	/// \param alpha The factor of the matrix
+	/// \param[in,out] blocks The diagonal blocks stacked vertically, their size is the number of columns
+	static void addDiagonalBlocks(const SparseMatrix& matrix, double alpha, Matrix* blocks);
+
 	/// The initial state (which defines the ODE initial conditions \f$(x0, v0)\f$)
 	/// \note MUST be set by the derived classes
 	std::shared_ptr<OdeState> m_initialState;
@@ -22,7 +22,7 @@ namespace SurgSim
 namespace Math
 {
 
-OdeSolver::OdeSolver(OdeEquation* equation) : m_equation(*equation)
+OdeSolver::OdeSolver(OdeEquation* equation) : m_equation(*equation), m_isComplianceComputed(false)
 {
 	// Default linear solver
 	setLinearSolver(std::make_shared<LinearSparseSolveAndInverseLU>());
@@ -75,6 +75,38 @@ void OdeSolver::computeComplianceMatrixFromSystemMatrix(const OdeState& state)
 	state.applyBoundaryConditionsToMatrix(&m_complianceMatrix, false);
 }
 
+bool OdeSolver::setDiagonalLinearSystem(double dt, const OdeState& state)
+{
+	auto diagonalSolver = dynamic_cast<LinearSparseSolveAndInverseDiagonal*>(m_linearSolver.get());
+	if (diagonalSolver == nullptr || !m_equation.hasDiagonalMass())
+	{
+		return false;
+	}
+
+	m_equation.updateFMDK(state, ODEEQUATIONUPDATE_F);
+
+	// The boundary conditions replace their rows and columns with the identity, as in applyBoundaryConditionsToMatrix
+	m_systemDiagonal = m_equation.getLumpedMass() / dt;
+	for (auto dof : state.getBoundaryConditions())
+	{
+		m_systemDiagonal[dof] = 1.0;
+	}
+	diagonalSolver->setDiagonal(m_systemDiagonal);
+
+	m_rhs = m_equation.getF();
+	state.applyBoundaryConditionsToVector(&m_rhs);
+	return true;
+}
+
+void OdeSolver::computeConstantComplianceIfNeeded(const OdeState& state, bool computeCompliance)
+{
+	if (computeCompliance && !m_isComplianceComputed)
+	{
+		computeComplianceMatrixFromSystemMatrix(state);
+		m_isComplianceComputed = true;
+	}
+}
+
 }; // namespace Math
 
 }; // namespace SurgSim
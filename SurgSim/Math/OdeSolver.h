@@ -103,6 +103,10 @@ class OdeSolver
 	/// \param currentState State at time t
 	/// \param[out] newState State at time t+dt
 	/// \param computeCompliance True to explicitly compute the compliance matrix, False otherwise
+	/// \note The Linear solvers (e.g. OdeSolverLinearEulerExplicit) assume that the system matrix is constant, they
+	/// only assemble and factorize it on the first call. The compliance matrix being constant as well, it is only
+	/// computed on the first call with computeCompliance set to true, and then used in the following calls no matter
+	/// what the parameter value is.
 	virtual void solve(double dt, const OdeState& currentState, OdeState* newState, bool computeCompliance = true) = 0;
 
 	/// Computes the system and compliance matrices for a given state
@@ -135,6 +139,21 @@ class OdeSolver
 	/// \note This method supposes that the linear solver has been updated with the current m_systemMatrix.
 	void computeComplianceMatrixFromSystemMatrix(const OdeState& state);
 
+	/// Helper method for the solvers with a constant system matrix, computing the compliance matrix only on the first
+	/// call requesting it (see solve())
+	/// \param state The state describing the boundary conditions
+	/// \param computeCompliance True if the compliance matrix is requested, False otherwise
+	void computeConstantComplianceIfNeeded(const OdeState& state, bool computeCompliance);
+
+	/// Helper method for the explicit solvers, whose system matrix is M/dt. If the mass matrix is diagonal and the
+	/// linear solver is a LinearSparseSolveAndInverseDiagonal, only the force is evaluated and the linear solver is
+	/// given the diagonal of the system matrix, neither the mass matrix nor the system matrix is assembled.
+	/// \param dt The time step
+	/// \param state The state to evaluate the force with, describing the boundary conditions
+	/// \return True if the linear solver and the rhs vector m_rhs are set, False if the linear system needs to be
+	/// 	assembled with assembleLinearSystem()
+	bool setDiagonalLinearSystem(double dt, const OdeState& state);
+
 	/// Name for this solver
 	/// \note MUST be set by the derived classes
 	std::string m_name;
@@ -154,8 +173,14 @@ class OdeSolver
 	/// Linear system solution and rhs vectors (including boundary conditions)
 	Vector m_solution, m_rhs;
 
+	/// Diagonal of the system matrix, when it is set without being assembled (see setDiagonalLinearSystem())
+	Vector m_systemDiagonal;
+
 	/// Compliance matrix which is the inverse of the system matrix, including boundary conditions
 	Matrix m_complianceMatrix;
+
+	/// True once the compliance matrix of a constant system matrix has been computed
+	bool m_isComplianceComputed;
 };
 
 }; // namespace Math
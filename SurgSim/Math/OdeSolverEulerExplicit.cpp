@@ -39,11 +39,14 @@ void OdeSolverEulerExplicit::solve(double dt, const OdeState& currentState, OdeS
 	//   systemMatrix . solution = rhs
 	// Therefore, systemMatrix = M/dt, solution = deltaV and rhs = f
 
-	// Assemble the linear system systemMatrix.solution = rhs
-	assembleLinearSystem(dt, currentState, *newState);
+	// Assemble the linear system systemMatrix.solution = rhs, with a diagonal mass the system is only a scaling
+	if (!setDiagonalLinearSystem(dt, currentState))
+	{
+		assembleLinearSystem(dt, currentState, *newState);
+	}
 
-	// Solve the linear system to find solution = deltaV
-	m_solution = m_linearSolver->solve(m_rhs);
+	// Solve the linear system to find solution = deltaV (i.e. dt.f/m with a diagonal mass)
+	m_linearSolver->solve(m_rhs, &m_solution);
 
 	// Compute the new state using the Euler Explicit scheme:
 	newState->getPositions()  = currentState.getPositions()  + dt * currentState.getVelocities();
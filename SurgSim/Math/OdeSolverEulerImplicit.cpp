@@ -13,6 +13,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "SurgSim/Framework/Assert.h"
+#include "SurgSim/Framework/Log.h"
 #include "SurgSim/Math/OdeSolverEulerImplicit.h"
 #include "SurgSim/Math/OdeState.h"
 
@@ -23,7 +25,10 @@ namespace Math
 {
 
 OdeSolverEulerImplicit::OdeSolverEulerImplicit(OdeEquation* equation)
-	: OdeSolver(equation), m_maximumIteration(1), m_epsilonConvergence(1e-5)
+	: OdeSolver(equation), m_maximumIteration(1), m_epsilonConvergence(1e-5), m_matrixFree(false),
+	  m_matrixFreeDt(0.0), m_modifiedNewton(false), m_stallRatio(0.5), m_maximumReuse(20),
+	  m_isFactorizationValid(false), m_factorizationDt(0.0), m_factorizationLinearSolver(nullptr), m_numReuse(0),
+	  m_isComplianceUpToDate(false), m_numIterations(0), m_numFactorizations(0), m_residual(0.0)
 {
 	m_name = "Ode Solver Euler Implicit";
 }
@@ -52,6 +57,106 @@ double OdeSolverEulerImplicit::getNewtonRaphsonEpsilonConvergence() const
 	return m_epsilonConvergence;
 }
 
+void OdeSolverEulerImplicit::setMatrixFree(bool matrixFree)
+{
+	m_matrixFree = matrixFree;
+}
+
+bool OdeSolverEulerImplicit::isMatrixFree() const
+{
+	return m_matrixFree;
+}
+
+void OdeSolverEulerImplicit::setMatrixFreeMaximumIteration(size_t maximumIteration)
+{
+	m_conjugateGradient.setMaxIterations(maximumIteration);
+}
+
+size_t OdeSolverEulerImplicit::getMatrixFreeMaximumIteration() const
+{
+	return m_conjugateGradient.getMaxIterations();
+}
+
+void OdeSolverEulerImplicit::setMatrixFreeTolerance(double tolerance)
+{
+	m_conjugateGradient.setTolerance(tolerance);
+}
+
+double OdeSolverEulerImplicit::getMatrixFreeTolerance() const
+{
+	return m_conjugateGradient.getTolerance();
+}
+
+const PreconditionedConjugateGradient& OdeSolverEulerImplicit::getMatrixFreeSolver() const
+{
+	return m_conjugateGradient;
+}
+
+void OdeSolverEulerImplicit::solveMatrixFree(const OdeState& state, const Matrix& b, Matrix* x)
+{
+	SURGSIM_ASSERT(m_matrixFree) << getName() << " does not use the matrix free mode";
+	SURGSIM_ASSERT(m_matrixFreeDt > 0.0) << getName() <<
+		" has not solved any matrix free system yet, call solve() first";
+	SURGSIM_ASSERT(b.rows() == static_cast<Matrix::Index>(state.getNumDof())) << "The right hand side has " <<
+		b.rows() << " rows, the state has " << state.getNumDof() << " dof";
+
+	x->resize(b.rows(), b.cols());
+	for (Matrix::Index column = 0; column < b.cols(); ++column)
+	{
+		m_matrixFreeRhs = b.col(column);
+		state.applyBoundaryConditionsToVector(&m_matrixFreeRhs);
+		m_matrixFreeSolution.setZero(m_matrixFreeRhs.size());
+		solveMatrixFreeSystem(state, m_matrixFreeRhs, &m_matrixFreeSolution);
+		x->col(column) = m_matrixFreeSolution;
+	}
+}
+
+void OdeSolverEulerImplicit::setModifiedNewton(bool modifiedNewton)
+{
+	m_modifiedNewton = modifiedNewton;
+}
+
+bool OdeSolverEulerImplicit::isModifiedNewton() const
+{
+	return m_modifiedNewton;
+}
+
+void OdeSolverEulerImplicit::setModifiedNewtonStallRatio(double ratio)
+{
+	SURGSIM_ASSERT(ratio > 0.0) << "The stall ratio needs to be positive";
+	m_stallRatio = ratio;
+}
+
+double OdeSolverEulerImplicit::getModifiedNewtonStallRatio() const
+{
+	return m_stallRatio;
+}
+
+void OdeSolverEulerImplicit::setModifiedNewtonMaximumReuse(size_t maximumReuse)
+{
+	m_maximumReuse = maximumReuse;
+}
+
+size_t OdeSolverEulerImplicit::getModifiedNewtonMaximumReuse() const
+{
+	return m_maximumReuse;
+}
+
+size_t OdeSolverEulerImplicit::getNumNewtonRaphsonIterations() const
+{
+	return m_numIterations;
+}
+
+size_t OdeSolverEulerImplicit::getNumFactorizations() const
+{
+	return m_numFactorizations;
+}
+
+double OdeSolverEulerImplicit::getNewtonRaphsonResidual() const
+{
+	return m_residual;
+}
+
 void OdeSolverEulerImplicit::solve(double dt, const OdeState& currentState, OdeState* newState, bool computeCompliance)
 {
 	// General equation to solve:
@@ -72,12 +177,23 @@ void OdeSolverEulerImplicit::solve(double dt, const OdeState& currentState, OdeS
 	// this non-linear problem. Note that each iteration will re-evaluate the complete system (forces and matrices).
 	// Also note that this method converges quadratically around the root. In our case, the solution is deltaV, which
 	// should be close to 0. This makes our problem well suited for this method.
+	// In the modified Newton mode, the iterations only re-evaluate the rhs and reuse the factorized system matrix, the
+	// convergence is then linear, the system matrix being factorized again if the convergence stalls. As the reused
+	// system matrix can be arbitrarily stale, the residual of the final estimate is checked, and an iteration with a
+	// new factorization is added if it has not decreased enough.
 
 	if (m_maximumIteration > 1)
 	{
 		m_previousSolution = Vector::Zero(currentState.getNumDof());
 	}
 
+	m_numIterations = 0;
+	m_numFactorizations = 0;
+	m_residual = 0.0;
+	double previousSolutionNorm = 0.0;
+	double initialResidual = 0.0;
+	bool isReusingFactorization = false;
+
 	// Prepare the newState to be used in the loop, it starts as the current state.
 	*newState = currentState;
 
@@ -88,16 +204,42 @@ void OdeSolverEulerImplicit::solve(double dt, const OdeState& currentState, OdeS
 	size_t numIteration = 0;
 	while (numIteration < m_maximumIteration)
 	{
-		// Assemble the linear system systemMatrix*solution = rhs
-		assembleLinearSystem(dt, currentState, *newState);
+		isReusingFactorization = false;
+		if (m_matrixFree)
+		{
+			// Solve the linear system systemMatrix*solution = rhs without assembling systemMatrix
+			solveMatrixFreeLinearSystem(dt, currentState, *newState);
+		}
+		else if (m_modifiedNewton && canReuseFactorization(dt, currentState))
+		{
+			isReusingFactorization = true;
+			// Only evaluate the rhs, the factorized systemMatrix is reused
+			m_equation.updateFMDK(*newState, ODEEQUATIONUPDATE_F | ODEEQUATIONUPDATE_M);
+			computeRhs(dt, currentState, *newState);
+			m_numReuse++;
 
-		// Solve the linear system to find solution = deltaV
-		m_solution = m_linearSolver->solve(m_rhs);
+			m_solution = m_linearSolver->solve(m_rhs);
+		}
+		else
+		{
+			// Assemble the linear system systemMatrix*solution = rhs
+			assembleLinearSystem(dt, currentState, *newState);
+
+			// Solve the linear system to find solution = deltaV
+			m_solution = m_linearSolver->solve(m_rhs);
+		}
+		m_residual = m_rhs.lpNorm<Eigen::Infinity>();
+		if (numIteration == 0)
+		{
+			initialResidual = m_residual;
+		}
 
 		// Compute the new state using the Euler Implicit scheme:
 		newState->getVelocities() += m_solution;
 		newState->getPositions()  = currentState.getPositions() + dt * newState->getVelocities();
 
+		numIteration++;
+
 		if (m_maximumIteration > 1)
 		{
 			// Use the infinity norm, to treat models with small or large number of dof the same way.
@@ -109,15 +251,56 @@ void OdeSolverEulerImplicit::solve(double dt, const OdeState& currentState, OdeS
 			}
 
 			m_previousSolution = m_solution;
+
+			// The solutions of a converging modified Newton decrease geometrically, factorize the system matrix again
+			// for the next iteration if they do not decrease fast enough
+			const double solutionNorm = m_solution.lpNorm<Eigen::Infinity>();
+			if (m_modifiedNewton && numIteration > 1 && solutionNorm > m_stallRatio * previousSolutionNorm)
+			{
+				m_isFactorizationValid = false;
+			}
+			previousSolutionNorm = solutionNorm;
 		}
+	}
 
-		numIteration++;
+	// The stiffness of the reused system matrix can be far from the current one, e.g. with a single iteration per
+	// time step nothing else detects it, so the residual of the final estimate is evaluated. If it did not decrease
+	// enough, the system matrix is factorized again and one more iteration is done with it.
+	// The residuals also need to give a correction above the convergence criteria with the reused system matrix, an
+	// absolute floor scaled by the mass and the time step, so that a model at rest neither evaluates the equation
+	// again nor factorizes the system matrix.
+	if (isReusingFactorization && m_solution.lpNorm<Eigen::Infinity>() >= m_epsilonConvergence)
+	{
+		m_equation.updateFMDK(*newState, ODEEQUATIONUPDATE_F | ODEEQUATIONUPDATE_M);
+		computeRhs(dt, currentState, *newState);
+		if (m_rhs.lpNorm<Eigen::Infinity>() > m_stallRatio * initialResidual &&
+			m_linearSolver->solve(m_rhs).lpNorm<Eigen::Infinity>() >= m_epsilonConvergence)
+		{
+			assembleLinearSystem(dt, currentState, *newState);
+			m_solution = m_linearSolver->solve(m_rhs);
+			m_residual = m_rhs.lpNorm<Eigen::Infinity>();
+
+			newState->getVelocities() += m_solution;
+			newState->getPositions()  = currentState.getPositions() + dt * newState->getVelocities();
+
+			numIteration++;
+		}
 	}
+	m_numIterations = numIteration;
 
 	// The compliance matrix (if requested) is computed w.r.t. the latest state.
 	if (computeCompliance)
 	{
-		computeComplianceMatrixFromSystemMatrix(currentState);
+		if (m_matrixFree)
+		{
+			// The system matrix has not been assembled by the iterations
+			assembleLinearSystem(dt, currentState, *newState, false);
+		}
+		if (!m_modifiedNewton || !m_isComplianceUpToDate)
+		{
+			computeComplianceMatrixFromSystemMatrix(currentState);
+			m_isComplianceUpToDate = true;
+		}
 	}
 }
 
@@ -142,7 +325,6 @@ void OdeSolverEulerImplicit::assembleLinearSystem(double dt, const OdeState& sta
 	const SparseMatrix& M = m_equation.getM();
 	const SparseMatrix& D = m_equation.getD();
 	const SparseMatrix& K = m_equation.getK();
-	const Vector& f = m_equation.getF();
 
 	// Computes the LHS systemMatrix
 	m_systemMatrix  = M * (1.0 / dt);
@@ -153,15 +335,100 @@ void OdeSolverEulerImplicit::assembleLinearSystem(double dt, const OdeState& sta
 	// Feed the systemMatrix to the linear solver, so it can be used after this call to solve or inverse the matrix
 	m_linearSolver->setMatrix(m_systemMatrix);
 
+	m_isFactorizationValid = true;
+	m_factorizationDt = dt;
+	m_factorizationBoundaryConditions = state.getBoundaryConditions();
+	m_factorizationLinearSolver = m_linearSolver.get();
+	m_numReuse = 0;
+	m_isComplianceUpToDate = false;
+	m_numFactorizations++;
+
 	// Computes the RHS vector by adding the Euler Implicit/Newton-Raphson terms
 	if (computeRHS)
 	{
-		m_rhs = f + K * (newState.getPositions() - state.getPositions() - newState.getVelocities() * dt);
-		m_rhs -= (M * (newState.getVelocities() - state.getVelocities())) / dt;
-		state.applyBoundaryConditionsToVector(&m_rhs);
+		computeRhs(dt, state, newState);
 	}
 }
 
+void OdeSolverEulerImplicit::computeRhs(double dt, const OdeState& state, const OdeState& newState)
+{
+	const SparseMatrix& M = m_equation.getM();
+	const SparseMatrix& K = m_equation.getK();
+	const Vector& f = m_equation.getF();
+
+	m_rhs = f + K * (newState.getPositions() - state.getPositions() - newState.getVelocities() * dt);
+	m_rhs -= (M * (newState.getVelocities() - state.getVelocities())) / dt;
+	state.applyBoundaryConditionsToVector(&m_rhs);
+}
+
+bool OdeSolverEulerImplicit::canReuseFactorization(double dt, const OdeState& state) const
+{
+	return m_isFactorizationValid && m_numReuse < m_maximumReuse && m_factorizationDt == dt &&
+		   m_factorizationLinearSolver == m_linearSolver.get() &&
+		   m_factorizationBoundaryConditions == state.getBoundaryConditions();
+}
+
+void OdeSolverEulerImplicit::solveMatrixFreeLinearSystem(double dt, const OdeState& state, const OdeState& newState)
+{
+	// Same linear system as the one of assembleLinearSystem(), the products with M, D and K are done by the equation:
+	//  (M/dt + D + dt.K) . deltaV = f + K.(x_n - x(t) - dt.v_n) - M.(v_n - v(t))/dt
+	m_equation.updateMatrixFreeFMDK(newState);
+
+	m_temporary = newState.getPositions() - state.getPositions() - newState.getVelocities() * dt;
+	m_equation.applyMDK(0.0, 0.0, 1.0, m_temporary, &m_rhs);
+	m_rhs += m_equation.getF();
+	m_temporary = newState.getVelocities() - state.getVelocities();
+	m_equation.applyMDK(1.0 / dt, 0.0, 0.0, m_temporary, &m_solution);
+	m_rhs -= m_solution;
+	state.applyBoundaryConditionsToVector(&m_rhs);
+
+	// Block Jacobi preconditioner, one block per node
+	m_matrixFreeDt = dt;
+	const std::vector<size_t>& boundaryConditions = state.getBoundaryConditions();
+	const size_t blockSize = (state.getNumNodes() > 0) ? state.getNumDof() / state.getNumNodes() : 1;
+	m_equation.computeMDKDiagonalBlocks(1.0 / dt, 1.0, dt, blockSize, &m_diagonalBlocks);
+	for (auto dof : boundaryConditions)
+	{
+		const Matrix::Index column = static_cast<Matrix::Index>(dof % blockSize);
+		m_diagonalBlocks.middleRows(static_cast<Matrix::Index>(dof - dof % blockSize), blockSize).col(column).setZero();
+		m_diagonalBlocks.row(dof).setZero();
+		m_diagonalBlocks(dof, column) = 1.0;
+	}
+	m_preconditioner.setBlocks(m_diagonalBlocks);
+
+	m_solution.setZero(state.getNumDof());
+	solveMatrixFreeSystem(state, m_rhs, &m_solution);
+}
+
+bool OdeSolverEulerImplicit::solveMatrixFreeSystem(const OdeState& state, const Vector& b, Vector* x)
+{
+	// The boundary conditions zero out the rows and columns of their dof, and set 1 on the diagonal
+	const double dt = m_matrixFreeDt;
+	const std::vector<size_t>& boundaryConditions = state.getBoundaryConditions();
+	auto systemMatrix = [this, dt, &state, &boundaryConditions](const Vector& x, Vector* result)
+	{
+		m_temporary = x;
+		state.applyBoundaryConditionsToVector(&m_temporary);
+		m_equation.applyMDK(1.0 / dt, 1.0, dt, m_temporary, result);
+		for (auto dof : boundaryConditions)
+		{
+			(*result)[dof] = x[dof];
+		}
+	};
+
+	auto preconditioner = [this](const Vector& x, Vector* result)
+	{
+		m_preconditioner.apply(x, result);
+	};
+
+	const bool converged = m_conjugateGradient.solve(systemMatrix, preconditioner, b, x);
+	SURGSIM_LOG_IF(!converged, SurgSim::Framework::Logger::getLogger("Math/OdeSolverEulerImplicit"), WARNING) <<
+		getName() << ": the conjugate gradient did not converge in " << m_conjugateGradient.getNumIterations() <<
+		" iterations, relative residual " << m_conjugateGradient.getRelativeResidual() << " > " <<
+		m_conjugateGradient.getTolerance();
+	return converged;
+}
+
 }; // namespace Math
 
 }; // namespace SurgSim
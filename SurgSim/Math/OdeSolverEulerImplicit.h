@@ -17,6 +17,7 @@
 #define SURGSIM_MATH_ODESOLVEREULERIMPLICIT_H
 
 #include "SurgSim/Math/OdeSolver.h"
+#include "SurgSim/Math/PreconditionedConjugateGradient.h"
 
 namespace SurgSim
 {
@@ -44,12 +45,98 @@ class OdeSolverEulerImplicit : public OdeSolver
 	/// \return The Newton-Raphson algorithm epsilon convergence
 	double getNewtonRaphsonEpsilonConvergence() const;
 
+	/// Set the matrix free mode, in which each Newton-Raphson iteration solves its linear system with a block Jacobi
+	/// preconditioned conjugate gradient, using OdeEquation::applyMDK() instead of the assembled system matrix.
+	/// \param matrixFree True to use the matrix free mode, False to assemble the system matrix (default)
+	/// \note The system matrix is only assembled when the compliance matrix is requested, the linear solver is not
+	/// updated otherwise. Use solveMatrixFree() to apply the compliance without assembling the system matrix.
+	/// \note A conjugate gradient solve not reaching the tolerance within its iteration budget logs a warning.
+	/// \note The system matrix needs to be symmetric positive definite, as it is for the FEM models.
+	void setMatrixFree(bool matrixFree);
+
+	/// \return True if the matrix free mode is used
+	bool isMatrixFree() const;
+
+	/// \param maximumIteration The iteration budget of the conjugate gradient for each linear system, in the matrix
+	/// 	free mode
+	void setMatrixFreeMaximumIteration(size_t maximumIteration);
+
+	/// \return The iteration budget of the conjugate gradient for each linear system, in the matrix free mode
+	size_t getMatrixFreeMaximumIteration() const;
+
+	/// \param tolerance The convergence tolerance of the conjugate gradient, relative to the norm of the rhs
+	void setMatrixFreeTolerance(double tolerance);
+
+	/// \return The convergence tolerance of the conjugate gradient, relative to the norm of the rhs
+	double getMatrixFreeTolerance() const;
+
+	/// \return The conjugate gradient used by the matrix free mode, holding the statistics of the latest solve
+	const PreconditionedConjugateGradient& getMatrixFreeSolver() const;
+
+	/// Solve the system matrix of the latest Newton-Raphson iteration, systemMatrix.x = b, with the preconditioned
+	/// conjugate gradient, without assembling it (in the matrix free mode). This applies the compliance to b, one
+	/// conjugate gradient solve per column.
+	/// \param state The state describing the boundary conditions, whose dof are zeroed in b and in the solution
+	/// \param b The right hand side, one system per column
+	/// \param [out] x The solution
+	/// \exception SurgSim::Framework::AssertionFailure If the matrix free mode is not used or if solve() has not been
+	/// called yet
+	void solveMatrixFree(const OdeState& state, const Matrix& b, Matrix* x);
+
+	/// Set the modified Newton mode, in which the factorized system matrix is reused by the following Newton-Raphson
+	/// iterations, and the following time steps, only the rhs being evaluated. The system matrix is assembled and
+	/// factorized again when the convergence stalls (see setModifiedNewtonStallRatio()), when the factorization has
+	/// been reused getModifiedNewtonMaximumReuse() times, or when the time step or the boundary conditions change.
+	/// When the last iteration of a time step reused the factorization, the residual of the final estimate is
+	/// evaluated, and if it is above getModifiedNewtonStallRatio() times the residual of the initial estimate (e.g.
+	/// because the stiffness changed), the system matrix is factorized again and one more iteration is done. Residuals
+	/// whose correction with the reused system matrix is below getNewtonRaphsonEpsilonConvergence() are not checked.
+	/// \param modifiedNewton True to use the modified Newton mode, False to use the full Newton-Raphson (default)
+	/// \note The compliance matrix (if requested) is computed from the reused system matrix, and only when it has
+	/// been factorized again.
+	/// \note This mode is ignored in the matrix free mode, which does not factorize the system matrix.
+	void setModifiedNewton(bool modifiedNewton);
+
+	/// \return True if the modified Newton mode is used
+	bool isModifiedNewton() const;
+
+	/// \param ratio The ratio of the infinity norms of 2 successive solutions above which the convergence is
+	/// 	considered stalled, and the system matrix is factorized again (in the modified Newton mode)
+	void setModifiedNewtonStallRatio(double ratio);
+
+	/// \return The ratio of the infinity norms of 2 successive solutions above which the convergence is considered
+	/// stalled (in the modified Newton mode)
+	double getModifiedNewtonStallRatio() const;
+
+	/// \param maximumReuse The maximum number of Newton-Raphson iterations a factorization is reused for, over
+	/// 	several time steps (in the modified Newton mode)
+	void setModifiedNewtonMaximumReuse(size_t maximumReuse);
+
+	/// \return The maximum number of Newton-Raphson iterations a factorization is reused for (in the modified Newton
+	/// mode)
+	size_t getModifiedNewtonMaximumReuse() const;
+
+	/// \return The number of Newton-Raphson iterations of the latest solve
+	size_t getNumNewtonRaphsonIterations() const;
+
+	/// \return The number of system matrix factorizations of the latest solve
+	size_t getNumFactorizations() const;
+
+	/// \return The infinity norm of the rhs of the last Newton-Raphson iteration of the latest solve, i.e. the
+	/// residual of the non-linear system for the estimate the iteration started from
+	double getNewtonRaphsonResidual() const;
+
 	void solve(double dt, const OdeState& currentState, OdeState* newState, bool computeCompliance = true) override;
 
 protected:
 	void assembleLinearSystem(double dt, const OdeState& state, const OdeState& newState,
 		bool computeRHS = true) override;
 
+	/// Compute the rhs of the linear system from the latest evaluation of the equation
+	/// \param dt The time step used in the system
+	/// \param state, newState The state and newState to be used to evaluate the system
+	void computeRhs(double dt, const OdeState& state, const OdeState& newState);
+
 	/// Newton-Raphson maximum number of iteration (1 => linearization)
 	size_t m_maximumIteration;
 
@@ -58,6 +145,59 @@ class OdeSolverEulerImplicit : public OdeSolver
 
 	/// Newton-Raphson previous solution (we solve a problem to find deltaV, the variation in velocity)
 	Vector m_previousSolution;
+
+private:
+	/// Assemble the rhs and the preconditioner for the matrix free mode, then solve the linear system
+	/// \param dt The time step used in the system
+	/// \param state, newState The state and newState to be used to evaluate the system
+	void solveMatrixFreeLinearSystem(double dt, const OdeState& state, const OdeState& newState);
+
+	/// Solve systemMatrix.x = b with the conjugate gradient and the current preconditioner, in the matrix free mode
+	/// \param state The state describing the boundary conditions, b needs to be zero on their dof
+	/// \param b The right hand side
+	/// \param [in,out] x The initial guess, the solution on return
+	/// \return True if the conjugate gradient converged, a warning being logged otherwise
+	bool solveMatrixFreeSystem(const OdeState& state, const Vector& b, Vector* x);
+
+	/// Is the matrix free mode used ?
+	bool m_matrixFree;
+
+	/// Conjugate gradient and its preconditioner, for the matrix free mode
+	PreconditionedConjugateGradient m_conjugateGradient;
+	BlockJacobiPreconditioner m_preconditioner;
+
+	/// Working data for the matrix free mode, the diagonal blocks of the system matrix and temporary vectors
+	Matrix m_diagonalBlocks;
+	Vector m_temporary, m_matrixFreeRhs, m_matrixFreeSolution;
+
+	/// The time step of the latest matrix free system, 0 if none has been solved yet
+	double m_matrixFreeDt;
+
+	/// \param dt The time step used in the system
+	/// \param state The state describing the boundary conditions
+	/// \return True if the factorized system matrix can be reused by the modified Newton mode
+	bool canReuseFactorization(double dt, const OdeState& state) const;
+
+	/// Is the modified Newton mode used ?
+	bool m_modifiedNewton;
+
+	/// Modified Newton stall ratio and maximum number of iterations a factorization is reused for
+	double m_stallRatio;
+	size_t m_maximumReuse;
+
+	/// The factorized system matrix: is it valid, its time step, boundary conditions and linear solver, the number of
+	/// iterations it has been reused for, and has the compliance matrix been computed from it ?
+	bool m_isFactorizationValid;
+	double m_factorizationDt;
+	std::vector<size_t> m_factorizationBoundaryConditions;
+	const LinearSparseSolveAndInverse* m_factorizationLinearSolver;
+	size_t m_numReuse;
+	bool m_isComplianceUpToDate;
+
+	/// Statistics of the latest solve
+	size_t m_numIterations;
+	size_t m_numFactorizations;
+	double m_residual;
 };
 
 }; // namespace Math
@@ -33,8 +33,7 @@ void OdeSolverLinearEulerExplicit::solve(double dt, const OdeState& currentState
 {
 	if (!m_initialized)
 	{
-		// The compliance matrix is constant and used in all following calls, so we force its calculation on 1st pass.
-		OdeSolverEulerExplicit::solve(dt, currentState, newState, true);
+		OdeSolverEulerExplicit::solve(dt, currentState, newState, false);
 		m_initialized = true;
 	}
 	else
@@ -47,6 +46,8 @@ void OdeSolverLinearEulerExplicit::solve(double dt, const OdeState& currentState
 		newState->getPositions()  = currentState.getPositions()  + dt * currentState.getVelocities();
 		newState->getVelocities() = currentState.getVelocities() + deltaV;
 	}
+
+	computeConstantComplianceIfNeeded(currentState, computeCompliance);
 }
 
 }; // namespace Math
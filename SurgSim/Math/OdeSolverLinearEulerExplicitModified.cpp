@@ -33,8 +33,7 @@ void OdeSolverLinearEulerExplicitModified::solve(double dt, const OdeState& curr
 {
 	if (!m_initialized)
 	{
-		// The compliance matrix is constant and used in all following calls, so we force its calculation on 1st pass.
-		OdeSolverEulerExplicitModified::solve(dt, currentState, newState, true);
+		OdeSolverEulerExplicitModified::solve(dt, currentState, newState, false);
 		m_initialized = true;
 	}
 	else
@@ -47,6 +46,8 @@ void OdeSolverLinearEulerExplicitModified::solve(double dt, const OdeState& curr
 		newState->getVelocities() = currentState.getVelocities() + deltaV;
 		newState->getPositions()  = currentState.getPositions()  + dt * newState->getVelocities();
 	}
+
+	computeConstantComplianceIfNeeded(currentState, computeCompliance);
 }
 
 }; // namespace Math
@@ -34,8 +34,7 @@ class OdeSolverLinearEulerExplicitModified : public OdeSolverEulerExplicitModifi
 	/// \param equation The ode equation to be solved
 	explicit OdeSolverLinearEulerExplicitModified(OdeEquation* equation);
 
-	/// The parameter computeCompliance is irrelevant for any Linear solver as it is a constant matrix.
-	/// It will be precomputed on the first call and use in the following calls, no matter what the parameter value is.
+	/// Solves with the constant system matrix of the first call, see OdeSolver::solve()
 	void solve(double dt, const OdeState& currentState, OdeState* newState, bool computeCompliance = true) override;
 
 private:
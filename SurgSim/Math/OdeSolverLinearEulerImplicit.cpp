@@ -13,6 +13,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "SurgSim/Framework/Assert.h"
 #include "SurgSim/Framework/Log.h"
 #include "SurgSim/Math/OdeSolverLinearEulerImplicit.h"
 #include "SurgSim/Math/OdeState.h"
@@ -43,10 +44,12 @@ void OdeSolverLinearEulerImplicit::setNewtonRaphsonMaximumIteration(size_t maxim
 void OdeSolverLinearEulerImplicit::solve(double dt, const OdeState& currentState, OdeState* newState,
 		bool computeCompliance)
 {
+	SURGSIM_ASSERT(!isMatrixFree()) << getName() << " solves with the constant compliance matrix, " <<
+		"it cannot be used in the matrix free mode.";
+
 	if (!m_initialized)
 	{
-		// The compliance matrix is constant and used in all following calls, so we force its calculation on 1st pass.
-		OdeSolverEulerImplicit::solve(dt, currentState, newState, true);
+		OdeSolverEulerImplicit::solve(dt, currentState, newState, false);
 		m_constantK = m_equation.getK();
 		m_initialized = true;
 	}
@@ -61,6 +64,8 @@ void OdeSolverLinearEulerImplicit::solve(double dt, const OdeState& currentState
 		newState->getVelocities() = currentState.getVelocities() + deltaV;
 		newState->getPositions()  = currentState.getPositions()  + dt * newState->getVelocities();
 	}
+
+	computeConstantComplianceIfNeeded(currentState, computeCompliance);
 }
 
 }; // namespace Math
@@ -40,8 +40,7 @@ class OdeSolverLinearEulerImplicit : public OdeSolverEulerImplicit
 
 	void setNewtonRaphsonMaximumIteration(size_t maximumIteration) override;
 
-	/// The parameter computeCompliance is irrelevant for any Linear solver as it is a constant matrix.
-	/// It will be precomputed on the first call and use in the following calls, no matter what the parameter value is.
+	/// Solves with the constant system matrix and stiffness matrix of the first call, see OdeSolver::solve()
 	void solve(double dt, const OdeState& currentState, OdeState* newState, bool computeCompliance = true) override;
 
 private:
@@ -34,8 +34,7 @@ void OdeSolverLinearRungeKutta4::solve(double dt, const OdeState& currentState,
 {
 	if (!m_initialized)
 	{
-		// The compliance matrix is constant and used in all following calls, so we force its calculation on 1st pass.
-		OdeSolverRungeKutta4::solve(dt, currentState, newState, true);
+		OdeSolverRungeKutta4::solve(dt, currentState, newState, false);
 		m_initialized = true;
 	}
 	else
@@ -55,38 +54,13 @@ void OdeSolverLinearRungeKutta4::solve(double dt, const OdeState& currentState,
 
 		// 1st evaluate k1 (note that y(n) is currentState)
 		m_k1.velocity = currentState.getVelocities();
-		// Reminder: m_complianceMatrix = dt.M^-1 (including 0 compliance for all boundary conditions)
-		m_equation.updateFMDK(currentState, ODEEQUATIONUPDATE_F);
-		m_k1.acceleration = m_equation.applyCompliance(currentState, m_equation.getF() / dt);
+		computeAcceleration(dt, currentState, &m_k1.acceleration);
 
-		// 2nd evaluate k2
-		newState->getPositions()  = currentState.getPositions()  + m_k1.velocity * dt / 2.0;
-		newState->getVelocities() = currentState.getVelocities() + m_k1.acceleration * dt / 2.0;
-		m_k2.velocity = newState->getVelocities();
-		m_equation.updateFMDK(*newState, ODEEQUATIONUPDATE_F);
-		m_k2.acceleration = m_equation.applyCompliance(*newState, m_equation.getF() / dt);
-
-		// 3rd evaluate k3
-		newState->getPositions()  = currentState.getPositions()  + m_k2.velocity * dt / 2.0;
-		newState->getVelocities() = currentState.getVelocities() + m_k2.acceleration * dt / 2.0;
-		m_k3.velocity = newState->getVelocities();
-		m_equation.updateFMDK(*newState, ODEEQUATIONUPDATE_F);
-		m_k3.acceleration = m_equation.applyCompliance(*newState, m_equation.getF() / dt);
-
-		// 4th evaluate k4
-		newState->getPositions()  = currentState.getPositions()  + m_k3.velocity * dt;
-		newState->getVelocities() = currentState.getVelocities() + m_k3.acceleration * dt;
-		m_k4.velocity = newState->getVelocities();
-		m_equation.updateFMDK(*newState, ODEEQUATIONUPDATE_F);
-		m_k4.acceleration = m_equation.applyCompliance(*newState, m_equation.getF() / dt);
-
-		// Compute the new state using Runge Kutta 4 integration scheme:
-		newState->getPositions()  = currentState.getPositions() +
-									(m_k1.velocity + m_k4.velocity + 2.0 * (m_k2.velocity + m_k3.velocity)) * dt / 6.0;
-		newState->getVelocities() = currentState.getVelocities() +
-									(m_k1.acceleration + m_k4.acceleration + 2.0 *
-									 (m_k2.acceleration + m_k3.acceleration)) * dt / 6.0;
+		// Then k2, k3, k4 and y(n+1)
+		integrateStages(dt, currentState, newState);
 	}
+
+	computeConstantComplianceIfNeeded(currentState, computeCompliance);
 }
 
 }; // namespace Math
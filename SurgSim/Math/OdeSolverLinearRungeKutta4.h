@@ -27,6 +27,8 @@ namespace Math
 /// Linear Version of the Runge Kutta 4 ode solver
 /// This solver assumes that the system is linear
 /// ie that Mass, Damping, and Stiffness matrices do not change.
+/// The mass matrix is factorized on the first call only, the following calls evaluate the 4 stages with this
+/// factorization, in place and without allocating any memory.
 class OdeSolverLinearRungeKutta4 : public OdeSolverRungeKutta4
 {
 public:
@@ -34,8 +36,7 @@ class OdeSolverLinearRungeKutta4 : public OdeSolverRungeKutta4
 	/// \param equation The ode equation to be solved
 	explicit OdeSolverLinearRungeKutta4(OdeEquation* equation);
 
-	/// The parameter computeCompliance is irrelevant for any Linear solver as it is a constant matrix.
-	/// It will be precomputed on the first call and use in the following calls, no matter what the parameter value is.
+	/// Evaluates the 4 stages with the constant system matrix of the first call, see OdeSolver::solve()
 	void solve(double dt, const OdeState& currentState, OdeState* newState, bool computeCompliance = true) override;
 
 private:
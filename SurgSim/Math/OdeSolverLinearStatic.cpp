@@ -32,7 +32,7 @@ void OdeSolverLinearStatic::solve(double dt, const OdeState& currentState, OdeSt
 {
 	if (!m_initialized)
 	{
-		OdeSolverStatic::solve(dt, currentState, newState, computeCompliance);
+		OdeSolverStatic::solve(dt, currentState, newState, false);
 		m_initialized = true;
 	}
 	else
@@ -47,6 +47,8 @@ void OdeSolverLinearStatic::solve(double dt, const OdeState& currentState, OdeSt
 		// Velocities are null in static mode (no time dependency)
 		newState->getVelocities().setZero();
 	}
+
+	computeConstantComplianceIfNeeded(currentState, computeCompliance);
 }
 
 }; // namespace Math
@@ -45,50 +45,60 @@ void OdeSolverRungeKutta4::solve(double dt, const OdeState& currentState, OdeSta
 	// with k3 = f(t(n) + dt/2, y(n) + k2 * dt/2)
 	// with k4 = f(t(n) + dt  , y(n) + k3 * dt  )
 
-	// Assemble the linear system systemMatrix.solution = rhs
-	assembleLinearSystem(dt, currentState, *newState);
+	// Assemble the linear system systemMatrix.solution = rhs, with a diagonal mass the system is only a scaling
+	if (!setDiagonalLinearSystem(dt, currentState))
+	{
+		assembleLinearSystem(dt, currentState, *newState);
+	}
 
-	// 1st evaluate k1 (note that y(n) is currentState)
+	// 1st evaluate k1 (note that y(n) is currentState), the force has been evaluated with the system matrix
 	m_k1.velocity = currentState.getVelocities();
-	m_k1.acceleration = m_linearSolver->solve(m_rhs / dt);
+	m_rhs /= dt;
+	m_linearSolver->solve(m_rhs, &m_k1.acceleration);
+
+	// Then k2, k3, k4 and y(n+1)
+	integrateStages(dt, currentState, newState);
+
+	if (computeCompliance)
+	{
+		computeComplianceMatrixFromSystemMatrix(currentState);
+	}
+}
 
+void OdeSolverRungeKutta4::computeAcceleration(double dt, const OdeState& state, Vector* acceleration)
+{
+	m_equation.updateFMDK(state, ODEEQUATIONUPDATE_F);
+	m_rhs = m_equation.getF();
+	state.applyBoundaryConditionsToVector(&m_rhs);
+	m_rhs /= dt;
+	m_linearSolver->solve(m_rhs, acceleration);
+}
+
+void OdeSolverRungeKutta4::integrateStages(double dt, const OdeState& currentState, OdeState* newState)
+{
 	// 2nd evaluate k2
-	newState->getPositions()  = currentState.getPositions()  + m_k1.velocity * dt / 2.0;
-	newState->getVelocities() = currentState.getVelocities() + m_k1.acceleration * dt / 2.0;
+	newState->getPositions()  = currentState.getPositions()  + m_k1.velocity * (dt / 2.0);
+	newState->getVelocities() = currentState.getVelocities() + m_k1.acceleration * (dt / 2.0);
 	m_k2.velocity = newState->getVelocities();
-	m_equation.updateFMDK(*newState, ODEEQUATIONUPDATE_F);
-	Vector f = m_equation.getF();
-	m_k2.acceleration =
-		m_linearSolver->solve(*currentState.applyBoundaryConditionsToVector(&f) / dt);
+	computeAcceleration(dt, *newState, &m_k2.acceleration);
 
 	// 3rd evaluate k3
-	newState->getPositions()  = currentState.getPositions()  + m_k2.velocity * dt / 2.0;
-	newState->getVelocities() = currentState.getVelocities() + m_k2.acceleration * dt / 2.0;
+	newState->getPositions()  = currentState.getPositions()  + m_k2.velocity * (dt / 2.0);
+	newState->getVelocities() = currentState.getVelocities() + m_k2.acceleration * (dt / 2.0);
 	m_k3.velocity = newState->getVelocities();
-	m_equation.updateFMDK(*newState, ODEEQUATIONUPDATE_F);
-	f = m_equation.getF();
-	m_k3.acceleration =
-		m_linearSolver->solve(*currentState.applyBoundaryConditionsToVector(&f) / dt);
+	computeAcceleration(dt, *newState, &m_k3.acceleration);
 
 	// 4th evaluate k4
 	newState->getPositions()  = currentState.getPositions()  + m_k3.velocity * dt;
 	newState->getVelocities() = currentState.getVelocities() + m_k3.acceleration * dt;
 	m_k4.velocity = newState->getVelocities();
-	m_equation.updateFMDK(*newState, ODEEQUATIONUPDATE_F);
-	f = m_equation.getF();
-	m_k4.acceleration =
-		m_linearSolver->solve(*currentState.applyBoundaryConditionsToVector(&f) / dt);
+	computeAcceleration(dt, *newState, &m_k4.acceleration);
 
 	// Compute the new state using Runge Kutta 4 integration scheme:
 	newState->getPositions()  = currentState.getPositions() +
-		(m_k1.velocity + m_k4.velocity + 2.0 * (m_k2.velocity + m_k3.velocity)) * dt / 6.0;
+		(m_k1.velocity + m_k4.velocity + 2.0 * (m_k2.velocity + m_k3.velocity)) * (dt / 6.0);
 	newState->getVelocities() = currentState.getVelocities() +
-		(m_k1.acceleration + m_k4.acceleration + 2.0 * (m_k2.acceleration + m_k3.acceleration)) * dt / 6.0;
-
-	if (computeCompliance)
-	{
-		computeComplianceMatrixFromSystemMatrix(currentState);
-	}
+		(m_k1.acceleration + m_k4.acceleration + 2.0 * (m_k2.acceleration + m_k3.acceleration)) * (dt / 6.0);
 }
 
 void OdeSolverRungeKutta4::assembleLinearSystem(double dt, const OdeState& state, const OdeState& newState,
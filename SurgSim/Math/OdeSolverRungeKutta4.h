@@ -52,6 +52,10 @@ namespace Math
 ///     \end{array}
 ///   \end{array}
 /// \f]
+/// The 4 evaluations are done in preallocated vectors and share the factorization of the mass matrix, a step does
+/// not allocate any memory once the sizes are set. With a diagonal (lumped) mass matrix and the linear solver
+/// LinearSparseSolveAndInverseDiagonal, the mass matrix is not assembled and each evaluation is a simple scaling of
+/// the force.
 class OdeSolverRungeKutta4 : public OdeSolver
 {
 public:
@@ -65,6 +69,18 @@ class OdeSolverRungeKutta4 : public OdeSolver
 	void assembleLinearSystem(double dt, const OdeState& state, const OdeState& newState,
 		bool computeRHS = true) override;
 
+	/// Evaluate the acceleration \f$M^{-1}.f(t, x, v)\f$ for a given state, with the latest mass matrix
+	/// \param dt The time step
+	/// \param state The state to evaluate the acceleration for
+	/// \param[out] acceleration The acceleration, including the boundary conditions
+	void computeAcceleration(double dt, const OdeState& state, Vector* acceleration);
+
+	/// Evaluate the stages k2, k3 and k4, from the stage k1, and compute the new state
+	/// \param dt The time step
+	/// \param currentState State at time t
+	/// \param[out] newState State at time t+dt
+	void integrateStages(double dt, const OdeState& currentState, OdeState* newState);
+
 	/// Internal structure to hold the 4 temporary evaluations
 	struct RungeKuttaDerivedState
 	{
@@ -17,6 +17,7 @@
 
 #include "SurgSim/DataStructures/AabbTree.h"
 #include "SurgSim/DataStructures/AabbTreeData.h"
+#include "SurgSim/DataStructures/FlatAabbTree.h"
 
 
 namespace SurgSim
@@ -35,7 +36,8 @@ ParticlesShape::ParticlesShape(double radius) :
 
 ParticlesShape::ParticlesShape(const ParticlesShape& other) :
 	DataStructures::Vertices<DataStructures::EmptyData>(other),
-	m_aabbTree(other.m_aabbTree),
+	m_aabbTree((other.m_aabbTree != nullptr) ?
+			   std::make_shared<DataStructures::FlatAabbTree>(*other.m_aabbTree) : nullptr),
 	m_radius(other.getRadius()),
 	m_center(other.getCenter()),
 	m_volume(other.getVolume()),
@@ -83,7 +85,8 @@ bool ParticlesShape::doUpdate()
 	const double numParticles = static_cast<double>(getVertices().size());
 	const Vector3d radius = Vector3d::Constant(m_radius);
 
-	std::list<DataStructures::AabbTreeData::Item> items;
+	std::vector<DataStructures::FlatAabbTree::Item> items;
+	items.reserve(getVertices().size());
 	Vector3d totalPosition = Vector3d::Zero();
 	Matrix33d totalDisplacementSkewSquared = Matrix33d::Zero();
 	size_t id = 0;
@@ -109,8 +112,11 @@ bool ParticlesShape::doUpdate()
 	m_secondMomentOfVolume = Matrix33d::Identity() * (2.0 / 5.0) * sphereVolume * m_radius * m_radius * numParticles;
 	m_secondMomentOfVolume -= sphereVolume * totalDisplacementSkewSquared;
 
-	m_aabbTree = std::make_shared<SurgSim::DataStructures::AabbTree>();
-	m_aabbTree->set(std::move(items));
+	if (m_aabbTree == nullptr)
+	{
+		m_aabbTree = std::make_shared<SurgSim::DataStructures::FlatAabbTree>();
+	}
+	m_aabbTree->update(items);
 
 	return true;
 }
@@ -123,11 +129,26 @@ std::shared_ptr<Shape> ParticlesShape::getTransformed(const RigidTransform3d& po
 	return transformed;
 }
 
-const std::shared_ptr<const SurgSim::DataStructures::AabbTree> ParticlesShape::getAabbTree() const
+const std::shared_ptr<const SurgSim::DataStructures::FlatAabbTree> ParticlesShape::getFlatAabbTree() const
 {
 	return m_aabbTree;
 }
 
+const std::shared_ptr<const SurgSim::DataStructures::AabbTree> ParticlesShape::getAabbTree() const
+{
+	const Vector3d radius = Vector3d::Constant(m_radius);
+	std::list<DataStructures::AabbTreeData::Item> items;
+	size_t id = 0;
+	for (auto const& vertex : getVertices())
+	{
+		items.emplace_back(SurgSim::Math::Aabbd(vertex.position - radius, vertex.position + radius), id++);
+	}
+
+	auto aabbTree = std::make_shared<SurgSim::DataStructures::AabbTree>();
+	aabbTree->set(std::move(items));
+	return aabbTree;
+}
+
 bool ParticlesShape::isTransformable() const
 {
 	return true;
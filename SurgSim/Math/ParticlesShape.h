@@ -30,6 +30,7 @@ namespace SurgSim
 namespace DataStructures
 {
 class AabbTree;
+class FlatAabbTree;
 };
 
 namespace Math
@@ -65,6 +66,12 @@ class ParticlesShape : public Shape, public SurgSim::DataStructures::Vertices<Da
 
 	/// Get the AabbTree
 	/// \return The object's associated AabbTree
+	const std::shared_ptr<const SurgSim::DataStructures::FlatAabbTree> getFlatAabbTree() const;
+
+	/// Get a pointer based AabbTree of the particles, kept for the existing users of this accessor
+	/// \note Deprecated, use getFlatAabbTree(). The shape does not keep this tree, a new one is built from the
+	/// 	current particles on every call.
+	/// \return A new AabbTree of the particles
 	const std::shared_ptr<const SurgSim::DataStructures::AabbTree> getAabbTree() const;
 
 	/// Set the particles' radius
@@ -95,7 +102,7 @@ class ParticlesShape : public Shape, public SurgSim::DataStructures::Vertices<Da
 	bool doUpdate() override;
 
 	/// The aabb tree of the ParticlesShape
-	std::shared_ptr<SurgSim::DataStructures::AabbTree> m_aabbTree;
+	std::shared_ptr<SurgSim::DataStructures::FlatAabbTree> m_aabbTree;
 
 	/// Particles' radius
 	double m_radius;
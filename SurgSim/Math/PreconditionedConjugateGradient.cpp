@@ -0,0 +1,169 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SurgSim/Math/PreconditionedConjugateGradient.h"
+
+#include <Eigen/LU>
+
+#include "SurgSim/Framework/Assert.h"
+
+namespace SurgSim
+{
+
+namespace Math
+{
+
+void BlockJacobiPreconditioner::setBlocks(const Matrix& blocks)
+{
+	const Matrix::Index blockSize = blocks.cols();
+	SURGSIM_ASSERT(blockSize > 0 && blocks.rows() % blockSize == 0) << "The diagonal blocks (" << blocks.rows() <<
+		"x" << blockSize << ") need to be square blocks stacked vertically";
+
+	m_inverseBlocks.resize(blocks.rows(), blockSize);
+	Eigen::FullPivLU<Matrix> lu(blockSize, blockSize);
+	for (Matrix::Index row = 0; row < blocks.rows(); row += blockSize)
+	{
+		lu.compute(blocks.middleRows(row, blockSize));
+		if (lu.isInvertible())
+		{
+			m_inverseBlocks.middleRows(row, blockSize) = lu.inverse();
+		}
+		else
+		{
+			m_inverseBlocks.middleRows(row, blockSize).setIdentity();
+		}
+	}
+}
+
+size_t BlockJacobiPreconditioner::getBlockSize() const
+{
+	return static_cast<size_t>(m_inverseBlocks.cols());
+}
+
+void BlockJacobiPreconditioner::apply(const Vector& x, Vector* result) const
+{
+	SURGSIM_ASSERT(x.size() == m_inverseBlocks.rows()) << "The preconditioner is of size " << m_inverseBlocks.rows() <<
+		", it cannot be applied to a vector of size " << x.size();
+
+	const Matrix::Index blockSize = m_inverseBlocks.cols();
+	result->resize(x.size());
+	for (Matrix::Index row = 0; row < x.size(); row += blockSize)
+	{
+		result->segment(row, blockSize).noalias() =
+			m_inverseBlocks.middleRows(row, blockSize) * x.segment(row, blockSize);
+	}
+}
+
+PreconditionedConjugateGradient::PreconditionedConjugateGradient() :
+	m_tolerance(1e-8),
+	m_maxIterations(100),
+	m_numIterations(0),
+	m_relativeResidual(0.0)
+{
+}
+
+void PreconditionedConjugateGradient::setTolerance(double tolerance)
+{
+	SURGSIM_ASSERT(tolerance >= 0.0) << "The tolerance cannot be negative";
+	m_tolerance = tolerance;
+}
+
+double PreconditionedConjugateGradient::getTolerance() const
+{
+	return m_tolerance;
+}
+
+void PreconditionedConjugateGradient::setMaxIterations(size_t maxIterations)
+{
+	SURGSIM_ASSERT(maxIterations >= 1) << "The iteration budget needs to be at least 1";
+	m_maxIterations = maxIterations;
+}
+
+size_t PreconditionedConjugateGradient::getMaxIterations() const
+{
+	return m_maxIterations;
+}
+
+bool PreconditionedConjugateGradient::solve(const Operator& matrix, const Operator& preconditioner, const Vector& b,
+		Vector* x)
+{
+	SURGSIM_ASSERT(x->size() == b.size()) << "The initial guess is of size " << x->size() <<
+		", the right hand side of size " << b.size();
+
+	m_numIterations = 0;
+	m_relativeResidual = 0.0;
+
+	const double bNorm = b.norm();
+	if (bNorm == 0.0)
+	{
+		x->setZero();
+		return true;
+	}
+
+	matrix(*x, &m_q);
+	m_r = b - m_q;
+	m_relativeResidual = m_r.norm() / bNorm;
+	if (m_relativeResidual <= m_tolerance)
+	{
+		return true;
+	}
+
+	preconditioner(m_r, &m_z);
+	m_p = m_z;
+	double rz = m_r.dot(m_z);
+
+	while (m_numIterations < m_maxIterations)
+	{
+		matrix(m_p, &m_q);
+		const double pq = m_p.dot(m_q);
+		if (pq <= 0.0)
+		{
+			// The matrix is not positive definite along p (or p vanished), no progress can be made
+			break;
+		}
+
+		const double alpha = rz / pq;
+		*x += alpha * m_p;
+		m_r -= alpha * m_q;
+		++m_numIterations;
+
+		m_relativeResidual = m_r.norm() / bNorm;
+		if (m_relativeResidual <= m_tolerance)
+		{
+			return true;
+		}
+
+		preconditioner(m_r, &m_z);
+		const double rzNew = m_r.dot(m_z);
+		m_p = m_z + (rzNew / rz) * m_p;
+		rz = rzNew;
+	}
+
+	return false;
+}
+
+size_t PreconditionedConjugateGradient::getNumIterations() const
+{
+	return m_numIterations;
+}
+
+double PreconditionedConjugateGradient::getRelativeResidual() const
+{
+	return m_relativeResidual;
+}
+
+}; // namespace Math
+
+}; // namespace SurgSim
@@ -0,0 +1,112 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SURGSIM_MATH_PRECONDITIONEDCONJUGATEGRADIENT_H
+#define SURGSIM_MATH_PRECONDITIONEDCONJUGATEGRADIENT_H
+
+#include <functional>
+
+#include "SurgSim/Math/Matrix.h"
+#include "SurgSim/Math/Vector.h"
+
+namespace SurgSim
+{
+
+namespace Math
+{
+
+/// Block Jacobi preconditioner, the inverse of the diagonal blocks of a symmetric positive definite matrix.
+/// For a FEM system the blocks are the node blocks, which captures the coupling between the dof of a node that a
+/// diagonal preconditioner misses.
+class BlockJacobiPreconditioner
+{
+public:
+	/// Set the diagonal blocks of the matrix and invert them
+	/// \param blocks The diagonal blocks stacked vertically, a (n x blockSize) matrix for a (n x n) matrix
+	/// \note A block that cannot be inverted (i.e. of a node without mass or stiffness) is replaced by the identity
+	void setBlocks(const Matrix& blocks);
+
+	/// \return The size of the blocks, 0 if they are not set
+	size_t getBlockSize() const;
+
+	/// Apply the preconditioner, result = inverse(diagonal blocks).x
+	/// \param x The vector to apply the preconditioner to
+	/// \param [out] result The preconditioned vector, it cannot be x
+	void apply(const Vector& x, Vector* result) const;
+
+private:
+	/// The inverse of the diagonal blocks, stacked vertically
+	Matrix m_inverseBlocks;
+};
+
+/// Preconditioned conjugate gradient for symmetric positive definite systems A.x = b, where A is only known through
+/// its product with a vector, so that the system can be solved without assembling A.
+/// The working vectors are kept from one solve to the next, solving systems of the same size does not allocate.
+class PreconditionedConjugateGradient
+{
+public:
+	/// Function computing the product of the matrix (or of the preconditioner) with a vector, result = A.x
+	typedef std::function<void(const Vector& x, Vector* result)> Operator;
+
+	/// Constructor
+	PreconditionedConjugateGradient();
+
+	/// \param tolerance The convergence tolerance, relative to the norm of the right hand side
+	void setTolerance(double tolerance);
+
+	/// \return The convergence tolerance, relative to the norm of the right hand side
+	double getTolerance() const;
+
+	/// \param maxIterations The iteration budget, the solve stops after this many iterations even if not converged
+	void setMaxIterations(size_t maxIterations);
+
+	/// \return The iteration budget
+	size_t getMaxIterations() const;
+
+	/// Solve A.x = b
+	/// \param matrix The product with the matrix A
+	/// \param preconditioner The product with the preconditioner, an approximation of the inverse of A
+	/// \param b The right hand side
+	/// \param [in,out] x The initial guess, the solution on return
+	/// \return True if the tolerance was reached within the iteration budget, false otherwise (x is then the last
+	/// 	estimate)
+	bool solve(const Operator& matrix, const Operator& preconditioner, const Vector& b, Vector* x);
+
+	/// \return The number of iterations of the latest solve
+	size_t getNumIterations() const;
+
+	/// \return The residual norm of the latest solve, relative to the norm of the right hand side
+	double getRelativeResidual() const;
+
+private:
+	/// Convergence tolerance
+	double m_tolerance;
+
+	/// Iteration budget
+	size_t m_maxIterations;
+
+	/// Statistics of the latest solve
+	size_t m_numIterations;
+	double m_relativeResidual;
+
+	/// Working vectors, residual, preconditioned residual, search direction and its product with A
+	Vector m_r, m_z, m_p, m_q;
+};
+
+}; // namespace Math
+
+}; // namespace SurgSim
+
+#endif // SURGSIM_MATH_PRECONDITIONEDCONJUGATEGRADIENT_H
@@ -0,0 +1,62 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SURGSIM_MATH_SDFSHAPE_INL_H
+#define SURGSIM_MATH_SDFSHAPE_INL_H
+
+namespace SurgSim
+{
+namespace Math
+{
+
+template <class M, class E, class F>
+void SdfShape::calculateVerticesPenetration(const M& mesh, const std::vector<E>& elements,
+											const RigidTransform3d& meshToLocal, double radius,
+											F onPenetration) const
+{
+	double depth;
+	Vector3d normal, surfacePoint;
+
+	std::vector<bool>& visited = *getVisitedVertices(mesh.getNumVertices());
+	for (size_t elementId = 0; elementId < elements.size(); ++elementId)
+	{
+		const auto& element = elements[elementId];
+		if (!element.isValid)
+		{
+			continue;
+		}
+
+		for (size_t i = 0; i < element.verticesId.size(); ++i)
+		{
+			const size_t vertexId = element.verticesId[i];
+			if (visited[vertexId])
+			{
+				continue;
+			}
+			visited[vertexId] = true;
+
+			if (calculatePenetration(meshToLocal * mesh.getVertexPosition(vertexId), radius,
+									 &depth, &normal, &surfacePoint))
+			{
+				onPenetration(elementId, i, depth, normal, surfacePoint);
+			}
+		}
+	}
+}
+
+}; // namespace Math
+}; // namespace SurgSim
+
+#endif // SURGSIM_MATH_SDFSHAPE_INL_H
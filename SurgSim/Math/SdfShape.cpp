@@ -0,0 +1,349 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SurgSim/Math/SdfShape.h"
+
+#include <algorithm>
+#include <boost/thread/tss.hpp>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include "SurgSim/Framework/Assert.h"
+#include "SurgSim/Framework/Log.h"
+#include "SurgSim/Math/Geometry.h"
+
+namespace SurgSim
+{
+namespace Math
+{
+SURGSIM_REGISTER(SurgSim::Math::Shape, SurgSim::Math::SdfShape, SdfShape);
+
+SdfShape::SdfShape() :
+	m_origin(Vector3d::Zero()),
+	m_spacing(0.0),
+	m_volume(0.0),
+	m_center(Vector3d::Zero()),
+	m_secondMomentOfVolume(Matrix33d::Zero())
+{
+	m_dimensions.fill(0);
+
+	SURGSIM_ADD_SETTER(SdfShape, std::string, SdfFileName, loadSdf);
+}
+
+SdfShape::SdfShape(const std::array<size_t, 3>& dimensions, const Vector3d& origin, double spacing,
+				   const std::vector<double>& values) :
+	SdfShape()
+{
+	setGrid(dimensions, origin, spacing, values);
+}
+
+void SdfShape::setGrid(const std::array<size_t, 3>& dimensions, const Vector3d& origin, double spacing,
+					   const std::vector<double>& values)
+{
+	SURGSIM_ASSERT(dimensions[0] >= 2 && dimensions[1] >= 2 && dimensions[2] >= 2)
+			<< "A signed distance field needs at least 2 samples along each axis.";
+	SURGSIM_ASSERT(spacing > 0.0) << "The spacing of a signed distance field needs to be positive, got " << spacing;
+	SURGSIM_ASSERT(values.size() == dimensions[0] * dimensions[1] * dimensions[2])
+			<< "A signed distance field of " << dimensions[0] << "x" << dimensions[1] << "x" << dimensions[2]
+			<< " samples cannot be built from " << values.size() << " values.";
+
+	m_dimensions = dimensions;
+	m_origin = origin;
+	m_spacing = spacing;
+	m_values = values;
+
+	m_aabb.setEmpty();
+	m_aabb.extend(m_origin);
+	m_aabb.extend(m_origin + m_spacing * Vector3d(static_cast<double>(m_dimensions[0] - 1),
+					static_cast<double>(m_dimensions[1] - 1), static_cast<double>(m_dimensions[2] - 1)));
+
+	computeVolumeIntegrals();
+}
+
+const std::array<size_t, 3>& SdfShape::getDimensions() const
+{
+	return m_dimensions;
+}
+
+const Vector3d& SdfShape::getOrigin() const
+{
+	return m_origin;
+}
+
+double SdfShape::getSpacing() const
+{
+	return m_spacing;
+}
+
+const std::vector<double>& SdfShape::getValues() const
+{
+	return m_values;
+}
+
+void SdfShape::loadSdf(const std::string& filePath)
+{
+	load(filePath);
+}
+
+double SdfShape::getDistance(const Vector3d& point) const
+{
+	Vector3d gradient;
+	return getDistance(point, &gradient);
+}
+
+double SdfShape::getDistance(const Vector3d& point, Vector3d* gradient) const
+{
+	SURGSIM_ASSERT(isValid()) << "The signed distance field is empty.";
+
+	// Find the cell containing the point, points outside of the grid use the closest cell
+	Vector3d gridPoint = (point - m_origin) / m_spacing;
+	Vector3d outside = Vector3d::Zero();
+	std::array<size_t, 3> cell;
+	Vector3d t;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		const double maxCoordinate = static_cast<double>(m_dimensions[axis] - 1);
+		const double clamped = std::min(std::max(gridPoint[axis], 0.0), maxCoordinate);
+		outside[axis] = (gridPoint[axis] - clamped) * m_spacing;
+		cell[axis] = std::min(static_cast<size_t>(clamped), m_dimensions[axis] - 2);
+		t[axis] = clamped - static_cast<double>(cell[axis]);
+	}
+
+	const size_t strideY = m_dimensions[0];
+	const size_t strideZ = m_dimensions[0] * m_dimensions[1];
+	const double* corner = &m_values[cell[0] + strideY * cell[1] + strideZ * cell[2]];
+	const double v000 = corner[0];
+	const double v100 = corner[1];
+	const double v010 = corner[strideY];
+	const double v110 = corner[strideY + 1];
+	const double v001 = corner[strideZ];
+	const double v101 = corner[strideZ + 1];
+	const double v011 = corner[strideZ + strideY];
+	const double v111 = corner[strideZ + strideY + 1];
+
+	// Trilinear interpolation, and its derivatives
+	const double v00 = v000 + t[0] * (v100 - v000);
+	const double v10 = v010 + t[0] * (v110 - v010);
+	const double v01 = v001 + t[0] * (v101 - v001);
+	const double v11 = v011 + t[0] * (v111 - v011);
+	const double v0 = v00 + t[1] * (v10 - v00);
+	const double v1 = v01 + t[1] * (v11 - v01);
+	double distance = v0 + t[2] * (v1 - v0);
+
+	const double outsideDistance = outside.norm();
+	if (outsideDistance > 0.0)
+	{
+		// Away from the grid, move away from the grid
+		distance += outsideDistance;
+		*gradient = outside / outsideDistance;
+	}
+	else
+	{
+		const double dx0 = (v100 - v000) + t[1] * ((v110 - v010) - (v100 - v000));
+		const double dx1 = (v101 - v001) + t[1] * ((v111 - v011) - (v101 - v001));
+		(*gradient)[0] = (dx0 + t[2] * (dx1 - dx0)) / m_spacing;
+		(*gradient)[1] = ((v10 - v00) + t[2] * ((v11 - v01) - (v10 - v00))) / m_spacing;
+		(*gradient)[2] = (v1 - v0) / m_spacing;
+	}
+
+	return distance;
+}
+
+bool SdfShape::calculatePenetration(const Vector3d& center, double radius,
+								   double* depth, Vector3d* normal, Vector3d* surfacePoint) const
+{
+	// The object is contained in the grid, a sphere that does not touch the grid cannot touch the object
+	if (m_aabb.exteriorDistance(center) > radius)
+	{
+		return false;
+	}
+
+	Vector3d gradient;
+	const double distance = getDistance(center, &gradient);
+	if (distance >= radius)
+	{
+		return false;
+	}
+
+	const double gradientNorm = gradient.norm();
+	if (gradientNorm < Geometry::DistanceEpsilon)
+	{
+		return false;
+	}
+
+	*normal = gradient / gradientNorm;
+	*depth = radius - distance;
+	*surfacePoint = center - distance * (*normal);
+	return true;
+}
+
+int SdfShape::getType() const
+{
+	return SHAPE_TYPE_SDF;
+}
+
+double SdfShape::getVolume() const
+{
+	return m_volume;
+}
+
+Vector3d SdfShape::getCenter() const
+{
+	return m_center;
+}
+
+Matrix33d SdfShape::getSecondMomentOfVolume() const
+{
+	return m_secondMomentOfVolume;
+}
+
+bool SdfShape::isValid() const
+{
+	return m_spacing > 0.0 && !m_values.empty();
+}
+
+const Math::Aabbd& SdfShape::getBoundingBox() const
+{
+	return m_aabb;
+}
+
+bool SdfShape::doLoad(const std::string& fileName)
+{
+	std::ifstream file(fileName);
+	if (!file.is_open())
+	{
+		SURGSIM_LOG_SEVERE(Framework::Logger::getDefaultLogger()) << "Could not open '" << fileName << "'.";
+		return false;
+	}
+
+	// Remove the comments, the rest of the file is a stream of keywords and numbers
+	std::stringstream content;
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (line.empty() || line[0] != '#')
+		{
+			content << line << " ";
+		}
+	}
+
+	std::array<size_t, 3> dimensions = {{0, 0, 0}};
+	Vector3d origin = Vector3d::Zero();
+	double spacing = 0.0;
+	std::vector<double> values;
+	std::string keyword;
+	while (content >> keyword)
+	{
+		if (keyword == "dimensions")
+		{
+			content >> dimensions[0] >> dimensions[1] >> dimensions[2];
+		}
+		else if (keyword == "origin")
+		{
+			content >> origin[0] >> origin[1] >> origin[2];
+		}
+		else if (keyword == "spacing")
+		{
+			content >> spacing;
+		}
+		else if (keyword == "values")
+		{
+			const size_t count = dimensions[0] * dimensions[1] * dimensions[2];
+			values.resize(count);
+			for (size_t i = 0; i < count && content; ++i)
+			{
+				content >> values[i];
+			}
+		}
+		else
+		{
+			SURGSIM_LOG_SEVERE(Framework::Logger::getDefaultLogger())
+					<< "Unknown keyword '" << keyword << "' in '" << fileName << "'.";
+			return false;
+		}
+
+		if (content.fail())
+		{
+			SURGSIM_LOG_SEVERE(Framework::Logger::getDefaultLogger())
+					<< "Invalid data for '" << keyword << "' in '" << fileName << "'.";
+			return false;
+		}
+	}
+
+	if (dimensions[0] < 2 || dimensions[1] < 2 || dimensions[2] < 2 || spacing <= 0.0 || values.empty())
+	{
+		SURGSIM_LOG_SEVERE(Framework::Logger::getDefaultLogger())
+				<< "'" << fileName << "' does not contain a valid signed distance field.";
+		return false;
+	}
+
+	setGrid(dimensions, origin, spacing, values);
+	return true;
+}
+
+std::vector<bool>* SdfShape::getVisitedVertices(size_t numVertices)
+{
+	static boost::thread_specific_ptr<std::vector<bool>> visitedVertices;
+	if (visitedVertices.get() == nullptr)
+	{
+		visitedVertices.reset(new std::vector<bool>());
+	}
+	visitedVertices->assign(numVertices, false);
+	return visitedVertices.get();
+}
+
+void SdfShape::computeVolumeIntegrals()
+{
+	// Each sample inside the object stands for a cube of the size of the spacing
+	const double cellVolume = m_spacing * m_spacing * m_spacing;
+	const double cellSecondMoment = cellVolume * m_spacing * m_spacing / 6.0;
+
+	m_volume = 0.0;
+	m_center.setZero();
+	std::vector<Vector3d> insideSamples;
+	size_t index = 0;
+	for (size_t k = 0; k < m_dimensions[2]; ++k)
+	{
+		for (size_t j = 0; j < m_dimensions[1]; ++j)
+		{
+			for (size_t i = 0; i < m_dimensions[0]; ++i, ++index)
+			{
+				if (m_values[index] < 0.0)
+				{
+					insideSamples.push_back(m_origin + m_spacing * Vector3d(static_cast<double>(i),
+											static_cast<double>(j), static_cast<double>(k)));
+					m_center += insideSamples.back();
+				}
+			}
+		}
+	}
+
+	m_secondMomentOfVolume.setZero();
+	if (!insideSamples.empty())
+	{
+		m_volume = cellVolume * static_cast<double>(insideSamples.size());
+		m_center /= static_cast<double>(insideSamples.size());
+		for (const auto& sample : insideSamples)
+		{
+			const Vector3d r = sample - m_center;
+			m_secondMomentOfVolume += cellVolume * (r.squaredNorm() * Matrix33d::Identity() - r * r.transpose());
+			m_secondMomentOfVolume.diagonal().array() += cellSecondMoment;
+		}
+	}
+}
+
+}; // namespace Math
+}; // namespace SurgSim
@@ -0,0 +1,185 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SURGSIM_MATH_SDFSHAPE_H
+#define SURGSIM_MATH_SDFSHAPE_H
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "SurgSim/Framework/Asset.h"
+#include "SurgSim/Framework/ObjectFactory.h"
+#include "SurgSim/Math/Shape.h"
+
+namespace SurgSim
+{
+namespace Math
+{
+
+SURGSIM_STATIC_REGISTRATION(SdfShape);
+
+/// Signed distance field shape, the signed distance to the surface of a rigid object sampled on a regular 3D grid.
+/// The distance is negative inside the object and positive outside of it, it is interpolated trilinearly between the
+/// samples, so that the distance and the gradient at any point are found in constant time.
+/// Points outside of the grid are clamped to it, their distance is increased by their distance to the grid, which
+/// keeps it conservative as long as the object is contained in the grid.
+///
+/// The field can be loaded from a text file, made of the keywords 'dimensions' (3 sizes), 'origin' (3 coordinates)
+/// and 'spacing' (1 value), followed by the keyword 'values' and the samples, x varying the fastest then y then z.
+/// Lines starting with '#' are comments.
+/// \code
+/// # A sphere of radius 1
+/// dimensions 3 3 3
+/// origin -1.0 -1.0 -1.0
+/// spacing 1.0
+/// values
+/// 0.73 0.41 0.73 0.41 0.0 0.41 ...
+/// \endcode
+class SdfShape : public Shape, public Framework::Asset
+{
+public:
+	/// Constructor, the field is empty until a grid is set or loaded
+	SdfShape();
+
+	/// Constructor
+	/// \param dimensions the number of samples along each axis, at least 2
+	/// \param origin the position of the first sample, in local coordinates
+	/// \param spacing the distance between two consecutive samples along any axis
+	/// \param values the signed distances at the samples, x varying the fastest then y then z
+	SdfShape(const std::array<size_t, 3>& dimensions, const Vector3d& origin, double spacing,
+			 const std::vector<double>& values);
+
+	SURGSIM_CLASSNAME(SurgSim::Math::SdfShape);
+
+	/// Set the sampled field
+	/// \param dimensions the number of samples along each axis, at least 2
+	/// \param origin the position of the first sample, in local coordinates
+	/// \param spacing the distance between two consecutive samples along any axis
+	/// \param values the signed distances at the samples, x varying the fastest then y then z
+	void setGrid(const std::array<size_t, 3>& dimensions, const Vector3d& origin, double spacing,
+				 const std::vector<double>& values);
+
+	/// \return the number of samples along each axis
+	const std::array<size_t, 3>& getDimensions() const;
+
+	/// \return the position of the first sample, in local coordinates
+	const Vector3d& getOrigin() const;
+
+	/// \return the distance between two consecutive samples
+	double getSpacing() const;
+
+	/// \return the signed distances at the samples, x varying the fastest then y then z
+	const std::vector<double>& getValues() const;
+
+	/// Load the field from a file, through the application data of the runtime
+	/// \param filePath the path of the file, relative to the application data search paths
+	/// \exception SurgSim::Framework::AssertionFailure if the file cannot be found or does not contain a valid field
+	/// \note Also available as the property 'SdfFileName', usable from YAML instead of the serialized asset.
+	void loadSdf(const std::string& filePath);
+
+	/// Calculate the signed distance at a point
+	/// \param point the point in local coordinates
+	/// \return the signed distance, negative inside the object
+	double getDistance(const Vector3d& point) const;
+
+	/// Calculate the signed distance and its gradient at a point
+	/// \param point the point in local coordinates
+	/// \param [out] gradient the gradient of the distance, pointing away from the object, not normalized
+	/// \return the signed distance, negative inside the object
+	double getDistance(const Vector3d& point, Vector3d* gradient) const;
+
+	/// Check a sphere against the field, used by the contact calculations for each vertex of the other shape
+	/// \param center the center of the sphere in local coordinates
+	/// \param radius the radius of the sphere, 0 for a point
+	/// \param [out] depth the penetration of the sphere into the object
+	/// \param [out] normal the normalized gradient of the field at the center, pointing away from the object
+	/// \param [out] surfacePoint the projection of the center on the surface of the object, in local coordinates
+	/// \return true if the sphere penetrates the object, in which case the outputs are set
+	bool calculatePenetration(const Vector3d& center, double radius,
+							  double* depth, Vector3d* normal, Vector3d* surfacePoint) const;
+
+	/// Check the vertices of a mesh against the field, each vertex is checked once, through the first valid element
+	/// using it
+	/// \tparam M the mesh type, providing getNumVertices() and getVertexPosition()
+	/// \tparam E the element type (i.e. triangles or edges), providing isValid and verticesId
+	/// \tparam F the callback type
+	/// \param mesh the mesh
+	/// \param elements the elements of the mesh whose vertices are checked
+	/// \param meshToLocal the transform from the mesh coordinates to the local coordinates of the field
+	/// \param radius the radius of the vertices, 0 for points
+	/// \param onPenetration called for each penetrating vertex, with the element id, the index of the vertex in the
+	/// 	element, and the depth, normal and surface point as given by calculatePenetration()
+	template <class M, class E, class F>
+	void calculateVerticesPenetration(const M& mesh, const std::vector<E>& elements,
+									  const RigidTransform3d& meshToLocal, double radius, F onPenetration) const;
+
+	int getType() const override;
+
+	/// \return the volume of the samples inside the object
+	double getVolume() const override;
+
+	/// \return the center of the samples inside the object
+	Vector3d getCenter() const override;
+
+	/// \return the second moment of volume of the samples inside the object
+	Matrix33d getSecondMomentOfVolume() const override;
+
+	bool isValid() const override;
+
+	/// \return the bounding box of the grid
+	const Math::Aabbd& getBoundingBox() const override;
+
+protected:
+	bool doLoad(const std::string& fileName) override;
+
+private:
+	/// Compute the volume integrals from the samples inside the object
+	void computeVolumeIntegrals();
+
+	/// Get the visited flags used by calculateVerticesPenetration(), kept per thread so that they are only allocated
+	/// when a larger mesh is checked
+	/// \param numVertices the number of vertices of the mesh
+	/// \return the flags of the calling thread, numVertices of them set to false
+	static std::vector<bool>* getVisitedVertices(size_t numVertices);
+
+	/// Number of samples along each axis
+	std::array<size_t, 3> m_dimensions;
+
+	/// Position of the first sample
+	Vector3d m_origin;
+
+	/// Distance between the samples
+	double m_spacing;
+
+	/// Signed distances at the samples
+	std::vector<double> m_values;
+
+	/// Volume of the samples inside the object
+	double m_volume;
+
+	/// Center of the samples inside the object
+	Vector3d m_center;
+
+	/// Second moment of volume of the samples inside the object
+	Matrix33d m_secondMomentOfVolume;
+};
+
+}; // namespace Math
+}; // namespace SurgSim
+
+#include "SurgSim/Math/SdfShape-inl.h"
+
+#endif // SURGSIM_MATH_SDFSHAPE_H
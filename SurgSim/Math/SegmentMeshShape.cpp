@@ -16,8 +16,8 @@
 
 #include "SurgSim/Math/SegmentMeshShape.h"
 
-#include "SurgSim/DataStructures/AabbTree.h"
 #include "SurgSim/DataStructures/AabbTreeData.h"
+#include "SurgSim/DataStructures/FlatAabbTree.h"
 #include "SurgSim/Framework/Log.h"
 #include "SurgSim/Math/Geometry.h"
 #include "SurgSim/Math/SegmentMeshShapePlyReaderDelegate.h"
@@ -36,7 +36,9 @@ SegmentMeshShape::SegmentMeshShape()
 }
 
 SegmentMeshShape::SegmentMeshShape(const SegmentMeshShape& other) :
-	DataStructures::SegmentMeshPlain(other)
+	DataStructures::SegmentMeshPlain(other),
+	m_aabbTree((other.m_aabbTree != nullptr) ?
+			   std::make_shared<DataStructures::FlatAabbTree>(*other.m_aabbTree) : nullptr)
 {
 	setRadius(other.m_radius);
 	updateAabbTree();
@@ -112,11 +114,21 @@ bool SegmentMeshShape::doLoad(const std::string& fileName)
 	return true;
 }
 
-std::shared_ptr<const DataStructures::AabbTree> SegmentMeshShape::getAabbTree() const
+std::shared_ptr<const DataStructures::FlatAabbTree> SegmentMeshShape::getFlatAabbTree() const
 {
 	return m_aabbTree;
 }
 
+std::shared_ptr<const DataStructures::AabbTree> SegmentMeshShape::getAabbTree() const
+{
+	std::vector<DataStructures::FlatAabbTree::Item> items;
+	getAabbTreeItems(&items);
+
+	auto aabbTree = std::make_shared<DataStructures::AabbTree>();
+	aabbTree->set(std::list<DataStructures::AabbTreeData::Item>(items.begin(), items.end()));
+	return aabbTree;
+}
+
 std::shared_ptr<Shape> SegmentMeshShape::getTransformed(const RigidTransform3d& pose) const
 {
 	auto transformed = std::make_shared<SegmentMeshShape>(*this);
@@ -127,11 +139,21 @@ std::shared_ptr<Shape> SegmentMeshShape::getTransformed(const RigidTransform3d&
 
 void SegmentMeshShape::updateAabbTree()
 {
-	m_aabbTree = std::make_shared<DataStructures::AabbTree>();
+	if (m_aabbTree == nullptr)
+	{
+		m_aabbTree = std::make_shared<DataStructures::FlatAabbTree>();
+	}
 
-	std::list<DataStructures::AabbTreeData::Item> items;
+	std::vector<DataStructures::FlatAabbTree::Item> items;
+	getAabbTreeItems(&items);
+	m_aabbTree->update(items);
+	m_aabb = m_aabbTree->getAabb();
+}
 
+void SegmentMeshShape::getAabbTreeItems(std::vector<DataStructures::FlatAabbTree::Item>* items) const
+{
 	auto const& edges = getEdges();
+	items->reserve(edges.size());
 
 	for (size_t id = 0; id < edges.size(); ++id)
 	{
@@ -142,11 +164,9 @@ void SegmentMeshShape::updateAabbTree()
 			aabb.extend((vertices[0] + m_segmentEndBoundingBoxHalfExtent).eval());
 			aabb.extend((vertices[1] - m_segmentEndBoundingBoxHalfExtent).eval());
 			aabb.extend((vertices[1] + m_segmentEndBoundingBoxHalfExtent).eval());
-			items.emplace_back(aabb, id);
+			items->emplace_back(aabb, id);
 		}
 	}
-	m_aabbTree->set(std::move(items));
-	m_aabb = m_aabbTree->getAabb();
 }
 
 bool SegmentMeshShape::isTransformable() const
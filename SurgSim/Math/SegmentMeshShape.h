@@ -17,6 +17,7 @@
 #define SURGSIM_MATH_SEGMENTMESHSHAPE_H
 
 #include "SurgSim/DataStructures/AabbTree.h"
+#include "SurgSim/DataStructures/FlatAabbTree.h"
 #include "SurgSim/DataStructures/SegmentMesh.h"
 #include "SurgSim/Framework/ObjectFactory.h"
 #include "SurgSim/Math/Geometry.h"
@@ -66,6 +67,12 @@ class SegmentMeshShape : public Shape, public DataStructures::SegmentMeshPlain
 	double getRadius() const;
 
 	/// \return The object's associated AabbTree
+	std::shared_ptr<const DataStructures::FlatAabbTree> getFlatAabbTree() const;
+
+	/// Get a pointer based AabbTree of the segments, kept for the existing users of this accessor
+	/// \note Deprecated, use getFlatAabbTree(). The shape does not keep this tree, a new one is built from the
+	/// 	current segments on every call.
+	/// \return A new AabbTree of the valid segments
 	std::shared_ptr<const DataStructures::AabbTree> getAabbTree() const;
 
 	bool isTransformable() const override;
@@ -76,15 +83,20 @@ class SegmentMeshShape : public Shape, public DataStructures::SegmentMeshPlain
 	bool doUpdate() override;
 	bool doLoad(const std::string& fileName) override;
 
-	/// Update the AabbTree, which is an axis-aligned bounding box r-tree used to accelerate spatial searches
+	/// Update the AabbTree, which is an axis-aligned bounding box tree used to accelerate spatial searches.
+	/// As long as the edges stay the same, the tree is only refit to the new edge positions.
 	void updateAabbTree();
 
+	/// Get the bounding boxes of the valid segments, including their radius
+	/// \param [out] items the bounding box and id of each valid segment
+	void getAabbTreeItems(std::vector<DataStructures::FlatAabbTree::Item>* items) const;
+
 private:
 	/// Segment radius
 	double m_radius;
 
 	/// The aabb tree used to accelerate collision detection against the mesh
-	std::shared_ptr<DataStructures::AabbTree> m_aabbTree;
+	std::shared_ptr<DataStructures::FlatAabbTree> m_aabbTree;
 
 	/// Half extent of the AABB of the sphere at one of the segment end.
 	Vector3d m_segmentEndBoundingBoxHalfExtent;
@@ -57,5 +57,16 @@ const Math::Aabbd& Shape::getBoundingBox() const
 	return m_aabb;
 }
 
+bool Shape::isConvex() const
+{
+	return false;
+}
+
+Vector3d Shape::getSupport(const Vector3d& direction) const
+{
+	SURGSIM_FAILURE() << "getSupport not implemented for " << getClassName();
+	return Vector3d::Zero();
+}
+
 } // namespace Math
 } // namespace SurgSim
@@ -56,6 +56,7 @@ typedef enum
 	SHAPE_TYPE_SURFACEMESH,
 	SHAPE_TYPE_SEGMENTMESH,
 	SHAPE_TYPE_COMPOUNDSHAPE,
+	SHAPE_TYPE_SDF,
 	SHAPE_TYPE_COUNT
 } ShapeType;
 
@@ -108,6 +109,14 @@ class Shape : virtual public SurgSim::Framework::Accessible, public Framework::F
 	/// \return the bounding box for the shape
 	virtual const Math::Aabbd& getBoundingBox() const;
 
+	/// \return true if the shape is convex and implements getSupport()
+	virtual bool isConvex() const;
+
+	/// Support function of a convex shape, used by the generic convex contact calculations
+	/// \param direction a direction in local coordinates, does not need to be normalized
+	/// \return the point of the shape farthest along the direction, in local coordinates
+	virtual Vector3d getSupport(const Vector3d& direction) const;
+
 protected:
 	Math::Aabbd m_aabb;
 };
@@ -78,6 +78,21 @@ bool SphereShape::isValid() const
 	return m_radius >= 0;
 }
 
+bool SphereShape::isConvex() const
+{
+	return true;
+}
+
+Vector3d SphereShape::getSupport(const Vector3d& direction) const
+{
+	double norm = direction.norm();
+	if (norm > 0.0)
+	{
+		return direction * (m_radius / norm);
+	}
+	return Vector3d(m_radius, 0.0, 0.0);
+}
+
 
 }; // namespace Math
 }; // namespace SurgSim
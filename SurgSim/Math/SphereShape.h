@@ -59,6 +59,10 @@ class SphereShape: public Shape
 	/// \return True if radius is bigger than or equal to 0; Otherwise, false.
 	bool isValid() const override;
 
+	bool isConvex() const override;
+
+	Vector3d getSupport(const Vector3d& direction) const override;
+
 protected:
 	// Setters in 'protected' sections are for serialization purpose only.
 
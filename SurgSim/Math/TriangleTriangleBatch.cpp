@@ -0,0 +1,273 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SurgSim/Math/TriangleTriangleBatch.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+#include "SurgSim/Framework/Assert.h"
+#include "SurgSim/Math/Geometry.h"
+
+namespace
+{
+typedef Eigen::Matrix<double, Eigen::Dynamic, 3> Coordinates;
+
+/// Signed distances of points from planes, for a range of pairs
+/// \param normals the normals of the planes
+/// \param origins a point on each plane
+/// \param points the points
+/// \param start the first pair
+/// \param size the number of pairs
+/// \return the signed distances
+Eigen::ArrayXd distances(const Coordinates& normals, const Coordinates& origins, const Coordinates& points,
+						 Eigen::DenseIndex start, Eigen::DenseIndex size)
+{
+	return normals.col(0).segment(start, size).array() *
+		   (points.col(0).segment(start, size) - origins.col(0).segment(start, size)).array() +
+		   normals.col(1).segment(start, size).array() *
+		   (points.col(1).segment(start, size) - origins.col(1).segment(start, size)).array() +
+		   normals.col(2).segment(start, size).array() *
+		   (points.col(2).segment(start, size) - origins.col(2).segment(start, size)).array();
+}
+}
+
+namespace SurgSim
+{
+namespace Math
+{
+
+const size_t TriangleTriangleBatch::DefaultCapacity;
+
+TriangleTriangleBatch::TriangleTriangleBatch(size_t capacity) :
+	m_size(0)
+{
+	SURGSIM_ASSERT(capacity > 0) << "The capacity of the batch cannot be 0.";
+	for (size_t i = 0; i < 3; ++i)
+	{
+		m_vertices0[i].resize(capacity, 3);
+		m_vertices1[i].resize(capacity, 3);
+	}
+	m_normals0.resize(capacity, 3);
+	m_normals1.resize(capacity, 3);
+	m_distances0.resize(capacity, 3);
+	m_distances1.resize(capacity, 3);
+}
+
+size_t TriangleTriangleBatch::getCapacity() const
+{
+	return static_cast<size_t>(m_normals0.rows());
+}
+
+size_t TriangleTriangleBatch::getSize() const
+{
+	return m_size;
+}
+
+bool TriangleTriangleBatch::isFull() const
+{
+	return m_size == getCapacity();
+}
+
+void TriangleTriangleBatch::clear()
+{
+	m_size = 0;
+}
+
+size_t TriangleTriangleBatch::add(const Vector3d& t0v0, const Vector3d& t0v1, const Vector3d& t0v2,
+								  const Vector3d& t1v0, const Vector3d& t1v1, const Vector3d& t1v2,
+								  const Vector3d& t0n, const Vector3d& t1n)
+{
+	SURGSIM_ASSERT(!isFull()) << "The batch is full, it cannot take more than " << getCapacity() << " pairs.";
+
+	m_vertices0[0].row(m_size) = t0v0.transpose();
+	m_vertices0[1].row(m_size) = t0v1.transpose();
+	m_vertices0[2].row(m_size) = t0v2.transpose();
+	m_vertices1[0].row(m_size) = t1v0.transpose();
+	m_vertices1[1].row(m_size) = t1v1.transpose();
+	m_vertices1[2].row(m_size) = t1v2.transpose();
+	m_normals0.row(m_size) = t0n.transpose();
+	m_normals1.row(m_size) = t1n.transpose();
+	return m_size++;
+}
+
+void TriangleTriangleBatch::getCandidates(std::vector<size_t>* candidates)
+{
+	candidates->clear();
+
+	// The groups of pairs are processed in order, the candidates are found in increasing order
+	size_t begin = 0;
+#if defined(__AVX512F__)
+	begin = getCandidatesAvx512(begin, candidates);
+#endif
+#if defined(__AVX__)
+	begin = getCandidatesAvx(begin, candidates);
+#endif
+	getCandidatesGeneric(begin, candidates);
+}
+
+void TriangleTriangleBatch::getDistances(size_t pair, Vector3d* t0Distances, Vector3d* t1Distances) const
+{
+	*t0Distances = m_distances0.row(pair).transpose();
+	*t1Distances = m_distances1.row(pair).transpose();
+}
+
+void TriangleTriangleBatch::getCandidatesGeneric(size_t begin, std::vector<size_t>* candidates)
+{
+	using Geometry::DistanceEpsilon;
+
+	if (begin >= m_size)
+	{
+		return;
+	}
+
+	// Same test as doesIntersectTriangleTriangle(), but on the extremes of the signed distances so that all the
+	// pairs are processed with the same instructions. Degenerate triangles have a zero normal, all the distances
+	// are then 0 and the pair is rejected, as it would be by the scalar test.
+	const Eigen::DenseIndex start = static_cast<Eigen::DenseIndex>(begin);
+	const Eigen::DenseIndex size = static_cast<Eigen::DenseIndex>(m_size - begin);
+	for (Eigen::DenseIndex vertex = 0; vertex < 3; ++vertex)
+	{
+		m_distances1.col(vertex).segment(start, size) =
+			distances(m_normals0, m_vertices0[0], m_vertices1[vertex], start, size).matrix();
+		m_distances0.col(vertex).segment(start, size) =
+			distances(m_normals1, m_vertices1[0], m_vertices0[vertex], start, size).matrix();
+	}
+
+	Eigen::Array<bool, Eigen::Dynamic, 1> rejected = Eigen::Array<bool, Eigen::Dynamic, 1>::Constant(size, false);
+	const Coordinates* sides[2] = {&m_distances0, &m_distances1};
+	for (const Coordinates* side : sides)
+	{
+		auto distance0 = side->col(0).segment(start, size).array();
+		auto distance1 = side->col(1).segment(start, size).array();
+		auto distance2 = side->col(2).segment(start, size).array();
+		rejected = rejected ||
+				   (distance0.max(distance1).max(distance2) < DistanceEpsilon) ||
+				   (distance0.min(distance1).min(distance2) > -DistanceEpsilon);
+	}
+
+	for (Eigen::DenseIndex i = 0; i < size; ++i)
+	{
+		if (!rejected[i])
+		{
+			candidates->push_back(begin + static_cast<size_t>(i));
+		}
+	}
+}
+
+#if defined(__AVX__)
+size_t TriangleTriangleBatch::getCandidatesAvx(size_t begin, std::vector<size_t>* candidates)
+{
+	const __m256d epsilon = _mm256_set1_pd(Geometry::DistanceEpsilon);
+	const __m256d minusEpsilon = _mm256_set1_pd(-Geometry::DistanceEpsilon);
+
+	size_t pair = begin;
+	for (; pair + 4 <= m_size; pair += 4)
+	{
+		__m256d rejected = _mm256_setzero_pd();
+		for (size_t side = 0; side < 2; ++side)
+		{
+			// The vertices of the second triangles against the planes of the first ones, then the opposite
+			const Coordinates& normals = (side == 0) ? m_normals0 : m_normals1;
+			const Coordinates& origins = (side == 0) ? m_vertices0[0] : m_vertices1[0];
+			const Coordinates* points = (side == 0) ? m_vertices1 : m_vertices0;
+			Coordinates& result = (side == 0) ? m_distances1 : m_distances0;
+
+			__m256d minimum = _mm256_setzero_pd();
+			__m256d maximum = _mm256_setzero_pd();
+			for (Eigen::DenseIndex vertex = 0; vertex < 3; ++vertex)
+			{
+				__m256d distance = _mm256_setzero_pd();
+				for (Eigen::DenseIndex axis = 0; axis < 3; ++axis)
+				{
+					const __m256d difference = _mm256_sub_pd(_mm256_loadu_pd(points[vertex].col(axis).data() + pair),
+															 _mm256_loadu_pd(origins.col(axis).data() + pair));
+					const __m256d normal = _mm256_loadu_pd(normals.col(axis).data() + pair);
+					distance = _mm256_add_pd(distance, _mm256_mul_pd(normal, difference));
+				}
+				_mm256_storeu_pd(result.col(vertex).data() + pair, distance);
+				minimum = (vertex == 0) ? distance : _mm256_min_pd(minimum, distance);
+				maximum = (vertex == 0) ? distance : _mm256_max_pd(maximum, distance);
+			}
+			rejected = _mm256_or_pd(rejected, _mm256_or_pd(_mm256_cmp_pd(maximum, epsilon, _CMP_LT_OQ),
+														   _mm256_cmp_pd(minimum, minusEpsilon, _CMP_GT_OQ)));
+		}
+
+		const int mask = _mm256_movemask_pd(rejected);
+		for (size_t lane = 0; lane < 4; ++lane)
+		{
+			if ((mask & (1 << lane)) == 0)
+			{
+				candidates->push_back(pair + lane);
+			}
+		}
+	}
+	return pair;
+}
+#endif
+
+#if defined(__AVX512F__)
+size_t TriangleTriangleBatch::getCandidatesAvx512(size_t begin, std::vector<size_t>* candidates)
+{
+	const __m512d epsilon = _mm512_set1_pd(Geometry::DistanceEpsilon);
+	const __m512d minusEpsilon = _mm512_set1_pd(-Geometry::DistanceEpsilon);
+
+	size_t pair = begin;
+	for (; pair + 8 <= m_size; pair += 8)
+	{
+		__mmask8 rejected = 0;
+		for (size_t side = 0; side < 2; ++side)
+		{
+			// The vertices of the second triangles against the planes of the first ones, then the opposite
+			const Coordinates& normals = (side == 0) ? m_normals0 : m_normals1;
+			const Coordinates& origins = (side == 0) ? m_vertices0[0] : m_vertices1[0];
+			const Coordinates* points = (side == 0) ? m_vertices1 : m_vertices0;
+			Coordinates& result = (side == 0) ? m_distances1 : m_distances0;
+
+			__m512d minimum = _mm512_setzero_pd();
+			__m512d maximum = _mm512_setzero_pd();
+			for (Eigen::DenseIndex vertex = 0; vertex < 3; ++vertex)
+			{
+				__m512d distance = _mm512_setzero_pd();
+				for (Eigen::DenseIndex axis = 0; axis < 3; ++axis)
+				{
+					const __m512d difference = _mm512_sub_pd(_mm512_loadu_pd(points[vertex].col(axis).data() + pair),
+															 _mm512_loadu_pd(origins.col(axis).data() + pair));
+					const __m512d normal = _mm512_loadu_pd(normals.col(axis).data() + pair);
+					distance = _mm512_add_pd(distance, _mm512_mul_pd(normal, difference));
+				}
+				_mm512_storeu_pd(result.col(vertex).data() + pair, distance);
+				minimum = (vertex == 0) ? distance : _mm512_min_pd(minimum, distance);
+				maximum = (vertex == 0) ? distance : _mm512_max_pd(maximum, distance);
+			}
+			rejected |= _mm512_cmp_pd_mask(maximum, epsilon, _CMP_LT_OQ) |
+						_mm512_cmp_pd_mask(minimum, minusEpsilon, _CMP_GT_OQ);
+		}
+
+		for (size_t lane = 0; lane < 8; ++lane)
+		{
+			if ((rejected & (1 << lane)) == 0)
+			{
+				candidates->push_back(pair + lane);
+			}
+		}
+	}
+	return pair;
+}
+#endif
+
+};  // namespace Math
+};  // namespace SurgSim
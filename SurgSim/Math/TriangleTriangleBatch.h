@@ -0,0 +1,132 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SURGSIM_MATH_TRIANGLETRIANGLEBATCH_H
+#define SURGSIM_MATH_TRIANGLETRIANGLEBATCH_H
+
+#include <vector>
+
+#include "SurgSim/Math/Vector.h"
+
+namespace SurgSim
+{
+namespace Math
+{
+
+/// Batch of triangle/triangle pairs, used to run the early rejection of the triangle/triangle intersection tests on
+/// many pairs at once.
+/// The pairs are stored as a structure of arrays, one array per coordinate, so that the rejection is a sequence of
+/// branch free operations on contiguous arrays. When the build targets AVX (SURGSIM_SIMD set to AVX2) or AVX-512
+/// (SURGSIM_SIMD set to AVX512), the pairs are processed 4 or 8 at a time with explicit intrinsics, otherwise the
+/// compiler vectorizes the array operations for the instruction set it targets (i.e. 2 pairs at a time with SSE2).
+/// The rejection is the same as the first step of doesIntersectTriangleTriangle(), a pair is rejected when all the
+/// vertices of one triangle are strictly on one side of the plane of the other triangle. The pairs that are not
+/// rejected still need to go through the exact test, which can reuse the signed distances computed by the rejection,
+/// see getDistances().
+class TriangleTriangleBatch
+{
+public:
+	/// Default number of pairs in a batch
+	static const size_t DefaultCapacity = 64;
+
+	/// Constructor
+	/// \param capacity the maximum number of pairs in the batch
+	explicit TriangleTriangleBatch(size_t capacity = DefaultCapacity);
+
+	/// \return the maximum number of pairs in the batch
+	size_t getCapacity() const;
+
+	/// \return the number of pairs in the batch
+	size_t getSize() const;
+
+	/// \return true if no more pairs can be added
+	bool isFull() const;
+
+	/// Remove all the pairs
+	void clear();
+
+	/// Add a pair of triangles
+	/// \param t0v0,t0v1,t0v2 Vertices of the first triangle.
+	/// \param t1v0,t1v1,t1v2 Vertices of the second triangle.
+	/// \param t0n Unit length normal of the first triangle.
+	/// \param t1n Unit length normal of the second triangle.
+	/// \return the index of the pair in the batch
+	/// \exception SurgSim::Framework::AssertionFailure if the batch is full
+	size_t add(const Vector3d& t0v0, const Vector3d& t0v1, const Vector3d& t0v2,
+			   const Vector3d& t1v0, const Vector3d& t1v1, const Vector3d& t1v2,
+			   const Vector3d& t0n, const Vector3d& t1n);
+
+	/// Run the early rejection on all the pairs
+	/// \param [out] candidates the indices of the pairs that might intersect, in increasing order
+	void getCandidates(std::vector<size_t>* candidates);
+
+	/// Get the signed distances computed by the latest getCandidates(), to be given to the exact test, e.g.
+	/// calculateContactTriangleTriangle()
+	/// \param pair the index of the pair, one of the candidates
+	/// \param [out] t0Distances the signed distances of the vertices of the first triangle from the plane of the second
+	/// \param [out] t1Distances the signed distances of the vertices of the second triangle from the plane of the first
+	void getDistances(size_t pair, Vector3d* t0Distances, Vector3d* t1Distances) const;
+
+private:
+	/// Coordinates stored as a structure of arrays, one row per pair
+	typedef Eigen::Matrix<double, Eigen::Dynamic, 3> Coordinates;
+
+	/// Run the early rejection on the pairs from begin to the end of the batch, with the array operations
+	/// \param begin the index of the first pair
+	/// \param [in,out] candidates the indices of the pairs that might intersect are added to it
+	void getCandidatesGeneric(size_t begin, std::vector<size_t>* candidates);
+
+#if defined(__AVX__)
+	/// Run the early rejection on groups of 4 pairs with AVX intrinsics, from begin as long as 4 pairs are left
+	/// \param begin the index of the first pair
+	/// \param [in,out] candidates the indices of the pairs that might intersect are added to it
+	/// \return the index of the first pair that was not processed
+	size_t getCandidatesAvx(size_t begin, std::vector<size_t>* candidates);
+#endif
+
+#if defined(__AVX512F__)
+	/// Run the early rejection on groups of 8 pairs with AVX-512 intrinsics, from begin as long as 8 pairs are left
+	/// \param begin the index of the first pair
+	/// \param [in,out] candidates the indices of the pairs that might intersect are added to it
+	/// \return the index of the first pair that was not processed
+	size_t getCandidatesAvx512(size_t begin, std::vector<size_t>* candidates);
+#endif
+
+	/// Number of pairs in the batch
+	size_t m_size;
+
+	/// The vertices of the first triangles
+	Coordinates m_vertices0[3];
+
+	/// The vertices of the second triangles
+	Coordinates m_vertices1[3];
+
+	/// The normals of the first triangles
+	Coordinates m_normals0;
+
+	/// The normals of the second triangles
+	Coordinates m_normals1;
+
+	/// The signed distances of the vertices of the first triangles from the planes of the second triangles
+	Coordinates m_distances0;
+
+	/// The signed distances of the vertices of the second triangles from the planes of the first triangles
+	Coordinates m_distances1;
+};
+
+};  // namespace Math
+};  // namespace SurgSim
+
+#endif // SURGSIM_MATH_TRIANGLETRIANGLEBATCH_H
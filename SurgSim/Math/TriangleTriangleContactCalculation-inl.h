@@ -226,11 +226,44 @@ bool calculateContactTriangleTriangle(
 	Eigen::Matrix<T, 3, 1, MOpt>* penetrationPoint0,
 	Eigen::Matrix<T, 3, 1, MOpt>* penetrationPoint1,
 	Eigen::Matrix<T, 3, 1, MOpt>* contactNormal)
+{
+	if (t0n.isZero() || t1n.isZero())
+	{
+		// Degenerate triangle(s) passed to calculateContactTriangleTriangle
+		return false;
+	}
+
+	Eigen::Matrix<T, 3, 1, MOpt> t0Distances, t1Distances;
+	if (isTriangleTriangleRejected(t0v0, t0v1, t0v2, t1v0, t1v1, t1v2, t0n, t1n, &t0Distances, &t1Distances))
+	{
+		return false;
+	}
+	return calculateContactTriangleTriangle(t0v0, t0v1, t0v2, t1v0, t1v1, t1v2, t0n, t1n, t0Distances, t1Distances,
+											penetrationDepth, penetrationPoint0, penetrationPoint1, contactNormal);
+}
+
+
+template <class T, int MOpt> inline
+bool calculateContactTriangleTriangle(
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0v0,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0v1,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0v2,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1v0,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1v1,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1v2,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0n,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1n,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0Distances,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1Distances,
+	T* penetrationDepth,
+	Eigen::Matrix<T, 3, 1, MOpt>* penetrationPoint0,
+	Eigen::Matrix<T, 3, 1, MOpt>* penetrationPoint1,
+	Eigen::Matrix<T, 3, 1, MOpt>* contactNormal)
 {
 	typedef Eigen::Matrix<T, 3, 1, MOpt> Vector3;
 
-	// Check if the triangles intersect.
-	if (!doesIntersectTriangleTriangle(t0v0, t0v1, t0v2, t1v0, t1v1, t1v2, t0n, t1n))
+	// Check if the triangles intersect, the early rejection has already been done.
+	if (!doesIntersectTriangleTriangle(t0v0, t0v1, t0v2, t1v0, t1v1, t1v2, t0n, t1n, t0Distances, t1Distances))
 	{
 		return false;
 	}
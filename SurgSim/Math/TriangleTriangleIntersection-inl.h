@@ -66,8 +66,19 @@ void edgeIntersection(T dStart, T dEnd, T pvStart, T pvEnd, T* parametricInterse
 	}
 }
 
+/// Early rejection test of the triangle/triangle intersection: if all the vertices of one triangle are on one side of
+/// the plane of the other triangle, there is no intersection.
+/// \tparam T Accuracy of the calculation, can usually be inferred.
+/// \tparam MOpt Eigen Matrix options, can usually be inferred.
+/// \param t0v0,t0v1,t0v2 Vertices of the first triangle.
+/// \param t1v0,t1v1,t1v2 Vertices of the second triangle.
+/// \param t0n Normal of the first triangle, should be normalized.
+/// \param t1n Normal of the second triangle, should be normalized.
+/// \param [out] t0Distances Signed distances of the vertices of the first triangle from the plane of the second one.
+/// \param [out] t1Distances Signed distances of the vertices of the second triangle from the plane of the first one.
+/// \return True if the triangles cannot intersect, in which case the distances might not be set.
 template <class T, int MOpt> inline
-bool doesIntersectTriangleTriangle(
+bool isTriangleTriangleRejected(
 	const Eigen::Matrix<T, 3, 1, MOpt>& t0v0,
 	const Eigen::Matrix<T, 3, 1, MOpt>& t0v1,
 	const Eigen::Matrix<T, 3, 1, MOpt>& t0v2,
@@ -75,17 +86,69 @@ bool doesIntersectTriangleTriangle(
 	const Eigen::Matrix<T, 3, 1, MOpt>& t1v1,
 	const Eigen::Matrix<T, 3, 1, MOpt>& t1v2,
 	const Eigen::Matrix<T, 3, 1, MOpt>& t0n,
-	const Eigen::Matrix<T, 3, 1, MOpt>& t1n)
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1n,
+	Eigen::Matrix<T, 3, 1, MOpt>* t0Distances,
+	Eigen::Matrix<T, 3, 1, MOpt>* t1Distances)
 {
-	typedef Eigen::Matrix<T, 3, 1, MOpt> Vector3;
 	using SurgSim::Math::Geometry::DistanceEpsilon;
 
+	// Check if all the vertices of T2 are on one side of p1.
+	// Plane eqn of T1: DotProduct(t0n, X) + distanceFromOrigin = 0
+	// where distanceFromOrigin = -DotProduct(t0n, t0v0)
+	// So, plane eqn of T1: DotProduct(t0n, X - t0v0) = 0
+	// Distance of first vertex of T2 from the plane of T1 is: DotProduct(t0n, t1v0 - t0v0)
+	*t1Distances << t0n.dot(t1v0 - t0v0), t0n.dot(t1v1 - t0v0), t0n.dot(t1v2 - t0v0);
+	if ((t1Distances->array() < DistanceEpsilon).all() || (t1Distances->array() > -DistanceEpsilon).all())
+	{
+		return true;
+	}
+
+	// Check if all the vertices of T1 are on one side of p2.
+	*t0Distances << t1n.dot(t0v0 - t1v0), t1n.dot(t0v1 - t1v0), t1n.dot(t0v2 - t1v0);
+	return (t0Distances->array() < DistanceEpsilon).all() || (t0Distances->array() > -DistanceEpsilon).all();
+}
+
+template <class T, int MOpt> inline
+bool doesIntersectTriangleTriangle(
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0v0,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0v1,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0v2,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1v0,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1v1,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1v2,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0n,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1n)
+{
 	if (t0n.isZero() || t1n.isZero())
 	{
 		// Degenerate triangle(s) passed to checkTriangleTriangleIntersection.
 		return false;
 	}
 
+	Eigen::Matrix<T, 3, 1, MOpt> t0Distances, t1Distances;
+	if (isTriangleTriangleRejected(t0v0, t0v1, t0v2, t1v0, t1v1, t1v2, t0n, t1n, &t0Distances, &t1Distances))
+	{
+		return false;
+	}
+	return doesIntersectTriangleTriangle(t0v0, t0v1, t0v2, t1v0, t1v1, t1v2, t0n, t1n, t0Distances, t1Distances);
+}
+
+template <class T, int MOpt> inline
+bool doesIntersectTriangleTriangle(
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0v0,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0v1,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0v2,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1v0,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1v1,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1v2,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0n,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1n,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t0Distances,
+	const Eigen::Matrix<T, 3, 1, MOpt>& t1Distances)
+{
+	typedef Eigen::Matrix<T, 3, 1, MOpt> Vector3;
+	using SurgSim::Math::Geometry::DistanceEpsilon;
+
 	// Variable names mentioned here are the notations used in the paper:
 	// T1		- Triangle with vertices (t0v0, t0v1, t0v2).
 	// T2		- Triangle with vertices (t1v0, t1v1, t1v2).
@@ -99,29 +162,9 @@ bool doesIntersectTriangleTriangle(
 	// s2[2]	- The intersection between T2 and D is a line segment.
 	//			  s2[0] and s2[1] are the parametric representation of the ends of this line segment.
 
-	// Early Rejection test:
-	// If all the vertices of one triangle are on one side of the plane of the other triangle,
-	// there is no intersection.
-
-	// Check if all the vertices of T2 are on one side of p1.
-	// Plane eqn of T1: DotProduct(t0n, X) + distanceFromOrigin = 0
-	// where distanceFromOrigin = -DotProduct(t0n, t0v0)
-	// So, plane eqn of T1: DotProduct(t0n, X - t0v0) = 0
-	// Distance of first vertex of T2 from the plane of T1 is: DotProduct(t0n, t1v0 - t0v0)
-	Vector3 d2(t0n.dot(t1v0 - t0v0), t0n.dot(t1v1 - t0v0), t0n.dot(t1v2 - t0v0));
-
-	if ((d2.array() < DistanceEpsilon).all() || (d2.array() > -DistanceEpsilon).all())
-	{
-		return false;
-	}
-
-	// Check if all the vertices of T1 are on one side of p2.
-	Vector3 d1(t1n.dot(t0v0 - t1v0), t1n.dot(t0v1 - t1v0), t1n.dot(t0v2 - t1v0));
-
-	if ((d1.array() < DistanceEpsilon).all() || (d1.array() > -DistanceEpsilon).all())
-	{
-		return false;
-	}
+	// The early rejection has been done, it gave the signed distances
+	const Vector3& d1 = t0Distances;
+	const Vector3& d2 = t1Distances;
 
 	// The separating axis.
 	Vector3 D = t0n.cross(t1n).normalized();
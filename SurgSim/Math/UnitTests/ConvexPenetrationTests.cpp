@@ -0,0 +1,177 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "SurgSim/DataStructures/TriangleMesh.h"
+#include "SurgSim/Framework/Assert.h"
+#include "SurgSim/Math/BoxShape.h"
+#include "SurgSim/Math/CapsuleShape.h"
+#include "SurgSim/Math/ConvexPenetration.h"
+#include "SurgSim/Math/CylinderShape.h"
+#include "SurgSim/Math/MeshShape.h"
+#include "SurgSim/Math/Quaternion.h"
+#include "SurgSim/Math/RigidTransform.h"
+#include "SurgSim/Math/SphereShape.h"
+
+namespace SurgSim
+{
+namespace Math
+{
+
+namespace
+{
+
+/// Check that a direction separates two convex shapes
+bool isSeparatingAxis(const Shape& shape1, const RigidTransform3d& pose1,
+					  const Shape& shape2, const RigidTransform3d& pose2, const Vector3d& axis)
+{
+	double max1 = axis.dot(pose1 * shape1.getSupport(pose1.linear().transpose() * axis));
+	double min2 = axis.dot(pose2 * shape2.getSupport(pose2.linear().transpose() * -axis));
+	return max1 <= min2;
+}
+
+}
+
+TEST(ConvexPenetrationTests, SphereSphereTest)
+{
+	SphereShape sphere1(0.5);
+	SphereShape sphere2(0.3);
+	Vector3d normal, point1, point2;
+	double depth;
+
+	{
+		SCOPED_TRACE("Separated");
+		RigidTransform3d pose1 = makeRigidTransform(Quaterniond::Identity(), Vector3d(0.1, 0.2, 0.3));
+		RigidTransform3d pose2 = makeRigidTransform(Quaterniond::Identity(), Vector3d(0.1, 1.2, 0.3));
+		Vector3d direction = Vector3d::Zero();
+		EXPECT_FALSE(calculateConvexPenetration(sphere1, pose1, sphere2, pose2, &direction,
+					 &normal, &depth, &point1, &point2));
+		EXPECT_TRUE(isSeparatingAxis(sphere1, pose1, sphere2, pose2, direction));
+	}
+
+	std::srand(42);
+	for (size_t i = 0; i < 20; ++i)
+	{
+		SCOPED_TRACE(i);
+		Vector3d center1 = Vector3d::Random();
+		Vector3d center2 = center1 + Vector3d::Random().normalized() * (0.2 + 0.5 * std::abs(Vector3d::Random()[0]));
+		RigidTransform3d pose1 = makeRigidTransform(Quaterniond(Vector4d::Random().normalized()), center1);
+		RigidTransform3d pose2 = makeRigidTransform(Quaterniond(Vector4d::Random().normalized()), center2);
+
+		Vector3d direction = Vector3d::Zero();
+		ASSERT_TRUE(calculateConvexPenetration(sphere1, pose1, sphere2, pose2, &direction,
+					&normal, &depth, &point1, &point2));
+
+		Vector3d expectedNormal = (center1 - center2).normalized();
+		double expectedDepth = 0.8 - (center1 - center2).norm();
+		EXPECT_NEAR(expectedDepth, depth, 2.0 * ConvexPenetrationRelativePrecision);
+		EXPECT_NEAR(1.0, normal.norm(), 1e-10);
+		EXPECT_LT((expectedNormal - normal).norm(), 0.05);
+		EXPECT_NEAR(0.5, (point1 - center1).norm(), 0.01);
+		EXPECT_NEAR(0.3, (point2 - center2).norm(), 0.01);
+		EXPECT_TRUE((point1 - point2).isApprox(-depth * normal, 1e-6));
+
+		// Starting from the last direction gives the same result
+		Vector3d warmNormal, warmPoint1, warmPoint2;
+		double warmDepth;
+		ASSERT_TRUE(calculateConvexPenetration(sphere1, pose1, sphere2, pose2, &direction,
+					&warmNormal, &warmDepth, &warmPoint1, &warmPoint2));
+		EXPECT_NEAR(depth, warmDepth, 2.0 * ConvexPenetrationRelativePrecision);
+	}
+}
+
+TEST(ConvexPenetrationTests, BoxBoxTest)
+{
+	BoxShape box1(1.0, 1.0, 1.0);
+	BoxShape box2(1.0, 2.0, 1.0);
+	RigidTransform3d pose1 = RigidTransform3d::Identity();
+	RigidTransform3d pose2 = makeRigidTransform(Quaterniond::Identity(), Vector3d(0.9, 0.1, 0.05));
+	Vector3d direction = Vector3d::Zero();
+	Vector3d normal, point1, point2;
+	double depth;
+
+	ASSERT_TRUE(calculateConvexPenetration(box1, pose1, box2, pose2, &direction, &normal, &depth, &point1, &point2));
+	EXPECT_NEAR(0.1, depth, 1e-9);
+	EXPECT_TRUE(normal.isApprox(-Vector3d::UnitX()));
+	EXPECT_NEAR(0.5, point1[0], 1e-9);
+	EXPECT_NEAR(0.4, point2[0], 1e-9);
+
+	// Swapping the shapes swaps the normal
+	direction.setZero();
+	ASSERT_TRUE(calculateConvexPenetration(box2, pose2, box1, pose1, &direction, &normal, &depth, &point1, &point2));
+	EXPECT_NEAR(0.1, depth, 1e-9);
+	EXPECT_TRUE(normal.isApprox(Vector3d::UnitX()));
+
+	// Rotated by 45 degrees around Z, the corner of the second box goes into the first one
+	pose2 = makeRigidTransform(makeRotationQuaternion(M_PI_4, Vector3d::UnitZ().eval()), Vector3d(1.1, 0.0, 0.0));
+	BoxShape box3(1.0, 1.0, 1.0);
+	direction.setZero();
+	ASSERT_TRUE(calculateConvexPenetration(box1, pose1, box3, pose2, &direction, &normal, &depth, &point1, &point2));
+	EXPECT_NEAR(0.5 + std::sqrt(0.5) - 1.1, depth, 1e-9);
+	EXPECT_TRUE(normal.isApprox(-Vector3d::UnitX()));
+
+	pose2.translation() = Vector3d(1.3, 0.0, 0.0);
+	direction.setZero();
+	EXPECT_FALSE(calculateConvexPenetration(box1, pose1, box3, pose2, &direction, &normal, &depth, &point1,
+											&point2));
+	EXPECT_TRUE(isSeparatingAxis(box1, pose1, box3, pose2, direction));
+}
+
+TEST(ConvexPenetrationTests, CapsuleCylinderTest)
+{
+	// A capsule along Y crossing a cylinder along X
+	CapsuleShape capsule(1.0, 0.1);
+	CylinderShape cylinder(1.0, 0.2);
+	RigidTransform3d capsulePose = RigidTransform3d::Identity();
+	RigidTransform3d cylinderPose = makeRigidTransform(makeRotationQuaternion(M_PI_2, Vector3d::UnitZ().eval()),
+									Vector3d(0.0, 0.0, 0.25));
+	Vector3d direction = Vector3d::Zero();
+	Vector3d normal, point1, point2;
+	double depth;
+
+	ASSERT_TRUE(calculateConvexPenetration(capsule, capsulePose, cylinder, cylinderPose, &direction,
+										   &normal, &depth, &point1, &point2));
+	EXPECT_NEAR(0.05, depth, 1e-4);
+	EXPECT_LT((normal + Vector3d::UnitZ()).norm(), 1e-2);
+
+	cylinderPose.translation() = Vector3d(0.0, 0.0, 0.35);
+	EXPECT_FALSE(calculateConvexPenetration(capsule, capsulePose, cylinder, cylinderPose, &direction,
+											&normal, &depth, &point1, &point2));
+	EXPECT_TRUE(isSeparatingAxis(capsule, capsulePose, cylinder, cylinderPose, direction));
+
+	// The cap of the cylinder against the end of the capsule
+	cylinderPose = makeRigidTransform(Quaterniond::Identity(), Vector3d(0.0, 1.05, 0.0));
+	direction.setZero();
+	ASSERT_TRUE(calculateConvexPenetration(capsule, capsulePose, cylinder, cylinderPose, &direction,
+										   &normal, &depth, &point1, &point2));
+	EXPECT_NEAR(0.05, depth, 1e-4);
+	EXPECT_LT((normal + Vector3d::UnitY()).norm(), 1e-2);
+}
+
+TEST(ConvexPenetrationTests, NonConvexTest)
+{
+	SphereShape sphere(1.0);
+	MeshShape mesh;
+	Vector3d direction = Vector3d::Zero();
+	Vector3d normal, point1, point2;
+	double depth;
+	EXPECT_THROW(calculateConvexPenetration(sphere, RigidTransform3d::Identity(), mesh, RigidTransform3d::Identity(),
+											&direction, &normal, &depth, &point1, &point2),
+				 Framework::AssertionFailure);
+}
+
+};
+};
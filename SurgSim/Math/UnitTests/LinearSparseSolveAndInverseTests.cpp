@@ -36,6 +36,17 @@ class LinearSparseSolveAndInverseTests : public ::testing::Test
 		initializeSparseMatrix(&matrix);
 	}
 
+	/// Replace the matrices by a symmetric positive definite one, with the same sparsity pattern
+	void setupSymmetricSparseMatrixTest()
+	{
+		setupSparseMatrixTest();
+		denseMatrix = denseMatrix.transpose() * denseMatrix + Matrix::Identity(size, size);
+		matrix = denseMatrix.sparseView();
+		matrix.makeCompressed();
+		expectedInverse = denseMatrix.inverse();
+		expectedX = expectedInverse * b;
+	}
+
 	SparseMatrix matrix;
 	Matrix denseMatrix, inverseMatrix, expectedInverse;
 	Vector b;
@@ -124,6 +135,94 @@ TEST_F(LinearSparseSolveAndInverseTests, SparseLUMatrixComponentsTest)
 
 	inverseMatrix = solveAndInverse.solve(denseMatrix);
 	EXPECT_TRUE(inverseMatrix.isApprox(Matrix::Identity(18, 18)));
+
+	// The vector solve reuses the given vector
+	Vector solution = Vector::Zero(18);
+	const double* data = solution.data();
+	solveAndInverse.solve(b, &solution);
+	EXPECT_TRUE(solution.isApprox(expectedX));
+	EXPECT_EQ(data, solution.data());
+};
+
+TEST_F(LinearSparseSolveAndInverseTests, SparseLDLTInitializationTests)
+{
+	SparseMatrix nonSquare(9, 18);
+	SparseMatrix square(18, 18);
+	nonSquare.setZero();
+
+	for (SparseMatrix::Index counter = 0; counter < 18; ++counter)
+	{
+		square.insert(counter, counter) = 1.0;
+	}
+	square.makeCompressed();
+
+	LinearSparseSolveAndInverseLDLT solveAndInverse;
+	EXPECT_EQ(0u, solveAndInverse.getMaxFactorizationReuse());
+	EXPECT_THROW(solveAndInverse.setMatrix(nonSquare), SurgSim::Framework::AssertionFailure);
+	EXPECT_NO_THROW(solveAndInverse.setMatrix(square));
+
+	clearMatrix(&square);
+	EXPECT_THROW(solveAndInverse.setMatrix(square), SurgSim::Framework::AssertionFailure);
+
+	solveAndInverse.setMaxFactorizationReuse(3);
+	EXPECT_EQ(3u, solveAndInverse.getMaxFactorizationReuse());
+};
+
+TEST_F(LinearSparseSolveAndInverseTests, SparseLDLTMatrixComponentsTest)
+{
+	setupSymmetricSparseMatrixTest();
+
+	LinearSparseSolveAndInverseLDLT solveAndInverse;
+	solveAndInverse.setMatrix(matrix);
+	x = solveAndInverse.solve(b);
+	inverseMatrix = solveAndInverse.getInverse();
+
+	EXPECT_TRUE(x.isApprox(expectedX));
+	EXPECT_TRUE(inverseMatrix.isApprox(expectedInverse));
+
+	inverseMatrix = solveAndInverse.solve(denseMatrix);
+	EXPECT_TRUE(inverseMatrix.isApprox(Matrix::Identity(18, 18)));
+};
+
+TEST_F(LinearSparseSolveAndInverseTests, SparseLDLTFactorizationReuseTest)
+{
+	setupSymmetricSparseMatrixTest();
+	SparseMatrix scaledMatrix = 2.0 * matrix;
+
+	LinearSparseSolveAndInverseLDLT solveAndInverse;
+	solveAndInverse.setMatrix(matrix);
+	EXPECT_EQ(1u, solveAndInverse.getNumAnalyzePattern());
+	EXPECT_EQ(1u, solveAndInverse.getNumFactorizations());
+
+	// Same pattern, only the numerical factorization is done
+	solveAndInverse.setMatrix(scaledMatrix);
+	EXPECT_EQ(1u, solveAndInverse.getNumAnalyzePattern());
+	EXPECT_EQ(2u, solveAndInverse.getNumFactorizations());
+	EXPECT_TRUE(solveAndInverse.solve(b).isApprox(0.5 * expectedX));
+
+	// The factorization of scaledMatrix is reused for the next 2 calls
+	solveAndInverse.setMaxFactorizationReuse(2);
+	solveAndInverse.setMatrix(matrix);
+	solveAndInverse.setMatrix(matrix);
+	EXPECT_EQ(2u, solveAndInverse.getNumFactorizations());
+	EXPECT_TRUE(solveAndInverse.solve(b).isApprox(0.5 * expectedX));
+	EXPECT_TRUE(solveAndInverse.getInverse().isApprox(0.5 * expectedInverse));
+
+	solveAndInverse.setMatrix(matrix);
+	EXPECT_EQ(3u, solveAndInverse.getNumFactorizations());
+	EXPECT_TRUE(solveAndInverse.solve(b).isApprox(expectedX));
+
+	// A different pattern is always analyzed and factorized
+	SparseMatrix diagonal(18, 18);
+	for (SparseMatrix::Index counter = 0; counter < 18; ++counter)
+	{
+		diagonal.insert(counter, counter) = 2.0;
+	}
+	diagonal.makeCompressed();
+	solveAndInverse.setMatrix(diagonal);
+	EXPECT_EQ(2u, solveAndInverse.getNumAnalyzePattern());
+	EXPECT_EQ(4u, solveAndInverse.getNumFactorizations());
+	EXPECT_TRUE(solveAndInverse.solve(b).isApprox(0.5 * b));
 };
 
 TEST_F(LinearSparseSolveAndInverseTests, SparseCGSetGetTests)
@@ -192,6 +291,76 @@ TEST_F(LinearSparseSolveAndInverseTests, SparseCGMatrixComponentsTest)
 
 };
 
+TEST_F(LinearSparseSolveAndInverseTests, DiagonalInitializationTests)
+{
+	SparseMatrix nonSquare(9, 18);
+	SparseMatrix diagonal(18, 18);
+	nonSquare.setZero();
+
+	for (SparseMatrix::Index counter = 0; counter < 18; ++counter)
+	{
+		diagonal.insert(counter, counter) = 1.0;
+	}
+	diagonal.makeCompressed();
+
+	LinearSparseSolveAndInverseDiagonal solveAndInverse;
+	EXPECT_THROW(solveAndInverse.setMatrix(nonSquare), SurgSim::Framework::AssertionFailure);
+	EXPECT_NO_THROW(solveAndInverse.setMatrix(diagonal));
+
+	// A stored zero outside of the diagonal is accepted, a non-zero value is not
+	SparseMatrix nonDiagonal = diagonal;
+	nonDiagonal.coeffRef(3, 4) = 0.0;
+	EXPECT_NO_THROW(solveAndInverse.setMatrix(nonDiagonal));
+	nonDiagonal.coeffRef(3, 4) = 1.0;
+	EXPECT_THROW(solveAndInverse.setMatrix(nonDiagonal), SurgSim::Framework::AssertionFailure);
+
+	diagonal.coeffRef(5, 5) = 0.0;
+	EXPECT_THROW(solveAndInverse.setMatrix(diagonal), SurgSim::Framework::AssertionFailure);
+
+	setupSparseMatrixTest();
+	EXPECT_THROW(solveAndInverse.setMatrix(matrix), SurgSim::Framework::AssertionFailure);
+};
+
+TEST_F(LinearSparseSolveAndInverseTests, DiagonalMatrixComponentsTest)
+{
+	Vector diagonalValues(18);
+	for (Vector::Index i = 0; i < 18; ++i)
+	{
+		diagonalValues[i] = 0.5 + static_cast<double>(i);
+	}
+	diagonalValues[7] = -3.0;
+	SparseMatrix diagonal(18, 18);
+	for (SparseMatrix::Index counter = 0; counter < 18; ++counter)
+	{
+		diagonal.insert(counter, counter) = diagonalValues[counter];
+	}
+	diagonal.makeCompressed();
+	expectedX = b.cwiseQuotient(diagonalValues);
+
+	LinearSparseSolveAndInverseDiagonal solveAndInverse;
+	solveAndInverse.setMatrix(diagonal);
+	EXPECT_TRUE(solveAndInverse.getInverseDiagonal().isApprox(diagonalValues.cwiseInverse()));
+
+	x = solveAndInverse.solve(b);
+	EXPECT_TRUE(x.isApprox(expectedX));
+
+	Vector solution = Vector::Zero(18);
+	const double* data = solution.data();
+	solveAndInverse.solve(b, &solution);
+	EXPECT_TRUE(solution.isApprox(expectedX));
+	EXPECT_EQ(data, solution.data());
+
+	inverseMatrix = solveAndInverse.getInverse();
+	EXPECT_TRUE(inverseMatrix.isApprox(Matrix(diagonalValues.cwiseInverse().asDiagonal())));
+
+	// Same results as the general solver
+	LinearSparseSolveAndInverseLU lu;
+	lu.setMatrix(diagonal);
+	EXPECT_TRUE(x.isApprox(lu.solve(b)));
+	EXPECT_TRUE(inverseMatrix.isApprox(lu.getInverse()));
+	EXPECT_TRUE(solveAndInverse.solve(denseMatrix).isApprox(lu.solve(denseMatrix)));
+};
+
 }; // namespace Math
 
 }; // namespace SurgSim
@@ -20,6 +20,7 @@
 #include "SurgSim/DataStructures/AabbTree.h"
 #include "SurgSim/DataStructures/AabbTreeNode.h"
 #include "SurgSim/DataStructures/EmptyData.h"
+#include "SurgSim/DataStructures/FlatAabbTree.h"
 #include "SurgSim/Framework/ApplicationData.h"
 #include "SurgSim/Framework/Runtime.h"
 #include "SurgSim/Math/BoxShape.h"
@@ -291,6 +292,51 @@ TEST_F(MeshShapeTest, CreateAabbTreeTest)
 	}
 
 	EXPECT_TRUE(meshShape->getBoundingBox().isApprox(tree->getAabb()));
+
+	// The tree is kept until the next update
+	EXPECT_EQ(tree, meshShape->getAabbTree());
+	meshShape->setVertexPosition(0, vertices[0].position + Vector3d(0.1, 0.0, 0.0));
+	meshShape->update();
+	auto updatedTree = meshShape->getAabbTree();
+	EXPECT_NE(tree, updatedTree);
+	EXPECT_TRUE(meshShape->getBoundingBox().isApprox(updatedTree->getAabb()));
+}
+
+TEST_F(MeshShapeTest, CreateFlatAabbTreeTest)
+{
+	const std::string fileName = "Geometry/staple_collision.ply";
+	auto meshShape = std::make_shared<MeshShape>();
+	EXPECT_NO_THROW(meshShape->load(fileName));
+
+	auto tree = meshShape->getFlatAabbTree();
+	ASSERT_NE(nullptr, tree);
+
+	auto triangles = meshShape->getTriangles();
+	auto vertices = meshShape->getVertices();
+
+	// Every triangle is in exactly one leaf, whose box contains it
+	std::vector<size_t> numLeaves(triangles.size(), 0);
+	for (size_t node = 0; node < tree->getNumNodes(); ++node)
+	{
+		if (tree->isLeaf(node))
+		{
+			for (auto id : tree->getNodeObjects(node))
+			{
+				ASSERT_LT(id, triangles.size());
+				auto ids = triangles[id].verticesId;
+				EXPECT_TRUE(tree->getNodeAabb(node).contains(makeAabb(
+						vertices[ids[0]].position, vertices[ids[1]].position, vertices[ids[2]].position)));
+				++numLeaves[id];
+			}
+		}
+	}
+	for (auto count : numLeaves)
+	{
+		EXPECT_EQ(1u, count);
+	}
+
+	EXPECT_TRUE(meshShape->getBoundingBox().isApprox(tree->getAabb()));
+	EXPECT_TRUE(meshShape->getAabbTree()->getAabb().isApprox(tree->getAabb()));
 }
 
 TEST_F(MeshShapeTest, TransformTest)
@@ -31,6 +31,8 @@
 
 using SurgSim::Math::isValid;
 using SurgSim::Math::MlcpGaussSeidelSolver;
+using SurgSim::Math::MlcpProblem;
+using SurgSim::Math::MlcpSolution;
 
 TEST(MlcpGaussSeidelSolverTests, CanConstruct)
 {
@@ -135,6 +137,70 @@ TEST(MlcpGaussSeidelSolverTests, SolveSequence)
 	}
 }
 
+static void compareSparseAndDense(const MlcpProblem& problem, double gsSolverPrecision, double gsContactTolerance,
+								  int gsMaxIterations)
+{
+	MlcpGaussSeidelSolver denseSolver(gsSolverPrecision, gsContactTolerance, gsMaxIterations);
+	MlcpGaussSeidelSolver sparseSolver(gsSolverPrecision, gsContactTolerance, gsMaxIterations);
+	EXPECT_FALSE(sparseSolver.isUsingSparseMatrix());
+	sparseSolver.setUseSparseMatrix(true);
+	EXPECT_TRUE(sparseSolver.isUsingSparseMatrix());
+
+	MlcpSolution denseSolution;
+	denseSolution.x.setZero(problem.getSize());
+	MlcpSolution sparseSolution;
+	sparseSolution.x.setZero(problem.getSize());
+
+	EXPECT_EQ(denseSolver.solve(problem, &denseSolution), sparseSolver.solve(problem, &sparseSolution));
+	EXPECT_EQ(denseSolution.numIterations, sparseSolution.numIterations);
+	EXPECT_EQ(denseSolution.validSignorini, sparseSolution.validSignorini);
+	EXPECT_TRUE(sparseSolution.x.isApprox(denseSolution.x)) << "sparse:" << std::endl <<
+		sparseSolution.x.transpose() << std::endl << "dense:" << std::endl << denseSolution.x.transpose();
+}
+
+TEST(MlcpGaussSeidelSolverTests, SolveSparse)
+{
+	{
+		SCOPED_TRACE("while running test mlcpOriginalTest.txt");
+		const std::shared_ptr<MlcpTestData> data = loadTestData("mlcpOriginalTest.txt");
+		ASSERT_TRUE(data != nullptr);
+		compareSparseAndDense(data->problem, 1e-4, 2e-4, 30);
+	}
+
+	std::vector<std::shared_ptr<MlcpTestData>> data;
+	for (int i = 0;  i <= 9;  ++i)
+	{
+		const std::string fileName = getTestFileName("mlcpTest", i, ".txt");
+		SCOPED_TRACE("while running test " + fileName);
+		data.push_back(loadTestData(fileName));
+		ASSERT_TRUE(data.back() != nullptr);
+		compareSparseAndDense(data.back()->problem, 1e-9, 1e-9, 100);
+	}
+
+	// Block diagonal problem made of uncoupled problems, these only hold contacts as the solver expects the
+	// bilateral constraints to come first
+	data.resize(4);
+	size_t size = 0;
+	for (const auto& test : data)
+	{
+		size += test->getSize();
+	}
+
+	MlcpProblem problem = MlcpProblem::Zero(size, size, 0);
+	size_t index = 0;
+	for (const auto& test : data)
+	{
+		const size_t testSize = test->getSize();
+		problem.A.block(index, index, testSize, testSize) = test->problem.A;
+		problem.b.segment(index, testSize) = test->problem.b;
+		problem.mu.segment(index, testSize) = test->problem.mu;
+		problem.constraintTypes.insert(problem.constraintTypes.end(), test->problem.constraintTypes.begin(),
+									   test->problem.constraintTypes.end());
+		index += testSize;
+	}
+	compareSparseAndDense(problem, 1e-9, 1e-9, 100);
+}
+
 static void solveRepeatedly(const MlcpTestData& data,
 							/*XXX const */ MlcpGaussSeidelSolver* mlcpSolver,
 							const int repetitions)
@@ -121,6 +121,46 @@ class MassPoint : public OdeEquation
 	}
 };
 
+/// Mass point exposing its diagonal mass, counting the evaluations of its mass matrix
+class LumpedMassPoint : public MassPoint
+{
+public:
+	/// Constructor
+	/// \param viscosity The mass viscosity
+	explicit LumpedMassPoint(double viscosity = 0.0) :
+		MassPoint(viscosity),
+		m_lumpedMass(Vector::Constant(3, m_mass)),
+		m_numMassEvaluations(0)
+	{
+	}
+
+	bool hasDiagonalMass() const override
+	{
+		return true;
+	}
+
+	const Vector& getLumpedMass() const override
+	{
+		return m_lumpedMass;
+	}
+
+	Vector m_lumpedMass;
+	size_t m_numMassEvaluations;
+
+protected:
+	void computeM(const OdeState& state) override
+	{
+		++m_numMassEvaluations;
+		MassPoint::computeM(state);
+	}
+
+	void computeFMDK(const OdeState& state) override
+	{
+		++m_numMassEvaluations;
+		MassPoint::computeFMDK(state);
+	}
+};
+
 
 
 /// State class for static resolution
@@ -21,6 +21,7 @@
 
 #include <gtest/gtest.h>
 
+#include "SurgSim/Math/LinearSparseSolveAndInverse.h"
 #include "SurgSim/Math/OdeSolverEulerExplicit.h"
 #include "SurgSim/Math/OdeSolverLinearEulerExplicit.h"
 #include "SurgSim/Math/UnitTests/MockObject.h"
@@ -165,6 +166,56 @@ TEST(OdeSolverEulerExplicit, ComputeMatricesTest)
 	}
 }
 
+namespace
+{
+template <class T>
+void doLumpedMassTest()
+{
+	MassPoint m(0.1);
+	LumpedMassPoint lumpedM(0.1);
+	MassPointState state;
+	state.getVelocities().setConstant(1.0);
+	state.addBoundaryCondition(0, 1);
+	const double dt = 1e-3;
+
+	auto solver = std::make_shared<T>(&m);
+	m.setOdeSolver(solver);
+	auto lumpedSolver = std::make_shared<T>(&lumpedM);
+	lumpedM.setOdeSolver(lumpedSolver);
+	lumpedSolver->setLinearSolver(std::make_shared<LinearSparseSolveAndInverseDiagonal>());
+
+	// The diagonal mass gives the same steps without evaluating the mass matrix
+	MassPointState newState, newLumpedState;
+	ASSERT_NO_THROW(solver->solve(dt, state, &newState, true));
+	ASSERT_NO_THROW(lumpedSolver->solve(dt, state, &newLumpedState, true));
+	EXPECT_TRUE(newLumpedState.getPositions().isApprox(newState.getPositions()));
+	EXPECT_TRUE(newLumpedState.getVelocities().isApprox(newState.getVelocities()));
+	EXPECT_TRUE(lumpedSolver->getComplianceMatrix().isApprox(solver->getComplianceMatrix()));
+	EXPECT_EQ(0u, lumpedM.m_numMassEvaluations);
+
+	// Without the diagonal linear solver, the mass matrix is assembled
+	LumpedMassPoint assembledM(0.1);
+	auto assembledSolver = std::make_shared<T>(&assembledM);
+	assembledM.setOdeSolver(assembledSolver);
+	ASSERT_NO_THROW(assembledSolver->solve(dt, state, &newLumpedState));
+	EXPECT_TRUE(newLumpedState.getVelocities().isApprox(newState.getVelocities()));
+	EXPECT_LT(0u, assembledM.m_numMassEvaluations);
+}
+};
+
+TEST(OdeSolverEulerExplicit, LumpedMassTest)
+{
+	{
+		SCOPED_TRACE("EulerExplicit");
+		doLumpedMassTest<OdeSolverEulerExplicit>();
+	}
+
+	{
+		SCOPED_TRACE("LinearEulerExplicit");
+		doLumpedMassTest<OdeSolverLinearEulerExplicit>();
+	}
+}
+
 }; // Math
 
 }; // SurgSim
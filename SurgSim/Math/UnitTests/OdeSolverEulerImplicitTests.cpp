@@ -21,6 +21,7 @@
 
 #include <gtest/gtest.h>
 
+#include "SurgSim/Framework/Assert.h"
 #include "SurgSim/Math/OdeSolverEulerImplicit.h"
 #include "SurgSim/Math/OdeSolverLinearEulerImplicit.h"
 #include "SurgSim/Math/UnitTests/MockObject.h"
@@ -251,6 +252,263 @@ TEST(OdeSolverEulerImplicit, ComputeMatricesTest)
 	}
 }
 
+TEST(OdeSolverEulerImplicit, MatrixFreeTest)
+{
+	{
+		MassPoint m;
+		OdeSolverEulerImplicit solver(&m);
+		EXPECT_FALSE(solver.isMatrixFree());
+		solver.setMatrixFree(true);
+		EXPECT_TRUE(solver.isMatrixFree());
+		solver.setMatrixFreeMaximumIteration(12);
+		EXPECT_EQ(12u, solver.getMatrixFreeMaximumIteration());
+		solver.setMatrixFreeTolerance(1e-10);
+		EXPECT_DOUBLE_EQ(1e-10, solver.getMatrixFreeTolerance());
+
+		OdeSolverLinearEulerImplicit linearSolver(&m);
+		linearSolver.setMatrixFree(true);
+		MassPointState state0, state1;
+		EXPECT_THROW(linearSolver.solve(1e-3, state0, &state1), SurgSim::Framework::AssertionFailure);
+	}
+
+	{
+		SCOPED_TRACE("Damped mass point");
+		MassPoint m(0.1);
+		auto solver = std::make_shared<OdeSolverEulerImplicit>(&m);
+		auto matrixFreeSolver = std::make_shared<OdeSolverEulerImplicit>(&m);
+		matrixFreeSolver->setMatrixFree(true);
+		MassPointState state0, expected, state1;
+		m.setOdeSolver(solver);
+		solver->solve(1e-3, state0, &expected);
+
+		Matrix b = Matrix::Random(3, 2);
+		Matrix x;
+		EXPECT_THROW(solver->solveMatrixFree(state0, b, &x), SurgSim::Framework::AssertionFailure);
+		EXPECT_THROW(matrixFreeSolver->solveMatrixFree(state0, b, &x), SurgSim::Framework::AssertionFailure);
+
+		m.setOdeSolver(matrixFreeSolver);
+		ASSERT_NO_THROW(matrixFreeSolver->solve(1e-3, state0, &state1, false));
+		EXPECT_TRUE(state1.getVelocities().isApprox(expected.getVelocities()));
+		EXPECT_TRUE(state1.getPositions().isApprox(expected.getPositions()));
+
+		// The compliance is applied column by column with the conjugate gradient
+		ASSERT_NO_THROW(matrixFreeSolver->solveMatrixFree(state0, b, &x));
+		EXPECT_TRUE(x.isApprox(solver->getComplianceMatrix() * b));
+
+		// The compliance matrix is still available when requested
+		ASSERT_NO_THROW(matrixFreeSolver->solve(1e-3, state0, &state1, true));
+		EXPECT_TRUE(matrixFreeSolver->getComplianceMatrix().isApprox(solver->getComplianceMatrix()));
+	}
+
+	{
+		SCOPED_TRACE("Non linear equation with multiple Newton-Raphson iterations");
+		OdeComplexNonLinear odeEquation;
+		MassPointState state0, expected, state1;
+		state0.getPositions().setLinSpaced(1.4, 5.67);
+		state0.getVelocities().setLinSpaced(-0.4, -0.3);
+
+		auto solver = std::make_shared<OdeSolverEulerImplicit>(&odeEquation);
+		odeEquation.setOdeSolver(solver);
+		solver->setNewtonRaphsonMaximumIteration(10);
+		solver->setNewtonRaphsonEpsilonConvergence(1e-13);
+		solver->solve(1e-3, state0, &expected, false);
+
+		solver->setMatrixFree(true);
+		solver->setMatrixFreeTolerance(1e-14);
+		ASSERT_NO_THROW(solver->solve(1e-3, state0, &state1, false));
+		EXPECT_TRUE(state1.getVelocities().isApprox(expected.getVelocities()));
+		EXPECT_TRUE(state1.getPositions().isApprox(expected.getPositions()));
+		EXPECT_LE(solver->getMatrixFreeSolver().getRelativeResidual(), 1e-14);
+	}
+}
+
+namespace
+{
+/// Mass point attached to the origin by a spring whose stiffness can be changed between the time steps
+class SpringMassPoint : public MassPoint
+{
+public:
+	explicit SpringMassPoint(double stiffness) : MassPoint(0.1), m_stiffness(stiffness)
+	{
+	}
+
+	double m_stiffness;
+
+protected:
+	void computeF(const OdeState& state) override
+	{
+		MassPoint::computeF(state);
+		m_f -= m_stiffness * state.getPositions();
+	}
+
+	void computeK(const OdeState& state) override
+	{
+		m_K.setIdentity();
+		m_K *= m_stiffness;
+	}
+
+	void computeFMDK(const OdeState& state) override
+	{
+		computeF(state);
+		computeM(state);
+		computeD(state);
+		computeK(state);
+	}
+};
+};
+
+TEST(OdeSolverEulerImplicit, ModifiedNewtonTest)
+{
+	{
+		MassPoint m;
+		OdeSolverEulerImplicit solver(&m);
+		EXPECT_FALSE(solver.isModifiedNewton());
+		solver.setModifiedNewton(true);
+		EXPECT_TRUE(solver.isModifiedNewton());
+		solver.setModifiedNewtonStallRatio(0.25);
+		EXPECT_DOUBLE_EQ(0.25, solver.getModifiedNewtonStallRatio());
+		EXPECT_THROW(solver.setModifiedNewtonStallRatio(0.0), SurgSim::Framework::AssertionFailure);
+		solver.setModifiedNewtonMaximumReuse(3);
+		EXPECT_EQ(3u, solver.getModifiedNewtonMaximumReuse());
+	}
+
+	{
+		SCOPED_TRACE("The factorization is reused over the time steps");
+		MassPoint m(0.1);
+		auto solver = std::make_shared<OdeSolverEulerImplicit>(&m);
+		m.setOdeSolver(solver);
+		solver->setModifiedNewton(true);
+		solver->setModifiedNewtonMaximumReuse(2);
+		MassPointState state0, state1, expected;
+		OdeSolverEulerImplicit(&m).solve(1e-3, state0, &expected, false);
+
+		solver->solve(1e-3, state0, &state1);
+		EXPECT_EQ(1u, solver->getNumNewtonRaphsonIterations());
+		EXPECT_EQ(1u, solver->getNumFactorizations());
+		Matrix compliance = solver->getComplianceMatrix();
+
+		// The mass point being linear, reusing the factorization gives the exact solution
+		for (size_t step = 0; step < 2; ++step)
+		{
+			solver->solve(1e-3, state0, &state1);
+			EXPECT_EQ(0u, solver->getNumFactorizations());
+			EXPECT_TRUE(solver->getComplianceMatrix().isApprox(compliance));
+		}
+		EXPECT_TRUE(state1.getVelocities().isApprox(expected.getVelocities()));
+		EXPECT_TRUE(state1.getPositions().isApprox(expected.getPositions()));
+
+		// The maximum reuse is reached
+		solver->solve(1e-3, state0, &state1);
+		EXPECT_EQ(1u, solver->getNumFactorizations());
+
+		// The time step changes
+		solver->solve(2e-3, state0, &state1);
+		EXPECT_EQ(1u, solver->getNumFactorizations());
+		EXPECT_FALSE(solver->getComplianceMatrix().isApprox(compliance));
+
+		// The boundary conditions change
+		state0.addBoundaryCondition(0, 1);
+		solver->solve(2e-3, state0, &state1);
+		EXPECT_EQ(1u, solver->getNumFactorizations());
+
+		// The linear solver changes
+		solver->setLinearSolver(std::make_shared<LinearSparseSolveAndInverseLU>());
+		solver->solve(2e-3, state0, &state1);
+		EXPECT_EQ(1u, solver->getNumFactorizations());
+	}
+
+	{
+		SCOPED_TRACE("Non linear equation");
+		OdeComplexNonLinear odeEquation;
+		MassPointState state0, expected, state1;
+		state0.getPositions().setLinSpaced(1.4, 5.67);
+		state0.getVelocities().setLinSpaced(-0.4, -0.3);
+
+		auto solver = std::make_shared<OdeSolverEulerImplicit>(&odeEquation);
+		odeEquation.setOdeSolver(solver);
+		solver->setNewtonRaphsonMaximumIteration(50);
+		solver->setNewtonRaphsonEpsilonConvergence(1e-13);
+		solver->solve(1e-3, state0, &expected, false);
+		EXPECT_EQ(solver->getNumNewtonRaphsonIterations(), solver->getNumFactorizations());
+		EXPECT_LT(solver->getNumNewtonRaphsonIterations(), 50u);
+
+		// The modified Newton converges to the same solution with a single factorization
+		solver = std::make_shared<OdeSolverEulerImplicit>(&odeEquation);
+		odeEquation.setOdeSolver(solver);
+		solver->setNewtonRaphsonMaximumIteration(50);
+		solver->setNewtonRaphsonEpsilonConvergence(1e-13);
+		solver->setModifiedNewton(true);
+		solver->solve(1e-3, state0, &state1, false);
+		EXPECT_TRUE(state1.getVelocities().isApprox(expected.getVelocities()));
+		EXPECT_TRUE(state1.getPositions().isApprox(expected.getPositions()));
+		EXPECT_EQ(1u, solver->getNumFactorizations());
+		EXPECT_LT(solver->getNumNewtonRaphsonIterations(), 50u);
+		EXPECT_LT(solver->getNewtonRaphsonResidual(), 1e-9);
+
+		// A convergence always considered stalled factorizes the system matrix again
+		solver->setModifiedNewtonStallRatio(1e-20);
+		solver->solve(1e-3, state0, &state1, false);
+		EXPECT_TRUE(state1.getVelocities().isApprox(expected.getVelocities()));
+		EXPECT_LT(1u, solver->getNumFactorizations());
+	}
+
+	{
+		SCOPED_TRACE("The stiffness changes while the factorization is reused");
+		SpringMassPoint m(10.0);
+		auto solver = std::make_shared<OdeSolverEulerImplicit>(&m);
+		m.setOdeSolver(solver);
+		solver->setModifiedNewton(true);
+		MassPointState state0, state1, expected;
+
+		solver->solve(1e-3, state0, &state1, false);
+		EXPECT_EQ(1u, solver->getNumFactorizations());
+		solver->solve(1e-3, state0, &state1, false);
+		EXPECT_EQ(0u, solver->getNumFactorizations());
+		EXPECT_EQ(1u, solver->getNumNewtonRaphsonIterations());
+
+		// The reused system matrix is far too soft, the residual of the step grows instead of vanishing
+		m.m_stiffness = 1e6;
+		OdeSolverEulerImplicit(&m).solve(1e-3, state0, &expected, false);
+		solver->solve(1e-3, state0, &state1, false);
+		EXPECT_EQ(1u, solver->getNumFactorizations());
+		EXPECT_EQ(2u, solver->getNumNewtonRaphsonIterations());
+		EXPECT_TRUE(state1.getVelocities().isApprox(expected.getVelocities()));
+		EXPECT_TRUE(state1.getPositions().isApprox(expected.getPositions()));
+
+		// The new factorization is reused
+		solver->solve(1e-3, state0, &state1, false);
+		EXPECT_EQ(0u, solver->getNumFactorizations());
+		EXPECT_EQ(1u, solver->getNumNewtonRaphsonIterations());
+		EXPECT_TRUE(state1.getVelocities().isApprox(expected.getVelocities()));
+	}
+
+	{
+		SCOPED_TRACE("A mass point at rest does not factorize the system matrix again");
+		SpringMassPoint m(10.0);
+		m.disableGravity();
+		auto solver = std::make_shared<OdeSolverEulerImplicit>(&m);
+		m.setOdeSolver(solver);
+		solver->setModifiedNewton(true);
+		MassPointState state0, state1;
+		state0.getPositions().setConstant(1e-12);
+		state0.getVelocities().setZero();
+
+		solver->solve(1e-3, state0, &state1, false);
+		EXPECT_EQ(1u, solver->getNumFactorizations());
+
+		// The residual of the steps is far below the convergence criteria, even with a stale system matrix
+		m.m_stiffness = 1e6;
+		for (size_t step = 0; step < 5; ++step)
+		{
+			solver->solve(1e-3, state1, &state0, false);
+			EXPECT_EQ(0u, solver->getNumFactorizations());
+			EXPECT_EQ(1u, solver->getNumNewtonRaphsonIterations());
+			EXPECT_GT(1e-11, state0.getPositions().lpNorm<Eigen::Infinity>());
+			state1 = state0;
+		}
+	}
+}
+
 }; // Math
 
 }; // SurgSim
@@ -20,6 +20,7 @@
 
 #include <gtest/gtest.h>
 
+#include "SurgSim/Math/LinearSparseSolveAndInverse.h"
 #include "SurgSim/Math/OdeSolverRungeKutta4.h"
 #include "SurgSim/Math/OdeSolverLinearRungeKutta4.h"
 #include "SurgSim/Math/UnitTests/MockObject.h"
@@ -260,6 +261,72 @@ TEST(OdeSolverRungeKutta4, SolveTest)
 	}
 }
 
+namespace
+{
+template <class T>
+void doDiagonalLinearSolverTest()
+{
+	MassPoint m(0.1), diagonalM(0.1);
+	MassPointState currentState;
+	currentState.getPositions().setLinSpaced(1.0, 3.0);
+	currentState.getVelocities().setConstant(1.0);
+	const double dt = 1e-3;
+
+	auto solver = std::make_shared<T>(&m);
+	m.setOdeSolver(solver);
+	auto diagonalSolver = std::make_shared<T>(&diagonalM);
+	diagonalM.setOdeSolver(diagonalSolver);
+	diagonalSolver->setLinearSolver(std::make_shared<LinearSparseSolveAndInverseDiagonal>());
+
+	// The mass matrix being diagonal, both linear solvers give the same steps
+	MassPointState state = currentState, diagonalState = currentState;
+	MassPointState newState, newDiagonalState;
+	for (int step = 0; step < 3; ++step)
+	{
+		ASSERT_NO_THROW(solver->solve(dt, state, &newState));
+		ASSERT_NO_THROW(diagonalSolver->solve(dt, diagonalState, &newDiagonalState));
+		EXPECT_TRUE(newDiagonalState.getPositions().isApprox(newState.getPositions()));
+		EXPECT_TRUE(newDiagonalState.getVelocities().isApprox(newState.getVelocities()));
+		EXPECT_TRUE(diagonalSolver->getComplianceMatrix().isApprox(solver->getComplianceMatrix()));
+		state = newState;
+		diagonalState = newDiagonalState;
+	}
+}
+};
+
+TEST(OdeSolverRungeKutta4, DiagonalLinearSolverTest)
+{
+	{
+		SCOPED_TRACE("RungeKutta4");
+		doDiagonalLinearSolverTest<OdeSolverRungeKutta4>();
+	}
+
+	{
+		SCOPED_TRACE("LinearRungeKutta4");
+		doDiagonalLinearSolverTest<OdeSolverLinearRungeKutta4>();
+	}
+}
+
+TEST(OdeSolverRungeKutta4, LinearComplianceRequestedAfterFirstCallTest)
+{
+	MassPoint m(0.1);
+	auto solver = std::make_shared<OdeSolverLinearRungeKutta4>(&m);
+	m.setOdeSolver(solver);
+	MassPointState currentState, newState, newState2;
+	currentState.getPositions().setLinSpaced(1.0, 3.0);
+	currentState.getVelocities().setConstant(1.0);
+	const double dt = 1e-3;
+
+	ASSERT_NO_THROW(solver->solve(dt, currentState, &newState, false));
+	EXPECT_EQ(0, solver->getComplianceMatrix().size());
+
+	// The compliance matrix is computed on the 1st call that requests it
+	ASSERT_NO_THROW(solver->solve(dt, newState, &newState2, true));
+	m.updateFMDK(currentState, ODEEQUATIONUPDATE_M);
+	Matrix expectedSystemMatrix = m.getM() / dt;
+	EXPECT_TRUE(solver->getComplianceMatrix().isApprox(expectedSystemMatrix.inverse()));
+}
+
 namespace
 {
 template <class T>
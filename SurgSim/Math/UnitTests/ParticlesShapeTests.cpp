@@ -67,6 +67,7 @@ TEST(ParticlesShapeTests, DefaultProperties)
 	EXPECT_NEAR(0.0, particles.getVolume(), epsilon);
 	EXPECT_FALSE(isValid(particles.getCenter()));
 	EXPECT_TRUE(particles.getSecondMomentOfVolume().isZero());
+	EXPECT_NE(nullptr, particles.getFlatAabbTree());
 	EXPECT_NE(nullptr, particles.getAabbTree());
 
 	EXPECT_TRUE(particles.isTransformable());
@@ -0,0 +1,132 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "SurgSim/Framework/Assert.h"
+#include "SurgSim/Math/PreconditionedConjugateGradient.h"
+
+namespace SurgSim
+{
+
+namespace Math
+{
+
+namespace
+{
+
+/// \return A symmetric positive definite matrix of the given size, with strong 3x3 diagonal blocks
+Matrix makeSymmetricPositiveDefinite(Matrix::Index size)
+{
+	std::srand(7);
+	Matrix matrix = 0.1 * Matrix::Random(size, size);
+	matrix = matrix.transpose() * matrix;
+	for (Matrix::Index row = 0; row < size; row += 3)
+	{
+		Matrix block = Matrix::Random(3, 3);
+		matrix.block(row, row, 3, 3) += block.transpose() * block + Matrix::Identity(3, 3);
+	}
+	return matrix;
+}
+
+/// \return The diagonal 3x3 blocks of a matrix, stacked vertically
+Matrix getDiagonalBlocks(const Matrix& matrix)
+{
+	Matrix blocks(matrix.rows(), 3);
+	for (Matrix::Index row = 0; row < matrix.rows(); row += 3)
+	{
+		blocks.middleRows(row, 3) = matrix.block(row, row, 3, 3);
+	}
+	return blocks;
+}
+
+}
+
+TEST(PreconditionedConjugateGradientTests, BlockJacobiTest)
+{
+	BlockJacobiPreconditioner preconditioner;
+	EXPECT_EQ(0u, preconditioner.getBlockSize());
+	EXPECT_THROW(preconditioner.setBlocks(Matrix::Identity(4, 3)), Framework::AssertionFailure);
+
+	Matrix matrix = makeSymmetricPositiveDefinite(12);
+	// A singular block is replaced by the identity
+	matrix.block(6, 6, 3, 3).setZero();
+	ASSERT_NO_THROW(preconditioner.setBlocks(getDiagonalBlocks(matrix)));
+	EXPECT_EQ(3u, preconditioner.getBlockSize());
+
+	Vector x = Vector::Random(12);
+	Vector result;
+	preconditioner.apply(x, &result);
+	for (Matrix::Index row = 0; row < 12; row += 3)
+	{
+		Vector expected = (row == 6) ? Vector(x.segment(row, 3)) :
+			Vector(matrix.block(row, row, 3, 3).inverse() * x.segment(row, 3));
+		EXPECT_TRUE(result.segment(row, 3).isApprox(expected));
+	}
+
+	EXPECT_THROW(preconditioner.apply(Vector::Zero(9), &result), Framework::AssertionFailure);
+}
+
+TEST(PreconditionedConjugateGradientTests, SolveTest)
+{
+	const Matrix matrix = makeSymmetricPositiveDefinite(30);
+	const Vector b = Vector::Random(30);
+	const Vector expected = matrix.ldlt().solve(b);
+
+	auto product = [&matrix](const Vector& x, Vector* result)
+	{
+		*result = matrix * x;
+	};
+
+	BlockJacobiPreconditioner blockJacobi;
+	blockJacobi.setBlocks(getDiagonalBlocks(matrix));
+	auto preconditioner = [&blockJacobi](const Vector& x, Vector* result)
+	{
+		blockJacobi.apply(x, result);
+	};
+
+	PreconditionedConjugateGradient solver;
+	solver.setTolerance(1e-12);
+	EXPECT_DOUBLE_EQ(1e-12, solver.getTolerance());
+	solver.setMaxIterations(100);
+	EXPECT_EQ(100u, solver.getMaxIterations());
+	EXPECT_THROW(solver.setMaxIterations(0), Framework::AssertionFailure);
+	EXPECT_THROW(solver.setTolerance(-1.0), Framework::AssertionFailure);
+
+	Vector x = Vector::Zero(30);
+	ASSERT_TRUE(solver.solve(product, preconditioner, b, &x));
+	EXPECT_TRUE(x.isApprox(expected, 1e-9));
+	EXPECT_GT(solver.getNumIterations(), 0u);
+	EXPECT_LE(solver.getRelativeResidual(), 1e-12);
+
+	// Starting from the solution, there is nothing to do
+	ASSERT_TRUE(solver.solve(product, preconditioner, b, &x));
+	EXPECT_EQ(0u, solver.getNumIterations());
+
+	// A null right hand side gives a null solution
+	ASSERT_TRUE(solver.solve(product, preconditioner, Vector::Zero(30), &x));
+	EXPECT_TRUE(x.isZero());
+
+	// The iteration budget is respected, the estimate is still improved
+	solver.setMaxIterations(2);
+	x.setZero();
+	EXPECT_FALSE(solver.solve(product, preconditioner, b, &x));
+	EXPECT_EQ(2u, solver.getNumIterations());
+	EXPECT_LT(solver.getRelativeResidual(), 1.0);
+}
+
+}; // namespace Math
+
+}; // namespace SurgSim
@@ -0,0 +1,229 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "SurgSim/Framework/ApplicationData.h"
+#include "SurgSim/Framework/Assert.h"
+#include "SurgSim/Framework/Runtime.h"
+#include "SurgSim/Math/MathConvert.h"
+#include "SurgSim/Math/Shapes.h"
+
+namespace
+{
+const double epsilon = 1e-10;
+}
+
+namespace SurgSim
+{
+namespace Math
+{
+
+namespace
+{
+
+/// Sample the field of a sphere centered at the origin
+std::shared_ptr<SdfShape> makeSphereSdf(double radius, double spacing, size_t samples)
+{
+	std::array<size_t, 3> dimensions = {{samples, samples, samples}};
+	const Vector3d origin = Vector3d::Constant(-spacing * static_cast<double>(samples - 1) / 2.0);
+	std::vector<double> values;
+	for (size_t k = 0; k < samples; ++k)
+	{
+		for (size_t j = 0; j < samples; ++j)
+		{
+			for (size_t i = 0; i < samples; ++i)
+			{
+				Vector3d point = origin + spacing * Vector3d(static_cast<double>(i), static_cast<double>(j),
+								 static_cast<double>(k));
+				values.push_back(point.norm() - radius);
+			}
+		}
+	}
+	return std::make_shared<SdfShape>(dimensions, origin, spacing, values);
+}
+
+}
+
+TEST(SdfShapeTests, InitTest)
+{
+	ASSERT_NO_THROW(SdfShape sdf);
+	SdfShape sdf;
+	EXPECT_EQ(SHAPE_TYPE_SDF, sdf.getType());
+	EXPECT_FALSE(sdf.isValid());
+	EXPECT_FALSE(sdf.isTransformable());
+	EXPECT_FALSE(sdf.isConvex());
+
+	std::array<size_t, 3> dimensions = {{2, 2, 3}};
+	EXPECT_THROW(sdf.setGrid(dimensions, Vector3d::Zero(), 1.0, std::vector<double>(11, 0.0)),
+				 Framework::AssertionFailure);
+	EXPECT_THROW(sdf.setGrid(dimensions, Vector3d::Zero(), 0.0, std::vector<double>(12, 0.0)),
+				 Framework::AssertionFailure);
+	dimensions[2] = 1;
+	EXPECT_THROW(sdf.setGrid(dimensions, Vector3d::Zero(), 1.0, std::vector<double>(4, 0.0)),
+				 Framework::AssertionFailure);
+
+	dimensions[2] = 3;
+	ASSERT_NO_THROW(sdf.setGrid(dimensions, Vector3d(1.0, 2.0, 3.0), 0.5, std::vector<double>(12, 1.0)));
+	EXPECT_TRUE(sdf.isValid());
+	EXPECT_EQ(dimensions, sdf.getDimensions());
+	EXPECT_TRUE(sdf.getOrigin().isApprox(Vector3d(1.0, 2.0, 3.0)));
+	EXPECT_DOUBLE_EQ(0.5, sdf.getSpacing());
+	EXPECT_EQ(12u, sdf.getValues().size());
+	EXPECT_TRUE(sdf.getBoundingBox().min().isApprox(Vector3d(1.0, 2.0, 3.0)));
+	EXPECT_TRUE(sdf.getBoundingBox().max().isApprox(Vector3d(1.5, 2.5, 4.0)));
+	EXPECT_NEAR(0.0, sdf.getVolume(), epsilon);
+}
+
+TEST(SdfShapeTests, DistanceTest)
+{
+	// A linear field is reproduced exactly by the interpolation
+	std::array<size_t, 3> dimensions = {{3, 4, 5}};
+	const Vector3d origin(-1.0, -1.5, -2.0);
+	const Vector3d gradient(0.3, -0.4, 0.5);
+	std::vector<double> values;
+	for (size_t k = 0; k < dimensions[2]; ++k)
+	{
+		for (size_t j = 0; j < dimensions[1]; ++j)
+		{
+			for (size_t i = 0; i < dimensions[0]; ++i)
+			{
+				values.push_back(gradient.dot(origin + Vector3d(static_cast<double>(i), static_cast<double>(j),
+											  static_cast<double>(k))) + 0.1);
+			}
+		}
+	}
+	SdfShape sdf(dimensions, origin, 1.0, values);
+
+	std::srand(3);
+	for (size_t i = 0; i < 20; ++i)
+	{
+		Vector3d point = Vector3d::Random().cwiseProduct(Vector3d(1.0, 1.5, 2.0));
+		Vector3d result;
+		EXPECT_NEAR(gradient.dot(point) + 0.1, sdf.getDistance(point, &result), epsilon);
+		EXPECT_TRUE(gradient.isApprox(result));
+		EXPECT_NEAR(gradient.dot(point) + 0.1, sdf.getDistance(point), epsilon);
+	}
+
+	// On the border of the grid
+	Vector3d result;
+	EXPECT_NEAR(gradient.dot(Vector3d(1.0, 1.5, 2.0)) + 0.1, sdf.getDistance(Vector3d(1.0, 1.5, 2.0), &result),
+				epsilon);
+	EXPECT_TRUE(gradient.isApprox(result));
+
+	// Outside of the grid, the distance to the grid is added
+	EXPECT_NEAR(gradient.dot(Vector3d(1.0, 0.0, 0.0)) + 0.1 + 2.0, sdf.getDistance(Vector3d(3.0, 0.0, 0.0), &result),
+				epsilon);
+	EXPECT_TRUE(Vector3d::UnitX().isApprox(result));
+}
+
+TEST(SdfShapeTests, PenetrationTest)
+{
+	// The interpolated gradient is only accurate to a few percent at this resolution
+	auto sdf = makeSphereSdf(0.5, 0.05, 31);
+	double depth;
+	Vector3d normal, surfacePoint;
+
+	EXPECT_FALSE(sdf->calculatePenetration(Vector3d(0.0, 0.6, 0.0), 0.0, &depth, &normal, &surfacePoint));
+	EXPECT_FALSE(sdf->calculatePenetration(Vector3d(0.0, 2.0, 0.0), 1.0, &depth, &normal, &surfacePoint));
+
+	ASSERT_TRUE(sdf->calculatePenetration(Vector3d(0.0, 0.4, 0.0), 0.0, &depth, &normal, &surfacePoint));
+	EXPECT_NEAR(0.1, depth, 1e-3);
+	EXPECT_TRUE(normal.isApprox(Vector3d::UnitY(), 0.1));
+	EXPECT_TRUE(surfacePoint.isApprox(Vector3d(0.0, 0.5, 0.0), 0.05));
+
+	ASSERT_TRUE(sdf->calculatePenetration(Vector3d(0.3, 0.3, 0.3), 0.1, &depth, &normal, &surfacePoint));
+	EXPECT_NEAR(0.6 - std::sqrt(0.27), depth, 1e-2);
+	EXPECT_TRUE(normal.isApprox(Vector3d::Ones().normalized(), 1e-2));
+	EXPECT_NEAR(0.5, surfacePoint.norm(), 1e-2);
+}
+
+TEST(SdfShapeTests, VolumeIntegralsTest)
+{
+	auto sdf = makeSphereSdf(0.5, 0.02, 61);
+	EXPECT_NEAR(4.0 / 3.0 * M_PI * 0.125, sdf->getVolume(), 0.01);
+	EXPECT_TRUE(sdf->getCenter().isZero(1e-3));
+
+	SphereShape sphere(0.5);
+	EXPECT_TRUE(sdf->getSecondMomentOfVolume().isApprox(sphere.getSecondMomentOfVolume(), 0.05));
+}
+
+TEST(SdfShapeTests, LoadTest)
+{
+	Framework::ApplicationData data("config.txt");
+	auto sdf = std::make_shared<SdfShape>();
+	ASSERT_NO_THROW(sdf->load("sphere.sdf", data));
+	ASSERT_TRUE(sdf->isValid());
+	std::array<size_t, 3> dimensions = {{5, 5, 5}};
+	EXPECT_EQ(dimensions, sdf->getDimensions());
+	EXPECT_TRUE(sdf->getOrigin().isApprox(Vector3d::Constant(-1.0)));
+	EXPECT_DOUBLE_EQ(0.5, sdf->getSpacing());
+	EXPECT_NEAR(-0.6, sdf->getDistance(Vector3d::Zero()), 1e-6);
+	EXPECT_NEAR(0.4, sdf->getDistance(Vector3d(0.0, 0.0, 1.0)), 1e-6);
+
+	EXPECT_ANY_THROW(sdf->load("segmentmesh.ply", data));
+}
+
+TEST(SdfShapeTests, SerializationTest)
+{
+	Framework::Runtime runtime("config.txt");
+	const std::string fileName = "sphere.sdf";
+
+	{
+		SCOPED_TRACE("Load through the property");
+		SdfShape sdf;
+		EXPECT_NO_THROW(sdf.setValue("SdfFileName", fileName));
+		EXPECT_TRUE(sdf.isValid());
+		EXPECT_EQ(fileName, sdf.getFileName());
+		EXPECT_ANY_THROW(sdf.setValue("SdfFileName", std::string("Nonexistent file")));
+	}
+
+	{
+		SCOPED_TRACE("Decode from the file name");
+		YAML::Node node;
+		node["SurgSim::Math::SdfShape"]["SdfFileName"] = fileName;
+
+		std::shared_ptr<Shape> shape;
+		ASSERT_NO_THROW(shape = node.as<std::shared_ptr<Shape>>());
+		auto sdf = std::dynamic_pointer_cast<SdfShape>(shape);
+		ASSERT_NE(nullptr, sdf);
+		EXPECT_EQ(SHAPE_TYPE_SDF, sdf->getType());
+		EXPECT_EQ(fileName, sdf->getFileName());
+		EXPECT_TRUE(sdf->isValid());
+		EXPECT_NEAR(-0.6, sdf->getDistance(Vector3d::Zero()), 1e-6);
+	}
+
+	{
+		SCOPED_TRACE("Encode and decode");
+		auto sdf = std::make_shared<SdfShape>();
+		sdf->loadSdf(fileName);
+
+		YAML::Node node;
+		ASSERT_NO_THROW(node = YAML::convert<std::shared_ptr<Shape>>::encode(sdf));
+		ASSERT_TRUE(node["SurgSim::Math::SdfShape"].IsMap());
+
+		std::shared_ptr<SdfShape> decoded;
+		ASSERT_NO_THROW(decoded = std::dynamic_pointer_cast<SdfShape>(node.as<std::shared_ptr<Shape>>()));
+		ASSERT_NE(nullptr, decoded);
+		EXPECT_EQ(fileName, decoded->getFileName());
+		EXPECT_EQ(sdf->getDimensions(), decoded->getDimensions());
+		EXPECT_TRUE(sdf->getOrigin().isApprox(decoded->getOrigin()));
+		EXPECT_DOUBLE_EQ(sdf->getSpacing(), decoded->getSpacing());
+		EXPECT_EQ(sdf->getValues(), decoded->getValues());
+	}
+}
+
+};
+};
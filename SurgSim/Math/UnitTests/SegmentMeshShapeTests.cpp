@@ -16,6 +16,7 @@
 #include <gtest/gtest.h>
 
 #include "SurgSim/DataStructures/AabbTree.h"
+#include "SurgSim/DataStructures/FlatAabbTree.h"
 #include "SurgSim/DataStructures/EmptyData.h"
 #include "SurgSim/Framework/ApplicationData.h"
 #include "SurgSim/Framework/Runtime.h"
@@ -89,6 +90,7 @@ TEST_F(SegmentMeshShapeTest, AabbTest)
 	SurgSim::Math::Aabbd expected(Vector3d(-13.0, -13.0, -13.0), Vector3d(13.0, 13.0, 13.0));
 
 	shape->update();
+	EXPECT_TRUE(expected.isApprox(shape->getFlatAabbTree()->getAabb()));
 	EXPECT_TRUE(expected.isApprox(shape->getAabbTree()->getAabb()));
 }
 
@@ -525,6 +525,38 @@ TEST_F(ShapeTest, OctreeShape)
 		EXPECT_TRUE(shape.isValid());
 	}
 
+	{
+		SCOPED_TRACE("Flat octree");
+		auto root = std::make_shared<OctreeShape::NodeType>(
+			OctreeShape::NodeType::AxisAlignedBoundingBox(Vector3d::Zero(), Vector3d::Constant(4.0)));
+		OctreeShape shape;
+		shape.setOctree(root);
+		EXPECT_EQ(1u, shape.getFlatOctree()->getNumNodes());
+
+		// Edits through getOctree() are picked up by the next query
+		shape.getOctree()->addData(Vector3d(0.5, 0.5, 0.5), 3);
+		EXPECT_EQ(17u, shape.getFlatOctree()->getNumNodes());
+
+		// Edits through a node kept from before need an explicit update
+		root->addData(Vector3d(3.5, 3.5, 3.5), 3);
+		EXPECT_EQ(17u, shape.getFlatOctree()->getNumNodes());
+		shape.updateFlatOctree();
+		EXPECT_EQ(25u, shape.getFlatOctree()->getNumNodes());
+
+		// A flat octree returned before a rebuild is left untouched
+		auto snapshot = shape.getFlatOctree();
+		root->getChildren()[0] = nullptr;
+		shape.updateFlatOctree();
+		EXPECT_EQ(16u, shape.getFlatOctree()->getNumNodes());
+		EXPECT_EQ(25u, snapshot->getNumNodes());
+
+		// Deactivating a node needs an update as well
+		root->setIsActive(false);
+		EXPECT_TRUE(shape.getFlatOctree()->isActive(0));
+		shape.updateFlatOctree();
+		EXPECT_FALSE(shape.getFlatOctree()->isActive(0));
+	}
+
 	{
 		SCOPED_TRACE("Normal Loading");
 		const std::string fileName = "Geometry/staple.ply";
@@ -620,5 +652,46 @@ TEST_F(ShapeTest, PlaneShape)
 }
 
 
+TEST_F(ShapeTest, SupportTest)
+{
+	SphereShape sphere(m_radius);
+	EXPECT_TRUE(sphere.isConvex());
+	EXPECT_TRUE(sphere.getSupport(Vector3d(0.0, 2.0, 0.0)).isApprox(Vector3d(0.0, m_radius, 0.0)));
+	EXPECT_NEAR(m_radius, sphere.getSupport(Vector3d(1.0, -2.0, 3.0)).norm(), epsilon);
+	EXPECT_NEAR(m_radius, sphere.getSupport(Vector3d::Zero()).norm(), epsilon);
+
+	BoxShape box(m_size[0], m_size[1], m_size[2]);
+	EXPECT_TRUE(box.isConvex());
+	EXPECT_TRUE(box.getSupport(Vector3d(1.0, -2.0, 3.0)).isApprox(
+					Vector3d(m_size[0] / 2.0, -m_size[1] / 2.0, m_size[2] / 2.0)));
+
+	CapsuleShape capsule(m_length, m_radius);
+	EXPECT_TRUE(capsule.isConvex());
+	EXPECT_TRUE(capsule.getSupport(Vector3d(0.0, 1.0, 0.0)).isApprox(
+					Vector3d(0.0, m_length / 2.0 + m_radius, 0.0)));
+	EXPECT_TRUE(capsule.getSupport(Vector3d(-1.0, -0.5, 0.0)).isApprox(
+					Vector3d(0.0, -m_length / 2.0, 0.0) + m_radius * Vector3d(-1.0, -0.5, 0.0).normalized()));
+
+	CylinderShape cylinder(m_length, m_radius);
+	EXPECT_TRUE(cylinder.isConvex());
+	EXPECT_TRUE(cylinder.getSupport(Vector3d(0.0, 1.0, 0.0)).isApprox(
+					Vector3d(0.0, m_length / 2.0, 0.0)));
+	EXPECT_TRUE(cylinder.getSupport(Vector3d(3.0, -1.0, 4.0)).isApprox(
+					Vector3d(0.6 * m_radius, -m_length / 2.0, 0.8 * m_radius)));
+
+	// Every point of the shape is below the support point
+	for (size_t i = 0; i < 20; ++i)
+	{
+		Vector3d direction = Vector3d::Random();
+		double support = direction.dot(cylinder.getSupport(direction));
+		Vector3d point = cylinder.getSupport(Vector3d::Random());
+		EXPECT_LE(direction.dot(point), support + epsilon);
+	}
+
+	PlaneShape plane;
+	EXPECT_FALSE(plane.isConvex());
+	EXPECT_THROW(plane.getSupport(Vector3d::UnitX()), SurgSim::Framework::AssertionFailure);
+}
+
 }
 }
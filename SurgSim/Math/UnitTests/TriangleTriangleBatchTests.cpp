@@ -0,0 +1,193 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "SurgSim/Framework/Assert.h"
+#include "SurgSim/Math/Geometry.h"
+#include "SurgSim/Math/TriangleTriangleBatch.h"
+#include "SurgSim/Math/UnitTests/TriangleTriangleTestParameters.h"
+
+namespace SurgSim
+{
+namespace Math
+{
+
+class TriangleTriangleBatchTest : public ::testing::Test, public TriangleTriangleTestParameters
+{
+};
+
+TEST_F(TriangleTriangleBatchTest, InitTest)
+{
+	EXPECT_NO_THROW(TriangleTriangleBatch batch);
+	EXPECT_THROW(TriangleTriangleBatch batch(0), SurgSim::Framework::AssertionFailure);
+
+	TriangleTriangleBatch batch(2);
+	EXPECT_EQ(2u, batch.getCapacity());
+	EXPECT_EQ(0u, batch.getSize());
+	EXPECT_FALSE(batch.isFull());
+
+	std::vector<size_t> candidates(1, 0);
+	batch.getCandidates(&candidates);
+	EXPECT_TRUE(candidates.empty());
+}
+
+TEST_F(TriangleTriangleBatchTest, AddTest)
+{
+	TriangleTriangleBatch batch(2);
+	MockTriangle t0 = std::get<1>(m_testCases[0]);
+	MockTriangle t1 = std::get<2>(m_testCases[0]);
+
+	EXPECT_EQ(0u, batch.add(t0.v0, t0.v1, t0.v2, t1.v0, t1.v1, t1.v2, t0.n, t1.n));
+	EXPECT_EQ(1u, batch.add(t0.v0, t0.v1, t0.v2, t1.v0, t1.v1, t1.v2, t0.n, t1.n));
+	EXPECT_EQ(2u, batch.getSize());
+	EXPECT_TRUE(batch.isFull());
+	EXPECT_THROW(batch.add(t0.v0, t0.v1, t0.v2, t1.v0, t1.v1, t1.v2, t0.n, t1.n),
+				 SurgSim::Framework::AssertionFailure);
+
+	batch.clear();
+	EXPECT_EQ(0u, batch.getSize());
+	EXPECT_FALSE(batch.isFull());
+}
+
+TEST_F(TriangleTriangleBatchTest, TestCases)
+{
+	TriangleTriangleBatch batch(m_testCases.size() + 1);
+	for (auto it = m_testCases.begin(); it != m_testCases.end(); ++it)
+	{
+		MockTriangle t0 = std::get<1>(*it);
+		MockTriangle t1 = std::get<2>(*it);
+		batch.add(t0.v0, t0.v1, t0.v2, t1.v0, t1.v1, t1.v2, t0.n, t1.n);
+	}
+	// Degenerate triangles are always rejected
+	batch.add(Vector3d::Zero(), Vector3d::UnitX(), Vector3d::UnitX(),
+			  Vector3d::Zero(), Vector3d::UnitX(), Vector3d::UnitY(), Vector3d::Zero(), Vector3d::UnitZ());
+
+	std::vector<size_t> candidates;
+	batch.getCandidates(&candidates);
+	EXPECT_TRUE(std::is_sorted(candidates.begin(), candidates.end()));
+
+	for (size_t i = 0; i < m_testCases.size(); ++i)
+	{
+		SCOPED_TRACE(std::get<0>(m_testCases[i]));
+
+		MockTriangle t0 = std::get<1>(m_testCases[i]);
+		MockTriangle t1 = std::get<2>(m_testCases[i]);
+		bool isCandidate = std::binary_search(candidates.begin(), candidates.end(), i);
+		if (!isCandidate)
+		{
+			EXPECT_FALSE(doesIntersectTriangleTriangle(t0.v0, t0.v1, t0.v2, t1.v0, t1.v1, t1.v2, t0.n, t1.n));
+		}
+		if (std::get<3>(m_testCases[i]))
+		{
+			EXPECT_TRUE(isCandidate);
+		}
+	}
+	EXPECT_FALSE(std::binary_search(candidates.begin(), candidates.end(), m_testCases.size()));
+}
+
+TEST_F(TriangleTriangleBatchTest, RandomTest)
+{
+	// A full batch and a partial one, every pair that intersects has to be a candidate
+	std::srand(42);
+	for (size_t numPairs : {TriangleTriangleBatch::DefaultCapacity, TriangleTriangleBatch::DefaultCapacity / 2 + 1})
+	{
+		TriangleTriangleBatch batch;
+		std::vector<MockTriangle> triangles0, triangles1;
+		for (size_t i = 0; i < numPairs; ++i)
+		{
+			triangles0.emplace_back(Vector3d::Random(), Vector3d::Random(), Vector3d::Random());
+			triangles1.emplace_back(Vector3d::Random(), Vector3d::Random(), Vector3d::Random());
+			const MockTriangle& t0 = triangles0.back();
+			const MockTriangle& t1 = triangles1.back();
+			batch.add(t0.v0, t0.v1, t0.v2, t1.v0, t1.v1, t1.v2, t0.n, t1.n);
+		}
+		EXPECT_EQ(numPairs, batch.getSize());
+
+		std::vector<size_t> candidates;
+		batch.getCandidates(&candidates);
+		size_t numIntersections = 0;
+		for (size_t i = 0; i < numPairs; ++i)
+		{
+			const MockTriangle& t0 = triangles0[i];
+			const MockTriangle& t1 = triangles1[i];
+			if (doesIntersectTriangleTriangle(t0.v0, t0.v1, t0.v2, t1.v0, t1.v1, t1.v2, t0.n, t1.n))
+			{
+				EXPECT_TRUE(std::binary_search(candidates.begin(), candidates.end(), i));
+				++numIntersections;
+			}
+		}
+		EXPECT_LE(numIntersections, candidates.size());
+		EXPECT_GT(numPairs, candidates.size());
+	}
+}
+
+TEST_F(TriangleTriangleBatchTest, DistancesTest)
+{
+	// The distances of the candidates give the same result as the complete test, the size of the batch is not a
+	// multiple of the number of pairs processed at once
+	std::srand(42);
+	const size_t numPairs = TriangleTriangleBatch::DefaultCapacity - 3;
+	TriangleTriangleBatch batch;
+	std::vector<MockTriangle> triangles0, triangles1;
+	for (size_t i = 0; i < numPairs; ++i)
+	{
+		triangles0.emplace_back(Vector3d::Random(), Vector3d::Random(), Vector3d::Random());
+		triangles1.emplace_back(Vector3d::Random(), Vector3d::Random(), Vector3d::Random());
+		const MockTriangle& t0 = triangles0.back();
+		const MockTriangle& t1 = triangles1.back();
+		batch.add(t0.v0, t0.v1, t0.v2, t1.v0, t1.v1, t1.v2, t0.n, t1.n);
+	}
+
+	std::vector<size_t> candidates;
+	batch.getCandidates(&candidates);
+	ASSERT_FALSE(candidates.empty());
+	for (size_t candidate : candidates)
+	{
+		const MockTriangle& t0 = triangles0[candidate];
+		const MockTriangle& t1 = triangles1[candidate];
+		Vector3d t0Distances, t1Distances;
+		batch.getDistances(candidate, &t0Distances, &t1Distances);
+		EXPECT_NEAR(t1.n.dot(t0.v0 - t1.v0), t0Distances[0], 1e-12);
+		EXPECT_NEAR(t1.n.dot(t0.v1 - t1.v0), t0Distances[1], 1e-12);
+		EXPECT_NEAR(t1.n.dot(t0.v2 - t1.v0), t0Distances[2], 1e-12);
+		EXPECT_NEAR(t0.n.dot(t1.v0 - t0.v0), t1Distances[0], 1e-12);
+		EXPECT_NEAR(t0.n.dot(t1.v1 - t0.v0), t1Distances[1], 1e-12);
+		EXPECT_NEAR(t0.n.dot(t1.v2 - t0.v0), t1Distances[2], 1e-12);
+
+		double expectedDepth = 0.0, depth = 0.0;
+		Vector3d expectedPoint0, expectedPoint1, expectedNormal, point0, point1, normal;
+		bool expected = calculateContactTriangleTriangle(t0.v0, t0.v1, t0.v2, t1.v0, t1.v1, t1.v2, t0.n, t1.n,
+						&expectedDepth, &expectedPoint0, &expectedPoint1, &expectedNormal);
+		ASSERT_EQ(expected, calculateContactTriangleTriangle(t0.v0, t0.v1, t0.v2, t1.v0, t1.v1, t1.v2, t0.n, t1.n,
+				  t0Distances, t1Distances, &depth, &point0, &point1, &normal));
+		EXPECT_EQ(expected, doesIntersectTriangleTriangle(t0.v0, t0.v1, t0.v2, t1.v0, t1.v1, t1.v2, t0.n, t1.n,
+				  t0Distances, t1Distances));
+		if (expected)
+		{
+			EXPECT_NEAR(expectedDepth, depth, 1e-10);
+			EXPECT_TRUE(expectedPoint0.isApprox(point0));
+			EXPECT_TRUE(expectedPoint1.isApprox(point1));
+			EXPECT_TRUE(expectedNormal.isApprox(normal));
+		}
+	}
+}
+
+}
+}
@@ -14,6 +14,7 @@
 // limitations under the License.
 
 #include <Eigen/Core>
+#include <unordered_map>
 using Eigen::MatrixXd;
 using Eigen::VectorXd;
 
@@ -30,12 +31,22 @@ namespace SurgSim
 namespace Physics
 {
 
-BuildMlcp::BuildMlcp(bool doCopyState) : Computation(doCopyState)
+BuildMlcp::BuildMlcp(bool doCopyState) : Computation(doCopyState), m_useSparseMatrix(false)
 {}
 
 BuildMlcp::~BuildMlcp()
 {}
 
+void BuildMlcp::setUseSparseMatrix(bool useSparseMatrix)
+{
+	m_useSparseMatrix = useSparseMatrix;
+}
+
+bool BuildMlcp::isUsingSparseMatrix() const
+{
+	return m_useSparseMatrix;
+}
+
 std::shared_ptr<PhysicsManagerState>
 BuildMlcp::doUpdate(const double& dt, const std::shared_ptr<PhysicsManagerState>& state)
 {
@@ -47,8 +58,14 @@ BuildMlcp::doUpdate(const double& dt, const std::shared_ptr<PhysicsManagerState>
 	size_t numAtomicConstraint = 0;
 	size_t numDof = 0;
 
+	// Group the constraints by islands, each island is stored contiguously in the Mlcp
+	const auto& activeRepresentations = result->getActiveRepresentations();
+	std::vector<std::shared_ptr<Constraint>> activeConstraints;
+	std::vector<MlcpIsland> islands;
+	computeIslands(result->getActiveConstraints(), activeRepresentations, &activeConstraints, &islands);
+	result->setMlcpIslands(islands);
+
 	// Calculate numAtomicConstraint
-	auto const activeConstraints = result->getActiveConstraints();
 	for (auto it = activeConstraints.cbegin(); it != activeConstraints.cend(); it++)
 	{
 		constraintsMapping.setValue((*it).get(), static_cast<ptrdiff_t>(numAtomicConstraint));
@@ -57,7 +74,6 @@ BuildMlcp::doUpdate(const double& dt, const std::shared_ptr<PhysicsManagerState>
 	result->setConstraintsMapping(constraintsMapping);
 
 	// Calculate numDof size
-	const auto& activeRepresentations = result->getActiveRepresentations();
 	for (auto it = activeRepresentations.cbegin(); it != activeRepresentations.cend(); it++)
 	{
 		representationsMapping.setValue((*it).get(), numDof);
@@ -65,8 +81,19 @@ BuildMlcp::doUpdate(const double& dt, const std::shared_ptr<PhysicsManagerState>
 	}
 	result->setRepresentationsMapping(representationsMapping);
 
-	// Resize the Mlcp problem
-	result->getMlcpProblem().A.setZero(numAtomicConstraint, numAtomicConstraint);
+	// Resize the Mlcp problem, the sparse matrix is assembled once all the constraints are built. With several
+	// islands, it only stores their diagonal blocks and the global dense matrix is never formed.
+	const bool useIslands = islands.size() > 1;
+	if (m_useSparseMatrix || useIslands)
+	{
+		result->getMlcpProblem().A.resize(0, 0);
+		result->getMlcpProblem().sparseA.resize(numAtomicConstraint, numAtomicConstraint);
+	}
+	else
+	{
+		result->getMlcpProblem().A.setZero(numAtomicConstraint, numAtomicConstraint);
+		result->getMlcpProblem().sparseA.resize(0, 0);
+	}
 	result->getMlcpProblem().b.setZero(numAtomicConstraint);
 	result->getMlcpProblem().H.resize(numAtomicConstraint, numDof);
 	result->getMlcpProblem().CHt.setZero(numDof, numAtomicConstraint);
@@ -102,9 +129,106 @@ BuildMlcp::doUpdate(const double& dt, const std::shared_ptr<PhysicsManagerState>
 		(*it)->build(dt, &result->getMlcpProblem(), indexRepresentation0, indexRepresentation1, indexConstraint);
 	}
 
+	if (useIslands)
+	{
+		result->getMlcpProblem().assembleSparseA(result->getMlcpIslands());
+	}
+	else if (result->getMlcpProblem().isSparse())
+	{
+		result->getMlcpProblem().assembleSparseA();
+	}
+
 	return result;
 }
 
+void BuildMlcp::computeIslands(const std::vector<std::shared_ptr<Constraint>>& constraints,
+							   const std::vector<std::shared_ptr<Representation>>& representations,
+							   std::vector<std::shared_ptr<Constraint>>* orderedConstraints,
+							   std::vector<MlcpIsland>* islands) const
+{
+	const size_t numRepresentations = representations.size();
+	const size_t numConstraints = constraints.size();
+
+	std::unordered_map<const Representation*, size_t> representationIndices;
+	for (size_t i = 0; i < numRepresentations; ++i)
+	{
+		representationIndices[representations[i].get()] = i;
+	}
+
+	// Union-find over the representations followed by the constraints
+	std::vector<size_t> parents(numRepresentations + numConstraints);
+	for (size_t i = 0; i < parents.size(); ++i)
+	{
+		parents[i] = i;
+	}
+	auto find = [&parents](size_t node)
+	{
+		while (parents[node] != node)
+		{
+			parents[node] = parents[parents[node]];
+			node = parents[node];
+		}
+		return node;
+	};
+
+	for (size_t i = 0; i < numConstraints; ++i)
+	{
+		const auto& localizations = constraints[i]->getLocalizations();
+		for (const auto& localization : {localizations.first, localizations.second})
+		{
+			if (localization == nullptr || localization->getRepresentation()->getNumDof() == 0)
+			{
+				continue;
+			}
+			auto found = representationIndices.find(localization->getRepresentation().get());
+			if (found != representationIndices.end())
+			{
+				parents[find(numRepresentations + i)] = find(found->second);
+			}
+		}
+	}
+
+	// Number the islands in the order of their first constraint
+	std::vector<size_t> islandOfConstraint(numConstraints);
+	std::vector<size_t> islandOfRoot(parents.size(), numConstraints);
+	islands->clear();
+	for (size_t i = 0; i < numConstraints; ++i)
+	{
+		size_t root = find(numRepresentations + i);
+		if (islandOfRoot[root] == numConstraints)
+		{
+			islandOfRoot[root] = islands->size();
+			MlcpIsland island = {0, 0, 0, 0};
+			islands->push_back(island);
+		}
+		islandOfConstraint[i] = islandOfRoot[root];
+		(*islands)[islandOfConstraint[i]].numConstraints++;
+		(*islands)[islandOfConstraint[i]].numAtomicConstraints += constraints[i]->getNumDof();
+	}
+
+	size_t constraintIndex = 0;
+	size_t atomicIndex = 0;
+	for (auto& island : *islands)
+	{
+		island.constraintIndex = constraintIndex;
+		island.atomicIndex = atomicIndex;
+		constraintIndex += island.numConstraints;
+		atomicIndex += island.numAtomicConstraints;
+	}
+
+	// Stable bucket sort of the constraints by island
+	std::vector<size_t> position(islands->size());
+	for (size_t i = 0; i < islands->size(); ++i)
+	{
+		position[i] = (*islands)[i].constraintIndex;
+	}
+	orderedConstraints->resize(numConstraints);
+	for (size_t i = 0; i < numConstraints; ++i)
+	{
+		(*orderedConstraints)[position[islandOfConstraint[i]]++] = constraints[i];
+	}
+}
+
 
 }; // namespace Physics
 }; // namespace SurgSim
@@ -16,15 +16,24 @@
 #ifndef SURGSIM_PHYSICS_BUILDMLCP_H
 #define SURGSIM_PHYSICS_BUILDMLCP_H
 
+#include <memory>
+#include <vector>
+
 #include "SurgSim/Framework/Macros.h"
 #include "SurgSim/Physics/Computation.h"
+#include "SurgSim/Physics/MlcpIsland.h"
 
 namespace SurgSim
 {
 namespace Physics
 {
 
+class Constraint;
+class Representation;
+
 /// Build an mlcp from a list of constraints stored in a PhysicsManagerState
+/// The constraints are grouped in islands (see MlcpIsland), the constraints of each island are stored contiguously
+/// in the mlcp and the islands are stored in the PhysicsManagerState so they can be solved independently.
 class BuildMlcp : public Computation
 {
 public:
@@ -37,10 +46,37 @@ class BuildMlcp : public Computation
 	/// Destructor
 	virtual ~BuildMlcp();
 
+	/// Set whether the Mlcp matrix is assembled as a sparse matrix (MlcpProblem::sparseA) instead of a dense one.
+	/// Constraints that do not share a representation are not coupled, the sparse matrix skips these zero blocks and
+	/// is solved without any copy by the Gauss-Seidel solver.
+	/// \note When the constraints form several islands, the matrix is always assembled as the sparse block diagonal
+	/// matrix of the islands, see MlcpPhysicsProblem::assembleSparseA(const std::vector<MlcpIsland>&).
+	/// \param useSparseMatrix true to assemble the sparse matrix, false to assemble the dense matrix
+	void setUseSparseMatrix(bool useSparseMatrix);
+
+	/// \return true if the Mlcp matrix is assembled as a sparse matrix
+	bool isUsingSparseMatrix() const;
+
 protected:
 	/// Override doUpdate from superclass
 	std::shared_ptr<PhysicsManagerState> doUpdate(const double& dt, const std::shared_ptr<PhysicsManagerState>& state)
 		override;
+
+private:
+	/// Group the constraints in islands, two constraints belong to the same island if they are (directly or
+	/// indirectly) acting on a common representation with degrees of freedom.
+	/// \param constraints The constraints to group
+	/// \param representations The representations the constraints are acting on
+	/// \param [out] orderedConstraints The constraints, ordered island by island, the order of the constraints in
+	/// 	an island is the same as in constraints
+	/// \param [out] islands The islands, ordered by the position of their first constraint in constraints
+	void computeIslands(const std::vector<std::shared_ptr<Constraint>>& constraints,
+						const std::vector<std::shared_ptr<Representation>>& representations,
+						std::vector<std::shared_ptr<Constraint>>* orderedConstraints,
+						std::vector<MlcpIsland>* islands) const;
+
+	/// Whether the Mlcp matrix is assembled as a sparse matrix
+	bool m_useSparseMatrix;
 };
 
 }; // namespace Physics
@@ -14,11 +14,14 @@
 // limitations under the License.
 
 #include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Framework/Timer.h"
 #include "SurgSim/Physics/BuildMlcp.h"
 #include "SurgSim/Physics/CcdCollision.h"
 #include "SurgSim/Physics/CcdCollisionLoop.h"
+#include "SurgSim/Physics/Constraint.h"
 #include "SurgSim/Physics/ContactConstraintGeneration.h"
 #include "SurgSim/Physics/ContactFiltering.h"
+#include "SurgSim/Physics/Localization.h"
 #include "SurgSim/Physics/PhysicsManagerState.h"
 #include "SurgSim/Physics/PushResults.h"
 #include "SurgSim/Physics/SolveMlcp.h"
@@ -43,6 +46,8 @@ CcdCollisionLoop::CcdCollisionLoop(bool copyState) :
 	m_solveMlcp(new SolveMlcp(copyState)),
 	m_pushResults(new PushResults(copyState)),
 	m_maxIterations(20),
+	m_retestAffectedPairsOnly(false),
+	m_timeBudget(0.0),
 	m_epsilonFactor(100),
 	m_logger(SurgSim::Framework::Logger::getLogger("Physics/CCDCollisionLoop"))
 {
@@ -68,10 +73,16 @@ std::shared_ptr<PhysicsManagerState> CcdCollisionLoop::doUpdate(const double& dt
 		return p->getType() == Collision::COLLISION_DETECTION_TYPE_CONTINUOUS;
 	});
 
+	Framework::Timer timer;
+
 	double timeOfImpact = 0.0;
 	double localTimeOfImpact = 0.0;
 	std::vector<std::list<std::shared_ptr<Collision::Contact>>> oldContacts;
 
+	// The first iteration tests all the pairs
+	std::vector<std::shared_ptr<Collision::CollisionPair>> pairsToTest(ccdPairs);
+	std::vector<bool> hadContacts(ccdPairs.size());
+
 	bool executedOnce = false;
 	size_t iterations = 0;
 	for (; iterations < m_maxIterations; ++iterations)
@@ -79,8 +90,20 @@ std::shared_ptr<PhysicsManagerState> CcdCollisionLoop::doUpdate(const double& dt
 		double epsilon = 1.0 / ((1 - timeOfImpact) * m_epsilonFactor);
 
 		ccdState = m_updateCcdData->update(localTimeOfImpact, ccdState);
-		ccdState = m_ccdCollision->update(dt, ccdState);
-		ccdState = m_contactFilter->update(dt, ccdState);
+		if (m_retestAffectedPairsOnly)
+		{
+			// Run the detection on the affected pairs only, the other ones were cleared by backupContacts()
+			auto allPairs = ccdState->getCollisionPairs();
+			ccdState->setCollisionPairs(pairsToTest);
+			ccdState = m_ccdCollision->update(dt, ccdState);
+			ccdState = m_contactFilter->update(dt, ccdState);
+			ccdState->setCollisionPairs(allPairs);
+		}
+		else
+		{
+			ccdState = m_ccdCollision->update(dt, ccdState);
+			ccdState = m_contactFilter->update(dt, ccdState);
+		}
 
 		if (m_logger->getThreshold() <= SurgSim::Framework::LOG_LEVEL_DEBUG)
 		{
@@ -92,6 +115,10 @@ std::shared_ptr<PhysicsManagerState> CcdCollisionLoop::doUpdate(const double& dt
 		{
 			break;
 		}
+		for (size_t i = 0; i < ccdPairs.size(); ++i)
+		{
+			hadContacts[i] = !ccdPairs[i]->getContacts().empty();
+		}
 		filterLaterContacts(&ccdPairs, epsilon, localTimeOfImpact);
 
 		restoreContacts(&ccdPairs, &oldContacts);
@@ -102,6 +129,12 @@ std::shared_ptr<PhysicsManagerState> CcdCollisionLoop::doUpdate(const double& dt
 		ccdState = m_pushResults->update(dt, ccdState);
 		executedOnce = true;
 
+		if (m_retestAffectedPairsOnly)
+		{
+			findAffectedPairs(ccdPairs, hadContacts, ccdState->getCollisionToPhysicsMap(),
+							  ccdState->getActiveConstraints(), &pairsToTest);
+		}
+
 		backupContacts(&ccdPairs, &oldContacts);
 
 		timeOfImpact += (1.0 - timeOfImpact) * localTimeOfImpact;
@@ -119,6 +152,14 @@ std::shared_ptr<PhysicsManagerState> CcdCollisionLoop::doUpdate(const double& dt
 		{
 			break;
 		}
+
+		// Out of time, the remaining contacts will be handled at the start of the next time step.
+		if (m_timeBudget > 0.0 && timer.getCurrentTime() > m_timeBudget)
+		{
+			SURGSIM_LOG_WARNING(m_logger) << "Ran out of time (" << m_timeBudget << "s) after " <<
+										  iterations + 1 << " iterations";
+			break;
+		}
 	}
 
 	SURGSIM_LOG_IF(iterations == m_maxIterations, m_logger, WARNING) <<
@@ -146,6 +187,37 @@ void CcdCollisionLoop::setPushResults(std::unique_ptr<PushResults> computation)
 	m_pushResults = std::move(computation);
 }
 
+void CcdCollisionLoop::setMaxIterations(size_t maxIterations)
+{
+	m_maxIterations = maxIterations;
+}
+
+size_t CcdCollisionLoop::getMaxIterations() const
+{
+	return m_maxIterations;
+}
+
+void CcdCollisionLoop::setRetestAffectedPairsOnly(bool retestAffectedPairsOnly)
+{
+	m_retestAffectedPairsOnly = retestAffectedPairsOnly;
+}
+
+bool CcdCollisionLoop::isRetestingAffectedPairsOnly() const
+{
+	return m_retestAffectedPairsOnly;
+}
+
+void CcdCollisionLoop::setTimeBudget(double budget)
+{
+	SURGSIM_ASSERT(budget >= 0.0) << "The time budget cannot be negative (" << budget << ").";
+	m_timeBudget = budget;
+}
+
+double CcdCollisionLoop::getTimeBudget() const
+{
+	return m_timeBudget;
+}
+
 bool CcdCollisionLoop::findEarliestContact(
 	const std::vector<std::shared_ptr<Collision::CollisionPair>>& ccdPairs,
 	double* currentTimeOfImpact)
@@ -219,6 +291,73 @@ void CcdCollisionLoop::restoreContacts(std::vector<std::shared_ptr<Collision::Co
 	oldContacts->clear();
 }
 
+void CcdCollisionLoop::findAffectedPairs(const std::vector<std::shared_ptr<Collision::CollisionPair>>& ccdPairs,
+		const std::vector<bool>& hadContacts,
+		const std::unordered_map<std::shared_ptr<Collision::Representation>,
+		std::shared_ptr<Representation>>& collisionToPhysics,
+		const std::vector<std::shared_ptr<Constraint>>& constraints,
+		std::vector<std::shared_ptr<Collision::CollisionPair>>* pairsToTest)
+{
+	SURGSIM_ASSERT(pairsToTest != nullptr) << "Invalid container found.";
+	SURGSIM_ASSERT(hadContacts.size() == ccdPairs.size()) << "Contact size exception detected";
+
+	// The representations that can be moved by the solve, a physics representation may drive several collision
+	// representations
+	std::unordered_set<Collision::Representation*> correctedCollision;
+	std::unordered_set<Representation*> correctedPhysics;
+	auto addRepresentation = [&](const std::shared_ptr<Collision::Representation>& representation)
+	{
+		correctedCollision.insert(representation.get());
+		auto physics = collisionToPhysics.find(representation);
+		if (physics != collisionToPhysics.end())
+		{
+			correctedPhysics.insert(physics->second.get());
+		}
+	};
+	for (const auto& pair : ccdPairs)
+	{
+		if (!pair->getContacts().empty())
+		{
+			addRepresentation(pair->getFirst());
+			addRepresentation(pair->getSecond());
+		}
+	}
+
+	// The other constraints of the solve, e.g. the scene constraints, move their representations as well
+	for (const auto& constraint : constraints)
+	{
+		for (const auto& localization : {constraint->getLocalizations().first, constraint->getLocalizations().second})
+		{
+			if (localization != nullptr && localization->getRepresentation() != nullptr)
+			{
+				correctedPhysics.insert(localization->getRepresentation().get());
+			}
+		}
+	}
+
+	auto isCorrected = [&](const std::shared_ptr<Collision::Representation>& representation)
+	{
+		if (correctedCollision.count(representation.get()) > 0)
+		{
+			return true;
+		}
+		auto physics = collisionToPhysics.find(representation);
+		return physics != collisionToPhysics.end() && correctedPhysics.count(physics->second.get()) > 0;
+	};
+
+	// A pair that is not affected moves along the same trajectory as in this iteration, but over a shorter
+	// interval, it did not have any contacts and cannot have any in the next one.
+	pairsToTest->clear();
+	for (size_t i = 0; i < ccdPairs.size(); ++i)
+	{
+		const auto& pair = ccdPairs[i];
+		if (hadContacts[i] || isCorrected(pair->getFirst()) || isCorrected(pair->getSecond()))
+		{
+			pairsToTest->push_back(pair);
+		}
+	}
+}
+
 void CcdCollisionLoop::printContacts(const std::vector<std::shared_ptr<Collision::CollisionPair>>& ccdPairs)
 {
 	std::stringstream out;
@@ -16,6 +16,9 @@
 #ifndef SURGSIM_PHYSICS_CCDCOLLISIONLOOP_H
 #define SURGSIM_PHYSICS_CCDCOLLISIONLOOP_H
 
+#include <unordered_map>
+#include <vector>
+
 #include "SurgSim/Physics/ComputationGroup.h"
 
 namespace SurgSim
@@ -29,6 +32,7 @@ class Logger;
 namespace Collision
 {
 class CollisionPair;
+class Representation;
 struct Contact;
 }
 namespace Physics
@@ -39,9 +43,11 @@ class ContactFiltering;
 class UpdateCcdData;
 class ContactConstraintGeneration;
 class BuildMlcp;
+class Constraint;
 class SolveMlcp;
 class PushResults;
 class PhysicsManager;
+class Representation;
 
 class CcdCollisionLoop : public Computation
 {
@@ -66,10 +72,37 @@ class CcdCollisionLoop : public Computation
 	/// \param computation A unique_ptr to the PushResults...will be empty after the call.
 	void setPushResults(std::unique_ptr<PushResults> computation);
 
+	/// Set the maximum number of iterations of the loop
+	/// \param maxIterations the maximum number of iterations, 20 by default
+	void setMaxIterations(size_t maxIterations);
+
+	/// \return the maximum number of iterations of the loop
+	size_t getMaxIterations() const;
+
+	/// Only test again the pairs that can have been affected by the corrections of the previous iteration, i.e.
+	/// the pairs that had contacts in the remaining interval, and the pairs with a representation that was part of
+	/// the last solve, through a contact or through any other active constraint. The other pairs move along the
+	/// same trajectory on a shorter interval and cannot have contacts. The results are the same as when all the
+	/// pairs are tested, this is off by default.
+	/// \param retestAffectedPairsOnly true to skip the pairs that cannot have been affected
+	void setRetestAffectedPairsOnly(bool retestAffectedPairsOnly);
+
+	/// \return true if only the affected pairs are tested again after the first iteration
+	bool isRetestingAffectedPairsOnly() const;
+
+	/// Set the wall clock time after which no new iteration is started, the contacts that are left are handled
+	/// in the next time step, as when the maximum number of iterations is reached.
+	/// \param budget the time budget in seconds, 0 for no limit (the default)
+	void setTimeBudget(double budget);
+
+	/// \return the wall clock time after which no new iteration is started, in seconds, 0 for no limit
+	double getTimeBudget() const;
+
 	///@{
 	/// Test access
 	friend class CcdCollisionLoopTest_FilterContacts_Test;
 	friend class CcdCollisionLoopTest_FilterContactsWithEpsilon_Test;
+	friend class CcdCollisionLoopTest_FindAffectedPairs_Test;
 	///@}
 
 private:
@@ -86,6 +119,12 @@ class CcdCollisionLoop : public Computation
 
 	size_t m_maxIterations; ///< maximum number of iterations to run
 
+	/// Whether to only test again the pairs affected by the last corrections
+	bool m_retestAffectedPairsOnly;
+
+	/// The time budget of the loop in seconds, 0 for no limit
+	double m_timeBudget;
+
 	/// epsilon as a fraction of dt, i.e. if this is 100, the epsilon will be dt/100
 	/// during the iteration epsilon will be scaled to remain dt/100 as it pertains to the ever shrinking interval
 	/// that is the iterations intervall
@@ -119,6 +158,20 @@ class CcdCollisionLoop : public Computation
 	void restoreContacts(std::vector<std::shared_ptr<Collision::CollisionPair>>* ccdPairs,
 						 std::vector<std::list<std::shared_ptr<Collision::Contact>>>* oldContacts);
 
+	/// Find the pairs that need to be tested again after the corrections of the current iteration
+	/// \param ccdPairs the list of pairs, with the contacts that are going to be solved
+	/// \param hadContacts for each pair, true if it had contacts before the later contacts were filtered
+	/// \param collisionToPhysics the physics representations of the collision representations
+	/// \param constraints the active constraints of the solve, including the ones that are not contacts (e.g. the
+	/// 	scene constraints), their representations are corrected as well
+	/// \param [out] pairsToTest the pairs that can have contacts in the next iteration
+	void findAffectedPairs(const std::vector<std::shared_ptr<Collision::CollisionPair>>& ccdPairs,
+						   const std::vector<bool>& hadContacts,
+						   const std::unordered_map<std::shared_ptr<Collision::Representation>,
+						   std::shared_ptr<Representation>>& collisionToPhysics,
+						   const std::vector<std::shared_ptr<Constraint>>& constraints,
+						   std::vector<std::shared_ptr<Collision::CollisionPair>>* pairsToTest);
+
 	/// Logs all of the contacts
 	/// \param ccdPairs the list of current contact pairs
 	void printContacts(const std::vector<std::shared_ptr<Collision::CollisionPair>>& ccdPairs);
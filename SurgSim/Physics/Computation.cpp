@@ -95,7 +95,7 @@ std::shared_ptr<PhysicsManagerState> Computation::preparePhysicsState(const std:
 
 	for (int constraintType = 0 ; constraintType < constraintTypeEnd ; constraintType++)
 	{
-		auto constraints = state->getConstraintGroup(constraintType);
+		const auto& constraints = state->getConstraintGroup(constraintType);
 		for (auto it = constraints.begin(); it != constraints.end(); it++)
 		{
 			if ((*it)->isActive())
@@ -26,6 +26,28 @@ namespace SurgSim
 namespace Physics
 {
 
+namespace
+{
+
+/// Get a localization of a representation, moving the previous localization of the constraint when nothing else
+/// references it, so that a pooled constraint does not allocate new localizations
+/// \param representation The representation
+/// \param location The location on the representation
+/// \param previous The previous localization of the constraint on this side, can be nullptr
+/// \return The localization, nullptr if it could not be created
+std::shared_ptr<Localization> makeLocalization(const std::shared_ptr<Representation>& representation,
+		const SurgSim::DataStructures::Location& location, const std::shared_ptr<Localization>& previous)
+{
+	if (previous != nullptr && previous.use_count() == 1 && previous->getRepresentation() == representation &&
+		representation->updateLocalization(location, previous.get()))
+	{
+		return previous;
+	}
+	return representation->createLocalization(location);
+}
+
+}
+
 Constraint::Constraint(ConstraintType constraintType,
 	std::shared_ptr<ConstraintData> data,
 	std::shared_ptr<Representation> representation0,
@@ -136,10 +158,10 @@ void Constraint::setInformation(ConstraintType constraintType,
 	SURGSIM_ASSERT(representation0 != nullptr) << "First representation can't be nullptr";
 	SURGSIM_ASSERT(representation1 != nullptr) << "Second representation can't be nullptr";
 
-	auto localization0 = representation0->createLocalization(location0);
+	auto localization0 = makeLocalization(representation0, location0, m_localizations.first);
 	SURGSIM_ASSERT(localization0 != nullptr) << "Could not create localization for " << representation0->getName();
 
-	auto localization1 = representation1->createLocalization(location1);
+	auto localization1 = makeLocalization(representation1, location1, m_localizations.second);
 	SURGSIM_ASSERT(localization1 != nullptr) << "Could not create localization for " << representation1->getName();
 
 	auto implementation0 = representation0->getConstraintImplementation(m_constraintType);
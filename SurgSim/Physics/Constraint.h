@@ -57,6 +57,8 @@ class Constraint
 	/// \param data The data for this constraint.
 	/// \param representation0, representation1 Both representations in this constraint.
 	/// \param location0, location1 Both locations of the representations involved in this constraint.
+	/// \note The localizations of the constraint are moved to the new locations instead of being created again when
+	/// 	nothing else references them and the representations support it (see Representation::updateLocalization()).
 	void setInformation(
 		ConstraintType constraintType,
 		std::shared_ptr<ConstraintData> data,
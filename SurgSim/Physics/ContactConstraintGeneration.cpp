@@ -15,6 +15,7 @@
 
 #include "SurgSim/Physics/ContactConstraintGeneration.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -25,6 +26,7 @@
 #include "SurgSim/Physics/Constraint.h"
 #include "SurgSim/Physics/ContactConstraintData.h"
 #include "SurgSim/Physics/ConstraintImplementation.h"
+#include "SurgSim/Physics/Localization.h"
 #include "SurgSim/Physics/PhysicsManagerState.h"
 #include "SurgSim/Physics/Representation.h"
 
@@ -33,7 +35,9 @@ namespace SurgSim
 namespace Physics
 {
 
-ContactConstraintGeneration::ContactConstraintGeneration(bool doCopyState) : Computation(doCopyState)
+ContactConstraintGeneration::ContactConstraintGeneration(bool doCopyState) :
+	Computation(doCopyState),
+	m_nextPooledConstraint(0)
 {
 	m_logger = SurgSim::Framework::Logger::getLogger("ContactConstraintGeneration");
 }
@@ -51,8 +55,11 @@ std::shared_ptr<PhysicsManagerState> ContactConstraintGeneration::doUpdate(
 
 	auto result = state;
 	auto& pairs = result->getCollisionPairs();
+	const auto& collisionToPhysicsMap = state->getCollisionToPhysicsMap();
 
-	std::vector<std::shared_ptr<Constraint>> constraints;
+	m_constraints.clear();
+	m_nextPooledConstraint = 0;
+	std::pair<Location, Location> physicsLocations;
 
 	// This will check all collision pairs for contacts, then iterate over all
 	// the contacts and for each contact will create a constraint between the
@@ -63,9 +70,8 @@ std::shared_ptr<PhysicsManagerState> ContactConstraintGeneration::doUpdate(
 	{
 		if (pair->hasContacts())
 		{
-			auto collisionRepresentations = pair->getRepresentations();
+			const auto& collisionRepresentations = pair->getRepresentations();
 
-			auto collisionToPhysicsMap = state->getCollisionToPhysicsMap();
 			auto foundFirst = collisionToPhysicsMap.find(collisionRepresentations.first);
 			auto foundSecond = collisionToPhysicsMap.find(collisionRepresentations.second);
 			if (foundFirst == collisionToPhysicsMap.end() || foundSecond == collisionToPhysicsMap.end())
@@ -92,51 +98,119 @@ std::shared_ptr<PhysicsManagerState> ContactConstraintGeneration::doUpdate(
 			const auto& contacts = pair->getContacts();
 			for (auto& contact : contacts)
 			{
-				std::pair<std::shared_ptr<Location>, std::shared_ptr<Location>> locations;
-
-				locations.first = makeLocation(physicsRepresentations.first, collisionRepresentations.first,
-											   contact->penetrationPoints.first);
-				locations.second = makeLocation(physicsRepresentations.second, collisionRepresentations.second,
-												contact->penetrationPoints.second);
-
-				// HS-2013-jul-12 The type of constraint is fixed here right now, to get to a constraint
-				// that we can change we probably will need to predefine collision pairs and their appropriate
-				// contact constraints so we can look up which constraint to use here
-				auto data = std::make_shared<ContactConstraintData>();
-				data->setPlaneEquation(contact->normal, contact->depth);
-				data->setContact(contact);
-
-				constraints.push_back(std::make_shared<Constraint>(
-										  SurgSim::Physics::FRICTIONLESS_3DCONTACT, data,
-										  physicsRepresentations.first, *locations.first,
-										  physicsRepresentations.second, *locations.second));
+				const Location& location0 = makeLocation(physicsRepresentations.first,
+										   collisionRepresentations.first, contact->penetrationPoints.first,
+										   &physicsLocations.first);
+				const Location& location1 = makeLocation(physicsRepresentations.second,
+										   collisionRepresentations.second, contact->penetrationPoints.second,
+										   &physicsLocations.second);
+
+				m_constraints.push_back(makeConstraint(contact, physicsRepresentations, location0, location1));
 			}
 		}
 	}
 
-	result->setConstraintGroup(CONSTRAINT_GROUP_TYPE_CONTACT, constraints);
+	result->setConstraintGroup(CONSTRAINT_GROUP_TYPE_CONTACT, m_constraints);
+	trimConstraintPool(result);
 
 	return std::move(result);
 }
 
-std::shared_ptr<SurgSim::DataStructures::Location> ContactConstraintGeneration::makeLocation(
-	std::shared_ptr<SurgSim::Physics::Representation> physicsRepresentation,
-	std::shared_ptr<SurgSim::Collision::Representation> collisionRepresentation,
-	const SurgSim::DataStructures::Location& location)
+bool ContactConstraintGeneration::isFree(const PooledConstraint& pooled)
 {
-	auto physicsLocation = std::make_shared<SurgSim::DataStructures::Location>(location);
-	SURGSIM_ASSERT(physicsLocation != nullptr) << "Cannot create Location object.";
+	return pooled.constraint.use_count() == 1 && pooled.data.use_count() == 2;
+}
 
-	if (location.rigidLocalPosition.hasValue())
+void ContactConstraintGeneration::trimConstraintPool(const std::shared_ptr<PhysicsManagerState>& state)
+{
+	const auto& representations = state->getRepresentations();
+	m_stateRepresentations.clear();
+	for (const auto& representation : representations)
 	{
-		// Move the local position from the collision representation that created the location
-		// to local coordinates of the physics representation that is creating a localization
-		physicsLocation->rigidLocalPosition.setValue(
-			physicsRepresentation->getLocalPose().inverse() *
-			collisionRepresentation->getLocalPose() *
-			location.rigidLocalPosition.getValue());
+		m_stateRepresentations.push_back(representation.get());
 	}
-	return physicsLocation;
+	std::sort(m_stateRepresentations.begin(), m_stateRepresentations.end());
+
+	auto isInState = [this](const std::shared_ptr<Localization>& localization)
+	{
+		return localization != nullptr && std::binary_search(m_stateRepresentations.begin(),
+				m_stateRepresentations.end(), localization->getRepresentation().get());
+	};
+
+	// The constraints of the current frame are referenced by the state, they are never free. A constraint that went
+	// back to the pool releases its contact, so that the contact arena can reuse the storage of the contact
+	for (auto& pooled : m_constraintPool)
+	{
+		if (isFree(pooled))
+		{
+			pooled.data->setContact(nullptr);
+		}
+	}
+	m_constraintPool.erase(std::remove_if(m_constraintPool.begin(), m_constraintPool.end(),
+		[&isInState](const PooledConstraint& pooled)
+		{
+			const auto& localizations = pooled.constraint->getLocalizations();
+			return isFree(pooled) && !(isInState(localizations.first) && isInState(localizations.second));
+		}), m_constraintPool.end());
+}
+
+const SurgSim::DataStructures::Location& ContactConstraintGeneration::makeLocation(
+	const std::shared_ptr<SurgSim::Physics::Representation>& physicsRepresentation,
+	const std::shared_ptr<SurgSim::Collision::Representation>& collisionRepresentation,
+	const SurgSim::DataStructures::Location& location,
+	SurgSim::DataStructures::Location* physicsLocation)
+{
+	if (!location.rigidLocalPosition.hasValue())
+	{
+		return location;
+	}
+
+	// Move the local position from the collision representation that created the location
+	// to local coordinates of the physics representation that is creating a localization
+	*physicsLocation = location;
+	physicsLocation->rigidLocalPosition.setValue(
+		physicsRepresentation->getLocalPose().inverse() *
+		collisionRepresentation->getLocalPose() *
+		location.rigidLocalPosition.getValue());
+	return *physicsLocation;
+}
+
+std::shared_ptr<Constraint> ContactConstraintGeneration::makeConstraint(
+	const std::shared_ptr<SurgSim::Collision::Contact>& contact,
+	const std::pair<std::shared_ptr<Representation>, std::shared_ptr<Representation>>& physicsRepresentations,
+	const SurgSim::DataStructures::Location& location0,
+	const SurgSim::DataStructures::Location& location1)
+{
+	while (m_nextPooledConstraint < m_constraintPool.size() && !isFree(m_constraintPool[m_nextPooledConstraint]))
+	{
+		++m_nextPooledConstraint;
+	}
+
+	// HS-2013-jul-12 The type of constraint is fixed here right now, to get to a constraint
+	// that we can change we probably will need to predefine collision pairs and their appropriate
+	// contact constraints so we can look up which constraint to use here
+	if (m_nextPooledConstraint < m_constraintPool.size())
+	{
+		auto& pooled = m_constraintPool[m_nextPooledConstraint++];
+		pooled.data->setPlaneEquation(contact->normal, contact->depth);
+		pooled.data->setContact(contact);
+		pooled.constraint->setInformation(SurgSim::Physics::FRICTIONLESS_3DCONTACT, pooled.data,
+										  physicsRepresentations.first, location0,
+										  physicsRepresentations.second, location1);
+		pooled.constraint->setActive(true);
+		return pooled.constraint;
+	}
+
+	PooledConstraint pooled;
+	pooled.data = std::make_shared<ContactConstraintData>();
+	pooled.data->setPlaneEquation(contact->normal, contact->depth);
+	pooled.data->setContact(contact);
+	pooled.constraint = std::make_shared<Constraint>(SurgSim::Physics::FRICTIONLESS_3DCONTACT, pooled.data,
+												   physicsRepresentations.first, location0,
+												   physicsRepresentations.second, location1);
+	m_constraintPool.push_back(pooled);
+	m_nextPooledConstraint = m_constraintPool.size();
+	return pooled.constraint;
 }
 
 }; // Physics
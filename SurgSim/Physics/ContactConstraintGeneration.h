@@ -17,6 +17,7 @@
 #define SURGSIM_PHYSICS_CONTACTCONSTRAINTGENERATION_H
 
 #include  <memory>
+#include <vector>
 
 #include "SurgSim/Framework/Macros.h"
 #include "SurgSim/Physics/Computation.h"
@@ -36,12 +37,15 @@ struct Location;
 }
 namespace Collision
 {
+struct Contact;
 class Representation;
 }
 
 namespace Physics
 {
 
+class Constraint;
+class ContactConstraintData;
 class Localization;
 class PhysicsManagerState;
 class Representation;
@@ -56,6 +60,13 @@ class Representation;
 /// - Create a constraint from, the ContactImplmentation, Localization and ConstraintData
 /// - Add it to the list of Constraints
 /// At the end those constraints are added as contact constraints to the physics state
+/// The constraints and their data are pooled, a constraint created in a previous frame is reused once the physics
+/// states referencing it are gone, its localizations being moved to the new contact when the representations support
+/// it (see Representation::updateLocalization()), so at steady state no constraint is allocated for each contact.
+/// Free pooled constraints on representations that are no longer in the physics state are dropped from the pool, so
+/// that the pool does not keep removed representations alive.
+/// Free pooled constraints also release their contacts, which live in the contact arena of the physics state (see
+/// Collision::ContactArena) whose storage is only reused once nothing references them.
 class ContactConstraintGeneration : public Computation
 {
 public:
@@ -84,12 +95,57 @@ class ContactConstraintGeneration : public Computation
 	/// \param	physicsRepresentation	The physics representation.
 	/// \param	collisionRepresentation	The collision representation.
 	/// \param	location				The location generated by the contact calculation.
-	/// \return	The localization for the collision representations physics representation.
-	/// \note Asserts if cannot Location create shared object.
-	std::shared_ptr<SurgSim::DataStructures::Location> makeLocation(
-		std::shared_ptr<SurgSim::Physics::Representation> physicsRepresentation,
-		std::shared_ptr<SurgSim::Collision::Representation> collisionRepresentation,
-		const SurgSim::DataStructures::Location& location);
+	/// \param [out] physicsLocation	Storage for the location in the physics representation, only used when it
+	/// 		differs from the location generated by the contact calculation.
+	/// \return	The location for the collision representations physics representation, either location or
+	/// 		physicsLocation.
+	const SurgSim::DataStructures::Location& makeLocation(
+		const std::shared_ptr<SurgSim::Physics::Representation>& physicsRepresentation,
+		const std::shared_ptr<SurgSim::Collision::Representation>& collisionRepresentation,
+		const SurgSim::DataStructures::Location& location,
+		SurgSim::DataStructures::Location* physicsLocation);
+
+	/// Make the constraint for a contact, reusing a constraint of the pool once nothing but the pool references it
+	/// and its data, otherwise adding a new constraint to the pool.
+	/// \param	contact					The contact to constrain.
+	/// \param	physicsRepresentations	The physics representations of both sides of the contact.
+	/// \param	location0, location1		The locations of the contact on both physics representations.
+	/// \return	The frictionless contact constraint.
+	std::shared_ptr<Constraint> makeConstraint(
+		const std::shared_ptr<SurgSim::Collision::Contact>& contact,
+		const std::pair<std::shared_ptr<Representation>, std::shared_ptr<Representation>>& physicsRepresentations,
+		const SurgSim::DataStructures::Location& location0,
+		const SurgSim::DataStructures::Location& location1);
+
+	/// A contact constraint with its data, kept from frame to frame
+	struct PooledConstraint
+	{
+		std::shared_ptr<Constraint> constraint;
+		std::shared_ptr<ContactConstraintData> data;
+	};
+
+	/// A pooled constraint is free once the physics states of the previous frames have released it, its data being
+	/// referenced by the pool and the constraint only
+	/// \param pooled The pooled constraint
+	/// \return true if the pooled constraint can be reused
+	static bool isFree(const PooledConstraint& pooled);
+
+	/// Release the contacts of the free pooled constraints, and drop the ones that act on a representation that is
+	/// not in the physics state anymore
+	/// \param state The physics state of the current frame
+	void trimConstraintPool(const std::shared_ptr<PhysicsManagerState>& state);
+
+	/// The pool of contact constraints
+	std::vector<PooledConstraint> m_constraintPool;
+
+	/// The position in the pool to look for the next free constraint in the current frame
+	size_t m_nextPooledConstraint;
+
+	/// The constraints generated in the current frame, kept to reuse the storage
+	std::vector<std::shared_ptr<Constraint>> m_constraints;
+
+	/// The sorted representations of the physics state of the current frame, kept to reuse the storage
+	std::vector<const Representation*> m_stateRepresentations;
 };
 
 }; // Physics
@@ -51,7 +51,6 @@ std::shared_ptr<PhysicsManagerState> ContactFiltering::doUpdate(
 
 	std::shared_ptr<PhysicsManagerState> result = state;
 	auto threadPool = Framework::Runtime::getThreadPool();
-	std::vector<std::future<void>> tasks;
 
 	const auto& stateFilters = state->getContactFilters();
 	std::vector<std::shared_ptr<Collision::ContactFilter>> filters;
@@ -73,21 +72,12 @@ std::shared_ptr<PhysicsManagerState> ContactFiltering::doUpdate(
 	pairs.reserve(statePairs.size());
 	std::copy_if(statePairs.begin(), statePairs.end(), std::back_inserter(pairs), hasContacts);
 
-	for (auto& pair : pairs)
+	threadPool->parallelFor(0, pairs.size(), 1, [&state, &filters, &pairs](size_t i)
 	{
-		tasks.push_back(threadPool->enqueue<void>([&state, &filters, &pair]()
+		for (const auto& filter : filters)
 		{
-			for (const auto& filter : filters)
-			{
-				filter->filterContacts(state, pair);
-			}
-		}));
-	}
-
-
-	std::for_each(tasks.begin(), tasks.end(), [](std::future<void>& p)
-	{
-		p.get();
+			filter->filterContacts(state, pairs[i]);
+		}
 	});
 
 	return result;
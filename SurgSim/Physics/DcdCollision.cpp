@@ -47,23 +47,27 @@ std::shared_ptr<PhysicsManagerState> DcdCollision::doUpdate(
 {
 	std::shared_ptr<PhysicsManagerState> result = state;
 	auto threadPool = Framework::Runtime::getThreadPool();
-	std::vector<std::future<void>> tasks;
 
 	const auto& calculations = ContactCalculation::getDcdContactTable();
 
-	for (auto& pair : result->getCollisionPairs())
+	const auto& pairs = result->getCollisionPairs();
+	threadPool->parallelFor(0, pairs.size(), 1, [&calculations, &pairs](size_t i)
 	{
+		const auto& pair = pairs[i];
 		if (pair->getType() == Collision::COLLISION_DETECTION_TYPE_DISCRETE)
 		{
-			tasks.push_back(threadPool->enqueue<void>([&calculations, &pair]()
+			const auto& calculation = pair->getContactCalculation();
+			if (calculation != nullptr)
+			{
+				calculation->calculateContact(pair);
+			}
+			else
 			{
 				calculations[pair->getFirst()->getShapeType()]
 				[pair->getSecond()->getShapeType()]->calculateContact(pair);
-			}));
+			}
 		}
-	}
-
-	std::for_each(tasks.begin(), tasks.end(), [](std::future<void>& p){p.get();});
+	});
 
 	return result;
 }
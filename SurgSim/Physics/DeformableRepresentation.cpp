@@ -38,6 +38,20 @@ using SurgSim::Math::OdeState;
 using SurgSim::Math::SparseMatrix;
 using SurgSim::Math::Vector;
 
+namespace
+{
+/// \return True if the system matrix of the integration scheme only depends on the mass matrix
+bool isExplicit(SurgSim::Math::IntegrationScheme integrationScheme)
+{
+	return integrationScheme == SurgSim::Math::INTEGRATIONSCHEME_EULER_EXPLICIT ||
+		   integrationScheme == SurgSim::Math::INTEGRATIONSCHEME_EULER_EXPLICIT_MODIFIED ||
+		   integrationScheme == SurgSim::Math::INTEGRATIONSCHEME_RUNGE_KUTTA_4 ||
+		   integrationScheme == SurgSim::Math::INTEGRATIONSCHEME_LINEAR_EULER_EXPLICIT ||
+		   integrationScheme == SurgSim::Math::INTEGRATIONSCHEME_LINEAR_EULER_EXPLICIT_MODIFIED ||
+		   integrationScheme == SurgSim::Math::INTEGRATIONSCHEME_LINEAR_RUNGE_KUTTA_4;
+}
+}
+
 namespace SurgSim
 {
 
@@ -49,12 +63,18 @@ DeformableRepresentation::DeformableRepresentation(const std::string& name) :
 	SurgSim::Math::OdeEquation(),
 	m_numDofPerNode(0),
 	m_integrationScheme(SurgSim::Math::INTEGRATIONSCHEME_EULER_EXPLICIT),
-	m_linearSolver(SurgSim::Math::LINEARSOLVER_LU)
+	m_linearSolver(SurgSim::Math::LINEARSOLVER_LU),
+	m_matrixFreeCompliance(false),
+	m_matrixFreeSystem(false)
 {
 	SURGSIM_ADD_SERIALIZABLE_PROPERTY(DeformableRepresentation, SurgSim::Math::IntegrationScheme, IntegrationScheme,
 									  getIntegrationScheme, setIntegrationScheme);
 	SURGSIM_ADD_SERIALIZABLE_PROPERTY(DeformableRepresentation, SurgSim::Math::LinearSolver, LinearSolver,
 									  getLinearSolver, setLinearSolver);
+	SURGSIM_ADD_SERIALIZABLE_PROPERTY(DeformableRepresentation, bool, MatrixFreeSystem,
+									  getMatrixFreeSystem, setMatrixFreeSystem);
+	SURGSIM_ADD_SERIALIZABLE_PROPERTY(DeformableRepresentation, bool, MatrixFreeCompliance,
+									  getMatrixFreeCompliance, setMatrixFreeCompliance);
 	SURGSIM_ADD_SERIALIZABLE_PROPERTY(DeformableRepresentation, std::shared_ptr<SurgSim::Collision::Representation>,
 									  CollisionRepresentation, getCollisionRepresentation, setCollisionRepresentation);
 }
@@ -156,6 +176,30 @@ SurgSim::Math::LinearSolver DeformableRepresentation::getLinearSolver() const
 	return m_linearSolver;
 }
 
+void DeformableRepresentation::setMatrixFreeSystem(bool matrixFreeSystem)
+{
+	SURGSIM_ASSERT(!isInitialized()) <<
+		"You cannot set the matrix free system after the component has been initialized";
+	m_matrixFreeSystem = matrixFreeSystem;
+}
+
+bool DeformableRepresentation::getMatrixFreeSystem() const
+{
+	return m_matrixFreeSystem;
+}
+
+void DeformableRepresentation::setMatrixFreeCompliance(bool matrixFreeCompliance)
+{
+	SURGSIM_ASSERT(!isInitialized()) <<
+		"You cannot set the matrix free compliance after the component has been initialized";
+	m_matrixFreeCompliance = matrixFreeCompliance;
+}
+
+bool DeformableRepresentation::getMatrixFreeCompliance() const
+{
+	return m_matrixFreeCompliance;
+}
+
 const SurgSim::Math::Vector& DeformableRepresentation::getExternalGeneralizedForce() const
 {
 	return m_externalGeneralizedForce;
@@ -175,12 +219,44 @@ Math::Matrix DeformableRepresentation::applyCompliance(const Math::OdeState& sta
 {
 	SURGSIM_ASSERT(m_odeSolver) << "Ode solver not initialized, it should have been initialized on wake-up";
 
+	if (m_matrixFreeSystem)
+	{
+		// The linear solver is never given the system matrix, solve with the conjugate gradient
+		Math::Matrix solution;
+		std::static_pointer_cast<Math::OdeSolverEulerImplicit>(m_odeSolver)->solveMatrixFree(state, b, &solution);
+		return solution;
+	}
+	return solveWithBoundaryConditions(state, *m_odeSolver->getLinearSolver(), b);
+}
+
+const SurgSim::Math::Matrix& DeformableRepresentation::getComplianceMatrix() const
+{
+	SURGSIM_ASSERT(m_odeSolver) << "Ode solver not initialized, it should have been initialized on wake-up";
+	SURGSIM_ASSERT(!m_matrixFreeCompliance) << getName() << " uses the matrix free compliance, " <<
+		"the compliance matrix is not computed, use computeCHt() instead";
+	return m_odeSolver->getComplianceMatrix();
+}
+
+Math::Vector DeformableRepresentation::computeCHt(const Eigen::SparseVector<double, Eigen::RowMajor, ptrdiff_t>& h)
+{
+	if (!m_matrixFreeCompliance)
+	{
+		return getComplianceMatrix() * h.transpose();
+	}
+
+	SURGSIM_ASSERT(m_odeSolver) << "Ode solver not initialized, it should have been initialized on wake-up";
+	return DeformableRepresentation::applyCompliance(*m_currentState, h.transpose().toDense());
+}
+
+Math::Matrix DeformableRepresentation::solveWithBoundaryConditions(const Math::OdeState& state,
+		const Math::LinearSparseSolveAndInverse& linearSolver, const Math::Matrix& b) const
+{
 	Math::Matrix bTemp = b;
 	for (auto condition : state.getBoundaryConditions())
 	{
 		Math::zeroRow(condition, &bTemp);
 	}
-	auto solution = m_odeSolver->getLinearSolver()->solve(bTemp);
+	auto solution = linearSolver.solve(bTemp);
 	for (auto condition : state.getBoundaryConditions())
 	{
 		Math::zeroRow(condition, &solution);
@@ -188,12 +264,6 @@ Math::Matrix DeformableRepresentation::applyCompliance(const Math::OdeState& sta
 	return solution;
 }
 
-const SurgSim::Math::Matrix& DeformableRepresentation::getComplianceMatrix() const
-{
-	SURGSIM_ASSERT(m_odeSolver) << "Ode solver not initialized, it should have been initialized on wake-up";
-	return m_odeSolver->getComplianceMatrix();
-}
-
 void DeformableRepresentation::update(double dt)
 {
 	if (! isActive())
@@ -206,8 +276,8 @@ void DeformableRepresentation::update(double dt)
 	SURGSIM_ASSERT(m_initialState != nullptr) <<
 			"Initial state has not been set yet. Did you call setInitialState() ?";
 
-	// Solve the ode
-	m_odeSolver->solve(dt, *m_currentState, m_newState.get());
+	// Solve the ode, the compliance matrix is only needed when the compliance is not matrix free
+	m_odeSolver->solve(dt, *m_currentState, m_newState.get(), !m_matrixFreeCompliance);
 
 	// Back up the current state into the previous state (by swapping)
 	m_currentState.swap(m_previousState);
@@ -369,21 +439,66 @@ bool DeformableRepresentation::doInitialize()
 	}
 
 	// Set the linear solver with initial settings on the ode solver
+	auto linearSolver = createLinearSolver();
+	if (linearSolver == nullptr)
+	{
+		SURGSIM_LOG_WARNING(SurgSim::Framework::Logger::getDefaultLogger())
+				<< "Linear solver not initialized, the linear solver is invalid";
+		return false;
+	}
+	m_odeSolver->setLinearSolver(linearSolver);
+
+	// The compliance of a diagonal mass with an explicit scheme is a scaling, applied without the dense matrix
+	if (hasDiagonalMass() && isExplicit(m_integrationScheme))
+	{
+		m_matrixFreeCompliance = true;
+	}
+
+	if (m_matrixFreeSystem)
+	{
+		if (m_integrationScheme != SurgSim::Math::INTEGRATIONSCHEME_EULER_IMPLICIT)
+		{
+			SURGSIM_LOG_WARNING(SurgSim::Framework::Logger::getDefaultLogger())
+					<< "The matrix free system is only supported by the implicit Euler integration scheme";
+			return false;
+		}
+		std::static_pointer_cast<SurgSim::Math::OdeSolverEulerImplicit>(m_odeSolver)->setMatrixFree(true);
+
+		// The compliance matrix cannot be computed without the system matrix
+		m_matrixFreeCompliance = true;
+	}
+
+	return true;
+}
+
+std::shared_ptr<SurgSim::Math::LinearSparseSolveAndInverse> DeformableRepresentation::createLinearSolver() const
+{
+	std::shared_ptr<SurgSim::Math::LinearSparseSolveAndInverse> linearSolver;
+
+	// The system matrix of the explicit schemes is M/dt, with a diagonal mass it is solved component-wise
+	if (hasDiagonalMass() && isExplicit(m_integrationScheme))
+	{
+		return std::make_shared<SurgSim::Math::LinearSparseSolveAndInverseDiagonal>();
+	}
+
 	switch (m_linearSolver)
 	{
 		case SurgSim::Math::LINEARSOLVER_LU:
-			m_odeSolver->setLinearSolver(std::make_shared<SurgSim::Math::LinearSparseSolveAndInverseLU>());
+			linearSolver = std::make_shared<SurgSim::Math::LinearSparseSolveAndInverseLU>();
 			break;
 		case SurgSim::Math::LINEARSOLVER_CONJUGATEGRADIENT:
-			m_odeSolver->setLinearSolver(std::make_shared<SurgSim::Math::LinearSparseSolveAndInverseCG>());
+			linearSolver = std::make_shared<SurgSim::Math::LinearSparseSolveAndInverseCG>();
+			break;
+		case SurgSim::Math::LINEARSOLVER_LDLT:
+			linearSolver = std::make_shared<SurgSim::Math::LinearSparseSolveAndInverseLDLT>();
+			break;
+		case SurgSim::Math::LINEARSOLVER_DIAGONAL:
+			linearSolver = std::make_shared<SurgSim::Math::LinearSparseSolveAndInverseDiagonal>();
 			break;
 		default:
-			SURGSIM_LOG_WARNING(SurgSim::Framework::Logger::getDefaultLogger())
-					<< "Linear solver not initialized, the linear solver is invalid";
-			return false;
+			break;
 	}
-
-	return true;
+	return linearSolver;
 }
 
 bool DeformableRepresentation::doWakeUp()
@@ -110,6 +110,19 @@ class DeformableRepresentation :
 	/// \note Default is SurgSim::Math::LINEARSOLVER_LU
 	SurgSim::Math::LinearSolver getLinearSolver() const;
 
+	/// Sets the matrix free system flag
+	/// When set, the linear systems of the implicit Euler scheme are solved with a preconditioned conjugate gradient
+	/// without assembling the system matrix (see SurgSim::Math::OdeSolverEulerImplicit::setMatrixFree()). This
+	/// implies the matrix free compliance, computeCHt() then solving one conjugate gradient per constraint.
+	/// \param matrixFreeSystem True to use the matrix free system, False to assemble and factorize the system matrix
+	/// \exception SurgSim::Framework::AssertionFailure raised if called after the component has been initialized.
+	/// \note Only supported by SurgSim::Math::INTEGRATIONSCHEME_EULER_IMPLICIT, the initialization fails otherwise.
+	void setMatrixFreeSystem(bool matrixFreeSystem);
+
+	/// Gets the matrix free system flag (default = false)
+	/// \return True if the linear systems are solved without assembling the system matrix, False otherwise
+	bool getMatrixFreeSystem() const;
+
 	/// Add an external generalized force applied on a specific localization
 	/// \param localization where the generalized force is applied
 	/// \param generalizedForce The force to apply (of dimension getNumDofPerNode())
@@ -129,11 +142,32 @@ class DeformableRepresentation :
 	/// \return the external generalized damping matrix
 	const SurgSim::Math::SparseMatrix& getExternalGeneralizedDamping() const;
 
+	/// Sets the matrix free compliance flag
+	/// When set, the dense compliance matrix is never computed, the compliance is only applied to the constraints
+	/// using the factorized system, see computeCHt(). Necessary for models with a large number of degrees of freedom.
+	/// \param matrixFreeCompliance True to use the matrix free compliance, False to compute the compliance matrix
+	/// \exception SurgSim::Framework::AssertionFailure raised if called after the component has been initialized.
+	/// \note An explicit integration scheme with a diagonal mass always uses the matrix free compliance, applying it
+	/// is a simple scaling.
+	void setMatrixFreeCompliance(bool matrixFreeCompliance);
+
+	/// Gets the matrix free compliance flag (default = false)
+	/// \return True if the compliance matrix is not computed, False otherwise
+	bool getMatrixFreeCompliance() const;
+
 	Math::Matrix applyCompliance(const Math::OdeState& state, const Math::Matrix& b) override;
 
 	/// Gets the compliance matrix associated with motion
+	/// \exception SurgSim::Framework::AssertionFailure raised if the matrix free compliance is used.
 	virtual const SurgSim::Math::Matrix& getComplianceMatrix() const;
 
+	/// Calculate the product C.H^t, where C is the compliance matrix with boundary conditions, for a single
+	/// constraint. With the matrix free compliance, this only solves the factorized system for H^t, or solves the
+	/// system for H^t with the conjugate gradient if the matrix free system is used.
+	/// \param h The constraint Jacobian (a row of H)
+	/// \return The vector \f$C.H^t\f$
+	virtual Math::Vector computeCHt(const Eigen::SparseVector<double, Eigen::RowMajor, ptrdiff_t>& h);
+
 	void update(double dt) override;
 
 	void afterUpdate(double dt) override;
@@ -163,6 +197,18 @@ class DeformableRepresentation :
 	virtual void transformState(std::shared_ptr<SurgSim::Math::OdeState> state,
 								const SurgSim::Math::RigidTransform3d& transform) = 0;
 
+	/// \return A new linear solver of the type given by setLinearSolver, nullptr if the type is invalid
+	/// \note With a diagonal mass and an explicit integration scheme, LinearSparseSolveAndInverseDiagonal is used
+	std::shared_ptr<SurgSim::Math::LinearSparseSolveAndInverse> createLinearSolver() const;
+
+	/// Solve a linear system, with the boundary conditions applied to the rhs and the solution
+	/// \param state The state describing the boundary conditions
+	/// \param linearSolver The linear solver, holding the system matrix
+	/// \param b The rhs matrix
+	/// \return The solution matrix
+	Math::Matrix solveWithBoundaryConditions(const Math::OdeState& state,
+			const Math::LinearSparseSolveAndInverse& linearSolver, const Math::Matrix& b) const;
+
 	/// The previous state inside the calculation loop, this has no meaning outside of the loop
 	std::shared_ptr<SurgSim::Math::OdeState> m_previousState;
 
@@ -198,6 +244,12 @@ class DeformableRepresentation :
 	/// Linear algebraic solver used
 	SurgSim::Math::LinearSolver m_linearSolver;
 
+	/// Is the compliance applied without computing the compliance matrix ?
+	bool m_matrixFreeCompliance;
+
+	/// Are the linear systems solved without assembling the system matrix ?
+	bool m_matrixFreeSystem;
+
 	/// Ode solver (its type depends on the numerical integration scheme)
 	std::shared_ptr<SurgSim::Math::OdeSolver> m_odeSolver;
 
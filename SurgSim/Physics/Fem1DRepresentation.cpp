@@ -244,6 +244,18 @@ std::shared_ptr<Localization> Fem1DRepresentation::createLocalization(const Data
 	return nullptr;
 }
 
+bool Fem1DRepresentation::updateLocalization(const DataStructures::Location& location, Localization* localization)
+{
+	auto femLocalization = dynamic_cast<Fem1DLocalization*>(localization);
+	if (femLocalization == nullptr || location.index.hasValue() || !location.elementMeshLocalCoordinate.hasValue())
+	{
+		return false;
+	}
+
+	femLocalization->setLocalPosition(*location.elementMeshLocalCoordinate);
+	return true;
+}
+
 void Fem1DRepresentation::transformState(std::shared_ptr<Math::OdeState> state,
 										 const Math::RigidTransform3d& transform)
 {
@@ -80,6 +80,9 @@ class Fem1DRepresentation : public FemRepresentation
 
 	std::shared_ptr<Localization> createLocalization(const SurgSim::DataStructures::Location& location) override;
 
+	/// \note Only the element-based locations are updated, a new localization is needed for the node-based ones
+	bool updateLocalization(const SurgSim::DataStructures::Location& location, Localization* localization) override;
+
 protected:
 	void transformState(std::shared_ptr<SurgSim::Math::OdeState> state,
 						const SurgSim::Math::RigidTransform3d& transform) override;
@@ -253,6 +253,28 @@ std::shared_ptr<Localization> Fem2DRepresentation::createLocalization(const Data
 	return nullptr;
 }
 
+bool Fem2DRepresentation::updateLocalization(const DataStructures::Location& location, Localization* localization)
+{
+	auto femLocalization = dynamic_cast<Fem2DLocalization*>(localization);
+	if (femLocalization == nullptr || location.index.hasValue())
+	{
+		return false;
+	}
+
+	// As in createLocalization(), the triangles are the elements
+	if (location.triangleMeshLocalCoordinate.hasValue())
+	{
+		femLocalization->setLocalPosition(*location.triangleMeshLocalCoordinate);
+		return true;
+	}
+	else if (location.elementMeshLocalCoordinate.hasValue())
+	{
+		femLocalization->setLocalPosition(*location.elementMeshLocalCoordinate);
+		return true;
+	}
+	return false;
+}
+
 void Fem2DRepresentation::transformState(std::shared_ptr<Math::OdeState> state,
 										 const Math::RigidTransform3d& transform)
 {
@@ -78,6 +78,10 @@ class Fem2DRepresentation : public FemRepresentation
 
 	std::shared_ptr<Localization> createLocalization(const SurgSim::DataStructures::Location& location) override;
 
+	/// \note Only the triangle and element-based locations are updated, a new localization is needed for the
+	/// node-based ones
+	bool updateLocalization(const SurgSim::DataStructures::Location& location, Localization* localization) override;
+
 protected:
 	void transformState(std::shared_ptr<SurgSim::Math::OdeState> state,
 			const SurgSim::Math::RigidTransform3d& transform) override;
@@ -39,6 +39,8 @@ SURGSIM_STATIC_REGISTRATION(Fem3DElementCorotationalTetrahedron);
 /// \note be used with any OdeSolverLinearXXX, it needs an ode solver that recomputes the data at each iteration.
 class Fem3DElementCorotationalTetrahedron : public Fem3DElementTetrahedron
 {
+	friend class Fem3DElementCorotationalTetrahedronBatch;
+
 public:
 	/// Constructor
 	Fem3DElementCorotationalTetrahedron();
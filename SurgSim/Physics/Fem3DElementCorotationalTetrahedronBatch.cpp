@@ -0,0 +1,452 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SurgSim/Physics/Fem3DElementCorotationalTetrahedronBatch.h"
+
+#include "SurgSim/Framework/Assert.h"
+#include "SurgSim/Math/OdeEquation.h"
+#include "SurgSim/Math/OdeState.h"
+#include "SurgSim/Physics/Fem3DElementCorotationalTetrahedron.h"
+
+namespace
+{
+typedef SurgSim::Physics::Fem3DElementCorotationalTetrahedronBatch Batch;
+
+/// One value per element of a batch
+typedef Eigen::Array<double, Batch::BatchSize, 1> Lanes;
+
+/// One flag per element of a batch
+typedef Eigen::Array<bool, Batch::BatchSize, 1> LaneFlags;
+
+/// One 3x3 matrix per element of a batch, stored row major
+typedef std::array<Lanes, 9> Lanes33;
+
+/// Maximum number of iterations of the polar decomposition
+const int maxPolarIterations = 30;
+
+/// Convergence threshold of the polar decomposition, on the squared norm of the last update
+const double polarTolerance = 1e-24;
+
+/// Threshold under which the matrix G of the stiffness derivative is singular (as Eigen's inverse with check)
+const double singularThreshold = 1e-12;
+
+Lanes determinant(const Lanes33& m)
+{
+	return m[0] * (m[4] * m[8] - m[5] * m[7]) - m[1] * (m[3] * m[8] - m[5] * m[6]) +
+		   m[2] * (m[3] * m[7] - m[4] * m[6]);
+}
+
+/// Compute the cofactor matrix, i.e. determinant(m).m^-T
+void cofactor(const Lanes33& m, Lanes33* c)
+{
+	(*c)[0] = m[4] * m[8] - m[5] * m[7];
+	(*c)[1] = m[5] * m[6] - m[3] * m[8];
+	(*c)[2] = m[3] * m[7] - m[4] * m[6];
+	(*c)[3] = m[2] * m[7] - m[1] * m[8];
+	(*c)[4] = m[0] * m[8] - m[2] * m[6];
+	(*c)[5] = m[1] * m[6] - m[0] * m[7];
+	(*c)[6] = m[1] * m[5] - m[2] * m[4];
+	(*c)[7] = m[2] * m[3] - m[0] * m[5];
+	(*c)[8] = m[0] * m[4] - m[1] * m[3];
+}
+
+/// Compute the rotation of the polar decomposition B = R.S with a scaled Newton iteration:
+/// X(k+1) = (g.X(k) + X(k)^-T / g) / 2 with g = |det(X(k))|^(-1/3)
+/// \param B The matrices to decompose
+/// \param[out] R The rotations
+/// \return The flags of the lanes for which the rotation is valid (B not inverted and the iteration converged)
+LaneFlags computeRotation(const Lanes33& B, Lanes33* R)
+{
+	const Lanes detB = determinant(B);
+	LaneFlags valid = (detB > 0.0);
+
+	// The invalid lanes iterate on the identity, they are discarded anyway
+	for (int i = 0; i < 9; ++i)
+	{
+		(*R)[i] = valid.select(B[i], Lanes::Constant((i % 4 == 0) ? 1.0 : 0.0));
+	}
+
+	Lanes33 cof;
+	Lanes update = Lanes::Zero();
+	for (int iteration = 0; iteration < maxPolarIterations; ++iteration)
+	{
+		const Lanes det = determinant(*R);
+		cofactor(*R, &cof);
+		const Lanes gamma = det.abs().pow(-1.0 / 3.0);
+		const Lanes inverseScale = 1.0 / (gamma * det);
+
+		update.setZero();
+		for (int i = 0; i < 9; ++i)
+		{
+			const Lanes next = 0.5 * (gamma * (*R)[i] + inverseScale * cof[i]);
+			update += (next - (*R)[i]).square();
+			(*R)[i] = next;
+		}
+
+		if ((update <= polarTolerance).all())
+		{
+			break;
+		}
+	}
+
+	return valid && (update <= polarTolerance);
+}
+
+}
+
+namespace SurgSim
+{
+
+namespace Physics
+{
+
+const size_t Fem3DElementCorotationalTetrahedronBatch::BatchSize;
+
+Fem3DElementCorotationalTetrahedronBatch::Fem3DElementCorotationalTetrahedronBatch(
+	const std::vector<std::shared_ptr<Fem3DElementCorotationalTetrahedron>>& elements) :
+	m_elements(elements),
+	m_numElements(elements.size())
+{
+	for (const auto& element : m_elements)
+	{
+		SURGSIM_ASSERT(element != nullptr) << "Cannot batch a nullptr element";
+	}
+
+	// Pad the last batch with the last element, its lanes are computed but never stored
+	const size_t numBatches = getNumBatches();
+	if (m_numElements > 0)
+	{
+		m_elements.resize(numBatches * BatchSize, m_elements.back());
+	}
+
+	m_nodeIds.resize(m_elements.size());
+	m_restShapeInverse.resize(BatchSize, 12 * numBatches);
+	m_restPositions.resize(BatchSize, 12 * numBatches);
+	m_linearStiffness.resize(BatchSize, 144 * numBatches);
+	for (size_t elementId = 0; elementId < m_elements.size(); ++elementId)
+	{
+		const Fem3DElementCorotationalTetrahedron& element = *m_elements[elementId];
+		const Eigen::Index lane = static_cast<Eigen::Index>(elementId % BatchSize);
+		const Eigen::Index batch = static_cast<Eigen::Index>(elementId / BatchSize);
+
+		std::copy(element.m_nodeIds.begin(), element.m_nodeIds.end(), m_nodeIds[elementId].begin());
+		for (Eigen::Index node = 0; node < 4; ++node)
+		{
+			for (Eigen::Index axis = 0; axis < 3; ++axis)
+			{
+				m_restShapeInverse(lane, 12 * batch + 3 * node + axis) = element.m_Vinverse(node, axis);
+				m_restPositions(lane, 12 * batch + 3 * node + axis) = element.m_x0[3 * node + axis];
+			}
+		}
+		for (Eigen::Index row = 0; row < 12; ++row)
+		{
+			for (Eigen::Index col = 0; col < 12; ++col)
+			{
+				m_linearStiffness(lane, 144 * batch + 12 * row + col) = element.m_KLinear(row, col);
+			}
+		}
+	}
+}
+
+size_t Fem3DElementCorotationalTetrahedronBatch::getNumElements() const
+{
+	return m_numElements;
+}
+
+size_t Fem3DElementCorotationalTetrahedronBatch::getNumBatches() const
+{
+	return (m_numElements + BatchSize - 1) / BatchSize;
+}
+
+void Fem3DElementCorotationalTetrahedronBatch::updateFMDK(const Math::OdeState& state, int options)
+{
+	for (size_t batchId = 0; batchId < getNumBatches(); ++batchId)
+	{
+		updateFMDK(batchId, state, options);
+	}
+}
+
+void Fem3DElementCorotationalTetrahedronBatch::updateFMDK(size_t batchId, const Math::OdeState& state, int options)
+{
+	SURGSIM_ASSERT(batchId < getNumBatches()) << "Invalid batch id " << batchId << ", there are " <<
+		getNumBatches() << " batches";
+
+	const bool updateF = (options & Math::ODEEQUATIONUPDATE_F) != 0;
+	const bool updateM = (options & Math::ODEEQUATIONUPDATE_M) != 0;
+	const bool updateK = updateF || (options & Math::ODEEQUATIONUPDATE_K) != 0;
+	if (!updateM && !updateK)
+	{
+		return;
+	}
+
+	const size_t firstElement = batchId * BatchSize;
+	const Eigen::Index batch = static_cast<Eigen::Index>(batchId);
+
+	// Gather the current positions, x[3 * node + axis]
+	std::array<Lanes, 12> x;
+	const Math::Vector& positions = state.getPositions();
+	for (size_t lane = 0; lane < BatchSize; ++lane)
+	{
+		for (size_t node = 0; node < 4; ++node)
+		{
+			const Eigen::Index dof = static_cast<Eigen::Index>(3 * m_nodeIds[firstElement + lane][node]);
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				x[3 * node + axis][lane] = positions[dof + axis];
+			}
+		}
+	}
+
+	// 1) Extract the rotation R from the deformation gradient B = sum(x_node.n_node^t), n_node being the first 3
+	// entries of the row node of V^-1 (see Fem3DElementCorotationalTetrahedron)
+	Lanes33 B;
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			B[3 * i + j].setZero();
+			for (int node = 0; node < 4; ++node)
+			{
+				B[3 * i + j] += x[3 * node + i] * m_restShapeInverse.col(12 * batch + 3 * node + j);
+			}
+		}
+	}
+	Lanes33 R;
+	LaneFlags valid = computeRotation(B, &R);
+
+	std::array<Lanes, 144> K;
+	std::array<Lanes, 12> f;
+	if (updateK)
+	{
+		// 2) The rotated linear stiffness matrix R.Ke.R^t, by 3x3 blocks, keeping RK = R.Ke
+		std::array<Lanes, 144> RK;
+		for (int blockRow = 0; blockRow < 4; ++blockRow)
+		{
+			for (int i = 0; i < 3; ++i)
+			{
+				for (int col = 0; col < 12; ++col)
+				{
+					Lanes& value = RK[12 * (3 * blockRow + i) + col];
+					value = R[3 * i] * m_linearStiffness.col(144 * batch + 12 * (3 * blockRow) + col);
+					value += R[3 * i + 1] * m_linearStiffness.col(144 * batch + 12 * (3 * blockRow + 1) + col);
+					value += R[3 * i + 2] * m_linearStiffness.col(144 * batch + 12 * (3 * blockRow + 2) + col);
+				}
+			}
+		}
+		for (int row = 0; row < 12; ++row)
+		{
+			for (int blockCol = 0; blockCol < 4; ++blockCol)
+			{
+				for (int j = 0; j < 3; ++j)
+				{
+					const int col = 3 * blockCol;
+					K[12 * row + col + j] = RK[12 * row + col] * R[3 * j] + RK[12 * row + col + 1] * R[3 * j + 1] +
+											RK[12 * row + col + 2] * R[3 * j + 2];
+				}
+			}
+		}
+
+		// 3) The derivative of the rotation, from G = (tr(S).I - S).R^t with S = R^t.B
+		Lanes33 S;
+		for (int i = 0; i < 3; ++i)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				S[3 * i + j] = R[i] * B[j] + R[3 + i] * B[3 + j] + R[6 + i] * B[6 + j];
+			}
+		}
+		const Lanes trace = S[0] + S[4] + S[8];
+		Lanes33 G;
+		for (int i = 0; i < 3; ++i)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				G[3 * i + j] = trace * R[3 * j + i] - (S[3 * i] * R[3 * j] + S[3 * i + 1] * R[3 * j + 1] +
+													   S[3 * i + 2] * R[3 * j + 2]);
+			}
+		}
+		const Lanes detG = determinant(G);
+		valid = valid && (detG.abs() > singularThreshold);
+		const Lanes inverseDetG = valid.select(1.0 / detG, Lanes::Zero());
+		Lanes33 cofG;
+		cofactor(G, &cofG);
+
+		// dR/dFij = [wij].R with G.wij = 2.skew(R^t.ei.ej^t), then dR/dx = dR/dF.dF/dx
+		std::array<Lanes33, 12> dRdX;
+		for (int i = 0; i < 3; ++i)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				// 2.skew(M) with M(a, b) = R(i, a).delta(b, j)
+				std::array<Lanes, 3> v;
+				v[0] = ((j == 1) ? R[3 * i + 2] : Lanes::Zero()) - ((j == 2) ? R[3 * i + 1] : Lanes::Zero());
+				v[1] = ((j == 2) ? R[3 * i] : Lanes::Zero()) - ((j == 0) ? R[3 * i + 2] : Lanes::Zero());
+				v[2] = ((j == 0) ? R[3 * i + 1] : Lanes::Zero()) - ((j == 1) ? R[3 * i] : Lanes::Zero());
+
+				// w = G^-1.v, with G^-1 = cof(G)^t / det(G)
+				std::array<Lanes, 3> w;
+				for (int a = 0; a < 3; ++a)
+				{
+					w[a] = (cofG[a] * v[0] + cofG[3 + a] * v[1] + cofG[6 + a] * v[2]) * inverseDetG;
+				}
+
+				// dR/dFij = [w].R
+				Lanes33 dRdF;
+				for (int col = 0; col < 3; ++col)
+				{
+					dRdF[col] = w[1] * R[6 + col] - w[2] * R[3 + col];
+					dRdF[3 + col] = w[2] * R[col] - w[0] * R[6 + col];
+					dRdF[6 + col] = w[0] * R[3 + col] - w[1] * R[col];
+				}
+
+				// dR/dx[3 * node + axis](i, j) = dR/dFij.row(axis).dot(n_node)
+				for (int node = 0; node < 4; ++node)
+				{
+					const Eigen::Index column = 12 * batch + 3 * node;
+					for (int axis = 0; axis < 3; ++axis)
+					{
+						dRdX[3 * node + axis][3 * i + j] = dRdF[3 * axis] * m_restShapeInverse.col(column) +
+							dRdF[3 * axis + 1] * m_restShapeInverse.col(column + 1) +
+							dRdF[3 * axis + 2] * m_restShapeInverse.col(column + 2);
+					}
+				}
+			}
+		}
+
+		// 4) K += [dR/dxl.Ke.(R^t.x - x0)]_l + [R.Ke.(dR/dxl)^T.x]_l, the first term using the rotated stiffness
+		// matrix as the element does
+		std::array<Lanes, 12> u, KTimesRx_x0;
+		for (int node = 0; node < 4; ++node)
+		{
+			for (int i = 0; i < 3; ++i)
+			{
+				u[3 * node + i] = R[i] * x[3 * node] + R[3 + i] * x[3 * node + 1] + R[6 + i] * x[3 * node + 2] -
+								  m_restPositions.col(12 * batch + 3 * node + i);
+			}
+		}
+		for (int row = 0; row < 12; ++row)
+		{
+			KTimesRx_x0[row].setZero();
+			for (int col = 0; col < 12; ++col)
+			{
+				KTimesRx_x0[row] += K[12 * row + col] * u[col];
+			}
+		}
+
+		std::array<Lanes, 12> y, column;
+		for (int dof = 0; dof < 12; ++dof)
+		{
+			const Lanes33& dRdx = dRdX[dof];
+			for (int node = 0; node < 4; ++node)
+			{
+				for (int i = 0; i < 3; ++i)
+				{
+					column[3 * node + i] = dRdx[3 * i] * KTimesRx_x0[3 * node] +
+										   dRdx[3 * i + 1] * KTimesRx_x0[3 * node + 1] +
+										   dRdx[3 * i + 2] * KTimesRx_x0[3 * node + 2];
+					y[3 * node + i] = dRdx[i] * x[3 * node] + dRdx[3 + i] * x[3 * node + 1] +
+									  dRdx[6 + i] * x[3 * node + 2];
+				}
+			}
+			for (int row = 0; row < 12; ++row)
+			{
+				Lanes value = column[row];
+				for (int col = 0; col < 12; ++col)
+				{
+					value += RK[12 * row + col] * y[col];
+				}
+				K[12 * row + dof] += value;
+			}
+		}
+
+		// 5) The force f = -K.(x - R.x0)
+		if (updateF)
+		{
+			std::array<Lanes, 12> displacement;
+			for (int node = 0; node < 4; ++node)
+			{
+				for (int i = 0; i < 3; ++i)
+				{
+					displacement[3 * node + i] = x[3 * node + i] -
+						(R[3 * i] * m_restPositions.col(12 * batch + 3 * node) +
+						 R[3 * i + 1] * m_restPositions.col(12 * batch + 3 * node + 1) +
+						 R[3 * i + 2] * m_restPositions.col(12 * batch + 3 * node + 2));
+				}
+			}
+			for (int row = 0; row < 12; ++row)
+			{
+				f[row].setZero();
+				for (int col = 0; col < 12; ++col)
+				{
+					f[row] -= K[12 * row + col] * displacement[col];
+				}
+			}
+		}
+	}
+
+	// Store the results in the elements, the invalid lanes being updated by the elements themselves
+	const size_t numLanes = std::min(BatchSize, m_numElements - firstElement);
+	for (size_t lane = 0; lane < numLanes; ++lane)
+	{
+		Fem3DElementCorotationalTetrahedron& element = *m_elements[firstElement + lane];
+		if (!valid[lane])
+		{
+			element.updateFMDK(state, options);
+			continue;
+		}
+
+		Math::Matrix33d rotation;
+		for (int i = 0; i < 9; ++i)
+		{
+			rotation(i / 3, i % 3) = R[i][lane];
+		}
+
+		if (updateF)
+		{
+			element.m_R = rotation;
+			for (int row = 0; row < 12; ++row)
+			{
+				element.m_f[row] = f[row][lane];
+			}
+		}
+
+		if (updateM)
+		{
+			// M = R.Me.R^t
+			Eigen::Matrix<double, 12, 12> R12x12 = Eigen::Matrix<double, 12, 12>::Zero();
+			for (Eigen::Index node = 0; node < 4; ++node)
+			{
+				R12x12.block<3, 3>(3 * node, 3 * node) = rotation;
+			}
+			Eigen::Matrix<double, 12, 12> RM = R12x12 * element.m_MLinear;
+			element.m_M = RM * R12x12.transpose();
+		}
+
+		if (updateK)
+		{
+			for (int row = 0; row < 12; ++row)
+			{
+				for (int col = 0; col < 12; ++col)
+				{
+					element.m_K(row, col) = K[12 * row + col][lane];
+				}
+			}
+		}
+	}
+}
+
+}; // namespace Physics
+
+}; // namespace SurgSim
@@ -0,0 +1,112 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SURGSIM_PHYSICS_FEM3DELEMENTCOROTATIONALTETRAHEDRONBATCH_H
+#define SURGSIM_PHYSICS_FEM3DELEMENTCOROTATIONALTETRAHEDRONBATCH_H
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace SurgSim
+{
+
+namespace Math
+{
+class OdeState;
+}
+
+namespace Physics
+{
+
+class Fem3DElementCorotationalTetrahedron;
+
+/// Data oriented update of a set of Fem3DElementCorotationalTetrahedron.
+/// The constant data of the elements (node ids, rest shape inverse, rest positions and linear stiffness) is stored
+/// structure of arrays, by batches of BatchSize elements. The rotation extraction, the force and the stiffness
+/// matrix are computed for all the elements of a batch at once, each element being a lane of fixed size Eigen arrays
+/// so the computation is vectorized by Eigen. A batch fills one AVX register (4 lanes) or one AVX-512 register
+/// (8 lanes) when the build targets these instruction sets (see the SURGSIM_SIMD CMake option), without them the
+/// lanes are processed by pairs. The representations use the batches by default in the first case only, see
+/// Fem3DRepresentation::setElementBatching().
+/// The results are stored in the elements, which are then assembled as usual. Updating the elements through a
+/// batch is equivalent to calling FemElement::updateFMDK() on each of them.
+/// \note The rotation is extracted with a scaled Newton iteration of the polar decomposition instead of an SVD.
+/// An inverted or degenerated element (or one whose iteration does not converge) is updated by the element itself.
+class Fem3DElementCorotationalTetrahedronBatch
+{
+public:
+	/// Number of elements processed at once, the number of doubles in a vector register
+#if defined(__AVX512F__)
+	static const size_t BatchSize = 8;
+#else
+	static const size_t BatchSize = 4;
+#endif
+
+	/// Constructor
+	/// \param elements The elements to update, they need to be initialized
+	/// \exception SurgSim::Framework::AssertionFailure If an element is nullptr
+	explicit Fem3DElementCorotationalTetrahedronBatch(
+		const std::vector<std::shared_ptr<Fem3DElementCorotationalTetrahedron>>& elements);
+
+	/// \return The number of elements
+	size_t getNumElements() const;
+
+	/// \return The number of batches, the last one being padded if the number of elements is not a multiple of
+	/// BatchSize
+	size_t getNumBatches() const;
+
+	/// Update the elements of a batch based on the given state, equivalent to FemElement::updateFMDK()
+	/// \param batchId The batch to update
+	/// \param state \f$(x, v)\f$ the current position and velocity to evaluate the various terms with
+	/// \param options Flag to specify which of the F, M, D, K needs to be updated
+	/// \note Different batches do not share any data, so they can be updated concurrently
+	void updateFMDK(size_t batchId, const Math::OdeState& state, int options);
+
+	/// Update all the elements based on the given state, equivalent to FemElement::updateFMDK()
+	/// \param state \f$(x, v)\f$ the current position and velocity to evaluate the various terms with
+	/// \param options Flag to specify which of the F, M, D, K needs to be updated
+	void updateFMDK(const Math::OdeState& state, int options);
+
+private:
+	/// Structure of arrays, one row per lane, each batch using a set of consecutive columns
+	typedef Eigen::Array<double, BatchSize, Eigen::Dynamic> LaneArray;
+
+	/// The elements, padded with the last element to fill the last batch
+	std::vector<std::shared_ptr<Fem3DElementCorotationalTetrahedron>> m_elements;
+
+	/// The number of elements (without the padding)
+	size_t m_numElements;
+
+	/// The node ids of the elements, padded as m_elements
+	std::vector<std::array<size_t, 4>> m_nodeIds;
+
+	/// The first 3 columns of the inverse of the undeformed tetrahedron homogeneous points, 12 values per batch
+	LaneArray m_restShapeInverse;
+
+	/// The rest positions of the nodes, 12 values per batch
+	LaneArray m_restPositions;
+
+	/// The linear stiffness matrices (row major), 144 values per batch
+	LaneArray m_linearStiffness;
+};
+
+} // namespace Physics
+
+} // namespace SurgSim
+
+#endif // SURGSIM_PHYSICS_FEM3DELEMENTCOROTATIONALTETRAHEDRONBATCH_H
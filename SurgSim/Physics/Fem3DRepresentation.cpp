@@ -13,14 +13,19 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <typeinfo>
+
 #include "SurgSim/DataStructures/IndexedLocalCoordinate.h"
 #include "SurgSim/DataStructures/Location.h"
 #include "SurgSim/Framework/Assert.h"
 #include "SurgSim/Framework/Asset.h"
+#include "SurgSim/Framework/ThreadPool.h"
 #include "SurgSim/Math/MeshShape.h"
 #include "SurgSim/Math/OdeState.h"
 #include "SurgSim/Math/SparseMatrix.h"
 #include "SurgSim/Physics/DeformableCollisionRepresentation.h"
+#include "SurgSim/Physics/Fem3DElementCorotationalTetrahedron.h"
+#include "SurgSim/Physics/Fem3DElementCorotationalTetrahedronBatch.h"
 #include "SurgSim/Physics/Fem3DElementCube.h"
 #include "SurgSim/Physics/Fem3DElementTetrahedron.h"
 #include "SurgSim/Physics/Fem3DLocalization.h"
@@ -30,6 +35,17 @@
 
 namespace
 {
+/// Number of Fem3DElementCorotationalTetrahedronBatch batches updated by a task of the parallel update
+const size_t updateBatchGrainSize = 4;
+
+/// The corotational tetrahedra are updated by batches by default when the build targets AVX or AVX-512 (see the
+/// SURGSIM_SIMD CMake option), where a batch fills a vector register
+#if defined(__AVX2__) || defined(__AVX512F__)
+const bool defaultElementBatching = true;
+#else
+const bool defaultElementBatching = false;
+#endif
+
 void transformVectorByBlockOf3(const SurgSim::Math::RigidTransform3d& transform, SurgSim::Math::Vector* x,
 							   bool rotationOnly = false)
 {
@@ -54,11 +70,14 @@ namespace Physics
 SURGSIM_REGISTER(SurgSim::Framework::Component, SurgSim::Physics::Fem3DRepresentation, Fem3DRepresentation);
 
 Fem3DRepresentation::Fem3DRepresentation(const std::string& name) :
-	FemRepresentation(name)
+	FemRepresentation(name),
+	m_useElementBatching(defaultElementBatching)
 {
 	SURGSIM_ADD_SERIALIZABLE_PROPERTY(Fem3DRepresentation, std::shared_ptr<SurgSim::Framework::Asset>, Fem, getFem,
 									  setFem);
 	SURGSIM_ADD_SETTER(Fem3DRepresentation, std::string, FemFileName, loadFem)
+	SURGSIM_ADD_SERIALIZABLE_PROPERTY(Fem3DRepresentation, bool, ElementBatching,
+									  getElementBatching, setElementBatching);
 	// Reminder: m_numDofPerNode is held by DeformableRepresentation
 	// but needs to be set by all concrete derived classes
 	m_numDofPerNode = 3;
@@ -283,7 +302,78 @@ bool Fem3DRepresentation::doInitialize()
 		m_femElements.push_back(femElement);
 	}
 
-	return FemRepresentation::doInitialize();
+	if (!FemRepresentation::doInitialize())
+	{
+		return false;
+	}
+
+	// Gather the corotational tetrahedra (and not any derived type) in batches, they need to be initialized
+	m_corotationalBatch = nullptr;
+	m_unbatchedElementIds.clear();
+	std::vector<std::shared_ptr<Fem3DElementCorotationalTetrahedron>> corotationalElements;
+	for (size_t elementId = 0; elementId < m_femElements.size(); ++elementId)
+	{
+		const auto& element = m_femElements[elementId];
+		if (m_useElementBatching && typeid(*element) == typeid(Fem3DElementCorotationalTetrahedron))
+		{
+			corotationalElements.push_back(std::static_pointer_cast<Fem3DElementCorotationalTetrahedron>(element));
+		}
+		else
+		{
+			m_unbatchedElementIds.push_back(elementId);
+		}
+	}
+	if (!corotationalElements.empty())
+	{
+		m_corotationalBatch = std::make_shared<Fem3DElementCorotationalTetrahedronBatch>(corotationalElements);
+	}
+
+	return true;
+}
+
+void Fem3DRepresentation::updateFemElements(const SurgSim::Math::OdeState& state, int options)
+{
+	if (m_corotationalBatch == nullptr)
+	{
+		FemRepresentation::updateFemElements(state, options);
+		return;
+	}
+
+	// Each batch and each element only updates its own data, so they can all be updated concurrently
+	if (getParallelAssembly())
+	{
+		auto threadPool = getAssemblyThreadPoolOrDefault();
+		threadPool->parallelFor(0, m_corotationalBatch->getNumBatches(), updateBatchGrainSize,
+			[this, &state, options](size_t batchId)
+		{
+			m_corotationalBatch->updateFMDK(batchId, state, options);
+		});
+		threadPool->parallelFor(0, m_unbatchedElementIds.size(), UpdateGrainSize,
+			[this, &state, options](size_t i)
+		{
+			m_femElements[m_unbatchedElementIds[i]]->updateFMDK(state, options);
+		});
+	}
+	else
+	{
+		m_corotationalBatch->updateFMDK(state, options);
+		for (auto elementId : m_unbatchedElementIds)
+		{
+			m_femElements[elementId]->updateFMDK(state, options);
+		}
+	}
+}
+
+void Fem3DRepresentation::setElementBatching(bool useElementBatching)
+{
+	SURGSIM_ASSERT(!isInitialized()) << "Element batching cannot be modified once the component is initialized";
+
+	m_useElementBatching = useElementBatching;
+}
+
+bool Fem3DRepresentation::getElementBatching() const
+{
+	return m_useElementBatching;
 }
 
 std::shared_ptr<Localization> Fem3DRepresentation::createNodeLocalization(size_t nodeId)
@@ -317,6 +407,15 @@ std::shared_ptr<Localization> Fem3DRepresentation::createNodeLocalization(size_t
 
 std::shared_ptr<Localization> Fem3DRepresentation::createTriangleLocalization(
 		const DataStructures::IndexedLocalCoordinate& location)
+{
+	// Fem3DLocalization will verify the coordinate (2nd parameter) based on
+	// the Fem3DRepresentation passed as 1st parameter.
+	return std::make_shared<Fem3DLocalization>(
+				std::static_pointer_cast<Physics::Representation>(getSharedPtr()), computeTriangleCoordinate(location));
+}
+
+DataStructures::IndexedLocalCoordinate Fem3DRepresentation::computeTriangleCoordinate(
+		const DataStructures::IndexedLocalCoordinate& location)
 {
 	DataStructures::IndexedLocalCoordinate coordinate;
 	size_t triangleId = location.index;
@@ -366,10 +465,7 @@ std::shared_ptr<Localization> Fem3DRepresentation::createTriangleLocalization(
 		coordinate.coordinate[i] = barycentricCoordinate[indices[i]];
 	}
 
-	// Fem3DLocalization will verify the coordinate (2nd parameter) based on
-	// the Fem3DRepresentation passed as 1st parameter.
-	return std::make_shared<Fem3DLocalization>(
-				std::static_pointer_cast<Physics::Representation>(getSharedPtr()), coordinate);
+	return coordinate;
 }
 
 std::shared_ptr<Localization> Fem3DRepresentation::createElementLocalization(
@@ -399,6 +495,27 @@ std::shared_ptr<Localization> Fem3DRepresentation::createLocalization(const Data
 	return nullptr;
 }
 
+bool Fem3DRepresentation::updateLocalization(const DataStructures::Location& location, Localization* localization)
+{
+	auto femLocalization = dynamic_cast<Fem3DLocalization*>(localization);
+	if (femLocalization == nullptr || location.index.hasValue())
+	{
+		return false;
+	}
+
+	if (location.triangleMeshLocalCoordinate.hasValue())
+	{
+		femLocalization->setLocalPosition(computeTriangleCoordinate(*location.triangleMeshLocalCoordinate));
+		return true;
+	}
+	else if (location.elementMeshLocalCoordinate.hasValue())
+	{
+		femLocalization->setLocalPosition(*location.elementMeshLocalCoordinate);
+		return true;
+	}
+	return false;
+}
+
 void Fem3DRepresentation::transformState(std::shared_ptr<Math::OdeState> state,
 										 const Math::RigidTransform3d& transform)
 {
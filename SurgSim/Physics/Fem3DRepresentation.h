@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "SurgSim/Framework/FrameworkConvert.h"
 #include "SurgSim/Math/Matrix.h"
@@ -46,6 +47,7 @@ class OdeState;
 
 namespace Physics
 {
+class Fem3DElementCorotationalTetrahedronBatch;
 class Localization;
 
 SURGSIM_STATIC_REGISTRATION(Fem3DRepresentation);
@@ -80,6 +82,22 @@ class Fem3DRepresentation : public FemRepresentation
 
 	std::shared_ptr<Localization> createLocalization(const SurgSim::DataStructures::Location& location) override;
 
+	/// \note Only the triangle and element-based locations are updated, a new localization is needed for the
+	/// node-based ones
+	bool updateLocalization(const SurgSim::DataStructures::Location& location, Localization* localization) override;
+
+	/// Set whether the corotational tetrahedra are updated by batches
+	/// \param useElementBatching True to update the Fem3DElementCorotationalTetrahedron elements through a
+	/// Fem3DElementCorotationalTetrahedronBatch, False to update each element on its own
+	/// \exception SurgSim::Framework::AssertionFailure If the call is done after initialization
+	/// \note The batches give the same result as the elements, the other element types are always updated on their own
+	/// \note The batches are meant for builds targeting AVX or AVX-512, see Fem3DElementCorotationalTetrahedronBatch
+	void setElementBatching(bool useElementBatching);
+
+	/// Get the element batching flag (default = true when the build targets AVX or AVX-512, false otherwise)
+	/// \return True if the corotational tetrahedra are updated by batches, False otherwise
+	bool getElementBatching() const;
+
 protected:
 	bool doWakeUp() override;
 
@@ -88,6 +106,8 @@ class Fem3DRepresentation : public FemRepresentation
 
 	bool doInitialize() override;
 
+	void updateFemElements(const SurgSim::Math::OdeState& state, int options) override;
+
 private:
 	/// Produces a mapping from the provided mesh's triangle ids to this object's fem element ids. The mesh's vertices
 	/// must be identical to this object's fem element nodes.
@@ -107,6 +127,12 @@ class Fem3DRepresentation : public FemRepresentation
 	std::shared_ptr<Localization> createTriangleLocalization(
 		const SurgSim::DataStructures::IndexedLocalCoordinate& location);
 
+	/// Helper method: compute the element-based IndexedLocalCoordinate of a triangle-based IndexedLocalCoordinate
+	/// \param location The IndexedLocalCoordinate defining a point on the triangle mesh
+	/// \return The IndexedLocalCoordinate of the point in the element containing the triangle
+	SurgSim::DataStructures::IndexedLocalCoordinate computeTriangleCoordinate(
+		const SurgSim::DataStructures::IndexedLocalCoordinate& location);
+
 	/// Helper method: create a localization for an element-based IndexedLocalCoordinate (tetrahedron or cube)
 	/// \param location The IndexedLocalCoordinate defining a point on the element mesh
 	/// \return Localization of the point for this representation
@@ -118,6 +144,14 @@ class Fem3DRepresentation : public FemRepresentation
 
 	/// The Fem3DRepresentation's asset as a Fem3D
 	std::shared_ptr<Fem3D> m_fem;
+
+	bool m_useElementBatching; ///< Are the corotational tetrahedra updated by batches or not ?
+
+	/// The batched corotational tetrahedra, nullptr if the element batching is not used
+	std::shared_ptr<Fem3DElementCorotationalTetrahedronBatch> m_corotationalBatch;
+
+	/// The ids of the FemElements not updated through m_corotationalBatch
+	std::vector<size_t> m_unbatchedElementIds;
 };
 
 } // namespace Physics
@@ -104,7 +104,7 @@ void FemConstraintFixedPoint::doBuild(double dt,
 				m_newH.insert(numDofPerNode * nodeIndex + axis) = coord.coordinate[index] * (dt * scale);
 			}
 		}
-		mlcp->updateConstraint(m_newH, fem->getComplianceMatrix() * m_newH.transpose(),
+		mlcp->updateConstraint(m_newH, fem->computeCHt(m_newH),
 			indexOfRepresentation, indexOfConstraint + axis);
 	}
 }
@@ -113,7 +113,7 @@ void FemConstraintFixedRotationVector::doBuild(double dt,
 				m_newH.insert(numDofPerNode * nodeIndex + axis + 3) = coord.coordinate[index] * (dt * scale);
 			}
 		}
-		mlcp->updateConstraint(m_newH, fem->getComplianceMatrix() * m_newH.transpose(),
+		mlcp->updateConstraint(m_newH, fem->computeCHt(m_newH),
 			indexOfRepresentation, indexOfConstraint + axis);
 	}
 }
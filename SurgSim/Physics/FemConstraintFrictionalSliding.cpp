@@ -85,7 +85,7 @@ void FemConstraintFrictionalSliding::doBuild(double dt,
 			m_newH.insert(numDofPerNode * nodeId + 2) = coord.coordinate[j] * directions[i][2] * scale * dt;
 		}
 
-		mlcp->updateConstraint(m_newH, fem->getComplianceMatrix() * m_newH.transpose(), indexOfRepresentation,
+		mlcp->updateConstraint(m_newH, fem->computeCHt(m_newH), indexOfRepresentation,
 			indexOfConstraint + i);
 	}
 
@@ -105,7 +105,7 @@ void FemConstraintFrictionlessContact::doBuild(double dt,
 		}
 	}
 
-	mlcp->updateConstraint(m_newH, fem->getComplianceMatrix() * m_newH.transpose(), indexOfRepresentation,
+	mlcp->updateConstraint(m_newH, fem->computeCHt(m_newH), indexOfRepresentation,
 						   indexOfConstraint);
 }
 
@@ -13,6 +13,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <array>
+
 #include "SurgSim/Framework/Assert.h"
 #include "SurgSim/Math/Geometry.h"
 #include "SurgSim/Math/OdeState.h"
@@ -142,6 +145,73 @@ void FemElement::addFMDK(SurgSim::Math::Vector* F,
 	addStiffness(K);
 }
 
+void FemElement::computeScatterMap(const SurgSim::Math::SparseMatrix& matrix,
+								   std::vector<SurgSim::Math::SparseMatrix::Index>* scatterMap) const
+{
+	typedef SurgSim::Math::SparseMatrix::Index Index;
+
+	SURGSIM_ASSERT(matrix.isCompressed()) << "Invalid matrix. Matrix must be in compressed form.";
+
+	const Index numDofPerNode = static_cast<Index>(m_numDofPerNode);
+	const auto* outerIndices = matrix.outerIndexPtr();
+	const auto* innerIndices = matrix.innerIndexPtr();
+
+	scatterMap->clear();
+	scatterMap->reserve(m_nodeIds.size() * m_nodeIds.size() * m_numDofPerNode);
+	for (auto columnNodeId : m_nodeIds)
+	{
+		for (Index column = numDofPerNode * static_cast<Index>(columnNodeId);
+			 column < numDofPerNode * static_cast<Index>(columnNodeId + 1); ++column)
+		{
+			const auto* columnBegin = innerIndices + outerIndices[column];
+			const auto* columnEnd = innerIndices + outerIndices[column + 1];
+			for (auto rowNodeId : m_nodeIds)
+			{
+				// The rows of a node block are consecutive in the column, the block being fully part of the pattern
+				const Index row = numDofPerNode * static_cast<Index>(rowNodeId);
+				const auto* found = std::lower_bound(columnBegin, columnEnd, row);
+				SURGSIM_ASSERT(found + numDofPerNode <= columnEnd && *found == row &&
+							   *(found + numDofPerNode - 1) == row + numDofPerNode - 1) <<
+						"The matrix pattern does not contain the block (" << rowNodeId << ", " << columnNodeId << ")";
+				scatterMap->push_back(static_cast<Index>(found - innerIndices));
+			}
+		}
+	}
+}
+
+void FemElement::addMass(const std::vector<SurgSim::Math::SparseMatrix::Index>& scatterMap,
+						 SurgSim::Math::SparseMatrix* M, double scale) const
+{
+	scatterMatrix(m_M, scatterMap, scale, M);
+}
+
+void FemElement::addDamping(const std::vector<SurgSim::Math::SparseMatrix::Index>& scatterMap,
+							SurgSim::Math::SparseMatrix* D, double scale) const
+{
+	if (m_useDamping)
+	{
+		scatterMatrix(m_D, scatterMap, scale, D);
+	}
+}
+
+void FemElement::addStiffness(const std::vector<SurgSim::Math::SparseMatrix::Index>& scatterMap,
+							  SurgSim::Math::SparseMatrix* K, double scale) const
+{
+	scatterMatrix(m_K, scatterMap, scale, K);
+}
+
+void FemElement::addFMDK(const std::vector<SurgSim::Math::SparseMatrix::Index>& scatterMap,
+						 SurgSim::Math::Vector* F,
+						 SurgSim::Math::SparseMatrix* M,
+						 SurgSim::Math::SparseMatrix* D,
+						 SurgSim::Math::SparseMatrix* K) const
+{
+	addForce(F);
+	addMass(scatterMap, M);
+	addDamping(scatterMap, D);
+	addStiffness(scatterMap, K);
+}
+
 void FemElement::addMatVec(double alphaM, double alphaD, double alphaK, const SurgSim::Math::Vector& x,
 						   SurgSim::Math::Vector* F,
 						   SurgSim::Math::Vector* extractedX, SurgSim::Math::Vector* accumulator) const
@@ -186,6 +256,76 @@ void FemElement::addMatVec(double alphaM, double alphaD, double alphaK, const Su
 	addSubVector(*accumulator, m_nodeIds, m_numDofPerNode, F);
 }
 
+void FemElement::addMatDiagonalBlocks(double alphaM, double alphaD, double alphaK,
+									  SurgSim::Math::Matrix* blocks) const
+{
+	SURGSIM_ASSERT(static_cast<size_t>(blocks->cols()) == m_numDofPerNode) << "The diagonal blocks are of size " <<
+		blocks->cols() << ", the nodes have " << m_numDofPerNode << " dof";
+
+	const SurgSim::Math::Matrix::Index size = static_cast<SurgSim::Math::Matrix::Index>(m_numDofPerNode);
+	for (size_t node = 0; node < m_nodeIds.size(); ++node)
+	{
+		const SurgSim::Math::Matrix::Index local = static_cast<SurgSim::Math::Matrix::Index>(node) * size;
+		auto block = blocks->middleRows(static_cast<SurgSim::Math::Matrix::Index>(m_nodeIds[node]) * size, size);
+		if (alphaM != 0.0)
+		{
+			block += alphaM * m_M.block(local, local, size, size);
+		}
+		if (m_useDamping && alphaD != 0.0)
+		{
+			block += alphaD * m_D.block(local, local, size, size);
+		}
+		if (alphaK != 0.0)
+		{
+			block += alphaK * m_K.block(local, local, size, size);
+		}
+	}
+}
+
+void FemElement::addLumpedMass(SurgSim::Math::Vector* lumpedMass) const
+{
+	SURGSIM_ASSERT(m_numDofPerNode >= 3) << "The lumped mass needs 3 translational dof per node, the nodes have " <<
+		m_numDofPerNode << " dof";
+
+	// The element mass in a given direction is the sum of the mass matrix terms linking the translational dof of
+	// this direction (i.e. the kinetic energy of a unit rigid translation)
+	typedef SurgSim::Math::Matrix::Index Index;
+	const size_t numNodes = m_nodeIds.size();
+	std::array<double, 3> mass = {{0.0, 0.0, 0.0}};
+	std::array<double, 3> diagonal = {{0.0, 0.0, 0.0}};
+	for (size_t direction = 0; direction < 3; ++direction)
+	{
+		for (size_t nodeI = 0; nodeI < numNodes; ++nodeI)
+		{
+			const Index i = static_cast<Index>(nodeI * m_numDofPerNode + direction);
+			diagonal[direction] += m_M(i, i);
+			for (size_t nodeJ = 0; nodeJ < numNodes; ++nodeJ)
+			{
+				mass[direction] += m_M(i, static_cast<Index>(nodeJ * m_numDofPerNode + direction));
+			}
+		}
+	}
+
+	const double translationalDiagonal = diagonal[0] + diagonal[1] + diagonal[2];
+	if (translationalDiagonal <= 0.0)
+	{
+		return;
+	}
+
+	// Each translational direction is scaled to its own mass, the other dof by the average scaling
+	const double averageScale = (mass[0] + mass[1] + mass[2]) / translationalDiagonal;
+	for (size_t node = 0; node < numNodes; ++node)
+	{
+		const Index systemDof = static_cast<Index>(m_nodeIds[node] * m_numDofPerNode);
+		const Index elementDof = static_cast<Index>(node * m_numDofPerNode);
+		for (Index dof = 0; dof < static_cast<Index>(m_numDofPerNode); ++dof)
+		{
+			const double scale = (dof < 3 && diagonal[dof] > 0.0) ? mass[dof] / diagonal[dof] : averageScale;
+			(*lumpedMass)[systemDof + dof] += scale * m_M(elementDof + dof, elementDof + dof);
+		}
+	}
+}
+
 bool FemElement::isValidCoordinate(const SurgSim::Math::Vector& naturalCoordinate) const
 {
 	return (std::abs(naturalCoordinate.sum() - 1.0) < SurgSim::Math::Geometry::ScalarEpsilon)
@@ -200,6 +340,34 @@ void FemElement::updateFMDK(const Math::OdeState& state, int options)
 	doUpdateFMDK(state, options);
 }
 
+void FemElement::scatterMatrix(const SurgSim::Math::Matrix& elementMatrix,
+							   const std::vector<SurgSim::Math::SparseMatrix::Index>& scatterMap,
+							   double scale, SurgSim::Math::SparseMatrix* matrix) const
+{
+	typedef SurgSim::Math::SparseMatrix::Index Index;
+
+	const Index numDofPerNode = static_cast<Index>(m_numDofPerNode);
+	const Index numNodes = static_cast<Index>(m_nodeIds.size());
+	SURGSIM_ASSERT(static_cast<Index>(scatterMap.size()) == numNodes * numNodes * numDofPerNode) <<
+			"The scatter map has not been computed for this element";
+
+	double* values = matrix->valuePtr();
+	const double* columnValues = elementMatrix.data();
+	auto blockStart = std::begin(scatterMap);
+	for (Index column = 0; column < elementMatrix.cols(); ++column)
+	{
+		for (Index blockRow = 0; blockRow < numNodes; ++blockRow, ++blockStart)
+		{
+			double* destination = values + *blockStart;
+			for (Index row = 0; row < numDofPerNode; ++row)
+			{
+				destination[row] += scale * columnValues[row];
+			}
+			columnValues += numDofPerNode;
+		}
+	}
+}
+
 void FemElement::initializeFMDK()
 {
 	if (!m_initializedFMDK)
@@ -154,6 +154,53 @@ class FemElement
 						 SurgSim::Math::SparseMatrix* D,
 						 SurgSim::Math::SparseMatrix* K) const;
 
+	/// Computes where the element matrices are added in a complete system matrix, to assemble them without searching
+	/// the sparse matrix structure.
+	/// \param matrix The compressed complete system matrix, its pattern must contain all the element blocks
+	/// \param[out] scatterMap For each element column and each node, the index in matrix.valuePtr() of the
+	/// getNumDofPerNode() consecutive values receiving the corresponding column of the node block
+	/// \note The scatter map stays valid as long as the pattern of the matrix does not change
+	void computeScatterMap(const SurgSim::Math::SparseMatrix& matrix,
+						   std::vector<SurgSim::Math::SparseMatrix::Index>* scatterMap) const;
+
+	/// Adds the element mass matrix M to a complete system mass matrix M (assembly), using a scatter map
+	/// \param scatterMap The scatter map computed by computeScatterMap() on a matrix with the pattern of M
+	/// \param[in,out] M The compressed complete system mass matrix to add the element mass matrix into
+	/// \param scale A factor to scale the added mass matrix with
+	/// \note Only the values of M are accessed, elements not sharing any node can be added concurrently
+	void addMass(const std::vector<SurgSim::Math::SparseMatrix::Index>& scatterMap,
+				 SurgSim::Math::SparseMatrix* M, double scale = 1.0) const;
+
+	/// Adds the element damping matrix D to a complete system damping matrix D (assembly), using a scatter map
+	/// \param scatterMap The scatter map computed by computeScatterMap() on a matrix with the pattern of D
+	/// \param[in,out] D The compressed complete system damping matrix to add the element damping matrix into
+	/// \param scale A factor to scale the added damping matrix with
+	/// \note Only the values of D are accessed, elements not sharing any node can be added concurrently
+	void addDamping(const std::vector<SurgSim::Math::SparseMatrix::Index>& scatterMap,
+					SurgSim::Math::SparseMatrix* D, double scale = 1.0) const;
+
+	/// Adds the element stiffness matrix K to a complete system stiffness matrix K (assembly), using a scatter map
+	/// \param scatterMap The scatter map computed by computeScatterMap() on a matrix with the pattern of K
+	/// \param[in,out] K The compressed complete system stiffness matrix to add the element stiffness matrix into
+	/// \param scale A factor to scale the added stiffness matrix with
+	/// \note Only the values of K are accessed, elements not sharing any node can be added concurrently
+	void addStiffness(const std::vector<SurgSim::Math::SparseMatrix::Index>& scatterMap,
+					  SurgSim::Math::SparseMatrix* K, double scale = 1.0) const;
+
+	/// Adds the element force vector, mass, stiffness and damping matrices into a complete system data structure
+	/// F, M, D, K (assembly), using a scatter map
+	/// \param scatterMap The scatter map computed by computeScatterMap() on a matrix with the pattern of M, D and K
+	/// \param[in,out] F The complete system force vector to add the element force into
+	/// \param[in,out] M The compressed complete system mass matrix to add the element mass matrix into
+	/// \param[in,out] D The compressed complete system damping matrix to add the element damping matrix into
+	/// \param[in,out] K The compressed complete system stiffness matrix to add the element stiffness matrix into
+	/// \note Elements not sharing any node can be added concurrently
+	void addFMDK(const std::vector<SurgSim::Math::SparseMatrix::Index>& scatterMap,
+				 SurgSim::Math::Vector* F,
+				 SurgSim::Math::SparseMatrix* M,
+				 SurgSim::Math::SparseMatrix* D,
+				 SurgSim::Math::SparseMatrix* K) const;
+
 	/// Adds the element matrix-vector contribution F += (alphaM.M + alphaD.D + alphaK.K).x (computed for a given state)
 	/// into a complete system data structure F (assembly)
 	/// \param alphaM The scaling factor for the mass contribution
@@ -169,6 +216,24 @@ class FemElement
 						   const SurgSim::Math::Vector& x, SurgSim::Math::Vector* F,
 						   SurgSim::Math::Vector* extractedX, SurgSim::Math::Vector* acumulator) const;
 
+	/// Adds the node diagonal blocks of the element matrix (alphaM.M + alphaD.D + alphaK.K) (computed for a given
+	/// state) into the diagonal blocks of a complete system matrix, i.e. to precondition a matrix free resolution
+	/// \param alphaM The scaling factor for the mass contribution
+	/// \param alphaD The scaling factor for the damping contribution
+	/// \param alphaK The scaling factor for the stiffness contribution
+	/// \param[in,out] blocks The complete system diagonal blocks, stacked vertically, of size getNumDofPerNode()
+	/// \note Elements not sharing any node can be added concurrently
+	void addMatDiagonalBlocks(double alphaM, double alphaD, double alphaK, SurgSim::Math::Matrix* blocks) const;
+
+	/// Adds the element lumped mass (computed for a given state) into a complete system lumped mass vector, using the
+	/// HRZ lumping (Hinton, Rock and Zienkiewicz): the diagonal of the element mass matrix is scaled so that the
+	/// translational lumped masses add up to the element mass in each direction.
+	/// \param[in,out] lumpedMass The complete system lumped mass vector, the diagonal of the lumped mass matrix
+	/// \note The first 3 dof of each node are expected to be the translational dof
+	/// \note Unlike the row-sum lumping, the HRZ lumping gives positive masses for the rotational dof and for the
+	/// higher order elements
+	void addLumpedMass(SurgSim::Math::Vector* lumpedMass) const;
+
 	/// Determines whether a given natural coordinate is valid
 	/// \param naturalCoordinate Coordinate to check
 	/// \return True if valid
@@ -224,6 +289,15 @@ class FemElement
 	/// \param options Flag to specify which of the F, M, D, K needs to be updated
 	virtual void doUpdateFMDK(const Math::OdeState& state, int options) = 0;
 
+	/// Adds an element matrix to the values of a complete system matrix, using a scatter map
+	/// \param elementMatrix The element matrix, of size (getNumDofPerNode() x getNumNodes()) squared
+	/// \param scatterMap The scatter map computed by computeScatterMap() on a matrix with the pattern of matrix
+	/// \param scale A factor to scale the added matrix with
+	/// \param[in,out] matrix The compressed complete system matrix to add the element matrix into
+	void scatterMatrix(const SurgSim::Math::Matrix& elementMatrix,
+					   const std::vector<SurgSim::Math::SparseMatrix::Index>& scatterMap,
+					   double scale, SurgSim::Math::SparseMatrix* matrix) const;
+
 	/// Initialize f, M, D, K variables.
 	void initializeFMDK();
 
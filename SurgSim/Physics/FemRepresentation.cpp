@@ -13,12 +13,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+
 #include "SurgSim/DataStructures/IndexedLocalCoordinate.h"
 #include "SurgSim/DataStructures/PlyReader.h"
 #include "SurgSim/Framework/Assert.h"
 #include "SurgSim/Framework/ApplicationData.h"
 #include "SurgSim/Framework/Log.h"
 #include "SurgSim/Framework/Runtime.h"
+#include "SurgSim/Framework/ThreadPool.h"
 #include "SurgSim/Math/Matrix.h"
 #include "SurgSim/Math/OdeState.h"
 #include "SurgSim/Math/SparseMatrix.h"
@@ -30,6 +33,49 @@ using SurgSim::Math::Matrix;
 using SurgSim::Math::OdeState;
 using SurgSim::Math::SparseMatrix;
 
+namespace
+{
+/// Checks if all the entries of a sparse matrix are part of the pattern of another sparse matrix
+/// \param matrix The matrix to look for the entries of
+/// \param pattern The compressed matrix to look into
+/// \return True if all the entries of matrix are in pattern, False otherwise
+bool isInPattern(const SparseMatrix& matrix, const SparseMatrix& pattern)
+{
+	for (SparseMatrix::Index col = 0; col < matrix.outerSize(); ++col)
+	{
+		const auto begin = pattern.innerIndexPtr() + pattern.outerIndexPtr()[col];
+		const auto end = pattern.innerIndexPtr() + pattern.outerIndexPtr()[col + 1];
+		for (SparseMatrix::InnerIterator it(matrix, col); it; ++it)
+		{
+			if (!std::binary_search(begin, end, it.index()))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/// Adds a sparse matrix to another sparse matrix whose pattern contains all its entries, in place
+/// \param matrix The matrix to add
+/// \param[in,out] result The compressed matrix to add matrix into, its pattern is not changed
+void addInPattern(const SparseMatrix& matrix, SparseMatrix* result)
+{
+	for (SparseMatrix::Index col = 0; col < matrix.outerSize(); ++col)
+	{
+		const auto begin = result->innerIndexPtr() + result->outerIndexPtr()[col];
+		const auto end = result->innerIndexPtr() + result->outerIndexPtr()[col + 1];
+		for (SparseMatrix::InnerIterator it(matrix, col); it; ++it)
+		{
+			const auto entry = std::lower_bound(begin, end, it.index());
+			SURGSIM_ASSERT(entry != end && *entry == it.index()) <<
+				"The entry (" << it.row() << ", " << it.col() << ") is not part of the matrix pattern";
+			result->valuePtr()[entry - result->innerIndexPtr()] += it.value();
+		}
+	}
+}
+}
+
 namespace SurgSim
 {
 
@@ -39,7 +85,9 @@ namespace Physics
 FemRepresentation::FemRepresentation(const std::string& name) :
 	DeformableRepresentation(name),
 	m_useComplianceWarping(false),
-	m_isInitialComplianceMatrixComputed(false)
+	m_isInitialComplianceMatrixComputed(false),
+	m_useParallelAssembly(true),
+	m_useMassLumping(false)
 {
 	m_rayleighDamping.massCoefficient = 0.0;
 	m_rayleighDamping.stiffnessCoefficient = 0.0;
@@ -47,6 +95,12 @@ FemRepresentation::FemRepresentation(const std::string& name) :
 	SURGSIM_ADD_SERIALIZABLE_PROPERTY(FemRepresentation, bool, ComplianceWarping,
 									  getComplianceWarping, setComplianceWarping);
 
+	SURGSIM_ADD_SERIALIZABLE_PROPERTY(FemRepresentation, bool, ParallelAssembly,
+									  getParallelAssembly, setParallelAssembly);
+
+	SURGSIM_ADD_SERIALIZABLE_PROPERTY(FemRepresentation, bool, MassLumping,
+									  getMassLumping, setMassLumping);
+
 	SURGSIM_ADD_SERIALIZABLE_PROPERTY(FemRepresentation, std::string, FemElementType,
 									  getFemElementType, setFemElementType);
 
@@ -121,6 +175,56 @@ bool FemRepresentation::doInitialize()
 	m_M.makeCompressed();
 	m_D = m_K = m_M;
 
+	// Lump the mass matrix, the FemElements mass matrices being computed on initialization
+	m_lumpedMass.resize(0);
+	if (m_useMassLumping)
+	{
+		m_lumpedMass.setZero(getNumDof());
+		for (const auto& femElement : m_femElements)
+		{
+			femElement->addLumpedMass(&m_lumpedMass);
+		}
+
+		// The lumped mass matrix is constant, it is assembled once with its own diagonal pattern
+		m_M.resize(static_cast<Index>(getNumDof()), static_cast<Index>(getNumDof()));
+		m_M.reserve(Eigen::Matrix<Index, Eigen::Dynamic, 1>::Constant(static_cast<Index>(getNumDof()), 1));
+		addLumpedMass(1.0, &m_M);
+		m_M.makeCompressed();
+	}
+
+	// Precompute where each FemElement is added in the global matrices, sharing the pattern of m_K
+	m_femElementScatterMaps.resize(m_femElements.size());
+	for (size_t elementId = 0; elementId < m_femElements.size(); ++elementId)
+	{
+		m_femElements[elementId]->computeScatterMap(m_K, &m_femElementScatterMaps[elementId]);
+	}
+
+	// Greedy coloring of the FemElements, such that the elements of a color do not share any node
+	m_femElementColors.clear();
+	std::vector<std::vector<size_t>> nodeColors(m_initialState->getNumNodes());
+	std::vector<bool> usedColors;
+	for (size_t elementId = 0; elementId < m_femElements.size(); ++elementId)
+	{
+		usedColors.assign(m_femElementColors.size(), false);
+		for (auto nodeId : m_femElements[elementId]->getNodeIds())
+		{
+			for (auto color : nodeColors[nodeId])
+			{
+				usedColors[color] = true;
+			}
+		}
+		size_t color = std::find(std::begin(usedColors), std::end(usedColors), false) - std::begin(usedColors);
+		if (color == m_femElementColors.size())
+		{
+			m_femElementColors.emplace_back();
+		}
+		m_femElementColors[color].push_back(elementId);
+		for (auto nodeId : m_femElements[elementId]->getNodeIds())
+		{
+			nodeColors[nodeId].push_back(color);
+		}
+	}
+
 	// If we are using compliance warping for this representation, let's pre-allocate the rotation matrix
 	// and pre-define its pattern, so we only access existing elements later on.
 	if (m_useComplianceWarping)
@@ -236,7 +340,13 @@ void FemRepresentation::update(double dt)
 	{
 		if (!isInitialComplianceMatrixComputed())
 		{
-			m_odeSolver->computeMatrices(dt, *m_initialState, true);
+			m_odeSolver->computeMatrices(dt, *m_initialState, !getMatrixFreeCompliance());
+			if (getMatrixFreeCompliance())
+			{
+				// The ode solver's linear solver is refactorized on every solve, keep the initial system on the side
+				m_initialLinearSolver = createLinearSolver();
+				m_initialLinearSolver->setMatrix(m_odeSolver->getSystemMatrix());
+			}
 			setIsInitialComplianceMatrixComputed(true);
 		}
 		m_odeSolver->solve(dt, *m_currentState, m_newState.get(), false);
@@ -246,7 +356,7 @@ void FemRepresentation::update(double dt)
 	}
 	else
 	{
-		m_odeSolver->solve(dt, *m_currentState, m_newState.get());
+		m_odeSolver->solve(dt, *m_currentState, m_newState.get(), !getMatrixFreeCompliance());
 	}
 
 	// Back up the current state into the previous state (by swapping)
@@ -277,6 +387,53 @@ bool FemRepresentation::getComplianceWarping() const
 	return m_useComplianceWarping;
 }
 
+void FemRepresentation::setParallelAssembly(bool useParallelAssembly)
+{
+	m_useParallelAssembly = useParallelAssembly;
+}
+
+bool FemRepresentation::getParallelAssembly() const
+{
+	return m_useParallelAssembly;
+}
+
+void FemRepresentation::setAssemblyThreadPool(std::shared_ptr<SurgSim::Framework::ThreadPool> threadPool)
+{
+	m_assemblyThreadPool = threadPool;
+}
+
+std::shared_ptr<SurgSim::Framework::ThreadPool> FemRepresentation::getAssemblyThreadPool() const
+{
+	return m_assemblyThreadPool;
+}
+
+std::shared_ptr<SurgSim::Framework::ThreadPool> FemRepresentation::getAssemblyThreadPoolOrDefault() const
+{
+	return (m_assemblyThreadPool != nullptr) ? m_assemblyThreadPool : Framework::Runtime::getThreadPool();
+}
+
+void FemRepresentation::setMassLumping(bool useMassLumping)
+{
+	SURGSIM_ASSERT(!isInitialized()) << "Mass lumping cannot be modified once the component is initialized";
+
+	m_useMassLumping = useMassLumping;
+}
+
+bool FemRepresentation::getMassLumping() const
+{
+	return m_useMassLumping;
+}
+
+const SurgSim::Math::Vector& FemRepresentation::getLumpedMass() const
+{
+	return m_lumpedMass;
+}
+
+bool FemRepresentation::hasDiagonalMass() const
+{
+	return m_useMassLumping;
+}
+
 Math::Matrix FemRepresentation::applyCompliance(const Math::OdeState& state, const Math::Matrix& b)
 {
 	SURGSIM_ASSERT(m_odeSolver) << "Ode solver not initialized, it should have been initialized on wake-up";
@@ -296,9 +453,24 @@ const SurgSim::Math::Matrix& FemRepresentation::getComplianceMatrix() const
 
 	if (m_useComplianceWarping)
 	{
+		SURGSIM_ASSERT(!getMatrixFreeCompliance()) << getName() << " uses the matrix free compliance, " <<
+			"the compliance matrix is not computed, use computeCHt() instead";
 		return m_complianceWarpingMatrix;
 	}
-	return m_odeSolver->getComplianceMatrix();
+	return DeformableRepresentation::getComplianceMatrix();
+}
+
+Math::Vector FemRepresentation::computeCHt(const Eigen::SparseVector<double, Eigen::RowMajor, ptrdiff_t>& h)
+{
+	if (m_useComplianceWarping && getMatrixFreeCompliance())
+	{
+		SURGSIM_ASSERT(m_initialLinearSolver) << "The initial system has not been computed yet, call update() first";
+		// C.H^t = R.C0.R^t.H^t, with C0 the initial compliance
+		Math::Matrix b = m_complianceWarpingTransformation.transpose() * h.transpose();
+		return m_complianceWarpingTransformation *
+			   solveWithBoundaryConditions(*m_currentState, *m_initialLinearSolver, b);
+	}
+	return DeformableRepresentation::computeCHt(h);
 }
 
 SurgSim::Math::Matrix FemRepresentation::getNodeTransformation(const SurgSim::Math::OdeState& state, size_t nodeId)
@@ -321,8 +493,11 @@ void FemRepresentation::updateComplianceMatrix(const SurgSim::Math::OdeState& st
 	}
 
 	// Then, transform the initial compliance matrix to get the current compliance warping matrix
-	m_complianceWarpingMatrix = m_complianceWarpingTransformation * m_odeSolver->getComplianceMatrix() *
-								m_complianceWarpingTransformation.transpose();
+	if (!getMatrixFreeCompliance())
+	{
+		m_complianceWarpingMatrix = m_complianceWarpingTransformation * m_odeSolver->getComplianceMatrix() *
+									m_complianceWarpingTransformation.transpose();
+	}
 }
 
 void FemRepresentation::computeF(const SurgSim::Math::OdeState& state)
@@ -343,13 +518,19 @@ void FemRepresentation::computeF(const SurgSim::Math::OdeState& state)
 
 void FemRepresentation::computeM(const SurgSim::Math::OdeState& state)
 {
+	// The lumped mass matrix is assembled on initialization
+	if (m_useMassLumping)
+	{
+		return;
+	}
+
 	// Make sure the mass matrix has been properly allocated and zeroed out
 	Math::clearMatrix(&m_M);
 
-	for (auto femElement = std::begin(m_femElements); femElement != std::end(m_femElements); femElement++)
+	assembleFemElements([this](size_t elementId)
 	{
-		(*femElement)->addMass(&m_M);
-	}
+		m_femElements[elementId]->addMass(m_femElementScatterMaps[elementId], &m_M);
+	});
 }
 
 void FemRepresentation::computeD(const SurgSim::Math::OdeState& state)
@@ -357,54 +538,60 @@ void FemRepresentation::computeD(const SurgSim::Math::OdeState& state)
 	const double& rayleighStiffness = m_rayleighDamping.stiffnessCoefficient;
 	const double& rayleighMass = m_rayleighDamping.massCoefficient;
 
+	if (m_hasExternalGeneralizedForce)
+	{
+		updateMatricesPattern();
+	}
+
 	// Make sure the damping matrix has been properly allocated and zeroed out
 	Math::clearMatrix(&m_D);
 
-	// D += rayleighMass.M
-	if (rayleighMass != 0.0)
+	// D += rayleighMass.M + rayleighStiffness.K + FemElements damping matrix
+	assembleFemElements([this, rayleighMass, rayleighStiffness](size_t elementId)
 	{
-		for (auto femElement = std::begin(m_femElements); femElement != std::end(m_femElements); femElement++)
+		const FemElement& element = *m_femElements[elementId];
+		const auto& scatterMap = m_femElementScatterMaps[elementId];
+		if (rayleighMass != 0.0 && !m_useMassLumping)
 		{
-			(*femElement)->addMass(&m_D, rayleighMass);
+			element.addMass(scatterMap, &m_D, rayleighMass);
 		}
-	}
-
-	// D += rayleighStiffness.K
-	if (rayleighStiffness != 0.0)
-	{
-		for (auto femElement = std::begin(m_femElements); femElement != std::end(m_femElements); femElement++)
+		if (rayleighStiffness != 0.0)
 		{
-			(*femElement)->addStiffness(&m_D, rayleighStiffness);
+			element.addStiffness(scatterMap, &m_D, rayleighStiffness);
 		}
-	}
-
-	// D += FemElements damping matrix
-	for (auto femElement = std::begin(m_femElements); femElement != std::end(m_femElements); femElement++)
+		element.addDamping(scatterMap, &m_D);
+	});
+	if (rayleighMass != 0.0 && m_useMassLumping)
 	{
-		(*femElement)->addDamping(&m_D);
+		addLumpedMass(rayleighMass, &m_D);
 	}
 
 	// Add external generalized damping
 	if (m_hasExternalGeneralizedForce)
 	{
-		m_D += m_externalGeneralizedDamping;
+		addInPattern(m_externalGeneralizedDamping, &m_D);
 	}
 }
 
 void FemRepresentation::computeK(const SurgSim::Math::OdeState& state)
 {
+	if (m_hasExternalGeneralizedForce)
+	{
+		updateMatricesPattern();
+	}
+
 	// Make sure the stiffness matrix has been properly allocated and zeroed out
 	Math::clearMatrix(&m_K);
 
-	for (auto femElement = std::begin(m_femElements); femElement != std::end(m_femElements); femElement++)
+	assembleFemElements([this](size_t elementId)
 	{
-		(*femElement)->addStiffness(&m_K);
-	}
+		m_femElements[elementId]->addStiffness(m_femElementScatterMaps[elementId], &m_K);
+	});
 
 	// Add external generalized stiffness
 	if (m_hasExternalGeneralizedForce)
 	{
-		m_K += m_externalGeneralizedStiffness;
+		addInPattern(m_externalGeneralizedStiffness, &m_K);
 	}
 }
 
@@ -413,8 +600,16 @@ void FemRepresentation::computeFMDK(const SurgSim::Math::OdeState& state)
 	// Make sure the force vector has been properly allocated and zeroed out
 	m_f.setZero(state.getNumDof());
 
-	// Make sure the mass matrix has been properly allocated and zeroed out
-	Math::clearMatrix(&m_M);
+	if (m_hasExternalGeneralizedForce)
+	{
+		updateMatricesPattern();
+	}
+
+	// Make sure the mass matrix has been properly allocated and zeroed out, the lumped one is constant
+	if (!m_useMassLumping)
+	{
+		Math::clearMatrix(&m_M);
+	}
 
 	// Make sure the damping matrix has been properly allocated and zeroed out
 	Math::clearMatrix(&m_D);
@@ -423,19 +618,38 @@ void FemRepresentation::computeFMDK(const SurgSim::Math::OdeState& state)
 	Math::clearMatrix(&m_K);
 
 	// Add all the FemElement contribution to f, M, D, K
-	for (auto femElement = std::begin(m_femElements); femElement != std::end(m_femElements); femElement++)
+	assembleFemElements([this](size_t elementId)
 	{
-		(*femElement)->addFMDK(&m_f, &m_M, &m_D, &m_K);
-	}
+		const auto& element = m_femElements[elementId];
+		const auto& scatterMap = m_femElementScatterMaps[elementId];
+		if (m_useMassLumping)
+		{
+			// The consistent mass matrix is not used
+			element->addForce(&m_f);
+			element->addDamping(scatterMap, &m_D);
+			element->addStiffness(scatterMap, &m_K);
+		}
+		else
+		{
+			element->addFMDK(scatterMap, &m_f, &m_M, &m_D, &m_K);
+		}
+	});
 
-	// Add the Rayleigh damping matrix
-	if (m_rayleighDamping.massCoefficient)
+	// Add the Rayleigh damping matrix, M (unless lumped), D and K sharing the same pattern, their values are added
+	// directly
+	Eigen::Map<Math::Vector> dValues(m_D.valuePtr(), m_D.nonZeros());
+	if (m_rayleighDamping.massCoefficient && m_useMassLumping)
 	{
-		m_D += m_M * m_rayleighDamping.massCoefficient;
+		addLumpedMass(m_rayleighDamping.massCoefficient, &m_D);
+	}
+	else if (m_rayleighDamping.massCoefficient)
+	{
+		dValues += m_rayleighDamping.massCoefficient * Eigen::Map<const Math::Vector>(m_M.valuePtr(), m_M.nonZeros());
 	}
 	if (m_rayleighDamping.stiffnessCoefficient)
 	{
-		m_D += m_K * m_rayleighDamping.stiffnessCoefficient;
+		dValues += m_rayleighDamping.stiffnessCoefficient *
+				   Eigen::Map<const Math::Vector>(m_K.valuePtr(), m_K.nonZeros());
 	}
 
 	// Add the gravity to m_f
@@ -453,8 +667,8 @@ void FemRepresentation::computeFMDK(const SurgSim::Math::OdeState& state)
 	if (m_hasExternalGeneralizedForce)
 	{
 		m_f += m_externalGeneralizedForce;
-		m_K += m_externalGeneralizedStiffness;
-		m_D += m_externalGeneralizedDamping;
+		addInPattern(m_externalGeneralizedStiffness, &m_K);
+		addInPattern(m_externalGeneralizedDamping, &m_D);
 
 		if (!m_previousExternalGeneralizedStiffness.isApprox(m_externalGeneralizedStiffness) ||
 			!m_previousExternalGeneralizedDamping.isApprox(m_externalGeneralizedDamping))
@@ -465,21 +679,152 @@ void FemRepresentation::computeFMDK(const SurgSim::Math::OdeState& state)
 }
 
 void FemRepresentation::updateFMDK(const SurgSim::Math::OdeState& state, int options)
+{
+	// The FemElements mass matrices are not used once the mass is lumped
+	updateFemElements(state, m_useMassLumping ? (options & ~Math::ODEEQUATIONUPDATE_M) : options);
+
+	OdeEquation::updateFMDK(state, options);
+}
+
+void FemRepresentation::updateMatrixFreeFMDK(const SurgSim::Math::OdeState& state)
+{
+	updateFemElements(state, m_useMassLumping ? (Math::ODEEQUATIONUPDATE_FMDK & ~Math::ODEEQUATIONUPDATE_M) :
+					  Math::ODEEQUATIONUPDATE_FMDK);
+
+	computeF(state);
+}
+
+void FemRepresentation::applyMDK(double alphaM, double alphaD, double alphaK, const SurgSim::Math::Vector& x,
+								 SurgSim::Math::Vector* result)
+{
+	// D = FemElements D + rayleighMass.M + rayleighStiffness.K (+ external damping)
+	const double massAlpha = alphaM + alphaD * m_rayleighDamping.massCoefficient;
+	const double elementAlphaM = m_useMassLumping ? 0.0 : massAlpha;
+	const double elementAlphaK = alphaK + alphaD * m_rayleighDamping.stiffnessCoefficient;
+
+	result->setZero(x.size());
+
+	// The FemElements of a color do not share any node, each chunk of a color can add into result concurrently
+	// with its own temporary vectors
+	size_t numChunks = 0;
+	for (const auto& color : m_femElementColors)
+	{
+		numChunks = std::max(numChunks, (color.size() + AssemblyGrainSize - 1) / AssemblyGrainSize);
+	}
+	if (m_matVecBuffers.size() < numChunks)
+	{
+		m_matVecBuffers.resize(numChunks);
+	}
+
+	for (const auto& color : m_femElementColors)
+	{
+		auto addChunk = [this, &color, &x, result, elementAlphaM, alphaD, elementAlphaK](size_t chunk)
+		{
+			auto& buffers = m_matVecBuffers[chunk];
+			const size_t end = std::min(color.size(), (chunk + 1) * AssemblyGrainSize);
+			for (size_t i = chunk * AssemblyGrainSize; i < end; ++i)
+			{
+				m_femElements[color[i]]->addMatVec(elementAlphaM, alphaD, elementAlphaK, x, result,
+												   &buffers.first, &buffers.second);
+			}
+		};
+
+		const size_t colorChunks = (color.size() + AssemblyGrainSize - 1) / AssemblyGrainSize;
+		if (m_useParallelAssembly)
+		{
+			auto threadPool = getAssemblyThreadPoolOrDefault();
+			threadPool->parallelFor(0, colorChunks, 1, addChunk);
+		}
+		else
+		{
+			for (size_t chunk = 0; chunk < colorChunks; ++chunk)
+			{
+				addChunk(chunk);
+			}
+		}
+	}
+
+	if (m_useMassLumping && massAlpha != 0.0)
+	{
+		*result += massAlpha * m_lumpedMass.cwiseProduct(x);
+	}
+
+	if (m_hasExternalGeneralizedForce)
+	{
+		if (alphaK != 0.0)
+		{
+			*result += alphaK * (m_externalGeneralizedStiffness * x);
+		}
+		if (alphaD != 0.0)
+		{
+			*result += alphaD * (m_externalGeneralizedDamping * x);
+		}
+	}
+}
+
+void FemRepresentation::computeMDKDiagonalBlocks(double alphaM, double alphaD, double alphaK, size_t blockSize,
+		SurgSim::Math::Matrix* blocks)
+{
+	SURGSIM_ASSERT(blockSize == getNumDofPerNode()) << "The diagonal blocks of " << getName() <<
+		" are node blocks of size " << getNumDofPerNode() << ", not " << blockSize;
+
+	const double massAlpha = alphaM + alphaD * m_rayleighDamping.massCoefficient;
+	const double elementAlphaM = m_useMassLumping ? 0.0 : massAlpha;
+	const double elementAlphaK = alphaK + alphaD * m_rayleighDamping.stiffnessCoefficient;
+
+	blocks->setZero(static_cast<Matrix::Index>(getNumDof()), static_cast<Matrix::Index>(blockSize));
+	assembleFemElements([this, elementAlphaM, alphaD, elementAlphaK, blocks](size_t elementId)
+	{
+		m_femElements[elementId]->addMatDiagonalBlocks(elementAlphaM, alphaD, elementAlphaK, blocks);
+	});
+
+	if (m_useMassLumping && massAlpha != 0.0)
+	{
+		for (Matrix::Index row = 0; row < blocks->rows(); ++row)
+		{
+			(*blocks)(row, row % blocks->cols()) += massAlpha * m_lumpedMass[row];
+		}
+	}
+
+	if (m_hasExternalGeneralizedForce)
+	{
+		addDiagonalBlocks(m_externalGeneralizedStiffness, alphaK, blocks);
+		addDiagonalBlocks(m_externalGeneralizedDamping, alphaD, blocks);
+	}
+}
+
+void FemRepresentation::updateFemElements(const SurgSim::Math::OdeState& state, int options)
 {
 	// This function updates the matrices needed to calculate F, M, D, K for each element.
 	// Note that the relevant matrices are updated only for non-linear elements.
-	for (auto femElement = std::begin(m_femElements); femElement != std::end(m_femElements); femElement++)
+	// Each element only updates its own data, so they can all be updated concurrently.
+	if (m_useParallelAssembly)
 	{
-		(*femElement)->updateFMDK(state, options);
+		auto threadPool = getAssemblyThreadPoolOrDefault();
+		threadPool->parallelFor(0, m_femElements.size(), UpdateGrainSize, [this, &state, options](size_t elementId)
+		{
+			m_femElements[elementId]->updateFMDK(state, options);
+		});
 	}
+	else
+	{
+		for (auto femElement = std::begin(m_femElements); femElement != std::end(m_femElements); femElement++)
+		{
+			(*femElement)->updateFMDK(state, options);
+		}
+	}
+}
 
-// 	#pragma omp parallel for
-// 	for (int i = 0; i < m_femElements.size(); ++i)
-// 	{
-// 		m_femElements[i]->updateFMDK(state, options);
-// 	}
-
-	OdeEquation::updateFMDK(state, options);
+void FemRepresentation::addLumpedMass(double scale, SurgSim::Math::SparseMatrix* matrix) const
+{
+	for (SparseMatrix::Index dof = 0; dof < m_lumpedMass.size(); ++dof)
+	{
+		// A dof without any FemElement has no mass and is not part of the matrix pattern
+		if (m_lumpedMass[dof] != 0.0)
+		{
+			matrix->coeffRef(dof, dof) += scale * m_lumpedMass[dof];
+		}
+	}
 }
 
 void FemRepresentation::addRayleighDampingForce(
@@ -501,8 +846,13 @@ void FemRepresentation::addRayleighDampingForce(
 	// Rayleigh damping mass: F = -rayleighMass.M.v(t)
 	if (rayleighMass != 0.0)
 	{
+		// With the lumped mass matrix, F = -rayleighMass.M.v(t) is a component-wise product
+		if (m_useMassLumping)
+		{
+			*force -= (scale * rayleighMass) * m_lumpedMass.cwiseProduct(v);
+		}
 		// If we have the mass matrix, we can compute directly F = -rayleighMass.M.v(t)
-		if (useGlobalMassMatrix)
+		else if (useGlobalMassMatrix)
 		{
 			Math::Vector tempForce = (scale * rayleighMass) * (m_M * v);
 			*force -= tempForce;
@@ -548,9 +898,61 @@ void FemRepresentation::addFemElementsForce(SurgSim::Math::Vector* force,
 		const SurgSim::Math::OdeState& state,
 		double scale)
 {
-	for (auto femElement = std::begin(m_femElements); femElement != std::end(m_femElements); femElement++)
+	assembleFemElements([this, force, scale](size_t elementId)
+	{
+		m_femElements[elementId]->addForce(force, scale);
+	});
+}
+
+void FemRepresentation::assembleFemElements(const std::function<void(size_t)>& function)
+{
+	if (m_useParallelAssembly)
+	{
+		auto threadPool = getAssemblyThreadPoolOrDefault();
+		for (const auto& color : m_femElementColors)
+		{
+			threadPool->parallelFor(0, color.size(), AssemblyGrainSize, [&color, &function](size_t i)
+			{
+				function(color[i]);
+			});
+		}
+	}
+	else
+	{
+		for (const auto& color : m_femElementColors)
+		{
+			for (auto elementId : color)
+			{
+				function(elementId);
+			}
+		}
+	}
+}
+
+void FemRepresentation::updateMatricesPattern()
+{
+	if (isInPattern(m_externalGeneralizedStiffness, m_K) && isInPattern(m_externalGeneralizedDamping, m_K))
+	{
+		return;
+	}
+
+	// Extend the common pattern with explicit zeros, it is kept for the following frames so the external
+	// generalized stiffness and damping can be added in place as long as they do not touch new entries
+	// The lumped mass matrix keeps its diagonal pattern
+	const SparseMatrix newEntries = 0.0 * m_externalGeneralizedStiffness + 0.0 * m_externalGeneralizedDamping;
+	if (!m_useMassLumping)
+	{
+		m_M = m_M + newEntries;
+		m_M.makeCompressed();
+	}
+	m_D = m_D + newEntries;
+	m_K = m_K + newEntries;
+	m_D.makeCompressed();
+	m_K.makeCompressed();
+
+	for (size_t elementId = 0; elementId < m_femElements.size(); ++elementId)
 	{
-		(*femElement)->addForce(force, scale);
+		m_femElements[elementId]->computeScatterMap(m_K, &m_femElementScatterMaps[elementId]);
 	}
 }
 
@@ -16,7 +16,9 @@
 #ifndef SURGSIM_PHYSICS_FEMREPRESENTATION_H
 #define SURGSIM_PHYSICS_FEMREPRESENTATION_H
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include "SurgSim/DataStructures/IndexedLocalCoordinate.h"
 #include "SurgSim/Math/Matrix.h"
@@ -28,6 +30,11 @@
 namespace SurgSim
 {
 
+namespace Framework
+{
+class ThreadPool;
+}
+
 namespace Physics
 {
 
@@ -121,6 +128,43 @@ class FemRepresentation : public DeformableRepresentation
 	/// \return True if compliance warping is used, False otherwise
 	bool getComplianceWarping() const;
 
+	/// Set whether the FemElements are updated and assembled in parallel
+	/// \param useParallelAssembly True to update and assemble the FemElements on the assembly thread pool, False to
+	/// do it on the calling thread
+	/// \note The elements are assembled color by color, the elements of a color not sharing any node, so the global
+	/// vector and matrices are filled without any synchronization. The result does not depend on this setting.
+	void setParallelAssembly(bool useParallelAssembly);
+
+	/// Get the parallel assembly flag (default = true)
+	/// \return True if the FemElements are updated and assembled in parallel, False otherwise
+	bool getParallelAssembly() const;
+
+	/// Set the thread pool used by the parallel assembly
+	/// \param threadPool The thread pool to use, nullptr to use the Runtime thread pool (default)
+	void setAssemblyThreadPool(std::shared_ptr<SurgSim::Framework::ThreadPool> threadPool);
+
+	/// \return The thread pool used by the parallel assembly, nullptr if it uses the Runtime thread pool
+	std::shared_ptr<SurgSim::Framework::ThreadPool> getAssemblyThreadPool() const;
+
+	/// Set whether the mass matrix is lumped
+	/// \param useMassLumping True to use the lumped (diagonal) mass matrix, False to use the consistent mass matrix
+	/// \exception SurgSim::Framework::AssertionFailure If the call is done after initialization
+	/// \note The mass is lumped once on initialization with FemElement::addLumpedMass(), the global mass matrix is
+	/// then only made of its diagonal and the FemElements mass matrices are not updated anymore. With an explicit
+	/// integration scheme, the solvers only scale the force by the lumped mass with
+	/// LinearSparseSolveAndInverseDiagonal, and the compliance is matrix free (see
+	/// DeformableRepresentation::setMatrixFreeCompliance()).
+	void setMassLumping(bool useMassLumping);
+
+	/// Get the mass lumping flag (default = false)
+	/// \return True if the mass matrix is lumped, False otherwise
+	bool getMassLumping() const;
+
+	/// \return The diagonal of the lumped mass matrix, empty if the mass is not lumped
+	const SurgSim::Math::Vector& getLumpedMass() const override;
+
+	bool hasDiagonalMass() const override;
+
 	/// Calculate the product C.b where C is the compliance matrix with boundary conditions
 	/// \param state \f$(x, v)\f$ the current position and velocity to evaluate the various terms with
 	/// \param b The input matrix b
@@ -129,9 +173,32 @@ class FemRepresentation : public DeformableRepresentation
 
 	const SurgSim::Math::Matrix& getComplianceMatrix() const override;
 
+	Math::Vector computeCHt(const Eigen::SparseVector<double, Eigen::RowMajor, ptrdiff_t>& h) override;
+
 	void updateFMDK(const SurgSim::Math::OdeState& state, int options) override;
 
+	/// Updates the FemElements and computes f, the global M, D, K are not assembled.
+	/// \note Use applyMDK() and computeMDKDiagonalBlocks() to solve the system matrix free
+	void updateMatrixFreeFMDK(const SurgSim::Math::OdeState& state) override;
+
+	/// Computes the product FemElement by FemElement, color by color, in parallel within a color if the parallel
+	/// assembly is used, with the external generalized stiffness and damping if any.
+	void applyMDK(double alphaM, double alphaD, double alphaK, const SurgSim::Math::Vector& x,
+				  SurgSim::Math::Vector* result) override;
+
+	void computeMDKDiagonalBlocks(double alphaM, double alphaD, double alphaK, size_t blockSize,
+								  SurgSim::Math::Matrix* blocks) override;
+
 protected:
+	/// Number of FemElements assembled by a task of the parallel assembly
+	static const size_t AssemblyGrainSize = 64;
+
+	/// Number of FemElements updated by a task of the parallel update
+	static const size_t UpdateGrainSize = 16;
+
+	/// \return the thread pool set with setAssemblyThreadPool(), or the Runtime thread pool if none was set
+	std::shared_ptr<SurgSim::Framework::ThreadPool> getAssemblyThreadPoolOrDefault() const;
+
 	/// Adds the Rayleigh damping forces
 	/// \param[in,out] f The force vector to cumulate the Rayleigh damping force into
 	/// \param state The state vector containing positions and velocities
@@ -153,6 +220,24 @@ class FemRepresentation : public DeformableRepresentation
 	/// \param scale A scaling factor to scale the FemElements forces with
 	void addFemElementsForce(SurgSim::Math::Vector* f, const SurgSim::Math::OdeState& state, double scale = 1.0);
 
+	/// Calls a function for each FemElement, color by color, in parallel within a color if the parallel assembly is
+	/// used. The FemElements of a color do not share any node, so the function can add the contribution of an element
+	/// to the global vector and matrices without synchronization.
+	/// \param function The function to call with each FemElement id
+	void assembleFemElements(const std::function<void(size_t)>& function);
+
+	/// Updates the FemElements data needed to calculate F, M, D, K, in parallel if the parallel assembly is used
+	/// \param state The state to update the FemElements with
+	/// \param options Flag to specify which of the F, M, D, K needs to be updated
+	/// \note Derived classes can override it to update some FemElements in a more efficient way, all the FemElements
+	/// need to be updated on return
+	virtual void updateFemElements(const SurgSim::Math::OdeState& state, int options);
+
+	/// Extends the pattern shared by the global matrices M, D and K with the entries of the external generalized
+	/// stiffness and damping that are not part of it yet, and updates the FemElements scatter maps accordingly.
+	/// The pattern only grows, so once extended the external matrices are added in place on the following frames.
+	void updateMatricesPattern();
+
 	/// Adds the gravity force to f (given a state)
 	/// \param[in,out] f The force vector to cumulate the gravity force into
 	/// \param state The state vector containing positions and velocities
@@ -165,7 +250,7 @@ class FemRepresentation : public DeformableRepresentation
 	/// Updates the compliance matrix using nodes transformation (useful for compliance warping)
 	/// \param state The state to compute the nodes transformation from
 	/// \note This computes the diagonal block matrix m_complianceWarpingTransformation and
-	///       transforms the initial compliance matrix with it.
+	///       transforms the initial compliance matrix with it, unless the compliance is matrix free.
 	void updateComplianceMatrix(const SurgSim::Math::OdeState& state);
 
 	/// Retrieves a specific node transformation (useful for compliance warping)
@@ -198,6 +283,12 @@ class FemRepresentation : public DeformableRepresentation
 	/// FemElements
 	std::vector<std::shared_ptr<FemElement>> m_femElements;
 
+	/// For each FemElement, its scatter map in the global matrices (see FemElement::computeScatterMap)
+	std::vector<std::vector<SurgSim::Math::SparseMatrix::Index>> m_femElementScatterMaps;
+
+	/// The FemElements ids grouped by color, FemElements of the same color do not share any node
+	std::vector<std::vector<size_t>> m_femElementColors;
+
 	/// The FemElement factory parameter invoked in doInitialize() when using a MeshAsset
 	/// either with LoadFem(const std::stirng& filename) or setFem(std::shared_ptr<Asset> mesh)
 	/// This ensures that when using a mesh Asset, a single FemElement type is used. Therefore we do
@@ -205,6 +296,11 @@ class FemRepresentation : public DeformableRepresentation
 	std::string m_femElementType;
 
 private:
+	/// Adds the lumped mass matrix into the diagonal of a global matrix
+	/// \param scale A factor to scale the added lumped mass with
+	/// \param[in,out] matrix The global matrix, the diagonal entries missing from its pattern are inserted
+	void addLumpedMass(double scale, SurgSim::Math::SparseMatrix* matrix) const;
+
 	/// Rayleigh damping parameters (massCoefficient and stiffnessCoefficient)
 	/// D = massCoefficient.M + stiffnessCoefficient.K
 	/// Matrices: D = damping, M = mass, K = stiffness
@@ -222,6 +318,23 @@ class FemRepresentation : public DeformableRepresentation
 
 	/// The system-size transformation matrix. It contains nodes transformation on the diagonal blocks.
 	Eigen::SparseMatrix<double> m_complianceWarpingTransformation;
+
+	bool m_useParallelAssembly; ///< Are the FemElements updated and assembled in parallel or not ?
+
+	bool m_useMassLumping; ///< Is the mass matrix lumped or not ?
+
+	/// The diagonal of the lumped mass matrix, if the mass matrix is lumped
+	SurgSim::Math::Vector m_lumpedMass;
+
+	/// The thread pool used for the parallel assembly, nullptr to use the Runtime thread pool
+	std::shared_ptr<SurgSim::Framework::ThreadPool> m_assemblyThreadPool;
+
+	/// For compliance warping with the matrix free compliance, the linear solver holding the initial system matrix
+	std::shared_ptr<SurgSim::Math::LinearSparseSolveAndInverse> m_initialLinearSolver;
+
+	/// For the matrix free product, the FemElements temporary vectors (extracted x and accumulator) of each chunk of
+	/// FemElements processed by a thread
+	std::vector<std::pair<SurgSim::Math::Vector, SurgSim::Math::Vector>> m_matVecBuffers;
 };
 
 } // namespace Physics
@@ -47,24 +47,22 @@ std::shared_ptr<PhysicsManagerState> FreeMotion::doUpdate(const double& dt,
 	std::shared_ptr<PhysicsManagerState> result = state;
 
 	auto threadPool = Framework::Runtime::getThreadPool();
-	std::vector<std::future<void>> tasks;
 
 	auto& representations = result->getActiveRepresentations();
-	for (auto& representation : representations)
-	{
-		tasks.push_back(threadPool->enqueue<void>([dt, &representation]() { representation->update(dt); }));
-	}
-
 	auto& particleRepresentations = result->getActiveParticleRepresentations();
-	for (auto& representation : particleRepresentations)
-	{
-		tasks.push_back(threadPool->enqueue<void>([dt, &representation]() { representation->update(dt); }));
-	}
-
-	for (auto& task : tasks)
+	const size_t numRepresentations = representations.size();
+	threadPool->parallelFor(0, numRepresentations + particleRepresentations.size(), 1,
+		[dt, numRepresentations, &representations, &particleRepresentations](size_t i)
 	{
-		task.get();
-	}
+		if (i < numRepresentations)
+		{
+			representations[i]->update(dt);
+		}
+		else
+		{
+			particleRepresentations[i - numRepresentations]->update(dt);
+		}
+	});
 
 	return result;
 }
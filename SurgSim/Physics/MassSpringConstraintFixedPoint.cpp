@@ -99,7 +99,7 @@ void MassSpringConstraintFixedPoint::doBuild(double dt,
 	{
 		m_newH.setZero();
 		m_newH.insert(3 * nodeId + axis) = dt * scale;
-		mlcp->updateConstraint(m_newH, massSpring->getComplianceMatrix() * m_newH.transpose(),
+		mlcp->updateConstraint(m_newH, massSpring->computeCHt(m_newH),
 			indexOfRepresentation, indexOfConstraint + axis);
 	}
 }
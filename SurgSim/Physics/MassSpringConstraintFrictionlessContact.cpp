@@ -87,7 +87,7 @@ void MassSpringConstraintFrictionlessContact::doBuild(double dt,
 	m_newH.insert(3 * nodeId + 1) = n[1] * scale;
 	m_newH.insert(3 * nodeId + 2) = n[2] * scale;
 
-	mlcp->updateConstraint(m_newH, massSpring->getComplianceMatrix() * m_newH.transpose(),
+	mlcp->updateConstraint(m_newH, massSpring->computeCHt(m_newH),
 						   indexOfRepresentation, indexOfConstraint);
 }
 
@@ -468,6 +468,19 @@ std::shared_ptr<Localization> MassSpringRepresentation::createLocalization(
 	return result;
 }
 
+bool MassSpringRepresentation::updateLocalization(const SurgSim::DataStructures::Location& location,
+		Localization* localization)
+{
+	auto massSpringLocalization = dynamic_cast<MassSpringLocalization*>(localization);
+	if (massSpringLocalization == nullptr || !location.index.hasValue())
+	{
+		return false;
+	}
+
+	massSpringLocalization->setLocalNode(*location.index);
+	return true;
+}
+
 } // namespace Physics
 
 } // namespace SurgSim
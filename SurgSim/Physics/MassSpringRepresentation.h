@@ -108,6 +108,8 @@ class MassSpringRepresentation : public DeformableRepresentation
 
 	std::shared_ptr<Localization> createLocalization(const SurgSim::DataStructures::Location& location) override;
 
+	bool updateLocalization(const SurgSim::DataStructures::Location& location, Localization* localization) override;
+
 protected:
 	/// Add the Rayleigh damping forces
 	/// \param[in,out] f The force vector to cumulate the Rayleigh damping force into
@@ -0,0 +1,50 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SURGSIM_PHYSICS_MLCPISLAND_H
+#define SURGSIM_PHYSICS_MLCPISLAND_H
+
+#include <stddef.h>
+
+namespace SurgSim
+{
+namespace Physics
+{
+
+/// A group of constraints that do not share any degree of freedom with the constraints outside of the group.
+///
+/// BuildMlcp stores the constraints of an island contiguously in the \ref MlcpPhysicsProblem, so the island
+/// occupies a diagonal block of \f$\mathbf{A}\f$ and all the entries of \f$\mathbf{A}\f$ coupling it with other
+/// islands are zero. Each island can therefore be solved independently of the other ones.
+/// \note Representations without degrees of freedom (e.g. FixedRepresentation) do not couple constraints.
+struct MlcpIsland
+{
+	/// Index of the first constraint of the island in MlcpProblem::constraintTypes
+	size_t constraintIndex;
+
+	/// Number of constraints in the island
+	size_t numConstraints;
+
+	/// Index of the first atomic constraint (row of the Mlcp) of the island
+	size_t atomicIndex;
+
+	/// Number of atomic constraints in the island
+	size_t numAtomicConstraints;
+};
+
+};  // namespace Physics
+};  // namespace SurgSim
+
+#endif  // SURGSIM_PHYSICS_MLCPISLAND_H
@@ -60,8 +60,12 @@ void MlcpPhysicsProblem::updateConstraint(
 	//
 	// (H+H')C(H+H')t = HCHt + HCH't + H'C(H+H')t
 	// => HCHt += H(CH't) + H'[C(H+H')t];
+	const bool updateA = !isSparse();
 
-	A.col(indexNewSubH) += H.middleCols(indexSubC, newCHt.rows()) * newCHt;
+	if (updateA)
+	{
+		A.col(indexNewSubH) += H.middleCols(indexSubC, newCHt.rows()) * newCHt;
+	}
 
 	// Calculate: H.block(indexNewSubH, indexSubC, 1, newCHt.rows()) += newSubH;
 	for (Eigen::SparseVector<double, Eigen::RowMajor, ptrdiff_t>::InnerIterator it(newSubH); it; ++it)
@@ -70,7 +74,47 @@ void MlcpPhysicsProblem::updateConstraint(
 	}
 
 	CHt.block(indexSubC, indexNewSubH, newCHt.rows(), 1) += newCHt;
-	A.row(indexNewSubH) += newSubH * CHt.middleRows(indexSubC, newCHt.rows());
+	if (updateA)
+	{
+		A.row(indexNewSubH) += newSubH * CHt.middleRows(indexSubC, newCHt.rows());
+	}
+}
+
+void MlcpPhysicsProblem::assembleSparseA()
+{
+	// The columns of CHt are only non-zero on the degrees of freedom of the representations of their constraint, so
+	// the sparse product only has entries for the constraints that share a representation.
+	Eigen::SparseMatrix<double, Eigen::ColMajor, ptrdiff_t> sparseCHt = CHt.sparseView();
+	sparseA = H * sparseCHt;
+}
+
+void MlcpPhysicsProblem::assembleSparseA(const std::vector<MlcpIsland>& islands)
+{
+	Eigen::VectorXi rowSizes(H.rows());
+	for (const auto& island : islands)
+	{
+		rowSizes.segment(island.atomicIndex, island.numAtomicConstraints).setConstant(
+			static_cast<int>(island.numAtomicConstraints));
+	}
+	sparseA.resize(H.rows(), H.rows());
+	sparseA.reserve(rowSizes);
+
+	// The rows of H of an island are only non-zero on the degrees of freedom of the representations of the island
+	Matrix block;
+	for (const auto& island : islands)
+	{
+		const Eigen::Index start = static_cast<Eigen::Index>(island.atomicIndex);
+		const Eigen::Index size = static_cast<Eigen::Index>(island.numAtomicConstraints);
+		block.noalias() = H.middleRows(start, size) * CHt.middleCols(start, size);
+		for (Eigen::Index row = 0; row < size; ++row)
+		{
+			for (Eigen::Index col = 0; col < size; ++col)
+			{
+				sparseA.insert(start + row, start + col) = block(row, col);
+			}
+		}
+	}
+	sparseA.makeCompressed();
 }
 
 }; // namespace Physics
@@ -16,8 +16,11 @@
 #ifndef SURGSIM_PHYSICS_MLCPPHYSICSPROBLEM_H
 #define SURGSIM_PHYSICS_MLCPPHYSICSPROBLEM_H
 
+#include <vector>
+
 #include "SurgSim/Math/MlcpProblem.h"
 #include "SurgSim/Math/SparseMatrix.h"
+#include "SurgSim/Physics/MlcpIsland.h"
 
 namespace SurgSim
 {
@@ -60,6 +63,8 @@ struct MlcpPhysicsProblem : public SurgSim::Math::MlcpProblem
 	Matrix CHt;
 
 	/// Applies a new constraint to a specific Representation
+	/// When the problem is sparse (see isSparse()), only H and CHt are updated, sparseA is assembled afterward by
+	/// assembleSparseA().
 	/// \param newSubH New constraint to be added to H
 	/// \param newCHt Compliance matrix (system matrix inverse) times newSubH
 	/// \param indexSubC Index of the Representation's compliance matrix
@@ -70,6 +75,17 @@ struct MlcpPhysicsProblem : public SurgSim::Math::MlcpProblem
 		size_t indexSubC,
 		size_t indexNewSubH);
 
+	/// Assembles sparseA as \f$\mathbf{H\;C\;H^T}\f$ once all the constraints have been applied.
+	/// Only the blocks coupling constraints that share a representation are stored, the dense matrix A is never
+	/// formed.
+	void assembleSparseA();
+
+	/// Assembles sparseA as the block diagonal matrix of the islands once all the constraints have been applied.
+	/// Each block is computed from the rows of H and the columns of CHt of its island only, neither the dense matrix
+	/// A nor the blocks coupling different islands (which are zero) are formed.
+	/// \param islands The islands, covering all the atomic constraints
+	void assembleSparseA(const std::vector<MlcpIsland>& islands);
+
 	/// Resize an MlcpPhysicsProblem and set to zero.
 	/// \param numDof the total degrees of freedom.
 	/// \param numConstraintDof the total constrained degrees of freedom.
@@ -13,9 +13,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <utility>
+
 #include "SurgSim/Framework/Assert.h"
 #include "SurgSim/Math/OdeState.h"
 #include "SurgSim/Math/Vector.h"
+#include "SurgSim/Physics/Fem3DElementCorotationalTetrahedron.h"
 #include "SurgSim/Physics/Fem3DElementCube.h"
 #include "SurgSim/Physics/Fem3DRepresentation.h"
 #include "SurgSim/Physics/PerformanceTests/DivisibleCubeRepresentation.h"
@@ -27,7 +30,8 @@ namespace SurgSim
 namespace Physics
 {
 
-DivisibleCubeRepresentation::DivisibleCubeRepresentation(const std::string& name, size_t nodesPerAxis)
+DivisibleCubeRepresentation::DivisibleCubeRepresentation(const std::string& name, size_t nodesPerAxis,
+		bool useTetrahedra)
 	: Fem3DRepresentation(name), m_numNodesPerAxis(nodesPerAxis)
 {
 	// Compute the center point of the cube
@@ -50,7 +54,14 @@ DivisibleCubeRepresentation::DivisibleCubeRepresentation(const std::string& name
 	auto initialState = std::make_shared<SurgSim::Math::OdeState>();
 	fillUpDeformableState(initialState);
 	setInitialState(initialState);
-	addFemCubes(initialState);
+	if (useTetrahedra)
+	{
+		addFemTetrahedra(initialState);
+	}
+	else
+	{
+		addFemCubes(initialState);
+	}
 }
 
 bool DivisibleCubeRepresentation::initializeNoWakeUp()
@@ -156,5 +167,57 @@ void DivisibleCubeRepresentation::addFemCubes(std::shared_ptr<SurgSim::Math::Ode
 	}
 }
 
+/// Adds the Fem3D elements of small cubes, each split in 6 corotational tetrahedra around its main diagonal
+/// \param state	The state for initialization.
+void DivisibleCubeRepresentation::addFemTetrahedra(std::shared_ptr<SurgSim::Math::OdeState> state)
+{
+	const SurgSim::Math::Vector& x = state->getPositions();
+	for (size_t i = 0; i < m_numNodesPerAxis - 1; i++)
+	{
+		for (size_t j = 0; j < m_numNodesPerAxis - 1; j++)
+		{
+			for (size_t k = 0; k < m_numNodesPerAxis - 1; k++)
+			{
+				// Corner c of the small cube is offset by (c & 1, (c >> 1) & 1, (c >> 2) & 1) from node (i, j, k)
+				std::array<size_t, 8> cubeNodeIds;
+				for (size_t corner = 0; corner < 8; corner++)
+				{
+					cubeNodeIds[corner] = get1DIndexFrom3D(i + (corner & 1), j + ((corner >> 1) & 1),
+														   k + ((corner >> 2) & 1));
+				}
+
+				// Each tetrahedron goes from the corner 0 to the corner 7 along the edges, one axis after the other
+				static const std::array<std::array<size_t, 3>, 6> axesOrders = {{
+						{{1, 2, 4}}, {{1, 4, 2}}, {{2, 1, 4}}, {{2, 4, 1}}, {{4, 1, 2}}, {{4, 2, 1}}
+					}
+				};
+				for (const auto& axes : axesOrders)
+				{
+					std::array<size_t, 4> tetrahedron = {cubeNodeIds[0], cubeNodeIds[axes[0]],
+														 cubeNodeIds[axes[0] + axes[1]], cubeNodeIds[7]
+														};
+
+					// Keep the tetrahedra positively oriented, as the ones loaded from a mesh
+					Vector3d p0 = SurgSim::Math::getSubVector(x, tetrahedron[0], 3);
+					Vector3d p1 = SurgSim::Math::getSubVector(x, tetrahedron[1], 3);
+					Vector3d p2 = SurgSim::Math::getSubVector(x, tetrahedron[2], 3);
+					Vector3d p3 = SurgSim::Math::getSubVector(x, tetrahedron[3], 3);
+					if ((p1 - p0).cross(p2 - p0).dot(p3 - p0) < 0.0)
+					{
+						std::swap(tetrahedron[2], tetrahedron[3]);
+					}
+
+					auto femElement = std::make_shared<Fem3DElementCorotationalTetrahedron>(tetrahedron);
+					femElement->setMassDensity(980.0);   // 0.98 g/cm^-3 (2-part silicone rubber a.k.a. RTV6166)
+					femElement->setPoissonRatio(0.499);  // From the paper (near 0.5)
+					femElement->setYoungModulus(15.3e3); // 15.3 kPa (From the paper)
+					femElement->initialize(*state);
+					addFemElement(femElement);
+				}
+			}
+		}
+	}
+}
+
 } // namespace Physics
 } // namespace SurgSim
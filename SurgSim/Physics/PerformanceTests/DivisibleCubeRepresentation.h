@@ -35,7 +35,9 @@ class DivisibleCubeRepresentation : public Fem3DRepresentation
 	/// Constructor
 	/// \param name	The name of the divisible cube representation.
 	/// \param nodesPerAxis	The number of nodes per axis
-	DivisibleCubeRepresentation(const std::string& name, size_t nodesPerAxis);
+	/// \param useTetrahedra	True to split each small cube in 6 Fem3DElementCorotationalTetrahedron, False to use
+	/// Fem3DElementCube
+	DivisibleCubeRepresentation(const std::string& name, size_t nodesPerAxis, bool useTetrahedra = false);
 
 
 	/// Initialize without setting up the complete system so that we can separately
@@ -61,6 +63,10 @@ class DivisibleCubeRepresentation : public Fem3DRepresentation
 	/// \param state	The state for initialization.
 	void addFemCubes(std::shared_ptr<SurgSim::Math::OdeState> state);
 
+	/// Adds the Fem3D elements of small cubes, each split in 6 corotational tetrahedra around its main diagonal
+	/// \param state	The state for initialization.
+	void addFemTetrahedra(std::shared_ptr<SurgSim::Math::OdeState> state);
+
 private:
 	// Number of point per dimensions
 	size_t m_numNodesPerAxis;
@@ -21,10 +21,12 @@
 #include "SurgSim/DataStructures/PlyReader.h"
 #include "SurgSim/Framework/Assert.h"
 #include "SurgSim/Framework/Runtime.h"
+#include "SurgSim/Framework/ThreadPool.h"
 #include "SurgSim/Framework/Timer.h"
 #include "SurgSim/Math/LinearSparseSolveAndInverse.h"
 #include "SurgSim/Math/OdeState.h"
 #include "SurgSim/Math/Vector.h"
+#include "SurgSim/Physics/Fem3DElementCorotationalTetrahedron.h"
 #include "SurgSim/Physics/Fem3DPlyReaderDelegate.h"
 #include "SurgSim/Physics/Fem3DRepresentation.h"
 #include "SurgSim/Physics/Fem3DElementCube.h"
@@ -67,6 +69,7 @@ static std::unordered_map<SurgSim::Math::LinearSolver, std::string, std::hash<in
 #define FEM3DPERFORMANCETEST_MAP_NAME(map, name) (map)[name] = #name
 	FEM3DPERFORMANCETEST_MAP_NAME(result, SurgSim::Math::LINEARSOLVER_LU);
 	FEM3DPERFORMANCETEST_MAP_NAME(result, SurgSim::Math::LINEARSOLVER_CONJUGATEGRADIENT);
+	FEM3DPERFORMANCETEST_MAP_NAME(result, SurgSim::Math::LINEARSOLVER_LDLT);
 #undef FEM3DPERFORMANCETEST_MAP_NAME
 
 	return result;
@@ -150,6 +153,25 @@ class Fem3DPerformanceTestBase : public ::testing::Test
 		RecordProperty("FrameRate", boost::to_string(timer.getAverageFrameRate()));
 	}
 
+	/// Time the update and assembly of all the FemElements
+	/// \param fem The initialized fem
+	/// \return The cumulative time of frameCount updates
+	double timeAssembly(std::shared_ptr<Fem3DRepresentation> fem)
+	{
+		const int options = SurgSim::Math::ODEEQUATIONUPDATE_FMDK;
+		fem->updateFMDK(*fem->getCurrentState(), options);
+
+		SurgSim::Framework::Timer timer;
+		timer.setMaxNumberOfFrames(frameCount);
+		for (int i = 0; i < frameCount; i++)
+		{
+			timer.beginFrame();
+			fem->updateFMDK(*fem->getCurrentState(), options);
+			timer.endFrame();
+		}
+		return timer.getCumulativeTime();
+	}
+
 protected:
 	std::shared_ptr<SurgSim::Testing::MockPhysicsManager> m_physicsManager;
 	std::shared_ptr<SurgSim::Framework::Runtime> m_runtime;
@@ -167,6 +189,38 @@ class IntegrationSchemeAndCountParamTest
 {
 };
 
+class AssemblyThreadCountParamTest : public Fem3DPerformanceTestBase, public ::testing::WithParamInterface<size_t>
+{
+};
+
+class ElementBatchingParamTest : public Fem3DPerformanceTestBase,
+	public ::testing::WithParamInterface<std::tuple<SurgSim::Math::IntegrationScheme, bool>>
+{
+};
+
+TEST_P(AssemblyThreadCountParamTest, CubeAssemblyTest)
+{
+	const int numCubes = 8;
+	const size_t numThreads = GetParam();
+	RecordProperty("CubeDivisions", boost::to_string(numCubes));
+	RecordProperty("NumThreads", boost::to_string(numThreads));
+
+	auto fem = std::make_shared<DivisibleCubeRepresentation>("cube", numCubes);
+	fem->setIntegrationScheme(SurgSim::Math::INTEGRATIONSCHEME_EULER_IMPLICIT);
+	initializeRepresentation(fem);
+
+	fem->setParallelAssembly(false);
+	double serialDuration = timeAssembly(fem);
+
+	fem->setParallelAssembly(true);
+	fem->setAssemblyThreadPool(std::make_shared<SurgSim::Framework::ThreadPool>(numThreads));
+	double parallelDuration = timeAssembly(fem);
+
+	RecordProperty("SerialDuration", boost::to_string(serialDuration));
+	RecordProperty("Duration", boost::to_string(parallelDuration));
+	RecordProperty("Speedup", boost::to_string(serialDuration / parallelDuration));
+}
+
 TEST_P(IntegrationSchemeParamTest, WoundTest)
 {
 	SurgSim::Math::IntegrationScheme integrationScheme;
@@ -208,6 +262,46 @@ TEST_P(IntegrationSchemeAndCountParamTest, CubeTest)
 	performTimingTest();
 }
 
+TEST_P(ElementBatchingParamTest, WoundTest)
+{
+	SurgSim::Math::IntegrationScheme integrationScheme;
+	bool elementBatching;
+	std::tie(integrationScheme, elementBatching) = GetParam();
+	RecordProperty("IntegrationScheme", IntegrationSchemeNames[integrationScheme]);
+	RecordProperty("ElementBatching", boost::to_string(elementBatching));
+
+	// Only the corotational tetrahedra are updated by batches
+	auto fem = std::make_shared<SurgSim::Physics::Fem3DRepresentation>("wound");
+	fem->setFemElementType(Fem3DElementCorotationalTetrahedron().getClassName());
+	fem->loadFem("Geometry/wound_deformable.ply");
+	fem->setIntegrationScheme(integrationScheme);
+	fem->setElementBatching(elementBatching);
+
+	initializeRepresentation(fem);
+	RecordProperty("AssemblyDuration", boost::to_string(timeAssembly(fem)));
+	performTimingTest();
+}
+
+TEST_P(ElementBatchingParamTest, CubeTest)
+{
+	const int numCubes = 8;
+	SurgSim::Math::IntegrationScheme integrationScheme;
+	bool elementBatching;
+	std::tie(integrationScheme, elementBatching) = GetParam();
+	RecordProperty("IntegrationScheme", IntegrationSchemeNames[integrationScheme]);
+	RecordProperty("CubeDivisions", boost::to_string(numCubes));
+	RecordProperty("ElementBatching", boost::to_string(elementBatching));
+
+	auto fem = std::make_shared<DivisibleCubeRepresentation>("cube", numCubes, true);
+	std::const_pointer_cast<SurgSim::Math::OdeState>(fem->getInitialState())->addBoundaryCondition(0);
+	fem->setIntegrationScheme(integrationScheme);
+	fem->setElementBatching(elementBatching);
+
+	initializeRepresentation(fem);
+	RecordProperty("AssemblyDuration", boost::to_string(timeAssembly(fem)));
+	performTimingTest();
+}
+
 INSTANTIATE_TEST_CASE_P(Fem3DPerformanceTest,
 						IntegrationSchemeParamTest,
 						::testing::Combine(::testing::Values(SurgSim::Math::INTEGRATIONSCHEME_EULER_EXPLICIT,
@@ -221,7 +315,8 @@ INSTANTIATE_TEST_CASE_P(Fem3DPerformanceTest,
 								SurgSim::Math::INTEGRATIONSCHEME_RUNGE_KUTTA_4,
 								SurgSim::Math::INTEGRATIONSCHEME_LINEAR_RUNGE_KUTTA_4),
 								::testing::Values(SurgSim::Math::LINEARSOLVER_LU,
-										SurgSim::Math::LINEARSOLVER_CONJUGATEGRADIENT)));
+										SurgSim::Math::LINEARSOLVER_CONJUGATEGRADIENT,
+										SurgSim::Math::LINEARSOLVER_LDLT)));
 
 INSTANTIATE_TEST_CASE_P(
 	Fem3DPerformanceTest,
@@ -237,8 +332,19 @@ INSTANTIATE_TEST_CASE_P(
 					   SurgSim::Math::INTEGRATIONSCHEME_RUNGE_KUTTA_4,
 					   SurgSim::Math::INTEGRATIONSCHEME_LINEAR_RUNGE_KUTTA_4),
 					   ::testing::Values(SurgSim::Math::LINEARSOLVER_LU,
-							   SurgSim::Math::LINEARSOLVER_CONJUGATEGRADIENT),
+							   SurgSim::Math::LINEARSOLVER_CONJUGATEGRADIENT,
+							   SurgSim::Math::LINEARSOLVER_LDLT),
 					   ::testing::Values(2, 3, 4, 5, 6, 7, 8)));
 
+INSTANTIATE_TEST_CASE_P(Fem3DPerformanceTest,
+						AssemblyThreadCountParamTest,
+						::testing::Values(1u, 2u, 4u, 8u));
+
+INSTANTIATE_TEST_CASE_P(Fem3DPerformanceTest,
+						ElementBatchingParamTest,
+						::testing::Combine(::testing::Values(SurgSim::Math::INTEGRATIONSCHEME_EULER_EXPLICIT,
+								SurgSim::Math::INTEGRATIONSCHEME_EULER_IMPLICIT),
+								::testing::Bool()));
+
 } // namespace Physics
 } // namespace SurgSim
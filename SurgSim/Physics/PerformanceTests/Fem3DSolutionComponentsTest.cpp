@@ -69,6 +69,7 @@ static std::unordered_map<SurgSim::Math::LinearSolver, std::string, std::hash<in
 #define FEM3DSOLUTIONCOMPONENTSTEST_MAP_NAME(map, name) (map)[name] = #name
 	FEM3DSOLUTIONCOMPONENTSTEST_MAP_NAME(result, SurgSim::Math::LINEARSOLVER_LU);
 	FEM3DSOLUTIONCOMPONENTSTEST_MAP_NAME(result, SurgSim::Math::LINEARSOLVER_CONJUGATEGRADIENT);
+	FEM3DSOLUTIONCOMPONENTSTEST_MAP_NAME(result, SurgSim::Math::LINEARSOLVER_LDLT);
 #undef FEM3DSOLUTIONCOMPONENTSTEST_MAP_NAME
 
 	return result;
@@ -328,7 +329,8 @@ INSTANTIATE_TEST_CASE_P(
 					   SurgSim::Math::INTEGRATIONSCHEME_RUNGE_KUTTA_4,
 					   SurgSim::Math::INTEGRATIONSCHEME_LINEAR_RUNGE_KUTTA_4),
 					   ::testing::Values(SurgSim::Math::LINEARSOLVER_LU,
-							   SurgSim::Math::LINEARSOLVER_CONJUGATEGRADIENT),
+							   SurgSim::Math::LINEARSOLVER_CONJUGATEGRADIENT,
+							   SurgSim::Math::LINEARSOLVER_LDLT),
 					   ::testing::Values(2, 3, 4, 5, 6, 7, 8)));
 
 } // namespace Physics
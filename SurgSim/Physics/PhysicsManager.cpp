@@ -42,7 +42,8 @@ namespace Physics
 {
 
 PhysicsManager::PhysicsManager() :
-	ComponentManager("Physics Manager")
+	ComponentManager("Physics Manager"),
+	m_contactArena(std::make_shared<Collision::ContactArena>())
 {
 	setRate(1000.0);
 }
@@ -121,6 +122,7 @@ bool PhysicsManager::doUpdate(double dt)
 	state->setContactFilters(m_contactFilters);
 	state->setParticleRepresentations(m_particleRepresentations);
 	state->setConstraintComponents(m_constraintComponents);
+	state->setContactArena(m_contactArena);
 
 	for (const auto& computation : m_computations)
 	{
@@ -115,6 +115,9 @@ class PhysicsManager : public SurgSim::Framework::ComponentManager
 	/// A list of computations, to perform the physics update.
 	std::vector<std::shared_ptr<SurgSim::Physics::Computation>> m_computations;
 
+	/// The storage of the contacts, handed to the physics state of every update
+	std::shared_ptr<Collision::ContactArena> m_contactArena;
+
 	/// A thread-safe copy of the last PhysicsManagerState in the previous update.
 	SurgSim::Framework::LockedContainer<SurgSim::Physics::PhysicsManagerState> m_finalState;
 };
@@ -237,6 +237,26 @@ void PhysicsManagerState::setConstraintsMapping(const MlcpMapping<Constraint>& c
 	m_constraintsIndexMapping = constraintsMapping;
 }
 
+const std::vector<MlcpIsland>& PhysicsManagerState::getMlcpIslands() const
+{
+	return m_mlcpIslands;
+}
+
+void PhysicsManagerState::setMlcpIslands(const std::vector<MlcpIsland>& islands)
+{
+	m_mlcpIslands = islands;
+}
+
+void PhysicsManagerState::setContactArena(const std::shared_ptr<SurgSim::Collision::ContactArena>& arena)
+{
+	m_contactArena = arena;
+}
+
+const std::shared_ptr<SurgSim::Collision::ContactArena>& PhysicsManagerState::getContactArena() const
+{
+	return m_contactArena;
+}
+
 void PhysicsManagerState::setTimeOfImpact(double timeOfImpact)
 {
 	m_timeOfImpact = timeOfImpact;
@@ -21,10 +21,12 @@
 #include <unordered_map>
 
 #include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/ContactArena.h"
 #include "SurgSim/Collision/ContactFilter.h"
 #include "SurgSim/Collision/Representation.h"
 #include "SurgSim/Particles/Representation.h"
 #include "SurgSim/Physics/Constraint.h"
+#include "SurgSim/Physics/MlcpIsland.h"
 #include "SurgSim/Physics/MlcpMapping.h"
 #include "SurgSim/Physics/MlcpPhysicsProblem.h"
 #include "SurgSim/Physics/MlcpPhysicsSolution.h"
@@ -184,6 +186,22 @@ class PhysicsManagerState
 	/// \param constraintsMapping The constraints mapping (mapping between the constraints and the mlcp)
 	void setConstraintsMapping(const MlcpMapping<Constraint>& constraintsMapping);
 
+	/// Gets the islands of the Mlcp problem
+	/// \return The independent groups of constraints in the Mlcp problem, empty if they were not computed
+	const std::vector<MlcpIsland>& getMlcpIslands() const;
+
+	/// Set the islands of the Mlcp problem
+	/// \param islands The independent groups of constraints, each one stored contiguously in the Mlcp problem
+	void setMlcpIslands(const std::vector<MlcpIsland>& islands);
+
+	/// Set the arena that the contacts of the collision pairs are made in, it is meant to be kept from one update to
+	/// the next so that the contacts are not allocated at steady state
+	/// \param arena The contact arena
+	void setContactArena(const std::shared_ptr<SurgSim::Collision::ContactArena>& arena);
+
+	/// \return The arena that the contacts of the collision pairs are made in, nullptr if there is none
+	const std::shared_ptr<SurgSim::Collision::ContactArena>& getContactArena() const;
+
 	/// Set the time of impact
 	/// \param timeOfImpact the time of impact for CCD
 	void setTimeOfImpact(double timeOfImpact);
@@ -247,6 +265,12 @@ class PhysicsManagerState
 	/// Constraints mapping
 	MlcpMapping<Constraint> m_constraintsIndexMapping;
 
+	/// Independent groups of constraints in the Mlcp problem
+	std::vector<MlcpIsland> m_mlcpIslands;
+
+	/// Storage of the contacts of the collision pairs, shared by the copies of the state
+	std::shared_ptr<SurgSim::Collision::ContactArena> m_contactArena;
+
 	///@}
 	/// Mlcp problem for this Physics Manager State
 	MlcpPhysicsProblem m_mlcpPhysicsProblem;
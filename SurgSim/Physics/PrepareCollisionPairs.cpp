@@ -13,9 +13,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/ContactArena.h"
+#include "SurgSim/Collision/ContactCache.h"
+#include "SurgSim/Collision/ContactCalculation.h"
 #include "SurgSim/Collision/Representation.h"
 #include "SurgSim/Framework/Log.h"
 #include "SurgSim/Physics/PhysicsManagerState.h"
@@ -30,7 +35,8 @@ namespace Physics
 PrepareCollisionPairs::PrepareCollisionPairs(bool doCopyState) :
 	Computation(doCopyState),
 	m_timeSinceLog(0.0),
-	m_logger(Framework::Logger::getLogger("Physics/PrepareCollisionPairs"))
+	m_logger(Framework::Logger::getLogger("Physics/PrepareCollisionPairs")),
+	m_frame(0)
 {
 }
 
@@ -47,23 +53,106 @@ std::shared_ptr<PhysicsManagerState> PrepareCollisionPairs::doUpdate(
 
 	std::vector<std::shared_ptr<Collision::CollisionPair>> pairs;
 
-	auto end = std::end(representations);
-	for (auto first = std::begin(representations); first != end; ++first)
+	m_broadPhase.update(representations);
+	const auto& candidates = m_broadPhase.getOverlappingPairs();
+
+	// The candidates are sorted by their first index, this keeps the order of the pairs the same as the one of
+	// the representations, with the self collision pair of each representation first
+	auto candidate = std::begin(candidates);
+	for (size_t index = 0; index < representations.size(); ++index)
 	{
-		for (auto second = first; second != end; ++second)
+		const auto& first = representations[index];
+		if (first->getSelfCollisionDetectionType() != Collision::COLLISION_DETECTION_TYPE_NONE &&
+			!first->isIgnoring(first))
 		{
-			if (!(*first)->isIgnoring(*second) && !(*second)->isIgnoring(*first))
-			{
-				auto pair = std::make_shared<Collision::CollisionPair>(*first, *second);
+			pairs.push_back(std::make_shared<Collision::CollisionPair>(first, first));
+		}
 
-				if (pair->getType() != Collision::COLLISION_DETECTION_TYPE_NONE && pair->mayIntersect())
-				{
-					pairs.push_back(pair);
-				}
+		for (; candidate != std::end(candidates) && candidate->first == index; ++candidate)
+		{
+			const auto& second = representations[candidate->second];
+			if (first->getCollisionDetectionType() != Collision::COLLISION_DETECTION_TYPE_NONE &&
+				second->getCollisionDetectionType() != Collision::COLLISION_DETECTION_TYPE_NONE &&
+				!first->isIgnoring(second) && !second->isIgnoring(first))
+			{
+				pairs.push_back(std::make_shared<Collision::CollisionPair>(first, second));
 			}
 		}
 	}
 
+	// Hand over the caches from the previous frame, the representations are kept in a fixed order so that the
+	// cache is found even if the order of the pair changes
+	++m_frame;
+	for (const auto& pair : pairs)
+	{
+		RepresentationPairType key(pair->getFirst(), pair->getSecond());
+		if (key.second < key.first)
+		{
+			std::swap(key.first, key.second);
+		}
+		auto& cachedPair = m_contactCaches[key];
+		if (cachedPair.cache == nullptr)
+		{
+			cachedPair.cache = std::make_shared<Collision::ContactCache>();
+		}
+		cachedPair.frame = m_frame;
+		pair->setContactCache(cachedPair.cache);
+	}
+	for (auto cachedPair = m_contactCaches.begin(); cachedPair != m_contactCaches.end();)
+	{
+		if (cachedPair->second.frame != m_frame)
+		{
+			cachedPair = m_contactCaches.erase(cachedPair);
+		}
+		else
+		{
+			++cachedPair;
+		}
+	}
+
+	// Resolve the contact calculation of each pair and pose the shapes of the discrete pairs, once per
+	// representation, the narrow phase then neither looks up the tables nor locks the representations
+	const auto& dcdCalculations = Collision::ContactCalculation::getDcdContactTable();
+	const auto& ccdCalculations = Collision::ContactCalculation::getCcdContactTable();
+	std::unordered_map<Collision::Representation*, Math::PosedShape<std::shared_ptr<Math::Shape>>> posedShapes;
+	auto getPosedShape = [&posedShapes](const std::shared_ptr<Collision::Representation>& representation)
+	{
+		auto posedShape = posedShapes.find(representation.get());
+		if (posedShape == posedShapes.end())
+		{
+			posedShape = posedShapes.emplace(representation.get(), Math::PosedShape<std::shared_ptr<Math::Shape>>(
+												 representation->getPosedShape(), representation->getPose())).first;
+		}
+		return posedShape->second;
+	};
+	for (const auto& pair : pairs)
+	{
+		const int firstType = pair->getFirst()->getShapeType();
+		const int secondType = pair->getSecond()->getShapeType();
+		if (pair->getType() == Collision::COLLISION_DETECTION_TYPE_DISCRETE)
+		{
+			pair->setContactCalculation(dcdCalculations[firstType][secondType]);
+			pair->setPosedShapes(getPosedShape(pair->getFirst()), getPosedShape(pair->getSecond()));
+		}
+		else if (pair->getType() == Collision::COLLISION_DETECTION_TYPE_CONTINUOUS)
+		{
+			pair->setContactCalculation(ccdCalculations[firstType][secondType]);
+		}
+	}
+
+	// Each pair makes its contacts in its own slot of the contact arena, the contacts of the previous frame are
+	// released to the arena
+	if (result->getContactArena() == nullptr)
+	{
+		result->setContactArena(std::make_shared<Collision::ContactArena>());
+	}
+	const auto& contactArena = result->getContactArena();
+	contactArena->reset(pairs.size());
+	for (size_t i = 0; i < pairs.size(); ++i)
+	{
+		pairs[i]->setContactArena(contactArena, i);
+	}
+
 	result->setCollisionPairs(pairs);
 
 	if (m_logger->getThreshold() <= SURGSIM_LOG_LEVEL(DEBUG))
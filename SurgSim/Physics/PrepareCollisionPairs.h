@@ -16,8 +16,11 @@
 #ifndef SURGSIM_PHYSICS_PREPARECOLLISIONPAIRS_H
 #define SURGSIM_PHYSICS_PREPARECOLLISIONPAIRS_H
 
+#include <map>
 #include <memory>
+#include <utility>
 
+#include "SurgSim/Collision/SweepAndPrune.h"
 #include "SurgSim/Framework/Macros.h"
 #include "SurgSim/Physics/Computation.h"
 
@@ -26,7 +29,9 @@ namespace SurgSim
 
 namespace Collision
 {
+class ContactCache;
 class ContactCalculation;
+class Representation;
 }
 
 namespace Framework
@@ -44,6 +49,15 @@ class PhysicsManagerState;
 /// function objects (ContactCalculation) to determine how to calculate a contact between the two
 /// members of each pair, if no specific function exists a default function will be used.
 /// will update the collision pairs accordingly.
+/// Only pairs whose bounding boxes overlap are generated, these are found by a sweep and prune broad phase
+/// that is kept between frames, the ignore/allow filters are applied to the overlapping pairs only.
+/// Each pair gets the Collision::ContactCache of the same two representations in the previous frame, the caches of
+/// pairs that are not generated anymore are dropped. The caches are kept in a persistent container, a steady set of
+/// pairs does not allocate anything for them.
+/// The contact calculation of each pair is resolved here, the shapes of the discrete pairs are posed once per
+/// representation and handed to the pairs, so that the narrow phase does not pose the shapes concurrently.
+/// The contact arena of the physics state is reset here, each pair gets its own slot of it for its contacts, a state
+/// without an arena gets a new one.
 /// \note When a new ContactCalculation type gets implemented, the type needs to be registered with the table
 /// inside of ContactCalculation
 class PrepareCollisionPairs : public Computation
@@ -68,6 +82,26 @@ class PrepareCollisionPairs : public Computation
 
 	/// The logger.
 	std::shared_ptr<Framework::Logger> m_logger;
+
+	/// The broad phase, keeps the sorted bounding boxes of the representations from frame to frame
+	Collision::SweepAndPrune m_broadPhase;
+
+	/// Representations of a pair, holding them keeps their addresses from being reused while a cache refers to them
+	typedef std::pair<std::shared_ptr<Collision::Representation>, std::shared_ptr<Collision::Representation>>
+		RepresentationPairType;
+
+	/// The contact cache of a pair, and the last frame in which the pair was generated
+	struct CachedPair
+	{
+		std::shared_ptr<Collision::ContactCache> cache;
+		size_t frame;
+	};
+
+	/// The contact caches of the pairs, updated in place, only the pairs that appear or disappear change the map
+	std::map<RepresentationPairType, CachedPair> m_contactCaches;
+
+	/// The number of frames, used to find the pairs that were not generated in the current frame
+	size_t m_frame;
 };
 
 }; // Physics
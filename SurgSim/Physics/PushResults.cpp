@@ -60,7 +60,6 @@ PushResults::doUpdate(const double& dt, const std::shared_ptr<PhysicsManagerStat
 
 	if (m_discardBadResults)
 	{
-		const SurgSim::Math::MlcpProblem::Matrix& A = problem.A;
 		const SurgSim::Math::MlcpProblem::Vector& b = problem.b;
 		auto& activeConstraints = result->getActiveConstraints();
 		auto& constraintsMapping = result->getConstraintsMapping();
@@ -71,7 +70,8 @@ PushResults::doUpdate(const double& dt, const std::shared_ptr<PhysicsManagerStat
 				constraint->getType() == SurgSim::Physics::FRICTIONAL_3DCONTACT)
 			{
 				const auto index = constraintsMapping.getValue(constraint.get());
-				const double violation = b[index] + A.row(index) * lambda;
+				const double violation = b[index] + (problem.isSparse() ?
+					problem.sparseA.row(index).dot(lambda) : problem.A.row(index).dot(lambda));
 				// Enforce orthogonality condition
 				if (!SurgSim::Math::isValid(violation) || violation < -m_contactTolerance ||
 					(lambda[index] > solution.epsilonConvergence &&
@@ -96,7 +96,9 @@ PushResults::doUpdate(const double& dt, const std::shared_ptr<PhysicsManagerStat
 		dofCorrection = CHt * lambda;
 
 		SURGSIM_LOG_DEBUG(m_logger) << "b:\t" << problem.b.transpose();
-		SURGSIM_LOG_DEBUG(m_logger) << "final:\t" << (problem.A * lambda + problem.b).transpose();
+		SURGSIM_LOG_DEBUG(m_logger) << "final:\t" << (problem.isSparse() ?
+			Math::MlcpProblem::Vector(problem.sparseA * lambda + problem.b) :
+			Math::MlcpProblem::Vector(problem.A * lambda + problem.b)).transpose();
 		SURGSIM_LOG_DEBUG(m_logger) << "Lambda:\t" << lambda.transpose();
 
 		auto& representations = result->getActiveRepresentations();
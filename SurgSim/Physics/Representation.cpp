@@ -94,6 +94,12 @@ std::shared_ptr<Localization> Representation::createLocalization(const SurgSim::
 	return nullptr;
 }
 
+bool Representation::updateLocalization(const SurgSim::DataStructures::Location& location,
+										Localization* localization)
+{
+	return false;
+}
+
 void Representation::applyCorrection(double dt, const Eigen::VectorBlock<SurgSim::Math::Vector>& deltaVelocity)
 {
 }
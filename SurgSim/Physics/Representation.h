@@ -104,6 +104,14 @@ class Representation : public SurgSim::Framework::Representation
 	/// \return A localization object for the given location.
 	virtual std::shared_ptr<Localization> createLocalization(const SurgSim::DataStructures::Location& location);
 
+	/// Moves a localization previously created by createLocalization() to a new location, so that it can be reused
+	/// instead of creating a new one.
+	/// \param location A location in 3d space.
+	/// \param [in,out] localization A localization of this representation.
+	/// \return True if the localization now refers to location, False if a new localization needs to be created.
+	/// \note The default implementation always returns False.
+	virtual bool updateLocalization(const SurgSim::DataStructures::Location& location, Localization* localization);
+
 	/// Update the Representation's current position and velocity using a time interval, dt, and change in velocity,
 	/// deltaVelocity.
 	///
@@ -123,6 +123,19 @@ std::shared_ptr<Localization> RigidRepresentationBase::createLocalization(
 	return std::move(createTypedLocalization<RigidLocalization>(location));
 }
 
+bool RigidRepresentationBase::updateLocalization(const SurgSim::DataStructures::Location& location,
+		Localization* localization)
+{
+	auto rigidLocalization = dynamic_cast<RigidLocalization*>(localization);
+	if (rigidLocalization == nullptr || !location.rigidLocalPosition.hasValue())
+	{
+		return false;
+	}
+
+	rigidLocalization->setLocalPosition(location.rigidLocalPosition.getValue());
+	return true;
+}
+
 void RigidRepresentationBase::setDensity(double rho)
 {
 	m_rho = rho;
@@ -64,6 +64,8 @@ class RigidRepresentationBase : public Representation
 
 	std::shared_ptr<Localization> createLocalization(const SurgSim::DataStructures::Location& location) override;
 
+	bool updateLocalization(const SurgSim::DataStructures::Location& location, Localization* localization) override;
+
 	/// Set the mass density of the rigid representation
 	/// \param rho The density (in Kg.m-3)
 	void setDensity(double rho);
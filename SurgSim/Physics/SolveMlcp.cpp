@@ -15,18 +15,54 @@
 
 #include "SurgSim/Physics/SolveMlcp.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "SurgSim/Framework/Log.h"
+#include "SurgSim/Framework/Runtime.h"
+#include "SurgSim/Framework/ThreadPool.h"
 #include "SurgSim/Physics/Constraint.h"
 #include "SurgSim/Physics/ContactConstraintData.h"
+#include "SurgSim/Physics/Localization.h"
 #include "SurgSim/Physics/PhysicsManagerState.h"
+#include "SurgSim/Physics/Representation.h"
 
 namespace SurgSim
 {
 namespace Physics
 {
 
-SolveMlcp::SolveMlcp(bool doCopyState) : Computation(doCopyState)
+namespace
+{
+
+/// \return The index of the element (triangle, element or node) of a location, or the maximum size_t if the location
+/// 		does not refer to a mesh element
+size_t getElementIndex(const DataStructures::Location& location)
 {
+	if (location.triangleMeshLocalCoordinate.hasValue())
+	{
+		return location.triangleMeshLocalCoordinate.getValue().index;
+	}
+	if (location.elementMeshLocalCoordinate.hasValue())
+	{
+		return location.elementMeshLocalCoordinate.getValue().index;
+	}
+	if (location.index.hasValue())
+	{
+		return location.index.getValue();
+	}
+	return std::numeric_limits<size_t>::max();
+}
+
+};
+
+SolveMlcp::SolveMlcp(bool doCopyState) :
+	Computation(doCopyState),
+	m_useIslands(true),
+	m_useWarmStart(false),
+	m_measureWarmStart(false)
+{
+	resetStatistics();
 }
 
 SolveMlcp::~SolveMlcp()
@@ -37,11 +73,43 @@ std::shared_ptr<PhysicsManagerState> SolveMlcp::doUpdate(const double& dt,
 {
 	std::shared_ptr<PhysicsManagerState> result = state;
 
-	// Solve the Mlcp using a Gauss-Seidel solver
-	m_gaussSeidelSolver.solve(result->getMlcpProblem(), &(result->getMlcpSolution()));
+	auto& solution = result->getMlcpSolution();
+	size_t numWarmStarted = 0;
+	bool measureWarmStart = false;
+	size_t coldIterations = 0;
+	if (m_useWarmStart)
+	{
+		computeConstraintKeys(result);
+		measureWarmStart = m_measureWarmStart && !m_savedImpulses.empty();
+		if (measureWarmStart)
+		{
+			m_initialGuess = solution.x;
+			solve(result);
+			coldIterations = solution.numIterations;
+			solution.x = m_initialGuess;
+		}
+		numWarmStarted = warmStart(result);
+	}
+
+	solve(result);
+
+	if (m_useWarmStart)
+	{
+		saveImpulses(result);
+	}
+	if (measureWarmStart)
+	{
+		m_statistics.numIterationsSaved +=
+			static_cast<ptrdiff_t>(coldIterations) - static_cast<ptrdiff_t>(solution.numIterations);
+	}
+
+	m_statistics.numSolves++;
+	m_statistics.numIterations += solution.numIterations;
+	m_statistics.numConstraints += result->getActiveConstraints().size();
+	m_statistics.numWarmStartedConstraints += numWarmStarted;
 
 	// lambda
-	const Eigen::VectorXd& lambda = result->getMlcpSolution().x;
+	const Eigen::VectorXd& lambda = solution.x;
 	if (lambda.size() == 0)
 	{
 		return result;
@@ -102,5 +170,273 @@ double SolveMlcp::getContactTolerance() const
 	return m_gaussSeidelSolver.getContactTolerance();
 }
 
+void SolveMlcp::setUseIslands(bool useIslands)
+{
+	m_useIslands = useIslands;
+}
+
+bool SolveMlcp::isUsingIslands() const
+{
+	return m_useIslands;
+}
+
+void SolveMlcp::setUseSparseMatrix(bool useSparseMatrix)
+{
+	m_gaussSeidelSolver.setUseSparseMatrix(useSparseMatrix);
+}
+
+bool SolveMlcp::isUsingSparseMatrix() const
+{
+	return m_gaussSeidelSolver.isUsingSparseMatrix();
+}
+
+void SolveMlcp::setUseWarmStart(bool useWarmStart)
+{
+	m_useWarmStart = useWarmStart;
+	if (!m_useWarmStart)
+	{
+		m_savedImpulses.clear();
+		m_impulses.clear();
+	}
+}
+
+bool SolveMlcp::isUsingWarmStart() const
+{
+	return m_useWarmStart;
+}
+
+void SolveMlcp::setMeasureWarmStart(bool measureWarmStart)
+{
+	m_measureWarmStart = measureWarmStart;
+}
+
+bool SolveMlcp::isMeasuringWarmStart() const
+{
+	return m_measureWarmStart;
+}
+
+const SolveMlcp::Statistics& SolveMlcp::getStatistics() const
+{
+	return m_statistics;
+}
+
+void SolveMlcp::resetStatistics()
+{
+	m_statistics.numSolves = 0;
+	m_statistics.numIterations = 0;
+	m_statistics.numConstraints = 0;
+	m_statistics.numWarmStartedConstraints = 0;
+	m_statistics.numIterationsSaved = 0;
+}
+
+void SolveMlcp::computeConstraintKeys(const std::shared_ptr<PhysicsManagerState>& state)
+{
+	const auto& activeConstraints = state->getActiveConstraints();
+	m_constraintKeys.clear();
+	m_constraintKeys.reserve(activeConstraints.size());
+
+	for (const auto& constraint : activeConstraints)
+	{
+		auto contactConstraintData = std::dynamic_pointer_cast<ContactConstraintData>(constraint->getData());
+		if (contactConstraintData == nullptr || contactConstraintData->getContact() == nullptr)
+		{
+			m_constraintKeys.emplace_back(constraint.get(), nullptr, nullptr, 0, 0, 0);
+		}
+		else
+		{
+			// Contact constraints are generated again every frame
+			const auto& locations = contactConstraintData->getContact()->penetrationPoints;
+			ConstraintKey key(nullptr,
+							  constraint->getLocalizations().first->getRepresentation().get(),
+							  constraint->getLocalizations().second->getRepresentation().get(),
+							  getElementIndex(locations.first), getElementIndex(locations.second), 0);
+			m_constraintKeys.push_back(key);
+		}
+	}
+
+	// Contacts with the same representations and elements end up next to each other in the sorted keys, they are
+	// numbered in the order of the active constraints
+	m_sortedConstraintKeys.resize(m_constraintKeys.size());
+	for (size_t i = 0; i < m_sortedConstraintKeys.size(); ++i)
+	{
+		m_sortedConstraintKeys[i] = i;
+	}
+	std::sort(m_sortedConstraintKeys.begin(), m_sortedConstraintKeys.end(), [this](size_t i, size_t j)
+	{
+		return m_constraintKeys[i] < m_constraintKeys[j] || (m_constraintKeys[i] == m_constraintKeys[j] && i < j);
+	});
+	for (size_t i = 1; i < m_sortedConstraintKeys.size(); ++i)
+	{
+		ConstraintKey& key = m_constraintKeys[m_sortedConstraintKeys[i]];
+		ConstraintKey previous = m_constraintKeys[m_sortedConstraintKeys[i - 1]];
+		const size_t previousOccurrence = std::get<5>(previous);
+		std::get<5>(previous) = 0;
+		if (key == previous)
+		{
+			std::get<5>(key) = previousOccurrence + 1;
+		}
+	}
+}
+
+size_t SolveMlcp::warmStart(const std::shared_ptr<PhysicsManagerState>& state)
+{
+	size_t numWarmStarted = 0;
+	if (m_savedImpulses.empty())
+	{
+		return numWarmStarted;
+	}
+
+	const auto& activeConstraints = state->getActiveConstraints();
+	const auto& constraintsMapping = state->getConstraintsMapping();
+	auto& x = state->getMlcpSolution().x;
+	SavedImpulse searched;
+	for (size_t i = 0; i < activeConstraints.size(); ++i)
+	{
+		searched.key = m_constraintKeys[i];
+		auto found = std::lower_bound(m_savedImpulses.begin(), m_savedImpulses.end(), searched);
+		const Eigen::Index numDof = static_cast<Eigen::Index>(activeConstraints[i]->getNumDof());
+		if (found != m_savedImpulses.end() && found->key == searched.key &&
+			static_cast<Eigen::Index>(found->numDof) == numDof)
+		{
+			ptrdiff_t index = constraintsMapping.getValue(activeConstraints[i].get());
+			SURGSIM_ASSERT(index >= 0) << "Index for constraint is invalid: " << index;
+			x.segment(index, numDof) = Eigen::Map<const Eigen::VectorXd>(&m_impulses[found->index], numDof);
+			++numWarmStarted;
+		}
+	}
+	return numWarmStarted;
+}
+
+void SolveMlcp::saveImpulses(const std::shared_ptr<PhysicsManagerState>& state)
+{
+	const auto& activeConstraints = state->getActiveConstraints();
+	const auto& constraintsMapping = state->getConstraintsMapping();
+	const auto& x = state->getMlcpSolution().x;
+
+	// Constraints that did not persist are forgotten
+	m_savedImpulses.clear();
+	m_impulses.clear();
+	if (!x.allFinite())
+	{
+		return;
+	}
+	for (size_t i = 0; i < activeConstraints.size(); ++i)
+	{
+		ptrdiff_t index = constraintsMapping.getValue(activeConstraints[i].get());
+		SURGSIM_ASSERT(index >= 0) << "Index for constraint is invalid: " << index;
+		SavedImpulse saved;
+		saved.key = m_constraintKeys[i];
+		saved.index = m_impulses.size();
+		saved.numDof = activeConstraints[i]->getNumDof();
+		m_savedImpulses.push_back(saved);
+		m_impulses.insert(m_impulses.end(), x.data() + index, x.data() + index + saved.numDof);
+	}
+	std::sort(m_savedImpulses.begin(), m_savedImpulses.end());
+}
+
+void SolveMlcp::solve(const std::shared_ptr<PhysicsManagerState>& state)
+{
+	// Solve the Mlcp using a Gauss-Seidel solver
+	if (m_useIslands && state->getMlcpIslands().size() > 1)
+	{
+		solveIslands(state);
+	}
+	else
+	{
+		m_gaussSeidelSolver.solve(state->getMlcpProblem(), &(state->getMlcpSolution()));
+	}
+}
+
+void SolveMlcp::solveIslands(const std::shared_ptr<PhysicsManagerState>& state)
+{
+	const auto& islands = state->getMlcpIslands();
+	const auto& problem = state->getMlcpProblem();
+	auto& solution = state->getMlcpSolution();
+	const size_t numIslands = islands.size();
+
+	while (m_islandSolvers.size() < numIslands)
+	{
+		m_islandSolvers.emplace_back(new Math::MlcpGaussSeidelSolver());
+	}
+	m_islandProblems.resize(numIslands);
+	m_islandSolutions.resize(numIslands);
+
+	for (size_t i = 0; i < numIslands; ++i)
+	{
+		auto& solver = *m_islandSolvers[i];
+		solver.setMaxIterations(m_gaussSeidelSolver.getMaxIterations());
+		solver.setEpsilonConvergence(m_gaussSeidelSolver.getEpsilonConvergence());
+		solver.setContactTolerance(m_gaussSeidelSolver.getContactTolerance());
+		solver.setUseSparseMatrix(m_gaussSeidelSolver.isUsingSparseMatrix());
+	}
+
+	Framework::Runtime::getThreadPool()->parallelFor(0, numIslands, 1, [this, &islands, &problem, &solution](size_t i)
+	{
+		const MlcpIsland& island = islands[i];
+		auto& islandProblem = m_islandProblems[i];
+		auto& islandSolution = m_islandSolutions[i];
+		const Eigen::Index start = static_cast<Eigen::Index>(island.atomicIndex);
+		const Eigen::Index size = static_cast<Eigen::Index>(island.numAtomicConstraints);
+
+		// The island is a diagonal block of the Mlcp, all the other entries of its rows are zero. With several
+		// islands, BuildMlcp stores the blocks in the sparse matrix, the dense solver gets its island as a dense block.
+		if (problem.isSparse() && m_islandSolvers[i]->isUsingSparseMatrix())
+		{
+			islandProblem.A.resize(0, 0);
+			islandProblem.sparseA = problem.sparseA.block(start, start, size, size);
+		}
+		else if (problem.isSparse())
+		{
+			islandProblem.A = problem.sparseA.block(start, start, size, size).toDense();
+			islandProblem.sparseA.resize(0, 0);
+		}
+		else
+		{
+			islandProblem.A = problem.A.block(start, start, size, size);
+		}
+		islandProblem.b = problem.b.segment(start, size);
+		islandProblem.mu = problem.mu.segment(start, size);
+		islandProblem.constraintTypes.assign(
+			problem.constraintTypes.begin() + island.constraintIndex,
+			problem.constraintTypes.begin() + island.constraintIndex + island.numConstraints);
+		islandSolution.x = solution.x.segment(start, size);
+
+		m_islandSolvers[i]->solve(islandProblem, &islandSolution);
+
+		solution.x.segment(start, size) = islandSolution.x;
+	});
+
+	// Gather the diagnostics, the overall criteria are the ones of the worst island, the criteria per constraint
+	// type are sums over the constraints so the islands add up
+	solution.numIterations = 0;
+	solution.maxIterations = m_gaussSeidelSolver.getMaxIterations();
+	solution.epsilonConvergence = m_gaussSeidelSolver.getEpsilonConvergence();
+	solution.contactTolerance = m_gaussSeidelSolver.getContactTolerance();
+	solution.validConvergence = true;
+	solution.validSignorini = true;
+	solution.convergenceCriteria = 0.0;
+	solution.initialConvergenceCriteria = 0.0;
+	for (size_t type = 0; type < Math::MLCP_NUM_CONSTRAINT_TYPES; ++type)
+	{
+		solution.constraintConvergenceCriteria[type] = 0.0;
+		solution.initialConstraintConvergenceCriteria[type] = 0.0;
+	}
+	for (const auto& islandSolution : m_islandSolutions)
+	{
+		solution.numIterations = std::max(solution.numIterations, islandSolution.numIterations);
+		solution.validConvergence = solution.validConvergence && islandSolution.validConvergence;
+		solution.validSignorini = solution.validSignorini && islandSolution.validSignorini;
+		solution.convergenceCriteria = std::max(solution.convergenceCriteria, islandSolution.convergenceCriteria);
+		solution.initialConvergenceCriteria =
+			std::max(solution.initialConvergenceCriteria, islandSolution.initialConvergenceCriteria);
+		for (size_t type = 0; type < Math::MLCP_NUM_CONSTRAINT_TYPES; ++type)
+		{
+			solution.constraintConvergenceCriteria[type] += islandSolution.constraintConvergenceCriteria[type];
+			solution.initialConstraintConvergenceCriteria[type] +=
+				islandSolution.initialConstraintConvergenceCriteria[type];
+		}
+	}
+}
+
 }; // Physics
 }; // SurgSim
@@ -17,9 +17,13 @@
 #define SURGSIM_PHYSICS_SOLVEMLCP_H
 
 #include <memory>
+#include <tuple>
+#include <vector>
 
 #include "SurgSim/Framework/Macros.h"
 #include "SurgSim/Math/MlcpGaussSeidelSolver.h"
+#include "SurgSim/Math/MlcpProblem.h"
+#include "SurgSim/Math/MlcpSolution.h"
 #include "SurgSim/Physics/Computation.h"
 
 namespace SurgSim
@@ -27,7 +31,14 @@ namespace SurgSim
 namespace Physics
 {
 
+class Constraint;
+class Representation;
+
 /// Solve the system Mixed Linear Complementarity Problem (Mlcp)
+/// If the PhysicsManagerState holds more than one island (see MlcpIsland), each island is solved as a separate
+/// smaller Mlcp, the islands are solved concurrently on the framework thread pool.
+/// The solver can be warm started with the impulses of the previous frame, constraints are matched from one frame
+/// to the next by their representations and the element indices of their contact points (see setUseWarmStart()).
 class SolveMlcp : public Computation
 {
 public:
@@ -64,6 +75,66 @@ class SolveMlcp : public Computation
 	/// \return The contact tolerance.
 	double getContactTolerance() const;
 
+	/// Set whether independent islands of constraints should be solved separately and in parallel
+	/// \param useIslands true to solve each island on its own, false to solve the whole Mlcp at once
+	void setUseIslands(bool useIslands);
+
+	/// \return true if independent islands of constraints are solved separately and in parallel
+	bool isUsingIslands() const;
+
+	/// Set whether the Gauss-Seidel iterations run on a sparse copy of the Mlcp matrix, this skips the zero blocks
+	/// between constraints that do not share a representation. Mlcps assembled as sparse matrices (see
+	/// BuildMlcp::setUseSparseMatrix()) are solved on their sparse matrix, without any copy, unless the islands are
+	/// solved separately with this set to false, each island being then copied to a dense matrix.
+	/// \param useSparseMatrix true to iterate on the sparse matrix, false to iterate on the dense matrix
+	void setUseSparseMatrix(bool useSparseMatrix);
+
+	/// \return true if the Gauss-Seidel iterations run on a sparse copy of the Mlcp matrix
+	bool isUsingSparseMatrix() const;
+
+	/// Set whether the solver starts from the impulses of the previous frame for the constraints that persist.
+	/// Contacts between a tool and tissue usually last for many frames, starting from their last impulse reduces the
+	/// number of iterations needed to converge.
+	/// \param useWarmStart true to warm start the solver, false to start from zero impulses (default)
+	/// \note The warm started solution stops on the same convergence criteria, but from a different initial guess,
+	/// 	so it can differ from the cold started one within the solver's tolerance.
+	void setUseWarmStart(bool useWarmStart);
+
+	/// \return true if the solver starts from the impulses of the previous frame
+	bool isUsingWarmStart() const;
+
+	/// Set whether the iterations saved by the warm start are measured (see Statistics::numIterationsSaved).
+	/// Each warm started Mlcp is first solved from zero impulses to count the iterations a cold start needs, this
+	/// doubles the cost of the solve and is meant to tune the maximum number of iterations.
+	/// \param measureWarmStart true to measure the iterations saved by the warm start, false otherwise (default)
+	void setMeasureWarmStart(bool measureWarmStart);
+
+	/// \return true if the iterations saved by the warm start are measured
+	bool isMeasuringWarmStart() const;
+
+	/// Statistics about the solves done by this computation, can be used to tune the maximum number of iterations
+	struct Statistics
+	{
+		/// Number of calls to the solver
+		size_t numSolves;
+		/// Total number of Gauss-Seidel iterations over all the solves
+		size_t numIterations;
+		/// Total number of constraints over all the solves
+		size_t numConstraints;
+		/// Total number of constraints that were warm started over all the solves
+		size_t numWarmStartedConstraints;
+		/// Total number of Gauss-Seidel iterations saved by the warm start over all the solves, i.e. the iterations
+		/// needed from zero impulses minus the iterations needed from the previous impulses. Only counted when
+		/// setMeasureWarmStart() is enabled, negative if the warm start slowed down the convergence.
+		ptrdiff_t numIterationsSaved;
+	};
+
+	/// \return The statistics accumulated since construction or the last call to resetStatistics()
+	const Statistics& getStatistics() const;
+
+	/// Reset the statistics
+	void resetStatistics();
+
 protected:
 
 	/// Override doUpdate from superclass
@@ -74,9 +145,83 @@ class SolveMlcp : public Computation
 		override;
 
 private:
+	/// Solve the Mlcp of the state, island by island if enabled
+	/// \param state The Physics manager state holding the problem and the solution
+	void solve(const std::shared_ptr<PhysicsManagerState>& state);
+
+	/// Solve each island of the Mlcp separately and gather the results in the state's Mlcp solution
+	/// \param state The Physics manager state holding the islands, the problem and the solution
+	void solveIslands(const std::shared_ptr<PhysicsManagerState>& state);
+
+	/// Identifies a constraint from one frame to the next. Constraints that are not regenerated every frame are
+	/// identified by their address. Contact constraints are identified by their physics representations, the element
+	/// indices of the contact points and an occurrence count to differentiate contacts with the same element indices.
+	typedef std::tuple<const Constraint*, const Representation*, const Representation*, size_t, size_t, size_t>
+		ConstraintKey;
+
+	/// Compute the keys of the active constraints of the state
+	/// \param state The Physics manager state
+	void computeConstraintKeys(const std::shared_ptr<PhysicsManagerState>& state);
+
+	/// Seed the Mlcp solution with the impulses of the previous frame
+	/// \param state The Physics manager state
+	/// \return The number of constraints that got their previous impulses
+	size_t warmStart(const std::shared_ptr<PhysicsManagerState>& state);
+
+	/// Keep the impulses of this frame for the next one
+	/// \param state The Physics manager state
+	void saveImpulses(const std::shared_ptr<PhysicsManagerState>& state);
 
 	/// The Gauss-Seidel Mlcp solver
 	SurgSim::Math::MlcpGaussSeidelSolver m_gaussSeidelSolver;
+
+	/// Whether islands are solved separately
+	bool m_useIslands;
+
+	///@{
+	/// Per island solvers, problems and solutions, kept to avoid reallocating them every frame
+	std::vector<std::unique_ptr<SurgSim::Math::MlcpGaussSeidelSolver>> m_islandSolvers;
+	std::vector<SurgSim::Math::MlcpProblem> m_islandProblems;
+	std::vector<SurgSim::Math::MlcpSolution> m_islandSolutions;
+	///@}
+
+	/// Whether the solver is warm started
+	bool m_useWarmStart;
+
+	/// Whether the iterations saved by the warm start are measured
+	bool m_measureWarmStart;
+
+	/// The keys of the active constraints of the current frame, in the same order
+	std::vector<ConstraintKey> m_constraintKeys;
+
+	/// The indices of m_constraintKeys sorted by key, used to number the contacts with the same elements
+	std::vector<size_t> m_sortedConstraintKeys;
+
+	/// The initial guess of the solution, kept while a cold start is measured
+	SurgSim::Math::MlcpSolution::Vector m_initialGuess;
+
+	/// A constraint of the previous frame, with the position and size of its impulse in m_impulses
+	struct SavedImpulse
+	{
+		ConstraintKey key;
+		size_t index;
+		size_t numDof;
+
+		bool operator<(const SavedImpulse& other) const
+		{
+			return key < other.key;
+		}
+	};
+
+	/// The constraints of the previous frame, sorted by key, and their impulses. Both are overwritten every frame,
+	/// keeping their storage.
+	///@{
+	std::vector<SavedImpulse> m_savedImpulses;
+	std::vector<double> m_impulses;
+	///@}
+
+	/// The statistics about the solves
+	Statistics m_statistics;
 };
 
 }; // Physics
@@ -419,5 +419,115 @@ TEST_F(BuildMlcpTests, TwoRepresentationsTwoConstraintsTest)
 			  m_physicsManagerState->getConstraintsMapping().getValue(m_usedConstraints[1].get()));
 }
 
+TEST_F(BuildMlcpTests, TwoIslandsTest)
+{
+	// Two rigid representations, each one constrained against the fixed world only
+	m_usedRepresentations.push_back(m_allRepresentations[0]);
+	m_usedRepresentations.push_back(m_allRepresentations[1]);
+	m_usedRepresentations.push_back(m_fixedWorldRepresentation);
+	m_physicsManagerState->setRepresentations(m_usedRepresentations);
+
+	// The constraints are interleaved, 0 and 2 act on the sphere, 1 on the box
+	for (size_t representationIndex : {0, 1, 0})
+	{
+		std::shared_ptr<ContactConstraintData> data = std::make_shared<ContactConstraintData>();
+		data->setPlaneEquation(SurgSim::Math::Vector3d(0.0, 1.0, 0.0), 0.0);
+
+		std::shared_ptr<Constraint> constraint = std::make_shared<Constraint>(FRICTIONLESS_3DCONTACT,
+			data, m_usedRepresentations[representationIndex],
+			SurgSim::DataStructures::Location(SurgSim::Math::Vector3d::Zero()),
+			m_fixedWorldRepresentation,
+			SurgSim::DataStructures::Location(SurgSim::Math::Vector3d::Zero()));
+		m_usedConstraints.push_back(constraint);
+	}
+	m_physicsManagerState->setConstraintGroup(CONSTRAINT_GROUP_TYPE_CONTACT, m_usedConstraints);
+
+	m_buildMlcpComputation->update(dt, m_physicsManagerState);
+	MlcpPhysicsProblem& mlcpProblem = m_physicsManagerState->getMlcpProblem();
+
+	EXPECT_EQ(3u, mlcpProblem.getSize());
+	EXPECT_TRUE(mlcpProblem.isConsistent());
+
+	// The fixed representation does not couple the constraints, the sphere constraints are stored first
+	const auto& islands = m_physicsManagerState->getMlcpIslands();
+	ASSERT_EQ(2u, islands.size());
+	EXPECT_EQ(0u, islands[0].constraintIndex);
+	EXPECT_EQ(2u, islands[0].numConstraints);
+	EXPECT_EQ(0u, islands[0].atomicIndex);
+	EXPECT_EQ(2u, islands[0].numAtomicConstraints);
+	EXPECT_EQ(2u, islands[1].constraintIndex);
+	EXPECT_EQ(1u, islands[1].numConstraints);
+	EXPECT_EQ(2u, islands[1].atomicIndex);
+	EXPECT_EQ(1u, islands[1].numAtomicConstraints);
+
+	const auto& mapping = m_physicsManagerState->getConstraintsMapping();
+	EXPECT_EQ(0, mapping.getValue(m_usedConstraints[0].get()));
+	EXPECT_EQ(1, mapping.getValue(m_usedConstraints[2].get()));
+	EXPECT_EQ(2, mapping.getValue(m_usedConstraints[1].get()));
+
+	// The dense matrix is never formed, the sparse matrix only stores the blocks of the islands
+	ASSERT_TRUE(mlcpProblem.isSparse());
+	EXPECT_EQ(0, mlcpProblem.A.size());
+	EXPECT_EQ(5, mlcpProblem.sparseA.nonZeros());
+	const Math::MlcpProblem::Matrix A = mlcpProblem.sparseA;
+	EXPECT_TRUE(A.block(0, 2, 2, 1).isZero());
+	EXPECT_TRUE(A.block(2, 0, 1, 2).isZero());
+	EXPECT_FALSE(A.block(0, 0, 2, 2).isZero());
+	EXPECT_FALSE(A.block(2, 2, 1, 1).isZero());
+
+	// The blocks are the ones of H.C.H^t
+	const Math::MlcpProblem::Matrix expectedA = mlcpProblem.H * mlcpProblem.CHt;
+	EXPECT_TRUE(expectedA.isApprox(A));
+}
+
+TEST_F(BuildMlcpTests, SparseMatrixTest)
+{
+	// Two rigid representations, each one constrained against the fixed world only
+	m_usedRepresentations.push_back(m_allRepresentations[0]);
+	m_usedRepresentations.push_back(m_allRepresentations[1]);
+	m_usedRepresentations.push_back(m_fixedWorldRepresentation);
+	m_physicsManagerState->setRepresentations(m_usedRepresentations);
+
+	for (size_t representationIndex : {0, 1, 0})
+	{
+		std::shared_ptr<ContactConstraintData> data = std::make_shared<ContactConstraintData>();
+		data->setPlaneEquation(SurgSim::Math::Vector3d(0.0, 1.0, 0.0), 0.0);
+
+		std::shared_ptr<Constraint> constraint = std::make_shared<Constraint>(FRICTIONLESS_3DCONTACT,
+			data, m_usedRepresentations[representationIndex],
+			SurgSim::DataStructures::Location(SurgSim::Math::Vector3d::Zero()),
+			m_fixedWorldRepresentation,
+			SurgSim::DataStructures::Location(SurgSim::Math::Vector3d::Zero()));
+		m_usedConstraints.push_back(constraint);
+	}
+	m_physicsManagerState->setConstraintGroup(CONSTRAINT_GROUP_TYPE_CONTACT, m_usedConstraints);
+
+	// The islands are always assembled in a sparse matrix, a single island gives the dense matrix
+	EXPECT_FALSE(m_buildMlcpComputation->isUsingSparseMatrix());
+	m_physicsManagerState->setConstraintGroup(CONSTRAINT_GROUP_TYPE_CONTACT,
+		std::vector<std::shared_ptr<Constraint>>(m_usedConstraints.begin(), m_usedConstraints.begin() + 1));
+	m_buildMlcpComputation->update(dt, m_physicsManagerState);
+	EXPECT_FALSE(m_physicsManagerState->getMlcpProblem().isSparse());
+	m_physicsManagerState->setConstraintGroup(CONSTRAINT_GROUP_TYPE_CONTACT, m_usedConstraints);
+	m_buildMlcpComputation->update(dt, m_physicsManagerState);
+	const MlcpPhysicsProblem islandsProblem = m_physicsManagerState->getMlcpProblem();
+	EXPECT_TRUE(islandsProblem.isSparse());
+
+	m_buildMlcpComputation->setUseSparseMatrix(true);
+	EXPECT_TRUE(m_buildMlcpComputation->isUsingSparseMatrix());
+	m_buildMlcpComputation->update(dt, m_physicsManagerState);
+	const MlcpPhysicsProblem& sparseProblem = m_physicsManagerState->getMlcpProblem();
+
+	// The dense matrix is never formed, the sparse one only stores the blocks of the islands
+	ASSERT_TRUE(sparseProblem.isSparse());
+	EXPECT_TRUE(sparseProblem.isConsistent());
+	EXPECT_EQ(0, sparseProblem.A.size());
+	EXPECT_EQ(5, sparseProblem.sparseA.nonZeros());
+	EXPECT_TRUE(Math::MlcpProblem::Matrix(islandsProblem.sparseA).isApprox(
+		Math::MlcpProblem::Matrix(sparseProblem.sparseA)));
+	EXPECT_TRUE(islandsProblem.b.isApprox(sparseProblem.b));
+	EXPECT_TRUE(islandsProblem.CHt.isApprox(sparseProblem.CHt));
+}
+
 }; // namespace Physics
 }; // namespace SurgSim
@@ -19,8 +19,12 @@
 #include "SurgSim/DataStructures/Location.h"
 #include "SurgSim/Math/Vector.h"
 #include "SurgSim/Physics/CcdCollisionLoop.h"
+#include "SurgSim/Physics/Constraint.h"
+#include "SurgSim/Physics/ConstraintData.h"
 #include "SurgSim/Physics/PushResults.h"
+#include "SurgSim/Framework/Assert.h"
 #include "SurgSim/Physics/RigidCollisionRepresentation.h"
+#include "SurgSim/Physics/RigidRepresentation.h"
 #include "SurgSim/Physics/SolveMlcp.h"
 
 namespace SurgSim
@@ -36,6 +40,19 @@ TEST(CcdCollisionLoopTest, Setters)
 
 	std::unique_ptr<PushResults> pushResults(new PushResults(false));
 	ccd->setPushResults(std::move(pushResults));
+
+	EXPECT_EQ(20u, ccd->getMaxIterations());
+	ccd->setMaxIterations(5);
+	EXPECT_EQ(5u, ccd->getMaxIterations());
+
+	EXPECT_FALSE(ccd->isRetestingAffectedPairsOnly());
+	ccd->setRetestAffectedPairsOnly(true);
+	EXPECT_TRUE(ccd->isRetestingAffectedPairsOnly());
+
+	EXPECT_DOUBLE_EQ(0.0, ccd->getTimeBudget());
+	ccd->setTimeBudget(0.002);
+	EXPECT_DOUBLE_EQ(0.002, ccd->getTimeBudget());
+	EXPECT_THROW(ccd->setTimeBudget(-1.0), Framework::AssertionFailure);
 }
 
 TEST(CcdCollisionLoopTest, FilterContacts)
@@ -98,6 +115,79 @@ TEST(CcdCollisionLoopTest, FilterContactsWithEpsilon)
 	EXPECT_DOUBLE_EQ(0.1, toi);
 	EXPECT_EQ(2u, pair->getContacts().size());
 }
+TEST(CcdCollisionLoopTest, FindAffectedPairs)
+{
+	std::vector<std::shared_ptr<RigidCollisionRepresentation>> collision;
+	for (auto name : {"A", "B", "C", "D", "E"})
+	{
+		collision.push_back(std::make_shared<RigidCollisionRepresentation>(name));
+		collision.back()->setCollisionDetectionType(Collision::COLLISION_DETECTION_TYPE_CONTINUOUS);
+		collision.back()->setSelfCollisionDetectionType(Collision::COLLISION_DETECTION_TYPE_CONTINUOUS);
+	}
+	auto physics1 = std::make_shared<RigidRepresentation>("Physics1");
+	auto physics2 = std::make_shared<RigidRepresentation>("Physics2");
+
+	// B and C are driven by the same physics representation, E does not have one
+	std::unordered_map<std::shared_ptr<Collision::Representation>, std::shared_ptr<Representation>> collisionToPhysics;
+	collisionToPhysics[collision[0]] = physics1;
+	collisionToPhysics[collision[1]] = physics2;
+	collisionToPhysics[collision[2]] = physics2;
+	collisionToPhysics[collision[3]] = physics1;
+
+	std::vector<std::shared_ptr<Collision::CollisionPair>> pairs;
+	pairs.push_back(std::make_shared<Collision::CollisionPair>(collision[1], collision[4]));
+	pairs.push_back(std::make_shared<Collision::CollisionPair>(collision[2], collision[2]));
+	pairs.push_back(std::make_shared<Collision::CollisionPair>(collision[0], collision[0]));
+	pairs.push_back(std::make_shared<Collision::CollisionPair>(collision[4], collision[4]));
+	pairs.push_back(std::make_shared<Collision::CollisionPair>(collision[0], collision[3]));
+
+	auto computation = std::make_shared<CcdCollisionLoop>(false);
+	std::vector<std::shared_ptr<Collision::CollisionPair>> pairsToTest(1, pairs[0]);
+	std::vector<bool> hadContacts(pairs.size(), false);
+	const std::vector<std::shared_ptr<Constraint>> noConstraints;
+
+	// Nothing was solved
+	computation->findAffectedPairs(pairs, hadContacts, collisionToPhysics, noConstraints, &pairsToTest);
+	EXPECT_TRUE(pairsToTest.empty());
+
+	// The contacts of the last pair were filtered out, it still needs to be tested again
+	hadContacts[4] = true;
+	computation->findAffectedPairs(pairs, hadContacts, collisionToPhysics, noConstraints, &pairsToTest);
+	ASSERT_EQ(1u, pairsToTest.size());
+	EXPECT_EQ(pairs[4], pairsToTest[0]);
+
+	// B and E are corrected, C through the physics of B
+	DataStructures::Location location;
+	pairs[0]->addCcdContact(0.0, 0.1, Math::Vector3d::Zero(), Math::Vector3d::Zero(),
+							std::make_pair(location, location));
+	hadContacts[0] = true;
+	computation->findAffectedPairs(pairs, hadContacts, collisionToPhysics, noConstraints, &pairsToTest);
+	ASSERT_EQ(4u, pairsToTest.size());
+	EXPECT_EQ(pairs[0], pairsToTest[0]);
+	EXPECT_EQ(pairs[1], pairsToTest[1]);
+	EXPECT_EQ(pairs[3], pairsToTest[2]);
+	EXPECT_EQ(pairs[4], pairsToTest[3]);
+
+	// A constraint that is not a contact, e.g. a scene constraint, moves both of its representations: A and D
+	// through Physics1, and B and C through Physics2
+	hadContacts.assign(pairs.size(), false);
+	pairs[0]->getContacts().clear();
+	auto sceneConstraint = std::make_shared<Constraint>(FIXED_3DPOINT, std::make_shared<ConstraintData>(),
+							physics1, DataStructures::Location(Math::Vector3d::Zero()),
+							physics2, DataStructures::Location(Math::Vector3d::Zero()));
+	computation->findAffectedPairs(pairs, hadContacts, collisionToPhysics, noConstraints, &pairsToTest);
+	EXPECT_TRUE(pairsToTest.empty());
+	computation->findAffectedPairs(pairs, hadContacts, collisionToPhysics,
+								   std::vector<std::shared_ptr<Constraint>>(1, sceneConstraint), &pairsToTest);
+	ASSERT_EQ(4u, pairsToTest.size());
+	EXPECT_EQ(pairs[0], pairsToTest[0]);
+	EXPECT_EQ(pairs[1], pairsToTest[1]);
+	EXPECT_EQ(pairs[2], pairsToTest[2]);
+	EXPECT_EQ(pairs[4], pairsToTest[3]);
+
+	EXPECT_THROW(computation->findAffectedPairs(pairs, std::vector<bool>(), collisionToPhysics, noConstraints,
+				 &pairsToTest), Framework::AssertionFailure);
+}
 
 }
 }
@@ -27,8 +27,10 @@
 #include "SurgSim/Math/SphereShape.h"
 #include "SurgSim/Math/Vector.h"
 #include "SurgSim/Physics/Constraint.h"
+#include "SurgSim/Physics/ContactConstraintData.h"
 #include "SurgSim/Physics/ContactConstraintGeneration.h"
 #include "SurgSim/Physics/PhysicsManagerState.h"
+#include "SurgSim/Physics/Localization.h"
 #include "SurgSim/Physics/RigidCollisionRepresentation.h"
 #include "SurgSim/Physics/RigidRepresentation.h"
 
@@ -204,6 +206,137 @@ TEST_F(ContactConstraintGenerationTests, LocalPoses)
 			"The contact location is not in the same position as the localization produced by constraint generation";
 }
 
+TEST_F(ContactConstraintGenerationTests, ConstraintPoolTest)
+{
+	std::shared_ptr<CollisionPair> pair = std::make_shared<CollisionPair>(collision0, collision1);
+	SurgSim::Collision::SphereDoubleSidedPlaneContact contactCalculation;
+	contactCalculation.calculateContact(pair);
+	ASSERT_TRUE(pair->hasContacts());
+	pairs.push_back(pair);
+
+	ContactConstraintGeneration generator;
+	auto generate = [this, &generator]()
+	{
+		auto frameState = std::make_shared<PhysicsManagerState>();
+		frameState->setRepresentations(representations);
+		frameState->setCollisionPairs(pairs);
+		generator.update(0.1, frameState);
+		EXPECT_EQ(1u, frameState->getConstraintGroup(CONSTRAINT_GROUP_TYPE_CONTACT).size());
+		return frameState;
+	};
+
+	auto state0 = generate();
+	auto constraint0 = state0->getConstraintGroup(CONSTRAINT_GROUP_TYPE_CONTACT)[0].get();
+
+	// The constraint of a physics state still in use is not reused
+	auto state1 = generate();
+	auto constraint1 = state1->getConstraintGroup(CONSTRAINT_GROUP_TYPE_CONTACT)[0].get();
+	EXPECT_NE(constraint0, constraint1);
+
+	// Once the physics state is released, its constraint, data and localizations are reused
+	auto data0 = constraint0->getData().get();
+	auto localizations0 = std::make_pair(constraint0->getLocalizations().first.get(),
+										 constraint0->getLocalizations().second.get());
+	auto positions0 = std::make_pair(localizations0.first->calculatePosition(),
+									 localizations0.second->calculatePosition());
+	// A constraint can be left deactivated by its previous frame, deactivate it to check that reusing it activates it
+	constraint0->setActive(false);
+	state0.reset();
+	auto state2 = generate();
+	auto constraint2 = state2->getConstraintGroup(CONSTRAINT_GROUP_TYPE_CONTACT)[0];
+	EXPECT_EQ(constraint0, constraint2.get());
+	EXPECT_EQ(data0, constraint2->getData().get());
+	EXPECT_TRUE(constraint2->isActive());
+	EXPECT_EQ(pair->getContacts().front(),
+			  std::static_pointer_cast<ContactConstraintData>(constraint2->getData())->getContact());
+	EXPECT_NE(nullptr, constraint2->getLocalizations().first);
+	EXPECT_NE(nullptr, constraint2->getLocalizations().second);
+	EXPECT_EQ(rigid0, constraint2->getLocalizations().first->getRepresentation());
+	EXPECT_EQ(rigid1, constraint2->getLocalizations().second->getRepresentation());
+
+	// No localization is created, the previous ones are moved to the contact
+	EXPECT_EQ(localizations0.first, constraint2->getLocalizations().first.get());
+	EXPECT_EQ(localizations0.second, constraint2->getLocalizations().second.get());
+	EXPECT_TRUE(positions0.first.isApprox(constraint2->getLocalizations().first->calculatePosition()));
+	EXPECT_TRUE(positions0.second.isApprox(constraint2->getLocalizations().second->calculatePosition()));
+
+	// A localization still referenced elsewhere is not moved
+	auto heldLocalization = constraint2->getLocalizations().first;
+	constraint2.reset();
+	state2.reset();
+	state1.reset();
+	auto state3 = generate();
+	auto constraint3 = state3->getConstraintGroup(CONSTRAINT_GROUP_TYPE_CONTACT)[0];
+	EXPECT_EQ(constraint0, constraint3.get());
+	EXPECT_NE(heldLocalization, constraint3->getLocalizations().first);
+	EXPECT_EQ(localizations0.second, constraint3->getLocalizations().second.get());
+}
+
+TEST_F(ContactConstraintGenerationTests, ConstraintPoolReleasesContacts)
+{
+	ContactConstraintGeneration generator;
+	std::weak_ptr<SurgSim::Collision::Contact> contact;
+	{
+		std::shared_ptr<CollisionPair> pair = std::make_shared<CollisionPair>(collision0, collision1);
+		SurgSim::Collision::SphereDoubleSidedPlaneContact contactCalculation;
+		contactCalculation.calculateContact(pair);
+		ASSERT_TRUE(pair->hasContacts());
+		contact = pair->getContacts().front();
+
+		std::vector<std::shared_ptr<CollisionPair>> framePairs;
+		framePairs.push_back(pair);
+		auto frameState = std::make_shared<PhysicsManagerState>();
+		frameState->setRepresentations(representations);
+		frameState->setCollisionPairs(framePairs);
+		generator.update(0.1, frameState);
+		ASSERT_EQ(1u, frameState->getConstraintGroup(CONSTRAINT_GROUP_TYPE_CONTACT).size());
+	}
+
+	// The constraint is back in the pool, the next update releases its contact
+	EXPECT_FALSE(contact.expired());
+	state->setCollisionPairs(pairs);
+	generator.update(0.1, state);
+	EXPECT_TRUE(contact.expired());
+}
+
+TEST_F(ContactConstraintGenerationTests, ConstraintPoolRemovedRepresentation)
+{
+	auto rigid2 = std::make_shared<RigidRepresentation>("Physics Representation 2");
+	rigid2->setShape(std::make_shared<SphereShape>(2.0));
+	auto collision2 = std::make_shared<RigidCollisionRepresentation>("Collision Representation 2");
+	rigid2->setCollisionRepresentation(collision2);
+	collision2->update(0.0);
+	std::weak_ptr<RigidRepresentation> removed = rigid2;
+
+	ContactConstraintGeneration generator;
+	{
+		std::shared_ptr<CollisionPair> pair = std::make_shared<CollisionPair>(collision2, collision1);
+		SurgSim::Collision::SphereDoubleSidedPlaneContact contactCalculation;
+		contactCalculation.calculateContact(pair);
+		ASSERT_TRUE(pair->hasContacts());
+
+		std::vector<std::shared_ptr<SurgSim::Physics::Representation>> frameRepresentations;
+		frameRepresentations.push_back(rigid2);
+		frameRepresentations.push_back(rigid1);
+		std::vector<std::shared_ptr<CollisionPair>> framePairs;
+		framePairs.push_back(pair);
+
+		auto frameState = std::make_shared<PhysicsManagerState>();
+		frameState->setRepresentations(frameRepresentations);
+		frameState->setCollisionPairs(framePairs);
+		generator.update(0.1, frameState);
+		ASSERT_EQ(1u, frameState->getConstraintGroup(CONSTRAINT_GROUP_TYPE_CONTACT).size());
+	}
+
+	// The pooled constraint keeps the representation alive until it is removed from the physics state
+	rigid2.reset();
+	collision2.reset();
+	EXPECT_FALSE(removed.expired());
+
+	state->setCollisionPairs(pairs);
+	generator.update(0.1, state);
+	EXPECT_TRUE(removed.expired());
+}
 
 }; // namespace Physics
 }; // namespace SurgSim
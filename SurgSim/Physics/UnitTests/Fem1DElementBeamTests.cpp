@@ -699,3 +699,44 @@ TEST_F(Fem1DElementBeamTests, ForceAndMatricesTest)
 		EXPECT_NEAR(expectedCoef, forceVector[rowId], 1e-6);
 	}
 }
+
+TEST_F(Fem1DElementBeamTests, LumpedMassTest)
+{
+	using SurgSim::Math::Matrix;
+	using SurgSim::Math::Vector;
+
+	std::shared_ptr<MockFem1DElement> beam = getBeam();
+	Matrix expectedMass(6 * m_numberNodes, 6 * m_numberNodes);
+	getExpectedMassMatrix(expectedMass);
+
+	Vector lumpedMass = Vector::Zero(6 * m_numberNodes);
+	beam->addLumpedMass(&lumpedMass);
+
+	// The nodes of the beam get a scaled diagonal of the mass matrix, with the beam mass in each direction
+	const double mass = beam->getMass(m_restState);
+	for (size_t dof = 0; dof < 6; ++dof)
+	{
+		const size_t dof0 = 6 * m_nodeIds[0] + dof;
+		const size_t dof1 = 6 * m_nodeIds[1] + dof;
+		EXPECT_GT(lumpedMass[dof0], 0.0);
+		EXPECT_GT(lumpedMass[dof1], 0.0);
+		EXPECT_NEAR(lumpedMass[dof0] / expectedMass(dof0, dof0), lumpedMass[dof1] / expectedMass(dof1, dof1),
+			epsilon);
+		if (dof < 3)
+		{
+			EXPECT_NEAR(mass, lumpedMass[dof0] + lumpedMass[dof1], 1e-10);
+		}
+	}
+	for (size_t nodeId = 0; nodeId < static_cast<size_t>(m_numberNodes); ++nodeId)
+	{
+		if (nodeId != m_nodeIds[0] && nodeId != m_nodeIds[1])
+		{
+			EXPECT_TRUE(lumpedMass.segment<6>(6 * nodeId).isZero());
+		}
+	}
+
+	// The lumped mass is accumulated
+	Vector doubleLumpedMass = lumpedMass;
+	beam->addLumpedMass(&doubleLumpedMass);
+	EXPECT_TRUE(doubleLumpedMass.isApprox(2.0 * lumpedMass));
+}
@@ -0,0 +1,320 @@
+// This file is a part of the OpenSurgSim project.
+// Copyright 2016, SimQuest Solutions Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "SurgSim/Framework/Runtime.h"
+#include "SurgSim/Math/Matrix.h"
+#include "SurgSim/Math/OdeEquation.h"
+#include "SurgSim/Math/OdeState.h"
+#include "SurgSim/Math/Vector.h"
+#include "SurgSim/Physics/Fem3DElementCorotationalTetrahedron.h"
+#include "SurgSim/Physics/Fem3DElementCorotationalTetrahedronBatch.h"
+#include "SurgSim/Physics/Fem3DRepresentation.h"
+
+using SurgSim::Math::Matrix;
+using SurgSim::Math::Vector;
+using SurgSim::Math::Vector3d;
+
+namespace SurgSim
+{
+
+namespace Physics
+{
+
+namespace
+{
+const double epsilon = 1e-9;
+
+class MockCorotationalTet : public Fem3DElementCorotationalTetrahedron
+{
+public:
+	explicit MockCorotationalTet(std::array<size_t, 4> nodeIds) : Fem3DElementCorotationalTetrahedron(nodeIds)
+	{
+	}
+
+	const Math::Matrix33d& getRotation() const
+	{
+		return m_R;
+	}
+
+	const Vector& getForce() const
+	{
+		return m_f;
+	}
+
+	const Matrix& getMass() const
+	{
+		return m_M;
+	}
+
+	const Matrix& getStiffness() const
+	{
+		return m_K;
+	}
+};
+
+/// A bar of 3 unit cubes along X, each cube split into 6 tetrahedra (18 tetrahedra, 16 nodes)
+/// \param[out] state The rest state
+/// \return The node ids of the tetrahedra, ordered so that they have a positive volume
+std::vector<std::array<size_t, 4>> createBar(Math::OdeState* state)
+{
+	auto nodeId = [](size_t i, size_t j, size_t k)
+	{
+		return 4 * i + 2 * j + k;
+	};
+
+	state->setNumDof(3, 16);
+	for (size_t i = 0; i < 4; ++i)
+	{
+		for (size_t j = 0; j < 2; ++j)
+		{
+			for (size_t k = 0; k < 2; ++k)
+			{
+				state->getPositions().segment<3>(3 * nodeId(i, j, k)) =
+					Vector3d(static_cast<double>(i), static_cast<double>(j), static_cast<double>(k));
+			}
+		}
+	}
+
+	// Each cube is split along its diagonal, one tetrahedron per order of the axis
+	const std::array<std::array<size_t, 3>, 6> axisOrders = {{
+			{{0, 1, 2}}, {{0, 2, 1}}, {{1, 0, 2}}, {{1, 2, 0}}, {{2, 0, 1}}, {{2, 1, 0}}
+		}
+	};
+	std::vector<std::array<size_t, 4>> tetrahedra;
+	for (size_t cube = 0; cube < 3; ++cube)
+	{
+		for (const auto& order : axisOrders)
+		{
+			std::array<size_t, 3> corner = {{cube, 0, 0}};
+			std::array<size_t, 4> tetrahedron;
+			tetrahedron[0] = nodeId(corner[0], corner[1], corner[2]);
+			for (size_t n = 0; n < 3; ++n)
+			{
+				++corner[order[n]];
+				tetrahedron[n + 1] = nodeId(corner[0], corner[1], corner[2]);
+			}
+
+			const Vector3d a = state->getPosition(tetrahedron[0]);
+			const Vector3d ab = state->getPosition(tetrahedron[1]) - a;
+			const Vector3d ac = state->getPosition(tetrahedron[2]) - a;
+			const Vector3d ad = state->getPosition(tetrahedron[3]) - a;
+			if (ab.cross(ac).dot(ad) < 0.0)
+			{
+				std::swap(tetrahedron[2], tetrahedron[3]);
+			}
+			tetrahedra.push_back(tetrahedron);
+		}
+	}
+	return tetrahedra;
+}
+
+std::vector<std::shared_ptr<MockCorotationalTet>> createElements(
+	const std::vector<std::array<size_t, 4>>& tetrahedra, const Math::OdeState& state)
+{
+	std::vector<std::shared_ptr<MockCorotationalTet>> elements;
+	for (const auto& nodeIds : tetrahedra)
+	{
+		auto element = std::make_shared<MockCorotationalTet>(nodeIds);
+		element->setMassDensity(1000.0);
+		element->setPoissonRatio(0.45);
+		element->setYoungModulus(1e6);
+		element->initialize(state);
+		elements.push_back(element);
+	}
+	return elements;
+}
+
+/// \return The rest state rigidly transformed and deformed
+Math::OdeState deform(const Math::OdeState& restState, double amplitude)
+{
+	const Math::Matrix33d rotation = Math::makeRotationMatrix(2.1, Vector3d(1.0, 0.2, -0.3).normalized());
+	const Vector3d translation(1.2, 2.3, 3.4);
+
+	Math::OdeState state = restState;
+	for (size_t node = 0; node < state.getNumNodes(); ++node)
+	{
+		const double t = static_cast<double>(node);
+		const Vector3d delta(std::sin(t), std::cos(2.0 * t), std::sin(3.0 * t + 1.0));
+		state.getPositions().segment<3>(3 * node) = rotation * (restState.getPosition(node) + amplitude * delta) +
+			translation;
+	}
+	return state;
+}
+
+void expectSameElements(const std::vector<std::shared_ptr<MockCorotationalTet>>& expected,
+						const std::vector<std::shared_ptr<MockCorotationalTet>>& actual)
+{
+	ASSERT_EQ(expected.size(), actual.size());
+	for (size_t i = 0; i < expected.size(); ++i)
+	{
+		SCOPED_TRACE("Element " + std::to_string(i));
+		EXPECT_TRUE(actual[i]->getRotation().isApprox(expected[i]->getRotation(), epsilon));
+		// The force vanishes in a rigid motion, so it is compared relatively to the stiffness
+		EXPECT_NEAR(0.0, (actual[i]->getForce() - expected[i]->getForce()).norm(),
+					epsilon * expected[i]->getStiffness().norm());
+		EXPECT_TRUE(actual[i]->getMass().isApprox(expected[i]->getMass(), epsilon));
+		EXPECT_TRUE(actual[i]->getStiffness().isApprox(expected[i]->getStiffness(), epsilon));
+	}
+}
+
+std::vector<std::shared_ptr<Fem3DElementCorotationalTetrahedron>> asCorotational(
+	const std::vector<std::shared_ptr<MockCorotationalTet>>& elements)
+{
+	return std::vector<std::shared_ptr<Fem3DElementCorotationalTetrahedron>>(elements.begin(), elements.end());
+}
+}
+
+TEST(Fem3DElementCorotationalTetrahedronBatchTests, ConstructorTest)
+{
+	Math::OdeState restState;
+	auto tetrahedra = createBar(&restState);
+	auto elements = createElements(tetrahedra, restState);
+	ASSERT_EQ(18u, elements.size());
+
+	Fem3DElementCorotationalTetrahedronBatch emptyBatch(
+		std::vector<std::shared_ptr<Fem3DElementCorotationalTetrahedron>>{});
+	EXPECT_EQ(0u, emptyBatch.getNumElements());
+	EXPECT_EQ(0u, emptyBatch.getNumBatches());
+	EXPECT_NO_THROW(emptyBatch.updateFMDK(restState, Math::ODEEQUATIONUPDATE_FMDK));
+
+	Fem3DElementCorotationalTetrahedronBatch batch(asCorotational(elements));
+	EXPECT_EQ(18u, batch.getNumElements());
+	EXPECT_EQ((18u + Fem3DElementCorotationalTetrahedronBatch::BatchSize - 1) /
+			  Fem3DElementCorotationalTetrahedronBatch::BatchSize, batch.getNumBatches());
+	EXPECT_THROW(batch.updateFMDK(batch.getNumBatches(), restState, Math::ODEEQUATIONUPDATE_FMDK),
+				 Framework::AssertionFailure);
+
+	auto withNullptr = asCorotational(elements);
+	withNullptr.push_back(nullptr);
+	EXPECT_THROW(Fem3DElementCorotationalTetrahedronBatch invalidBatch(withNullptr), Framework::AssertionFailure);
+}
+
+TEST(Fem3DElementCorotationalTetrahedronBatchTests, UpdateFMDKTest)
+{
+	Math::OdeState restState;
+	auto tetrahedra = createBar(&restState);
+	auto expectedElements = createElements(tetrahedra, restState);
+	auto elements = createElements(tetrahedra, restState);
+	Fem3DElementCorotationalTetrahedronBatch batch(asCorotational(elements));
+
+	// The rest state, a rigid transformation and a deformation
+	const std::array<Math::OdeState, 3> states = {{restState, deform(restState, 0.0), deform(restState, 0.1)}};
+	const std::array<int, 4> options = {{Math::ODEEQUATIONUPDATE_M, Math::ODEEQUATIONUPDATE_K,
+			Math::ODEEQUATIONUPDATE_F, Math::ODEEQUATIONUPDATE_FMDK
+		}
+	};
+	for (const auto& state : states)
+	{
+		for (int option : options)
+		{
+			for (const auto& element : expectedElements)
+			{
+				element->updateFMDK(state, option);
+			}
+			batch.updateFMDK(state, option);
+			expectSameElements(expectedElements, elements);
+		}
+	}
+
+	// The batches can be updated one by one
+	const Math::OdeState state = deform(restState, 0.05);
+	for (const auto& element : expectedElements)
+	{
+		element->updateFMDK(state, Math::ODEEQUATIONUPDATE_FMDK);
+	}
+	for (size_t batchId = 0; batchId < batch.getNumBatches(); ++batchId)
+	{
+		batch.updateFMDK(batchId, state, Math::ODEEQUATIONUPDATE_FMDK);
+	}
+	expectSameElements(expectedElements, elements);
+}
+
+TEST(Fem3DElementCorotationalTetrahedronBatchTests, InvertedElementTest)
+{
+	Math::OdeState restState;
+	auto tetrahedra = createBar(&restState);
+	auto expectedElements = createElements(tetrahedra, restState);
+	auto elements = createElements(tetrahedra, restState);
+	Fem3DElementCorotationalTetrahedronBatch batch(asCorotational(elements));
+
+	// Pushing a node through the bar inverts the elements using it, which are then updated by themselves
+	Math::OdeState state = deform(restState, 0.02);
+	state.getPositions().segment<3>(3 * 5) += Vector3d(0.0, -2.5, 0.0);
+	for (const auto& element : expectedElements)
+	{
+		element->updateFMDK(state, Math::ODEEQUATIONUPDATE_FMDK);
+	}
+	batch.updateFMDK(state, Math::ODEEQUATIONUPDATE_FMDK);
+	expectSameElements(expectedElements, elements);
+}
+
+TEST(Fem3DElementCorotationalTetrahedronBatchTests, RepresentationTest)
+{
+	Math::OdeState restState;
+	auto tetrahedra = createBar(&restState);
+
+	auto createFem = [&tetrahedra, &restState](const std::string& name, bool useElementBatching)
+	{
+		auto fem = std::make_shared<Fem3DRepresentation>(name);
+		fem->setInitialState(std::make_shared<Math::OdeState>(restState));
+		fem->setRayleighDampingStiffness(0.01);
+#if defined(__AVX2__) || defined(__AVX512F__)
+		EXPECT_TRUE(fem->getElementBatching());
+#else
+		EXPECT_FALSE(fem->getElementBatching());
+#endif
+		fem->setElementBatching(useElementBatching);
+		for (const auto& nodeIds : tetrahedra)
+		{
+			auto element = std::make_shared<Fem3DElementCorotationalTetrahedron>(nodeIds);
+			element->setMassDensity(1000.0);
+			element->setPoissonRatio(0.45);
+			element->setYoungModulus(1e6);
+			fem->addFemElement(element);
+		}
+		fem->initialize(std::make_shared<Framework::Runtime>());
+		return fem;
+	};
+
+	auto expectedFem = createFem("Elements", false);
+	EXPECT_FALSE(expectedFem->getElementBatching());
+	auto fem = createFem("Batches", true);
+	EXPECT_TRUE(fem->getElementBatching());
+	EXPECT_TRUE(fem->getValue<bool>("ElementBatching"));
+	EXPECT_THROW(fem->setElementBatching(false), Framework::AssertionFailure);
+
+	const Math::OdeState state = deform(restState, 0.1);
+	for (bool useParallelAssembly : {true, false})
+	{
+		fem->setParallelAssembly(useParallelAssembly);
+		expectedFem->updateFMDK(state, Math::ODEEQUATIONUPDATE_FMDK);
+		fem->updateFMDK(state, Math::ODEEQUATIONUPDATE_FMDK);
+		EXPECT_TRUE(fem->getF().isApprox(expectedFem->getF(), epsilon));
+		EXPECT_TRUE(Matrix(fem->getM()).isApprox(Matrix(expectedFem->getM()), epsilon));
+		EXPECT_TRUE(Matrix(fem->getD()).isApprox(Matrix(expectedFem->getD()), epsilon));
+		EXPECT_TRUE(Matrix(fem->getK()).isApprox(Matrix(expectedFem->getK()), epsilon));
+	}
+}
+
+}; // namespace Physics
+
+}; // namespace SurgSim
@@ -21,7 +21,10 @@
 #include "SurgSim/DataStructures/Location.h"
 #include "SurgSim/Framework/ApplicationData.h"
 #include "SurgSim/Framework/Runtime.h" ///< Used to initialize the Component Fem3DRepresentation
+#include "SurgSim/Math/LinearSparseSolveAndInverse.h"
 #include "SurgSim/Math/MeshShape.h"
+#include "SurgSim/Math/OdeSolverEulerExplicit.h"
+#include "SurgSim/Math/OdeSolverEulerImplicit.h"
 #include "SurgSim/Math/OdeState.h"
 #include "SurgSim/Math/Quaternion.h"
 #include "SurgSim/Math/RigidTransform.h"
@@ -406,6 +409,166 @@ TEST_F(Fem3DRepresentationTests, ExternalForceAPITest)
 	EXPECT_TRUE(m_fem->getExternalGeneralizedDamping().isApprox(2.0 * D));
 }
 
+TEST_F(Fem3DRepresentationTests, MatrixFreeSolveTest)
+{
+	using SurgSim::Math::OdeSolverEulerImplicit;
+
+	// Two tetrahedra sharing a face, the first node is fixed
+	auto createFem = [](const std::string& name)
+	{
+		auto fem = std::make_shared<Fem3DRepresentation>(name);
+		auto state = std::make_shared<SurgSim::Math::OdeState>();
+		state->setNumDof(3, 5);
+		state->getPositions() << 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 1.0, 1.0, 1.0;
+		state->addBoundaryCondition(0);
+		fem->setInitialState(state);
+		fem->setRayleighDampingMass(0.1);
+		fem->setRayleighDampingStiffness(0.01);
+		std::array<size_t, 4> tetrahedra[2] = {{{0, 1, 2, 3}}, {{1, 2, 3, 4}}};
+		for (const auto& nodeIds : tetrahedra)
+		{
+			auto element = std::make_shared<Fem3DElementTetrahedron>(nodeIds);
+			element->setYoungModulus(1e5);
+			element->setPoissonRatio(0.45);
+			element->setMassDensity(1000.0);
+			fem->addFemElement(element);
+		}
+		fem->initialize(std::make_shared<SurgSim::Framework::Runtime>());
+		return fem;
+	};
+
+	auto fem = createFem("Assembled");
+	auto matrixFreeFem = createFem("MatrixFree");
+	OdeSolverEulerImplicit solver(fem.get());
+	OdeSolverEulerImplicit matrixFreeSolver(matrixFreeFem.get());
+	matrixFreeSolver.setMatrixFree(true);
+	matrixFreeSolver.setMatrixFreeTolerance(1e-12);
+
+	SurgSim::Math::OdeState state(*fem->getInitialState()), matrixFreeState(state);
+	SurgSim::Math::OdeState newState(state), matrixFreeNewState(state);
+	for (int step = 0; step < 5; ++step)
+	{
+		solver.solve(1e-3, state, &newState, false);
+		matrixFreeSolver.solve(1e-3, matrixFreeState, &matrixFreeNewState, false);
+		state = newState;
+		matrixFreeState = matrixFreeNewState;
+	}
+
+	EXPECT_FALSE(state.getVelocities().isZero());
+	EXPECT_TRUE(matrixFreeState.getVelocities().segment<3>(0).isZero());
+	EXPECT_TRUE(matrixFreeState.getVelocities().isApprox(state.getVelocities(), 1e-8));
+	EXPECT_TRUE(matrixFreeState.getPositions().isApprox(state.getPositions(), 1e-8));
+	EXPECT_LE(matrixFreeSolver.getMatrixFreeSolver().getRelativeResidual(), 1e-12);
+}
+
+TEST_F(Fem3DRepresentationTests, MassLumpingTest)
+{
+	using SurgSim::Math::Matrix;
+	using SurgSim::Math::Vector;
+
+	// Two tetrahedra sharing a face, the first node is fixed
+	auto createFem = [](const std::string& name, bool useMassLumping)
+	{
+		auto fem = std::make_shared<Fem3DRepresentation>(name);
+		auto state = std::make_shared<SurgSim::Math::OdeState>();
+		state->setNumDof(3, 5);
+		state->getPositions() << 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 1.0, 1.0, 1.0;
+		state->addBoundaryCondition(0);
+		fem->setInitialState(state);
+		fem->setRayleighDampingMass(0.1);
+		fem->setRayleighDampingStiffness(0.01);
+		fem->setMassLumping(useMassLumping);
+		std::array<size_t, 4> tetrahedra[2] = {{{0, 1, 2, 3}}, {{1, 2, 3, 4}}};
+		for (const auto& nodeIds : tetrahedra)
+		{
+			auto element = std::make_shared<Fem3DElementTetrahedron>(nodeIds);
+			element->setYoungModulus(1e5);
+			element->setPoissonRatio(0.45);
+			element->setMassDensity(1000.0);
+			fem->addFemElement(element);
+		}
+		fem->initialize(std::make_shared<SurgSim::Framework::Runtime>());
+		return fem;
+	};
+
+	auto consistentFem = createFem("Consistent", false);
+	EXPECT_FALSE(consistentFem->getMassLumping());
+	EXPECT_FALSE(consistentFem->hasDiagonalMass());
+	EXPECT_EQ(0, consistentFem->getLumpedMass().size());
+	EXPECT_EQ(nullptr, std::dynamic_pointer_cast<SurgSim::Math::LinearSparseSolveAndInverseDiagonal>(
+				  consistentFem->getOdeSolver()->getLinearSolver()));
+
+	auto fem = createFem("Lumped", true);
+	EXPECT_TRUE(fem->getMassLumping());
+	EXPECT_TRUE(fem->hasDiagonalMass());
+	EXPECT_THROW(fem->setMassLumping(false), SurgSim::Framework::AssertionFailure);
+	EXPECT_NE(nullptr, std::dynamic_pointer_cast<SurgSim::Math::LinearSparseSolveAndInverseDiagonal>(
+				  fem->getOdeSolver()->getLinearSolver()));
+
+	// A linear tetrahedron spreads its mass evenly on its 4 nodes, in each direction
+	const auto& lumpedMass = fem->getLumpedMass();
+	ASSERT_EQ(15, lumpedMass.size());
+	const SurgSim::Math::OdeState& state = *fem->getInitialState();
+	const double mass0 = fem->getFemElement(0)->getMass(state);
+	const double mass1 = fem->getFemElement(1)->getMass(state);
+	EXPECT_TRUE(lumpedMass.segment<3>(0).isApprox(Vector::Constant(3, mass0 / 4.0)));
+	EXPECT_TRUE(lumpedMass.segment<3>(3).isApprox(Vector::Constant(3, (mass0 + mass1) / 4.0)));
+	EXPECT_TRUE(lumpedMass.segment<3>(12).isApprox(Vector::Constant(3, mass1 / 4.0)));
+	EXPECT_NEAR(3.0 * fem->getTotalMass(), lumpedMass.sum(), 1e-10);
+
+	// The global mass matrix is the lumped mass, in the Rayleigh damping too
+	fem->updateFMDK(state, SurgSim::Math::ODEEQUATIONUPDATE_FMDK);
+	consistentFem->updateFMDK(state, SurgSim::Math::ODEEQUATIONUPDATE_FMDK);
+	const Matrix M = fem->getM();
+	const Matrix D = fem->getD();
+	const Matrix K = fem->getK();
+	EXPECT_TRUE(M.isApprox(Matrix(lumpedMass.asDiagonal())));
+	EXPECT_EQ(15, fem->getM().nonZeros());
+	EXPECT_TRUE(D.isApprox(0.1 * M + 0.01 * K));
+	EXPECT_TRUE(K.isApprox(Matrix(consistentFem->getK())));
+	fem->updateFMDK(state, SurgSim::Math::ODEEQUATIONUPDATE_M | SurgSim::Math::ODEEQUATIONUPDATE_D);
+	EXPECT_TRUE(Matrix(fem->getM()).isApprox(M));
+	EXPECT_TRUE(Matrix(fem->getD()).isApprox(D));
+
+	// The Rayleigh damping force uses the lumped mass as well
+	Vector expectedF = consistentFem->getF() - 0.1 * (M - Matrix(consistentFem->getM())) * state.getVelocities();
+	EXPECT_TRUE(fem->getF().isApprox(expectedF));
+
+	// The matrix free product and diagonal blocks use the lumped mass
+	const Vector x = Vector::LinSpaced(15, -1.0, 2.0);
+	Vector result;
+	fem->applyMDK(2.0, 3.0, 4.0, x, &result);
+	EXPECT_TRUE(result.isApprox((2.0 * M + 3.0 * D + 4.0 * K) * x));
+	Matrix blocks;
+	fem->computeMDKDiagonalBlocks(2.0, 3.0, 4.0, 3, &blocks);
+	const Matrix system = 2.0 * M + 3.0 * D + 4.0 * K;
+	for (Matrix::Index node = 0; node < 5; ++node)
+	{
+		EXPECT_TRUE(blocks.middleRows(3 * node, 3).isApprox(system.block(3 * node, 3 * node, 3, 3)));
+	}
+
+	// The explicit solve with the diagonal linear solver matches the general linear solver
+	SurgSim::Math::OdeSolverEulerExplicit solver(fem.get());
+	solver.setLinearSolver(std::make_shared<SurgSim::Math::LinearSparseSolveAndInverseLU>());
+	SurgSim::Math::OdeState expectedState(state);
+	solver.solve(1e-3, state, &expectedState);
+	const Matrix expectedCompliance = solver.getComplianceMatrix();
+
+	fem->wakeUp();
+	EXPECT_TRUE(fem->getMatrixFreeCompliance());
+	ASSERT_NO_THROW(fem->update(1e-3));
+	EXPECT_TRUE(fem->getCurrentState()->getPositions().isApprox(expectedState.getPositions()));
+	EXPECT_TRUE(fem->getCurrentState()->getVelocities().isApprox(expectedState.getVelocities()));
+	EXPECT_TRUE(fem->getCurrentState()->getVelocities().segment<3>(0).isZero());
+
+	// The compliance is applied by the diagonal linear solver, without the compliance matrix
+	Eigen::SparseVector<double, Eigen::RowMajor, ptrdiff_t> h(15);
+	h.insert(1) = 1.0;
+	h.insert(4) = -2.0;
+	h.insert(13) = 0.5;
+	EXPECT_TRUE(fem->computeCHt(h).isApprox(expectedCompliance * h.transpose()));
+}
+
 TEST_F(Fem3DRepresentationTests, LoadMeshTest)
 {
 	auto fem = std::make_shared<Fem3DRepresentation>("Representation");
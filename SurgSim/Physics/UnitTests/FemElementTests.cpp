@@ -15,7 +15,9 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
 #include <string>
+#include <vector>
 
 #include "SurgSim/Physics/FemElement.h"
 #include "SurgSim/Math/Vector.h"
@@ -216,6 +218,69 @@ TEST(FemElementTests, IsValidCoordinate)
 	checkValidCoordinate(femElement, -0.01, 0.0, 1.01, e, false);
 }
 
+TEST(FemElementTests, ScatterMapTest)
+{
+	typedef SurgSim::Math::SparseMatrix::Index Index;
+
+	SurgSim::Math::OdeState state;
+	state.setNumDof(3, 6);
+	state.getPositions().segment<3>(3 * 3) = SurgSim::Math::Vector3d(0.0, 0.0, 0.0);
+	state.getPositions().segment<3>(3 * 0) = SurgSim::Math::Vector3d(1.0, 0.0, 0.0);
+	state.getPositions().segment<3>(3 * 5) = SurgSim::Math::Vector3d(0.0, 1.0, 0.0);
+	state.getPositions().segment<3>(3 * 1) = SurgSim::Math::Vector3d(0.0, 0.0, 1.0);
+
+	std::array<size_t, 4> nodeIds = {{3, 0, 5, 1}};
+	Fem3DElementTetrahedron element(nodeIds);
+	element.setMassDensity(1000.0);
+	element.setPoissonRatio(0.45);
+	element.setYoungModulus(1e6);
+	ASSERT_NO_THROW(element.initialize(state));
+	element.updateFMDK(state, SurgSim::Math::ODEEQUATIONUPDATE_FMDK);
+
+	// The pattern also contains the blocks of a neighbor element, so the element blocks are not contiguous
+	MockFemElement neighbor;
+	neighbor.addNode(2);
+	neighbor.addNode(5);
+	neighbor.addNode(4);
+
+	SurgSim::Math::SparseMatrix pattern(18, 18);
+	element.assembleMatrixBlocks(Matrix::Zero(12, 12), element.getNodeIds(), 3, &pattern, true);
+	neighbor.assembleMatrixBlocks(Matrix::Zero(9, 9), neighbor.getNodeIds(), 3, &pattern, true);
+	pattern.makeCompressed();
+
+	std::vector<Index> scatterMap;
+	element.computeScatterMap(pattern, &scatterMap);
+	EXPECT_EQ(4u * 4u * 3u, scatterMap.size());
+
+	SurgSim::Math::SparseMatrix expected = pattern;
+	SurgSim::Math::SparseMatrix actual = pattern;
+	element.addStiffness(&expected, 2.0);
+	element.addStiffness(scatterMap, &actual, 2.0);
+	EXPECT_TRUE(Matrix(expected).isApprox(Matrix(actual)));
+	EXPECT_EQ(pattern.nonZeros(), actual.nonZeros());
+
+	expected = pattern;
+	actual = pattern;
+	SurgSim::Math::SparseMatrix expectedDamping = pattern;
+	SurgSim::Math::SparseMatrix actualDamping = pattern;
+	SurgSim::Math::SparseMatrix expectedStiffness = pattern;
+	SurgSim::Math::SparseMatrix actualStiffness = pattern;
+	Vector expectedForce = Vector::Zero(18);
+	Vector actualForce = Vector::Zero(18);
+	element.addFMDK(&expectedForce, &expected, &expectedDamping, &expectedStiffness);
+	element.addFMDK(scatterMap, &actualForce, &actual, &actualDamping, &actualStiffness);
+	EXPECT_TRUE(expectedForce.isApprox(actualForce));
+	EXPECT_TRUE(Matrix(expected).isApprox(Matrix(actual)));
+	EXPECT_TRUE(Matrix(expectedDamping).isApprox(Matrix(actualDamping)));
+	EXPECT_TRUE(Matrix(expectedStiffness).isApprox(Matrix(actualStiffness)));
+
+	// A pattern missing some of the element blocks is rejected
+	SurgSim::Math::SparseMatrix neighborPattern(18, 18);
+	neighbor.assembleMatrixBlocks(Matrix::Zero(9, 9), neighbor.getNodeIds(), 3, &neighborPattern, true);
+	neighborPattern.makeCompressed();
+	EXPECT_ANY_THROW(element.computeScatterMap(neighborPattern, &scatterMap));
+}
+
 TEST(FemElementTests, FactoryTest)
 {
 	auto mockElement = std::make_shared<FemElementStructs::FemElementParameter>();
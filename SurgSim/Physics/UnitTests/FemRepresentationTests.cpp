@@ -20,6 +20,8 @@
 
 #include "SurgSim/DataStructures/IndexedLocalCoordinate.h"
 #include "SurgSim/Framework/Runtime.h" ///< Used to initialize the Component Fem3DRepresentation
+#include "SurgSim/Framework/ThreadPool.h"
+#include "SurgSim/Math/OdeSolverEulerImplicit.h"
 #include "SurgSim/Physics/UnitTests/DeformableTestsUtility.h"
 #include "SurgSim/Physics/UnitTests/MockObjects.h"
 
@@ -119,6 +121,21 @@ class FemRepresentationTests : public ::testing::Test
 	}
 };
 
+namespace
+{
+/// Mock element whose stiffness couples all its degrees of freedom, so its system is not block diagonal
+class CoupledMockFemElement : public MockFemElement
+{
+public:
+	void initialize(const SurgSim::Math::OdeState& state) override
+	{
+		MockFemElement::initialize(state);
+		m_K.setConstant(1.0);
+		m_K.diagonal().setConstant(3.0 * static_cast<double>(m_K.rows()));
+	}
+};
+}
+
 TEST_F(FemRepresentationTests, ConstructorTest)
 {
 	ASSERT_NO_THROW({MockFemRepresentation fem("name");});
@@ -408,6 +425,71 @@ TEST_F(FemRepresentationTests, ComputesWithGravityAndDampingTest)
 	}
 }
 
+TEST_F(FemRepresentationTests, ExternalForceMatricesPatternTest)
+{
+	m_fem->setIsGravityEnabled(false);
+	m_fem->initialize(std::make_shared<SurgSim::Framework::Runtime>());
+	m_fem->wakeUp();
+
+	// The 2 FemElements connect the nodes (0 1) and (1 2), the nodes 0 and 2 are not coupled
+	const size_t numDofPerNode = m_fem->getNumDofPerNode();
+	EXPECT_EQ(7 * numDofPerNode * numDofPerNode, static_cast<size_t>(m_fem->getK().nonZeros()));
+
+	std::shared_ptr<MockDeformableLocalization> localization = std::make_shared<MockDeformableLocalization>();
+	localization->setRepresentation(m_fem);
+	localization->setLocalNode(0);
+	Vector FextLocal = Vector::Ones(numDofPerNode);
+	Vector Fext = Vector::Zero(m_fem->getNumDof());
+	Fext.segment(0, numDofPerNode) = FextLocal;
+
+	{
+		SCOPED_TRACE("External force coupling all the nodes");
+
+		Matrix Kext = Matrix::Ones(m_fem->getNumDof(), m_fem->getNumDof());
+		Matrix Dext = 2.0 * Kext;
+		m_fem->addExternalGeneralizedForce(localization, FextLocal, Kext, Dext);
+
+		testOdeEquationUpdate(m_fem, *m_initialState, m_expectedFemElementsForce + Fext, m_expectedMass,
+			m_expectedDamping + Dext, m_expectedStiffness + Kext);
+		EXPECT_EQ(m_fem->getNumDof() * m_fem->getNumDof(), static_cast<size_t>(m_fem->getM().nonZeros()));
+		EXPECT_EQ(m_fem->getNumDof() * m_fem->getNumDof(), static_cast<size_t>(m_fem->getD().nonZeros()));
+		EXPECT_EQ(m_fem->getNumDof() * m_fem->getNumDof(), static_cast<size_t>(m_fem->getK().nonZeros()));
+	}
+
+	// The external generalized force, stiffness and damping are reset, the extended pattern is kept
+	m_fem->beforeUpdate(m_dt);
+	m_fem->update(m_dt);
+	m_fem->afterUpdate(m_dt);
+
+	{
+		SCOPED_TRACE("External force on a single node");
+
+		Matrix KextLocal = Matrix::Ones(numDofPerNode, numDofPerNode);
+		Matrix DextLocal = KextLocal + Matrix::Identity(numDofPerNode, numDofPerNode);
+		Matrix Kext = Matrix::Zero(m_fem->getNumDof(), m_fem->getNumDof());
+		Kext.block(0, 0, numDofPerNode, numDofPerNode) = KextLocal;
+		Matrix Dext = Matrix::Zero(m_fem->getNumDof(), m_fem->getNumDof());
+		Dext.block(0, 0, numDofPerNode, numDofPerNode) = DextLocal;
+		m_fem->addExternalGeneralizedForce(localization, FextLocal, KextLocal, DextLocal);
+
+		testOdeEquationUpdate(m_fem, *m_initialState, m_expectedFemElementsForce + Fext, m_expectedMass,
+			m_expectedDamping + Dext, m_expectedStiffness + Kext);
+		EXPECT_EQ(m_fem->getNumDof() * m_fem->getNumDof(), static_cast<size_t>(m_fem->getK().nonZeros()));
+	}
+
+	m_fem->beforeUpdate(m_dt);
+	m_fem->update(m_dt);
+	m_fem->afterUpdate(m_dt);
+
+	{
+		SCOPED_TRACE("Without external force");
+
+		testOdeEquationUpdate(m_fem, *m_initialState, m_expectedFemElementsForce, m_expectedMass, m_expectedDamping,
+			m_expectedStiffness);
+		EXPECT_EQ(m_fem->getNumDof() * m_fem->getNumDof(), static_cast<size_t>(m_fem->getK().nonZeros()));
+	}
+}
+
 TEST_F(FemRepresentationTests, DoInitializeTest)
 {
 	using SurgSim::Framework::Runtime;
@@ -526,6 +608,280 @@ TEST_F(FemRepresentationTests, ComplianceWarpingTest)
 	}
 }
 
+TEST_F(FemRepresentationTests, MatrixFreeComplianceTest)
+{
+	auto createFem = [this](bool complianceWarping, bool matrixFreeCompliance)
+	{
+		auto fem = std::make_shared<MockFemRepresentationValidComplianceWarping>("fem");
+		fem->setComplianceWarping(complianceWarping);
+		EXPECT_FALSE(fem->getMatrixFreeCompliance());
+		fem->setMatrixFreeCompliance(matrixFreeCompliance);
+		EXPECT_EQ(matrixFreeCompliance, fem->getMatrixFreeCompliance());
+		fem->setIntegrationScheme(SurgSim::Math::INTEGRATIONSCHEME_EULER_IMPLICIT);
+
+		auto initialState = std::make_shared<SurgSim::Math::OdeState>();
+		initialState->setNumDof(fem->getNumDofPerNode(), 3);
+		initialState->addBoundaryCondition(0);
+		fem->setInitialState(initialState);
+
+		std::shared_ptr<MockFemElement> element = std::make_shared<MockFemElement>();
+		element->setMassDensity(m_rho);
+		element->setPoissonRatio(m_nu);
+		element->setYoungModulus(m_E);
+		element->addNode(0);
+		element->addNode(1);
+		element->addNode(2);
+		fem->addFemElement(element);
+
+		fem->initialize(std::make_shared<SurgSim::Framework::Runtime>());
+		fem->wakeUp();
+		EXPECT_THROW(fem->setMatrixFreeCompliance(!matrixFreeCompliance), SurgSim::Framework::AssertionFailure);
+		fem->update(m_dt);
+		return fem;
+	};
+
+	Eigen::SparseVector<double, Eigen::RowMajor, ptrdiff_t> h(9);
+	h.insert(1) = 0.5;
+	h.insert(4) = -1.0;
+	h.insert(8) = 2.0;
+
+	for (bool complianceWarping : {false, true})
+	{
+		SCOPED_TRACE(complianceWarping ? "With compliance warping" : "Without compliance warping");
+		auto denseFem = createFem(complianceWarping, false);
+		auto matrixFreeFem = createFem(complianceWarping, true);
+
+		EXPECT_NO_THROW(denseFem->getComplianceMatrix());
+		EXPECT_THROW(matrixFreeFem->getComplianceMatrix(), SurgSim::Framework::AssertionFailure);
+
+		Vector expected = denseFem->getComplianceMatrix() * h.transpose();
+		EXPECT_TRUE(denseFem->computeCHt(h).isApprox(expected));
+		EXPECT_TRUE(matrixFreeFem->computeCHt(h).isApprox(expected));
+		EXPECT_TRUE(matrixFreeFem->computeCHt(h).segment<3>(0).isZero());
+	}
+}
+
+TEST_F(FemRepresentationTests, MatrixFreeSystemTest)
+{
+	auto createFem = [this](bool matrixFreeSystem, SurgSim::Math::IntegrationScheme integrationScheme)
+	{
+		auto fem = std::make_shared<MockFemRepresentation>("fem");
+		fem->setIntegrationScheme(integrationScheme);
+		fem->setMatrixFreeSystem(matrixFreeSystem);
+
+		auto initialState = std::make_shared<SurgSim::Math::OdeState>();
+		initialState->setNumDof(fem->getNumDofPerNode(), 4);
+		initialState->addBoundaryCondition(0);
+		initialState->getPositions().setLinSpaced(0.0, 0.1);
+		fem->setInitialState(initialState);
+
+		for (size_t nodeId = 0; nodeId < 2; ++nodeId)
+		{
+			auto element = std::make_shared<CoupledMockFemElement>();
+			element->setMassDensity(m_rho);
+			element->setPoissonRatio(m_nu);
+			element->setYoungModulus(m_E);
+			element->addNode(nodeId);
+			element->addNode(nodeId + 1);
+			element->addNode(nodeId + 2);
+			fem->addFemElement(element);
+		}
+		return fem;
+	};
+
+	{
+		SCOPED_TRACE("Matrix free system with an unsupported integration scheme");
+		auto fem = createFem(true, SurgSim::Math::INTEGRATIONSCHEME_STATIC);
+		EXPECT_FALSE(fem->initialize(std::make_shared<SurgSim::Framework::Runtime>()));
+	}
+
+	auto denseFem = createFem(false, SurgSim::Math::INTEGRATIONSCHEME_EULER_IMPLICIT);
+	auto matrixFreeFem = createFem(true, SurgSim::Math::INTEGRATIONSCHEME_EULER_IMPLICIT);
+	for (auto fem : {denseFem, matrixFreeFem})
+	{
+		ASSERT_TRUE(fem->initialize(std::make_shared<SurgSim::Framework::Runtime>()));
+		ASSERT_TRUE(fem->wakeUp());
+	}
+	EXPECT_THROW(matrixFreeFem->setMatrixFreeSystem(false), SurgSim::Framework::AssertionFailure);
+	EXPECT_TRUE(matrixFreeFem->getMatrixFreeCompliance());
+	EXPECT_FALSE(denseFem->getMatrixFreeCompliance());
+
+	// Two contacts pulling on the free nodes, each applied as a constraint correction after the free motion
+	Eigen::SparseVector<double, Eigen::RowMajor, ptrdiff_t> h1(12), h2(12);
+	h1.insert(4) = 1.0;
+	h1.insert(7) = -0.5;
+	h2.insert(9) = 0.5;
+	h2.insert(11) = 2.0;
+	const double impulse1 = 0.01, impulse2 = -0.02;
+
+	for (int step = 0; step < 5; ++step)
+	{
+		SCOPED_TRACE("Step " + std::to_string(step));
+		denseFem->update(m_dt);
+		matrixFreeFem->update(m_dt);
+		EXPECT_TRUE(matrixFreeFem->getCurrentState()->getPositions().isApprox(
+			denseFem->getCurrentState()->getPositions(), 1e-6));
+
+		Vector correction[2];
+		for (size_t i = 0; i < 2; ++i)
+		{
+			auto fem = (i == 0 ? denseFem : matrixFreeFem);
+			Vector cht1 = fem->computeCHt(h1);
+			Vector cht2 = fem->computeCHt(h2);
+			EXPECT_TRUE(cht1.segment<3>(0).isZero());
+			EXPECT_TRUE(cht2.segment<3>(0).isZero());
+			correction[i] = impulse1 * cht1 + impulse2 * cht2;
+			Vector velocityCorrection = correction[i] / m_dt;
+			fem->applyCorrection(m_dt, velocityCorrection.segment(0, velocityCorrection.size()));
+		}
+		EXPECT_TRUE(correction[1].isApprox(correction[0], 1e-6));
+
+		denseFem->afterUpdate(m_dt);
+		matrixFreeFem->afterUpdate(m_dt);
+	}
+	EXPECT_TRUE(matrixFreeFem->getFinalState()->getPositions().isApprox(
+		denseFem->getFinalState()->getPositions(), 1e-6));
+
+	// An unconverged conjugate gradient is only reported, the step still completes
+	auto odeSolver = std::dynamic_pointer_cast<SurgSim::Math::OdeSolverEulerImplicit>(matrixFreeFem->getOdeSolver());
+	ASSERT_NE(nullptr, odeSolver);
+	odeSolver->setMatrixFreeMaximumIteration(1);
+	ASSERT_NO_THROW(matrixFreeFem->update(m_dt));
+	EXPECT_GT(odeSolver->getMatrixFreeSolver().getRelativeResidual(), odeSolver->getMatrixFreeTolerance());
+	EXPECT_NO_THROW(matrixFreeFem->computeCHt(h1));
+}
+
+TEST_F(FemRepresentationTests, ParallelAssemblyTest)
+{
+	const size_t numNodes = 40;
+	auto state = std::make_shared<SurgSim::Math::OdeState>();
+	state->setNumDof(3, numNodes);
+	state->getVelocities().setRandom();
+
+	// Consecutive elements share nodes, so the assembly needs several colors
+	auto createFem = [this, &state](const std::string& name)
+	{
+		auto fem = std::make_shared<MockFemRepresentation>(name);
+		fem->setInitialState(state);
+		fem->setRayleighDampingMass(m_rayleighDampingMassParameter);
+		fem->setRayleighDampingStiffness(m_rayleighDampingStiffnessParameter);
+		for (size_t nodeId = 0; nodeId + 2 < numNodes; ++nodeId)
+		{
+			auto element = std::make_shared<MockFemElement>();
+			element->setMassDensity(m_rho);
+			element->setPoissonRatio(m_nu);
+			element->setYoungModulus(m_E);
+			element->addNode(nodeId);
+			element->addNode(nodeId + 1);
+			element->addNode(nodeId + 2);
+			fem->addFemElement(element);
+		}
+		return fem;
+	};
+
+	auto serialFem = createFem("serial");
+	EXPECT_TRUE(serialFem->getParallelAssembly());
+	serialFem->setParallelAssembly(false);
+	EXPECT_FALSE(serialFem->getParallelAssembly());
+
+	auto parallelFem = createFem("parallel");
+	auto threadPool = std::make_shared<SurgSim::Framework::ThreadPool>(4);
+	EXPECT_EQ(nullptr, parallelFem->getAssemblyThreadPool());
+	parallelFem->setAssemblyThreadPool(threadPool);
+	EXPECT_EQ(threadPool, parallelFem->getAssemblyThreadPool());
+
+	for (auto fem : {serialFem, parallelFem})
+	{
+		fem->initialize(std::make_shared<SurgSim::Framework::Runtime>());
+		fem->wakeUp();
+		fem->updateFMDK(*state, SurgSim::Math::ODEEQUATIONUPDATE_FMDK);
+	}
+
+	EXPECT_TRUE(serialFem->getF().isApprox(parallelFem->getF()));
+	EXPECT_TRUE(Matrix(serialFem->getM()).isApprox(Matrix(parallelFem->getM())));
+	EXPECT_TRUE(Matrix(serialFem->getD()).isApprox(Matrix(parallelFem->getD())));
+	EXPECT_TRUE(Matrix(serialFem->getK()).isApprox(Matrix(parallelFem->getK())));
+
+	// Compare with the assembly searching each element block in the sparse matrix
+	SurgSim::Math::SparseMatrix expectedK = parallelFem->getK();
+	SurgSim::Math::clearMatrix(&expectedK);
+	for (size_t elementId = 0; elementId < parallelFem->getNumFemElements(); ++elementId)
+	{
+		parallelFem->getFemElement(elementId)->addStiffness(&expectedK);
+	}
+	EXPECT_TRUE(Matrix(expectedK).isApprox(Matrix(parallelFem->getK())));
+
+	// Separate updates of each term give the same result
+	serialFem->updateFMDK(*state, SurgSim::Math::ODEEQUATIONUPDATE_F | SurgSim::Math::ODEEQUATIONUPDATE_M |
+						  SurgSim::Math::ODEEQUATIONUPDATE_D | SurgSim::Math::ODEEQUATIONUPDATE_K);
+	EXPECT_TRUE(serialFem->getF().isApprox(parallelFem->getF()));
+	EXPECT_TRUE(Matrix(serialFem->getM()).isApprox(Matrix(parallelFem->getM())));
+	EXPECT_TRUE(Matrix(serialFem->getD()).isApprox(Matrix(parallelFem->getD())));
+	EXPECT_TRUE(Matrix(serialFem->getK()).isApprox(Matrix(parallelFem->getK())));
+}
+
+TEST_F(FemRepresentationTests, MatrixFreeProductTest)
+{
+	const size_t numNodes = 40;
+	auto state = std::make_shared<SurgSim::Math::OdeState>();
+	state->setNumDof(3, numNodes);
+	state->getPositions().setRandom();
+	state->getVelocities().setRandom();
+
+	auto createFem = [this, &state](const std::string& name)
+	{
+		auto fem = std::make_shared<MockFemRepresentation>(name);
+		fem->setInitialState(state);
+		fem->setRayleighDampingMass(m_rayleighDampingMassParameter);
+		fem->setRayleighDampingStiffness(m_rayleighDampingStiffnessParameter);
+		for (size_t nodeId = 0; nodeId + 2 < numNodes; ++nodeId)
+		{
+			auto element = std::make_shared<MockFemElement>();
+			element->setMassDensity(m_rho);
+			element->setPoissonRatio(m_nu);
+			element->setYoungModulus(m_E);
+			element->addNode(nodeId);
+			element->addNode(nodeId + 1);
+			element->addNode(nodeId + 2);
+			fem->addFemElement(element);
+		}
+		fem->initialize(std::make_shared<SurgSim::Framework::Runtime>());
+		fem->wakeUp();
+		return fem;
+	};
+
+	auto assembledFem = createFem("assembled");
+	assembledFem->updateFMDK(*state, SurgSim::Math::ODEEQUATIONUPDATE_FMDK);
+	const Matrix systemMatrix = Matrix(assembledFem->getM()) * 2.0 + Matrix(assembledFem->getD()) * 0.5 +
+								Matrix(assembledFem->getK()) * 3.0;
+	const SurgSim::Math::Vector x = SurgSim::Math::Vector::Random(3 * numNodes);
+
+	auto serialFem = createFem("serial");
+	serialFem->setParallelAssembly(false);
+	auto parallelFem = createFem("parallel");
+	parallelFem->setAssemblyThreadPool(std::make_shared<SurgSim::Framework::ThreadPool>(4));
+
+	for (auto fem : {serialFem, parallelFem})
+	{
+		fem->updateMatrixFreeFMDK(*state);
+		EXPECT_TRUE(fem->getF().isApprox(assembledFem->getF()));
+
+		SurgSim::Math::Vector result;
+		fem->applyMDK(2.0, 0.5, 3.0, x, &result);
+		EXPECT_TRUE(result.isApprox(systemMatrix * x));
+
+		Matrix blocks;
+		EXPECT_THROW(fem->computeMDKDiagonalBlocks(2.0, 0.5, 3.0, 2, &blocks), SurgSim::Framework::AssertionFailure);
+		fem->computeMDKDiagonalBlocks(2.0, 0.5, 3.0, 3, &blocks);
+		ASSERT_EQ(3 * numNodes, static_cast<size_t>(blocks.rows()));
+		ASSERT_EQ(3, blocks.cols());
+		for (size_t nodeId = 0; nodeId < numNodes; ++nodeId)
+		{
+			EXPECT_TRUE(blocks.middleRows(3 * nodeId, 3).isApprox(systemMatrix.block(3 * nodeId, 3 * nodeId, 3, 3)));
+		}
+	}
+}
+
 TEST_F(FemRepresentationTests, SerializationTest)
 {
 	auto fem = std::make_shared<MockFemRepresentation>("Test-Fem");
@@ -537,6 +893,24 @@ TEST_F(FemRepresentationTests, SerializationTest)
 	EXPECT_FALSE(fem->getComplianceWarping());
 	EXPECT_FALSE(fem->getValue<bool>("ComplianceWarping"));
 
+	EXPECT_NO_THROW(fem->setValue("MatrixFreeCompliance", true));
+	EXPECT_TRUE(fem->getMatrixFreeCompliance());
+	EXPECT_TRUE(fem->getValue<bool>("MatrixFreeCompliance"));
+
+	EXPECT_FALSE(fem->getMatrixFreeSystem());
+	EXPECT_NO_THROW(fem->setValue("MatrixFreeSystem", true));
+	EXPECT_TRUE(fem->getMatrixFreeSystem());
+	EXPECT_TRUE(fem->getValue<bool>("MatrixFreeSystem"));
+
+	EXPECT_NO_THROW(fem->setValue("ParallelAssembly", false));
+	EXPECT_FALSE(fem->getParallelAssembly());
+	EXPECT_FALSE(fem->getValue<bool>("ParallelAssembly"));
+
+	EXPECT_FALSE(fem->getMassLumping());
+	EXPECT_NO_THROW(fem->setValue("MassLumping", true));
+	EXPECT_TRUE(fem->getMassLumping());
+	EXPECT_TRUE(fem->getValue<bool>("MassLumping"));
+
 	EXPECT_NO_THROW(fem->setValue("RayleighDampingMass", 1.1));
 	EXPECT_NO_THROW(fem->getValue<double>("RayleighDampingMass"));
 	EXPECT_DOUBLE_EQ(1.1, fem->getValue<double>("RayleighDampingMass"));
@@ -22,6 +22,8 @@
 
 #include "SurgSim/Blocks/SphereElement.h"
 #include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/Collision/ContactCache.h"
+#include "SurgSim/Collision/ContactCalculation.h"
 #include "SurgSim/Framework/Runtime.h"
 #include "SurgSim/Framework/Scene.h"
 #include "SurgSim/Framework/SceneElement.h"
@@ -213,5 +215,57 @@ TEST_F(PrepareCollisionPairsTest, SingleSelfCollisionPair)
 	ASSERT_EQ(1u, newState->getCollisionPairs().size());
 }
 
+TEST_F(PrepareCollisionPairsTest, ContactCacheTest)
+{
+	sphere2->setPose(Math::makeRigidTransform(Math::Quaterniond::Identity(), Vector3d(0.0, 0.0, 0.5)));
+
+	prepareState();
+	ASSERT_EQ(1u, state->getCollisionPairs().size());
+	auto cache = state->getCollisionPairs()[0]->getContactCache();
+	ASSERT_NE(nullptr, cache);
+
+	// The next frame gets the same cache for the same two representations
+	std::shared_ptr<PhysicsManagerState> newState = computation->update(1.0, state);
+	ASSERT_EQ(1u, newState->getCollisionPairs().size());
+	EXPECT_EQ(cache, newState->getCollisionPairs()[0]->getContactCache());
+
+	// The cache is dropped when the pair is not generated, a new one is created when the pair comes back
+	physicsRepresentations.pop_back();
+	collisionRepresentations.pop_back();
+	prepareState();
+	ASSERT_EQ(0u, state->getCollisionPairs().size());
+
+	physicsRepresentations.push_back(sphere2->getComponents<SurgSim::Physics::Representation>()[0]);
+	collisionRepresentations.push_back(sphere2Collision);
+	prepareState();
+	ASSERT_EQ(1u, state->getCollisionPairs().size());
+	EXPECT_NE(nullptr, state->getCollisionPairs()[0]->getContactCache());
+	EXPECT_NE(cache, state->getCollisionPairs()[0]->getContactCache());
+}
+
+TEST_F(PrepareCollisionPairsTest, ContactCalculationTest)
+{
+	sphere2->setPose(Math::makeRigidTransform(Math::Quaterniond::Identity(), Vector3d(0.0, 0.0, 0.5)));
+	sphere1Collision->update(0.0);
+	sphere2Collision->update(0.0);
+
+	prepareState();
+	ASSERT_EQ(1u, state->getCollisionPairs().size());
+	auto pair = state->getCollisionPairs()[0];
+	ASSERT_EQ(Collision::COLLISION_DETECTION_TYPE_DISCRETE, pair->getType());
+
+	// The calculation is resolved, and the shapes are posed before the narrow phase
+	EXPECT_EQ(Collision::ContactCalculation::getDcdContactTable()[Math::SHAPE_TYPE_SPHERE][Math::SHAPE_TYPE_SPHERE],
+			  pair->getContactCalculation());
+	EXPECT_EQ(pair->getFirst()->getShape(), pair->getPosedShapes().first.getShape());
+	EXPECT_TRUE(pair->getFirst()->getPose().isApprox(pair->getPosedShapes().first.getPose()));
+	EXPECT_EQ(pair->getSecond()->getShape(), pair->getPosedShapes().second.getShape());
+	EXPECT_TRUE(pair->getSecond()->getPose().isApprox(pair->getPosedShapes().second.getPose()));
+
+	// The narrow phase uses them
+	pair->getContactCalculation()->calculateContact(pair);
+	EXPECT_TRUE(pair->hasContacts());
+}
+
 };
 };
@@ -21,26 +21,27 @@
 #include <memory>
 #include <string>
 
+#include "SurgSim/Collision/CollisionPair.h"
+#include "SurgSim/DataStructures/Location.h"
+#include "SurgSim/Physics/BuildMlcp.h"
 #include "SurgSim/Physics/PhysicsManagerState.h"
 #include "SurgSim/Physics/SolveMlcp.h"
+#include "SurgSim/Physics/UnitTests/CommonTests.h"
 
 #include "SurgSim/Testing/MlcpIO/MlcpTestData.h"
 #include "SurgSim/Testing/MlcpIO/ReadText.h"
 
+using SurgSim::Physics::MlcpIsland;
 using SurgSim::Physics::PhysicsManagerState;
 using SurgSim::Physics::SolveMlcp;
 
-namespace
-{
-	const double epsilon = 1e-10;
-};
-
 TEST(SolveMlcpTest, CanConstruct)
 {
 	ASSERT_NO_THROW({std::shared_ptr<SolveMlcp> solveMlcpComputation = std::make_shared<SolveMlcp>();});
 }
 
-static void testMlcp(const std::string& filename, double contactTolerance, double solverPrecision, size_t maxIteration)
+static void testMlcp(const std::string& filename, double contactTolerance, double solverPrecision, size_t maxIteration,
+					 bool useSparseMatrix = false)
 {
 	std::shared_ptr<MlcpTestData> data = loadTestData(filename);
 	ASSERT_NE(nullptr, data) << "Could not load data file 'mlcpOriginalTest.txt'";
@@ -56,6 +57,8 @@ static void testMlcp(const std::string& filename, double contactTolerance, doubl
 	EXPECT_NEAR(solverPrecision, solveMlcpComputation->getPrecision(), 1e-10);
 	solveMlcpComputation->setMaxIterations(maxIteration);
 	EXPECT_EQ(maxIteration, solveMlcpComputation->getMaxIterations());
+	solveMlcpComputation->setUseSparseMatrix(useSparseMatrix);
+	EXPECT_EQ(useSparseMatrix, solveMlcpComputation->isUsingSparseMatrix());
 
 	// Copy the MlcpProblem data over into the input state
 	state->getMlcpProblem().A = data->problem.A;
@@ -92,3 +95,227 @@ TEST(SolveMlcpTest, TestSequenceMlcps)
 		testMlcp(getTestFileName("mlcpTest", i, ".txt"), 1e-9, 1e-9, 100);
 	}
 }
+
+TEST(SolveMlcpTest, TestSparseMatrix)
+{
+	testMlcp("mlcpOriginalTest.txt", 2e-4, 1e-4, 30, true);
+	for (int i = 0;  i <= 9;  ++i)
+	{
+		std::ostringstream scopeName;
+		scopeName << "Testing Mlcp " << i;
+		SCOPED_TRACE(scopeName.str());
+
+		testMlcp(getTestFileName("mlcpTest", i, ".txt"), 1e-9, 1e-9, 100, true);
+	}
+}
+
+TEST(SolveMlcpTest, TestIslands)
+{
+	// Stack several independent problems in one block diagonal Mlcp, one island per problem
+	std::vector<std::shared_ptr<MlcpTestData>> data;
+	for (int i = 0;  i <= 3;  ++i)
+	{
+		data.push_back(loadTestData(getTestFileName("mlcpTest", i, ".txt")));
+		ASSERT_NE(nullptr, data.back());
+	}
+
+	std::vector<MlcpIsland> islands;
+	size_t numAtomicConstraints = 0;
+	size_t numConstraints = 0;
+	for (const auto& problem : data)
+	{
+		MlcpIsland island = {numConstraints, problem->problem.constraintTypes.size(),
+							 numAtomicConstraints, problem->problem.getSize()};
+		islands.push_back(island);
+		numConstraints += island.numConstraints;
+		numAtomicConstraints += island.numAtomicConstraints;
+	}
+
+	std::shared_ptr<PhysicsManagerState> state = std::make_shared<PhysicsManagerState>();
+	auto& problem = state->getMlcpProblem();
+	problem.A.setZero(numAtomicConstraints, numAtomicConstraints);
+	problem.b.setZero(numAtomicConstraints);
+	problem.mu.setZero(numAtomicConstraints);
+	Eigen::VectorXd expectedLambda(numAtomicConstraints);
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		const auto& island = islands[i];
+		const auto size = island.numAtomicConstraints;
+		problem.A.block(island.atomicIndex, island.atomicIndex, size, size) = data[i]->problem.A;
+		problem.b.segment(island.atomicIndex, size) = data[i]->problem.b;
+		problem.mu.segment(island.atomicIndex, size) = data[i]->problem.mu;
+		problem.constraintTypes.insert(problem.constraintTypes.end(), data[i]->problem.constraintTypes.begin(),
+									   data[i]->problem.constraintTypes.end());
+		expectedLambda.segment(island.atomicIndex, size) = data[i]->expectedLambda;
+	}
+	state->setMlcpIslands(islands);
+	state->getMlcpSolution().x.setZero(numAtomicConstraints);
+
+	std::shared_ptr<SolveMlcp> solveMlcpComputation = std::make_shared<SolveMlcp>(false);
+	EXPECT_TRUE(solveMlcpComputation->isUsingIslands());
+	solveMlcpComputation->setContactTolerance(1e-9);
+	solveMlcpComputation->setPrecision(1e-9);
+	solveMlcpComputation->setMaxIterations(100);
+
+	// Each island is solved exactly like the standalone problem
+	state = solveMlcpComputation->update(1e-3, state);
+	EXPECT_TRUE(state->getMlcpSolution().x.isApprox(expectedLambda, epsilon)) <<
+		"lambda:" << std::endl << state->getMlcpSolution().x.transpose() << std::endl <<
+		"expected:" << std::endl << expectedLambda.transpose() << std::endl;
+	EXPECT_TRUE(state->getMlcpSolution().validSignorini);
+
+	// The whole problem gives the same result, islands do not interact
+	solveMlcpComputation->setUseIslands(false);
+	EXPECT_FALSE(solveMlcpComputation->isUsingIslands());
+	state->getMlcpSolution().x.setZero(numAtomicConstraints);
+	state = solveMlcpComputation->update(1e-3, state);
+	EXPECT_TRUE(state->getMlcpSolution().x.isApprox(expectedLambda, 1e-6));
+
+	// BuildMlcp stores the islands in the sparse matrix, they are solved on dense copies or on the sparse blocks
+	problem.sparseA = problem.A.sparseView();
+	problem.A.resize(0, 0);
+	ASSERT_TRUE(problem.isSparse());
+	solveMlcpComputation->setUseIslands(true);
+	for (bool useSparseMatrix : {false, true})
+	{
+		solveMlcpComputation->setUseSparseMatrix(useSparseMatrix);
+		state->getMlcpSolution().x.setZero(numAtomicConstraints);
+		state = solveMlcpComputation->update(1e-3, state);
+		EXPECT_TRUE(state->getMlcpSolution().x.isApprox(expectedLambda, epsilon));
+	}
+}
+
+namespace SurgSim
+{
+namespace Physics
+{
+
+class SolveMlcpWarmStartTest : public CommonTests
+{
+public:
+	void SetUp()
+	{
+		CommonTests::SetUp();
+
+		m_usedRepresentations.push_back(m_allRepresentations[0]);
+		m_usedRepresentations.push_back(m_allRepresentations[1]);
+		m_usedRepresentations.push_back(m_fixedWorldRepresentation);
+		m_physicsManagerState->setRepresentations(m_usedRepresentations);
+
+		m_buildMlcpComputation = std::make_shared<BuildMlcp>();
+		m_solveMlcpComputation = std::make_shared<SolveMlcp>();
+	}
+
+	/// Run one frame with one contact on each rigid representation, the contact constraints are created again like
+	/// ContactConstraintGeneration does it
+	/// \return The number of iterations of the solver
+	size_t runFrame()
+	{
+		std::vector<std::shared_ptr<Constraint>> constraints;
+		for (size_t i = 0; i < 2; ++i)
+		{
+			DataStructures::Location location(Math::Vector3d(0.1, 0.0, 0.0));
+			DataStructures::Location contactLocation(location);
+			contactLocation.triangleMeshLocalCoordinate.setValue(
+				DataStructures::IndexedLocalCoordinate(i, Math::Vector3d(1.0, 0.0, 0.0)));
+			auto contact = std::make_shared<Collision::Contact>(Collision::COLLISION_DETECTION_TYPE_DISCRETE,
+							0.01, 1.0, location.rigidLocalPosition.getValue(), Math::Vector3d::UnitY(),
+							std::make_pair(contactLocation, contactLocation));
+
+			auto data = std::make_shared<ContactConstraintData>();
+			data->setPlaneEquation(contact->normal, contact->depth);
+			data->setContact(contact);
+			// The fixed side is slightly above the rigid side, so the contacts are penetrating
+			DataStructures::Location fixedLocation(
+				location.rigidLocalPosition.getValue() + Math::Vector3d(0.0, 0.01, 0.0));
+			constraints.push_back(std::make_shared<Constraint>(FRICTIONLESS_3DCONTACT, data,
+								  m_allRepresentations[i], location, m_fixedWorldRepresentation, fixedLocation));
+		}
+		m_physicsManagerState->setConstraintGroup(CONSTRAINT_GROUP_TYPE_CONTACT, constraints);
+
+		m_buildMlcpComputation->update(dt, m_physicsManagerState);
+		m_solveMlcpComputation->update(dt, m_physicsManagerState);
+		return m_physicsManagerState->getMlcpSolution().numIterations;
+	}
+
+protected:
+	std::shared_ptr<BuildMlcp> m_buildMlcpComputation;
+	std::shared_ptr<SolveMlcp> m_solveMlcpComputation;
+};
+
+TEST_F(SolveMlcpWarmStartTest, SetGet)
+{
+	EXPECT_FALSE(m_solveMlcpComputation->isUsingWarmStart());
+	m_solveMlcpComputation->setUseWarmStart(true);
+	EXPECT_TRUE(m_solveMlcpComputation->isUsingWarmStart());
+	m_solveMlcpComputation->setUseWarmStart(false);
+	EXPECT_FALSE(m_solveMlcpComputation->isUsingWarmStart());
+
+	EXPECT_FALSE(m_solveMlcpComputation->isMeasuringWarmStart());
+	m_solveMlcpComputation->setMeasureWarmStart(true);
+	EXPECT_TRUE(m_solveMlcpComputation->isMeasuringWarmStart());
+
+	EXPECT_EQ(0u, m_solveMlcpComputation->getStatistics().numSolves);
+	EXPECT_EQ(0u, m_solveMlcpComputation->getStatistics().numIterations);
+	EXPECT_EQ(0, m_solveMlcpComputation->getStatistics().numIterationsSaved);
+}
+
+TEST_F(SolveMlcpWarmStartTest, PersistentContacts)
+{
+	m_solveMlcpComputation->setUseWarmStart(true);
+	const size_t coldIterations = runFrame();
+	const Eigen::VectorXd lambda = m_physicsManagerState->getMlcpSolution().x;
+	ASSERT_EQ(2, lambda.size());
+	ASSERT_GT(coldIterations, 0u);
+	ASSERT_GT(lambda.norm(), 0.0);
+	EXPECT_EQ(0u, m_solveMlcpComputation->getStatistics().numWarmStartedConstraints);
+
+	// Same contacts on new constraints, the previous solution is already converged
+	const size_t warmIterations = runFrame();
+	EXPECT_LT(warmIterations, coldIterations);
+	EXPECT_TRUE(m_physicsManagerState->getMlcpSolution().x.isApprox(lambda, 1e-6));
+
+	const auto& statistics = m_solveMlcpComputation->getStatistics();
+	EXPECT_EQ(2u, statistics.numSolves);
+	EXPECT_EQ(coldIterations + warmIterations, statistics.numIterations);
+	EXPECT_EQ(4u, statistics.numConstraints);
+	EXPECT_EQ(2u, statistics.numWarmStartedConstraints);
+
+	// The saved impulses are overwritten by each frame
+	EXPECT_LT(runFrame(), coldIterations);
+	EXPECT_TRUE(m_physicsManagerState->getMlcpSolution().x.isApprox(lambda, 1e-6));
+	EXPECT_EQ(4u, statistics.numWarmStartedConstraints);
+
+	m_solveMlcpComputation->resetStatistics();
+	EXPECT_EQ(0u, m_solveMlcpComputation->getStatistics().numSolves);
+
+	// Without warm start, the solver goes back to a cold start
+	m_solveMlcpComputation->setUseWarmStart(false);
+	EXPECT_EQ(coldIterations, runFrame());
+	EXPECT_EQ(0u, m_solveMlcpComputation->getStatistics().numWarmStartedConstraints);
+	EXPECT_EQ(0, m_solveMlcpComputation->getStatistics().numIterationsSaved);
+}
+
+TEST_F(SolveMlcpWarmStartTest, MeasureWarmStart)
+{
+	m_solveMlcpComputation->setUseWarmStart(true);
+	m_solveMlcpComputation->setMeasureWarmStart(true);
+	const auto& statistics = m_solveMlcpComputation->getStatistics();
+
+	// Nothing to warm start from on the first frame
+	const size_t coldIterations = runFrame();
+	const Eigen::VectorXd lambda = m_physicsManagerState->getMlcpSolution().x;
+	EXPECT_EQ(0, statistics.numIterationsSaved);
+
+	// The cold start is only used for counting, the solution and the statistics are the ones of the warm start
+	const size_t warmIterations = runFrame();
+	ASSERT_LT(warmIterations, coldIterations);
+	EXPECT_TRUE(m_physicsManagerState->getMlcpSolution().x.isApprox(lambda, 1e-6));
+	EXPECT_EQ(static_cast<ptrdiff_t>(coldIterations - warmIterations), statistics.numIterationsSaved);
+	EXPECT_EQ(2u, statistics.numSolves);
+	EXPECT_EQ(coldIterations + warmIterations, statistics.numIterations);
+	EXPECT_EQ(2u, statistics.numWarmStartedConstraints);
+}
+
+}; // namespace Physics
+}; // namespace SurgSim
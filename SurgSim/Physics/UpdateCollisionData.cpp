@@ -45,19 +45,11 @@ std::shared_ptr<PhysicsManagerState> UpdateCollisionData::doUpdate(
 	std::shared_ptr<PhysicsManagerState> result = state;
 
 	auto threadPool = Framework::Runtime::getThreadPool();
-	std::vector<std::future<void>> tasks;
 	auto& representations = result->getActiveCollisionRepresentations();
-	for (auto& representation : representations)
+	threadPool->parallelFor(0, representations.size(), 1, [&representations](size_t i)
 	{
-		tasks.push_back(threadPool->enqueue<void>([dt, &representation]()
-		{
-			representation->updateShapeData();
-		}));
-	}
-	for (auto& task : tasks)
-	{
-		task.get();
-	}
+		representations[i]->updateShapeData();
+	});
 
 	return result;
 }
@@ -40,16 +40,11 @@ std::shared_ptr<PhysicsManagerState> SurgSim::Physics::UpdateCollisionRepresenta
 	std::shared_ptr<PhysicsManagerState> result = state;
 
 	auto threadPool = Framework::Runtime::getThreadPool();
-	std::vector<std::future<void>> tasks;
 	auto& representations = result->getActiveCollisionRepresentations();
-	for (auto& representation : representations)
+	threadPool->parallelFor(0, representations.size(), 1, [dt, &representations](size_t i)
 	{
-		tasks.push_back(threadPool->enqueue<void>([dt, &representation]() { representation->update(dt); }));
-	}
-	for (auto& task : tasks)
-	{
-		task.get();
-	}
+		representations[i]->update(dt);
+	});
 
 	return result;
 }
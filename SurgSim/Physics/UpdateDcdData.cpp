@@ -21,6 +21,7 @@
 #include "SurgSim/Collision/Representation.h"
 
 #include <unordered_set>
+#include <vector>
 
 namespace SurgSim
 {
@@ -47,7 +48,6 @@ std::shared_ptr<PhysicsManagerState> UpdateDcdData::doUpdate(
 	std::shared_ptr<PhysicsManagerState> result = state;
 
 	auto threadPool = Framework::Runtime::getThreadPool();
-	std::vector<std::future<void>> tasks;
 
 	const auto& pairs = result->getCollisionPairs();
 	std::unordered_set<Collision::Representation*> representations;
@@ -61,18 +61,11 @@ std::shared_ptr<PhysicsManagerState> UpdateDcdData::doUpdate(
 		}
 	}
 
-	for (auto representation : representations)
+	std::vector<Collision::Representation*> uniqueRepresentations(representations.begin(), representations.end());
+	threadPool->parallelFor(0, uniqueRepresentations.size(), 1, [&uniqueRepresentations](size_t i)
 	{
-		tasks.push_back(threadPool->enqueue<void>([dt, representation]()
-		{
-			representation->updateDcdData();
-		}));
-	}
-
-	for (auto& task : tasks)
-	{
-		task.get();
-	}
+		uniqueRepresentations[i]->updateDcdData();
+	});
 
 	return result;
 }